@@ -11,6 +11,7 @@ import (
 	"os"
 	"os/exec"
 	"regexp"
+	"strconv"
 	"strings"
 
 	"github.com/joho/godotenv"
@@ -64,6 +65,11 @@ func handleVoice(w http.ResponseWriter, r *http.Request) {
 	}
 	fmt.Printf("[RECV] Received %d bytes of audio\n", len(pcmData))
 
+	// Wake word turns lead with the audio that woke the device; don't transcribe it
+	if n, err := strconv.Atoi(r.Header.Get("X-Wake-Preroll")); err == nil && n > 0 && n*2 <= len(pcmData) {
+		pcmData = pcmData[n*2:]
+	}
+
 	// 2. Create WAV from PCM for Whisper
 	wavData := pcmToWav(pcmData, 16000, 1, 16)
 
@@ -0,0 +1,20 @@
+"""
+Device authentication for NOVA
+The ESP32 sends the shared secret from src/config.h (DEVICE_TOKEN) as an
+X-Device-Token header; the backend's is NOVA_DEVICE_TOKEN. With no token set,
+audio requests stay open as before, but endpoints that store what they are
+sent refuse every request.
+"""
+
+import hmac
+import os
+
+DEVICE_TOKEN = os.environ.get("NOVA_DEVICE_TOKEN", "")
+
+
+def device_authorized(headers, stores_data: bool = False) -> bool:
+    """True if the request carries the device token (or none is set and it stores nothing)"""
+    if not DEVICE_TOKEN:
+        return not stores_data
+    sent = headers.get("x-device-token", "")
+    return hmac.compare_digest(sent.encode(), DEVICE_TOKEN.encode())
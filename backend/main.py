@@ -8,6 +8,7 @@ import wave
 import struct
 import numpy as np
 import os
+import time
 from dotenv import load_dotenv
 import edge_tts
 import asyncio
@@ -25,10 +26,15 @@ load_dotenv()
 
 from fastapi import FastAPI, Request
 from fastapi.staticfiles import StaticFiles
-from fastapi.responses import Response, RedirectResponse
+from fastapi.responses import Response, RedirectResponse, StreamingResponse
 from groq import Groq
 from tuya_controller import light_controller
 from firestick_controller import firestick_controller
+from tts_stream import stream_tts_chunks, first_audio_chunk, pcm_byte_stream
+from telemetry import ingest_telemetry, telemetry_summary
+from score_cache import ScoreDumpTooLarge, read_score_upload, store_score_dump
+from device_auth import DEVICE_TOKEN, device_authorized
+from wake_verify import parse_preroll, verify_wake
 
 # Firestick Bridge Configuration (for remote control via OCI)
 FIRESTICK_BRIDGE_URL = os.environ.get("FIRESTICK_BRIDGE_URL", "")  # e.g., https://abc123.ngrok.io
@@ -436,6 +442,8 @@ async def startup_event():
     # Start background task for periodic weather updates
     asyncio.create_task(update_weather_periodically())
     print("[STARTUP] Weather monitoring started (updates every 5 minutes)")
+    if not DEVICE_TOKEN:
+        print("[STARTUP] NOVA_DEVICE_TOKEN not set: /voice accepts any device, /scores refuses uploads")
 
     # Initialize Tuya token on startup
     try:
@@ -660,38 +668,35 @@ def chunk_text_for_tts(text: str, max_length: int = 200):
     return chunks
 
 
-async def generate_tts_audio(text: str):
+async def synthesize_tts_chunk(chunk: str, i: int):
     """
-    Generate TTS audio, handling chunking for long text.
-    Splits text into 200-char chunks, generates TTS for each,
-    then concatenates all audio arrays into a single stream.
-    Returns numpy array at 16kHz mono.
+    Synthesize one text chunk. Returns (int16 mono array, provider sample rate),
+    or None if both Orpheus and Edge TTS failed.
     """
     from pydub import AudioSegment
 
-    chunks = chunk_text_for_tts(text, max_length=200)
-    print(f"[TTS] Split into {len(chunks)} chunks for Orpheus")
-
-    all_audio_arrays = []
+    print(f"[TTS] Processing chunk {i+1}: {chunk[:50]}...")
 
-    for i, chunk in enumerate(chunks):
-        print(f"[TTS] Processing chunk {i+1}/{len(chunks)}: {chunk[:50]}...")
-
-        try:
-            # Try Orpheus TTS with female voice
+    try:
+        # Try Orpheus TTS with female voice
+        # (blocking SDK call - run in a thread so earlier chunks keep streaming)
+        def orpheus():
             tts_response = client.audio.speech.create(
                 model="canopylabs/orpheus-v1-english",
                 voice="diana",  # Female voice (natural and warm)
                 input=chunk,
                 response_format="wav"
             )
-            wav_bytes = tts_response.read()
-            print(f"[TTS] Orpheus succeeded for chunk {i+1}")
+            return tts_response.read()
 
-        except Exception as e:
-            print(f"[TTS] Orpheus failed for chunk {i+1}: {e}")
-            print("[TTS] Falling back to Edge TTS for this chunk...")
+        wav_bytes = await asyncio.to_thread(orpheus)
+        print(f"[TTS] Orpheus succeeded for chunk {i+1}")
+
+    except Exception as e:
+        print(f"[TTS] Orpheus failed for chunk {i+1}: {e}")
+        print("[TTS] Falling back to Edge TTS for this chunk...")
 
+        try:
             # Fallback to Edge TTS - remove expression tags
             clean_chunk = re.sub(r'<[^>]+>', '', chunk)
 
@@ -711,51 +716,66 @@ async def generate_tts_audio(text: str):
             wav_buffer.seek(0)
             wav_bytes = wav_buffer.read()
             print(f"[TTS] Edge TTS succeeded for chunk {i+1}")
+        except Exception as e:
+            print(f"[ERR] Edge TTS failed for chunk {i+1}: {e}")
+            return None
+
+    # Load WAV into Pydub
+    try:
+        audio_segment = AudioSegment.from_wav(io.BytesIO(wav_bytes))
 
+        # CRITICAL: set_frame_rate() doesn't actually resample - it just changes metadata!
+        # Resampling (if needed) happens in stream_tts_chunks() with scipy
 
-        # Load WAV into Pydub
-        try:
-            audio_segment = AudioSegment.from_wav(io.BytesIO(wav_bytes))
-
-            # CRITICAL: Properly resample from 24kHz (Groq native) to 16kHz
-            # set_frame_rate() doesn't actually resample - it just changes metadata!
-            # We need scipy for proper resampling with interpolation
-
-            # First, get raw samples
-            audio_samples = np.array(audio_segment.get_array_of_samples(), dtype=np.int16)
-            original_rate = audio_segment.frame_rate
-            target_rate = 16000
-
-            if original_rate != target_rate:
-                # Use scipy for proper resampling with interpolation
-                from scipy import signal
-                num_samples_new = int(len(audio_samples) * target_rate / original_rate)
-                audio_array = signal.resample(audio_samples, num_samples_new)
-                audio_array = np.int16(np.clip(audio_array, -32768, 32767))
-                print(f"[TTS] Chunk {i+1} resampled: {original_rate}Hz → {target_rate}Hz ({len(audio_array)} samples)")
-            else:
-                audio_array = audio_samples
-                print(f"[TTS] Chunk {i+1} already {target_rate}Hz ({len(audio_array)} samples)")
+        # First, get raw samples
+        audio_samples = np.array(audio_segment.get_array_of_samples(), dtype=np.int16)
 
-            # Ensure mono
-            if audio_segment.channels > 1:
-                audio_array = np.mean([audio_array[j::audio_segment.channels] for j in range(audio_segment.channels)], axis=0).astype(np.int16)
+        # Ensure mono (before resampling, so channels stay interleaved correctly)
+        if audio_segment.channels > 1:
+            audio_samples = np.mean([audio_samples[j::audio_segment.channels] for j in range(audio_segment.channels)], axis=0).astype(np.int16)
 
-            all_audio_arrays.append(audio_array)
+        return audio_samples, audio_segment.frame_rate
+
+    except Exception as e:
+        print(f"[ERR] Failed to process audio chunk {i+1}: {e}")
+        return None
+
+
+def stream_tts_audio(text: str, native_rate: bool = False):
+    """
+    Generate TTS audio chunk by chunk, handling chunking for long text.
+    Splits text into 200-char chunks and yields (numpy array, sample rate)
+    for each one as soon as it is synthesized, mono.
+    With native_rate=False the rate is always 16kHz. With native_rate=True the
+    first chunk's provider rate is kept (the ESP32 resamples or re-clocks I2S),
+    and only chunks from a different provider are converted to match it.
+    """
+    chunks = chunk_text_for_tts(text, max_length=200)
+    print(f"[TTS] Split into {len(chunks)} chunks for Orpheus")
+    return stream_tts_chunks(chunks, synthesize_tts_chunk, native_rate=native_rate)
 
-        except Exception as e:
-            print(f"[ERR] Failed to process audio chunk {i+1}: {e}")
-            continue
+
+async def generate_tts_audio(text: str, native_rate: bool = False):
+    """
+    Generate the whole reply at once (for queued audio and the dashboard).
+    Concatenates all stream_tts_audio() chunks into a single array.
+    Returns (numpy array, sample rate), mono.
+    """
+    all_audio_arrays = []
+    output_rate = 16000
+
+    async for audio_array, output_rate in stream_tts_audio(text, native_rate=native_rate):
+        all_audio_arrays.append(audio_array)
 
     if not all_audio_arrays:
-        return np.array([], dtype=np.int16)
+        return np.array([], dtype=np.int16), output_rate
 
     # Concatenate all chunks
     final_audio = np.concatenate(all_audio_arrays)
-    print(f"[TTS] Combined {len(chunks)} chunks into {len(final_audio)} samples")
-    print(f"[TTS] Total audio duration: {len(final_audio) / 16000:.2f} seconds")
+    print(f"[TTS] Combined {len(all_audio_arrays)} chunks into {len(final_audio)} samples")
+    print(f"[TTS] Total audio duration: {len(final_audio) / output_rate:.2f} seconds ({output_rate}Hz)")
 
-    return final_audio
+    return final_audio, output_rate
 
 
 async def run_scheduled_job(seconds: int, message: str):
@@ -768,7 +788,7 @@ async def run_scheduled_job(seconds: int, message: str):
     try:
         # Generate TTS for the scheduled message
         # This uses the same pipeline logic but purely backend-initiated
-        audio_array = await generate_tts_audio(message)
+        audio_array, _ = await generate_tts_audio(message)
         
         # 50% volume and clip (Standard processing)
         audio_array = np.clip(audio_array * 0.5, -32768, 32767).astype(np.int16)
@@ -784,14 +804,14 @@ async def run_scheduled_job(seconds: int, message: str):
     except Exception as e:
         print(f"[SCHEDULE] Job failed: {e}")
 
-async def process_ai_pipeline(user_text: str):
+async def process_ai_pipeline(user_text: str, native_rate: bool = False, stream: bool = False, started_at: float = None):
     """
     Common pipeline for Voice and Text input:
     1. Add user text to history
     2. Query LLM
     3. Process Smart Home/Firestick commands
-    4. Generate TTS Audio
-    5. Return Response object
+    4. Generate TTS Audio (at the provider's rate if native_rate, else 16kHz)
+    5. Return Response object (StreamingResponse per TTS chunk if stream)
     """
     # 1. Add user message to conversation history
     add_to_history("user", user_text)
@@ -835,9 +855,12 @@ async def process_ai_pipeline(user_text: str):
     # 5. Text-to-Speech with smart chunking (handles long responses)
     print(f"[TTS] Generating speech for {len(ai_text)} character response...")
 
+    if stream:
+        return await stream_ai_audio(ai_text, expression_code, firestick_cmd, native_rate, started_at)
+
     try:
         # Use new chunked TTS generation function
-        audio_array = await generate_tts_audio(ai_text)
+        audio_array, sample_rate = await generate_tts_audio(ai_text, native_rate=native_rate)
 
         # Volume set to 50% for comfortable listening
         audio_array = np.clip(audio_array * 0.5, -32768, 32767).astype(np.int16)
@@ -846,15 +869,15 @@ async def process_ai_pipeline(user_text: str):
         # ESP32 will handle mono-to-stereo duplication for I2S
         pcm_bytes = audio_array.tobytes()
         
-        print(f"[AUDIO] Final output: {len(pcm_bytes)} bytes of raw PCM (16kHz, 16-bit, MONO)")
-        print(f"[AUDIO] Duration: {len(audio_array) / 16000:.2f} seconds")
+        print(f"[AUDIO] Final output: {len(pcm_bytes)} bytes of raw PCM ({sample_rate}Hz, 16-bit, MONO)")
+        print(f"[AUDIO] Duration: {len(audio_array) / sample_rate:.2f} seconds")
         if firestick_cmd:
             print(f"[FIRESTICK] Sending command to ESP32: {firestick_cmd}")
         print(f"[SEND] Sending response to ESP32...")
 
         # Build response headers
         headers = {
-            "X-Audio-Sample-Rate": "16000",
+            "X-Audio-Sample-Rate": str(sample_rate),
             "X-Audio-Channels": "1",
             "X-Audio-Bits": "16",
             "X-Expression": str(expression_code),
@@ -877,11 +900,58 @@ async def process_ai_pipeline(user_text: str):
         traceback.print_exc()
         return Response(content=b"Audio processing error", status_code=500)
 
+def wants_native_rate(request: Request) -> bool:
+    """ESP32 firmware that can resample on-device sends X-Audio-Native-Rate: 1"""
+    return request.headers.get("x-audio-native-rate") == "1"
+
+async def stream_ai_audio(ai_text: str, expression_code, firestick_cmd, native_rate: bool, started_at: float = None):
+    """
+    Stream the reply as each TTS chunk completes (HTTP chunked encoding).
+    Headers go out with the first chunk, so the ESP32 starts playing while
+    the rest of the reply is still being synthesized.
+    """
+    started_at = started_at or time.monotonic()
+    audio_stream = stream_tts_audio(ai_text, native_rate=native_rate)
+    first = await first_audio_chunk(audio_stream)
+
+    if first is None:
+        print("[ERR] TTS produced no audio")
+        return Response(content=b"Audio processing error", status_code=500)
+
+    sample_rate = first[1]
+    print(f"[SEND] Streaming response to ESP32 ({sample_rate}Hz, 16-bit, MONO)")
+    if firestick_cmd:
+        print(f"[FIRESTICK] Sending command to ESP32: {firestick_cmd}")
+
+    headers = {
+        "X-Audio-Sample-Rate": str(sample_rate),
+        "X-Audio-Channels": "1",
+        "X-Audio-Bits": "16",
+        "X-Expression": str(expression_code),
+        "X-Accel-Buffering": "no"  # Don't let nginx hold chunks back
+    }
+    if firestick_cmd:
+        headers["X-Firestick-Cmd"] = firestick_cmd
+
+    return StreamingResponse(
+        pcm_byte_stream(first, audio_stream, volume=0.5, started_at=started_at),
+        media_type="application/octet-stream",
+        headers=headers
+    )
+
+def wants_stream(request: Request) -> bool:
+    """ESP32 firmware that decodes chunked responses sends X-Audio-Stream: 1"""
+    return request.headers.get("x-audio-stream") == "1"
+
 @app.post("/voice")
 async def process_voice(request: Request):
     """
     Receive raw PCM audio, process with AI, return WAV audio response.
     """
+    started_at = time.monotonic()
+    if not device_authorized(request.headers):
+        return Response(content=b"Unknown device", status_code=401)
+    ingest_telemetry(request.headers)
     try:
         # Read raw PCM data from request
         pcm_data = await request.body()
@@ -889,6 +959,18 @@ async def process_voice(request: Request):
     except Exception as e:
         print(f"[ERR] Failed to read request body: {e}")
         return Response(content=b"Error reading audio", status_code=400)
+
+    # Wake word turns lead with the audio that woke the device: second opinion, then drop it
+    preroll_samples = parse_preroll(request.headers.get("x-wake-preroll"), len(pcm_data))
+    if preroll_samples:
+        verdict = await asyncio.to_thread(verify_wake, pcm_data, preroll_samples)
+        if verdict:
+            print(f"[WAKE] Verifier score {verdict['score']:.2f} (threshold {verdict['threshold']:.2f}, "
+                  f"{verdict['latency_us'] / 1000:.1f} ms)")
+        if verdict and not verdict["accepted"]:
+            print("[WAKE] False wake, skipping STT")
+            return Response(status_code=204, headers={"X-Wake-Rejected": "1"})
+        pcm_data = pcm_data[preroll_samples * 2:]
     
     # Convert PCM to WAV for Whisper
     wav_buffer = io.BytesIO()
@@ -917,7 +999,8 @@ async def process_voice(request: Request):
         print(f"[ERR] Whisper STT failed: {e}")
         user_text = "Hello"  # Fallback to greeting
     
-    return await process_ai_pipeline(user_text)
+    return await process_ai_pipeline(user_text, native_rate=wants_native_rate(request),
+                                     stream=wants_stream(request), started_at=started_at)
 
 from pydantic import BaseModel
 
@@ -925,17 +1008,38 @@ class TextRequest(BaseModel):
     text: str
 
 @app.post("/text")
-async def process_text(request: TextRequest):
+async def process_text(request: TextRequest, raw_request: Request):
     """
     Receive text input, process with AI, return WAV audio response.
     """
+    started_at = time.monotonic()
+    ingest_telemetry(raw_request.headers)
     print(f"[RECV] Received text input: {request.text}")
-    return await process_ai_pipeline(request.text)
+    return await process_ai_pipeline(request.text, native_rate=wants_native_rate(raw_request),
+                                     stream=wants_stream(raw_request), started_at=started_at)
 
 
 
 
 
+@app.get("/telemetry")
+async def get_telemetry(device_id: str | None = None):
+    """Per-stage p50/p95 of device turn latency (see src/telemetry.h)"""
+    return telemetry_summary(device_id)
+
+@app.post("/scores")
+async def upload_scores(request: Request):
+    """Wake word score ring dumped by the device (see src/score_capture.h)"""
+    if not device_authorized(request.headers, stores_data=True):
+        return Response(content=b"Unknown device", status_code=401 if DEVICE_TOKEN else 403)
+    try:
+        raw = await read_score_upload(request.stream(), request.headers.get("content-length"))
+        return store_score_dump(raw, request.headers.get("x-device-id", "unknown"))
+    except ScoreDumpTooLarge as e:
+        return Response(content=str(e), status_code=413)
+    except ValueError as e:
+        return Response(content=str(e), status_code=400)
+
 @app.get("/status")
 async def get_status():
     """Get system status for Dashboard"""
@@ -1026,7 +1130,7 @@ async def speak_text(req: TTSSpeechRequest):
     # Actually, we likely want the AI to Reply.
     # But if this is "Make AI Speak X", we use TTS directly.
     
-    audio_array = await generate_tts_audio(req.text)
+    audio_array, _ = await generate_tts_audio(req.text)
     
     # 50% volume and clip
     audio_array = np.clip(audio_array * 0.5, -32768, 32767).astype(np.int16)
@@ -1087,7 +1191,7 @@ async def chat_send(req: TTSSpeechRequest):
         print(f"[FIRESTICK] Chat command for ESP32: {firestick_cmd}")
     
     # 4. Generate Audio
-    audio_array = await generate_tts_audio(ai_text)
+    audio_array, _ = await generate_tts_audio(ai_text)
     audio_array = np.clip(audio_array * 0.5, -32768, 32767).astype(np.int16)
     pcm_bytes = audio_array.tobytes()
     expression = extract_expression(ai_text)
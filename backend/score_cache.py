@@ -0,0 +1,106 @@
+"""
+Wake word score dumps for NOVA
+The ESP32 uploads its PSRAM ring of per-slice classifier results (src/score_capture.h)
+in the Edge Impulse SDK score cache format (classifier/ei_score_cache.h).
+Dumps are kept as .eisc files, readable here or by tools/wake_eval. Uploads
+are capped at SCORE_DUMP_MAX_BYTES and only the newest SCORE_DUMP_KEEP are kept.
+"""
+
+import os
+import re
+import struct
+import time
+
+import numpy as np
+
+# Must match ei_score_cache_header_t / ei_score_cache_record_t
+SCORE_CACHE_MAGIC = 0x43534945  # "EISC"
+SCORE_CACHE_VERSION = 1
+SCORE_CACHE_STREAMING = 0xFFFFFFFF
+HEADER_FORMAT = "<IHHHHIIIIfiIQq"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+HEADER_FIELDS = [
+    "magic", "version", "header_size", "label_count", "feature_count", "record_size",
+    "record_count", "slice_size", "frequency", "input_scale", "input_zero_point",
+    "reserved", "source_size", "source_mtime",
+]
+RECORD_HEAD_SIZE = 16
+
+SCORE_DUMP_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "score_dumps")
+# The device's 1200-slice ring (SCORE_CAPTURE_SLICES) dumps at about 800 KB
+SCORE_DUMP_MAX_BYTES = int(os.environ.get("SCORE_DUMP_MAX_BYTES", 2 * 1024 * 1024))
+SCORE_DUMP_KEEP = int(os.environ.get("SCORE_DUMP_KEEP", 100))
+
+
+class ScoreDumpTooLarge(ValueError):
+    pass
+
+
+async def read_score_upload(chunks, content_length=None) -> bytes:
+    """Body of an upload from an async iterator of chunks, up to SCORE_DUMP_MAX_BYTES.
+    Raises ScoreDumpTooLarge as soon as the declared or the received size is over it"""
+    if content_length is not None and int(content_length) > SCORE_DUMP_MAX_BYTES:
+        raise ScoreDumpTooLarge(f"{content_length} bytes, limit {SCORE_DUMP_MAX_BYTES}")
+    body = bytearray()
+    async for chunk in chunks:
+        body += chunk
+        if len(body) > SCORE_DUMP_MAX_BYTES:
+            raise ScoreDumpTooLarge(f"over {SCORE_DUMP_MAX_BYTES} bytes")
+    return bytes(body)
+
+
+def prune_score_dumps(keep: int):
+    """Delete all but the newest keep dumps"""
+    dumps = sorted((entry for entry in os.scandir(SCORE_DUMP_DIR) if entry.name.endswith(".eisc")),
+                   key=lambda entry: (entry.stat().st_mtime, entry.name))
+    for entry in dumps[:max(len(dumps) - keep, 0)]:
+        os.remove(entry.path)
+
+
+def parse_score_cache(raw: bytes):
+    """Header dict plus numpy views of the records. Raises ValueError on bad input"""
+    if len(raw) < HEADER_SIZE:
+        raise ValueError("too short for a score cache header")
+    header = dict(zip(HEADER_FIELDS, struct.unpack_from(HEADER_FORMAT, raw)))
+    if header["magic"] != SCORE_CACHE_MAGIC or header["version"] != SCORE_CACHE_VERSION:
+        raise ValueError("not a score cache (or unsupported version)")
+
+    labels, features = header["label_count"], header["feature_count"]
+    if header["record_size"] < RECORD_HEAD_SIZE + 4 * labels + features or header["record_size"] % 4:
+        raise ValueError("bad record size")
+
+    dtype = np.dtype({
+        "names": ["slice_index", "audio_offset", "dsp_us", "classification_us", "scores", "features"],
+        "formats": ["<u4", "<u4", "<u4", "<u4", ("<f4", (labels,)), ("i1", (features,))],
+        "offsets": [0, 4, 8, 12, 16, 16 + 4 * labels],
+        "itemsize": header["record_size"],
+    })
+    # A truncated tail (interrupted upload) is dropped
+    available = (len(raw) - header["header_size"]) // header["record_size"]
+    count = available if header["record_count"] == SCORE_CACHE_STREAMING else min(header["record_count"], available)
+    records = np.frombuffer(raw, dtype=dtype, count=count, offset=header["header_size"])
+    return header, records
+
+
+def store_score_dump(raw: bytes, device_id: str = "unknown"):
+    """Validate and save an uploaded dump. Returns a summary dict"""
+    if len(raw) > SCORE_DUMP_MAX_BYTES:
+        raise ScoreDumpTooLarge(f"{len(raw)} bytes, limit {SCORE_DUMP_MAX_BYTES}")
+    header, records = parse_score_cache(raw)
+
+    os.makedirs(SCORE_DUMP_DIR, exist_ok=True)
+    safe_device = re.sub(r"[^0-9A-Za-z_-]", "", device_id) or "unknown"
+    path = os.path.join(SCORE_DUMP_DIR, f"{safe_device}_{time.strftime('%Y%m%d_%H%M%S')}.eisc")
+    with open(path, "wb") as f:
+        f.write(raw)
+    prune_score_dumps(SCORE_DUMP_KEEP)
+
+    seconds = len(records) * header["slice_size"] / header["frequency"] if header["frequency"] else 0
+    print(f"[SCORES] {len(records)} slices ({seconds:.0f}s) from {device_id} -> {path}")
+    return {
+        "file": os.path.basename(path),
+        "slices": int(len(records)),
+        "seconds": seconds,
+        "labels": header["label_count"],
+        "features": header["feature_count"],
+    }
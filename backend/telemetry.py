@@ -0,0 +1,81 @@
+"""
+Device turn telemetry for NOVA
+ESP32 piggybacks 32-byte per-turn records (src/telemetry.h) on its next
+request as a hex X-Telemetry header; this keeps them and reports p50/p95.
+"""
+
+import struct
+from collections import deque
+
+import numpy as np
+
+# Must match struct TurnTelemetry in src/telemetry.h
+TELEMETRY_VERSION = 1
+TELEMETRY_FORMAT = "<BBBbIIHHIHHHHHH"
+TELEMETRY_SIZE = struct.calcsize(TELEMETRY_FORMAT)
+TELEMETRY_FIELDS = [
+    "version", "trigger", "flags", "rssi", "turn_id", "started_at",
+    "wake_detect_ms", "record_ms", "trimmed_bytes", "connect_ms", "upload_ms",
+    "first_byte_ms", "first_audio_ms", "playback_ms", "underruns",
+]
+
+# Per-stage columns reported by telemetry_summary()
+TELEMETRY_STAGES = [
+    "wake_detect_ms", "record_ms", "trimmed_bytes", "connect_ms", "upload_ms",
+    "first_byte_ms", "first_audio_ms", "playback_ms", "underruns", "rssi",
+]
+
+TRIGGERS = {1: "wake_word", 2: "button", 3: "text"}
+
+telemetry_records = deque(maxlen=5000)
+
+
+def parse_telemetry(hex_payload: str, device_id: str = "unknown"):
+    """Decode a concatenation of hex-encoded records. Bad input yields []"""
+    try:
+        raw = bytes.fromhex(hex_payload.strip())
+    except ValueError:
+        return []
+
+    records = []
+    for offset in range(0, len(raw) - TELEMETRY_SIZE + 1, TELEMETRY_SIZE):
+        values = struct.unpack_from(TELEMETRY_FORMAT, raw, offset)
+        record = dict(zip(TELEMETRY_FIELDS, values))
+        if record["version"] != TELEMETRY_VERSION:
+            continue
+        record["device_id"] = device_id
+        record["trigger"] = TRIGGERS.get(record["trigger"], str(record["trigger"]))
+        records.append(record)
+    return records
+
+
+def ingest_telemetry(headers):
+    """Store records from a request's X-Telemetry header, if any"""
+    payload = headers.get("x-telemetry")
+    if not payload:
+        return 0
+
+    records = parse_telemetry(payload, headers.get("x-device-id", "unknown"))
+    telemetry_records.extend(records)
+    if records:
+        print(f"[TELEMETRY] {len(records)} turn records from {records[0]['device_id']}")
+    return len(records)
+
+
+def telemetry_summary(device_id: str = None):
+    """p50/p95/max per stage across stored turns (optionally one device)"""
+    records = [r for r in telemetry_records if device_id is None or r["device_id"] == device_id]
+    summary = {"turns": len(records), "devices": len({r["device_id"] for r in records}), "stages": {}}
+
+    for stage in TELEMETRY_STAGES:
+        # 0 means "stage didn't happen" (e.g. wake time on a button turn)
+        values = np.array([r[stage] for r in records if r[stage] != 0], dtype=np.float64)
+        if len(values) == 0:
+            continue
+        summary["stages"][stage] = {
+            "count": int(len(values)),
+            "p50": float(np.percentile(values, 50)),
+            "p95": float(np.percentile(values, 95)),
+            "max": float(values.max()),
+        }
+    return summary
@@ -0,0 +1,114 @@
+"""
+Test wake word score dump parsing and storage
+Builds dumps the same way ei_score_cache_ring_t does (packed little-endian)
+"""
+
+import asyncio
+import os
+import struct
+import tempfile
+
+import numpy as np
+
+import device_auth
+import score_cache
+from device_auth import device_authorized
+from score_cache import (HEADER_FORMAT, HEADER_SIZE, SCORE_CACHE_MAGIC, SCORE_CACHE_STREAMING,
+                         ScoreDumpTooLarge, parse_score_cache, read_score_upload, store_score_dump)
+
+assert HEADER_SIZE == 56, "Must match sizeof(ei_score_cache_header_t)"
+
+LABELS, FEATURES = 3, 637
+RECORD_SIZE = (16 + 4 * LABELS + FEATURES + 3) & ~3
+
+
+def make_dump(count, record_count=None):
+    header = struct.pack(HEADER_FORMAT, SCORE_CACHE_MAGIC, 1, HEADER_SIZE, LABELS, FEATURES, RECORD_SIZE,
+                         count if record_count is None else record_count, 4000, 16000, 0.05, 6, 0, 0, 0)
+    body = b""
+    for i in range(count):
+        record = struct.pack("<IIII", i, 0xFFFFFFFF, 9000, 2500 + i)
+        record += struct.pack("<3f", 0.1 * (i % 10), 0.5, 0.2)
+        record += bytes((i + j) & 0xFF for j in range(FEATURES))
+        body += record + b"\0" * (RECORD_SIZE - len(record))
+    return header + body
+
+
+print("Testing score cache parsing...")
+header, records = parse_score_cache(make_dump(20))
+assert header["label_count"] == LABELS and header["feature_count"] == FEATURES
+assert len(records) == 20
+assert records["slice_index"][7] == 7 and records["classification_us"][7] == 2507
+assert np.isclose(records["scores"][7][0], 0.7) and records["scores"][7][1] == 0.5
+assert records["features"][7][0] == 7 and records["features"][7][200] == (7 + 200) - 256
+print(f"  {len(records)} records, {header['record_size']} bytes each")
+
+_, records = parse_score_cache(make_dump(20)[:-100])
+assert len(records) == 19, "Truncated record must be dropped"
+_, records = parse_score_cache(make_dump(5, record_count=SCORE_CACHE_STREAMING))
+assert len(records) == 5, "Streaming files count from their size"
+
+for bad in [b"", b"x" * 100, make_dump(1)[:-RECORD_SIZE].replace(b"EISC", b"NOPE")]:
+    try:
+        parse_score_cache(bad)
+        assert False, "Bad dump must raise"
+    except ValueError:
+        pass
+
+print("Testing dump storage...")
+with tempfile.TemporaryDirectory() as tmp:
+    score_cache.SCORE_DUMP_DIR = tmp
+    summary = store_score_dump(make_dump(240), "aa:bb:cc/../x")
+    assert summary["slices"] == 240 and summary["seconds"] == 60
+    assert summary["file"].startswith("aabbccx_"), "Device id must be sanitized"
+
+    # Only the newest SCORE_DUMP_KEEP stay
+    score_cache.SCORE_DUMP_KEEP = 3
+    for i in range(5):
+        path = os.path.join(tmp, f"dev{i}_old.eisc")
+        with open(path, "wb") as f:
+            f.write(make_dump(1))
+        os.utime(path, (1000 + i, 1000 + i))
+    summary = store_score_dump(make_dump(2), "newest")
+    kept = sorted(os.listdir(tmp))
+    assert len(kept) == 3 and summary["file"] in kept, kept
+    # The two uploads, then the newest of the old ones
+    assert "dev4_old.eisc" in kept and not any(f"dev{i}_old.eisc" in kept for i in range(4)), kept
+
+
+async def chunks(data, size=1000):
+    for i in range(0, len(data), size):
+        yield data[i:i + size]
+
+
+def upload(data, content_length=None):
+    return asyncio.run(read_score_upload(chunks(data), content_length))
+
+
+print("Testing upload limits...")
+score_cache.SCORE_DUMP_MAX_BYTES = 10000
+assert upload(b"x" * 10000, "10000") == b"x" * 10000
+for data, declared in [(b"x" * 10001, None), (b"x" * 10001, "100"), (b"", "10001")]:
+    try:
+        upload(data, declared)
+        assert False, f"{len(data)} bytes declared as {declared} must be refused"
+    except ScoreDumpTooLarge:
+        pass
+try:
+    store_score_dump(make_dump(20))
+    assert False, "Oversized dump must not be stored"
+except ScoreDumpTooLarge:
+    pass
+
+print("Testing device auth...")
+device_auth.DEVICE_TOKEN = ""
+assert device_authorized({}), "Audio stays open without a token"
+assert not device_authorized({}, stores_data=True), "Uploads need a token"
+device_auth.DEVICE_TOKEN = "s3cret"
+assert device_authorized({"x-device-token": "s3cret"}, stores_data=True)
+assert device_authorized({"x-device-token": "s3cret"})
+for headers in [{}, {"x-device-token": ""}, {"x-device-token": "s3cre"}, {"x-device-token": "S3CRET"}]:
+    assert not device_authorized(headers), headers
+    assert not device_authorized(headers, stores_data=True), headers
+
+print("\n✅ Score cache test passed")
@@ -0,0 +1,114 @@
+"""
+Test streaming TTS: first audio byte must go out after ONE chunk's synthesis,
+not after the whole reply. Uses a stand-in TTS with artificial per-chunk delay
+and a real HTTP/1.1 chunked connection over localhost (no API keys needed).
+"""
+
+import asyncio
+import time
+
+import numpy as np
+
+from tts_stream import stream_tts_chunks, first_audio_chunk, pcm_byte_stream
+
+CHUNK_DELAY = 0.3      # Seconds of fake synthesis per chunk
+CHUNK_SECONDS = 1.0    # Seconds of audio per chunk
+NATIVE_RATE = 24000    # Stand-in provider rate (like Orpheus)
+CHUNKS = ["Hello there!", "This is a test of streaming.", "Each chunk takes a while.",
+          "But playback starts early.", "Goodbye!"]
+
+
+async def fake_tts(chunk: str, i: int):
+    """Stand-in for synthesize_tts_chunk(): sleeps, then returns a tone"""
+    await asyncio.sleep(CHUNK_DELAY)
+    t = np.arange(int(NATIVE_RATE * CHUNK_SECONDS)) / NATIVE_RATE
+    return np.int16(10000 * np.sin(2 * np.pi * (300 + 100 * i) * t)), NATIVE_RATE
+
+
+async def serve(reader, writer):
+    """Minimal HTTP/1.1 server that streams like the FastAPI StreamingResponse"""
+    while (await reader.readline()) not in (b"\r\n", b"\n", b""):
+        pass
+
+    started_at = time.monotonic()
+    audio_stream = stream_tts_chunks(CHUNKS, fake_tts, native_rate=True)
+    first = await first_audio_chunk(audio_stream)
+
+    writer.write(b"HTTP/1.1 200 OK\r\n"
+                 b"Content-Type: application/octet-stream\r\n"
+                 b"Transfer-Encoding: chunked\r\n"
+                 + f"X-Audio-Sample-Rate: {first[1]}\r\n".encode() +
+                 b"Connection: close\r\n\r\n")
+
+    async for pcm in pcm_byte_stream(first, audio_stream, started_at=started_at, label="SERVER"):
+        writer.write(f"{len(pcm):x}\r\n".encode() + pcm + b"\r\n")
+        await writer.drain()
+
+    writer.write(b"0\r\n\r\n")
+    await writer.drain()
+    writer.close()
+
+
+async def client(port: int):
+    """Plays the ESP32's role: measures time to first body byte and total"""
+    sent_at = time.monotonic()
+    reader, writer = await asyncio.open_connection("127.0.0.1", port)
+    writer.write(b"POST /text HTTP/1.1\r\nHost: localhost\r\nX-Audio-Stream: 1\r\n"
+                 b"X-Audio-Native-Rate: 1\r\nConnection: close\r\n\r\n")
+    await writer.drain()
+
+    headers = {}
+    while True:
+        line = (await reader.readline()).decode().strip()
+        if not line:
+            break
+        if ":" in line:
+            name, value = line.split(":", 1)
+            headers[name.strip().lower()] = value.strip()
+
+    first_byte_at = None
+    body = b""
+    while True:
+        size = int((await reader.readline()).strip(), 16)
+        if size == 0:
+            break
+        data = await reader.readexactly(size)
+        await reader.readline()
+        if first_byte_at is None:
+            first_byte_at = time.monotonic()
+        body += data
+
+    writer.close()
+    return headers, first_byte_at - sent_at, time.monotonic() - sent_at, body
+
+
+async def main():
+    print("Testing streaming TTS with stand-in provider "
+          f"({len(CHUNKS)} chunks x {CHUNK_DELAY * 1000:.0f} ms)...")
+
+    server = await asyncio.start_server(serve, "127.0.0.1", 0)
+    port = server.sockets[0].getsockname()[1]
+
+    async with server:
+        headers, ttfb, total, body = await client(port)
+
+    samples = len(body) // 2
+    expected = int(NATIVE_RATE * CHUNK_SECONDS) * len(CHUNKS)
+    sequential = CHUNK_DELAY * len(CHUNKS)
+
+    print(f"\n[CLIENT] Sample rate header: {headers.get('x-audio-sample-rate')}")
+    print(f"[CLIENT] Time to first byte: {ttfb * 1000:.0f} ms")
+    print(f"[CLIENT] Total: {total * 1000:.0f} ms (full-reply buffering would need {sequential * 1000:.0f} ms before byte 1)")
+    print(f"[CLIENT] Received {samples} samples (expected {expected})")
+
+    assert headers.get("transfer-encoding") == "chunked"
+    assert headers.get("x-audio-sample-rate") == str(NATIVE_RATE)
+    assert samples == expected, "Audio lost in streaming"
+    assert ttfb < CHUNK_DELAY * 2, "First byte waited for more than one chunk"
+    assert ttfb < sequential / 2, "Streaming gave no time-to-first-byte gain"
+
+    print("\n✅ Streaming TTS test passed")
+
+
+if __name__ == "__main__":
+    asyncio.run(main())
@@ -0,0 +1,47 @@
+"""
+Test device telemetry decoding and per-stage percentiles
+Builds records the same way the ESP32 does (packed little-endian, hex header)
+"""
+
+import random
+import struct
+
+from telemetry import (TELEMETRY_FORMAT, TELEMETRY_SIZE, parse_telemetry,
+                       ingest_telemetry, telemetry_summary, telemetry_records)
+
+assert TELEMETRY_SIZE == 32, "Must match sizeof(TurnTelemetry) in src/telemetry.h"
+
+
+def make_record(turn_id, first_byte_ms, trigger=1):
+    return struct.pack(TELEMETRY_FORMAT, 1, trigger, 0x08, -55, turn_id, 1000 * turn_id,
+                       40, 3200, 64000, 35, 120, first_byte_ms, first_byte_ms + 250, 4000, 0)
+
+
+print("Testing telemetry parsing...")
+payload = (make_record(1, 900) + make_record(2, 1100, trigger=2)).hex()
+records = parse_telemetry(payload, "aa:bb")
+assert len(records) == 2
+assert records[0]["trigger"] == "wake_word" and records[1]["trigger"] == "button"
+assert records[0]["rssi"] == -55 and records[1]["first_audio_ms"] == 1350
+print(f"  Decoded: {records[0]}")
+
+assert parse_telemetry("not hex") == []
+assert parse_telemetry(payload[:-2], "aa:bb") == records[:1], "Truncated record must be dropped"
+
+print("Testing fleet summary...")
+telemetry_records.clear()
+random.seed(1)
+for device in ["dev-a", "dev-b", "dev-c"]:
+    hex_records = "".join(make_record(i, random.randint(500, 1500)).hex() for i in range(100))
+    assert ingest_telemetry({"x-telemetry": hex_records, "x-device-id": device}) == 100
+
+summary = telemetry_summary()
+ttfb = summary["stages"]["first_byte_ms"]
+print(f"  {summary['turns']} turns from {summary['devices']} devices")
+print(f"  first_byte_ms p50={ttfb['p50']:.0f} p95={ttfb['p95']:.0f} max={ttfb['max']:.0f}")
+assert summary["turns"] == 300 and summary["devices"] == 3
+assert 500 <= ttfb["p50"] <= ttfb["p95"] <= ttfb["max"] <= 1500
+assert "underruns" not in summary["stages"], "All-zero stages are omitted"
+assert telemetry_summary("dev-b")["turns"] == 100
+
+print("\n✅ Telemetry test passed")
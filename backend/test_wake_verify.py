@@ -0,0 +1,110 @@
+"""
+Test the wake word verifier client
+Talks to a stand-in verifier speaking the wake_verifier.h protocol, and to the
+real one (tools/wake_verify/build/wake_verify) if it has been built
+"""
+
+import os
+import socket
+import struct
+import subprocess
+import tempfile
+import threading
+import time
+
+from wake_verify import (REQUEST_FORMAT, RESPONSE_FORMAT, RESPONSE_SIZE, WAKE_VERIFY_MAGIC,
+                         parse_preroll, verify_wake)
+
+assert struct.calcsize(REQUEST_FORMAT) == 16, "Must match sizeof(WakeVerifyRequest)"
+assert RESPONSE_SIZE == 32, "Must match sizeof(WakeVerifyResponse)"
+
+
+def fake_verifier(path, requests, reply=True):
+    """Accept one connection, record the request, answer 'accepted' if the audio is loud"""
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(path)
+    server.listen(1)
+
+    def run():
+        conn, _ = server.accept()
+        with conn:
+            head = conn.recv(16, socket.MSG_WAITALL)
+            magic, count, preroll, flags = struct.unpack(REQUEST_FORMAT, head)
+            pcm = conn.recv(count * 2, socket.MSG_WAITALL) if count else b""
+            requests.append((magic, count, preroll, flags, pcm))
+            if reply:
+                loud = max(abs(s) for s in struct.unpack(f"<{count}h", pcm)) > 1000
+                conn.sendall(struct.pack(RESPONSE_FORMAT, WAKE_VERIFY_MAGIC, 0, int(loud),
+                                         0.97 if loud else 0.2, 0.9, 26, 5500, 0))
+            else:
+                time.sleep(0.5)
+        server.close()
+
+    thread = threading.Thread(target=run, daemon=True)
+    thread.start()
+    return thread
+
+
+print("Testing X-Wake-Preroll parsing...")
+assert parse_preroll("20000", 64000) == 20000
+assert parse_preroll(None, 64000) == 0
+assert parse_preroll("junk", 64000) == 0
+assert parse_preroll("-5", 64000) == 0
+assert parse_preroll("40000", 64000) == 0, "Pre-roll can't be longer than the upload"
+
+with tempfile.TemporaryDirectory() as tmp:
+    path = os.path.join(tmp, "verify.sock")
+
+    print("Testing requests and verdicts...")
+    requests = []
+    loud = struct.pack("<4h", 0, 3000, -3000, 0) * 20000
+    thread = fake_verifier(path, requests)
+    verdict = verify_wake(loud, 20000, socket_path=path)
+    thread.join()
+    magic, count, preroll, flags, pcm = requests[0]
+    assert magic == WAKE_VERIFY_MAGIC and preroll == 20000 and flags == 0
+    assert count == 48000 and pcm == loud[:96000], "Only the first 3s are sent"
+    assert verdict["accepted"] is True and abs(verdict["score"] - 0.97) < 1e-6
+    assert verdict["windows"] == 26 and verdict["latency_us"] == 5500
+    print(f"  {verdict}")
+
+    os.unlink(path)
+    thread = fake_verifier(path, requests)
+    verdict = verify_wake(b"\x10\x00" * 30000, 20000, socket_path=path)
+    thread.join()
+    assert verdict["accepted"] is False
+
+    print("Testing fail-open...")
+    assert verify_wake(loud, 20000, socket_path="") is None, "No socket configured"
+    assert verify_wake(loud, 20000, socket_path=os.path.join(tmp, "missing.sock")) is None
+    os.unlink(path)
+    thread = fake_verifier(path, requests, reply=False)
+    start = time.monotonic()
+    assert verify_wake(loud, 20000, socket_path=path, timeout_ms=100) is None, "Silent verifier must time out"
+    assert time.monotonic() - start < 0.4
+    thread.join()
+
+    binary = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tools", "wake_verify", "build", "wake_verify")
+    if os.path.exists(binary):
+        print("Testing the native verifier...")
+        path = os.path.join(tmp, "native.sock")
+        proc = subprocess.Popen([binary, "serve", "--socket", path, "-j", "2"],
+                                stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        try:
+            for _ in range(100):
+                if os.path.exists(path):
+                    break
+                time.sleep(0.05)
+            verdict = verify_wake(b"\0\0" * 24000, 20000, socket_path=path, timeout_ms=2000)
+            assert verdict and verdict["status"] == 0 and verdict["windows"] == 26
+            assert verdict["accepted"] is False, "Silence is no wake word"
+            short = verify_wake(b"\0\0" * 8000, 0, socket_path=path, timeout_ms=2000)
+            assert short["status"] == 1 and short["accepted"] is True, "Too short fails open"
+            print(f"  silence: score {verdict['score']:.3f} in {verdict['latency_us'] / 1000:.1f} ms")
+        finally:
+            proc.terminate()
+            proc.wait()
+    else:
+        print("Native verifier not built (tools/wake_verify/build.sh), skipping")
+
+print("All wake verify tests passed!")
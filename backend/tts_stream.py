@@ -0,0 +1,103 @@
+"""
+Streaming TTS helpers for NOVA
+Yields PCM per text chunk as soon as it is synthesized, instead of
+concatenating the whole reply before the first byte goes out.
+"""
+
+import asyncio
+import time
+from math import gcd
+
+import numpy as np
+
+
+def resample_audio(audio_samples, original_rate: int, target_rate: int):
+    """
+    Polyphase resample int16 mono audio (scipy.signal.resample_poly).
+    Unlike signal.resample this needs no full-buffer FFT.
+    """
+    if original_rate == target_rate:
+        return audio_samples
+
+    from scipy import signal
+    g = gcd(original_rate, target_rate)
+    audio_array = signal.resample_poly(audio_samples.astype(np.float32), target_rate // g, original_rate // g)
+    return np.int16(np.clip(audio_array, -32768, 32767))
+
+
+async def stream_tts_chunks(chunks, synthesize, native_rate: bool = False):
+    """
+    Synthesize text chunks in order and yield (int16 mono array, sample rate).
+
+    synthesize(chunk, index) is an async callable returning (samples, rate),
+    or None if that chunk failed. The next chunk is already being synthesized
+    while the caller sends the current one.
+
+    With native_rate=False everything is 16kHz. With native_rate=True the
+    first chunk's rate is kept and later chunks are converted to match it.
+    """
+    output_rate = None if native_rate else 16000
+    if not chunks:
+        return
+
+    pending = asyncio.ensure_future(synthesize(chunks[0], 0))
+    try:
+        for i in range(len(chunks)):
+            result = await pending
+            if i + 1 < len(chunks):
+                pending = asyncio.ensure_future(synthesize(chunks[i + 1], i + 1))
+
+            if result is None:
+                continue
+
+            samples, rate = result
+            if output_rate is None:
+                output_rate = rate
+
+            if rate != output_rate:
+                samples = resample_audio(samples, rate, output_rate)
+                print(f"[TTS] Chunk {i+1} resampled: {rate}Hz → {output_rate}Hz ({len(samples)} samples)")
+
+            yield samples, output_rate
+    finally:
+        # Client went away mid-reply: don't leave a synthesis running
+        if not pending.done():
+            pending.cancel()
+
+
+async def first_audio_chunk(audio_stream):
+    """
+    Pull the first chunk so its sample rate can go in the response headers.
+    Returns (samples, rate) or None if nothing was synthesized.
+    """
+    try:
+        return await audio_stream.__anext__()
+    except StopAsyncIteration:
+        return None
+
+
+async def pcm_byte_stream(first, audio_stream, volume: float = 0.5, started_at: float = None, label: str = "STREAM"):
+    """
+    Turn (samples, rate) chunks into raw PCM bytes for a StreamingResponse.
+    Logs time-to-first-byte and total time relative to started_at.
+    """
+    started_at = started_at or time.monotonic()
+    total_samples = 0
+    rate = first[1]
+
+    async def chunks():
+        yield first
+        async for item in audio_stream:
+            yield item
+
+    index = 0
+    async for samples, rate in chunks():
+        audio = np.clip(samples * volume, -32768, 32767).astype(np.int16)
+        total_samples += len(audio)
+        if index == 0:
+            print(f"[{label}] Time to first byte: {(time.monotonic() - started_at) * 1000:.0f} ms")
+        index += 1
+        yield audio.tobytes()
+
+    print(f"[{label}] Sent {index} chunks, {total_samples / rate:.2f}s of audio in "
+          f"{(time.monotonic() - started_at) * 1000:.0f} ms")
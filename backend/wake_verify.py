@@ -0,0 +1,68 @@
+"""
+Server-side wake word check for NOVA
+Wake word turns upload the device's pre-roll (src/wake_preroll.h) ahead of the
+recording. The native verifier (tools/wake_verify, `wake_verify serve`)
+re-classifies the start of the upload over a Unix socket, so a false wake is
+dropped before it costs an STT + LLM + TTS round trip.
+Fails open: without a verifier, or on any error, the device's decision stands.
+"""
+
+import os
+import socket
+import struct
+
+# Must match WakeVerifyRequest / WakeVerifyResponse in tools/wake_verify/wake_verifier.h
+WAKE_VERIFY_MAGIC = 0x5657564E  # "NVWV"
+REQUEST_FORMAT = "<IIII"
+RESPONSE_FORMAT = "<IiIffIII"
+RESPONSE_SIZE = struct.calcsize(RESPONSE_FORMAT)
+RESPONSE_FIELDS = ["magic", "status", "accepted", "score", "threshold", "windows", "latency_us", "reserved"]
+
+WAKE_VERIFY_SOCKET = os.environ.get("WAKE_VERIFY_SOCKET", "")  # Unset turns the check off
+WAKE_VERIFY_TIMEOUT_MS = int(os.environ.get("WAKE_VERIFY_TIMEOUT_MS", "250"))
+
+# The verifier only looks at the first 1.5s; no point sending a whole utterance
+SAMPLE_RATE = 16000
+MAX_SAMPLES = 3 * SAMPLE_RATE
+
+
+def parse_preroll(header_value, body_size: int) -> int:
+    """Pre-roll samples announced by an X-Wake-Preroll header, 0 if absent or bogus"""
+    try:
+        samples = int(header_value or 0)
+    except ValueError:
+        return 0
+    return samples if 0 < samples * 2 <= body_size else 0
+
+
+def verify_wake(pcm: bytes, preroll_samples: int, socket_path: str = None, timeout_ms: int = None):
+    """Verifier's verdict on an upload (pre-roll first) as a dict, or None if there is none"""
+    path = WAKE_VERIFY_SOCKET if socket_path is None else socket_path
+    if not path:
+        return None
+
+    count = min(len(pcm) // 2, MAX_SAMPLES)
+    request = struct.pack(REQUEST_FORMAT, WAKE_VERIFY_MAGIC, count, preroll_samples, 0) + pcm[:count * 2]
+    raw = b""
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+            sock.settimeout((WAKE_VERIFY_TIMEOUT_MS if timeout_ms is None else timeout_ms) / 1000)
+            sock.connect(path)
+            sock.sendall(request)
+            while len(raw) < RESPONSE_SIZE:
+                chunk = sock.recv(RESPONSE_SIZE - len(raw))
+                if not chunk:
+                    break
+                raw += chunk
+    except OSError as e:
+        print(f"[WAKE] Verifier unavailable ({e}), keeping the device's decision")
+        return None
+
+    if len(raw) < RESPONSE_SIZE:
+        return None
+    verdict = dict(zip(RESPONSE_FIELDS, struct.unpack(RESPONSE_FORMAT, raw)))
+    if verdict["magic"] != WAKE_VERIFY_MAGIC:
+        return None
+    verdict["accepted"] = bool(verdict["accepted"])
+    del verdict["magic"], verdict["reserved"]
+    return verdict
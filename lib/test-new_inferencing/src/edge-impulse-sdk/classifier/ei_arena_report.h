@@ -0,0 +1,358 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_ARENA_REPORT_H_
+#define _EI_ARENA_REPORT_H_
+
+/**
+ * Arena report: runs a TFLite flatbuffer once through a RecordingMicroAllocator
+ * and breaks down what it takes from the tensor arena, to size the arena of
+ * interpreter (non-EON) builds before a firmware build instead of guessing.
+ *
+ *   persistent       tail, lives as long as the interpreter: eval tensors,
+ *                    quantization data, node/registration arrays, kernel op
+ *                    data (AllocatePersistentBuffer), variable tensors
+ *   non-persistent   head, the memory plan: activations and kernel scratch
+ *                    buffers, overlapped by lifetime by the memory planner
+ *   buffers          every planned buffer with its operator lifetime and
+ *                    offset in the plan (tensor index, or -1 for scratch)
+ *
+ * plus the minimal arena: the smallest size a plain MicroInterpreter (what
+ * inference_tflite_setup() creates) gets through AllocateTensors() with. It
+ * is found by bisection, as planning needs temporary head room beyond the
+ * final plan. Kernels request different scratch on different targets
+ * (CMSIS-NN, ESP-NN, ...), so run it with the target's kernel flags.
+ *
+ * tools/arena_report is the host CLI around it.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include "edge-impulse-sdk/dsp/returntypes.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_helpers.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_planner/linear_memory_planner.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_interpreter.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_op_resolver.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/recording_micro_interpreter.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
+
+typedef enum {
+    EI_ARENA_PLANNER_GREEDY = 0,    // MicroInterpreter's default
+    EI_ARENA_PLANNER_LINEAR = 1,    // no reuse, every buffer gets its own range
+} ei_arena_planner_t;
+
+typedef struct {
+    int32_t subgraph;
+    int32_t tensor;                 // index in the subgraph, -1 for a kernel scratch buffer
+    uint32_t bytes;                 // size in the plan (aligned)
+    uint32_t offset;                // offset in the head section
+    int32_t first_used;             // operator that creates it, -1 for the model inputs
+    int32_t last_used;              // last operator that reads it
+} ei_arena_buffer_t;
+
+typedef struct {
+    ei_arena_planner_t planner;
+    size_t used_bytes;              // persistent_bytes + non_persistent_bytes, as arena_used_bytes()
+    size_t persistent_bytes;        // tail
+    size_t non_persistent_bytes;    // head: the memory plan
+    size_t activation_bytes;        // tensors in the plan, summed without reuse
+    size_t scratch_bytes;           // kernel scratch buffers in the plan, summed
+    size_t live_peak_bytes;         // most bytes live during one operator: the floor for any planner
+    int32_t live_peak_operator;
+    // persistent (tail) breakdown, recorded by RecordingMicroAllocator
+    tflite::RecordedAllocation eval_tensors;
+    tflite::RecordedAllocation tflite_tensors;
+    tflite::RecordedAllocation quantization;
+    tflite::RecordedAllocation op_data;
+    tflite::RecordedAllocation variables;
+    tflite::RecordedAllocation node_registrations;
+    size_t buffer_count;            // planned buffers, may exceed the capacity passed in
+    size_t minimal_arena_size;      // 0 if not searched
+} ei_arena_report_t;
+
+namespace ei {
+namespace arena_report {
+
+// Passes through to the real planner and keeps each buffer's lifetime and
+// offset; the offsets live in the planner's scratch, which is gone once the
+// plan is committed
+class RecordingPlanner : public tflite::MicroMemoryPlanner {
+public:
+    RecordingPlanner(tflite::MicroMemoryPlanner *planner, ei_arena_buffer_t *buffers, size_t capacity)
+        : planner_(planner), buffers_(buffers), capacity_(capacity), count_(0) { }
+
+    TfLiteStatus Init(unsigned char *scratch_buffer, int scratch_buffer_size) override {
+        count_ = 0;
+        return planner_->Init(scratch_buffer, scratch_buffer_size);
+    }
+
+    TfLiteStatus AddBuffer(int size, int first_time_used, int last_time_used) override {
+        record(size, first_time_used, last_time_used);
+        return planner_->AddBuffer(size, first_time_used, last_time_used);
+    }
+
+    TfLiteStatus AddBuffer(int size, int first_time_used, int last_time_used, int offline_offset) override {
+        record(size, first_time_used, last_time_used);
+        return planner_->AddBuffer(size, first_time_used, last_time_used, offline_offset);
+    }
+
+    size_t GetMaximumMemorySize() override { return planner_->GetMaximumMemorySize(); }
+
+    int GetBufferCount() override { return planner_->GetBufferCount(); }
+
+    TfLiteStatus GetOffsetForBuffer(int buffer_index, int *offset) override {
+        TfLiteStatus status = planner_->GetOffsetForBuffer(buffer_index, offset);
+        if (status == kTfLiteOk && (size_t)buffer_index < capacity_) {
+            buffers_[buffer_index].offset = (uint32_t)*offset;
+        }
+        return status;
+    }
+
+    void PrintMemoryPlan() override { planner_->PrintMemoryPlan(); }
+
+    size_t count() const { return count_; }
+
+private:
+    // The allocator counts lifetimes in allocation scopes: 0 for the subgraph
+    // inputs, then one per operator (control flow subgraphs are numbered in line)
+    void record(int size, int first_time_used, int last_time_used) {
+        if (count_ < capacity_) {
+            ei_arena_buffer_t *buffer = &buffers_[count_];
+            buffer->subgraph = 0;
+            buffer->tensor = -1;
+            buffer->bytes = (uint32_t)size;
+            buffer->offset = 0;
+            buffer->first_used = first_time_used - 1;
+            buffer->last_used = last_time_used - 1;
+        }
+        count_++;
+    }
+
+    tflite::MicroMemoryPlanner *planner_;
+    ei_arena_buffer_t *buffers_;
+    size_t capacity_;
+    size_t count_;
+};
+
+static tflite::MicroMemoryPlanner *create_planner(ei_arena_planner_t planner)
+{
+    switch (planner) {
+        case EI_ARENA_PLANNER_GREEDY: return new (std::nothrow) tflite::GreedyMemoryPlanner();
+        case EI_ARENA_PLANNER_LINEAR: return new (std::nothrow) tflite::LinearMemoryPlanner();
+    }
+    return nullptr;
+}
+
+/**
+ * The allocator plans every subgraph's tensors first, in order, then the
+ * scratch buffers. A tensor is planned when it has no data in the flatbuffer,
+ * isn't a variable and isn't empty (AllocationInfoBuilder), so walk the
+ * tensors with the same rules to name the recorded buffers.
+ */
+static void label_buffers(const tflite::Model *model, ei_arena_buffer_t *buffers, size_t count)
+{
+    size_t ix = 0;
+    for (size_t sg = 0; sg < model->subgraphs()->size(); sg++) {
+        const tflite::SubGraph *subgraph = model->subgraphs()->Get(sg);
+        for (size_t t = 0; t < subgraph->tensors()->size(); t++) {
+            const tflite::Tensor *tensor = subgraph->tensors()->Get(t);
+            const tflite::Buffer *buffer = model->buffers()->Get(tensor->buffer());
+            size_t bytes = 0, type_size = 0;
+            if (buffer && buffer->data() && buffer->data()->size() > 0) continue;
+            if (tensor->is_variable()) continue;
+            if (tflite::BytesRequiredForTensor(*tensor, &bytes, &type_size) != kTfLiteOk || bytes == 0) continue;
+            if (ix == count) return;
+            buffers[ix].subgraph = (int32_t)sg;
+            buffers[ix].tensor = (int32_t)t;
+            ix++;
+        }
+    }
+}
+
+static size_t live_peak(const ei_arena_buffer_t *buffers, size_t count, int32_t *peak_operator)
+{
+    int32_t last_operator = -1;
+    for (size_t ix = 0; ix < count; ix++) {
+        if (buffers[ix].last_used > last_operator) last_operator = buffers[ix].last_used;
+    }
+    size_t peak = 0;
+    *peak_operator = -1;
+    for (int32_t op = -1; op <= last_operator; op++) {
+        size_t live = 0;
+        for (size_t ix = 0; ix < count; ix++) {
+            if (buffers[ix].first_used <= op && op <= buffers[ix].last_used) live += buffers[ix].bytes;
+        }
+        if (live > peak) {
+            peak = live;
+            *peak_operator = op;
+        }
+    }
+    return peak;
+}
+
+// Would a plain interpreter with this planner fit the model in `arena_size`?
+static bool fits(const tflite::Model *model, const tflite::MicroOpResolver &resolver,
+                 ei_arena_planner_t planner, uint8_t *arena, size_t arena_size)
+{
+    if (planner == EI_ARENA_PLANNER_GREEDY) {
+        // As inference_tflite_setup(): the greedy planner lives in the arena too
+        tflite::MicroInterpreter interpreter(model, resolver, arena, arena_size);
+        return interpreter.initialization_status() == kTfLiteOk &&
+               interpreter.AllocateTensors(true) == kTfLiteOk;
+    }
+
+    tflite::MicroMemoryPlanner *memory_planner = create_planner(planner);
+    if (!memory_planner) {
+        return false;
+    }
+    bool ok = false;
+    tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(arena, arena_size, memory_planner);
+    if (allocator) {
+        tflite::MicroInterpreter interpreter(model, resolver, allocator);
+        ok = interpreter.initialization_status() == kTfLiteOk &&
+             interpreter.AllocateTensors(true) == kTfLiteOk;
+    }
+    delete memory_planner;
+    return ok;
+}
+
+} // namespace arena_report
+} // namespace ei
+
+/**
+ * Run `model_data` once (AllocateTensors() and one Invoke() on a zeroed input)
+ * in a `max_arena_size` work arena and fill in `report`. Planned buffers go to
+ * `buffers` (up to `buffer_capacity`, report->buffer_count has the total);
+ * live_peak_bytes only covers the buffers that fit. With `find_minimal` the
+ * model is prepared again for every bisection step, expect the interpreter's
+ * allocation errors in the log for the sizes that don't fit.
+ */
+static EI_IMPULSE_ERROR ei_arena_report(const uint8_t *model_data,
+                                        const tflite::MicroOpResolver &resolver,
+                                        ei_arena_planner_t planner,
+                                        size_t max_arena_size,
+                                        ei_arena_report_t *report,
+                                        ei_arena_buffer_t *buffers = nullptr,
+                                        size_t buffer_capacity = 0,
+                                        bool find_minimal = true)
+{
+    using namespace ei::arena_report;
+
+    memset(report, 0, sizeof(ei_arena_report_t));
+    report->planner = planner;
+
+    const tflite::Model *model = tflite::GetModel(model_data);
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        ei_printf("Model provided is schema version %d not equal to supported version %d.\n",
+            (int)model->version(), TFLITE_SCHEMA_VERSION);
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    uint8_t *arena = (uint8_t*)ei_aligned_calloc(16, max_arena_size);
+    tflite::MicroMemoryPlanner *memory_planner = create_planner(planner);
+    if (!arena || !memory_planner) {
+        ei_aligned_free(arena);
+        delete memory_planner;
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    EI_IMPULSE_ERROR res = EI_IMPULSE_OK;
+    {
+        RecordingPlanner recording_planner(memory_planner, buffers, buffers ? buffer_capacity : 0);
+        tflite::RecordingMicroInterpreter interpreter(model, resolver,
+            tflite::RecordingMicroAllocator::Create(arena, max_arena_size, &recording_planner));
+
+        if (interpreter.AllocateTensors(true) != kTfLiteOk) {
+            ei_printf("AllocateTensors() failed, increase the work arena (%zu bytes)\n", max_arena_size);
+            res = EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+        }
+        else if (interpreter.Invoke() != kTfLiteOk) {
+            ei_printf("Invoke failed\n");
+            res = EI_IMPULSE_TFLITE_ERROR;
+        }
+        else {
+            const tflite::RecordingMicroAllocator &allocator = interpreter.GetMicroAllocator();
+            const tflite::RecordingSingleArenaBufferAllocator *arena_allocator = allocator.GetSimpleMemoryAllocator();
+
+            report->persistent_bytes = arena_allocator->GetPersistentUsedBytes();
+            report->non_persistent_bytes = arena_allocator->GetNonPersistentUsedBytes();
+            report->used_bytes = interpreter.arena_used_bytes();
+
+            report->eval_tensors = allocator.GetRecordedAllocation(tflite::RecordedAllocationType::kTfLiteEvalTensorData);
+            report->tflite_tensors = allocator.GetRecordedAllocation(tflite::RecordedAllocationType::kPersistentTfLiteTensorData);
+            report->quantization = allocator.GetRecordedAllocation(tflite::RecordedAllocationType::kPersistentTfLiteTensorQuantizationData);
+            report->op_data = allocator.GetRecordedAllocation(tflite::RecordedAllocationType::kPersistentBufferData);
+            report->variables = allocator.GetRecordedAllocation(tflite::RecordedAllocationType::kTfLiteTensorVariableBufferData);
+            report->node_registrations = allocator.GetRecordedAllocation(tflite::RecordedAllocationType::kNodeAndRegistrationArray);
+
+            report->buffer_count = recording_planner.count();
+            const size_t recorded = report->buffer_count < buffer_capacity ? report->buffer_count : buffer_capacity;
+            if (buffers) {
+                label_buffers(model, buffers, recorded);
+                for (size_t ix = 0; ix < recorded; ix++) {
+                    if (buffers[ix].tensor < 0) report->scratch_bytes += buffers[ix].bytes;
+                    else report->activation_bytes += buffers[ix].bytes;
+                }
+                report->live_peak_bytes = live_peak(buffers, recorded, &report->live_peak_operator);
+            }
+        }
+    }
+
+    if (res == EI_IMPULSE_OK && find_minimal) {
+        // The recording allocator's bookkeeping is larger than the plain one's,
+        // so what it used normally fits; planning needs temporary head room
+        // though, so check before bisecting below it
+        size_t hi = (report->used_bytes + 15) & ~(size_t)15;
+        size_t lo = 0;
+        if (hi > max_arena_size || !fits(model, resolver, planner, arena, hi)) {
+            hi = max_arena_size;
+        }
+        while (hi - lo > 16) {
+            size_t mid = ((lo + hi) / 2) & ~(size_t)15;
+            if (fits(model, resolver, planner, arena, mid)) hi = mid;
+            else lo = mid;
+        }
+        report->minimal_arena_size = hi;
+    }
+
+    delete memory_planner;
+    ei_aligned_free(arena);
+    return res;
+}
+
+#endif // _EI_ARENA_REPORT_H_
@@ -95,6 +95,18 @@
     #define ESP_NN                                  1
 #endif
 
+// Set to 1 when run_classifier_continuous() is called for several handles
+// from different threads (e.g. offline evaluation on a server)
+#ifndef EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
+#define EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE        0
+#endif // EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
+
+// Without vendor kernels, run int8 CONV_2D and FULLY_CONNECTED through im2col
+// and a packed int8 GEMM instead of the reference loops
+#ifndef EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+#define EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM       1
+#endif // EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+
 // no include checks in the compiler? then just include metadata and then ops_define (optional if on EON model)
 #ifndef __has_include
     #include "model-parameters/model_metadata.h"
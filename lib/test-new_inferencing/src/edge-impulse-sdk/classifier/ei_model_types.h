@@ -428,6 +428,20 @@ public:
         }
     }
 
+    // Owns the DSP handles: move-only, so two copies never free them twice
+    ei_impulse_state_t(const ei_impulse_state_t&) = delete;
+    ei_impulse_state_t& operator=(const ei_impulse_state_t&) = delete;
+
+    ei_impulse_state_t(ei_impulse_state_t&& other)
+        : impulse(other.impulse)
+        , dsp_handles(other.dsp_handles)
+        , is_temp_handle(other.is_temp_handle)
+    {
+        other.dsp_handles = nullptr;
+    }
+
+    ei_impulse_state_t& operator=(ei_impulse_state_t&&) = delete;
+
     DspHandle* get_dsp_handle(size_t ix) {
         if (dsp_handles[ix] == nullptr) {
             dsp_handles[ix] = impulse->dsp_blocks[ix].factory(impulse->dsp_blocks[ix].config, impulse->frequency);
@@ -437,6 +451,9 @@ public:
 
     void reset()
     {
+        if (dsp_handles == nullptr) {
+            return;
+        }
         for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
             if (dsp_handles[ix] != nullptr) {
                 delete dsp_handles[ix];
@@ -468,6 +485,88 @@ public:
     }
 };
 
+/**
+ * State carried between run_classifier_continuous() calls. Kept per handle so
+ * several independent streams (e.g. two microphones, or many files on a server
+ * evaluated in parallel threads) can be classified side by side.
+ */
+class ei_continuous_state_t {
+public:
+    float *dsp_frame = nullptr;         // partial DSP frame left over from the previous slice
+    size_t dsp_frame_size = 0;
+    int dsp_frame_ix = 0;
+    bool dsp_first_run = false;         // spectrogram / MFE v1 stack frame workaround
+    ei::matrix_t *features = nullptr;   // sliding window of features, allocated on first slice
+    uint64_t features_written = 0;
+    int8_t *input_capture = nullptr;    // if set, receives each window's quantized model input (see ei_score_cache.h)
+    bool input_captured = false;        // input_capture holds the last slice's input
+    float input_capture_scale = 1.0f;
+    int32_t input_capture_zero_point = 0;
+
+    ei_continuous_state_t() = default;
+
+    // Owns dsp_frame and features: move-only, so two copies never free them twice
+    ei_continuous_state_t(const ei_continuous_state_t&) = delete;
+    ei_continuous_state_t& operator=(const ei_continuous_state_t&) = delete;
+
+    ei_continuous_state_t(ei_continuous_state_t&& other)
+    {
+        *this = static_cast<ei_continuous_state_t&&>(other);
+    }
+
+    ei_continuous_state_t& operator=(ei_continuous_state_t&& other)
+    {
+        if (this != &other) {
+            release();
+            dsp_frame = other.dsp_frame;
+            dsp_frame_size = other.dsp_frame_size;
+            dsp_frame_ix = other.dsp_frame_ix;
+            dsp_first_run = other.dsp_first_run;
+            features = other.features;
+            features_written = other.features_written;
+            input_capture = other.input_capture;
+            input_captured = other.input_captured;
+            input_capture_scale = other.input_capture_scale;
+            input_capture_zero_point = other.input_capture_zero_point;
+            other.dsp_frame = nullptr;
+            other.features = nullptr;
+            other.release();
+        }
+        return *this;
+    }
+
+    /**
+     * Start a new stream. The feature window is kept allocated (it is fully
+     * rewritten before the next inference).
+     */
+    void reset()
+    {
+        if (dsp_frame) {
+            ei_free(dsp_frame);
+        }
+        dsp_frame = nullptr;
+        dsp_frame_size = 0;
+        dsp_frame_ix = 0;
+        dsp_first_run = false;
+        features_written = 0;
+        input_captured = false;
+    }
+
+    void release()
+    {
+        reset();
+        if (features) {
+            delete features;
+            features = nullptr;
+        }
+    }
+
+    ~ei_continuous_state_t()
+    {
+        release();
+    }
+};
+
 class ei_impulse_handle_t {
 public:
     ei_impulse_handle_t(const ei_impulse_t *impulse)
@@ -482,6 +581,7 @@ public:
     ei_impulse_state_t state;
     const ei_impulse_t *impulse;
     void** post_processing_state;
+    ei_continuous_state_t continuous_state;
 #if EI_CLASSIFIER_FREEFORM_OUTPUT == 1
     ei::matrix_t *freeform_outputs;
 #endif // EI_CLASSIFIER_FREEFORM_OUTPUT
@@ -43,11 +43,16 @@
 #include "ei_signal_with_axes.h"
 #include "postprocessing/ei_postprocessing.h"
 #include "edge-impulse-sdk/classifier/ei_data_normalization.h"
+#include "edge-impulse-sdk/classifier/ei_quantize.h"
 #include "edge-impulse-sdk/classifier/ei_print_results.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
 #include <memory>
+#if EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
+#include <mutex>
+#endif // EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
 
 #if EI_CLASSIFIER_LOAD_ANOMALY_H
 #include "inferencing_engines/anomaly.h"
@@ -110,7 +115,11 @@ EI_IMPULSE_ERROR ei_unscale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fm
 
 /* Private variables ------------------------------------------------------- */
 
-static uint64_t classifier_continuous_features_written = 0;
+#if EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
+// Compiled models share one tensor arena, so streams running on separate
+// threads take turns for inference (DSP still runs concurrently)
+static std::mutex classifier_inference_mutex;
+#endif // EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
 
 /* Private functions ------------------------------------------------------- */
 
@@ -470,10 +479,15 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
 
     auto impulse = handle->impulse;
-    static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
-    if (!static_features_matrix.buffer) {
+    ei_continuous_state_t *cont_state = &handle->continuous_state;
+    if (!cont_state->features) {
+        cont_state->features = new ei::matrix_t(1, impulse->nn_input_frame_size);
+    }
+    if (!cont_state->features->buffer) {
         return EI_IMPULSE_ALLOC_FAILED;
     }
+    ei::matrix_t &features_matrix = *cont_state->features;
+    cont_state->input_captured = false;
 
     EI_IMPULSE_ERROR ei_impulse_error = EI_IMPULSE_OK;
 
@@ -490,9 +504,9 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         }
 
         ei::matrix_t fm(1, block.n_output_features,
-                        static_features_matrix.buffer + out_features_index);
+                        features_matrix.buffer + out_features_index);
 
-        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size);
+        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size, ei_continuous_state_t *state);
 
         /* Switch to the slice version of the mfcc feature extract function */
         if (block.extract_fn == extract_mfcc_features) {
@@ -516,10 +530,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             ei_printf("ERR: EIDSP_SIGNAL_C_FN_POINTER can only be used when all axes are selected for DSP blocks\n");
             return EI_IMPULSE_DSP_ERROR;
         }
-        int ret = extract_fn_slice(signal, &fm, block.config, impulse->frequency, &features_written);
+        int ret = extract_fn_slice(signal, &fm, block.config, impulse->frequency, &features_written, cont_state);
 #else
         SignalWithAxes swa(signal, block.axes, block.axes_size, impulse);
-        int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written);
+        int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written, cont_state);
 #endif
 
         if (ret != EIDSP_OK) {
@@ -531,7 +545,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             return EI_IMPULSE_CANCELED;
         }
 
-        classifier_continuous_features_written += (features_written.rows * features_written.cols);
+        cont_state->features_written += (features_written.rows * features_written.cols);
 
         out_features_index += block.n_output_features;
     }
@@ -539,7 +553,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
     result->timing.dsp = (int)(result->timing.dsp_us / 1000);
 
-    if (classifier_continuous_features_written >= impulse->nn_input_frame_size) {
+    if (cont_state->features_written >= impulse->nn_input_frame_size) {
         dsp_start_us = ei_read_timer_us();
 
         uint32_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
@@ -582,7 +596,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
             /* Create a copy of the matrix for normalization */
             for (size_t m_ix = 0; m_ix < block.n_output_features; m_ix++) {
-                features[ix].matrix->buffer[m_ix] = static_features_matrix.buffer[out_features_index + m_ix];
+                features[ix].matrix->buffer[m_ix] = features_matrix.buffer[out_features_index + m_ix];
             }
 
             if (block.extract_fn == extract_mfcc_features) {
@@ -597,6 +611,19 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             out_features_index += block.n_output_features;
         }
 
+        // Keep a copy of the exact int8 model input, e.g. for a score cache
+        if (cont_state->input_capture) {
+            size_t capture_ix = 0;
+            for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+                for (size_t m_ix = 0; m_ix < features[ix].matrix->cols; m_ix++) {
+                    cont_state->input_capture[capture_ix++] = (int8_t)pre_cast_quantize(
+                        features[ix].matrix->buffer[m_ix], cont_state->input_capture_scale,
+                        cont_state->input_capture_zero_point, true);
+                }
+            }
+            cont_state->input_captured = true;
+        }
+
         result->timing.dsp_us += ei_read_timer_us() - dsp_start_us;
         result->timing.dsp = (int)(result->timing.dsp_us / 1000);
 
@@ -610,7 +637,14 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             ei_printf("Running impulse...\n");
         }
 
+#if EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
+        {
+            std::lock_guard<std::mutex> lock(classifier_inference_mutex);
+            ei_impulse_error = run_inference(handle, features, result, debug);
+        }
+#else
         ei_impulse_error = run_inference(handle, features, result, debug);
+#endif // EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
         }
@@ -799,6 +833,14 @@ will be documented by Doxygen. */
  * @{
  */
 
+/**
+ * Clear the continuous audio state of the default impulse. The signature from
+ * before the state moved onto the impulse handle, kept for existing callers.
+ */
+__attribute__((unused)) int ei_dsp_clear_continuous_audio_state() {
+    return ei_dsp_clear_continuous_audio_state(&ei_default_impulse.continuous_state);
+}
+
 /**
  * @brief Initialize static variables for running preprocessing and inference
  *  continuously.
@@ -813,9 +855,7 @@ will be documented by Doxygen. */
  */
 extern "C" void run_classifier_init(void)
 {
-
-    classifier_continuous_features_written = 0;
-    ei_dsp_clear_continuous_audio_state();
+    ei_dsp_clear_continuous_audio_state(&ei_default_impulse.continuous_state);
     init_impulse(&ei_default_impulse);
     init_postprocessing(&ei_default_impulse);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
@@ -839,8 +879,7 @@ extern "C" void run_classifier_init(void)
  */
 __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 {
-    classifier_continuous_features_written = 0;
-    ei_dsp_clear_continuous_audio_state();
+    ei_dsp_clear_continuous_audio_state(&handle->continuous_state);
     init_impulse(handle);
     init_postprocessing(handle);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
@@ -862,11 +901,13 @@ __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 extern "C" void run_classifier_deinit(void)
 {
     deinit_postprocessing(&ei_default_impulse);
+    ei_default_impulse.continuous_state.release();
 }
 
 __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
 {
     deinit_postprocessing(handle);
+    handle->continuous_state.release();
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
     deinit_data_normalization(handle);
 #endif
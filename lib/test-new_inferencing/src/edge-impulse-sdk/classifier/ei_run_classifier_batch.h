@@ -0,0 +1,643 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EDGE_IMPULSE_RUN_CLASSIFIER_BATCH_H_
+#define _EDGE_IMPULSE_RUN_CLASSIFIER_BATCH_H_
+
+/**
+ * Batch classification: many windows per call, for offline evaluation and
+ * server-side checks on a host. The firmware keeps streaming through
+ * run_classifier_continuous().
+ *
+ *   run_classifier_batch()          one signal per window
+ *   run_classifier_batch_signal()   every window of one long signal, `hop`
+ *                                   values apart
+ *
+ * Every result is what run_classifier() gives for that window, bit for bit.
+ * The work shared between windows:
+ *   - EON models are initialized once per group of EI_CLASSIFIER_BATCH_WINDOWS
+ *     windows instead of once per window (run_nn_inference_batch()). The
+ *     compiled graph is planned for a batch of one, so the windows are still
+ *     invoked one after the other, on the same arena.
+ *   - For an MFCC impulse over a long signal, with a hop that is a multiple of
+ *     the frame stride and shorter than a window, each frame of the signal is
+ *     computed once. A window copies its frames from there and only redoes its
+ *     first one, as pre-emphasis wraps around at the start of a window. CMVN
+ *     stays per window.
+ *   - Feature and raw output buffers are allocated once per call.
+ * The timing of each result is its share of the group it ran in.
+ */
+
+#include "ei_run_classifier.h"
+#include <algorithm>
+
+#ifndef EI_CLASSIFIER_BATCH_WINDOWS
+#define EI_CLASSIFIER_BATCH_WINDOWS         64  // windows per DSP / inference round, bounds the feature buffers
+#endif // EI_CLASSIFIER_BATCH_WINDOWS
+
+#ifndef EI_CLASSIFIER_BATCH_MFCC_CHUNK
+#define EI_CLASSIFIER_BATCH_MFCC_CHUNK      256 // frames of the long signal per MFCC call, bounds the DSP scratch
+#endif // EI_CLASSIFIER_BATCH_MFCC_CHUNK
+
+namespace ei {
+namespace batch {
+
+// thread_local: like preemphasized_audio_signal_get_data(), these get_data
+// callbacks have no context pointer
+static thread_local signal_t *window_source;
+static thread_local size_t window_start;
+static thread_local size_t frames_start;
+
+// One window of the long signal
+static int window_get_data(size_t offset, size_t length, float *out_ptr) {
+    return window_source->get_data(window_start + offset, length, out_ptr);
+}
+
+// A run of frames of the pre-emphasized long signal
+static int frames_get_data(size_t offset, size_t length, float *out_ptr) {
+    return preemphasis->get_data(frames_start + offset, length, out_ptr);
+}
+
+/**
+ * MFCC frames of a long signal, computed once and shared by all windows
+ */
+class mfcc_frames {
+public:
+    /**
+     * Whether the windows of `signal`, `hop` values apart, can share frames:
+     * a single stateless MFCC block over the only axis, and windows that
+     * overlap by whole frame strides
+     */
+    bool init(const ei_impulse_t *impulse, signal_t *signal, size_t hop)
+    {
+        if (impulse->dsp_blocks_size != 1 || impulse->raw_samples_per_frame != 1) {
+            return false;
+        }
+        const ei_model_dsp_t &block = impulse->dsp_blocks[0];
+        if (block.extract_fn != &extract_mfcc_features || block.factory || block.axes_size != 1) {
+            return false;
+        }
+
+        _config = *((ei_dsp_config_mfcc_t*)block.config);
+        // frame i starts at i * stride from version 2 on
+        if (_config.axes != 1 || _config.implementation_version < 2 || _config.implementation_version > 4) {
+            return false;
+        }
+
+        _signal = signal;
+        _frequency = static_cast<uint32_t>(impulse->frequency);
+        _window_length = impulse->dsp_input_frame_size;
+        _frame_length = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+            static_cast<float>(_frequency) * _config.frame_length));
+        _frame_stride = static_cast<size_t>(speechpy::processing::ceil_unless_very_close_to_floor(
+            static_cast<float>(_frequency) * _config.frame_stride));
+        if (_frame_stride == 0 || hop % _frame_stride != 0 || hop >= _window_length ||
+                _config.pre_shift < 1 || (size_t)_config.pre_shift > _frame_length) {
+            return false;
+        }
+
+        matrix_size_t window_size = speechpy::feature::calculate_mfcc_buffer_size(
+            _window_length, _frequency, _config.frame_length, _config.frame_stride, _config.num_cepstral,
+            _config.implementation_version);
+        _window_frames = window_size.rows;
+        if (_window_frames < 1 || window_size.rows * window_size.cols != block.n_output_features) {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Run every frame of the signal through the MFCC
+     */
+    int compute()
+    {
+        const int32_t frame_count = speechpy::processing::calculate_no_of_stack_frames(
+            _signal->total_length, _frequency, _config.frame_length, _config.frame_stride, false,
+            _config.implementation_version);
+        if (frame_count < (int32_t)_window_frames) {
+            EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
+        }
+
+        // outside a scratch scope, so it comes from the heap rather than
+        // growing the thread's DSP scratch to the length of the signal
+        _frames.reset(new matrix_t(frame_count, _config.num_cepstral));
+        if (!_frames->buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        class speechpy::processing::preemphasis pre(_signal, _config.pre_shift, _config.pre_cof, false);
+
+        for (int32_t first = 0; first < frame_count; first += EI_CLASSIFIER_BATCH_MFCC_CHUNK) {
+            dsp_scratch_scope scratch;
+            const size_t count = std::min<size_t>(EI_CLASSIFIER_BATCH_MFCC_CHUNK, frame_count - first);
+
+            preemphasis = &pre;
+            frames_start = first * _frame_stride;
+
+            signal_t chunk;
+            chunk.total_length = (count - 1) * _frame_stride + _frame_length;
+            chunk.get_data = &frames_get_data;
+
+            matrix_t chunk_frames(count, _config.num_cepstral, _frames->buffer + first * _config.num_cepstral);
+            int ret = run_mfcc(&chunk_frames, &chunk, &_config, _frequency, _config.implementation_version);
+            if (ret != EIDSP_OK) {
+                ei_printf("ERR: MFCC failed (%d)\n", ret);
+                EIDSP_ERR(ret);
+            }
+        }
+        return EIDSP_OK;
+    }
+
+    /**
+     * Features of the window that starts at `start`, as extract_mfcc_features()
+     * computes them on that window alone
+     *
+     * @param output_matrix 1 x n_output_features
+     */
+    int extract(size_t start, matrix_t *output_matrix)
+    {
+        dsp_scratch_scope scratch;
+        const size_t cols = _config.num_cepstral;
+        matrix_t window(_window_frames, cols, output_matrix->buffer);
+
+        // frames 1.. read the same samples as in the long signal
+        memcpy(window.buffer + cols, _frames->buffer + (start / _frame_stride + 1) * cols,
+            (_window_frames - 1) * cols * sizeof(float));
+
+        // frame 0 is pre-emphasized against the end of the window
+        window_source = _signal;
+        window_start = start;
+        signal_t window_signal;
+        window_signal.total_length = _window_length;
+        window_signal.get_data = &window_get_data;
+
+        class speechpy::processing::preemphasis pre(&window_signal, _config.pre_shift, _config.pre_cof, false);
+        preemphasis = &pre;
+
+        signal_t frame_signal;
+        frame_signal.total_length = _frame_length;
+        frame_signal.get_data = &preemphasized_audio_signal_get_data;
+
+        matrix_t first_frame(1, cols, window.buffer);
+        int ret = run_mfcc(&first_frame, &frame_signal, &_config, _frequency, _config.implementation_version);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: MFCC failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+
+        ret = speechpy::processing::cmvnw(&window, _config.win_size, true, false);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: cmvnw failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+        return EIDSP_OK;
+    }
+
+private:
+    signal_t *_signal;
+    ei_dsp_config_mfcc_t _config;
+    uint32_t _frequency;
+    size_t _window_length;
+    size_t _window_frames;
+    size_t _frame_length;
+    size_t _frame_stride;
+    std::unique_ptr<matrix_t> _frames;
+};
+
+/**
+ * Run the DSP blocks over one window, as process_impulse() does
+ */
+static EI_IMPULSE_ERROR extract_window(
+    ei_impulse_handle_t *handle,
+    signal_t *signal,
+    ei_feature_t *features,
+    ei_impulse_result_t *result)
+{
+    auto impulse = handle->impulse;
+
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        ei_model_dsp_t block = impulse->dsp_blocks[ix];
+
+#if EIDSP_SIGNAL_C_FN_POINTER
+        if (block.axes_size != impulse->raw_samples_per_frame) {
+            ei_printf("ERR: EIDSP_SIGNAL_C_FN_POINTER can only be used when all axes are selected for DSP blocks\n");
+            return EI_IMPULSE_DSP_ERROR;
+        }
+        auto internal_signal = signal;
+#else
+        SignalWithAxes swa(signal, block.axes, block.axes_size, impulse);
+        auto internal_signal = swa.get_signal();
+#endif
+
+        int ret;
+        if (block.factory) { // ie, if we're using state
+            auto dsp_handle = handle->state.get_dsp_handle(ix);
+            if (!dsp_handle) {
+                return EI_IMPULSE_OUT_OF_MEMORY;
+            }
+            ret = dsp_handle->extract(internal_signal, features[ix].matrix, block.config, impulse->frequency, result);
+        } else {
+            ret = block.extract_fn(internal_signal, features[ix].matrix, block.config, impulse->frequency);
+        }
+
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
+            return EI_IMPULSE_DSP_ERROR;
+        }
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Run the learning blocks over the features of `window_count` windows
+ * (dsp_blocks_size matrices per window)
+ */
+static EI_IMPULSE_ERROR run_inference_batch(
+    ei_impulse_handle_t *handle,
+    ei_feature_t *features,
+    size_t window_count,
+    ei_impulse_result_t *results,
+    bool debug)
+{
+    auto impulse = handle->impulse;
+
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_LOAD_IMAGE_SCALING
+    bool batched = true;
+    for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
+        batched = batched && impulse->learning_blocks[ix].infer_fn == &run_nn_inference;
+    }
+
+    if (batched) {
+        for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
+            ei_learning_block_t block = impulse->learning_blocks[ix];
+            EI_IMPULSE_ERROR res = run_nn_inference_batch(impulse, features, window_count, ix,
+                (uint32_t*)block.input_block_ids, block.input_block_ids_size, results, block.config, debug);
+            if (res != EI_IMPULSE_OK) {
+                return res;
+            }
+        }
+        return EI_IMPULSE_OK;
+    }
+#endif
+
+    // other engines set up per window anyway
+    for (size_t w = 0; w < window_count; w++) {
+        EI_IMPULSE_ERROR res = run_inference(handle, features + w * impulse->dsp_blocks_size, &results[w], debug);
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+    }
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Classify `window_count` windows: windows[w] if `windows` is set, else the
+ * windows of `signal` that start `hop` values apart
+ */
+static EI_IMPULSE_ERROR process_impulse_batch(
+    ei_impulse_handle_t *handle,
+    signal_t *windows,
+    signal_t *signal,
+    size_t hop,
+    size_t window_count,
+    ei_impulse_result_t *results,
+    bool debug)
+{
+    if ((handle == nullptr) || (handle->impulse == nullptr) || (results == nullptr) ||
+            (windows == nullptr && signal == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    // the results would all point at the same classification array
+    ei_printf("ERR: Batch classification needs statically allocated classification results\n");
+    return EI_IMPULSE_INFERENCE_ERROR;
+#else
+
+    auto impulse = handle->impulse;
+    if (window_count == 0) {
+        return EI_IMPULSE_OK;
+    }
+
+    // a window of the long signal
+    signal_t window_view;
+    window_view.total_length = impulse->dsp_input_frame_size;
+    window_view.get_data = &window_get_data;
+
+#if (EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ONNX_TIDL) || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ATON)
+    // quantized image models run DSP and inference in one go, so window by window
+    if (can_run_classifier_image_quantized(impulse, impulse->learning_blocks[0]) == EI_IMPULSE_OK) {
+        for (size_t w = 0; w < window_count; w++) {
+            window_source = signal;
+            window_start = w * hop;
+            EI_IMPULSE_ERROR res = process_impulse(handle, windows ? &windows[w] : &window_view, &results[w], debug);
+            if (res != EI_IMPULSE_OK) {
+                return res;
+            }
+        }
+        return EI_IMPULSE_OK;
+    }
+#endif
+
+    mfcc_frames shared_frames;
+    const bool share_frames = !windows && shared_frames.init(impulse, signal, hop);
+    uint64_t frames_us = 0;
+    if (share_frames) {
+        uint64_t frames_start_us = ei_read_timer_us();
+        int ret = shared_frames.compute();
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
+            return EI_IMPULSE_DSP_ERROR;
+        }
+        frames_us = ei_read_timer_us() - frames_start_us;
+    }
+
+    const size_t group_size = std::min<size_t>(window_count, EI_CLASSIFIER_BATCH_WINDOWS);
+    const size_t block_num = impulse->dsp_blocks_size;
+    const size_t output_num = impulse->output_tensors_size;
+
+    // the feature matrices of a group, reused by every group
+    std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[group_size * block_num]);
+    std::unique_ptr<std::unique_ptr<ei::matrix_t>[]> matrix_ptrs(new std::unique_ptr<ei::matrix_t>[group_size * block_num]);
+    std::unique_ptr<ei_feature_t[]> raw_outputs_ptr(new ei_feature_t[group_size * output_num]);
+    ei_feature_t *features = features_ptr.get();
+    ei_feature_t *raw_outputs = raw_outputs_ptr.get();
+    if (!features || !matrix_ptrs || !raw_outputs) {
+        ei_printf("ERR: Out of memory, can't allocate features\n");
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+    memset(features, 0, sizeof(ei_feature_t) * group_size * block_num);
+
+    for (size_t ix = 0; ix < group_size * block_num; ix++) {
+        ei_model_dsp_t block = impulse->dsp_blocks[ix % block_num];
+        matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
+        if (matrix_ptrs[ix] == nullptr || matrix_ptrs[ix]->buffer == nullptr) {
+            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+        features[ix].matrix = matrix_ptrs[ix].get();
+        features[ix].blockId = block.blockId;
+    }
+
+    for (size_t first = 0; first < window_count; first += group_size) {
+        const size_t count = std::min(group_size, window_count - first);
+        ei_impulse_result_t *group = &results[first];
+
+        uint64_t dsp_start_us = ei_read_timer_us();
+
+        for (size_t w = 0; w < count; w++) {
+            ei_impulse_result_t *result = &group[w];
+            ei_feature_t *window_features = features + w * block_num;
+
+            memset(result, 0, sizeof(ei_impulse_result_t));
+            result->_raw_outputs = raw_outputs + w * output_num;
+            memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * output_num);
+
+            // extract functions may reshape their output matrix
+            for (size_t ix = 0; ix < block_num; ix++) {
+                window_features[ix].matrix->rows = 1;
+                window_features[ix].matrix->cols = impulse->dsp_blocks[ix].n_output_features;
+            }
+
+            const size_t start = (first + w) * hop;
+            if (share_frames) {
+                int ret = shared_frames.extract(start, window_features[0].matrix);
+                if (ret != EIDSP_OK) {
+                    ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
+                    return EI_IMPULSE_DSP_ERROR;
+                }
+            }
+            else {
+                window_source = signal;
+                window_start = start;
+                EI_IMPULSE_ERROR res = extract_window(handle, windows ? &windows[first + w] : &window_view,
+                    window_features, result);
+                if (res != EI_IMPULSE_OK) {
+                    return res;
+                }
+            }
+
+#if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
+            EI_IMPULSE_ERROR dn_error = run_data_normalization(handle, window_features);
+            if (dn_error != EI_IMPULSE_OK) {
+                ei_printf("ERR: Failed to run Data Normalization process (%d)\n", dn_error);
+                return dn_error;
+            }
+#endif
+        }
+
+        if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
+            return EI_IMPULSE_CANCELED;
+        }
+
+        // the shared frames are spread over all windows
+        uint64_t dsp_us = (ei_read_timer_us() - dsp_start_us) / count + frames_us / window_count;
+        for (size_t w = 0; w < count; w++) {
+            group[w].timing.dsp_us = dsp_us;
+            group[w].timing.dsp = (int)(dsp_us / 1000);
+        }
+
+        if (debug) {
+            ei_printf("Running impulse on windows %d..%d (%d us. DSP per window)...\n",
+                (int)first, (int)(first + count - 1), (int)dsp_us);
+        }
+
+#if !EI_CLASSIFIER_DSP_ONLY
+        EI_IMPULSE_ERROR res;
+#if EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
+        {
+            std::lock_guard<std::mutex> lock(classifier_inference_mutex);
+            res = run_inference_batch(handle, features, count, group, debug);
+        }
+#else
+        res = run_inference_batch(handle, features, count, group, debug);
+#endif // EI_CLASSIFIER_CONTINUOUS_THREAD_SAFE
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+
+        for (size_t w = 0; w < count; w++) {
+            res = run_postprocessing(handle, &group[w]);
+            if (res != EI_IMPULSE_OK) {
+                return res;
+            }
+        }
+#endif // !EI_CLASSIFIER_DSP_ONLY
+
+        // the raw outputs are reused by the next group
+        for (size_t w = 0; w < count; w++) {
+            group[w]._raw_outputs = nullptr;
+        }
+    }
+
+    return EI_IMPULSE_OK;
+#endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+}
+
+} // namespace batch
+} // namespace ei
+
+/**
+ * Number of windows run_classifier_batch_signal() classifies in a signal
+ *
+ * @param[in] handle Impulse handle
+ * @param[in] total_length Length of the signal, in values
+ * @param[in] hop Values between the starts of two windows
+ */
+__attribute__((unused)) static size_t run_classifier_batch_window_count(
+    ei_impulse_handle_t *handle,
+    size_t total_length,
+    size_t hop)
+{
+    const size_t window_length = handle->impulse->dsp_input_frame_size;
+    if (hop == 0 || total_length < window_length) {
+        return 0;
+    }
+    return (total_length - window_length) / hop + 1;
+}
+
+/**
+ * @brief Run the classifier over a batch of windows, one signal per window.
+ *
+ * Same results as calling `run_classifier()` on every window, with the
+ * model set up once per group of windows (see ei_run_classifier_batch.h).
+ *
+ * **Blocking**: yes
+ *
+ * @param[in] handle Pointer to an `ei_impulse_handle_t` struct that contains the model and
+ *  preprocessing information.
+ * @param[in] signals Array of `window_count` signals, each of EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE
+ *  values.
+ * @param[in] window_count Number of windows.
+ * @param[out] results Array of `window_count` results, in the order of `signals`.
+ * @param[in] debug Print internal preprocessing and inference debugging information via `ei_printf()`.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum. Will be `EI_IMPULSE_OK` if inference
+ *  completed successfully.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_batch(
+    ei_impulse_handle_t *handle,
+    signal_t *signals,
+    size_t window_count,
+    ei_impulse_result_t *results,
+    bool debug = false)
+{
+    if (signals == nullptr) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    return ei::batch::process_impulse_batch(handle, signals, nullptr, 0, window_count, results, debug);
+}
+
+/**
+ * @brief Run the classifier over a batch of windows, one signal per window.
+ *
+ * See `run_classifier_batch(handle, ...)`, for the default impulse.
+ */
+extern "C" EI_IMPULSE_ERROR run_classifier_batch(
+    signal_t *signals,
+    size_t window_count,
+    ei_impulse_result_t *results,
+    bool debug = false)
+{
+    return run_classifier_batch(&ei_default_impulse, signals, window_count, results, debug);
+}
+
+/**
+ * @brief Run the classifier over every window of a long signal.
+ *
+ * Windows of EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE values start at 0, `hop`,
+ * 2 * `hop`, ... as long as they fit in the signal. Same results as calling
+ * `run_classifier()` on each of them; for MFCC impulses with a hop that is a
+ * multiple of the frame stride the frames are computed only once (see
+ * ei_run_classifier_batch.h).
+ *
+ * **Blocking**: yes
+ *
+ * @param[in] handle Pointer to an `ei_impulse_handle_t` struct that contains the model and
+ *  preprocessing information.
+ * @param[in] signal The long signal.
+ * @param[in] hop Values between the starts of two windows.
+ * @param[out] results Array of `max_results` results, one per window in signal order.
+ * @param[in] max_results Size of `results`, see `run_classifier_batch_window_count()`.
+ * @param[out] window_count Number of windows classified (at most `max_results`).
+ * @param[in] debug Print internal preprocessing and inference debugging information via `ei_printf()`.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum. Will be `EI_IMPULSE_OK` if inference
+ *  completed successfully.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_batch_signal(
+    ei_impulse_handle_t *handle,
+    signal_t *signal,
+    size_t hop,
+    ei_impulse_result_t *results,
+    size_t max_results,
+    size_t *window_count,
+    bool debug = false)
+{
+    if (handle == nullptr || handle->impulse == nullptr || signal == nullptr || window_count == nullptr) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    *window_count = 0;
+    if (hop == 0 || hop % handle->impulse->raw_samples_per_frame != 0) {
+        ei_printf("ERR: hop (%d) must be a non-zero multiple of the values per frame (%d)\n",
+            (int)hop, (int)handle->impulse->raw_samples_per_frame);
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+
+    const size_t count = std::min(max_results, run_classifier_batch_window_count(handle, signal->total_length, hop));
+    EI_IMPULSE_ERROR res = ei::batch::process_impulse_batch(handle, nullptr, signal, hop, count, results, debug);
+    if (res == EI_IMPULSE_OK) {
+        *window_count = count;
+    }
+    return res;
+}
+
+/**
+ * @brief Run the classifier over every window of a long signal.
+ *
+ * See `run_classifier_batch_signal(handle, ...)`, for the default impulse.
+ */
+extern "C" EI_IMPULSE_ERROR run_classifier_batch_signal(
+    signal_t *signal,
+    size_t hop,
+    ei_impulse_result_t *results,
+    size_t max_results,
+    size_t *window_count,
+    bool debug = false)
+{
+    return run_classifier_batch_signal(&ei_default_impulse, signal, hop, results, max_results, window_count, debug);
+}
+
+#endif // _EDGE_IMPULSE_RUN_CLASSIFIER_BATCH_H_
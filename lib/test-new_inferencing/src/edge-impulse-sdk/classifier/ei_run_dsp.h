@@ -84,11 +84,6 @@ using namespace ei;
 float ei_dsp_image_buffer[EI_DSP_IMAGE_BUFFER_STATIC_SIZE];
 #endif
 
-// this is the frame we work on... allocate it statically so we share between invocations
-static float *ei_dsp_cont_current_frame = nullptr;
-static size_t ei_dsp_cont_current_frame_size = 0;
-static int ei_dsp_cont_current_frame_ix = 0;
-
 __attribute__((unused)) int extract_hr_features(
     signal_t *signal,
     matrix_t *output_matrix,
@@ -218,12 +213,46 @@ __attribute__((unused)) int extract_flatten_features(signal_t *signal, matrix_t
     return ret;
 }
 
-static class speechpy::processing::preemphasis *preemphasis;
+#ifndef EI_CLASSIFIER_MFCC_FIXED
+#define EI_CLASSIFIER_MFCC_FIXED 0
+#endif
+
+#if EI_CLASSIFIER_MFCC_FIXED
+typedef speechpy::mfcc_fixed<EI_CLASSIFIER_FREQUENCY,
+    EI_CLASSIFIER_MFCC_FIXED_FRAME_LENGTH, EI_CLASSIFIER_MFCC_FIXED_FRAME_STRIDE,
+    EI_CLASSIFIER_MFCC_FIXED_NUM_CEPSTRAL, EI_CLASSIFIER_MFCC_FIXED_NUM_FILTERS, EI_CLASSIFIER_MFCC_FIXED_FFT_LENGTH,
+    EI_CLASSIFIER_MFCC_FIXED_LOW_FREQUENCY, EI_CLASSIFIER_MFCC_FIXED_HIGH_FREQUENCY,
+    EI_CLASSIFIER_MFCC_FIXED_VERSION> mfcc_fixed_t;
+#endif
+
+/**
+ * speechpy::feature::mfcc() with DC elimination, through the compile-time
+ * engine if the config is the one the model was generated with
+ */
+static int run_mfcc(matrix_t *output_matrix, signal_t *signal, const ei_dsp_config_mfcc_t *config,
+    uint32_t frequency, uint16_t implementation_version)
+{
+#if EI_CLASSIFIER_MFCC_FIXED
+    if (mfcc_fixed_t::matches(frequency, config->frame_length, config->frame_stride, config->num_cepstral,
+            config->num_filters, config->fft_length, config->low_frequency, config->high_frequency,
+            implementation_version)) {
+        return mfcc_fixed_t::mfcc(output_matrix, signal, implementation_version);
+    }
+#endif
+    return speechpy::feature::mfcc(output_matrix, signal,
+        frequency, config->frame_length, config->frame_stride, config->num_cepstral, config->num_filters, config->fft_length,
+        config->low_frequency, config->high_frequency, true, implementation_version);
+}
+
+// thread_local: the get_data callback below has no context pointer, and
+// continuous streams may run on several threads at once
+static thread_local class speechpy::processing::preemphasis *preemphasis;
 static int preemphasized_audio_signal_get_data(size_t offset, size_t length, float *out_ptr) {
     return preemphasis->get_data(offset, length, out_ptr);
 }
 
 __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
+    dsp_scratch_scope scratch; // DSP temporaries come from the thread's scratch arena
     ei_dsp_config_mfcc_t config = *((ei_dsp_config_mfcc_t*)config_ptr);
 
     if (config.axes != 1) {
@@ -263,9 +292,7 @@ __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *ou
     output_matrix->cols = out_matrix_size.cols;
 
     // and run the MFCC extraction
-    int ret = speechpy::feature::mfcc(output_matrix, &preemphasized_audio_signal,
-        frequency, config.frame_length, config.frame_stride, config.num_cepstral, config.num_filters, config.fft_length,
-        config.low_frequency, config.high_frequency, true, config.implementation_version);
+    int ret = run_mfcc(output_matrix, &preemphasized_audio_signal, &config, frequency, config.implementation_version);
     if (ret != EIDSP_OK) {
         ei_printf("ERR: MFCC failed (%d)\n", ret);
         EIDSP_ERR(ret);
@@ -311,9 +338,7 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
     matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols, output_matrix->buffer + output_matrix_offset);
 
     // and run the MFCC extraction
-    x = speechpy::feature::mfcc(&output_matrix_slice, signal,
-        frequency, config->frame_length, config->frame_stride, config->num_cepstral, config->num_filters, config->fft_length,
-        config->low_frequency, config->high_frequency, true, implementation_version);
+    x = run_mfcc(&output_matrix_slice, signal, config, frequency, implementation_version);
     if (x != EIDSP_OK) {
         ei_printf("ERR: MFCC failed (%d)\n", x);
         EIDSP_ERR(x);
@@ -327,11 +352,12 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_continuous_state_t *state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
 #else
+    dsp_scratch_scope scratch; // DSP temporaries come from the thread's scratch arena
 
     ei_dsp_config_mfcc_t config = *((ei_dsp_config_mfcc_t*)config_ptr);
 
@@ -374,9 +400,9 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     int x;
 
     // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    if (state->dsp_frame && state->dsp_frame_size != frame_length_values) {
+        ei_free(state->dsp_frame);
+        state->dsp_frame = nullptr;
     }
 
     int implementation_version = config.implementation_version;
@@ -384,19 +410,19 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
+    if (!state->dsp_frame) {
+        state->dsp_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
+        if (!state->dsp_frame) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        state->dsp_frame_size = frame_length_values;
+        state->dsp_frame_ix = 0;
     }
 
 
-    if ((frame_length_values) > preemphasized_audio_signal.total_length  + ei_dsp_cont_current_frame_ix) {
+    if ((frame_length_values) > preemphasized_audio_signal.total_length  + state->dsp_frame_ix) {
         ei_printf("ERR: frame_length (%d) cannot be larger than signal's total length (%d) for continuous classification\n",
-            (int)frame_length_values, (int)preemphasized_audio_signal.total_length  + ei_dsp_cont_current_frame_ix);
+            (int)frame_length_values, (int)preemphasized_audio_signal.total_length  + state->dsp_frame_ix);
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
@@ -408,24 +434,24 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
         implementation_version = 2;
     }
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
-        ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size (ix=%d size=%d)\n",
-            ei_dsp_cont_current_frame_ix, (int)ei_dsp_cont_current_frame_size);
+    if (state->dsp_frame_ix > (int)state->dsp_frame_size) {
+        ei_printf("ERR: dsp_frame_ix is larger than frame size (ix=%d size=%d)\n",
+            state->dsp_frame_ix, (int)state->dsp_frame_size);
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->dsp_frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->dsp_frame_ix`
         // starting at offset 0
-        x = preemphasized_audio_signal.get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = preemphasized_audio_signal.get_data(0, frame_length_values - state->dsp_frame_ix, state->dsp_frame + state->dsp_frame_ix);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now state->dsp_frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
+        x = numpy::signal_from_buffer(state->dsp_frame, frame_length_values, &frame_signal);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
@@ -437,15 +463,15 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
 
         // if there's overlap between frames we roll through
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::roll(state->dsp_frame, frame_length_values, -frame_stride_values);
         }
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->dsp_frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->dsp_frame_ix < 0) {
+        offset_in_signal = -state->dsp_frame_ix;
+        state->dsp_frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
@@ -478,17 +504,17 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the state->dsp_frame buffer
         x = preemphasized_audio_signal.get_data(
             (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->dsp_frame);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->dsp_frame_ix = bytes_left_end_of_frame;
 
     preemphasis = nullptr;
 
@@ -497,6 +523,7 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
 }
 
 __attribute__((unused)) int extract_spectrogram_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
+    dsp_scratch_scope scratch; // DSP temporaries come from the thread's scratch arena
     ei_dsp_config_spectrogram_t config = *((ei_dsp_config_spectrogram_t*)config_ptr);
 
     if (config.axes != 1) {
@@ -598,16 +625,15 @@ __attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signa
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_continuous_state_t *state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
 #else
+    dsp_scratch_scope scratch; // DSP temporaries come from the thread's scratch arena
 
     ei_dsp_config_spectrogram_t config = *((ei_dsp_config_spectrogram_t*)config_ptr);
 
-    static bool first_run = false;
-
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
@@ -623,11 +649,11 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     buffer */
     if(config.implementation_version < 2) {
 
-        if (first_run == true) {
+        if (state->dsp_first_run == true) {
             signal->total_length += (size_t)(config.frame_length * (float)frequency);
         }
 
-        first_run = true;
+        state->dsp_first_run = true;
     }
 
     // Go from the time (e.g. 0.25 seconds to number of frames based on freq)
@@ -653,18 +679,18 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     int x;
 
     // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    if (state->dsp_frame && state->dsp_frame_size != frame_length_values) {
+        ei_free(state->dsp_frame);
+        state->dsp_frame = nullptr;
     }
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
+    if (!state->dsp_frame) {
+        state->dsp_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
+        if (!state->dsp_frame) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        state->dsp_frame_size = frame_length_values;
+        state->dsp_frame_ix = 0;
     }
 
     matrix_size_out->rows = 0;
@@ -673,23 +699,23 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
-        ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size\n");
+    if (state->dsp_frame_ix > (int)state->dsp_frame_size) {
+        ei_printf("ERR: dsp_frame_ix is larger than frame size\n");
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->dsp_frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->dsp_frame_ix`
         // starting at offset 0
-        x = signal->get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = signal->get_data(0, frame_length_values - state->dsp_frame_ix, state->dsp_frame + state->dsp_frame_ix);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now state->dsp_frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
+        x = numpy::signal_from_buffer(state->dsp_frame, frame_length_values, &frame_signal);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
@@ -701,15 +727,15 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
 
         // if there's overlap between frames we roll through
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::roll(state->dsp_frame, frame_length_values, -frame_stride_values);
         }
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->dsp_frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->dsp_frame_ix < 0) {
+        offset_in_signal = -state->dsp_frame_ix;
+        state->dsp_frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
@@ -742,20 +768,20 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the state->dsp_frame buffer
         x = signal->get_data(
             (signal->total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->dsp_frame);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->dsp_frame_ix = bytes_left_end_of_frame;
 
     if (config.implementation_version < 2) {
-        if (first_run == true) {
+        if (state->dsp_first_run == true) {
             signal->total_length -= (size_t)(config.frame_length * (float)frequency);
         }
     }
@@ -766,6 +792,7 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
 
 
 __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
+    dsp_scratch_scope scratch; // DSP temporaries come from the thread's scratch arena
     ei_dsp_config_mfe_t config = *((ei_dsp_config_mfe_t*)config_ptr);
 
     if (config.axes != 1) {
@@ -916,19 +943,18 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, ei_continuous_state_t *state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
 #else
+    dsp_scratch_scope scratch; // DSP temporaries come from the thread's scratch arena
 
     ei_dsp_config_mfe_t config = *((ei_dsp_config_mfe_t*)config_ptr);
 
     // signal is already the right size,
     // output matrix is not the right size, but we can start writing at offset 0 and then it's OK too
 
-    static bool first_run = false;
-
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
@@ -947,11 +973,11 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // subtracted and there for never used. But skip the first slice to fit the feature_matrix
     // buffer
     if (config.implementation_version == 1) {
-        if (first_run == true) {
+        if (state->dsp_first_run == true) {
             signal->total_length += (size_t)(config.frame_length * (float)frequency);
         }
 
-        first_run = true;
+        state->dsp_first_run = true;
     }
 
     // ok all setup, let's construct the signal (with preemphasis for impl version >3)
@@ -1001,21 +1027,21 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     int x;
 
     // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    if (state->dsp_frame && state->dsp_frame_size != frame_length_values) {
+        ei_free(state->dsp_frame);
+        state->dsp_frame = nullptr;
     }
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
+    if (!state->dsp_frame) {
+        state->dsp_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
+        if (!state->dsp_frame) {
             if (preemphasis) {
                 delete preemphasis;
             }
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        state->dsp_frame_size = frame_length_values;
+        state->dsp_frame_ix = 0;
     }
 
     matrix_size_out->rows = 0;
@@ -1024,8 +1050,8 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
-        ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size\n");
+    if (state->dsp_frame_ix > (int)state->dsp_frame_size) {
+        ei_printf("ERR: dsp_frame_ix is larger than frame size\n");
         if (preemphasis) {
             delete preemphasis;
         }
@@ -1033,10 +1059,10 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->dsp_frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->dsp_frame_ix`
         // starting at offset 0
-        x = preemphasized_audio_signal.get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = preemphasized_audio_signal.get_data(0, frame_length_values - state->dsp_frame_ix, state->dsp_frame + state->dsp_frame_ix);
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1044,9 +1070,9 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now state->dsp_frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
+        x = numpy::signal_from_buffer(state->dsp_frame, frame_length_values, &frame_signal);
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1064,15 +1090,15 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
 
         // if there's overlap between frames we roll through
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::roll(state->dsp_frame, frame_length_values, -frame_stride_values);
         }
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->dsp_frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->dsp_frame_ix < 0) {
+        offset_in_signal = -state->dsp_frame_ix;
+        state->dsp_frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
@@ -1111,11 +1137,11 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the state->dsp_frame buffer
         x = preemphasized_audio_signal.get_data(
             (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->dsp_frame);
         if (x != EIDSP_OK) {
             if (preemphasis) {
                 delete preemphasis;
@@ -1124,11 +1150,11 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->dsp_frame_ix = bytes_left_end_of_frame;
 
 
     if (config.implementation_version == 1) {
-        if (first_run == true) {
+        if (state->dsp_first_run == true) {
             signal->total_length -= (size_t)(config.frame_length * (float)frequency);
         }
     }
@@ -1401,16 +1427,10 @@ __attribute__((unused)) int extract_image_features_quantized(signal_t *signal, m
 #endif // (EI_CLASSIFIER_QUANTIZATION_ENABLED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE != EI_CLASSIFIER_DRPAI)
 
 /**
- * Clear all state regarding continuous audio. Invoke this function after continuous audio loop ends.
+ * Clear all state regarding continuous audio for one stream. Invoke this function after continuous audio loop ends.
  */
-__attribute__((unused)) int ei_dsp_clear_continuous_audio_state() {
-    if (ei_dsp_cont_current_frame) {
-        ei_free(ei_dsp_cont_current_frame);
-    }
-
-    ei_dsp_cont_current_frame = nullptr;
-    ei_dsp_cont_current_frame_size = 0;
-    ei_dsp_cont_current_frame_ix = 0;
+__attribute__((unused)) int ei_dsp_clear_continuous_audio_state(ei_continuous_state_t *state) {
+    state->reset();
 
     return EIDSP_OK;
 }
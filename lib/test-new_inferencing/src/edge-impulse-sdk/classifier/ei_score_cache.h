@@ -0,0 +1,427 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_SCORE_CACHE_H_
+#define _EI_SCORE_CACHE_H_
+
+/**
+ * Score cache: per-slice classifier output of a recording in a flat binary
+ * file that can be memory-mapped and replayed without running DSP or the NN
+ * again (threshold sweeps, ei_classifier_smooth, calibration, ...).
+ *
+ * Layout (little-endian, every part 4-byte aligned):
+ *
+ *   ei_score_cache_header_t
+ *   record_count x {
+ *       ei_score_cache_record_t
+ *       float  scores[label_count]       result.classification[ix].value
+ *       int8_t features[feature_count]   quantized model input (optional)
+ *       padding to record_size
+ *   }
+ *
+ * Writers: ei_score_cache_writer_t appends to a FILE, ei_score_cache_ring_t
+ * keeps the most recent records in a caller-provided buffer (e.g. PSRAM on
+ * a device) and dumps them in the same format.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "ei_classifier_types.h"
+#include "ei_model_types.h"
+#include "model-parameters/model_metadata.h"
+
+#define EI_SCORE_CACHE_MAGIC        0x43534945  // "EISC"
+#define EI_SCORE_CACHE_VERSION      1
+#define EI_SCORE_CACHE_STREAMING    0xFFFFFFFF  // record_count of a file still being appended to
+#define EI_SCORE_CACHE_NO_AUDIO     0xFFFFFFFF  // audio_offset when no raw audio is kept
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;           // offset of the first record
+    uint16_t label_count;
+    uint16_t feature_count;         // 0 if the model input was not captured
+    uint32_t record_size;
+    uint32_t record_count;          // EI_SCORE_CACHE_STREAMING: derive from the file size
+    uint32_t slice_size;            // samples per record
+    uint32_t frequency;
+    float input_scale;              // feature value = (q - input_zero_point) * input_scale
+    int32_t input_zero_point;
+    uint32_t reserved;              // 0, keeps the 64-bit fields aligned
+    uint64_t source_size;           // identifies the source recording, 0 if unused
+    int64_t source_mtime;
+} ei_score_cache_header_t;
+
+typedef struct {
+    uint32_t slice_index;
+    uint32_t audio_offset;          // sample offset into the source audio, or EI_SCORE_CACHE_NO_AUDIO
+    uint32_t dsp_us;
+    uint32_t classification_us;
+} ei_score_cache_record_t;
+
+static_assert(sizeof(ei_score_cache_header_t) == 56, "ei_score_cache_header_t is part of the file format");
+static_assert(sizeof(ei_score_cache_record_t) == 16, "ei_score_cache_record_t is part of the file format");
+
+constexpr uint32_t ei_score_cache_record_size(uint16_t label_count, uint16_t feature_count)
+{
+    return (uint32_t)((sizeof(ei_score_cache_record_t) + label_count * sizeof(float) + feature_count + 3) & ~3u);
+}
+
+/**
+ * Fill in a header for the given shape. Call ei_score_cache_capture_input()
+ * afterwards to also store the model input.
+ */
+inline void ei_score_cache_header_init(ei_score_cache_header_t *header,
+                                       uint16_t label_count = EI_CLASSIFIER_LABEL_COUNT,
+                                       uint16_t feature_count = 0,
+                                       uint32_t slice_size = EI_CLASSIFIER_SLICE_SIZE,
+                                       uint32_t frequency = EI_CLASSIFIER_FREQUENCY)
+{
+    memset(header, 0, sizeof(ei_score_cache_header_t));
+    header->magic = EI_SCORE_CACHE_MAGIC;
+    header->version = EI_SCORE_CACHE_VERSION;
+    header->header_size = sizeof(ei_score_cache_header_t);
+    header->label_count = label_count;
+    header->feature_count = feature_count;
+    header->record_size = ei_score_cache_record_size(label_count, feature_count);
+    header->record_count = EI_SCORE_CACHE_STREAMING;
+    header->slice_size = slice_size;
+    header->frequency = frequency;
+    header->input_scale = 1.0f;
+}
+
+/**
+ * Have run_classifier_continuous() copy each window's quantized model input
+ * into `buffer` (impulse->nn_input_frame_size bytes), and record the shape
+ * and quantization in `header`. Pass a nullptr buffer to stop capturing.
+ * Only int8 EON models expose their input quantization without an interpreter.
+ * Append what ei_score_cache_captured_input() returns, not `buffer` itself.
+ */
+inline EI_IMPULSE_ERROR ei_score_cache_capture_input(ei_impulse_handle_t *handle, int8_t *buffer,
+                                                     ei_score_cache_header_t *header)
+{
+    ei_continuous_state_t *state = &handle->continuous_state;
+    if (!buffer) {
+        state->input_capture = nullptr;
+        if (header) {
+            header->feature_count = 0;
+            header->record_size = ei_score_cache_record_size(header->label_count, 0);
+        }
+        return EI_IMPULSE_OK;
+    }
+
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+    const ei_impulse_t *impulse = handle->impulse;
+    if (impulse->learning_blocks_size != 1 || impulse->nn_input_frame_size > UINT16_MAX) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+    ei_learning_block_config_tflite_graph_t *config =
+        (ei_learning_block_config_tflite_graph_t *)impulse->learning_blocks[0].config;
+    if (!config->quantized) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+
+    // Tensor metadata is static in EON models, no need to init the graph
+    ei_config_tflite_eon_graph_t *graph = (ei_config_tflite_eon_graph_t *)config->graph_config;
+    TfLiteTensor input;
+    if (graph->model_input(0, &input) != kTfLiteOk || input.type != kTfLiteInt8) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+
+    state->input_capture_scale = input.params.scale;
+    state->input_capture_zero_point = input.params.zero_point;
+    state->input_capture = buffer;
+    header->feature_count = (uint16_t)impulse->nn_input_frame_size;
+    header->record_size = ei_score_cache_record_size(header->label_count, header->feature_count);
+    header->input_scale = input.params.scale;
+    header->input_zero_point = input.params.zero_point;
+    return EI_IMPULSE_OK;
+#else
+    (void)state;
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+#endif
+}
+
+/**
+ * The model input of the last run_classifier_continuous() call, or nullptr if
+ * that slice didn't run the model (the feature window was still filling) or
+ * nothing is captured. Records appended with nullptr features store zeros.
+ */
+inline const int8_t *ei_score_cache_captured_input(const ei_impulse_handle_t *handle)
+{
+    const ei_continuous_state_t *state = &handle->continuous_state;
+    return state->input_captured ? state->input_capture : nullptr;
+}
+
+/**
+ * Encode one classified slice into `out` (header->record_size bytes)
+ * @param features Captured model input, ignored if header->feature_count is 0
+ */
+inline void ei_score_cache_encode(const ei_score_cache_header_t *header, uint8_t *out,
+                                  const ei_impulse_result_t *result, uint32_t slice_index,
+                                  uint32_t audio_offset = EI_SCORE_CACHE_NO_AUDIO,
+                                  const int8_t *features = nullptr)
+{
+    ei_score_cache_record_t *record = (ei_score_cache_record_t *)out;
+    record->slice_index = slice_index;
+    record->audio_offset = audio_offset;
+    record->dsp_us = (uint32_t)result->timing.dsp_us;
+    record->classification_us = (uint32_t)result->timing.classification_us;
+
+    float *scores = (float *)(out + sizeof(ei_score_cache_record_t));
+    for (size_t ix = 0; ix < header->label_count; ix++) {
+        scores[ix] = result->classification[ix].value;
+    }
+
+    uint8_t *tail = (uint8_t *)(scores + header->label_count);
+    size_t tail_size = header->record_size - (tail - out);
+    if (header->feature_count > 0 && features) {
+        memcpy(tail, features, header->feature_count);
+        tail += header->feature_count;
+        tail_size -= header->feature_count;
+    }
+    memset(tail, 0, tail_size);
+}
+
+/**
+ * Read-only view over a score cache in memory (typically mmap'ed).
+ * The buffer must be 4-byte aligned and outlive the reader.
+ */
+class ei_score_cache_reader_t {
+public:
+    /**
+     * @return false if the buffer is not a score cache this version can read
+     */
+    bool open(const void *data, size_t size)
+    {
+        _data = (const uint8_t *)data;
+        _header = (const ei_score_cache_header_t *)data;
+        _count = 0;
+
+        if (!data || size < sizeof(ei_score_cache_header_t) ||
+            _header->magic != EI_SCORE_CACHE_MAGIC || _header->version != EI_SCORE_CACHE_VERSION ||
+            _header->header_size < sizeof(ei_score_cache_header_t) || _header->header_size > size ||
+            _header->record_size < ei_score_cache_record_size(_header->label_count, _header->feature_count) ||
+            (_header->record_size & 3) != 0) {
+            _header = nullptr;
+            return false;
+        }
+
+        // A truncated tail (e.g. a crashed writer) is dropped
+        uint32_t available = (uint32_t)((size - _header->header_size) / _header->record_size);
+        _count = _header->record_count < available ? _header->record_count : available;
+        return true;
+    }
+
+    const ei_score_cache_header_t *header() const { return _header; }
+
+    uint32_t count() const { return _count; }
+
+    const ei_score_cache_record_t *record(uint32_t ix) const
+    {
+        return (const ei_score_cache_record_t *)(_data + _header->header_size + (size_t)ix * _header->record_size);
+    }
+
+    const float *scores(uint32_t ix) const
+    {
+        return (const float *)((const uint8_t *)record(ix) + sizeof(ei_score_cache_record_t));
+    }
+
+    /**
+     * @return nullptr if the cache holds no model input
+     */
+    const int8_t *features(uint32_t ix) const
+    {
+        if (_header->feature_count == 0) {
+            return nullptr;
+        }
+        return (const int8_t *)(scores(ix) + _header->label_count);
+    }
+
+    /**
+     * Rebuild a result struct for post-processing that expects one
+     * (e.g. ei_classifier_smooth_update). Labels come from the impulse.
+     */
+    void fill_result(uint32_t ix, ei_impulse_result_t *result, const ei_impulse_t *impulse) const
+    {
+        const ei_score_cache_record_t *rec = record(ix);
+        const float *values = scores(ix);
+        size_t label_count = _header->label_count < impulse->label_count ? _header->label_count : impulse->label_count;
+        for (size_t l = 0; l < label_count; l++) {
+            result->classification[l].label = impulse->categories[l];
+            result->classification[l].value = values[l];
+        }
+        result->timing.dsp_us = rec->dsp_us;
+        result->timing.classification_us = rec->classification_us;
+        result->timing.dsp = (int)(rec->dsp_us / 1000);
+        result->timing.classification = (int)(rec->classification_us / 1000);
+    }
+
+private:
+    const uint8_t *_data = nullptr;
+    const ei_score_cache_header_t *_header = nullptr;
+    uint32_t _count = 0;
+};
+
+/**
+ * Streams records to a FILE. The header is written with
+ * EI_SCORE_CACHE_STREAMING and patched with the real count by end(), so an
+ * interrupted file is still readable.
+ */
+class ei_score_cache_writer_t {
+public:
+    bool begin(FILE *file, const ei_score_cache_header_t *header)
+    {
+        _file = file;
+        _header = *header;
+        _header.record_count = EI_SCORE_CACHE_STREAMING;
+        _count = 0;
+        _start = ftell(file);
+        return fwrite(&_header, sizeof(_header), 1, file) == 1;
+    }
+
+    bool append(const ei_impulse_result_t *result, uint32_t slice_index,
+                uint32_t audio_offset = EI_SCORE_CACHE_NO_AUDIO, const int8_t *features = nullptr)
+    {
+        uint8_t record[ei_score_cache_record_size(EI_CLASSIFIER_LABEL_COUNT, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE)];
+        if (!_file || _header.record_size > sizeof(record)) {
+            return false;
+        }
+        ei_score_cache_encode(&_header, record, result, slice_index, audio_offset, features);
+        if (fwrite(record, _header.record_size, 1, _file) != 1) {
+            return false;
+        }
+        _count++;
+        return true;
+    }
+
+    /**
+     * Patch the record count. Leaves the file positioned at its end.
+     */
+    bool end()
+    {
+        if (!_file) {
+            return false;
+        }
+        long end_pos = ftell(_file);
+        _header.record_count = _count;
+        bool ok = fseek(_file, _start, SEEK_SET) == 0 &&
+                  fwrite(&_header, sizeof(_header), 1, _file) == 1 &&
+                  fseek(_file, end_pos, SEEK_SET) == 0;
+        _file = nullptr;
+        return ok;
+    }
+
+    uint32_t count() const { return _count; }
+
+private:
+    FILE *_file = nullptr;
+    ei_score_cache_header_t _header;
+    uint32_t _count = 0;
+    long _start = 0;
+};
+
+/**
+ * Fixed-size ring of the most recent records in a caller-provided buffer
+ * (e.g. PSRAM), for always-on capture on a device. Appending never
+ * allocates; dump() emits a regular score cache, oldest record first.
+ */
+class ei_score_cache_ring_t {
+public:
+    /**
+     * @return false if the buffer can't hold a single record
+     */
+    bool begin(uint8_t *buffer, size_t size, const ei_score_cache_header_t *header)
+    {
+        _buffer = buffer;
+        _header = *header;
+        _capacity = (uint32_t)(size / _header.record_size);
+        _head = 0;
+        return buffer && _capacity > 0;
+    }
+
+    void append(const ei_impulse_result_t *result, uint32_t slice_index,
+                uint32_t audio_offset = EI_SCORE_CACHE_NO_AUDIO, const int8_t *features = nullptr)
+    {
+        if (_capacity == 0) {
+            return;
+        }
+        uint8_t *slot = _buffer + (size_t)(_head % _capacity) * _header.record_size;
+        ei_score_cache_encode(&_header, slot, result, slice_index, audio_offset, features);
+        _head++;
+    }
+
+    void clear() { _head = 0; }
+
+    uint32_t capacity() const { return _capacity; }
+
+    uint32_t count() const { return _head < _capacity ? _head : _capacity; }
+
+    /**
+     * Bytes dump() will produce
+     */
+    size_t dump_size() const
+    {
+        return sizeof(ei_score_cache_header_t) + (size_t)count() * _header.record_size;
+    }
+
+    /**
+     * Write the ring out as a score cache through `write` (e.g. a socket).
+     * Records are emitted in at most two contiguous runs.
+     * @return Bytes accepted by `write`
+     */
+    size_t dump(size_t (*write)(const uint8_t *data, size_t size, void *ctx), void *ctx) const
+    {
+        ei_score_cache_header_t header = _header;
+        header.record_count = count();
+        size_t written = write((const uint8_t *)&header, sizeof(header), ctx);
+
+        uint32_t first = _head < _capacity ? 0 : _head % _capacity;
+        uint32_t run = header.record_count - (_head < _capacity ? 0 : first);
+        written += write(_buffer + (size_t)first * _header.record_size, (size_t)run * _header.record_size, ctx);
+        if (run < header.record_count) {
+            written += write(_buffer, (size_t)(header.record_count - run) * _header.record_size, ctx);
+        }
+        return written;
+    }
+
+private:
+    uint8_t *_buffer = nullptr;
+    ei_score_cache_header_t _header;
+    uint32_t _capacity = 0;
+    uint32_t _head = 0;             // Records ever appended
+};
+
+#endif // _EI_SCORE_CACHE_H_
@@ -130,6 +130,70 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     return EI_IMPULSE_OK;
 }
 
+/**
+ * Copy the output tensors of a learning block into the raw outputs of a result
+ * (postprocessing frees them)
+ *
+ * @param   block_config        Learning block
+ * @param   outputs             Output tensors, output_tensors_size of them
+ * @param   learn_block_index   Index of the first output in raw_outputs
+ * @param   raw_outputs         result->_raw_outputs
+ *
+ * @return  EI_IMPULSE_OK if successful
+ */
+static EI_IMPULSE_ERROR copy_output_tensors(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    TfLiteTensor *outputs,
+    uint32_t learn_block_index,
+    ei_feature_t *raw_outputs) {
+
+    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
+        TfLiteTensor* output = &outputs[output_ix];
+        // calculate the size of the output by iterating through dims
+        size_t output_size = 1;
+        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
+            output_size *= output->dims->data[dim_num];
+        }
+        switch (output->type) {
+            case kTfLiteFloat32: {
+                raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                memcpy(raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
+                break;
+            }
+            case kTfLiteInt8: {
+                if (block_config->dequantize_output) {
+                    raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                    fill_output_matrix_from_tensor(output, raw_outputs[learn_block_index + output_ix].matrix);
+                }
+                else {
+                    raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
+                    memcpy(raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
+                }
+                break;
+            }
+            case kTfLiteUInt8: {
+                if (block_config->dequantize_output) {
+                    raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                    fill_output_matrix_from_tensor(output, raw_outputs[learn_block_index + output_ix].matrix);
+                }
+                else {
+                    raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
+                    memcpy(raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
+                }
+                break;
+            }
+            default: {
+                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
+                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
+            }
+        }
+
+        raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
 /**
  * @brief      Do neural network inferencing over a signal (from the DSP)
  *
@@ -251,55 +315,113 @@ EI_IMPULSE_ERROR run_nn_inference(
         &outputs,
         tensor_arena, result, debug);
 
-    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
-        TfLiteTensor* output = &outputs[output_ix];
-        // calculate the size of the output by iterating through dims
-        size_t output_size = 1;
-        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
-            output_size *= output->dims->data[dim_num];
+    EI_IMPULSE_ERROR output_res = copy_output_tensors(block_config, outputs, learn_block_index, result->_raw_outputs);
+    if (output_res != EI_IMPULSE_OK) {
+        return output_res;
+    }
+
+    graph_config->model_reset(ei_aligned_free);
+    ei_free(outputs);
+
+    if (run_res != EI_IMPULSE_OK) {
+        return run_res;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      Do neural network inferencing over the feature matrices of several
+ *             windows, with one model init / reset for all of them
+ *
+ * The compiled graph is planned for a batch of one, so the windows are
+ * invoked back to back on the same arena rather than in one invoke.
+ *
+ * @param      fmatrix        Processed matrices, dsp_blocks_size per window
+ * @param      window_count   Number of windows
+ * @param      results        Output classifier results, one per window
+ * @param[in]  debug          Debug output enable
+ *
+ * @return     The ei impulse error.
+ */
+EI_IMPULSE_ERROR run_nn_inference_batch(
+    const ei_impulse_t *impulse,
+    ei_feature_t *fmatrix,
+    size_t window_count,
+    uint32_t learn_block_index,
+    uint32_t* input_block_ids,
+    uint32_t input_block_ids_size,
+    ei_impulse_result_t *results,
+    void *config_ptr,
+    bool debug = false)
+{
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+
+    TfLiteTensor input;
+    TfLiteTensor *outputs;
+
+    // allocate outputs
+    outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    if (!outputs) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    uint64_t ctx_start_us = ei_read_timer_us();
+    ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
+
+    EI_IMPULSE_ERROR res = inference_tflite_setup(
+        block_config,
+        &ctx_start_us,
+        &input,
+        &outputs,
+        p_tensor_arena);
+
+    if (res != EI_IMPULSE_OK) {
+        ei_free(outputs);
+        return res;
+    }
+
+    for (size_t w = 0; w < window_count && res == EI_IMPULSE_OK; w++) {
+        ei_impulse_result_t *result = &results[w];
+
+        res = fill_input_tensor_from_matrix(fmatrix + w * impulse->dsp_blocks_size,
+                                            result->_raw_outputs,
+                                            &input,
+                                            input_block_ids,
+                                            input_block_ids_size,
+                                            impulse->dsp_blocks_size,
+                                            impulse->learning_blocks_size);
+        if (res != EI_IMPULSE_OK) {
+            break;
         }
-        switch (output->type) {
-            case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
-                break;
-            }
-            case kTfLiteInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
-                }
-                break;
-            }
-            case kTfLiteUInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
-                }
-                break;
-            }
-            default: {
-                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
-                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
-            }
+
+        if (graph_config->model_invoke() != kTfLiteOk) {
+            res = EI_IMPULSE_TFLITE_ERROR;
+            break;
         }
 
-        result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
+        res = copy_output_tensors(block_config, outputs, learn_block_index, result->_raw_outputs);
     }
 
     graph_config->model_reset(ei_aligned_free);
     ei_free(outputs);
 
-    if (run_res != EI_IMPULSE_OK) {
-        return run_res;
+    if (res != EI_IMPULSE_OK) {
+        return res;
+    }
+
+    // setup is shared, so every window gets an even share of the batch
+    uint64_t classification_us = window_count ? (ei_read_timer_us() - ctx_start_us) / window_count : 0;
+    for (size_t w = 0; w < window_count; w++) {
+        results[w].timing.classification_us = classification_us;
+        results[w].timing.classification = (int)(classification_us / 1000);
+    }
+
+    EI_LOGD("Predictions for %d windows (time: %d us. per window):\n", (int)window_count, (int)classification_us);
+
+    if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
+        return EI_IMPULSE_CANCELED;
     }
 
     return EI_IMPULSE_OK;
@@ -387,49 +509,9 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         result,
         debug);
 
-    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
-        TfLiteTensor* output = &outputs[output_ix];
-        // calculate the size of the output by iterating through dims
-        size_t output_size = 1;
-        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
-            output_size *= output->dims->data[dim_num];
-        }
-
-        switch (output->type) {
-            case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
-                break;
-            }
-            case kTfLiteInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
-                }
-                break;
-            }
-            case kTfLiteUInt8: {
-                if (block_config->dequantize_output) {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                    fill_output_matrix_from_tensor(output, result->_raw_outputs[learn_block_index + output_ix].matrix);
-                }
-                else {
-                    result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
-                    memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
-                }
-                break;
-            }
-            default: {
-                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
-                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
-            }
-        }
-
-        result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
+    EI_IMPULSE_ERROR output_res = copy_output_tensors(block_config, outputs, learn_block_index, result->_raw_outputs);
+    if (output_res != EI_IMPULSE_OK) {
+        return output_res;
     }
 
     graph_config->model_reset(ei_aligned_free);
@@ -35,8 +35,6 @@
 #ifndef EI_PERFORMANCE_CALIBRATION_H
 #define EI_PERFORMANCE_CALIBRATION_H
 
-#if EI_CLASSIFIER_CALIBRATION_ENABLED
-
 /* Includes ---------------------------------------------------------------- */
 #include "edge-impulse-sdk/dsp/numpy_types.h"
 #include "edge-impulse-sdk/dsp/returntypes.hpp"
@@ -148,6 +146,34 @@ public:
         return this->_detection_threshold;
     }
 
+    /**
+     * Forget all scores (e.g. after a gap in the audio stream), without
+     * reallocating. Suppression is lifted as well.
+     * @param fill_window Treat the window as full of zero scores, so the first
+     *        inferences are averaged over the whole window instead of
+     *        triggering on their own
+     */
+    void reset(bool fill_window = false)
+    {
+        if (this->_score_array == NULL || this->_running_sum == NULL) {
+            return;
+        }
+        for (uint32_t i = 0; i < this->_average_window_duration_samples * this->_n_labels; i++) {
+            this->_score_array[i] = 0.f;
+        }
+        for (uint32_t i = 0; i < this->_n_labels; i++) {
+            this->_running_sum[i] = 0.f;
+        }
+        this->_score_idx = 0;
+        this->_n_scores_in_array = fill_window ? this->_average_window_duration_samples : 0;
+        this->_suppression_count = this->_suppression_samples;
+    }
+
+    uint32_t average_window_samples()
+    {
+        return this->_average_window_duration_samples;
+    }
+
     int32_t trigger(ei_impulse_result_classification_t *scores)
     {
         int32_t recognized_event = EI_PC_RET_NO_EVENT_DETECTED;
@@ -233,6 +259,10 @@ private:
     uint32_t _n_scores_in_array;
 };
 
+// The class above is usable on its own (e.g. by an application's wake word
+// loop); the post-processing block hooks need a calibrated impulse
+#if EI_CLASSIFIER_CALIBRATION_ENABLED
+
 EI_IMPULSE_ERROR init_perfcal(ei_impulse_handle_t *handle, void **state, void *config)
 {
     const ei_impulse_t *impulse = handle->impulse;
@@ -274,7 +304,7 @@ EI_IMPULSE_ERROR process_perfcal(ei_impulse_handle_t *handle,
 
             // perfcal is configured
             static bool has_printed_msg = false;
-            result->postprocessed_output.perf_cal_output = *std::unique_ptr<ei_perf_cal_output_t>(new ei_perf_cal_output_t).get();
+            result->postprocessed_output.perf_cal_output = ei_perf_cal_output_t();
 
             if (!has_printed_msg) {
                 ei_printf("\nPerformance calibration is configured for your project. If no event is detected, all values are 0.\r\n\n");
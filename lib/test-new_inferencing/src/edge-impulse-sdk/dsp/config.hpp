@@ -95,6 +95,23 @@
 #define EIDSP_QUANTIZE_FILTERBANK    1
 #endif // EIDSP_QUANTIZE_FILTERBANK
 
+// Polynomial log / log10 (ei_fast_math.h) in the spectrogram, MFE and MFCC
+// blocks, and power spectra computed without the magnitude's sqrt()
+#ifndef EIDSP_FAST_MATH
+#define EIDSP_FAST_MATH              0
+#endif // EIDSP_FAST_MATH
+
+// matrix_t temporaries of the audio DSP blocks come from a per thread arena
+// (scratch.hpp) instead of one heap allocation each
+#ifndef EIDSP_USE_DSP_SCRATCH
+#define EIDSP_USE_DSP_SCRATCH        1
+#endif // EIDSP_USE_DSP_SCRATCH
+
+// alignment of every matrix buffer in the arena, a data cache line on the ESP32-S3
+#ifndef EIDSP_SCRATCH_ALIGNMENT
+#define EIDSP_SCRATCH_ALIGNMENT      32
+#endif // EIDSP_SCRATCH_ALIGNMENT
+
 // prints buffer allocations to stdout, useful when debugging
 #ifndef EIDSP_TRACK_ALLOCATIONS
 #define EIDSP_TRACK_ALLOCATIONS      0
@@ -110,6 +127,12 @@
 #define EIDSP_SIGNAL_C_FN_POINTER    0
 #endif // EIDSP_SIGNAL_C_FN_POINTER
 
+// Integer real FFT with block scaling (dsp_engines/ei_fixed_point_fft.h) instead
+// of the target's DSP library or KissFFT, e.g. for cores without an FPU
+#ifndef EIDSP_USE_FIXED_POINT_FFT
+#define EIDSP_USE_FIXED_POINT_FFT 0
+#endif // EIDSP_USE_FIXED_POINT_FFT
+
 #ifndef EIDSP_USE_ESP_DSP
 #if defined(ESP32) || defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3) || defined(CONFIG_IDF_TARGET_ESP32P4) || defined(CONFIG_IDF_TARGET_ESP32C3)
 #define EIDSP_USE_ESP_DSP 1
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef __EI_FIXED_POINT_FFT__H__
+#define __EI_FIXED_POINT_FFT__H__
+
+/**
+ * Integer real FFT, laid out like CMSIS-DSP's arm_rfft_q31(): an N/2 point
+ * complex radix-2 FFT over the even/odd packed input, then a split pass to the
+ * N/2 + 1 bin spectrum. Plain C++, so it builds on any target (Xtensa, x86,
+ * RISC-V) and needs no FPU.
+ *
+ * fixed_point::rfft() takes integer samples at any scale (int16 audio as is)
+ * and gives integer bins with one exponent for the block. CMSIS scales every
+ * stage by 1/2 and so loses log2(N) bits; here the input is normalized to 29
+ * bits and a stage only shifts down as far as its input needs to keep the next
+ * one from overflowing. The spectrum keeps ~28 bits below its peak whatever
+ * the input level, so the power spectrum and the mel stage after it see the
+ * full dynamic range.
+ *
+ * With EIDSP_USE_FIXED_POINT_FFT=1 (config.hpp) it is also the DSP engine:
+ * hw_r2c_fft() converts rfft()'s float copy of the frame to integers in place
+ * and the bins back to float. Sizes other than powers of two between
+ * MIN_FFT_SIZE and MAX_FFT_SIZE fall back to KissFFT.
+ *
+ * Twiddles are made on first use per thread (like numpy::dct2_ortho_basis()),
+ * N/2 complex values, 2 KB for 512. A table for N serves every smaller size.
+ * After that a call makes no heap allocations.
+ */
+
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+#include "edge-impulse-sdk/dsp/config.hpp"
+#include "edge-impulse-sdk/dsp/returntypes.hpp"
+#include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+namespace ei {
+
+namespace fft {
+
+namespace fixed_point {
+
+    typedef struct {
+        int32_t r;
+        int32_t i;
+    } q31_complex_t;
+
+    constexpr size_t min_size = 32;
+    constexpr size_t max_size = 4096;
+
+    // Butterflies grow a component by at most 1 + sqrt(2), the split pass by
+    // 2 + 2 sqrt(2) before its 1/2, so stage inputs are kept below 2^29
+    constexpr int headroom_bits = 29;
+
+    static bool can_do(size_t n_fft)
+    {
+        return n_fft >= min_size && n_fft <= max_size && (n_fft & (n_fft - 1)) == 0;
+    }
+
+    /**
+     * W_N^k = exp(-2 pi i k / N) for k in [0, N/2), Q31, for the largest N asked
+     * for on this thread so far. A failed allocation isn't kept, the next call
+     * tries again.
+     * @param stride Out: step through the table for an n_fft point FFT
+     */
+    static const q31_complex_t *twiddles(size_t n_fft, size_t *stride)
+    {
+        struct twiddle_cache {
+            q31_complex_t *table = nullptr;
+            size_t n_fft = 0;
+            ~twiddle_cache() {
+                ei_free(table);
+            }
+        };
+        static thread_local twiddle_cache cache;
+
+        if (!cache.table || cache.n_fft < n_fft) {
+            q31_complex_t *table = (q31_complex_t *)ei_malloc(n_fft / 2 * sizeof(q31_complex_t));
+            if (!table) {
+                return nullptr;
+            }
+            for (size_t k = 0; k < n_fft / 2; k++) {
+                const double phase = -6.283185307179586 * (double)k / (double)n_fft;
+                // 1.0 isn't representable, saturate to 0x7fffffff
+                const double c = cos(phase) * 2147483648.0;
+                const double s = sin(phase) * 2147483648.0;
+                table[k].r = c >= 2147483647.0 ? INT32_MAX : (int32_t)lround(c);
+                table[k].i = s >= 2147483647.0 ? INT32_MAX : (int32_t)lround(s);
+            }
+            ei_free(cache.table);
+            cache.table = table;
+            cache.n_fft = n_fft;
+        }
+        *stride = cache.n_fft / n_fft;
+        return cache.table;
+    }
+
+    // |x| rounded down to a power of two fits into the same bits, so OR-ing
+    // these over a block gives the same bit length as the block's maximum
+    __attribute__((always_inline)) static inline uint32_t magnitude_bits(int32_t x)
+    {
+        return (uint32_t)(x ^ (x >> 31));
+    }
+
+    __attribute__((always_inline)) static inline int bit_length(uint32_t bits)
+    {
+        return bits ? 32 - __builtin_clz(bits) : 0;
+    }
+
+    // Right shift that brings a block with these magnitude_bits() below 2^headroom_bits
+    __attribute__((always_inline)) static inline int shift_for(uint32_t bits)
+    {
+        const int excess = bit_length(bits) - headroom_bits;
+        return excess > 0 ? excess : 0;
+    }
+
+    static void bit_reverse(q31_complex_t *data, size_t m)
+    {
+        for (size_t i = 0, j = 0; i < m; i++) {
+            if (i < j) {
+                const q31_complex_t t = data[i];
+                data[i] = data[j];
+                data[j] = t;
+            }
+            size_t bit = m >> 1;
+            while (j & bit) {
+                j ^= bit;
+                bit >>= 1;
+            }
+            j |= bit;
+        }
+    }
+
+    /**
+     * Radix-2 decimation in time over `m` points in bit-reversed order, in place,
+     * the first two stages as one radix-4 pass.
+     * @param bits In: magnitude_bits() of the input, OR-ed. Out: the same for the output.
+     * @returns Number of right shifts applied, the output is X / 2^shifts
+     */
+    static int cfft(q31_complex_t *data, size_t m, const q31_complex_t *tw, size_t tw_stride, uint32_t &bits)
+    {
+        // First two stages as one radix-4 pass: W is 1 or -i, no multiplies.
+        // Each stage at most doubles a component, the input is below 2^29,
+        // so both fit without a shift in between.
+        int total_shift = shift_for(bits);
+        {
+            const int shift = total_shift;
+            bits = 0;
+            for (size_t start = 0; start < m; start += 4) {
+                q31_complex_t *x = &data[start];
+
+                const int32_t x0r = x[0].r >> shift, x0i = x[0].i >> shift;
+                const int32_t x1r = x[1].r >> shift, x1i = x[1].i >> shift;
+                const int32_t x2r = x[2].r >> shift, x2i = x[2].i >> shift;
+                const int32_t x3r = x[3].r >> shift, x3i = x[3].i >> shift;
+                const int32_t s0r = x0r + x1r, s0i = x0i + x1i, d0r = x0r - x1r, d0i = x0i - x1i;
+                const int32_t s1r = x2r + x3r, s1i = x2i + x3i, d1r = x2r - x3r, d1i = x2i - x3i;
+
+                x[0].r = s0r + s1r;
+                x[0].i = s0i + s1i;
+                x[2].r = s0r - s1r;
+                x[2].i = s0i - s1i;
+                // -i * d1 = d1.i - i d1.r
+                x[1].r = d0r + d1i;
+                x[1].i = d0i - d1r;
+                x[3].r = d0r - d1i;
+                x[3].i = d0i + d1r;
+                for (int k = 0; k < 4; k++) {
+                    bits |= magnitude_bits(x[k].r) | magnitude_bits(x[k].i);
+                }
+            }
+        }
+
+        for (size_t len = 8; len <= m; len <<= 1) {
+            const int shift = shift_for(bits);
+            total_shift += shift;
+            bits = 0;
+
+            const size_t half = len >> 1;
+            const size_t step = tw_stride * (m / len);
+            for (size_t start = 0; start < m; start += len) {
+                for (size_t j = 0; j < half; j++) {
+                    const q31_complex_t w = tw[j * step];
+                    q31_complex_t *a = &data[start + j];
+                    q31_complex_t *b = &data[start + j + half];
+
+                    const int32_t ar = a->r >> shift, ai = a->i >> shift;
+                    const int32_t br = b->r >> shift, bi = b->i >> shift;
+                    const int32_t tr = (int32_t)(((int64_t)br * w.r - (int64_t)bi * w.i) >> 31);
+                    const int32_t ti = (int32_t)(((int64_t)br * w.i + (int64_t)bi * w.r) >> 31);
+
+                    a->r = ar + tr;
+                    a->i = ai + ti;
+                    b->r = ar - tr;
+                    b->i = ai - ti;
+                    bits |= magnitude_bits(a->r) | magnitude_bits(a->i) | magnitude_bits(b->r) | magnitude_bits(b->i);
+                }
+            }
+        }
+        return total_shift;
+    }
+
+    /**
+     * N/2 point complex FFT of z (the packed real input, normalized), then the
+     * split to n_fft / 2 + 1 bins, each passed to store(k, re, im)
+     * @returns Number of right shifts applied, the bins are X / 2^shifts
+     */
+    template<typename Store>
+    static int transform(q31_complex_t *z, size_t n_fft, const q31_complex_t *tw, size_t tw_stride, uint32_t bits,
+                         Store store)
+    {
+        const size_t m = n_fft / 2;
+        bit_reverse(z, m);
+        // the N/2 point FFT uses every other twiddle of the N point table
+        int shift = cfft(z, m, tw, 2 * tw_stride, bits);
+
+        // Split: with A = Z[k], B = conj(Z[m - k]) (Z[m] = Z[0]),
+        // X[k] = ((A + B) - i W_N^k (A - B)) / 2, for k in [0, m]. Z is brought
+        // below 2^headroom_bits first, so the sums fit 31 bits, the products 62
+        // and the result 31 again.
+        const int split_shift = shift_for(bits);
+        shift += split_shift;
+        for (size_t k = 0; k <= m; k++) {
+            const q31_complex_t a = z[k == m ? 0 : k];
+            const q31_complex_t b = z[k == 0 ? 0 : m - k];
+            const int64_t ar = a.r >> split_shift, ai = a.i >> split_shift;
+            const int64_t br = b.r >> split_shift, bi = -(b.i >> split_shift);
+            const int64_t e_r = ar + br, e_i = ai + bi;
+            const int64_t o_r = ar - br, o_i = ai - bi;
+
+            // W_N^m = -1, past the end of the table
+            const int64_t w_r = k < m ? tw[k * tw_stride].r : -(int64_t)INT32_MAX;
+            const int64_t w_i = k < m ? tw[k * tw_stride].i : 0;
+
+            // -i * (w * o) = (w.r * o.i + w.i * o.r) - i (w.r * o.r - w.i * o.i)
+            const int64_t xr = e_r + ((w_r * o_i + w_i * o_r) >> 31);
+            const int64_t xi = e_i - ((w_r * o_r - w_i * o_i) >> 31);
+            store(k, (int32_t)(xr >> 1), (int32_t)(xi >> 1));
+        }
+        return shift;
+    }
+
+    /**
+     * Real FFT of integer samples.
+     * @param samples n_fft samples, any scale. Overwritten: used as the work buffer
+     * @param n_fft FFT size, a power of two between min_size and max_size
+     * @param output n_fft / 2 + 1 bins
+     * @param exponent Out: X[k] = output[k] * 2^exponent
+     * @returns EIDSP_OK, EIDSP_FFT_SIZE_NOT_SUPPORTED or EIDSP_OUT_OF_MEM
+     */
+    static int rfft(int32_t *samples, size_t n_fft, q31_complex_t *output, int *exponent)
+    {
+        if (!can_do(n_fft)) {
+            return EIDSP_FFT_SIZE_NOT_SUPPORTED;
+        }
+        size_t tw_stride;
+        const q31_complex_t *tw = twiddles(n_fft, &tw_stride);
+        if (!tw) {
+            return EIDSP_OUT_OF_MEM;
+        }
+
+        uint32_t bits = 0, any = 0;
+        for (size_t ix = 0; ix < n_fft; ix++) {
+            bits |= magnitude_bits(samples[ix]);
+            any |= (uint32_t)samples[ix];
+        }
+        if (!any) {
+            memset(output, 0, (n_fft / 2 + 1) * sizeof(q31_complex_t));
+            *exponent = 0;
+            return EIDSP_OK;
+        }
+
+        // Largest sample just below 2^headroom_bits, or shifted down to it
+        const int input_shift = headroom_bits - bit_length(bits);
+        if (input_shift > 0) {
+            for (size_t ix = 0; ix < n_fft; ix++) {
+                samples[ix] = (int32_t)((uint32_t)samples[ix] << input_shift);
+            }
+        }
+        else if (input_shift < 0) {
+            for (size_t ix = 0; ix < n_fft; ix++) {
+                samples[ix] >>= -input_shift;
+            }
+        }
+        bits = 0;
+        for (size_t ix = 0; ix < n_fft; ix++) {
+            bits |= magnitude_bits(samples[ix]);
+        }
+
+        // z[n] = x[2n] + i x[2n + 1] is the samples' own layout
+        q31_complex_t *z = reinterpret_cast<q31_complex_t *>(samples);
+        const int shift = transform(z, n_fft, tw, tw_stride, bits, [output](size_t k, int32_t re, int32_t im) {
+            output[k].r = re;
+            output[k].i = im;
+        });
+        *exponent = shift - input_shift;
+        return EIDSP_OK;
+    }
+
+} // namespace fixed_point
+
+#if EIDSP_USE_FIXED_POINT_FFT
+
+constexpr int MIN_FFT_SIZE = (int)fixed_point::min_size;
+constexpr int MAX_FFT_SIZE = (int)fixed_point::max_size;
+
+static bool can_do_fft(size_t n_fft)
+{
+    return fixed_point::can_do(n_fft);
+}
+
+/**
+ * Real FFT of `n_fft` samples to n_fft / 2 + 1 complex bins through
+ * fixed_point::rfft(). Like the vendor engines, works in the input buffer
+ * (numpy::rfft()'s copy of the frame).
+ */
+static int hw_r2c_fft(const float *input, ei::fft_complex_t *output, size_t n_fft)
+{
+    using namespace fixed_point;
+
+    if (!can_do(n_fft)) {
+        return EIDSP_FFT_SIZE_NOT_SUPPORTED;
+    }
+    size_t tw_stride;
+    const q31_complex_t *tw = twiddles(n_fft, &tw_stride);
+    if (!tw) {
+        return EIDSP_OUT_OF_MEM;
+    }
+
+    float peak = 0.0f;
+    for (size_t ix = 0; ix < n_fft; ix++) {
+        const float v = fabsf(input[ix]);
+        peak = v > peak ? v : peak;
+    }
+    if (peak == 0.0f) {
+        memset(output, 0, (n_fft / 2 + 1) * sizeof(ei::fft_complex_t));
+        return EIDSP_OK;
+    }
+
+    // peak * 2^input_shift just below 2^headroom_bits; each float is read
+    // before its slot is written as an integer
+    int exponent;
+    frexpf(peak, &exponent);
+    int input_shift = headroom_bits - exponent;
+    input_shift = input_shift > 126 ? 126 : input_shift < -126 ? -126 : input_shift;
+    const float input_scale = ldexpf(1.0f, input_shift);
+    q31_complex_t *z = reinterpret_cast<q31_complex_t *>(const_cast<float *>(input));
+    uint32_t bits = 0;
+    for (size_t n = 0; n < n_fft / 2; n++) {
+        const int32_t re = (int32_t)(input[2 * n] * input_scale);
+        const int32_t im = (int32_t)(input[2 * n + 1] * input_scale);
+        z[n].r = re;
+        z[n].i = im;
+        bits |= magnitude_bits(re) | magnitude_bits(im);
+    }
+
+    // The shift is only known at the end: store the integers, scale after
+    q31_complex_t *bins = reinterpret_cast<q31_complex_t *>(output);
+    const int shift = transform(z, n_fft, tw, tw_stride, bits, [bins](size_t k, int32_t re, int32_t im) {
+        bins[k].r = re;
+        bins[k].i = im;
+    });
+    const float output_scale = ldexpf(1.0f, shift - input_shift);
+    for (size_t k = 0; k <= n_fft / 2; k++) {
+        const q31_complex_t bin = bins[k];
+        output[k].r = (float)bin.r * output_scale;
+        output[k].i = (float)bin.i * output_scale;
+    }
+    return EIDSP_OK;
+}
+
+#endif // EIDSP_USE_FIXED_POINT_FFT
+
+} // namespace fft
+
+} // namespace ei
+
+#endif // __EI_FIXED_POINT_FFT__H__
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef _EIDSP_FAST_MATH_H_
+#define _EIDSP_FAST_MATH_H_
+
+/**
+ * Polynomial log / log10 for the DSP blocks: no branches, no libm calls, no
+ * fmaf (a libm call on targets without fused multiply-add). Enabled with
+ * EIDSP_FAST_MATH (config.hpp).
+ *
+ * Max errors against double precision, measured on the host over every
+ * positive normal float:
+ *
+ *   log(x)     1.5e-5 absolute for x in [0.5, 2], 1.8e-5 relative elsewhere
+ *   log10(x)   6.6e-6 absolute for x in [0.5, 2], 1.8e-5 relative elsewhere
+ *              (numpy::log10(): 4.0e-4 and 1.3e-3)
+ *
+ * At the -O2 / -Os the firmware builds with, these run one value at a time.
+ * log() is about 4x numpy::log(), which pays for the fmaf calls; log10() on
+ * its own is level with numpy::log10(), but it inlines where that calls
+ * frexpf(), which keeps the MFE and spectrogram normalization loops around it
+ * about 1.5x faster. tests/test_fast_math.cpp measures both.
+ *
+ * They expect positive normal numbers (the callers clamp to 1e-10 or 1e-30
+ * first). Outside that the result is garbage, there's no range check.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "numpy_types.h"
+
+namespace ei {
+namespace fast_math {
+
+    __attribute__((always_inline)) static inline float log(float a)
+    {
+        // numpy::log() without fmaf: same reduction and polynomial (Norbert Juffa,
+        // 2-clause BSD, see the license there)
+        int32_t g;
+        memcpy(&g, &a, sizeof(g));
+        int32_t e = (g - 0x3f2aaaab) & 0xff800000;
+        g = g - e;
+        float m;
+        memcpy(&m, &g, sizeof(m));
+        float i = (float)e * 1.19209290e-7f; // 0x1.0p-23
+        /* m in [2/3, 4/3] */
+        float f = m - 1.0f;
+        float s = f * f;
+        /* Compute log1p(f) for f in [-1/3, 1/3] */
+        float r = 0.230836749f * f - 0.279208571f;
+        float t = 0.331826031f * f - 0.498910338f;
+        r = r * s + t;
+        r = r * s + f;
+        return i * 0.693147182f + r; // log(2)
+    }
+
+    __attribute__((always_inline)) static inline float log10(float a)
+    {
+        return log(a) * 0.434294482f; // 1 / log(10)
+    }
+
+    /**
+     * In place over an array, see log(float)
+     */
+    static inline void log(float *buffer, size_t size)
+    {
+        for (size_t ix = 0; ix < size; ix++) {
+            buffer[ix] = log(buffer[ix]);
+        }
+    }
+
+    /**
+     * Power spectrum straight from a complex FFT output: scale * |X|^2. The
+     * usual route through the magnitude takes a sqrt() per bin only to square
+     * it again.
+     * @param fft Complex FFT output
+     * @param out Out buffer (size floats), may point at `fft` itself for in place
+     * @param size Number of bins
+     * @param scale Usually 1 / fft_length
+     */
+    static inline void power(const fft_complex_t *fft, float *out, size_t size, float scale)
+    {
+        for (size_t ix = 0; ix < size; ix++) {
+            out[ix] = scale * (fft[ix].r * fft[ix].r + fft[ix].i * fft[ix].i);
+        }
+    }
+
+} // namespace fast_math
+} // namespace ei
+
+#endif // _EIDSP_FAST_MATH_H_
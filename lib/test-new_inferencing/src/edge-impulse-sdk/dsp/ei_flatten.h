@@ -104,7 +104,7 @@ public:
             float mean; // to use with moving average
 
             if (config.average || config.moving_avg_num_windows) {
-                float fbuffer;
+                float fbuffer = 0.0f;
                 matrix_t out_matrix(1, 1, &fbuffer);
                 numpy::mean(&row_matrix, &out_matrix);
                 mean = out_matrix.buffer[0];
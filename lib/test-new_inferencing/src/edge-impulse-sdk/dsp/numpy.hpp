@@ -59,11 +59,16 @@
 #include "returntypes.hpp"
 #include "memory.hpp"
 #include "ei_utils.h"
+#include "ei_fast_math.h"
 #include "kissfft/kiss_fftr.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
 
 // Checks for hardware math engines and associated kernel includes
-#if EIDSP_USE_CEVA_DSP
+#if EIDSP_USE_FIXED_POINT_FFT
+#define EIDSP_INCLUDE_KISSFFT 1
+#include "edge-impulse-sdk/dsp/dsp_engines/ei_fixed_point_fft.h"
+
+#elif EIDSP_USE_CEVA_DSP
 // #include "edge-impulse-sdk/dsp/dsp_engines/ei_ceva_numpy.h" // pending
 
 #if EIDSP_USE_CEVA_DSP_FIXED
@@ -621,6 +626,109 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Orthonormal DCT-II basis, truncated to the first num_cepstral outputs and
+     * laid out num_filters x num_cepstral (one row per input) for dct2_truncated()
+     * @param out Out buffer of num_filters * num_cepstral
+     * @param num_filters Number of inputs (N)
+     * @param num_cepstral Number of outputs to keep
+     */
+    static void dct2_ortho_matrix(float *out, size_t num_filters, size_t num_cepstral) {
+        const float scale_first = sqrt(1.0f / static_cast<float>(num_filters));
+        const float scale = sqrt(2.0f / static_cast<float>(num_filters));
+
+        for (size_t n = 0; n < num_filters; n++) {
+            for (size_t k = 0; k < num_cepstral; k++) {
+                // cos(pi * phase / 2N), folded into the first quadrant with integer
+                // math so cos() only sees small, exactly representable angles
+                size_t phase = (k * (2 * n + 1)) % (4 * num_filters);
+                if (phase > 2 * num_filters) {
+                    phase = 4 * num_filters - phase;
+                }
+                float sign = 1.0f;
+                if (phase > num_filters) {
+                    phase = 2 * num_filters - phase;
+                    sign = -1.0f;
+                }
+                out[n * num_cepstral + k] = sign * (k == 0 ? scale_first : scale) *
+                    cos(static_cast<float>(M_PI) * static_cast<float>(phase) / static_cast<float>(2 * num_filters));
+            }
+        }
+    }
+
+    /**
+     * dct2_ortho_matrix() for the last (num_filters, num_cepstral) asked for on
+     * this thread, built on the first call and kept (like the scratch arena), so
+     * calls with the same config neither allocate nor call cos(). Valid until
+     * the next call with another config on the same thread.
+     * @returns The basis, or nullptr if out of memory
+     */
+    static const float *dct2_ortho_basis(size_t num_filters, size_t num_cepstral) {
+        struct basis_cache {
+            float *basis = nullptr;
+            size_t num_filters = 0;
+            size_t num_cepstral = 0;
+            ~basis_cache() {
+                ei_free(basis);
+            }
+        };
+        static thread_local basis_cache cache;
+
+        if (cache.basis && cache.num_filters == num_filters && cache.num_cepstral == num_cepstral) {
+            return cache.basis;
+        }
+        ei_free(cache.basis);
+        cache.basis = (float *)ei_malloc(num_filters * num_cepstral * sizeof(float));
+        if (!cache.basis) {
+            return nullptr;
+        }
+        dct2_ortho_matrix(cache.basis, num_filters, num_cepstral);
+        cache.num_filters = num_filters;
+        cache.num_cepstral = num_cepstral;
+        return cache.basis;
+    }
+
+    /**
+     * First num_cepstral outputs of the orthonormal DCT-II of every row (same as
+     * dct2() with DCT_NORMALIZATION_ORTHO), as one small matrix product:
+     * (rows x num_filters) * (num_filters x num_cepstral). Does not allocate.
+     * @param input Input rows (rows x num_filters)
+     * @param rows Number of rows
+     * @param num_filters Number of columns in the input
+     * @param dct_matrix Basis from dct2_ortho_matrix() or dct2_ortho_basis()
+     * @param num_cepstral Number of columns in the output
+     * @param output Out buffer (rows x num_cepstral), cannot overlap the input
+     */
+    static void dct2_truncated(const float *input, size_t rows, size_t num_filters,
+        const float *dct_matrix, size_t num_cepstral, float *output)
+    {
+        for (size_t row = 0; row < rows; row++) {
+            const float *in = input + row * num_filters;
+            float *out = output + row * num_cepstral;
+
+            // Every basis vector but the first sums to zero, so the row mean only
+            // contributes to output 0. Taking it out first keeps the partial sums
+            // (and their rounding error) small: log mel energies share a large offset.
+            float mean = 0.0f;
+            for (size_t n = 0; n < num_filters; n++) {
+                mean += in[n];
+            }
+            mean /= static_cast<float>(num_filters);
+
+            memset(out, 0, num_cepstral * sizeof(float));
+            out[0] = mean * static_cast<float>(num_filters) * dct_matrix[0];
+            // accumulate one basis row at a time, the inner loop runs over
+            // contiguous outputs and vectorizes
+            for (size_t n = 0; n < num_filters; n++) {
+                const float x = in[n] - mean;
+                const float *basis = dct_matrix + n * num_cepstral;
+                for (size_t k = 0; k < num_cepstral; k++) {
+                    out[k] += x * basis[k];
+                }
+            }
+        }
+    }
+
     /**
      * Quantize a float value between zero and one
      * @param value Float value
@@ -1330,9 +1438,9 @@ public:
             EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
         }
 
-        fft_complex_t *fft_output = NULL;
-        auto ptr = EI_MAKE_TRACKED_POINTER(fft_output, n_fft_out_features);
-        EI_ERR_AND_RETURN_ON_NULL(fft_output, EIDSP_OUT_OF_MEM);
+        // as a matrix, so inside a dsp_scratch_scope it comes from the arena
+        EI_DSP_MATRIX(fft_matrix, 1, n_fft_out_features * 2);
+        fft_complex_t *fft_output = reinterpret_cast<fft_complex_t *>(fft_matrix.buffer);
 
         int ret = rfft(src, src_size, fft_output, n_fft_out_features, n_fft);
         if (ret != EIDSP_OK) {
@@ -1624,9 +1732,13 @@ public:
      */
     static int log(matrix_t *matrix)
     {
+#if EIDSP_FAST_MATH == 1
+        fast_math::log(matrix->buffer, matrix->rows * matrix->cols);
+#else
         for (uint32_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
             matrix->buffer[ix] = numpy::log(matrix->buffer[ix]);
         }
+#endif // EIDSP_FAST_MATH
 
         return EIDSP_OK;
     }
@@ -1753,24 +1865,54 @@ public:
         return EIDSP_OK;
     }
 
+#if EIDSP_INCLUDE_KISSFFT || !defined(EIDSP_INCLUDE_KISSFFT)
+    /**
+     * KissFFT real forward FFT config for the last n_fft asked for on this
+     * thread, set up on the first call and kept (like dct2_ortho_basis()), so
+     * FFTs of the same size neither allocate nor compute twiddles again. Valid
+     * until the next call with another size on the same thread.
+     * @returns The config, or nullptr if out of memory
+     */
+    static kiss_fftr_cfg kiss_fftr_config(size_t n_fft) {
+        struct config_cache {
+            kiss_fftr_cfg cfg = nullptr;
+            size_t n_fft = 0;
+            size_t mem_length = 0;
+            ~config_cache() {
+                if (cfg) {
+                    ei_dsp_free(cfg, mem_length);
+                }
+            }
+        };
+        static thread_local config_cache cache;
+
+        if (cache.cfg && cache.n_fft == n_fft) {
+            return cache.cfg;
+        }
+        if (cache.cfg) {
+            ei_dsp_free(cache.cfg, cache.mem_length);
+        }
+        cache.cfg = kiss_fftr_alloc(n_fft, 0, NULL, NULL, &cache.mem_length);
+        if (!cache.cfg) {
+            return nullptr;
+        }
+        ei_dsp_register_alloc(cache.mem_length, cache.cfg);
+        cache.n_fft = n_fft;
+        return cache.cfg;
+    }
+#endif
+
     static int software_rfft(float *fft_input, fft_complex_t *output, size_t n_fft, size_t n_fft_out_features)
     {
     #if EIDSP_INCLUDE_KISSFFT || !defined(EIDSP_INCLUDE_KISSFFT)
-        // create fftr context
-        size_t kiss_fftr_mem_length;
-
-        kiss_fftr_cfg cfg = kiss_fftr_alloc(n_fft, 0, NULL, NULL, &kiss_fftr_mem_length);
+        kiss_fftr_cfg cfg = kiss_fftr_config(n_fft);
         if (!cfg) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
 
-        ei_dsp_register_alloc(kiss_fftr_mem_length, cfg);
-
         // execute the rfft operation
         kiss_fftr(cfg, fft_input, (kiss_fft_cpx*)output);
 
-        ei_dsp_free(cfg, kiss_fftr_mem_length);
-
         return EIDSP_OK;
     #else
         return EIDSP_NOT_SUPPORTED;
@@ -1808,7 +1950,7 @@ public:
      * @returns EIDSP_OK if OK
      */
     static int power_spectrum(
-        float *frame,
+        const float *frame,
         size_t frame_size,
         float *out_buffer,
         size_t out_buffer_size,
@@ -1818,6 +1960,22 @@ public:
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
+#if EIDSP_FAST_MATH == 1
+        // |X|^2 straight from the complex output, no sqrt() to square again
+        // as a matrix, so inside a dsp_scratch_scope it comes from the arena
+        EI_DSP_MATRIX(fft_matrix, 1, out_buffer_size * 2);
+        if (!fft_matrix.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        fft_complex_t *fft_output = reinterpret_cast<fft_complex_t *>(fft_matrix.buffer);
+
+        int r = numpy::rfft(frame, frame_size, fft_output, out_buffer_size, fft_points);
+        if (r != EIDSP_OK) {
+            return r;
+        }
+
+        fast_math::power(fft_output, out_buffer, out_buffer_size, 1.0f / static_cast<float>(fft_points));
+#else
         int r = numpy::rfft(frame, frame_size, out_buffer, out_buffer_size, fft_points);
         if (r != EIDSP_OK) {
             return r;
@@ -1827,6 +1985,7 @@ public:
             out_buffer[ix] = (1.0 / static_cast<float>(fft_points)) *
                 (out_buffer[ix] * out_buffer[ix]);
         }
+#endif // EIDSP_FAST_MATH
 
         return EIDSP_OK;
     }
@@ -48,6 +48,9 @@
 #if EIDSP_TRACK_ALLOCATIONS
 #include "memory.hpp"
 #endif
+#ifdef __cplusplus
+#include "scratch.hpp"
+#endif
 
 #ifdef __cplusplus
 namespace ei {
@@ -63,7 +66,8 @@ typedef struct {
     int32_t i;
 } fft_complex_i32_t;
 /**
- * A matrix structure that allocates a matrix on the **heap**.
+ * A matrix structure that allocates a matrix on the **heap**, or from the
+ * thread's dsp_scratch while a dsp_scratch_scope is open (scratch.hpp).
  * Freeing happens by calling `delete` on the object or letting the object go out of scope.
  */
 typedef struct ei_matrix {
@@ -71,6 +75,12 @@ typedef struct ei_matrix {
     uint32_t rows;
     uint32_t cols;
     bool buffer_managed_by_me;
+    size_t _scratch_size;   // bytes taken from _scratch, 0 if the buffer isn't from a dsp_scratch
+#ifdef __cplusplus
+    dsp_scratch *_scratch;  // arena the buffer came from, freed into it
+#else
+    void *_scratch;
+#endif
 
 #if EIDSP_TRACK_ALLOCATIONS
     const char *_fn;
@@ -99,10 +109,22 @@ typedef struct ei_matrix {
 #endif
         )
     {
+        _scratch_size = 0;
+        _scratch = nullptr;
         if (a_buffer) {
             buffer = a_buffer;
             buffer_managed_by_me = false;
         }
+#if EIDSP_USE_DSP_SCRATCH
+        else if (dsp_scratch::local().active()) {
+            buffer = (float*)dsp_scratch::local().calloc(n_rows * n_cols * sizeof(float));
+            buffer_managed_by_me = true;
+            if (buffer) {
+                _scratch_size = n_rows * n_cols * sizeof(float);
+                _scratch = &dsp_scratch::local();
+            }
+        }
+#endif
         else {
             buffer = (float*)ei_calloc(n_rows * n_cols * sizeof(float), 1);
             buffer_managed_by_me = true;
@@ -129,6 +151,12 @@ typedef struct ei_matrix {
 
     ~ei_matrix() {
         if (buffer && buffer_managed_by_me) {
+#if EIDSP_USE_DSP_SCRATCH
+            if (_scratch_size) {
+                _scratch->free(buffer, _scratch_size);
+            }
+            else
+#endif
             ei_free(buffer);
 
 #if EIDSP_TRACK_ALLOCATIONS
@@ -186,6 +214,8 @@ typedef struct ei_matrix_i8 {
     uint32_t rows;
     uint32_t cols;
     bool buffer_managed_by_me;
+    size_t _scratch_size;   // Always 0, so ei_feature_t can delete this as matrix_t (same layout)
+    void *_scratch;         // Always nullptr
 
 #if EIDSP_TRACK_ALLOCATIONS
     const char *_fn;
@@ -214,6 +244,8 @@ typedef struct ei_matrix_i8 {
 #endif
         )
     {
+        _scratch_size = 0;
+        _scratch = nullptr;
         if (a_buffer) {
             buffer = a_buffer;
             buffer_managed_by_me = false;
@@ -530,6 +562,8 @@ typedef struct ei_matrix_u8 {
     uint32_t rows;
     uint32_t cols;
     bool buffer_managed_by_me;
+    size_t _scratch_size;   // Always 0, so ei_feature_t can delete this as matrix_t (same layout)
+    void *_scratch;         // Always nullptr
 
 #if EIDSP_TRACK_ALLOCATIONS
     const char *_fn;
@@ -558,6 +592,8 @@ typedef struct ei_matrix_u8 {
 #endif
         )
     {
+        _scratch_size = 0;
+        _scratch = nullptr;
         if (a_buffer) {
             buffer = a_buffer;
             buffer_managed_by_me = false;
@@ -708,6 +744,13 @@ typedef struct ei_signal_t {
 #endif // __cplusplus
 
 #ifdef __cplusplus
+// ei_feature_t deletes whichever matrix it holds as matrix_t
+static_assert(offsetof(ei::matrix_i8_t, _scratch_size) == offsetof(ei::matrix_t, _scratch_size) &&
+              offsetof(ei::matrix_u8_t, _scratch_size) == offsetof(ei::matrix_t, _scratch_size) &&
+              offsetof(ei::matrix_i8_t, _scratch) == offsetof(ei::matrix_t, _scratch) &&
+              offsetof(ei::matrix_u8_t, _scratch) == offsetof(ei::matrix_t, _scratch),
+              "matrix_i8_t / matrix_u8_t don't share matrix_t's layout");
+
 typedef struct ei_feature_t {
     union {
         ei::matrix_t* matrix;
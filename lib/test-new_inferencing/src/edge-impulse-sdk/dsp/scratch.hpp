@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef _EIDSP_SCRATCH_H_
+#define _EIDSP_SCRATCH_H_
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include "../porting/ei_classifier_porting.h"
+#include "config.hpp"
+
+namespace ei {
+
+/**
+ * Scratch arena for the matrix_t temporaries of a DSP call.
+ *
+ * While a dsp_scratch_scope is open on a thread, matrices that allocate their
+ * own buffer take it from one aligned block instead of ei_calloc(). It is a
+ * bump allocator: freeing the newest allocation gives its space back, and once
+ * everything is freed the block is empty again. DSP temporaries are scoped
+ * locals, so that is the common case.
+ *
+ * The block sizes itself. Allocations that don't fit go to the heap as
+ * before, and when the outermost scope closes the block grows to the high
+ * water mark. From the second call with the same config on, a call makes no
+ * heap allocations for its matrices. reserve() sizes it up front.
+ *
+ * Matrices from the block are still registered with ei_dsp_register_matrix_alloc,
+ * so with EIDSP_TRACK_ALLOCATIONS they count towards ei_memory_peak_use as before.
+ *
+ * Each allocation remembers the arena it came from, so a matrix may outlive
+ * its scope. It must be freed on the thread that made it though: the arena
+ * is not locked, and a debug build asserts on a free from another thread.
+ */
+class dsp_scratch {
+public:
+    ~dsp_scratch()
+    {
+        ei_free(_raw);
+    }
+
+    /**
+     * The calling thread's arena
+     */
+    static dsp_scratch &local()
+    {
+        static thread_local dsp_scratch scratch;
+        return scratch;
+    }
+
+    /**
+     * Whether a dsp_scratch_scope is open on this thread
+     */
+    bool active() const
+    {
+        return _scopes > 0;
+    }
+
+    /**
+     * Zeroed memory, from the block (aligned to EIDSP_SCRATCH_ALIGNMENT) if it
+     * fits, else from the heap. Only while active(), give it back with free().
+     * Size 0 gives nullptr, as heap_caps_calloc() does: a pointer into the
+     * block would look like one the matrix must ei_free().
+     */
+    void *calloc(size_t size)
+    {
+        if (size == 0) {
+            return nullptr;
+        }
+        size = round_up(size);
+        if (_capacity - _used < size) {
+            void *ptr = ei_calloc(size, 1);
+            if (ptr) {
+                account(size);
+            }
+            return ptr;
+        }
+        void *ptr = _base + _used;
+        memset(ptr, 0, size);
+        _used += size;
+        _live += size;
+        account(size);
+        return ptr;
+    }
+
+    /**
+     * @param size Same as passed to calloc()
+     */
+    void free(void *ptr, size_t size)
+    {
+        assert(this == &local() && "DSP scratch freed on another thread than it came from");
+        size = round_up(size);
+        _demand -= size;
+
+        uint8_t *p = (uint8_t *)ptr;
+        if (p < _base || p >= _base + _capacity) {
+            ei_free(ptr);
+            return;
+        }
+        _live -= size;
+        if (_live == 0) {
+            _used = 0;
+        }
+        else if (p + size == _base + _used) {
+            _used -= size;
+        }
+    }
+
+    /**
+     * Grow the block to at least `size` bytes. Only possible while nothing is
+     * allocated from it; if it fails, matrices keep coming from the heap.
+     */
+    bool reserve(size_t size)
+    {
+        size = round_up(size);
+        if (size <= _capacity) {
+            return true;
+        }
+        if (_live != 0) {
+            return false;
+        }
+        ei_free(_raw);
+        _raw = (uint8_t *)ei_malloc(size + EIDSP_SCRATCH_ALIGNMENT - 1);
+        _base = _raw ? (uint8_t *)round_up((uintptr_t)_raw) : nullptr;
+        _capacity = _raw ? size : 0;
+        _used = 0;
+        return _raw != nullptr;
+    }
+
+    /**
+     * Most matrix memory in use at once inside a scope on this thread so far,
+     * each matrix rounded up to EIDSP_SCRATCH_ALIGNMENT
+     */
+    size_t high_water() const
+    {
+        return _high_water;
+    }
+
+    size_t capacity() const
+    {
+        return _capacity;
+    }
+
+private:
+    friend class dsp_scratch_scope;
+
+    dsp_scratch() = default;
+    dsp_scratch(const dsp_scratch &) = delete;
+    dsp_scratch &operator=(const dsp_scratch &) = delete;
+
+    static size_t round_up(size_t size)
+    {
+        return (size + EIDSP_SCRATCH_ALIGNMENT - 1) & ~(size_t)(EIDSP_SCRATCH_ALIGNMENT - 1);
+    }
+
+    void account(size_t size)
+    {
+        _demand += size;
+        if (_demand > _high_water) {
+            _high_water = _demand;
+        }
+    }
+
+    uint8_t *_raw = nullptr;
+    uint8_t *_base = nullptr;
+    size_t _capacity = 0;
+    size_t _used = 0;       // bump offset
+    size_t _live = 0;       // handed out from the block and not freed yet
+    size_t _demand = 0;     // handed out from the block or the heap, not freed yet
+    size_t _high_water = 0;
+    int _scopes = 0;
+};
+
+/**
+ * Serves the matrix_t allocations on this thread from its dsp_scratch until
+ * the scope closes. Scopes nest; the outermost one grows the block.
+ */
+class dsp_scratch_scope {
+public:
+    dsp_scratch_scope() : _scratch(dsp_scratch::local())
+    {
+        _scratch._scopes++;
+    }
+
+    ~dsp_scratch_scope()
+    {
+        if (--_scratch._scopes == 0) {
+            _scratch.reserve(_scratch._high_water);
+        }
+    }
+
+private:
+    dsp_scratch_scope(const dsp_scratch_scope &) = delete;
+    dsp_scratch_scope &operator=(const dsp_scratch_scope &) = delete;
+
+    dsp_scratch &_scratch;
+};
+
+} // namespace ei
+
+#endif // _EIDSP_SCRATCH_H_
@@ -248,7 +248,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frames != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -257,7 +257,7 @@ public:
         }
 
         if (out_energies) {
-            if (stack_frame_info.frame_ixs.size() != out_energies->rows || out_energies->cols != 1) {
+            if (stack_frame_info.frames != out_energies->rows || out_energies->cols != 1) {
                 EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
             }
         }
@@ -271,12 +271,9 @@ public:
         // converting the upper and lower frequencies to Mels.
         // num_filter + 2 is because for num_filter filterbanks we need
         // num_filter+2 point.
-        float *mels;
         const int MELS_SIZE = num_filters + 2;
-        const size_t mem_size = MELS_SIZE * sizeof(float);
-        mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
-        EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
-        ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
+        EI_DSP_MATRIX(mels_matrix, 1, MELS_SIZE);
+        float *mels = mels_matrix.buffer;
         uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
 
         numpy::linspace(
@@ -314,29 +311,22 @@ public:
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
 
-        // get signal data from the audio file
-        EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
-
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
-            // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
-            size_t signal_length = stack_frame_info.frame_length;
-            if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
-                signal_length = signal_length -
-                    (stack_frame_info.signal->total_length - (signal_offset + signal_length));
-            }
+        // frames are read in order, several at a time
+        processing::frame_reader frames(&stack_frame_info);
+        ret = frames.status();
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
 
-            ret = stack_frame_info.signal->get_data(
-                signal_offset,
-                signal_length,
-                signal_frame.buffer
-            );
+        for (size_t ix = 0; ix < stack_frame_info.frames; ix++) {
+            const float *signal_frame;
+            ret = frames.next(&signal_frame);
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
 
             ret = numpy::power_spectrum(
-                signal_frame.buffer,
+                signal_frame,
                 stack_frame_info.frame_length,
                 power_spectrum_frame.buffer,
                 power_spectrum_frame_size,
@@ -448,7 +438,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frames != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -457,7 +447,7 @@ public:
         }
 
         if (out_energies) {
-            if (stack_frame_info.frame_ixs.size() != out_energies->rows || out_energies->cols != 1) {
+            if (stack_frame_info.frames != out_energies->rows || out_energies->cols != 1) {
                 EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
             }
         }
@@ -484,36 +474,29 @@ public:
         if (ret != 0) {
             EIDSP_ERR(ret);
         }
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
-            size_t power_spectrum_frame_size = (fft_length / 2 + 1);
-
-            EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
-            if (!power_spectrum_frame.buffer) {
-                EIDSP_ERR(EIDSP_OUT_OF_MEM);
-            }
+        size_t power_spectrum_frame_size = (fft_length / 2 + 1);
 
-            // get signal data from the audio file
-            EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
+        EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
+        if (!power_spectrum_frame.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
 
-            // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
-            size_t signal_length = stack_frame_info.frame_length;
-            if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
-                signal_length = signal_length -
-                    (stack_frame_info.signal->total_length - (signal_offset + signal_length));
-            }
+        // frames are read in order, several at a time
+        processing::frame_reader frames(&stack_frame_info);
+        ret = frames.status();
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
 
-            ret = stack_frame_info.signal->get_data(
-                signal_offset,
-                signal_length,
-                signal_frame.buffer
-            );
+        for (size_t ix = 0; ix < stack_frame_info.frames; ix++) {
+            const float *signal_frame;
+            ret = frames.next(&signal_frame);
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
 
             ret = numpy::power_spectrum(
-                signal_frame.buffer,
+                signal_frame,
                 stack_frame_info.frame_length,
                 power_spectrum_frame.buffer,
                 power_spectrum_frame_size,
@@ -588,7 +571,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frames != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -602,23 +585,22 @@ public:
             *(out_features->buffer + i) = 0;
         }
 
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
-            // get signal data from the audio file
-            EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
+        // frames are scaled in a copy, the reader's buffer holds the overlap
+        EI_DSP_MATRIX(scaled_frame, 1, version == 3 ? stack_frame_info.frame_length : 1);
+        if (!scaled_frame.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
 
-            // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
-            size_t signal_length = stack_frame_info.frame_length;
-            if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
-                signal_length = signal_length -
-                    (stack_frame_info.signal->total_length - (signal_offset + signal_length));
-            }
+        // frames are read in order, several at a time
+        processing::frame_reader frames(&stack_frame_info);
+        ret = frames.status();
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
 
-            ret = stack_frame_info.signal->get_data(
-                signal_offset,
-                signal_length,
-                signal_frame.buffer
-            );
+        for (size_t ix = 0; ix < stack_frame_info.frames; ix++) {
+            const float *signal_frame;
+            ret = frames.next(&signal_frame);
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
@@ -627,23 +609,25 @@ public:
             if (version == 3) {
                 // it might be that everything is already normalized here...
                 bool all_between_min_1_and_1 = true;
-                for (size_t ix = 0; ix < signal_frame.rows * signal_frame.cols; ix++) {
-                    if (signal_frame.buffer[ix] < -1.0f || signal_frame.buffer[ix] > 1.0f) {
+                for (size_t ix = 0; ix < scaled_frame.cols; ix++) {
+                    if (signal_frame[ix] < -1.0f || signal_frame[ix] > 1.0f) {
                         all_between_min_1_and_1 = false;
                         break;
                     }
                 }
 
                 if (!all_between_min_1_and_1) {
-                    ret = numpy::scale(&signal_frame, 1.0f / 32768.0f);
+                    memcpy(scaled_frame.buffer, signal_frame, scaled_frame.cols * sizeof(float));
+                    ret = numpy::scale(&scaled_frame, 1.0f / 32768.0f);
                     if (ret != 0) {
                         EIDSP_ERR(ret);
                     }
+                    signal_frame = scaled_frame.buffer;
                 }
             }
 
             ret = numpy::power_spectrum(
-                signal_frame.buffer,
+                signal_frame,
                 stack_frame_info.frame_length,
                 out_features->buffer + (ix * coefficients),
                 coefficients,
@@ -718,7 +702,7 @@ public:
         uint32_t low_frequency, uint32_t high_frequency, bool dc_elimination,
         uint16_t version)
     {
-        if (out_features->cols != num_cepstral) {
+        if (out_features->cols != num_cepstral || num_cepstral > num_filters) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -762,23 +746,18 @@ public:
             EIDSP_ERR(ret);
         }
 
-        // now do DST type 2
-        ret = numpy::dct2(&features_matrix, DCT_NORMALIZATION_ORTHO);
-        if (ret != EIDSP_OK) {
-            EIDSP_ERR(ret);
+        // now do DCT type 2, only the coefficients we keep, straight into the output
+        const float *dct_matrix = numpy::dct2_ortho_basis(num_filters, num_cepstral);
+        if (!dct_matrix) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
+        numpy::dct2_truncated(features_matrix.buffer, features_matrix.rows, features_matrix.cols,
+            dct_matrix, num_cepstral, out_features->buffer);
 
         // replace first cepstral coefficient with log of frame energy for DC elimination
         if (dc_elimination) {
             for (size_t row = 0; row < features_matrix.rows; row++) {
-                features_matrix.buffer[row * features_matrix.cols] = numpy::log(energy_matrix.buffer[row]);
-            }
-        }
-
-        // copy to the output...
-        for (size_t row = 0; row < features_matrix.rows; row++) {
-            for(int i = 0; i < num_cepstral; i++) {
-                *(out_features->buffer + (num_cepstral * row) + i) = *(features_matrix.buffer + (features_matrix.cols * row) + i);
+                out_features->buffer[row * num_cepstral] = numpy::log(energy_matrix.buffer[row]);
             }
         }
 
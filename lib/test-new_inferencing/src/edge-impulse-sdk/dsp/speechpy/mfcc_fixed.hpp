@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef _EIDSP_SPEECHPY_MFCC_FIXED_H_
+#define _EIDSP_SPEECHPY_MFCC_FIXED_H_
+
+/**
+ * MFCC for one DSP config known at compile time, producing the same features
+ * as feature::mfcc() (with DC elimination, as used by the MFCC block).
+ *
+ * The frame geometry, the mel filterbank (bin edges and triangle weights) and
+ * the orthonormal DCT-II matrix are constexpr tables derived from the template
+ * arguments, so a call does no size bookkeeping, builds no frame index vector
+ * and needs two scratch allocations instead of several per frame. Frames come
+ * from a processing::frame_reader, so every sample is read (and pre-emphasized)
+ * once. Frames are not windowed, same as feature::mfcc().
+ *
+ * Frame length and stride are template arguments in samples (float template
+ * arguments need C++20); matches() checks a runtime config against them the
+ * way processing::stack_frames() would round it.
+ *
+ * Everything here is C++11 constexpr (single-expression recursion), as the
+ * SDK is still built with -std=gnu++11 on some targets.
+ */
+
+#include <stdint.h>
+#include <math.h>
+#include "../numpy.hpp"
+#include "../returntypes.hpp"
+#include "processing.hpp"
+
+namespace ei {
+namespace speechpy {
+
+namespace mfcc_fixed_detail {
+
+    // Enough precision in double for the filterbank edges and DCT weights, which
+    // are only rounded to float (or to an FFT bin) at the very end
+
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double ln2 = 0.69314718055994530942;
+
+    constexpr double sq(double x) {
+        return x * x;
+    }
+
+    // ln(m) = 2 atanh(z), z = (m - 1) / (m + 1), |z| <= 1/3 for m in [1, 2)
+    constexpr double atanh_series(double z2, double term, int n) {
+        return n > 40 ? 0.0 : term / (2 * n + 1) + atanh_series(z2, term * z2, n + 1);
+    }
+
+    constexpr double log_mantissa(double m) {
+        return 2.0 * atanh_series(sq((m - 1.0) / (m + 1.0)), (m - 1.0) / (m + 1.0), 0);
+    }
+
+    constexpr double log(double x, int exponent = 0) {
+        return x >= 2.0 ? log(x / 2.0, exponent + 1) :
+               x < 1.0 ? log(x * 2.0, exponent - 1) :
+               exponent * ln2 + log_mantissa(x);
+    }
+
+    constexpr double exp_series(double x, double term, int n) {
+        return n > 30 ? 0.0 : term + exp_series(x, term * x / (n + 1), n + 1);
+    }
+
+    constexpr double exp(double x) {
+        return x > 1.0 ? sq(exp(x / 2.0)) :
+               x < -1.0 ? 1.0 / exp(-x) :
+               exp_series(x, 1.0, 0);
+    }
+
+    constexpr double cos_series(double x2, double term, int n) {
+        return n > 20 ? 0.0 : term + cos_series(x2, -term * x2 / ((2 * n + 1) * (2 * n + 2)), n + 1);
+    }
+
+    // x in [0, 2 pi)
+    constexpr double cos(double x) {
+        return x > pi ? cos(2.0 * pi - x) :
+               x > pi / 2.0 ? -cos(pi - x) :
+               cos_series(x * x, 1.0, 0);
+    }
+
+    constexpr double sqrt_newton(double x, double guess, int n) {
+        return n == 0 ? guess : sqrt_newton(x, 0.5 * (guess + x / guess), n - 1);
+    }
+
+    constexpr double sqrt(double x) {
+        return sqrt_newton(x, x > 1.0 ? x : 1.0, 60);
+    }
+
+    // Same conversions as functions::frequency_to_mel / mel_to_frequency
+    constexpr double frequency_to_mel(double f) {
+        return 1127.0 * log(1.0 + f / 700.0);
+    }
+
+    constexpr double mel_to_frequency(double mel) {
+        return 700.0 * (exp(mel / 1127.0) - 1.0);
+    }
+
+    constexpr double clamp(double v, double lo, double hi) {
+        return v < lo ? lo : v > hi ? hi : v;
+    }
+
+    // Table initializers: values[] = { Generator::at(0), ..., Generator::at(N - 1) }
+
+    template<size_t... I> struct index_list { };
+
+    template<typename A, typename B> struct index_concat;
+    template<size_t... A, size_t... B> struct index_concat<index_list<A...>, index_list<B...>> {
+        typedef index_list<A..., (sizeof...(A) + B)...> type;
+    };
+
+    template<size_t N> struct make_index_list {
+        typedef typename index_concat<typename make_index_list<N / 2>::type,
+                                      typename make_index_list<N - N / 2>::type>::type type;
+    };
+    template<> struct make_index_list<0> { typedef index_list<> type; };
+    template<> struct make_index_list<1> { typedef index_list<0> type; };
+
+    template<typename Generator, typename T, typename Indices> struct table;
+    template<typename Generator, typename T, size_t... I> struct table<Generator, T, index_list<I...>> {
+        static constexpr T values[sizeof...(I)] = { Generator::at(I)... };
+    };
+    template<typename Generator, typename T, size_t... I>
+    constexpr T table<Generator, T, index_list<I...>>::values[sizeof...(I)];
+
+} // namespace mfcc_fixed_detail
+
+/**
+ * @tparam SamplingFrequency In Hz
+ * @tparam FrameLength Frame length in samples
+ * @tparam FrameStride Frame stride in samples
+ * @tparam NumCepstral Number of cepstral coefficients
+ * @tparam NumFilters Number of filters in the mel filterbank
+ * @tparam FftLength Number of FFT points
+ * @tparam LowFrequency Lowest band edge of the mel filters, in Hz (non-zero)
+ * @tparam HighFrequency Highest band edge of the mel filters, in Hz (non-zero)
+ * @tparam Version Implementation version of the MFCC block
+ */
+template<uint32_t SamplingFrequency, uint16_t FrameLength, uint16_t FrameStride,
+         uint16_t NumCepstral, uint16_t NumFilters, uint16_t FftLength,
+         uint32_t LowFrequency, uint32_t HighFrequency, uint16_t Version>
+class mfcc_fixed {
+public:
+    static constexpr size_t coefficients = FftLength / 2 + 1;
+
+    static_assert(FrameStride > 0 && FrameStride <= FrameLength, "Invalid frame stride");
+    static_assert(FrameLength <= FftLength, "Frames longer than the FFT are not supported");
+    static_assert((FftLength & (FftLength - 1)) == 0, "FFT length must be a power of two");
+    static_assert(NumCepstral > 0 && NumCepstral <= NumFilters, "Invalid number of cepstral coefficients");
+    static_assert(LowFrequency > 0 && LowFrequency < HighFrequency && HighFrequency <= SamplingFrequency / 2,
+        "Invalid filterbank frequencies");
+
+    /**
+     * Number of frames feature::mfcc() takes from a signal of this length.
+     * Frame stacking version 1 only counts complete frames, later versions
+     * count frames that start before the last stride.
+     */
+    static constexpr int32_t frame_count(size_t signal_length, uint16_t version) {
+        return signal_length < frame_span(version) ?
+            0 : static_cast<int32_t>((signal_length - frame_span(version)) / FrameStride);
+    }
+
+    /**
+     * Whether a runtime MFCC config is the one this engine was built for
+     * (after the same defaulting and rounding feature::mfcc() applies)
+     */
+    static bool matches(uint32_t sampling_frequency, float frame_length, float frame_stride,
+        uint16_t num_cepstral, uint16_t num_filters, uint16_t fft_length,
+        uint32_t low_frequency, uint32_t high_frequency, uint16_t version)
+    {
+        if (high_frequency == 0) {
+            high_frequency = sampling_frequency / 2;
+        }
+        if (version < 4 && low_frequency == 0) {
+            low_frequency = 300;
+        }
+
+        float frame_length_values, frame_stride_values;
+        if (version == 1) {
+            frame_length_values = round(static_cast<float>(sampling_frequency) * frame_length);
+            frame_stride_values = round(static_cast<float>(sampling_frequency) * frame_stride);
+        }
+        else {
+            frame_length_values = processing::ceil_unless_very_close_to_floor(static_cast<float>(sampling_frequency) * frame_length);
+            frame_stride_values = processing::ceil_unless_very_close_to_floor(static_cast<float>(sampling_frequency) * frame_stride);
+        }
+
+        // the filterbank edges only depend on version < 4 vs. >= 4
+        return sampling_frequency == SamplingFrequency &&
+            static_cast<int>(frame_length_values) == FrameLength &&
+            static_cast<int>(frame_stride_values) == FrameStride &&
+            num_cepstral == NumCepstral &&
+            num_filters == NumFilters &&
+            fft_length == FftLength &&
+            low_frequency == LowFrequency &&
+            high_frequency == HighFrequency &&
+            (version >= 4) == (Version >= 4);
+    }
+
+    /**
+     * Compute MFCC features, see feature::mfcc()
+     * @param out_features Matrix of frame_count() x NumCepstral
+     * @param signal Audio signal (already pre-emphasized)
+     * @param version Frame stacking version (see frame_count())
+     * @returns EIDSP_OK if OK
+     */
+    static int mfcc(matrix_t *out_features, signal_t *signal, uint16_t version)
+    {
+        static_assert(edge_bin(NumFilters + 1) < coefficients, "Filterbank exceeds the power spectrum");
+
+        const int32_t frames = frame_count(signal->total_length, version);
+        if (frames <= 0) {
+            EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
+        }
+        if (out_features->rows != static_cast<uint32_t>(frames) || out_features->cols != NumCepstral) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        // FFT input, FFT output (complex), power spectrum, then log energy and
+        // log mel energies of all frames
+        EI_DSP_MATRIX(scratch, 1, FftLength + coefficients * 2 + coefficients + frames * (1 + NumFilters));
+        float *frame = scratch.buffer;
+        fft_complex_t *spectrum = reinterpret_cast<fft_complex_t*>(frame + FftLength);
+        float *power = frame + FftLength + coefficients * 2;
+        float *log_energy = power + coefficients;
+        float *log_mel = log_energy + frames;
+
+        const uint16_t *bins = bin_table::values;
+        const float *rise = rise_table::values;
+        const float *fall = fall_table::values;
+
+        processing::frame_reader reader(signal, FrameLength, FrameStride, frames);
+        if (reader.status() != EIDSP_OK) {
+            EIDSP_ERR(reader.status());
+        }
+
+        // only set up if there's no hardware FFT
+        kiss_fftr_cfg kiss_cfg = NULL;
+
+        for (int32_t ix = 0; ix < frames; ix++) {
+            const float *samples;
+            int ret = reader.next(&samples);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+            // FFT input, padded again every frame as hardware FFTs may work in place
+            memcpy(frame, samples, FrameLength * sizeof(float));
+            memset(frame + FrameLength, 0, (FftLength - FrameLength) * sizeof(float));
+
+            if (!kiss_cfg && ei::fft::hw_r2c_fft(frame, spectrum, FftLength) != EIDSP_OK) {
+                kiss_cfg = numpy::kiss_fftr_config(FftLength);
+                if (!kiss_cfg) {
+                    EIDSP_ERR(EIDSP_OUT_OF_MEM);
+                }
+            }
+            if (kiss_cfg) {
+                kiss_fftr(kiss_cfg, frame, reinterpret_cast<kiss_fft_cpx*>(spectrum));
+            }
+
+            // magnitude, then power, in the same steps as numpy::power_spectrum()
+            float energy = 0.0f;
+#if EIDSP_FAST_MATH == 1
+            fast_math::power(spectrum, power, coefficients, 1.0f / static_cast<float>(FftLength));
+            for (size_t bin = 0; bin < coefficients; bin++) {
+                energy += power[bin];
+            }
+#else
+            for (size_t bin = 0; bin < coefficients; bin++) {
+                float magnitude = sqrt(spectrum[bin].r * spectrum[bin].r + spectrum[bin].i * spectrum[bin].i);
+                power[bin] = (1.0f / static_cast<float>(FftLength)) * (magnitude * magnitude);
+                energy += power[bin];
+            }
+#endif // EIDSP_FAST_MATH
+            if (energy == 0) {
+                energy = 1e-10;
+            }
+            log_energy[ix] = numpy::log(energy);
+
+            float *mel = log_mel + ix * NumFilters;
+            for (size_t i = 0; i < NumFilters; i++) {
+                const size_t left = bins[i];
+                const size_t middle = bins[i + 1];
+                const size_t right = bins[i + 2];
+
+                float sum = power[middle];
+                for (size_t bin = left + 1; bin < middle; bin++) {
+                    sum += rise[bin] * power[bin];
+                }
+                for (size_t bin = middle + 1; bin < right; bin++) {
+                    sum += fall[bin] * power[bin];
+                }
+#if EIDSP_FAST_MATH == 1
+                mel[i] = sum == 0 ? 1e-10f : sum;
+            }
+            fast_math::log(mel, NumFilters);
+#else
+                mel[i] = numpy::log(sum == 0 ? 1e-10f : sum);
+            }
+#endif // EIDSP_FAST_MATH
+        }
+
+        // DCT-II (orthonormal) of all frames as one matrix product, then replace
+        // the first coefficient with the log frame energy (DC elimination)
+        numpy::dct2_truncated(log_mel, frames, NumFilters, dct_table::values, NumCepstral, out_features->buffer);
+        for (int32_t ix = 0; ix < frames; ix++) {
+            out_features->buffer[ix * NumCepstral] = log_energy[ix];
+        }
+
+        return EIDSP_OK;
+    }
+
+private:
+    typedef typename mfcc_fixed_detail::make_index_list<NumFilters + 2>::type bin_indices;
+    typedef typename mfcc_fixed_detail::make_index_list<coefficients>::type coefficient_indices;
+    typedef typename mfcc_fixed_detail::make_index_list<NumFilters * NumCepstral>::type dct_indices;
+
+    static constexpr size_t frame_span(uint16_t version) {
+        return version == 1 ? FrameLength : FrameLength - FrameStride;
+    }
+
+    // highest FFT bin the filterbank is spread over (feature::mfe() keeps an
+    // off-by-half-the-spectrum bug for versions < 4)
+    static constexpr uint16_t max_bin = Version >= 4 ? FftLength : coefficients;
+
+    static constexpr double mel_low = mfcc_fixed_detail::frequency_to_mel(LowFrequency);
+    static constexpr double mel_high = mfcc_fixed_detail::frequency_to_mel(HighFrequency);
+
+    // NumFilters + 2 points evenly spaced on the mel scale, back in Hz; the
+    // last one is nudged down like in feature::mfe()
+    static constexpr double edge_frequency(size_t ix) {
+        return ix == NumFilters + 1u ?
+            mfcc_fixed_detail::clamp(mfcc_fixed_detail::mel_to_frequency(mel_high), 0.0, HighFrequency) - 0.001 :
+            mfcc_fixed_detail::clamp(
+                mfcc_fixed_detail::mel_to_frequency(mel_low + ix * (mel_high - mel_low) / (NumFilters + 1)),
+                LowFrequency, HighFrequency);
+    }
+
+    static constexpr uint16_t edge_bin(size_t ix) {
+        return static_cast<uint16_t>((max_bin + 1) * edge_frequency(ix) / SamplingFrequency);
+    }
+
+    // segment s runs from edge s to edge s + 1: the rising half of filter s and
+    // the falling half of filter s - 1
+    static constexpr size_t segment_of(size_t bin, size_t s = 0) {
+        return s >= NumFilters + 1u || edge_bin(s + 1) > bin ? s : segment_of(bin, s + 1);
+    }
+
+    static constexpr bool inside_segment(size_t bin, size_t s) {
+        return s < NumFilters + 1u && edge_bin(s) < bin && bin < edge_bin(s + 1);
+    }
+
+    // Weights in float, computed exactly like feature::mfe() does per frame
+    static constexpr float rise_weight(size_t bin, size_t s) {
+        return inside_segment(bin, s) ?
+            (static_cast<float>(bin) - static_cast<float>(edge_bin(s))) / static_cast<float>(edge_bin(s + 1) - edge_bin(s)) : 0.0f;
+    }
+
+    static constexpr float fall_weight(size_t bin, size_t s) {
+        return inside_segment(bin, s) ?
+            (static_cast<float>(edge_bin(s + 1)) - static_cast<float>(bin)) / static_cast<float>(edge_bin(s + 1) - edge_bin(s)) : 0.0f;
+    }
+
+    static constexpr float dct_weight(size_t k, size_t n) {
+        return static_cast<float>(
+            (k == 0 ? mfcc_fixed_detail::sqrt(1.0 / NumFilters) : mfcc_fixed_detail::sqrt(2.0 / NumFilters)) *
+            // angle reduced to [0, 2 pi) with integer math first
+            mfcc_fixed_detail::cos(mfcc_fixed_detail::pi * ((k * (2 * n + 1)) % (4 * NumFilters)) / (2.0 * NumFilters)));
+    }
+
+    struct bin_generator {
+        static constexpr uint16_t at(size_t ix) { return edge_bin(ix); }
+    };
+    struct rise_generator {
+        static constexpr float at(size_t bin) { return rise_weight(bin, segment_of(bin)); }
+    };
+    struct fall_generator {
+        static constexpr float at(size_t bin) { return fall_weight(bin, segment_of(bin)); }
+    };
+    // NumFilters x NumCepstral, the layout numpy::dct2_truncated() takes
+    struct dct_generator {
+        static constexpr float at(size_t ix) { return dct_weight(ix % NumCepstral, ix / NumCepstral); }
+    };
+
+    typedef mfcc_fixed_detail::table<bin_generator, uint16_t, bin_indices> bin_table;
+    typedef mfcc_fixed_detail::table<rise_generator, float, coefficient_indices> rise_table;
+    typedef mfcc_fixed_detail::table<fall_generator, float, coefficient_indices> fall_table;
+    typedef mfcc_fixed_detail::table<dct_generator, float, dct_indices> dct_table;
+};
+
+} // namespace speechpy
+} // namespace ei
+
+#endif // _EIDSP_SPEECHPY_MFCC_FIXED_H_
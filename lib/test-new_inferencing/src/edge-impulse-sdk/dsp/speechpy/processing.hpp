@@ -36,10 +36,12 @@
 namespace ei {
 namespace speechpy {
 
-// one stack frame returned by stack_frames
+// how stack_frames frames a signal: frames of frame_length samples,
+// frame_stride apart from offset 0, read with a processing::frame_reader
 typedef struct ei_stack_frames_info {
     signal_t *signal;
-    ei_vector<uint32_t> frame_ixs;
+    size_t frames;
+    size_t frame_stride;
     int frame_length;
 } stack_frames_info_t;
 
@@ -53,10 +55,15 @@ namespace processing {
     class preemphasis {
 public:
         preemphasis(ei_signal_t *signal, int shift, float cof, bool rescale)
-            : _signal(signal), _shift(shift), _cof(cof), _rescale(rescale)
+            : _signal(signal), _shift(shift), _cof(cof), _rescale(rescale),
+              _history(2, shift > 0 ? shift : 0)
         {
-            _prev_buffer = (float*)ei_dsp_calloc(shift * sizeof(float), 1);
-            _end_of_signal_buffer = (float*)ei_dsp_calloc(shift * sizeof(float), 1);
+            _prev_buffer = nullptr;
+            _end_of_signal_buffer = nullptr;
+            if (shift > 0 && _history.buffer) {
+                _prev_buffer = _history.get_row_ptr(0);
+                _end_of_signal_buffer = _history.get_row_ptr(1);
+            }
             _next_offset_should_be = 0;
 
             if (shift < 0) {
@@ -84,7 +91,8 @@ public:
             }
 
             int ret;
-            if (static_cast<int32_t>(offset) - _shift >= 0) {
+            // reading on from the previous call, the history is already there
+            if (offset != _next_offset_should_be && static_cast<int32_t>(offset) - _shift >= 0) {
                 ret = _signal->get_data(offset - _shift, _shift, _prev_buffer);
                 if (ret != 0) {
                     EIDSP_ERR(ret);
@@ -117,7 +125,7 @@ public:
                 _prev_buffer[_shift - 1] = now;
             }
 
-            _next_offset_should_be += length;
+            _next_offset_should_be = offset + length;
 
             // rescale from [-1 .. 1] ?
             if (_rescale) {
@@ -131,15 +139,6 @@ public:
             return EIDSP_OK;
         }
 
-        ~preemphasis() {
-            if (_prev_buffer) {
-                ei_dsp_free(_prev_buffer, _shift * sizeof(float));
-            }
-            if (_end_of_signal_buffer) {
-                ei_dsp_free(_end_of_signal_buffer, _shift * sizeof(float));
-            }
-        }
-
 private:
         ei_signal_t *_signal;
         int _shift;
@@ -148,6 +147,8 @@ private:
         float *_end_of_signal_buffer;
         size_t _next_offset_should_be;
         bool _rescale;
+        // both buffers, as a matrix so inside a dsp_scratch_scope they come from the arena
+        matrix_t _history;
     };
 }
 
@@ -260,7 +261,8 @@ namespace processing {
     }
 
     /**
-     * Frame a signal into overlapping frames.
+     * Frame a signal into overlapping frames. Only the layout is computed, the
+     * frames themselves are read with a frame_reader.
      * @param info This is both the base object and where we'll store our results.
      * @param sampling_frequency (int): The sampling frequency of the signal.
      * @param frame_length (float): The length of the frame in second.
@@ -318,17 +320,8 @@ namespace processing {
             info->signal->total_length = static_cast<size_t>(len_sig);
         }
 
-        info->frame_ixs.clear();
-        info->frame_ixs.reserve(numframes); //limit the memory allocation
-
-        int frame_count = 0;
-
-        for (size_t ix = 0; ix < static_cast<uint32_t>(len_sig); ix += static_cast<size_t>(frame_stride)) {
-            if (++frame_count > numframes) break;
-
-            info->frame_ixs.push_back(ix);
-        }
-
+        info->frames = numframes > 0 ? static_cast<size_t>(numframes) : 0;
+        info->frame_stride = static_cast<size_t>(frame_stride);
         info->frame_length = frame_sample_length;
 
         return EIDSP_OK;
@@ -384,6 +377,106 @@ namespace processing {
         return numframes;
     }
 
+    /**
+     * Hands out overlapping frames of a signal in order, for feature
+     * extractors that process one frame at a time. Instead of a get_data()
+     * call per frame (which converts and pre-emphasizes the overlap again for
+     * every frame), samples are read once, several frames at a time, into a
+     * buffer that frames point into. Only the overlap is moved before the next
+     * read.
+     */
+    class frame_reader {
+public:
+        /**
+         * @param signal Signal to read from, from offset 0 on
+         * @param frame_length Frame length in samples
+         * @param frame_stride Frame stride in samples
+         * @param frames Number of frames that will be read; with 0, next() fails
+         * @param frames_per_read Frames to buffer per get_data() call
+         */
+        frame_reader(signal_t *signal, size_t frame_length, size_t frame_stride, size_t frames,
+            size_t frames_per_read = 8)
+            : _signal(signal),
+              _frame_length(frame_length),
+              _frame_stride(frame_stride),
+              _end(frames > 0 ? (frames - 1) * frame_stride + frame_length : 0),
+              _buffer(1, frame_length + (frames_per_read - 1) * frame_stride)
+        {
+        }
+
+        /**
+         * @param info Frames as laid out by stack_frames()
+         * @param frames_per_read Frames to buffer per get_data() call
+         */
+        explicit frame_reader(const stack_frames_info_t *info, size_t frames_per_read = 8)
+            : frame_reader(info->signal, info->frame_length, info->frame_stride, info->frames, frames_per_read)
+        {
+        }
+
+        /**
+         * @returns EIDSP_OK if the buffer was allocated
+         */
+        int status() const {
+            return _buffer.buffer ? EIDSP_OK : EIDSP_OUT_OF_MEM;
+        }
+
+        /**
+         * Next frame, valid until the next call
+         * @param frame Set to frame_length samples
+         * @returns EIDSP_OK if OK
+         */
+        int next(const float **frame) {
+            if (_first) {
+                _first = false;
+            }
+            else {
+                _start += _frame_stride;
+            }
+
+            if (_start + _frame_length > _filled) {
+                size_t keep = 0;
+                if (_start < _filled) {
+                    keep = _filled - _start;
+                    memmove(_buffer.buffer, _buffer.buffer + _start, keep * sizeof(float));
+                }
+                else {
+                    // frames further apart than they are long: skip the gap
+                    _offset += _start - _filled;
+                }
+                _start = 0;
+                _filled = keep;
+
+                size_t length = _buffer.cols - _filled;
+                if (length > _end - _offset) {
+                    length = _end - _offset;
+                }
+                if (_filled + length < _frame_length) {
+                    EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+                }
+                int ret = _signal->get_data(_offset, length, _buffer.buffer + _filled);
+                if (ret != 0) {
+                    EIDSP_ERR(ret);
+                }
+                _offset += length;
+                _filled += length;
+            }
+
+            *frame = _buffer.buffer + _start;
+            return EIDSP_OK;
+        }
+
+private:
+        signal_t *_signal;
+        size_t _frame_length;
+        size_t _frame_stride;
+        size_t _end;            // last sample any frame needs, + 1
+        size_t _offset = 0;     // next sample to read from the signal
+        size_t _start = 0;      // current frame in _buffer
+        size_t _filled = 0;     // samples in _buffer
+        bool _first = true;
+        matrix_t _buffer;
+    };
+
     /**
      * This function performs local cepstral mean and
      * variance normalization on a sliding window. The code assumes that
@@ -500,7 +593,11 @@ namespace processing {
             if (f < 1e-30) {
                 f = 1e-30;
             }
+#if EIDSP_FAST_MATH == 1
+            f = fast_math::log10(f);
+#else
             f = numpy::log10(f);
+#endif // EIDSP_FAST_MATH
             f *= 10.0f; // scale by 10
             f += noise;
             f *= noise_scale;
@@ -538,7 +635,11 @@ namespace processing {
             if (f < 1e-30) {
                 f = 1e-30;
             }
+#if EIDSP_FAST_MATH == 1
+            f = fast_math::log10(f);
+#else
             f = numpy::log10(f);
+#endif // EIDSP_FAST_MATH
             f *= 10.0f; // scale by 10
             f += noise;
             f *= noise_scale;
@@ -35,5 +35,6 @@
 #include "feature.hpp"
 #include "functions.hpp"
 #include "processing.hpp"
+#include "mfcc_fixed.hpp"
 
 #endif // _EIDSP_SPEECHPY_SPEECHPY_H_
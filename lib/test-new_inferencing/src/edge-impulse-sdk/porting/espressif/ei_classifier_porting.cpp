@@ -38,6 +38,7 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <cstring>
 // Include FreeRTOS for delay
 #include <freertos/FreeRTOS.h>
@@ -95,24 +96,62 @@ __attribute__((weak)) void ei_printf_float(float f) {
     ei_printf("%f", f);
 }
 
+// Memory placement policy:
+// DSP scratch matrices and the tensor arena are small and hot, so they go to
+// internal SRAM; anything above EI_ESPRESSIF_INTERNAL_ALLOC_MAX goes to PSRAM
+// (when present) so it doesn't starve WiFi/I2S of internal memory. Each
+// request falls back to the other region before failing.
+// heap_caps_aligned_alloc() memory can be released with free() from IDF 4.4 on
+// (Arduino-ESP32 2.x), which is what ei_free() does.
+#ifndef EI_ESPRESSIF_INTERNAL_ALLOC_MAX
+#define EI_ESPRESSIF_INTERNAL_ALLOC_MAX   (32 * 1024)
+#endif
+
+#define EI_CAPS_INTERNAL    (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define EI_CAPS_SPIRAM      (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
+#define EI_ESPRESSIF_PLACED_ALLOC   1
+#else
+#define EI_ESPRESSIF_PLACED_ALLOC   0
+#endif
+
+#if EI_ESPRESSIF_PLACED_ALLOC
+static void *ei_placed_aligned_alloc(size_t size) {
+    uint32_t primary = (size <= EI_ESPRESSIF_INTERNAL_ALLOC_MAX) ? EI_CAPS_INTERNAL : EI_CAPS_SPIRAM;
+    uint32_t secondary = (primary == EI_CAPS_INTERNAL) ? EI_CAPS_SPIRAM : EI_CAPS_INTERNAL;
+
+    void *ptr = heap_caps_aligned_alloc(16, size, primary);
+    if (ptr == nullptr) {
+        ptr = heap_caps_aligned_alloc(16, size, secondary);
+    }
+    return ptr;
+}
+#endif
+
 // we use alligned alloc instead of regular malloc
 // due to https://github.com/espressif/esp-nn/issues/7
 __attribute__((weak)) void *ei_malloc(size_t size) {
-#if defined(CONFIG_IDF_TARGET_ESP32S3)
-#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
-    return heap_caps_aligned_alloc(16, size, MALLOC_CAP_DEFAULT);
-#else
+#if EI_ESPRESSIF_PLACED_ALLOC
+    return ei_placed_aligned_alloc(size);
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
     return aligned_alloc(16, size);
-#endif
-#endif
+#else
     return malloc(size);
+#endif
 }
 
 __attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
-#if defined(CONFIG_IDF_TARGET_ESP32S3)
-#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
-    return heap_caps_calloc(nitems, size, MALLOC_CAP_DEFAULT);
-#else
+    if (size != 0 && nitems > SIZE_MAX / size) {
+        return nullptr;
+    }
+#if EI_ESPRESSIF_PLACED_ALLOC
+    void *p = ei_placed_aligned_alloc(nitems * size);
+    if (p != nullptr) {
+        memset(p, '\0', nitems * size);
+    }
+    return p;
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
     void *p;
     p = aligned_alloc(16, nitems * size);
     if (p == nullptr)
@@ -120,9 +159,9 @@ __attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
 
     memset(p, '\0', nitems * size);
     return p;
-#endif
-#endif
+#else
     return calloc(nitems, size);
+#endif
 }
 
 __attribute__((weak)) void ei_free(void *ptr) {
@@ -0,0 +1,595 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_INT8_GEMM_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_INT8_GEMM_H_
+
+// int8 x int8 -> int32 GEMM for CONV_2D and FULLY_CONNECTED, for targets
+// without vendor kernels. The reference branches of micro/kernels/conv.cpp and
+// fully_connected.cpp use it when EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM is set.
+//
+// - The filter is packed once, at prepare: output channels in blocks of 4,
+//   interleaved in 16 byte chunks of depth, depth zero padded to a multiple
+//   of 16. EON compiled models can ship it packed (PrepackedFilter), then it
+//   is used in place from flash.
+// - The input zero point is folded into a per channel constant,
+//   bias[oc] + input_offset * sum(filter[oc]), so the inner loop is a plain
+//   int8 dot product.
+// - Convolutions are lowered with im2col, kRowBlock output pixels at a time.
+//   Taps in the spatial padding hold the input zero point, the folded
+//   constant cancels them just like the reference kernel skipping them.
+// - Accumulators are requantized like the reference kernels do, so outputs
+//   are bit-exact.
+// - RowsTimesFilter() can max pool rows as it requantizes them, for the fused
+//   CONV_2D + MAX_POOL_2D kernel (micro/kernels/conv_max_pool.cpp).
+//
+// x86 hosts pick an SSE4.1 or AVX2 microkernel at run time, other targets run
+// the portable one.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/types.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EI_INT8_GEMM_X86 1
+#include <immintrin.h>
+#else
+#define EI_INT8_GEMM_X86 0
+#endif
+
+namespace tflite {
+namespace optimized_integer_ops {
+namespace int8_gemm {
+
+constexpr int kDepthAlign = 16;
+constexpr int kChannelBlock = 4;
+// Rows (output pixels, or batches) per im2col pass
+constexpr int kRowBlock = 16;
+
+inline int PaddedDepth(int depth) {
+  return (depth + kDepthAlign - 1) / kDepthAlign * kDepthAlign;
+}
+
+inline int PaddedChannels(int channels) {
+  return (channels + kChannelBlock - 1) / kChannelBlock * kChannelBlock;
+}
+
+struct PackedFilter {
+  // bias[oc] + input_offset * sum(filter[oc])
+  const int32_t* corrections;
+  const int8_t* weights;
+  int channels;
+  int depth;
+  int padded_depth;
+};
+
+// Bytes PackFilter() needs, the corrections followed by the weights
+inline size_t PackedFilterSize(int channels, int depth) {
+  return PaddedChannels(channels) *
+         (sizeof(int32_t) + static_cast<size_t>(PaddedDepth(depth)));
+}
+
+// `filter` is [channels, depth] (OHWI for convolutions), `bias` may be null.
+// `buffer` holds PackedFilterSize() bytes and is 16 byte aligned.
+inline PackedFilter PackFilter(const int8_t* filter, const int32_t* bias,
+                               int channels, int depth, int32_t input_offset,
+                               void* buffer) {
+  PackedFilter packed;
+  packed.channels = channels;
+  packed.depth = depth;
+  packed.padded_depth = PaddedDepth(depth);
+
+  const int padded_channels = PaddedChannels(channels);
+  int32_t* corrections = static_cast<int32_t*>(buffer);
+  int8_t* weights = reinterpret_cast<int8_t*>(corrections + padded_channels);
+
+  for (int oc = 0; oc < padded_channels; ++oc) {
+    int32_t sum = 0;
+    for (int d = 0; d < depth && oc < channels; ++d) {
+      sum += filter[oc * depth + d];
+    }
+    corrections[oc] =
+        (oc < channels && bias ? bias[oc] : 0) + input_offset * sum;
+  }
+
+  // weights[block][depth chunk][channel in block][16]
+  int8_t* out = weights;
+  for (int oc0 = 0; oc0 < padded_channels; oc0 += kChannelBlock) {
+    for (int d0 = 0; d0 < packed.padded_depth; d0 += kDepthAlign) {
+      for (int j = 0; j < kChannelBlock; ++j) {
+        const int oc = oc0 + j;
+        for (int i = 0; i < kDepthAlign; ++i) {
+          const int d = d0 + i;
+          *out++ = (oc < channels && d < depth) ? filter[oc * depth + d] : 0;
+        }
+      }
+    }
+  }
+
+  packed.corrections = corrections;
+  packed.weights = weights;
+  return packed;
+}
+
+// Filters packed ahead of time, by tools/eon_prepack for EON compiled models.
+// An entry is only used for the tensor data it points at. The table is bound
+// to the export it was made from when the model builds (kEonModelChecksum,
+// tools/eon_hooks), so the weights aren't looked at again at init.
+struct PrepackedFilter {
+  const void* filter;
+  int32_t input_offset;
+  int32_t channels;
+  int32_t depth;
+  const int32_t* corrections;
+  const int8_t* weights;
+};
+
+struct PrepackedFilters {
+  const PrepackedFilter* entries;
+  size_t count;
+};
+
+// Table of the model being prepared on this thread
+inline PrepackedFilters& CurrentPrepackedFilters() {
+  static thread_local PrepackedFilters current = {nullptr, 0};
+  return current;
+}
+
+// Set by a compiled model around its kernels' prepare, cleared with nullptr
+inline void SetPrepackedFilters(const PrepackedFilter* entries, size_t count) {
+  CurrentPrepackedFilters().entries = entries;
+  CurrentPrepackedFilters().count = entries ? count : 0;
+}
+
+// The table for the kernels' prepare in a compiled model's init, cleared
+// however init returns (the hook tools/eon_hooks inserts)
+class PrepackedFiltersScope {
+ public:
+  PrepackedFiltersScope(const PrepackedFilter* entries, size_t count) {
+    SetPrepackedFilters(entries, count);
+  }
+  ~PrepackedFiltersScope() { SetPrepackedFilters(nullptr, 0); }
+  PrepackedFiltersScope(const PrepackedFiltersScope&) = delete;
+  PrepackedFiltersScope& operator=(const PrepackedFiltersScope&) = delete;
+};
+
+// Fills `packed` from the current table instead of packing at run time
+inline bool FindPrepackedFilter(const int8_t* filter, int channels, int depth,
+                                int32_t input_offset, PackedFilter* packed) {
+  const PrepackedFilters& table = CurrentPrepackedFilters();
+  for (size_t i = 0; i < table.count; ++i) {
+    const PrepackedFilter& entry = table.entries[i];
+    if (entry.filter != filter || entry.channels != channels ||
+        entry.depth != depth || entry.input_offset != input_offset) {
+      continue;
+    }
+    packed->corrections = entry.corrections;
+    packed->weights = entry.weights;
+    packed->channels = channels;
+    packed->depth = depth;
+    packed->padded_depth = PaddedDepth(depth);
+    return true;
+  }
+  return false;
+}
+
+// acc[r * kChannelBlock + j] = dot(row r, channel j of the block). Rows are
+// padded_depth apart, `block` is one channel block of the packed weights.
+typedef void (*KernelFn)(const int8_t* rows, int num_rows,
+                         const int8_t* block, int padded_depth, int32_t* acc);
+
+inline void KernelPortable(const int8_t* rows, int num_rows,
+                           const int8_t* block, int padded_depth,
+                           int32_t* acc) {
+  for (int r = 0; r < num_rows; ++r) {
+    const int8_t* row = rows + r * padded_depth;
+    const int8_t* w = block;
+    int32_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    for (int d0 = 0; d0 < padded_depth; d0 += kDepthAlign) {
+      for (int i = 0; i < kDepthAlign; ++i) {
+        const int32_t x = row[d0 + i];
+        acc0 += x * w[i];
+        acc1 += x * w[kDepthAlign + i];
+        acc2 += x * w[2 * kDepthAlign + i];
+        acc3 += x * w[3 * kDepthAlign + i];
+      }
+      w += kChannelBlock * kDepthAlign;
+    }
+    acc[r * kChannelBlock + 0] = acc0;
+    acc[r * kChannelBlock + 1] = acc1;
+    acc[r * kChannelBlock + 2] = acc2;
+    acc[r * kChannelBlock + 3] = acc3;
+  }
+}
+
+#if EI_INT8_GEMM_X86
+// Two rows at a time: 8 accumulators, each holding 8 (AVX2) or 4 (SSE4.1)
+// partial sums, reduced to 4 lanes per row at the end.
+
+__attribute__((target("sse4.1"))) inline __m128i ReduceSse41(__m128i a0,
+                                                             __m128i a1,
+                                                             __m128i a2,
+                                                             __m128i a3) {
+  return _mm_hadd_epi32(_mm_hadd_epi32(a0, a1), _mm_hadd_epi32(a2, a3));
+}
+
+__attribute__((target("sse4.1"))) inline void KernelSse41(
+    const int8_t* rows, int num_rows, const int8_t* block, int padded_depth,
+    int32_t* acc) {
+  int r = 0;
+  for (; r + 2 <= num_rows; r += 2) {
+    const int8_t* row0 = rows + r * padded_depth;
+    const int8_t* row1 = row0 + padded_depth;
+    __m128i a[2][kChannelBlock];
+    for (int j = 0; j < kChannelBlock; ++j) {
+      a[0][j] = _mm_setzero_si128();
+      a[1][j] = _mm_setzero_si128();
+    }
+    const int8_t* w = block;
+    for (int d0 = 0; d0 < padded_depth; d0 += kDepthAlign) {
+      for (int h = 0; h < kDepthAlign; h += 8) {
+        const __m128i x0 = _mm_cvtepi8_epi16(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row0 + d0 + h)));
+        const __m128i x1 = _mm_cvtepi8_epi16(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row1 + d0 + h)));
+        for (int j = 0; j < kChannelBlock; ++j) {
+          const __m128i wj = _mm_cvtepi8_epi16(_mm_loadl_epi64(
+              reinterpret_cast<const __m128i*>(w + j * kDepthAlign + h)));
+          a[0][j] = _mm_add_epi32(a[0][j], _mm_madd_epi16(x0, wj));
+          a[1][j] = _mm_add_epi32(a[1][j], _mm_madd_epi16(x1, wj));
+        }
+      }
+      w += kChannelBlock * kDepthAlign;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + r * kChannelBlock),
+                     ReduceSse41(a[0][0], a[0][1], a[0][2], a[0][3]));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(acc + (r + 1) * kChannelBlock),
+        ReduceSse41(a[1][0], a[1][1], a[1][2], a[1][3]));
+  }
+  if (r < num_rows) {
+    KernelPortable(rows + r * padded_depth, num_rows - r, block, padded_depth,
+                   acc + r * kChannelBlock);
+  }
+}
+
+__attribute__((target("avx2"))) inline __m128i ReduceAvx2(__m256i a0,
+                                                          __m256i a1,
+                                                          __m256i a2,
+                                                          __m256i a3) {
+  const __m256i sums =
+      _mm256_hadd_epi32(_mm256_hadd_epi32(a0, a1), _mm256_hadd_epi32(a2, a3));
+  return _mm_add_epi32(_mm256_castsi256_si128(sums),
+                       _mm256_extracti128_si256(sums, 1));
+}
+
+__attribute__((target("avx2"))) inline void KernelAvx2(
+    const int8_t* rows, int num_rows, const int8_t* block, int padded_depth,
+    int32_t* acc) {
+  int r = 0;
+  for (; r + 2 <= num_rows; r += 2) {
+    const int8_t* row0 = rows + r * padded_depth;
+    const int8_t* row1 = row0 + padded_depth;
+    __m256i a[2][kChannelBlock];
+    for (int j = 0; j < kChannelBlock; ++j) {
+      a[0][j] = _mm256_setzero_si256();
+      a[1][j] = _mm256_setzero_si256();
+    }
+    const int8_t* w = block;
+    for (int d0 = 0; d0 < padded_depth; d0 += kDepthAlign) {
+      const __m256i x0 = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + d0)));
+      const __m256i x1 = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + d0)));
+      for (int j = 0; j < kChannelBlock; ++j) {
+        const __m256i wj = _mm256_cvtepi8_epi16(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(w + j * kDepthAlign)));
+        a[0][j] = _mm256_add_epi32(a[0][j], _mm256_madd_epi16(x0, wj));
+        a[1][j] = _mm256_add_epi32(a[1][j], _mm256_madd_epi16(x1, wj));
+      }
+      w += kChannelBlock * kDepthAlign;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + r * kChannelBlock),
+                     ReduceAvx2(a[0][0], a[0][1], a[0][2], a[0][3]));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(acc + (r + 1) * kChannelBlock),
+        ReduceAvx2(a[1][0], a[1][1], a[1][2], a[1][3]));
+  }
+  if (r < num_rows) {
+    KernelPortable(rows + r * padded_depth, num_rows - r, block, padded_depth,
+                   acc + r * kChannelBlock);
+  }
+}
+
+inline KernelFn SelectKernel() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return KernelAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return KernelSse41;
+  }
+  return KernelPortable;
+}
+
+inline KernelFn Kernel() {
+  static const KernelFn kernel = SelectKernel();
+  return kernel;
+}
+#else
+inline KernelFn Kernel() { return KernelPortable; }
+#endif  // EI_INT8_GEMM_X86
+
+struct OutputStage {
+  const int32_t* multiplier;
+  const int32_t* shift;
+  // 1 for per channel quantization, 0 for per tensor
+  int quantization_stride;
+  int32_t output_offset;
+  int32_t activation_min;
+  int32_t activation_max;
+};
+
+// output[r * channels + oc] for `num_rows` rows of filter.padded_depth bytes.
+// With `pool_rows`, row r is a tap of max pooling window pool_rows[r] instead:
+// output[pool_rows[r] * channels + oc] is the max over the window's rows,
+// which are consecutive.
+inline void RowsTimesFilter(const int8_t* rows, int num_rows,
+                            const PackedFilter& filter, int channels,
+                            const OutputStage& stage, int8_t* output,
+                            const int* pool_rows = nullptr) {
+  const KernelFn kernel = Kernel();
+  const int padded_depth = filter.padded_depth;
+  int32_t acc[kRowBlock * kChannelBlock];
+
+  for (int r0 = 0; r0 < num_rows; r0 += kRowBlock) {
+    const int block_rows = std::min(kRowBlock, num_rows - r0);
+    for (int oc0 = 0; oc0 < channels; oc0 += kChannelBlock) {
+      kernel(rows + r0 * padded_depth, block_rows,
+             filter.weights + oc0 * padded_depth, padded_depth, acc);
+
+      const int block_channels = std::min(kChannelBlock, channels - oc0);
+      for (int r = 0; r < block_rows; ++r) {
+        const int row = r0 + r;
+        int8_t* out = output + (pool_rows ? pool_rows[row] : row) * channels + oc0;
+        const bool pooled =
+            pool_rows && row > 0 && pool_rows[row - 1] == pool_rows[row];
+        for (int j = 0; j < block_channels; ++j) {
+          const int oc = oc0 + j;
+          const int q = oc * stage.quantization_stride;
+          int32_t value = MultiplyByQuantizedMultiplier(
+              acc[r * kChannelBlock + j] + filter.corrections[oc],
+              stage.multiplier[q], stage.shift[q]);
+          value += stage.output_offset;
+          value = std::max(value, stage.activation_min);
+          value = std::min(value, stage.activation_max);
+          if (pooled) {
+            value = std::max(value, static_cast<int32_t>(out[j]));
+          }
+          out[j] = static_cast<int8_t>(value);
+        }
+      }
+    }
+  }
+}
+
+// 1x1 convolutions with stride 1 over a depth the kernel can read in place
+// run straight off the input, everything else needs an im2col buffer
+inline bool Im2colNeeded(int filter_height, int filter_width,
+                         int stride_height, int stride_width,
+                         int input_depth) {
+  return !(filter_height == 1 && filter_width == 1 && stride_height == 1 &&
+           stride_width == 1 && input_depth == PaddedDepth(input_depth));
+}
+
+inline size_t Im2colBufferSize(int output_pixels, int depth) {
+  return static_cast<size_t>(std::min(kRowBlock, output_pixels)) *
+         PaddedDepth(depth);
+}
+
+inline OutputStage ConvOutputStage(const ConvParams& params,
+                                   const int32_t* output_multiplier,
+                                   const int32_t* output_shift) {
+  OutputStage stage;
+  stage.multiplier = output_multiplier;
+  stage.shift = output_shift;
+  stage.quantization_stride = 1;
+  stage.output_offset = params.output_offset;
+  stage.activation_min = params.quantized_activation_min;
+  stage.activation_max = params.quantized_activation_max;
+  TFLITE_DCHECK_LE(stage.activation_min, stage.activation_max);
+  return stage;
+}
+
+// The filter taps of output pixel (batch, out_y, out_x) as one row of
+// filter.padded_depth bytes
+inline void Im2colRow(const ConvParams& params,
+                      const RuntimeShape& input_shape,
+                      const int8_t* input_data,
+                      const RuntimeShape& filter_shape,
+                      const PackedFilter& filter, int batch, int out_y,
+                      int out_x, int8_t* row) {
+  const int dilation_width_factor = params.dilation_width_factor;
+  const int dilation_height_factor = params.dilation_height_factor;
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int8_t pad_value = static_cast<int8_t>(-params.input_offset);
+  const int span = filter_width * input_depth;
+
+  const int in_y_origin =
+      (out_y * params.stride_height) - params.padding_values.height;
+  const int in_x_origin =
+      (out_x * params.stride_width) - params.padding_values.width;
+  const bool row_inside = dilation_width_factor == 1 && in_x_origin >= 0 &&
+                          in_x_origin + filter_width <= input_width;
+
+  for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+    const int in_y = in_y_origin + dilation_height_factor * filter_y;
+    if (in_y < 0 || in_y >= input_height) {
+      memset(row, pad_value, span);
+      row += span;
+      continue;
+    }
+    if (row_inside) {
+      memcpy(row,
+             input_data + Offset(input_shape, batch, in_y, in_x_origin, 0),
+             span);
+      row += span;
+      continue;
+    }
+    for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+      const int in_x = in_x_origin + dilation_width_factor * filter_x;
+      if (in_x < 0 || in_x >= input_width) {
+        memset(row, pad_value, input_depth);
+      } else {
+        memcpy(row, input_data + Offset(input_shape, batch, in_y, in_x, 0),
+               input_depth);
+      }
+      row += input_depth;
+    }
+  }
+  memset(row, 0, filter.padded_depth - filter.depth);
+}
+
+// Counterpart of reference_integer_ops::ConvPerChannel() (groups == 1)
+inline void ConvPerChannel(const ConvParams& params,
+                           const int32_t* output_multiplier,
+                           const int32_t* output_shift,
+                           const RuntimeShape& input_shape,
+                           const int8_t* input_data,
+                           const RuntimeShape& filter_shape,
+                           const PackedFilter& filter,
+                           const RuntimeShape& output_shape,
+                           int8_t* output_data, int8_t* im2col_data) {
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_depth = MatchingDim(input_shape, 3, filter_shape, 3);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
+  const int output_pixels = batches * output_height * output_width;
+
+  const OutputStage stage =
+      ConvOutputStage(params, output_multiplier, output_shift);
+
+  if (!Im2colNeeded(filter_height, filter_width, params.stride_height,
+                    params.stride_width, input_depth)) {
+    RowsTimesFilter(input_data, output_pixels, filter, output_depth, stage,
+                    output_data);
+    return;
+  }
+  TFLITE_DCHECK(im2col_data != nullptr);
+
+  for (int p0 = 0; p0 < output_pixels; p0 += kRowBlock) {
+    const int block_pixels = std::min(kRowBlock, output_pixels - p0);
+    for (int p = 0; p < block_pixels; ++p) {
+      const int pixel = p0 + p;
+      Im2colRow(params, input_shape, input_data, filter_shape, filter,
+                pixel / (output_width * output_height),
+                (pixel / output_width) % output_height, pixel % output_width,
+                im2col_data + p * filter.padded_depth);
+    }
+    RowsTimesFilter(im2col_data, block_pixels, filter, output_depth, stage,
+                    output_data + p0 * output_depth);
+  }
+}
+
+// Rows are read in place when the depth needs no padding, otherwise they are
+// copied kRowBlock at a time into a buffer of this size
+inline size_t FullyConnectedBufferSize(int batches, int depth) {
+  if (depth == PaddedDepth(depth)) {
+    return 0;
+  }
+  return static_cast<size_t>(std::min(kRowBlock, batches)) *
+         PaddedDepth(depth);
+}
+
+// Counterpart of reference_integer_ops::FullyConnected() (weights_offset == 0)
+inline void FullyConnected(const FullyConnectedParams& params,
+                           const int8_t* input_data,
+                           const PackedFilter& filter,
+                           const RuntimeShape& output_shape,
+                           int8_t* output_data, int8_t* row_data) {
+  TFLITE_DCHECK_EQ(params.weights_offset, 0);
+  const int output_dim_count = output_shape.DimensionsCount();
+  const int batches = FlatSizeSkipDim(output_shape, output_dim_count - 1);
+  const int output_depth = output_shape.Dims(output_dim_count - 1);
+  TFLITE_DCHECK_LE(output_depth, filter.channels);
+
+  const int32_t shift = params.output_shift;
+  OutputStage stage;
+  stage.multiplier = &params.output_multiplier;
+  stage.shift = &shift;
+  stage.quantization_stride = 0;
+  stage.output_offset = params.output_offset;
+  stage.activation_min = params.quantized_activation_min;
+  stage.activation_max = params.quantized_activation_max;
+  TFLITE_DCHECK_LE(stage.activation_min, stage.activation_max);
+
+  const int depth = filter.depth;
+  if (depth == filter.padded_depth) {
+    RowsTimesFilter(input_data, batches, filter, output_depth, stage,
+                    output_data);
+    return;
+  }
+  TFLITE_DCHECK(row_data != nullptr);
+
+  for (int b0 = 0; b0 < batches; b0 += kRowBlock) {
+    const int block_rows = std::min(kRowBlock, batches - b0);
+    for (int b = 0; b < block_rows; ++b) {
+      int8_t* row = row_data + b * filter.padded_depth;
+      memcpy(row, input_data + (b0 + b) * depth, depth);
+      memset(row + depth, 0, filter.padded_depth - depth);
+    }
+    RowsTimesFilter(row_data, block_rows, filter, output_depth, stage,
+                    output_data + b0 * output_depth);
+  }
+}
+
+}  // namespace int8_gemm
+}  // namespace optimized_integer_ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_INTEGER_OPS_INT8_GEMM_H_
@@ -2056,6 +2056,7 @@ limitations under the License.
 
 #include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/portable_tensor_utils.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/conv.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
@@ -2066,10 +2067,92 @@ limitations under the License.
 namespace tflite {
 namespace {
 
+struct NodeData {
+  OpDataConv op_data;
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+  // weights == nullptr when the reference kernel runs
+  optimized_integer_ops::int8_gemm::PackedFilter packed_filter;
+  int im2col_buffer_index;
+#endif
+};
+
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context, sizeof(OpDataConv));
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+}
+
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  TF_LITE_ENSURE_STATUS(ConvPrepare(context, node));
+
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  const auto& params =
+      *(static_cast<const TfLiteConvParams*>(node->builtin_data));
+  data->packed_filter.weights = nullptr;
+  data->im2col_buffer_index = -1;
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kConvInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* filter =
+      micro_context->AllocateTempInputTensor(node, kConvWeightsTensor);
+  TF_LITE_ENSURE(context, filter != nullptr);
+  TfLiteTensor* bias =
+      micro_context->AllocateTempInputTensor(node, kConvBiasTensor);
+  TfLiteTensor* output =
+      micro_context->AllocateTempOutputTensor(node, kConvOutputTensor);
+  TF_LITE_ENSURE(context, output != nullptr);
+
+  // The weights (and bias) are packed once, so they need to be constant.
+  // Grouped convolutions stay on the reference kernel.
+  const int input_depth = input->dims->data[3];
+  if (input->type == kTfLiteInt8 && filter->type == kTfLiteInt8 &&
+      filter->dims->data[3] == input_depth && IsConstantTensor(filter) &&
+      (bias == nullptr || IsConstantTensor(bias))) {
+    const int channels = filter->dims->data[0];
+    const int filter_height = filter->dims->data[1];
+    const int filter_width = filter->dims->data[2];
+    const int depth = filter_height * filter_width * input_depth;
+
+    const int8_t* filter_data = GetTensorData<int8_t>(filter);
+    const int32_t* bias_data =
+        bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr;
+    // Filters the model ships prepacked are used in place
+    if (!optimized_integer_ops::int8_gemm::FindPrepackedFilter(
+            filter_data, channels, depth, -input->params.zero_point,
+            &data->packed_filter)) {
+      void* buffer = context->AllocatePersistentBuffer(
+          context,
+          optimized_integer_ops::int8_gemm::PackedFilterSize(channels, depth));
+      TF_LITE_ENSURE(context, buffer != nullptr);
+      data->packed_filter = optimized_integer_ops::int8_gemm::PackFilter(
+          filter_data, bias_data, channels, depth, -input->params.zero_point,
+          buffer);
+    }
+
+    if (optimized_integer_ops::int8_gemm::Im2colNeeded(
+            filter_height, filter_width, params.stride_height,
+            params.stride_width, input_depth)) {
+      const int output_pixels = output->dims->data[0] *
+                                output->dims->data[1] * output->dims->data[2];
+      TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+          context,
+          optimized_integer_ops::int8_gemm::Im2colBufferSize(output_pixels,
+                                                             depth),
+          &data->im2col_buffer_index));
+    }
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(filter);
+  if (bias != nullptr) {
+    micro_context->DeallocateTempTfLiteTensor(bias);
+  }
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
 }
+#endif  // EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
 
 TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteEvalTensor* input =
@@ -2087,7 +2170,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   const auto& params =
       *(reinterpret_cast<TfLiteConvParams*>(node->builtin_data));
   TFLITE_DCHECK(node->user_data != nullptr);
-  const auto& data = *(static_cast<const OpDataConv*>(node->user_data));
+  const auto& node_data = *(static_cast<const NodeData*>(node->user_data));
+  const auto& data = node_data.op_data;
 
   TF_LITE_ENSURE_EQ(context, input->type, output->type);
   TF_LITE_ENSURE_MSG(
@@ -2180,6 +2264,25 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
           break;
         }
         case kTfLiteInt8: {
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+          if (node_data.packed_filter.weights != nullptr) {
+            int8_t* im2col_data =
+                node_data.im2col_buffer_index >= 0
+                    ? static_cast<int8_t*>(context->GetScratchBuffer(
+                          context, node_data.im2col_buffer_index))
+                    : nullptr;
+            optimized_integer_ops::int8_gemm::ConvPerChannel(
+                ConvParamsQuantized(params, data),
+                data.per_channel_output_multiplier,
+                data.per_channel_output_shift,
+                tflite::micro::GetTensorShape(input),
+                tflite::micro::GetTensorData<int8_t>(input),
+                tflite::micro::GetTensorShape(filter), node_data.packed_filter,
+                tflite::micro::GetTensorShape(output),
+                tflite::micro::GetTensorData<int8_t>(output), im2col_data);
+            break;
+          }
+#endif  // EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
           reference_integer_ops::ConvPerChannel(
               ConvParamsQuantized(params, data),
               data.per_channel_output_multiplier, data.per_channel_output_shift,
@@ -2211,7 +2314,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace
 
 TfLiteRegistration Register_CONV_2D() {
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+#else
   return tflite::micro::RegisterOp(Init, ConvPrepare, Eval);
+#endif
 }
 
 }  // namespace tflite
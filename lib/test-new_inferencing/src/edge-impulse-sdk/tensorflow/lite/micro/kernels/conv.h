@@ -81,6 +81,18 @@ TfLiteStatus ConvPrepare(TfLiteContext* context, TfLiteNode* node);
 // (reference or optimized) must define this function.
 TfLiteRegistration Register_CONV_2D();
 
+// CONV_2D followed by MAX_POOL_2D, for EON graphs rewritten by tools/eon_fuse.
+// The pooling window is given in the coordinates of the convolution output,
+// which is never stored: each pooled pixel is the max over the requantized
+// outputs of its window. int8 only.
+struct ConvMaxPoolParams {
+  // First, ConvPrepare() reads the builtin data as TfLiteConvParams
+  TfLiteConvParams conv;
+  TfLitePoolParams pool;
+};
+
+TfLiteRegistration Register_CONV_2D_MAX_POOL_2D();
+
 #if defined(XTENSA)
 // Returns a TfLiteRegistration struct for kernel variant that only supports
 // int8 activations and int8 weights and always calls the reference
@@ -0,0 +1,369 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// CONV_2D + MAX_POOL_2D in one pass (see ConvMaxPoolParams in conv.h). The
+// convolution output is computed a pooling window at a time and reduced
+// straight away, so it needs no tensor of its own. Outputs are bit-exact with
+// the two kernels run one after the other.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/padding.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+namespace {
+
+struct NodeData {
+  // First, ConvPrepare() reads the user data as OpDataConv
+  OpDataConv op_data;
+  int conv_height;
+  int conv_width;
+  int pooled_height;
+  int pooled_width;
+  TfLitePaddingValues pool_padding;
+  int32_t pool_activation_min;
+  int32_t pool_activation_max;
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+  // weights == nullptr when the reference loops run
+  optimized_integer_ops::int8_gemm::PackedFilter packed_filter;
+  int im2col_buffer_index;
+#endif
+};
+
+// Convolution output pixels of one pooling window, clamped to the output
+struct Window {
+  int y_start;
+  int y_end;
+  int x_start;
+  int x_end;
+};
+
+Window PoolWindow(const NodeData& data, const TfLitePoolParams& pool,
+                  int out_y, int out_x) {
+  const int in_y_origin =
+      (out_y * pool.stride_height) - data.pool_padding.height;
+  const int in_x_origin = (out_x * pool.stride_width) - data.pool_padding.width;
+  Window window;
+  window.y_start = std::max(0, in_y_origin);
+  window.y_end = std::min(in_y_origin + pool.filter_height, data.conv_height);
+  window.x_start = std::max(0, in_x_origin);
+  window.x_end = std::min(in_x_origin + pool.filter_width, data.conv_width);
+  return window;
+}
+
+void* Init(TfLiteContext* context, const char* /*buffer*/, size_t /*length*/) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+}
+
+TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+  // The convolution's output has the quantization of the pooled output
+  TF_LITE_ENSURE_STATUS(ConvPrepare(context, node));
+
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  const auto& params =
+      *(static_cast<const ConvMaxPoolParams*>(node->builtin_data));
+  const TfLitePoolParams& pool = params.pool;
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kConvInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* filter =
+      micro_context->AllocateTempInputTensor(node, kConvWeightsTensor);
+  TF_LITE_ENSURE(context, filter != nullptr);
+  TfLiteTensor* bias =
+      micro_context->AllocateTempInputTensor(node, kConvBiasTensor);
+  TfLiteTensor* output =
+      micro_context->AllocateTempOutputTensor(node, kConvOutputTensor);
+  TF_LITE_ENSURE(context, output != nullptr);
+
+  if (input->type != kTfLiteInt8 || filter->type != kTfLiteInt8 ||
+      output->type != kTfLiteInt8) {
+    MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                input->type);
+    return kTfLiteError;
+  }
+  // No grouped convolutions
+  const int input_depth = input->dims->data[3];
+  TF_LITE_ENSURE_EQ(context, filter->dims->data[3], input_depth);
+
+  const int batches = input->dims->data[0];
+  const int channels = filter->dims->data[0];
+  const int filter_height = filter->dims->data[1];
+  const int filter_width = filter->dims->data[2];
+  ComputePaddingHeightWidth(
+      params.conv.stride_height, params.conv.stride_width,
+      params.conv.dilation_height_factor, params.conv.dilation_width_factor,
+      input->dims->data[1], input->dims->data[2], filter_height, filter_width,
+      params.conv.padding, &data->conv_height, &data->conv_width);
+  data->pool_padding = ComputePaddingHeightWidth(
+      pool.stride_height, pool.stride_width, 1, 1, data->conv_height,
+      data->conv_width, pool.filter_height, pool.filter_width, pool.padding,
+      &data->pooled_height, &data->pooled_width);
+
+  // Any shape holding the pooled pixels in order, like the pooling's own
+  // output before a reshape
+  TF_LITE_ENSURE_EQ(context, output->dims->data[output->dims->size - 1],
+                    channels);
+  TF_LITE_ENSURE_EQ(
+      context, NumElements(output),
+      batches * data->pooled_height * data->pooled_width * channels);
+
+  TF_LITE_ENSURE_STATUS(CalculateActivationRangeQuantized(
+      context, pool.activation, output, &data->pool_activation_min,
+      &data->pool_activation_max));
+
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+  namespace gemm = optimized_integer_ops::int8_gemm;
+  data->packed_filter.weights = nullptr;
+  data->im2col_buffer_index = -1;
+
+  // A window's taps go through the GEMM together
+  if (IsConstantTensor(filter) && (bias == nullptr || IsConstantTensor(bias)) &&
+      pool.filter_height * pool.filter_width <= gemm::kRowBlock) {
+    const int depth = filter_height * filter_width * input_depth;
+    const int8_t* filter_data = GetTensorData<int8_t>(filter);
+    const int32_t* bias_data =
+        bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr;
+    if (!gemm::FindPrepackedFilter(filter_data, channels, depth,
+                                   -input->params.zero_point,
+                                   &data->packed_filter)) {
+      void* buffer = context->AllocatePersistentBuffer(
+          context, gemm::PackedFilterSize(channels, depth));
+      TF_LITE_ENSURE(context, buffer != nullptr);
+      data->packed_filter =
+          gemm::PackFilter(filter_data, bias_data, channels, depth,
+                           -input->params.zero_point, buffer);
+    }
+    const int conv_pixels = batches * data->conv_height * data->conv_width;
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, gemm::Im2colBufferSize(conv_pixels, depth),
+        &data->im2col_buffer_index));
+  }
+#endif  // EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(filter);
+  if (bias != nullptr) {
+    micro_context->DeallocateTempTfLiteTensor(bias);
+  }
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+void ClampPooled(const NodeData& data, int8_t* begin, int8_t* end) {
+  for (int8_t* p = begin; p < end; ++p) {
+    int32_t value = *p;
+    value = std::max(value, data.pool_activation_min);
+    value = std::min(value, data.pool_activation_max);
+    *p = static_cast<int8_t>(value);
+  }
+}
+
+// Maxes the output of convolution pixel (batch, out_y, out_x) into `pooled`,
+// the arithmetic of reference_integer_ops::ConvPerChannel()
+void ConvPixelReference(const ConvParams& params, const OpDataConv& data,
+                        const RuntimeShape& input_shape,
+                        const int8_t* input_data,
+                        const RuntimeShape& filter_shape,
+                        const int8_t* filter_data, const int32_t* bias_data,
+                        int batch, int out_y, int out_x, int8_t* pooled) {
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int output_depth = filter_shape.Dims(0);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int in_y_origin =
+      (out_y * params.stride_height) - params.padding_values.height;
+  const int in_x_origin =
+      (out_x * params.stride_width) - params.padding_values.width;
+
+  for (int out_channel = 0; out_channel < output_depth; ++out_channel) {
+    int32_t acc = 0;
+    for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+      const int in_y = in_y_origin + params.dilation_height_factor * filter_y;
+      for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+        const int in_x = in_x_origin + params.dilation_width_factor * filter_x;
+        if (in_x < 0 || in_x >= input_width || in_y < 0 ||
+            in_y >= input_height) {
+          continue;
+        }
+        for (int in_channel = 0; in_channel < input_depth; ++in_channel) {
+          const int32_t input_val =
+              input_data[Offset(input_shape, batch, in_y, in_x, in_channel)];
+          const int32_t filter_val = filter_data[Offset(
+              filter_shape, out_channel, filter_y, filter_x, in_channel)];
+          acc += filter_val * (input_val + params.input_offset);
+        }
+      }
+    }
+    if (bias_data) {
+      acc += bias_data[out_channel];
+    }
+    acc = MultiplyByQuantizedMultiplier(
+        acc, data.per_channel_output_multiplier[out_channel],
+        data.per_channel_output_shift[out_channel]);
+    acc += params.output_offset;
+    acc = std::max(acc, params.quantized_activation_min);
+    acc = std::min(acc, params.quantized_activation_max);
+    pooled[out_channel] =
+        std::max(pooled[out_channel], static_cast<int8_t>(acc));
+  }
+}
+
+TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kConvInputTensor);
+  const TfLiteEvalTensor* filter =
+      tflite::micro::GetEvalInput(context, node, kConvWeightsTensor);
+  const TfLiteEvalTensor* bias =
+      (NumInputs(node) == 3)
+          ? tflite::micro::GetEvalInput(context, node, kConvBiasTensor)
+          : nullptr;
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kConvOutputTensor);
+
+  TFLITE_DCHECK(node->builtin_data != nullptr);
+  const auto& params =
+      *(static_cast<const ConvMaxPoolParams*>(node->builtin_data));
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const auto& data = *(static_cast<const NodeData*>(node->user_data));
+
+  const ConvParams conv_params = ConvParamsQuantized(params.conv, data.op_data);
+  const RuntimeShape input_shape = tflite::micro::GetTensorShape(input);
+  const RuntimeShape filter_shape = tflite::micro::GetTensorShape(filter);
+  const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
+  int8_t* output_data = tflite::micro::GetTensorData<int8_t>(output);
+  const int channels = filter_shape.Dims(0);
+  const int pooled_pixels =
+      input_shape.Dims(0) * data.pooled_height * data.pooled_width;
+
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+  if (data.packed_filter.weights != nullptr) {
+    namespace gemm = optimized_integer_ops::int8_gemm;
+    const gemm::OutputStage stage = gemm::ConvOutputStage(
+        conv_params, data.op_data.per_channel_output_multiplier,
+        data.op_data.per_channel_output_shift);
+    int8_t* im2col_data = static_cast<int8_t*>(
+        context->GetScratchBuffer(context, data.im2col_buffer_index));
+    const int padded_depth = data.packed_filter.padded_depth;
+
+    // Whole windows per block: row r is a tap of pooled pixel
+    // first + pool_rows[r]
+    int pool_rows[gemm::kRowBlock];
+    int rows = 0;
+    int first = 0;
+    for (int pixel = 0; pixel <= pooled_pixels; ++pixel) {
+      Window window = {0, 0, 0, 0};
+      if (pixel < pooled_pixels) {
+        window = PoolWindow(data, params.pool,
+                            (pixel / data.pooled_width) % data.pooled_height,
+                            pixel % data.pooled_width);
+      }
+      const int taps = std::max(0, window.y_end - window.y_start) *
+                       std::max(0, window.x_end - window.x_start);
+      if (pixel == pooled_pixels || rows + taps > gemm::kRowBlock) {
+        gemm::RowsTimesFilter(im2col_data, rows, data.packed_filter, channels,
+                              stage, output_data + first * channels,
+                              pool_rows);
+        ClampPooled(data, output_data + first * channels,
+                    output_data + pixel * channels);
+        rows = 0;
+        first = pixel;
+        if (pixel == pooled_pixels) {
+          break;
+        }
+      }
+      if (taps == 0) {
+        memset(output_data + pixel * channels,
+               std::numeric_limits<int8_t>::lowest(), channels);
+        continue;
+      }
+      const int batch = pixel / (data.pooled_width * data.pooled_height);
+      for (int y = window.y_start; y < window.y_end; ++y) {
+        for (int x = window.x_start; x < window.x_end; ++x) {
+          gemm::Im2colRow(conv_params, input_shape, input_data, filter_shape,
+                          data.packed_filter, batch, y, x,
+                          im2col_data + rows * padded_depth);
+          pool_rows[rows++] = pixel - first;
+        }
+      }
+    }
+    return kTfLiteOk;
+  }
+#endif  // EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+
+  const int8_t* filter_data = tflite::micro::GetTensorData<int8_t>(filter);
+  const int32_t* bias_data =
+      tflite::micro::GetOptionalTensorData<int32_t>(bias);
+  for (int pixel = 0; pixel < pooled_pixels; ++pixel) {
+    const Window window =
+        PoolWindow(data, params.pool,
+                   (pixel / data.pooled_width) % data.pooled_height,
+                   pixel % data.pooled_width);
+    const int batch = pixel / (data.pooled_width * data.pooled_height);
+    int8_t* pooled = output_data + pixel * channels;
+    memset(pooled, std::numeric_limits<int8_t>::lowest(), channels);
+    for (int y = window.y_start; y < window.y_end; ++y) {
+      for (int x = window.x_start; x < window.x_end; ++x) {
+        ConvPixelReference(conv_params, data.op_data, input_shape, input_data,
+                           filter_shape, filter_data, bias_data, batch, y, x,
+                           pooled);
+      }
+    }
+    ClampPooled(data, pooled, pooled + channels);
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteRegistration Register_CONV_2D_MAX_POOL_2D() {
+  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+}
+
+}  // namespace tflite
@@ -1618,19 +1618,30 @@ limitations under the License.
 
 #include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/portable_tensor_utils.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/fully_connected.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
 
 namespace tflite {
 namespace {
 
+struct NodeData {
+  OpDataFullyConnected op_data;
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+  // weights == nullptr when the reference kernel runs
+  optimized_integer_ops::int8_gemm::PackedFilter packed_filter;
+  int row_buffer_index;
+#endif
+};
+
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context,
-                                           sizeof(OpDataFullyConnected));
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
 }
 
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
@@ -1639,7 +1650,8 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->user_data != nullptr);
   TFLITE_DCHECK(node->builtin_data != nullptr);
 
-  auto* data = static_cast<OpDataFullyConnected*>(node->user_data);
+  auto* node_data = static_cast<NodeData*>(node->user_data);
+  auto* data = &node_data->op_data;
   const auto params =
       static_cast<const TfLiteFullyConnectedParams*>(node->builtin_data);
 
@@ -1669,6 +1681,45 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                                  context, params->activation, input->type,
                                  input, filter, bias, output, data));
 
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+  // The weights (and bias) are packed once, so they need to be constant
+  node_data->packed_filter.weights = nullptr;
+  node_data->row_buffer_index = -1;
+  if (input->type == kTfLiteInt8 && filter->type == kTfLiteInt8 &&
+      data->filter_zero_point == 0 && IsConstantTensor(filter) &&
+      (bias == nullptr || IsConstantTensor(bias))) {
+    const int channels = filter->dims->data[filter->dims->size - 2];
+    const int depth = filter->dims->data[filter->dims->size - 1];
+
+    const int8_t* filter_data = GetTensorData<int8_t>(filter);
+    const int32_t* bias_data =
+        bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr;
+    // Filters the model ships prepacked are used in place
+    if (!optimized_integer_ops::int8_gemm::FindPrepackedFilter(
+            filter_data, channels, depth, -input->params.zero_point,
+            &node_data->packed_filter)) {
+      void* buffer = context->AllocatePersistentBuffer(
+          context,
+          optimized_integer_ops::int8_gemm::PackedFilterSize(channels, depth));
+      TF_LITE_ENSURE(context, buffer != nullptr);
+      node_data->packed_filter = optimized_integer_ops::int8_gemm::PackFilter(
+          filter_data, bias_data, channels, depth, -input->params.zero_point,
+          buffer);
+    }
+
+    const RuntimeShape output_shape = GetTensorShape(output);
+    const int batches =
+        FlatSizeSkipDim(output_shape, output_shape.DimensionsCount() - 1);
+    const size_t row_buffer_size =
+        optimized_integer_ops::int8_gemm::FullyConnectedBufferSize(batches,
+                                                                   depth);
+    if (row_buffer_size > 0) {
+      TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+          context, row_buffer_size, &node_data->row_buffer_index));
+    }
+  }
+#endif  // EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+
   micro_context->DeallocateTempTfLiteTensor(input);
   micro_context->DeallocateTempTfLiteTensor(filter);
   if (bias != nullptr) {
@@ -1694,8 +1745,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
   TFLITE_DCHECK(node->user_data != nullptr);
 
-  const auto& data =
-      *(static_cast<const OpDataFullyConnected*>(node->user_data));
+  const auto& node_data = *(static_cast<const NodeData*>(node->user_data));
+  const auto& data = node_data.op_data;
 
   // Checks in Prepare ensure input, output and filter types are all the same.
   switch (input->type) {
@@ -1744,6 +1795,22 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
           break;
         }
         case kTfLiteInt8: {
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
+          if (node_data.packed_filter.weights != nullptr) {
+            int8_t* row_data =
+                node_data.row_buffer_index >= 0
+                    ? static_cast<int8_t*>(context->GetScratchBuffer(
+                          context, node_data.row_buffer_index))
+                    : nullptr;
+            optimized_integer_ops::int8_gemm::FullyConnected(
+                FullyConnectedParamsQuantized(data),
+                tflite::micro::GetTensorData<int8_t>(input),
+                node_data.packed_filter,
+                tflite::micro::GetTensorShape(output),
+                tflite::micro::GetTensorData<int8_t>(output), row_data);
+            break;
+          }
+#endif  // EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM
           tflite::reference_integer_ops::FullyConnected(
               FullyConnectedParamsQuantized(data),
               tflite::micro::GetTensorShape(input),
@@ -61,6 +61,21 @@ RecordingMicroAllocator* RecordingMicroAllocator::Create(uint8_t* tensor_arena,
   return allocator;
 }
 
+RecordingMicroAllocator* RecordingMicroAllocator::Create(
+    uint8_t* tensor_arena, size_t arena_size,
+    MicroMemoryPlanner* memory_planner) {
+  TFLITE_DCHECK(memory_planner != nullptr);
+  RecordingSingleArenaBufferAllocator* simple_memory_allocator =
+      RecordingSingleArenaBufferAllocator::Create(tensor_arena, arena_size);
+  TFLITE_DCHECK(simple_memory_allocator != nullptr);
+
+  uint8_t* allocator_buffer = simple_memory_allocator->AllocatePersistentBuffer(
+      sizeof(RecordingMicroAllocator), alignof(RecordingMicroAllocator));
+  RecordingMicroAllocator* allocator = new (allocator_buffer)
+      RecordingMicroAllocator(simple_memory_allocator, memory_planner);
+  return allocator;
+}
+
 RecordedAllocation RecordingMicroAllocator::GetRecordedAllocation(
     RecordedAllocationType allocation_type) const {
   switch (allocation_type) {
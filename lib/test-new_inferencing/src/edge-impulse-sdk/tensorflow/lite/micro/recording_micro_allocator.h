@@ -57,6 +57,12 @@ class RecordingMicroAllocator : public MicroAllocator {
   static RecordingMicroAllocator* Create(uint8_t* tensor_arena,
                                          size_t arena_size);
 
+  // Same, with a given MemoryPlanner instead of a GreedyMemoryPlanner created
+  // on the arena. The planner is owned by the caller.
+  static RecordingMicroAllocator* Create(uint8_t* tensor_arena,
+                                         size_t arena_size,
+                                         MicroMemoryPlanner* memory_planner);
+
   // Returns the fixed amount of memory overhead of RecordingMicroAllocator.
   static size_t GetDefaultTailUsage();
 
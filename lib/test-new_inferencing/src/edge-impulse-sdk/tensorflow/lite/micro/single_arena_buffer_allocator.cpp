@@ -181,6 +181,10 @@ size_t SingleArenaBufferAllocator::GetPersistentUsedBytes() const {
 size_t SingleArenaBufferAllocator::GetAvailableMemory(size_t alignment) const {
   uint8_t* const aligned_temp = AlignPointerUp(temp_, alignment);
   uint8_t* const aligned_tail = AlignPointerDown(tail_, alignment);
+  // The head may already reach into the alignment padding of the tail
+  if (aligned_temp >= aligned_tail) {
+    return 0;
+  }
   return aligned_tail - aligned_temp;
 }
 
@@ -123,6 +123,19 @@
 
 #define EI_DSP_PARAMS_GENERATED                  1
 
+// MFCC config of the DSP block, for the compile-time MFCC engine (dsp/speechpy/mfcc_fixed.hpp)
+#ifndef EI_CLASSIFIER_MFCC_FIXED
+#define EI_CLASSIFIER_MFCC_FIXED                 1
+#endif // EI_CLASSIFIER_MFCC_FIXED
+#define EI_CLASSIFIER_MFCC_FIXED_FRAME_LENGTH    400
+#define EI_CLASSIFIER_MFCC_FIXED_FRAME_STRIDE    320
+#define EI_CLASSIFIER_MFCC_FIXED_NUM_CEPSTRAL    13
+#define EI_CLASSIFIER_MFCC_FIXED_NUM_FILTERS     32
+#define EI_CLASSIFIER_MFCC_FIXED_FFT_LENGTH      512
+#define EI_CLASSIFIER_MFCC_FIXED_LOW_FREQUENCY   300
+#define EI_CLASSIFIER_MFCC_FIXED_HIGH_FREQUENCY  8000
+#define EI_CLASSIFIER_MFCC_FIXED_VERSION         4
+
 #define EI_CLASSIFIER_INFERENCING_ENGINE            EI_CLASSIFIER_TFLITE
 #define EI_CLASSIFIER_COMPILED                      1
 #define EI_CLASSIFIER_HAS_TFLITE_OPS_RESOLVER       0
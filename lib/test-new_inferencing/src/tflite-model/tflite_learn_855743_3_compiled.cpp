@@ -36,6 +36,10 @@
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+// eon_hooks begin: prepacked
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h"
+// eon_hooks end: prepacked
 
 #if EI_CLASSIFIER_PRINT_STATE
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
@@ -93,8 +97,40 @@ using namespace tflite::ops::micro;
 
 namespace {
 
+// eon_hooks begin: fused
+// The graph rewritten by tools/eon_fuse, with its own arena size and tensor
+// offsets (the EON tools compile this file themselves without it). The header
+// is only taken for the export it was made from: kEonModelChecksum is FNV-1a of
+// this file as exported.
+constexpr uint32_t kEonModelChecksum = 0x3fabdb34u;
+
+template <int SZ> struct FusedIntArray {
+  int sz; int elem[SZ];
+};
+
+struct FusedNodeInfo_t { // node of the graph rewritten by tools/eon_fuse, runs in place of tflNodes[node]
+  int node;
+  const TfLiteIntArray* outputs; // nullptr: those of tflNodes[node]
+  const ConvMaxPoolParams* conv_max_pool; // set: a CONV_2D_MAX_POOL_2D node
+};
+
+#if !defined(EI_EON_FUSE) && !defined(EI_EON_PREPACK)
+#ifdef __has_include
+#if __has_include("tflite-model/tflite_learn_855743_3_fused.h")
+#include "tflite-model/tflite_learn_855743_3_fused.h"
+#define EI_EON_FUSED_GRAPH 1
+static_assert(kFusedModelChecksum == kEonModelChecksum,
+  "tflite-model/tflite_learn_855743_3_fused.h was made from another export of the model, run tools/eon_fuse/build.sh");
+#endif
+#endif // __has_include
+#endif
+// eon_hooks end: fused
 #if defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX) || defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX_GNU)
 constexpr int kTensorArenaSize = 3232;
+// eon_hooks begin: fused
+#elif defined(EI_EON_FUSED_GRAPH)
+constexpr int kTensorArenaSize = kFusedTensorArenaSize;
+// eon_hooks end: fused
 #else
 constexpr int kTensorArenaSize = 2208;
 #endif
@@ -124,7 +160,10 @@ template <int SZ, class T> struct TfArray {
 };
 
 enum used_operators_e {
-  OP_RESHAPE, OP_CONV_2D, OP_MAX_POOL_2D, OP_FULLY_CONNECTED, OP_SOFTMAX,  OP_LAST
+// eon_hooks begin: fused
+// eon_hooks was:   OP_RESHAPE, OP_CONV_2D, OP_MAX_POOL_2D, OP_FULLY_CONNECTED, OP_SOFTMAX,  OP_LAST
+  OP_RESHAPE, OP_CONV_2D, OP_MAX_POOL_2D, OP_FULLY_CONNECTED, OP_SOFTMAX, OP_CONV_2D_MAX_POOL_2D,  OP_LAST
+// eon_hooks end: fused
 };
 
 struct TensorInfo_t { // subset of TfLiteTensor used for initialization from constant memory
@@ -324,6 +363,20 @@ const TfArray<1, int> inputs11 = { 1, { 24 } };
 const TfArray<1, int> outputs11 = { 1, { 25 } };
 };
 
+// eon_hooks begin: prepacked
+// Filters packed for the int8 GEMM kernels ahead of time, by tools/eon_prepack
+// (which compiles this file itself without them)
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM && !defined(EI_EON_PREPACK)
+#ifdef __has_include
+#if __has_include("tflite-model/tflite_learn_855743_3_prepacked.h")
+#include "tflite-model/tflite_learn_855743_3_prepacked.h"
+#define EI_EON_PREPACKED_FILTERS 1
+static_assert(kPrepackedModelChecksum == kEonModelChecksum,
+  "tflite-model/tflite_learn_855743_3_prepacked.h was made from another export of the model, run tools/eon_prepack/build.sh");
+#endif
+#endif // __has_include
+#endif
+// eon_hooks end: prepacked
 TensorInfo_t tensorData[] = {
 { kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 640), (TfLiteIntArray*)&g0::tensor_dimension0, 637, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data1, (TfLiteIntArray*)&g0::tensor_dimension1, 16, {kTfLiteNoQuantization, nullptr}, },
@@ -393,6 +446,60 @@ used_operators_e used_ops[] =
 const size_t tflTensors_subgraph_index[] = {0, 26, };
 const size_t tflNodes_subgraph_index[] = {0, 12, };
 
+// eon_hooks begin: fused
+// The nodes init and invoke run: tflNodes, or the fused graph
+struct Graph_t {
+  TfLiteNode* nodes;
+  used_operators_e* ops;
+  const size_t* subgraph_index;
+  size_t node_count;
+};
+
+static Graph_t graph = { tflNodes, used_ops, tflNodes_subgraph_index, sizeof(tflNodes) / sizeof(tflNodes[0]) };
+
+#ifdef EI_EON_FUSED_GRAPH
+const size_t kFusedNodeCount = sizeof(fused_nodes) / sizeof(fused_nodes[0]);
+static TfLiteNode fusedNodes[kFusedNodeCount];
+static used_operators_e fused_used_ops[kFusedNodeCount];
+
+// Builds the fused graph's nodes and moves the tensors to its memory plan.
+// Tensors it no longer stores (folded into a fused node) are left without data.
+static void init_fused_graph() {
+  for (size_t i = 0; i < kFusedNodeCount; ++i) {
+    const FusedNodeInfo_t& info = fused_nodes[i];
+    fusedNodes[i] = tflNodes[info.node];
+    fused_used_ops[i] = used_ops[info.node];
+    if (info.outputs) {
+      fusedNodes[i].outputs = const_cast<TfLiteIntArray*>(info.outputs);
+    }
+    if (info.conv_max_pool) {
+      fusedNodes[i].builtin_data = const_cast<ConvMaxPoolParams*>(info.conv_max_pool);
+      fused_used_ops[i] = OP_CONV_2D_MAX_POOL_2D;
+    }
+  }
+
+  for (size_t i = 0; i < sizeof(fused_tensor_offsets) / sizeof(fused_tensor_offsets[0]); ++i) {
+    TensorInfo_t& tensor = tensorData[fused_tensor_offsets[i][0]];
+    const int32_t offset = fused_tensor_offsets[i][1];
+    if (offset < 0) {
+      tensor.allocation_type = kTfLiteMmapRo;
+      tensor.data = nullptr;
+      continue;
+    }
+#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
+    tensor.data = (void*)(uintptr_t)offset;
+#else
+    tensor.data = tensor_arena + offset;
+#endif
+  }
+
+  graph.nodes = fusedNodes;
+  graph.ops = fused_used_ops;
+  graph.subgraph_index = fused_nodes_subgraph_index;
+  graph.node_count = kFusedNodeCount;
+}
+#endif // EI_EON_FUSED_GRAPH
+// eon_hooks end: fused
 // Input/output tensors
 static const int in_tensor_indices[] = {
   0, 
@@ -658,6 +765,11 @@ TfLiteStatus tflite_learn_855743_3_init( void*(*alloc_fnc)(size_t,size_t) ) {
   ctx.GetEvalTensor = &GetEvalTensorImpl;
   ctx.ReportError = &MicroContextReportOpError;
 
+// eon_hooks begin: fused
+#ifdef EI_EON_FUSED_GRAPH
+  init_fused_graph();
+#endif
+// eon_hooks end: fused
   ctx.tensors_size = 26;
   for (size_t i = 0; i < 26; ++i) {
     TfLiteTensor tensor;
@@ -680,23 +792,46 @@ TfLiteStatus tflite_learn_855743_3_init( void*(*alloc_fnc)(size_t,size_t) ) {
   registrations[OP_MAX_POOL_2D] = Register_MAX_POOL_2D();
   registrations[OP_FULLY_CONNECTED] = Register_FULLY_CONNECTED();
   registrations[OP_SOFTMAX] = Register_SOFTMAX();
+// eon_hooks begin: fused
+#if defined(EI_EON_FUSED_GRAPH) || defined(EI_EON_FUSE)
+  registrations[OP_CONV_2D_MAX_POOL_2D] = Register_CONV_2D_MAX_POOL_2D();
+#endif
+// eon_hooks end: fused
 
   for (size_t g = 0; g < 1; ++g) {
     current_subgraph_index = g;
-    for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
-      if (registrations[used_ops[i]].init) {
-        tflNodes[i].user_data = registrations[used_ops[i]].init(&ctx, (const char*)tflNodes[i].builtin_data, 0);
+// eon_hooks begin: fused
+// eon_hooks was:     for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
+// eon_hooks was:       if (registrations[used_ops[i]].init) {
+// eon_hooks was:         tflNodes[i].user_data = registrations[used_ops[i]].init(&ctx, (const char*)tflNodes[i].builtin_data, 0);
+    for(size_t i = graph.subgraph_index[g]; i < graph.subgraph_index[g+1]; ++i) {
+      if (registrations[graph.ops[i]].init) {
+        graph.nodes[i].user_data = registrations[graph.ops[i]].init(&ctx, (const char*)graph.nodes[i].builtin_data, 0);
+// eon_hooks end: fused
       }
     }
   }
   current_subgraph_index = 0;
 
+// eon_hooks begin: prepacked
+#ifdef EI_EON_PREPACKED_FILTERS
+  tflite::optimized_integer_ops::int8_gemm::PrepackedFiltersScope prepacked(prepacked_filters,
+    sizeof(prepacked_filters) / sizeof(prepacked_filters[0]));
+#endif
+// eon_hooks end: prepacked
   for(size_t g = 0; g < 1; ++g) {
     current_subgraph_index = g;
-    for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
-      if (registrations[used_ops[i]].prepare) {
+// eon_hooks begin: fused
+// eon_hooks was:     for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
+// eon_hooks was:       if (registrations[used_ops[i]].prepare) {
+    for(size_t i = graph.subgraph_index[g]; i < graph.subgraph_index[g+1]; ++i) {
+      if (registrations[graph.ops[i]].prepare) {
+// eon_hooks end: fused
         ResetTensors();
-        TfLiteStatus status = registrations[used_ops[i]].prepare(&ctx, &tflNodes[i]);
+// eon_hooks begin: fused
+// eon_hooks was:         TfLiteStatus status = registrations[used_ops[i]].prepare(&ctx, &tflNodes[i]);
+        TfLiteStatus status = registrations[graph.ops[i]].prepare(&ctx, &graph.nodes[i]);
+// eon_hooks end: fused
         if (status != kTfLiteOk) {
           return status;
         }
@@ -719,16 +854,26 @@ TfLiteStatus tflite_learn_855743_3_output(int index, TfLiteTensor *tensor) {
 }
 
 TfLiteStatus tflite_learn_855743_3_invoke() {
-  for (size_t i = 0; i < 12; ++i) {
+// eon_hooks begin: fused
+// eon_hooks was:   for (size_t i = 0; i < 12; ++i) {
+  for (size_t i = 0; i < graph.node_count; ++i) {
+// eon_hooks end: fused
     ResetTensors();
 
-    TfLiteStatus status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);
+// eon_hooks begin: fused
+// eon_hooks was:     TfLiteStatus status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);
+    TfLiteStatus status = registrations[graph.ops[i]].invoke(&ctx, &graph.nodes[i]);
+// eon_hooks end: fused
 
 #if EI_CLASSIFIER_PRINT_STATE
     ei_printf("layer %lu\n", i);
     ei_printf("    inputs:\n");
-    for (size_t ix = 0; ix < tflNodes[i].inputs->size; ix++) {
-      auto d = tensorData[tflNodes[i].inputs->data[ix]];
+// eon_hooks begin: fused
+// eon_hooks was:     for (size_t ix = 0; ix < tflNodes[i].inputs->size; ix++) {
+// eon_hooks was:       auto d = tensorData[tflNodes[i].inputs->data[ix]];
+    for (size_t ix = 0; ix < graph.nodes[i].inputs->size; ix++) {
+      auto d = tensorData[graph.nodes[i].inputs->data[ix]];
+// eon_hooks end: fused
 
       size_t data_ptr = (size_t)d.data;
 
@@ -755,8 +900,12 @@ TfLiteStatus tflite_learn_855743_3_invoke() {
     ei_printf("\n");
 
     ei_printf("    outputs:\n");
-    for (size_t ix = 0; ix < tflNodes[i].outputs->size; ix++) {
-      auto d = tensorData[tflNodes[i].outputs->data[ix]];
+// eon_hooks begin: fused
+// eon_hooks was:     for (size_t ix = 0; ix < tflNodes[i].outputs->size; ix++) {
+// eon_hooks was:       auto d = tensorData[tflNodes[i].outputs->data[ix]];
+    for (size_t ix = 0; ix < graph.nodes[i].outputs->size; ix++) {
+      auto d = tensorData[graph.nodes[i].outputs->data[ix]];
+// eon_hooks end: fused
 
       size_t data_ptr = (size_t)d.data;
 
@@ -0,0 +1,49 @@
+// Generated by tools/eon_fuse, do not edit. Run it again after re-exporting the model
+// (and after tools/eon_prepack). The model's graph with RESHAPEs folded and
+// CONV_2D + MAX_POOL_2D fused, included by the compiled model.
+// 12 -> 5 nodes, arena 3280 -> 2880 bytes (tensors 1280 -> 848, persistent 2000 -> 2032)
+
+// kEonModelChecksum of the export it was made from, the model doesn't build with another
+constexpr uint32_t kFusedModelChecksum = 0x3fabdb34u;
+
+const int kFusedTensorArenaSize = 2880;
+
+// node 1 CONV_2D + node 3 MAX_POOL_2D, pooling window in the convolution's axes
+const ConvMaxPoolParams fused_opdata1 = {
+  { kTfLitePaddingSame, 1,1, kTfLiteActRelu, 1,1 },
+  { kTfLitePaddingSame, 2,1, 2,1, kTfLiteActNone, { { 0,0, 0, 0 } } },
+};
+const FusedIntArray<1> fused_outputs1 = { 1, { 17 } };
+
+// node 5 CONV_2D + node 7 MAX_POOL_2D, pooling window in the convolution's axes
+const ConvMaxPoolParams fused_opdata5 = {
+  { kTfLitePaddingSame, 1,1, kTfLiteActRelu, 1,1 },
+  { kTfLitePaddingSame, 2,1, 2,1, kTfLiteActNone, { { 0,0, 0, 0 } } },
+};
+const FusedIntArray<1> fused_outputs5 = { 1, { 21 } };
+
+const FusedNodeInfo_t fused_nodes[] = {
+  { 1, (const TfLiteIntArray*)&fused_outputs1, &fused_opdata1 },
+  { 5, (const TfLiteIntArray*)&fused_outputs5, &fused_opdata5 },
+  { 9, nullptr, nullptr },
+  { 10, nullptr, nullptr },
+  { 11, nullptr, nullptr },
+};
+const size_t fused_nodes_subgraph_index[] = {0, 5, };
+
+// { tensor, arena offset }, -1: not stored any more
+const int32_t fused_tensor_offsets[][2] = {
+  { 0, 0 },
+  { 14, 0 },
+  { 15, -1 },
+  { 16, -1 },
+  { 17, 640 },
+  { 18, 640 },
+  { 19, -1 },
+  { 20, -1 },
+  { 21, 0 },
+  { 22, 0 },
+  { 23, 208 },
+  { 24, 16 },
+  { 25, 0 },
+};
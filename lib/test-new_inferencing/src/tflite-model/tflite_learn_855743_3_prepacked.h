@@ -0,0 +1,282 @@
+// Generated by tools/eon_prepack, do not edit. Run it again after re-exporting the model.
+// int8 CONV_2D / FULLY_CONNECTED filters in the int8 GEMM layout
+// (edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h),
+// included by the compiled model.
+
+// kEonModelChecksum of the export it was made from, the model doesn't build with another
+constexpr uint32_t kPrepackedModelChecksum = 0x3fabdb34u;
+
+// node 1, CONV_2D, 8 x 39 from tensor 13
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int32_t prepacked_corrections1[8] = {
+  1167, 4401, 5276, -4362, -237, -3554, 1845, -9706,
+};
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int8_t prepacked_weights1[384] = {
+  -6, 48, 36, 77, -23, 30, 11, -41, -14, 61, 50, -127, 31, -31, -103, 28, -95, -43, 17, 30, -39, 6, 5, 27, -19, -34, -49, -6, 58, -79, 43, 32,
+  31, 44, -127, -56, -57, -12, -18, 9, -35, 83, 55, 0, 26, -103, -43, -64, 25, 17, -76, -95, 5, 16, -4, 98, 62, -112, -99, -127, -98, 87, 54, -57,
+  50, 1, -15, -93, -20, -65, 115, 39, 68, -22, 42, -122, 30, -15, -113, 87, -46, 9, 22, 108, 2, 4, -6, -6, 23, -57, -50, -36, 2, 24, 18, -127,
+  17, -31, 70, -2, 23, -83, 12, 17, 11, -20, -109, -70, -82, -125, -60, 33, 71, -10, 56, 17, 17, 22, 28, 96, 57, 72, 123, 30, -57, -9, 77, 103,
+  47, -65, -75, -26, 21, 1, 78, 0, 0, 0, 0, 0, 0, 0, 0, 0, -30, -35, 16, -11, -49, -63, -46, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -102, 25, 58, 31, -11, -64, -8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 89, 64, 51, 11, -68, -65, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  112, 43, 19, 60, -29, -11, 69, 89, 17, -62, -93, 31, 48, 122, 64, 55, 67, 79, -48, 89, 20, 8, -15, -15, -28, 27, 4, -72, -17, 113, 72, -48,
+  100, 127, -27, 2, -52, -53, -110, -44, -121, -119, 9, -23, -30, -42, -1, -18, 35, 80, 68, 91, 98, 2, -40, 54, 30, 8, 64, -46, 90, -53, 54, 43,
+  -73, -105, -102, -5, -2, -38, -57, -61, -44, -48, 29, 57, 39, -52, -127, -32, 45, -16, -9, 4, -11, -84, 50, -61, -73, -55, 88, 111, -127, 112, -53, 45,
+  0, 34, 74, 25, -12, 58, 40, 127, 10, 8, 60, -49, 30, -62, -59, -57, 50, 127, -37, -8, -16, 53, -3, 4, 70, 34, -1, 105, 78, 27, 36, -25,
+  38, -4, 36, -51, -20, 46, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 25, -3, -4, -42, 13, -108, 72, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -27, -74, -34, 9, -79, 14, -27, 0, 0, 0, 0, 0, 0, 0, 0, 0, 21, 21, 26, 4, 67, -9, 91, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+// node 5, CONV_2D, 16 x 24 from tensor 11
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int32_t prepacked_corrections5[16] = {
+  36146, 11689, -7213, -67277, -71749, -77062, -14055, -7000, 10730, -64099, -85857, -29430, 569, -85217, -44401, -61791,
+};
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int8_t prepacked_weights5[512] = {
+  -41, 63, 93, 121, -72, -52, 24, 67, -46, 48, -36, -81, -14, 65, 83, -85, -26, 46, -23, 127, -69, -106, -22, 7, -52, -42, -36, 47, 79, 87, 74, 85,
+  34, -33, -64, 12, -26, 16, 29, 77, 97, -11, 34, 48, -13, -112, 0, 97, -70, -126, -82, -52, 75, 20, -89, 47, -87, -55, -118, -11, 55, 40, -56, 66,
+  -37, 86, 7, 42, -31, -57, 127, 11, 0, 0, 0, 0, 0, 0, 0, 0, 72, 27, 10, -84, -36, -77, 41, -34, 0, 0, 0, 0, 0, 0, 0, 0,
+  -127, 55, -9, -122, -75, -21, 94, -33, 0, 0, 0, 0, 0, 0, 0, 0, -127, -34, -98, -32, 96, 39, 53, 32, 0, 0, 0, 0, 0, 0, 0, 0,
+  -64, -57, -127, -89, -55, -68, -35, 68, -70, -1, -45, -81, -78, 48, 25, 41, -98, 73, 22, -7, -64, -94, -67, 39, -127, 50, -18, -74, -40, 0, -59, -13,
+  56, -71, -42, 32, -21, 106, 67, 20, 89, -126, 41, -51, -17, 29, 56, 32, -22, 27, -30, -127, -108, 1, 6, -71, 30, 30, -4, 64, 53, 43, 27, 3,
+  38, -2, 61, -114, -113, 88, 11, 61, 0, 0, 0, 0, 0, 0, 0, 0, -101, 67, 28, 12, -51, -24, -84, 20, 0, 0, 0, 0, 0, 0, 0, 0,
+  -11, -127, -41, 70, -3, 14, -99, -112, 0, 0, 0, 0, 0, 0, 0, 0, 16, -12, -76, 8, 32, 25, 64, -29, 0, 0, 0, 0, 0, 0, 0, 0,
+  90, -59, 127, 44, -14, -59, 95, 29, -45, -48, -62, 88, 84, -122, -93, 64, -6, -127, -32, 10, -35, 99, 38, -6, -63, -127, -99, -29, -38, 77, 2, -11,
+  -85, -96, -92, 37, -5, 43, 33, -11, -127, -75, -71, 28, -63, 8, -30, 21, -51, 36, -117, 90, 27, 58, -69, -83, -25, -34, 65, 21, 127, -29, 29, -9,
+  -15, -51, 84, 59, -26, -35, -7, -34, 0, 0, 0, 0, 0, 0, 0, 0, -72, -84, -91, 54, -12, 56, -34, 39, 0, 0, 0, 0, 0, 0, 0, 0,
+  -87, -113, -30, 76, -87, 44, -59, 76, 0, 0, 0, 0, 0, 0, 0, 0, 9, -19, -21, 56, -120, -54, -38, -78, 0, 0, 0, 0, 0, 0, 0, 0,
+  -68, 85, -121, 70, -45, 54, 106, 26, 82, -2, -113, -8, -86, 67, -60, -22, 26, 17, 21, -36, -121, 26, -110, -125, 50, 43, -8, -6, -127, -48, -46, -106,
+  8, -7, 44, -33, -56, -5, 4, -40, -6, 16, 59, 3, -26, -39, -11, -51, -18, 31, -65, -72, 18, -21, -37, 105, -22, -52, 49, -67, -25, -85, -61, 85,
+  52, 18, 40, 53, 18, -127, -33, 18, 0, 0, 0, 0, 0, 0, 0, 0, -19, 16, 72, 17, -18, -89, -121, 12, 0, 0, 0, 0, 0, 0, 0, 0,
+  22, -127, 6, 54, -40, -86, -29, -3, 0, 0, 0, 0, 0, 0, 0, 0, -44, -65, 63, -72, -127, -57, -12, 68, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+// node 9, FULLY_CONNECTED, 32 x 208 from tensor 9
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int32_t prepacked_corrections9[32] = {
+  45355, -133025, -251240, 262596, -95305, -151695, -102637, 126080, -138599, -128382, -131870, -31414, -261914, -90386, 32254, -64990, 193476, 54773, -147528, 48311, 74953, -149954, -338427, -96544, -117181, -194246, -183275, 1593, -204062, -146935, -3577, -249164,
+};
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int8_t prepacked_weights9[6656] = {
+  20, 13, -8, 6, 51, 40, 31, -50, 5, -1, -4, -27, 29, 20, 40, 101, -1, 25, 9, -14, -9, -59, -24, 26, -2, -35, -29, 82, -6, -44, -10, 24,
+  -37, -2, 18, -30, -25, -4, 12, 8, -1, -28, -10, -25, -8, -8, 17, 9, -4, 6, 0, -19, 33, 14, -8, 26, -15, -13, -35, 27, 4, -10, -27, -28,
+  0, 28, 16, 47, 59, -6, 37, -13, -3, -6, 20, -80, -1, 45, 49, 30, 13, 38, 29, -51, 8, -49, 3, 13, 57, -16, -28, 51, 28, -48, -14, -13,
+  -1, -29, 17, 1, -26, -17, 9, -27, -33, 7, 5, -22, -31, -4, -6, -12, 10, 11, 22, -30, 22, 30, 28, 28, -12, 25, -22, 43, -1, -9, -43, 23,
+  -18, 8, 32, 54, 12, 14, -8, 15, 13, -26, 13, -35, -4, 17, 8, -4, 13, 37, 36, -41, 34, -12, 10, -19, 18, -17, -27, 21, 26, -44, 20, 28,
+  6, -5, -19, -17, -24, -24, -29, -14, -16, -12, -31, -34, -19, 6, -3, 20, 18, 9, 5, -31, 50, -4, 30, 15, -21, 3, 5, -30, 23, 26, -5, -3,
+  -40, 25, -1, 39, 4, -2, 7, -16, 0, 33, 67, -22, -40, 36, 17, 24, -6, 20, -1, -55, 31, 3, -7, 8, 17, 4, -13, 21, 31, -23, 3, -58,
+  -18, -30, 13, -6, -11, 12, 19, -39, -20, -18, 16, 10, -24, -29, -8, -19, 17, -3, 4, -18, 44, 22, 23, 24, 9, -1, -8, 0, 5, -31, 9, 22,
+  -18, -9, 11, 42, 35, -10, 5, -26, -13, 51, 105, 13, 2, -34, 10, 13, -27, 26, -15, -37, 27, -29, 2, 10, 25, -37, -19, 11, 16, -18, 5, -26,
+  -25, -41, -22, -38, -18, -20, -21, -26, 11, -3, -12, -17, -10, -13, -19, 17, 27, -3, 4, -12, 30, -7, 56, -13, 11, 2, -24, 23, 40, -24, 19, 28,
+  -31, 16, -27, 43, -7, 28, 52, 17, -14, 7, 57, 3, -2, -26, 11, -14, 1, 53, -6, -11, -70, -33, -17, 17, 22, -75, -74, -4, -10, -34, 17, -19,
+  -5, 0, -6, 0, 10, 9, 0, -27, -3, -28, -25, -35, -21, -25, -7, -30, -4, 36, 43, -28, 28, -24, 49, 1, 0, 9, 10, 20, 40, -9, -3, 10,
+  -6, 5, 19, 53, 16, -19, 43, -8, 4, 1, 16, 11, -14, -3, -20, 81, 38, -36, -14, -47, 16, -36, -32, -10, -11, -15, -36, -8, 25, -71, -17, 18,
+  -30, -14, -20, -28, 20, 15, -37, -31, -25, -11, -2, -4, -16, 1, -17, 29, 1, -8, 8, -4, 27, 51, -3, 18, 13, 1, 27, 37, 59, 4, -29, 50,
+  -72, -62, -6, -21, -7, 20, 12, 15, 4, 9, 9, -7, -52, 3, -34, 26, 32, -3, 44, -27, 31, 9, -27, 2, 25, -47, -36, 1, 6, 18, 8, 63,
+  5, 12, 12, -31, -5, 18, -10, -29, 5, -26, -15, -10, -1, -23, -19, 6, 46, 14, 16, -20, 127, 28, 2, -9, -16, 19, 8, 27, 25, -8, -4, 51,
+  -47, -21, -5, 49, -45, 11, -7, 4, -23, 2, -5, -23, -3, 42, -14, 40, 31, 35, 18, -71, -31, -58, -1, 12, 12, -28, -57, 7, 10, -12, 10, -52,
+  -31, -9, 8, 7, -20, 6, -1, -5, -4, 11, 13, 12, 21, -9, 9, -4, 39, -9, 13, -31, 66, 6, 42, 23, 10, 0, -13, 23, 12, -26, 6, 50,
+  -1, 15, -40, 37, 18, -21, -81, -10, -19, -14, 12, 39, -38, 32, -40, -3, 8, -27, -41, -24, -3, 19, 14, 12, 9, -49, -60, 57, 24, -37, 48, -45,
+  3, 13, -20, 7, 28, 8, -26, -11, -36, -36, -17, 24, 16, -12, -37, -14, 43, 24, 5, -37, 46, -19, 83, 7, 41, -6, -26, -10, 51, -9, -1, -14,
+  -9, -50, -12, -23, -14, -23, -15, -2, -32, 3, -36, 23, -13, 62, 20, -29, 36, 36, -8, -24, -37, 3, 32, 3, 16, -9, -24, -10, 30, -22, -5, -57,
+  -38, -29, -23, -35, -12, -38, -1, -23, -21, -14, -4, -17, -22, -16, 10, -2, 3, -5, -25, -55, 26, 8, 39, 22, -6, 26, 40, 13, 45, -56, 5, -28,
+  -16, -55, -21, -56, -44, 62, -34, -12, -37, -26, -67, -36, -15, 40, 21, -28, 3, 32, 6, -45, -15, 0, 46, 1, -7, -32, -45, 22, 17, -43, -51, -53,
+  -4, -24, -1, -2, -32, 17, 13, -33, -23, 9, -9, 12, -18, 5, -17, -21, 18, 49, 2, 18, 30, 9, 16, 13, 0, 7, 26, -6, 65, -10, -25, 4,
+  33, -22, -13, 6, 35, 78, -39, 0, -27, -34, -32, -56, -75, 94, 52, -28, -25, 27, -16, -13, -42, -50, -46, 1, 67, -19, 26, 16, 32, -33, -66, 30,
+  -3, 9, -9, -2, 20, 0, -23, -1, 17, 4, -5, -30, 17, -10, -22, -21, -2, 39, 43, 12, -12, 35, -11, 35, -12, 2, 2, 36, 59, -29, -19, 35,
+  10, 4, 5, 3, 14, -26, 14, -24, -25, -11, 5, 22, 11, -6, 19, 9, -14, -3, -2, -3, -16, 1, 13, 3, -7, -10, -18, 7, -5, 9, -20, -2,
+  15, -26, -6, -48, 8, -4, 18, 3, -4, 2, -19, -47, -22, 17, -39, -67, 1, 24, 7, -18, -10, -5, 8, 26, -15, -9, 7, 10, 39, -14, -45, 33,
+  10, 9, -19, 20, 7, 9, -6, -1, -20, 14, -4, -4, -1, 5, 16, 14, 2, -8, -17, -17, 11, -9, 16, 13, 4, -25, -26, 24, -2, -2, 11, -29,
+  -18, -10, -23, -23, -28, 12, -25, 10, -7, -17, -39, -4, -19, -12, -4, -60, 17, 76, 34, -51, -2, -30, 46, -15, 1, -16, -12, 53, 53, -5, -45, 42,
+  -17, 6, -8, -1, 13, -7, -15, -28, -17, -18, 18, -18, 12, -24, -21, -24, 1, 4, 9, 1, 8, 8, 3, 14, -8, 9, -5, 5, -8, -3, -6, 5,
+  15, -44, 0, -34, -23, 29, -11, -21, -35, 23, -1, -67, -13, 3, -1, -53, 41, 44, 12, -34, 18, -18, 22, 5, 3, 22, 19, 19, 30, -7, 4, 40,
+  17, 9, 0, 0, -14, -26, -4, 17, -27, -6, -5, 10, -28, -12, -14, 16, 16, 0, 11, -18, -5, 12, -14, -1, -24, -30, -35, -2, -12, 3, -16, -9,
+  16, -31, 23, -9, -31, 17, -36, 12, -32, -6, -23, -19, -47, 31, -10, 5, -14, 5, 9, -52, 19, 9, 13, -16, -22, 5, 12, -2, 55, -30, -17, 1,
+  7, 4, 1, -12, 8, -6, -31, 11, -20, -22, 18, 10, -14, 11, -31, -17, 6, -18, -7, -12, 11, 10, -27, -2, 3, 11, -5, 11, -20, 8, 23, 2,
+  -4, -21, 15, -28, -12, 24, -59, -19, -39, 7, -16, -50, -38, 6, -10, 26, -18, 25, 4, -64, 27, -46, 58, 33, 1, -33, -30, -6, 42, -58, -51, 47,
+  -6, 18, 13, 15, -12, -28, -17, -11, 11, 4, 13, 11, -22, -23, 1, -7, -23, -23, 10, 0, 24, 19, -26, -6, -32, -19, -11, 6, 5, -23, -5, 6,
+  -37, -47, -17, 30, -19, -4, 8, -20, -20, -4, -19, 12, -47, 5, 16, -46, 42, 55, 20, -31, 15, -2, 15, -8, 23, 12, -34, 60, 16, -39, 9, -26,
+  -22, 6, 16, -28, 13, 12, -25, 15, 14, -19, -31, 3, -11, 2, -22, -29, -1, 13, -32, 3, -28, -18, 24, -3, -35, -24, 19, -29, -4, -13, -13, 7,
+  -40, -41, -30, 32, 14, 9, -15, 17, -17, 13, -2, 8, -21, -1, 0, -7, 16, -32, -43, -28, -53, 9, -18, -7, 29, -39, -48, 5, -8, 35, -2, 55,
+  1, 1, -14, 18, -16, 11, -23, 14, -3, -22, 12, 8, -13, -13, -10, 5, -25, -22, -19, -14, -24, 0, 5, 18, -7, -26, 15, -27, -4, -27, 7, -16,
+  -31, 15, -24, 25, 28, 0, 11, 26, 12, -17, 4, 17, 4, -34, -17, 21, -7, 7, 30, -48, 20, 30, -9, -24, -18, -48, -14, -8, 16, 19, -23, 34,
+  -12, -12, 16, 21, 6, 13, -6, -27, -17, 18, 15, -22, 11, 4, -11, 16, -3, -13, -16, -27, 10, 10, -4, 8, -8, 2, 18, 3, 0, -30, -4, 15,
+  -32, 17, 5, 21, 52, -13, 49, -5, 14, 29, 11, 21, -2, -7, 13, 5, 16, 35, 14, -33, 46, -19, 29, -24, -5, -30, 38, 18, 28, 5, 2, 84,
+  -14, -27, 14, -4, -5, 13, 14, -13, -31, 13, -7, -15, -12, -18, 18, 8, -6, 20, -5, 5, 1, -21, -17, 17, -27, -1, -22, -26, -8, -18, -20, -5,
+  9, -22, 12, -1, 31, -9, 24, 16, 27, 45, 45, -9, 36, -23, -15, 23, 40, 25, 19, -36, 5, 27, 81, 53, 17, -64, -62, 52, 36, -6, -19, -50,
+  -30, -7, -4, 1, -21, 16, -6, 19, 3, 19, -24, -27, 9, -24, -8, 18, -18, -21, -30, -16, 17, -10, -1, 14, -16, 0, 0, -3, -5, -16, 1, 7,
+  -29, -11, -32, -8, 25, 19, 36, -12, -1, 33, 31, -4, 25, -37, -22, 96, 0, 54, 34, -50, -32, -17, 28, 14, 61, 13, -25, 60, 35, -11, -28, 7,
+  -28, -7, -18, -8, 5, 18, -32, -13, 0, -12, 12, 6, -10, 8, 15, -3, -6, -28, 9, -27, -20, -26, -13, -2, -21, 16, -5, -21, -21, -7, -31, -19,
+  18, -8, 17, 1, 12, -2, -24, -26, 9, 12, 17, 0, 17, -8, 16, 78, 14, 51, 30, -39, 78, 2, 5, 2, -20, 15, 4, -39, 44, -7, -10, 44,
+  21, -9, -32, 15, -13, -30, 16, 0, -20, -31, 23, -22, -16, 0, -15, -28, 3, 6, -5, 4, -20, -1, -5, -9, 2, -21, -2, -14, 3, -18, 11, -14,
+  -5, -25, 13, 5, 72, -21, 31, 11, -54, 18, -28, -49, -31, -40, 9, 15, 23, 45, 8, -40, -73, 41, -2, -4, 11, 3, 58, 9, 51, -49, -63, 61,
+  18, 5, -30, 14, -21, -2, 12, 7, -22, -4, 0, 16, 3, -29, -13, 5, -28, 13, 2, -13, 3, -13, 18, 11, 17, 7, -15, -12, 13, -18, -13, 14,
+  -25, 35, -23, -33, -10, -31, -32, 31, 8, -4, -42, 82, 4, -42, -36, -51, 14, 1, -18, 37, 6, 36, 22, -55, 60, 10, 37, -29, -29, 57, 30, 71,
+  -27, -5, 4, 0, 19, 8, -23, -11, 0, -25, -21, -18, -31, -12, -10, -29, -22, -4, 10, -2, -29, 12, -12, -24, 21, -31, 5, -17, 10, -1, 1, -18,
+  22, 29, -4, -30, -8, -16, -41, 27, 26, -21, -27, 45, 65, -13, 11, -16, 18, 28, -12, 56, 31, 39, 22, -12, 28, 15, 4, -73, -54, 52, 15, -34,
+  11, 15, -2, -3, -1, -23, -2, -3, -9, 8, 28, -19, -23, 14, -12, -23, -11, -25, 16, 12, -8, -19, 3, -7, -26, -2, -2, 13, 14, -13, 2, -7,
+  -2, 52, 26, -48, 22, -34, 2, 11, 29, -15, -20, 4, 19, -37, -9, -20, -28, -6, 3, 60, -16, 57, 2, -4, 16, 32, 47, -3, -10, 39, 29, 0,
+  16, -5, -25, -30, -5, -2, -7, 5, 14, 17, -11, -30, 15, -21, -16, 6, -4, 6, -17, 17, -13, -4, 12, 10, 15, 8, -10, -23, -8, -14, -13, 7,
+  -3, 6, 19, -78, 22, -6, 32, 5, 16, -19, -47, 25, 11, -37, -15, -33, -12, 15, 28, 37, -19, -21, -23, -1, 12, 38, 39, -14, 7, 52, 25, 71,
+  -25, -9, 8, -30, 24, 12, -13, -7, 12, -13, 7, -21, -22, 14, -2, 8, -23, -28, -23, -6, 14, -27, 8, 13, 2, -28, 15, -7, -15, 19, 3, 11,
+  4, 3, -1, -40, 3, -35, 28, 5, -8, -18, -21, -3, 26, 22, -8, 28, -40, 38, 55, 54, -12, -51, 13, -6, -2, 30, 50, -18, -15, 46, 70, 38,
+  -2, -18, 15, -22, 0, 18, 17, -2, -12, -16, 15, 2, -24, -8, 4, 9, -8, 5, -20, 7, -5, 0, -23, 5, 15, 14, -9, 5, -26, 16, -18, 8,
+  25, 48, 14, -47, -18, 8, -8, 22, 16, -23, -45, 28, 2, -54, -8, -66, -31, 1, -34, 72, 13, -28, -8, 23, -6, 5, 9, -57, -21, 58, 13, 10,
+  -28, 7, -8, -29, -19, -11, 20, 4, -13, -29, 12, -15, 6, 8, -7, 15, -28, -24, 19, -34, 7, -26, 0, -20, -6, -20, 10, -34, -8, -22, -20, 7,
+  29, -14, -29, -25, 21, -6, -43, -13, 1, -29, 21, -26, 25, -49, -40, -7, -31, -31, -11, 33, -30, 19, 2, -18, -8, -11, 4, 0, -23, 28, 9, 7,
+  -4, 14, -4, -16, 9, -12, -25, -18, -15, 15, 10, -19, 4, -6, 4, 18, -18, -11, -15, -20, -20, -23, -4, -5, -10, -13, 11, -32, -12, -16, -15, -13,
+  44, 22, 37, -7, 38, -32, -12, 4, -18, -17, -6, 5, 11, -42, 16, 17, -42, -6, -74, 16, -11, -11, -8, -5, -39, 0, -22, -10, -38, 35, 46, 19,
+  4, 2, -15, -1, -12, 12, -27, 13, -13, -8, -26, 18, -9, -7, -19, -9, -2, -7, -22, -10, -23, 0, -12, -23, 17, -8, -18, -14, -22, -24, 21, 4,
+  24, 21, 45, -30, 13, -57, -2, 17, -9, -22, -32, 5, 4, -61, -2, -9, -15, -62, -19, 17, -1, 22, -24, -28, 13, -62, -56, 10, -30, 23, 13, 13,
+  -29, 9, 15, 15, 9, -9, 0, -11, -29, -1, 23, 13, 18, 4, 8, 2, 0, -15, -7, -18, -15, 1, -9, -1, -25, 10, 1, -7, -26, -20, 7, -26,
+  40, 18, 2, -25, -11, 46, 24, 28, 6, -38, -59, 20, 0, -28, 35, -47, -33, -36, -24, 50, -29, -42, -22, -45, -26, -6, -12, 10, -25, 26, -2, 60,
+  16, -26, -15, -5, -26, -27, -28, -16, 0, -2, -3, -27, 11, -24, 0, -28, -5, 8, -12, 13, -5, 17, 32, 14, -2, -21, -9, 16, 4, 12, -14, 19,
+  21, 14, 16, -50, -59, -22, 1, -2, 19, 1, -65, 28, 20, -28, -21, -95, 12, -37, 0, 2, 36, -2, -51, -70, 2, -94, -66, 21, -19, 28, 5, -28,
+  2, -23, -20, 9, -22, -17, 13, -13, -25, 16, 18, -17, -2, 12, -9, -23, -5, -21, 13, 4, 6, 21, -12, 7, -14, 22, 24, 9, 4, 6, -17, 9,
+  17, 37, -37, -17, -20, 1, 37, 41, -3, 5, -35, 21, 18, -57, -1, -43, 16, -53, -39, -23, -2, -3, -50, -43, -15, -57, -42, -40, -51, 41, 30, 19,
+  10, -24, 2, -1, -5, 16, -12, -15, -31, -29, -5, -10, -16, 13, -33, -22, -24, -9, -6, 4, 29, -24, -23, 5, -23, 17, 8, -25, -9, 1, -21, -4,
+  -43, -2, -19, -43, 9, -22, -13, -18, 46, -22, -6, 1, 41, -74, -29, -8, -10, -41, -28, -45, 40, -13, -5, -27, -24, -34, -25, -37, -41, 40, 41, -1,
+  -16, -20, -25, -1, -39, -22, 21, -38, 40, -24, 27, 48, 4, 13, 53, 32, -33, -1, 20, 8, -19, 17, 25, 10, 24, -18, 4, 15, -22, -28, 19, 3,
+  -3, -1, 33, -11, 2, 55, -32, -46, -58, -16, 34, -16, -13, 29, -23, -24, -5, 37, 13, -13, -3, -61, -5, -1, 18, 2, -25, 76, -16, -63, -24, 1,
+  -26, -13, 1, -6, 44, 1, -8, -50, 11, -50, 29, -41, -78, 16, 31, -9, -5, -19, 23, 2, -5, -2, 3, 16, -25, 9, -10, -14, 1, -15, 4, -14,
+  2, -26, 16, -66, -18, -11, -61, -4, -19, -16, -78, -48, -6, 9, -42, -57, 16, 41, -3, -38, -25, -42, -12, 26, 30, -49, -28, 62, 28, -66, -4, 36,
+  -1, 42, -9, 19, -64, 7, 27, -19, -10, -46, 0, -4, -19, -22, 26, -54, -26, 28, 22, -10, -2, 17, 8, -25, 16, -2, -17, 26, 13, -22, -9, 23,
+  -36, -33, -10, 8, -48, 13, -67, 3, -55, -23, -33, -64, 23, 56, -30, -6, 21, 55, 4, -72, -25, -13, -12, 20, -7, -43, -34, 38, 2, -76, -5, 2,
+  -1, 15, 4, 42, -30, -4, -24, -47, 32, -26, -14, -33, 1, -1, 38, -8, -16, 3, -25, -1, 1, 22, -26, -9, 0, 10, -6, -5, -22, -8, 16, 20,
+  -17, -45, -36, 23, 44, 37, 9, 24, -11, -7, -30, 24, -24, -4, 0, 1, 8, 12, 29, -55, 43, -12, 23, 16, 21, -14, -36, 50, 60, 18, -3, -45,
+  23, -21, 7, 8, 26, -18, -56, 8, -13, -35, 24, -70, -45, 25, 8, 51, -16, -22, 16, -28, 0, 6, -42, 1, -6, -1, 10, -12, -12, -8, -13, 23,
+  -8, 9, 1, 54, -36, 44, 18, -3, -19, 65, 41, 1, 10, 34, -16, 18, 9, -13, 10, -13, 0, -62, 14, 23, 51, -9, -58, 40, 19, 17, -16, -16,
+  9, -55, -32, 34, -40, 11, -55, -33, 12, -25, -32, 40, -16, 5, 43, 18, -17, -26, -6, 6, 29, 11, 6, 10, 8, -27, -12, -20, -20, 16, -13, 6,
+  -26, -39, -52, 66, 8, -12, 53, -11, -31, 71, 35, -51, 37, 48, 37, -3, 12, 49, 25, -40, -29, -4, 15, 20, 24, -60, -68, 2, -38, -19, 16, -51,
+  0, 26, -30, 12, -27, -48, -18, -39, -33, -1, -41, 28, -24, -8, 46, -54, 12, -9, 6, 12, 14, 6, -12, -9, -4, -20, 7, -29, 0, 7, -4, 12,
+  -2, -2, 12, 14, 9, 20, 26, 24, 2, 5, 32, 16, -6, 72, 14, 70, 43, 0, -17, -35, 15, -31, -28, -3, 21, -9, -27, -15, 9, -55, 5, -24,
+  -1, -2, -10, 23, -24, -3, -58, -23, -4, -26, 26, -18, -9, -10, -1, -34, 6, 18, -30, -31, 5, -6, -32, -25, 1, -12, 19, 0, -28, -14, -4, -3,
+  -14, -6, 16, 2, 65, 18, 27, 38, -4, -5, 7, 23, -20, 4, -4, 22, 48, 3, 40, -70, -15, 5, -43, -7, 18, -8, -28, 1, 11, 4, -5, 38,
+  -43, -9, 11, 11, -22, -16, -81, -26, 16, -18, -3, -22, -2, -63, -48, 16, -29, -15, -6, -8, 4, -9, 10, -18, 11, -8, 3, 19, 13, -39, -4, 0,
+  -11, -6, 9, 25, 23, 31, 7, 17, 1, 31, 11, -10, -2, 13, -4, 14, 61, 23, 33, -34, 37, -33, 9, 16, 29, -15, -73, 9, 1, -12, 4, 12,
+  -31, 22, -85, 7, -3, -27, -62, -21, -40, -3, 28, 4, -57, 36, -6, -18, -23, 8, 12, -1, -7, -8, 37, -26, -9, -25, -19, -22, 13, 16, -17, 7,
+  7, -26, 11, 3, 25, 14, 31, -29, 25, 19, 48, -12, 7, 2, -15, 64, 12, 11, -11, -37, 39, 23, 30, 30, 2, -9, -53, 77, 20, 18, -3, -17,
+  -21, 58, 22, 19, -10, -65, -109, 27, 14, -47, -26, 31, -63, 33, 18, -54, 11, 5, -6, 17, 14, -9, 12, -16, 10, 12, -22, 34, -28, -10, -21, -14,
+  -5, -4, -18, -21, -18, 39, 6, -29, 28, 14, 39, 0, 10, 13, 10, 46, 28, 23, 0, -35, 34, -12, 52, -11, 16, 12, -21, -6, 20, -12, -3, -27,
+  -37, -75, -41, 11, 6, -67, -50, -20, 14, -3, -53, 28, -60, 31, 33, -58, -25, -6, 13, -22, 2, -3, -20, -13, 1, 29, -19, 4, -11, -17, -16, -27,
+  5, 10, -7, -21, -1, 51, -7, -59, 10, 6, 11, -34, -34, 15, -7, 59, -12, 39, -41, -17, 6, -43, 1, -17, -9, 18, -37, 34, 13, -56, -24, -37,
+  -15, -55, -19, -25, -23, -44, -3, 11, 18, 10, -27, 26, -21, 58, 34, -40, -14, 16, -19, -17, 2, -12, -22, -19, 15, -15, 37, -21, -2, -37, 6, 12,
+  15, -23, 37, -8, 82, -14, 11, -14, -25, -43, -31, -86, -58, -17, 12, -7, -63, 20, 11, -17, -25, -47, -10, -2, 86, 10, 12, -26, 29, -49, -71, -6,
+  1, 27, 22, -11, 39, 38, -6, 37, -49, -9, -5, -6, 22, -26, -25, -3, -34, -2, -27, -21, 89, -35, 46, -18, -11, 6, -25, -82, 7, -9, -41, -24,
+  11, -5, 17, -30, -6, -17, -4, -22, 9, -7, -16, -28, -10, -14, -5, -4, 16, -22, 3, 2, -9, 29, -10, -54, -4, -24, 87, -46, -12, 44, 2, 53,
+  -23, 7, -11, -18, -43, 2, 8, 38, -31, -24, -23, 13, 28, -30, -14, 26, 0, -25, 19, 36, 11, 34, -7, 19, -11, 21, 0, -60, 5, 23, -28, -17,
+  7, -31, -1, -24, 5, 1, -6, 19, -3, -10, -6, 8, 12, 8, -20, 11, 2, -5, -3, 18, 23, 46, -5, 18, -19, -10, 35, -60, -40, 24, 13, -30,
+  11, 11, -10, -10, 6, 18, 16, 4, -13, -6, -17, -13, 42, -12, -28, 31, -2, -18, -38, 68, 20, 5, -18, 35, -46, 22, 37, -32, -37, 55, -18, -60,
+  7, -10, 10, 0, -13, -29, 8, 18, 15, -9, 9, 11, -6, -13, -2, 6, -7, -7, -12, 71, -19, 34, -30, 2, -19, -1, 17, -11, -6, 25, 0, -15,
+  9, -6, -7, -24, 26, -15, 51, 18, -12, -3, 23, 37, 13, -18, -26, 8, 17, -6, -8, 61, 14, 23, 14, -2, -36, 57, 15, 18, -27, 21, 0, 3,
+  -8, 7, -30, -23, -14, 16, 12, -11, 14, 11, -25, -7, -31, 15, -7, -12, -19, 3, -3, 56, -16, 5, 21, 18, -1, 24, 35, -25, -24, 24, -9, -14,
+  -28, -16, -2, -33, 30, -8, 61, 29, 32, 35, 10, 5, 62, -30, -18, 70, 36, -50, 29, -17, -34, 43, 22, -21, 9, 27, -1, -3, 28, 0, 10, -12,
+  -27, -4, -10, 11, 15, -14, -18, -10, -3, -25, -1, -29, -27, -23, 3, -24, -38, -9, -14, 42, -1, 33, 13, 16, -12, 16, 29, -25, -28, 37, -7, 9,
+  29, 8, 11, 13, 37, -34, 37, 24, 15, 8, 36, 9, 40, -17, -14, -9, -18, -18, 0, 19, -9, -2, -25, -30, -13, 35, -19, -15, 46, 19, 4, -27,
+  11, -11, -25, -9, -30, 7, 14, 5, -11, 4, -1, 18, 6, -21, -10, -29, -39, -46, -39, 85, -24, -2, -11, -4, -29, 23, 28, -35, 29, 65, 3, 44,
+  0, -3, 30, 8, 39, 61, -7, -17, -33, -1, 28, 10, 33, 0, -27, 80, -20, 2, -18, 12, 43, 17, -14, 21, -66, 27, -44, -2, -7, 43, -34, 19,
+  -27, -16, -29, -20, 12, 17, -9, -24, -4, -17, 11, -14, -17, 1, 18, -1, -27, -19, 33, 50, -31, 34, 49, 14, 20, 20, -25, -7, -20, 45, 7, 13,
+  23, 4, 49, -36, 89, 9, 26, 2, -7, 17, 31, 2, 57, 23, -9, 35, -31, 4, -30, 34, 56, 44, 24, 38, -45, 12, -41, -15, -37, 11, 4, 24,
+  -19, -14, 17, 11, -13, 16, -9, -2, -8, -11, -28, -16, -17, 14, 5, 18, -21, -14, 11, 42, 4, -24, 23, 6, 5, 14, -16, -25, -15, 22, 19, 7,
+  52, 8, 43, -37, 21, 25, 46, -3, -14, 4, 1, 19, 28, 4, -9, 66, 7, -32, -9, 38, 19, 14, 35, 15, -12, 36, 23, 17, -31, 0, -17, 6,
+  -27, 18, 10, -5, -32, -19, 2, 11, -9, -25, -21, -23, -8, -2, -16, -8, -24, -30, -29, 40, -59, 19, -2, 29, 12, 12, -43, 22, 6, 11, -6, -14,
+  11, 15, 9, -43, 4, 9, 70, 26, 21, 0, -30, 38, 22, -51, -29, -32, 8, 13, 16, 22, -16, 19, 16, 31, -9, 36, 24, -23, 21, 2, -29, 21,
+  -19, -26, 15, -27, 18, -16, 9, -24, 19, 1, 5, -18, 9, 20, -4, -28, -37, -8, -23, 62, -31, -5, -42, -23, -4, 0, 45, -4, -15, 16, 8, 13,
+  24, -21, -27, -36, -25, 5, 57, -8, 24, 26, 4, 14, 56, -40, 3, -34, 5, -18, -21, 19, -9, 62, 38, 6, 32, -27, 15, 11, 35, 24, -2, 29,
+  -22, -2, 19, -14, -5, -2, -32, 6, -3, 7, -3, -10, 8, 15, -26, 4, 10, -45, 27, 26, 14, 12, -7, -14, -6, -16, 3, 11, -24, 38, 15, 14,
+  33, 18, 12, -9, -4, 29, 25, 0, 10, 16, 2, -1, 42, -40, -26, 1, 9, 15, -29, 11, -3, 26, 28, -33, -3, 31, 31, -23, -35, -12, -8, -3,
+  -5, -26, 19, -3, -23, -21, 11, -31, 18, -1, 7, 5, -21, 14, -7, 9, -1, -54, -26, -19, 10, 14, 0, -56, -16, -10, 7, -3, -47, 37, 55, 42,
+  6, 84, 20, -6, 3, 47, -28, -9, -10, 9, 3, 14, 40, -43, -25, 15, 12, -46, -20, -1, 2, 46, 29, 2, -38, 11, 13, -58, -35, 29, 24, -25,
+  2, -12, -23, -22, 13, -29, -14, -24, -24, 8, 23, -9, 8, -17, -4, 3, -7, -33, -1, 46, 27, 7, 22, 13, -26, 5, -24, -35, -10, 22, 9, 13,
+  -15, 22, -9, 5, 65, 59, -3, -5, -40, 23, 29, -69, -2, 43, -2, 18, -26, -11, -10, 12, -29, 6, -26, -6, -17, 6, -20, 1, -10, -23, -30, -5,
+  -17, 14, 0, 67, -67, -24, 38, -15, 50, 0, 40, 3, 6, 1, 18, -17, -27, -18, -26, 9, -28, -10, -1, 4, 8, -2, 15, 21, 23, 4, -39, -30,
+  -5, -50, 5, -48, -4, 41, 21, 39, -46, 33, 11, -50, -1, 23, -31, -7, -26, -22, 16, -11, -11, -15, 21, 14, -6, -7, -6, 8, -15, -22, 21, -12,
+  25, 39, 9, 36, 7, -18, -31, -31, 57, -1, 2, -23, -11, 8, 50, -71, -14, -11, 17, -45, -6, -21, 14, 18, -1, -13, 18, 35, -27, 16, -5, 11,
+  21, -7, -19, -18, 27, 13, 14, 0, -24, 29, 5, -45, 4, 45, -12, 26, -32, 10, 19, -24, -20, 4, 5, 11, 16, 1, -8, -33, -10, -13, -26, -2,
+  3, 31, 24, 18, -36, -38, -18, -8, 33, 7, 1, 50, -30, 8, 27, -26, -18, -22, 1, 0, -41, -6, -18, -24, 9, -14, -20, -7, -16, 28, -2, -11,
+  -25, -39, -27, -1, 46, 38, 8, 35, -46, 5, 25, -4, -19, 2, -1, 27, 3, -26, 18, 4, 0, 0, 17, -32, -19, -32, -27, -22, -1, 13, 19, -21,
+  37, 18, -8, 35, -61, -37, -21, -14, 6, 3, -9, -14, 2, 11, 33, -9, -30, 8, 16, -18, 3, -21, -26, -20, -18, 19, -21, -15, 11, 22, -32, 5,
+  -21, -37, -9, -3, -22, 8, 41, 0, -6, 46, 17, -1, 21, 18, -27, 13, -7, -16, -27, 8, 3, -14, 14, -11, -31, -15, 2, 3, 5, -2, 10, -8,
+  -1, 35, 14, -3, 1, -5, -55, -44, 4, -16, -22, -21, -63, 3, 33, 8, 11, -41, 17, -24, -46, 0, -12, -11, -26, -18, -32, -55, 3, 13, -12, -28,
+  -32, 1, -7, 5, 5, 15, 12, 13, -6, 32, 38, -11, 11, -14, -51, 34, 17, 20, 9, -21, 20, 18, 12, 12, -15, -25, -22, -2, 20, 13, 13, -29,
+  -12, 46, -3, -1, -43, -46, -32, 5, -34, -63, -23, 37, -38, -48, 5, 15, -4, 22, 9, 2, -19, -11, -3, -50, -34, -31, 13, -10, 48, 24, -28, 11,
+  17, -20, -5, 4, 6, 26, 39, -13, -7, 33, 64, -31, 4, 47, 32, 59, -8, -28, 8, -28, -29, -10, 12, 8, -5, 2, 4, -3, -30, -22, 18, -30,
+  -53, -25, -2, 17, 8, -57, -30, -30, -6, -34, -19, 34, -53, -26, 62, -20, 1, 12, -9, -41, -6, 40, 21, -5, -21, 44, 14, -65, -10, 45, -5, 7,
+  -28, -35, -23, -5, 14, 37, 28, -22, 0, 26, 49, 7, 10, 13, -24, -3, 3, -31, 1, -16, 9, -9, 4, -7, -32, -12, -28, 10, -29, -4, -31, 0,
+  -38, -22, -30, 35, -41, -59, -22, 2, -46, -76, -45, -10, -76, -25, 11, -63, 15, 7, -12, 6, -1, 18, 3, 0, -29, 44, 27, -26, 12, 10, -27, -38,
+  -3, -11, -18, -30, -51, 43, 23, -35, 28, 34, 24, 21, -14, 14, -13, 22, -26, 1, -4, 18, 5, -12, -17, 9, 13, -25, -6, 9, -4, -29, -12, 4,
+  -19, -47, -43, 17, -49, -31, -27, 32, -25, 2, -47, 44, -22, 23, -15, -20, -15, 5, 27, -21, 6, 6, -12, -21, -13, -14, 10, 2, 31, 57, 17, -14,
+  -36, 27, -15, 13, 48, -1, -3, -1, 15, 39, 48, -20, 47, 3, -41, 37, -1, -5, 15, -32, 4, -28, -20, -1, -11, 1, 0, 19, -9, -14, -1, 16,
+  -19, -82, -39, 57, -72, -16, -112, 29, -53, -19, -27, -20, -60, 27, -1, -28, -14, 11, 6, 15, -22, -30, -23, -35, 2, -6, 22, -32, -28, 50, -11, 30,
+  -17, -8, 14, -37, 43, 39, -22, -39, 5, -17, 17, -6, 0, -7, -24, 66, -1, -12, -9, 11, 8, -12, -7, 18, -3, -24, 4, -14, -14, -7, -9, 2,
+  -22, -46, -26, 36, -23, -65, -37, -48, -15, -6, 12, -5, -63, 50, 20, -24, -17, -17, 11, 14, 5, -4, 5, 30, -70, -17, 40, 2, -40, -13, -15, 18,
+  21, 15, 20, 4, 4, 37, -18, -13, -7, -46, 17, -38, -8, -10, -8, 35, -16, -17, -15, 18, -2, -9, 9, -10, -3, 17, -28, 3, 18, -21, -3, -25,
+  -11, -73, -29, 2, -33, -84, -12, -28, 12, -34, -15, -54, -26, 15, 43, 40, -43, -68, -30, 50, 6, -14, -5, -3, -22, 38, 11, -25, 3, -1, -1, 36,
+  17, 32, 0, -6, 114, 66, -33, 5, -40, -31, -94, -102, -58, -4, 3, -6, -26, 19, -8, -25, 14, -17, 11, -1, 19, 4, 24, -14, -8, 1, -28, -11,
+  -35, -120, -25, -14, -29, -76, -13, -14, 11, 1, -28, -78, -101, 19, 34, -16, -14, -14, 32, 35, 34, -20, 14, -6, -47, -10, 35, 15, -1, -7, -28, 59,
+  -31, 33, -9, -31, -8, -20, -19, 36, 33, -17, -22, 76, 28, -35, 0, 7, -3, -4, 0, -10, -27, -30, -3, -8, 5, -6, -22, -23, -24, 4, -5, -22,
+  10, 4, 5, 3, -9, -11, -25, -15, 15, 24, 14, 13, -26, -5, 13, 11, 10, 10, 10, -33, -27, 34, -36, -23, -70, -34, -49, -72, -45, 33, -43, 17,
+  14, 37, -9, -19, -17, 3, 4, 8, 10, -9, -11, 44, 24, -43, -11, 16, 11, 2, -14, 9, 14, 21, -16, -29, -6, -1, -23, 1, 2, 1, 5, 21,
+  4, 1, 6, 1, 5, 12, 24, -11, -10, -1, -16, -21, -39, -14, 3, -27, -1, -28, 9, -30, -56, 32, 1, -9, -25, -18, -34, -46, -1, 0, -41, -27,
+  -1, 34, 32, -22, -13, -15, 15, -14, 36, -13, -38, 28, 20, -53, -27, -19, 3, -21, 5, 4, -4, -21, 1, 1, -19, -15, -30, -18, -6, -10, 10, -5,
+  4, -20, 15, -11, -12, -26, 0, -29, -16, -8, 15, 22, 5, -35, -20, 9, 3, -40, -24, 23, 8, 24, 10, 15, -36, -3, 39, -46, -9, 9, -27, 37,
+  -8, 1, 6, -57, 23, 0, 22, 8, 4, -14, -52, 32, 22, -32, -14, -59, -28, -24, -29, -15, -6, 1, -15, -30, 5, -16, -16, -9, 2, -20, -13, 3,
+  -21, -4, 7, -10, -8, -18, -6, -12, -16, -23, 2, 13, -29, 13, 0, -32, -30, -10, 14, 16, 18, -9, 47, 0, -21, 32, 43, -12, -45, 16, 8, 42,
+  6, -2, 10, -21, -7, -14, 24, -14, 29, -27, -21, 41, 4, -60, -16, 3, 17, 10, -12, -5, 15, -21, -7, -26, -38, -16, -7, -5, -6, 1, -4, -22,
+  -30, -24, 2, -6, 6, -1, -26, 0, 17, 1, -3, -22, -32, 9, 16, -9, -24, -1, -7, 4, -25, 22, 17, 15, -20, 25, 11, 11, 6, 5, -33, -20,
+  36, 6, 22, -17, -16, -28, -8, 5, -6, -83, -73, -3, -14, -4, -2, 10, -40, -5, 19, -14, 10, 2, 6, -4, -20, -16, -17, 14, -16, 0, -11, 19,
+  -41, -34, -21, -18, -7, -33, -24, 7, 11, 4, 1, 22, -1, -31, -17, -26, -8, 0, -26, 30, 2, 25, 1, 26, -5, 35, 37, -48, 44, 33, -38, 19,
+  30, -1, -21, -23, 25, -27, -47, 7, 20, -25, -16, 16, 21, -23, 5, 12, -28, -15, -22, -3, 5, -6, 2, -11, -38, -22, -1, -1, 13, -19, 11, 24,
+  -9, 1, -20, -13, -10, 9, 7, 12, -25, 15, -10, -12, -26, 5, 4, -7, -22, -8, 5, -11, 17, -31, 50, -7, 13, 24, 3, -9, -10, 66, 35, 81,
+  20, -5, 1, -56, -6, 12, -5, 0, 7, -34, -10, 21, 25, -35, -11, 30, -9, 12, -27, -38, -9, 1, 8, 18, -1, -34, -37, -9, -32, 22, -11, -24,
+  -17, -15, -8, 14, -28, -32, -6, -28, -21, -29, -6, -16, -19, -19, -26, 1, -22, -24, -12, -14, 34, -15, 18, 23, 3, 16, 31, -4, 23, 15, 43, 27,
+  20, 6, 34, -55, 47, -52, 0, -13, 27, -10, -13, 11, -19, -31, -15, 9, -28, -26, -12, -19, -18, -20, 7, -22, -6, 14, -30, -15, 0, -7, 17, 19,
+  -20, -25, 18, -17, 18, -24, 9, -11, -17, 17, 7, -13, -32, -17, -15, 2, -10, 9, 5, 1, 1, 32, 9, -16, 18, 14, 15, 22, -1, -6, -3, -35,
+  -2, -2, 19, -10, 19, 33, 23, 9, 12, -52, -54, 44, 11, 6, -11, -46, -11, 11, 0, -16, 4, -28, 11, 1, 19, 6, -18, -29, -28, 8, 3, -23,
+  -27, 10, 11, -26, -16, -31, 11, -7, 5, 10, 3, 9, -27, -15, 2, -6, -32, 35, -12, 38, 15, 2, 12, -38, 8, 14, 51, -16, 35, -16, -28, 1,
+  42, 29, 0, -47, -6, -14, 38, -20, 4, -13, -43, -6, -18, -32, -33, -60, 9, -34, -29, -2, -3, -1, -1, -11, -16, -14, 21, -9, 15, -17, 5, 12,
+  2, 12, -18, -28, -8, -16, -5, -15, 10, -14, -5, 12, -30, 11, -21, -13, -13, -10, -4, -2, -28, 42, 12, 2, 2, 11, 26, -1, 25, 4, -1, 88,
+  16, 22, -25, -23, -3, -20, 25, 37, -2, -24, -25, 11, 20, -67, -38, -42, -31, 0, -19, -1, -13, 4, -25, 0, 2, 16, -24, -3, 20, -25, 4, -1,
+  20, -19, -25, -1, 3, -20, -4, -4, -19, 6, -5, -24, -7, 14, -20, -6, -13, -13, 12, -14, 33, 26, -24, -20, -31, -13, -1, -42, -43, 9, -3, 22,
+  -21, 18, -3, -31, 45, -71, 5, 3, 54, -9, -6, 5, 40, -74, -52, -8, -7, 1, -21, 11, 24, -22, -26, -16, -15, 1, 2, -11, 10, -12, -16, -17,
+  -25, 4, -1, -9, -17, -5, 5, -3, -9, 15, 7, 10, 6, -6, 2, 5, 22, -45, 20, -17, 40, 31, 2, 6, -9, -23, -35, -56, -29, -11, 18, -15,
+  -14, -30, -6, -14, -6, -26, 14, 14, -12, -22, 14, -26, -28, 11, -19, 7, -6, -31, -45, -30, 59, -28, 52, 28, -38, 69, 53, -35, -31, -35, -18, -38,
+  11, 4, -8, -15, 4, 24, -15, -31, -32, -18, -34, -52, -27, 12, -10, -8, -34, 0, -8, -22, -43, -26, 4, -13, -5, -35, 0, -20, -40, -14, -11, -37,
+  14, 6, -26, 17, -7, -5, 15, -18, -3, -16, -18, -28, -34, 9, 15, -25, -34, -64, -3, 18, 47, -49, 18, -3, -26, 61, 25, -42, 3, -11, -1, -36,
+  -10, -1, 2, -77, 10, 6, -20, -30, -11, -15, -65, -45, -23, 32, -27, -13, -41, -10, -10, -49, -20, -16, -24, -6, -33, -29, 32, -28, 4, 3, -35, -26,
+  -1, -10, 14, -16, -15, -7, 16, 11, 15, -15, -12, -5, 11, -7, 15, 0, 3, -24, -16, -6, 73, 3, 32, -28, -35, -14, -13, 4, 23, 6, 7, -7,
+  -21, -13, 0, 21, 37, 18, -3, 15, -3, -15, -16, -49, 0, 31, -51, 18, 5, -53, 13, 8, -25, -41, 23, 3, -38, -11, 1, -29, 21, 7, -21, 5,
+  7, 15, 15, 16, -3, -22, -27, -26, -3, -9, 15, -5, 12, -2, -34, -11, 14, -11, 20, -23, 5, 18, -31, -38, 1, -47, -7, -47, -9, 9, 8, 28,
+  -20, -32, 3, -13, 50, -11, 19, 12, -20, 12, -16, -7, -22, -12, 8, 28, -4, -20, -26, -7, -15, 19, -42, -10, -3, -36, -31, 4, -29, -6, 0, 2,
+  -20, -11, 16, -1, -5, -8, -9, 4, -28, -6, -18, -31, -3, -24, 4, -19, -10, -31, 11, -25, 6, 9, -19, -9, -3, 23, -5, 35, -79, -19, -37, -6,
+  -33, -40, -8, 22, 6, 33, 41, 27, -39, 25, 36, 23, 10, 9, -11, -4, -32, -33, -23, -32, -26, -16, -3, 1, 3, 14, 17, -19, -2, 30, 10, -46,
+  -25, -33, -11, -31, -14, -28, -2, -17, -5, 7, 9, -33, 9, -37, -4, -30, -18, 6, 5, -32, 84, -15, -47, -8, -24, 65, 10, 25, 0, -34, -62, 52,
+  -8, -42, -21, 24, 26, -2, 27, 2, -15, 74, 16, -23, 9, 29, -12, -19, -29, -40, 8, 18, 32, 0, 9, 7, 4, 16, 18, -37, -12, -36, -33, 17,
+  8, 7, -20, 4, 5, -4, -9, -30, -34, 13, -16, -7, -28, -31, 12, -31, 11, 9, -25, -14, 19, -55, 7, -36, -17, 3, 29, 24, 40, -15, -17, 14,
+  -13, 2, 22, 6, 15, -7, 19, 15, -9, 8, 35, -13, -2, 83, 20, 65, -14, 11, -16, 44, 17, -6, -5, -12, -49, -16, 28, -22, 20, -14, -25, 26,
+  2, 11, 17, 10, -32, -31, 8, -4, -27, -12, -25, -31, -17, -7, -12, 2, -15, 17, -21, -47, -13, 25, 9, -63, 21, -28, 7, 18, 21, -13, -16, 6,
+  -3, 26, 4, 3, 20, 12, 28, -30, 0, 15, -3, 9, 38, -12, 11, 27, -17, -33, 4, 4, 14, -35, 18, 13, -47, -19, -32, -25, 2, -49, 1, 26,
+  1, -4, 16, 0, -13, -22, -9, -11, -5, -28, -17, -26, 14, 16, 9, -15, -34, -20, -11, 4, -26, 92, -18, -46, -6, -30, -22, -27, -57, 16, -53, -5,
+  -17, 5, 3, 7, -31, 35, 12, -6, -18, 21, 2, 15, 5, -8, -3, -5, -31, -37, -1, -12, 41, -10, -41, -15, 6, -11, 37, 31, 5, 21, -24, 0,
+  -19, -7, -6, -2, -6, -31, -18, -21, -4, 2, -2, -9, -26, -23, -14, 3, -38, 30, -37, -14, 49, -13, 33, -8, -23, 45, 4, 30, -31, -61, -85, 39,
+  -16, 5, 13, -21, 33, 4, 7, -31, 13, 21, 94, -7, 3, -11, -4, 7, -32, 18, 1, -20, 14, -32, -33, -7, 2, -21, 23, 1, -40, 1, -37, -27,
+  -7, -5, -23, -3, -20, -2, -35, -15, -10, 16, -13, -11, 1, -2, -4, -26, -18, -30, 3, -52, 51, 13, 7, -31, -23, 13, 27, 33, -28, -56, -40, 10,
+  -14, -22, -30, -68, 28, -6, 55, -31, -2, 4, 39, -20, 36, -23, 2, 57, -29, -40, -27, 4, -9, -10, -25, -6, -6, -30, -5, -2, -24, -15, -29, 10,
+  11, 9, 3, 6, -27, -22, 16, 9, 5, 14, 9, 9, 7, -22, 14, -19, 20, 2, 25, -24, 4, 57, -55, -61, -19, -23, 1, 13, -10, 24, -12, -3,
+  26, -5, -9, -26, 0, 24, -2, -23, 7, -22, -1, -61, 3, 25, -27, 24, -28, 5, -12, -16, 9, -4, -20, 22, -20, -7, 31, 12, -14, 2, -1, -27,
+  -11, -19, 17, 16, -21, -4, -15, -29, 11, 1, -24, -16, -13, 8, -23, -28, 37, -25, -5, 10, 5, 73, -35, 17, -90, -30, -15, -66, -68, 25, 64, 2,
+  28, 7, 1, -17, 39, 36, -30, 15, -49, -11, -1, -87, -87, 12, 45, -13, -31, 27, 14, 4, -16, 13, 38, -20, -49, -26, -19, 6, -13, 49, -20, -8,
+};
+
+// node 10, FULLY_CONNECTED, 3 x 32 from tensor 7
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int32_t prepacked_corrections10[4] = {
+  -78226, -33400, 10963, 0,
+};
+const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) int8_t prepacked_weights10[128] = {
+  -13, -127, -51, -83, 48, -23, -59, -68, 44, 24, -106, 37, 68, 51, 8, -33, -64, -18, -64, 63, -27, 55, -47, 29, -47, 42, 22, -68, -58, 71, -30, 64,
+  -27, -79, -60, 53, -57, -22, 54, 10, 24, -41, -25, 20, -11, 25, 74, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -89, 11, 61, 1, -96, 37, 103, 2, -94, -84, -21, -41, 41, -92, -90, 29, 47, -16, -31, -112, -2, -43, -24, -22, 56, 32, 29, -23, -9, -43, -11, -16,
+  50, 44, -55, -11, 38, -58, 3, 24, 0, -25, -51, 65, 23, 33, 42, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+const tflite::optimized_integer_ops::int8_gemm::PrepackedFilter prepacked_filters[] = {
+  { g0::tensor_data13, -6, 8, 39, prepacked_corrections1, prepacked_weights1 },
+  { g0::tensor_data11, 128, 16, 24, prepacked_corrections5, prepacked_weights5 },
+  { g0::tensor_data9, 128, 32, 208, prepacked_corrections9, prepacked_weights9 },
+  { g0::tensor_data7, 128, 3, 32, prepacked_corrections10, prepacked_weights10 },
+};
@@ -0,0 +1,165 @@
+/*
+ * HTTP/1.1 Chunked Transfer-Encoding Decoder
+ * Incremental, in-place: feed whatever client.read() returned, get payload bytes back
+ *
+ * Lets playStream() consume a streaming backend response (one HTTP chunk per
+ * TTS segment) without buffering the whole body.
+ */
+
+#ifndef CHUNKED_DECODER_H
+#define CHUNKED_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class ChunkedDecoder {
+private:
+    enum State {
+        CHUNK_SIZE,      // Hex digits
+        CHUNK_EXT,       // ";name=value" up to CRLF
+        CHUNK_SIZE_LF,
+        CHUNK_DATA,
+        CHUNK_DATA_CR,
+        CHUNK_DATA_LF,
+        TRAILER,         // After the 0-size chunk, up to an empty line
+        TRAILER_LF,
+        FINISHED,
+        FAILED
+    };
+
+    State state = CHUNK_SIZE;
+    uint32_t remaining = 0;
+    bool sizeHasDigits = false;
+    bool trailerLineEmpty = true;
+
+    static int hexValue(uint8_t c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    void endOfSizeLine() {
+        if (!sizeHasDigits) {
+            state = FAILED;
+        } else if (remaining == 0) {
+            state = TRAILER;
+            trailerLineEmpty = true;
+        } else {
+            state = CHUNK_DATA;
+        }
+    }
+
+public:
+    void reset() {
+        state = CHUNK_SIZE;
+        remaining = 0;
+        sizeHasDigits = false;
+        trailerLineEmpty = true;
+    }
+
+    bool done() const { return state == FINISHED; }
+    bool failed() const { return state == FAILED; }
+
+    /**
+     * @brief Strip chunk framing from buf in place
+     * @return Number of payload bytes now at the start of buf
+     */
+    size_t decode(uint8_t* buf, size_t len) {
+        size_t out = 0;
+        size_t i = 0;
+
+        while (i < len && state != FINISHED && state != FAILED) {
+            uint8_t c = buf[i];
+
+            switch (state) {
+                case CHUNK_SIZE: {
+                    int v = hexValue(c);
+                    if (v >= 0) {
+                        if (remaining > 0x0FFFFFFF) { state = FAILED; break; }
+                        remaining = (remaining << 4) | v;
+                        sizeHasDigits = true;
+                    } else if (c == ';' || c == ' ' || c == '\t') {
+                        state = CHUNK_EXT;
+                    } else if (c == '\r') {
+                        state = CHUNK_SIZE_LF;
+                    } else if (c == '\n') {
+                        endOfSizeLine();
+                    } else {
+                        state = FAILED;
+                    }
+                    i++;
+                    break;
+                }
+
+                case CHUNK_EXT:
+                    if (c == '\r') state = CHUNK_SIZE_LF;
+                    else if (c == '\n') endOfSizeLine();
+                    i++;
+                    break;
+
+                case CHUNK_SIZE_LF:
+                    if (c == '\n') endOfSizeLine();
+                    else state = FAILED;
+                    i++;
+                    break;
+
+                case CHUNK_DATA: {
+                    size_t n = len - i;
+                    if (n > remaining) n = remaining;
+                    // out <= i always holds, so this never overwrites unread input
+                    if (out != i) memmove(buf + out, buf + i, n);
+                    out += n;
+                    i += n;
+                    remaining -= n;
+                    if (remaining == 0) state = CHUNK_DATA_CR;
+                    break;
+                }
+
+                case CHUNK_DATA_CR:
+                    if (c == '\r') state = CHUNK_DATA_LF;
+                    else if (c == '\n') { state = CHUNK_SIZE; sizeHasDigits = false; }
+                    else state = FAILED;
+                    i++;
+                    break;
+
+                case CHUNK_DATA_LF:
+                    if (c == '\n') { state = CHUNK_SIZE; sizeHasDigits = false; }
+                    else state = FAILED;
+                    i++;
+                    break;
+
+                case TRAILER:
+                    if (c == '\r') {
+                        state = TRAILER_LF;
+                    } else if (c == '\n') {
+                        if (trailerLineEmpty) state = FINISHED;
+                        trailerLineEmpty = true;
+                    } else {
+                        trailerLineEmpty = false;
+                    }
+                    i++;
+                    break;
+
+                case TRAILER_LF:
+                    if (c == '\n') {
+                        if (trailerLineEmpty) state = FINISHED;
+                        else { state = TRAILER; trailerLineEmpty = true; }
+                    } else {
+                        state = FAILED;
+                    }
+                    i++;
+                    break;
+
+                default:
+                    i++;
+                    break;
+            }
+        }
+
+        return out;
+    }
+};
+
+#endif // CHUNKED_DECODER_H
@@ -12,6 +12,9 @@
 #define BACKEND_PORT        80
 #define USE_HTTPS           false
 #define VOICE_ENDPOINT      "/voice"
+// Sent as X-Device-Token on audio and score uploads, must match the backend's
+// NOVA_DEVICE_TOKEN ("" sends none; the backend then refuses score uploads)
+#define DEVICE_TOKEN        ""
 
 // ============== INMP441 Microphone (I2S Input) ==============
 #define MIC_I2S_NUM         I2S_NUM_1
@@ -24,6 +27,8 @@
 #define SPK_I2S_BCLK        12
 #define SPK_I2S_LRC         13
 #define SPK_I2S_DIN         14
+#define SPK_DMA_BUF_COUNT   16
+#define SPK_DMA_BUF_LEN     1024    // Frames: the DMA queues about 1s at 16kHz
 
 // ============== Audio Settings ==============
 #define SAMPLE_RATE         16000
@@ -31,6 +36,19 @@
 #define RECORD_SECONDS      30
 #define I2S_BUFFER_SIZE     1024
 
+// ============== Speaker Sample Rate ==============
+// true: switch the speaker I2S clock to the rate the backend streams at
+// false: keep I2S at SAMPLE_RATE and resample on the device
+#define SPK_NATIVE_RATE_PLAYBACK  true
+#define SPK_MIN_SAMPLE_RATE       8000
+#define SPK_MAX_SAMPLE_RATE       48000
+
+// ============== Response Streaming ==============
+// Ask the backend to stream the reply per TTS chunk (HTTP/1.1 chunked)
+#define STREAM_RESPONSES          true
+// Audio held back before the first I2S write, absorbs network jitter
+#define STREAM_PREFILL_MS         200
+
 // ============== Silence Detection ==============
 #define SILENCE_THRESHOLD       200
 #define SILENCE_DURATION_MS     1000
@@ -39,6 +57,27 @@
 // Calculated values
 #define RECORD_BUFFER_SIZE  (SAMPLE_RATE * RECORD_SECONDS * (BITS_PER_SAMPLE / 8))
 
+// ============== Score Capture ==============
+// Wake word scores + model input of the last N slices kept in a PSRAM ring,
+// uploaded to the backend with the 's' serial command (0 disables)
+#define SCORE_CAPTURE_SLICES    1200    // 5 minutes, ~800KB
+
+// ============== Wake Pre-roll ==============
+// Mic audio the wake word engine heard last, sent ahead of a wake word turn's
+// recording so the backend can re-check the wake word before STT (0 disables)
+#define WAKE_PREROLL_MS         1500    // All three averaged windows, 48KB
+
+// ============== Barge-in ==============
+// Wake word keeps running while a reply plays: the speaker signal goes into a
+// reference ring for the echo canceller (echo_canceller.h), 0 disables.
+// Deferred: compiled out until barge-in has been accepted on the device, i.e. a
+// wake word cuts a long reply short and the "[AEC] ERLE" line after each reply
+// shows a delay found. The esp32s3-barge-in env (platformio.ini) builds it with
+// 2500, the speaker DMA queue plus margin (80KB); once accepted, ship that here.
+#ifndef ECHO_REFERENCE_MS
+#define ECHO_REFERENCE_MS       0
+#endif
+
 // ============== RGB LED ==============
 #define RGB_LED_PIN         48
 #define NUM_LEDS            1
@@ -0,0 +1,154 @@
+/*
+ * Earcon Engine for NOVA
+ * Sound effects are short note lists played through a phase-accumulator
+ * wavetable oscillator - no sin() or malloc at call time
+ *
+ *   EARCON_SINE   - one sine cycle in flash (256 points + wrap guard)
+ *   EarconNote    - frequency (0 = rest) and duration
+ *   EarconPlayer  - renders a note list into stereo frames, block by block
+ *
+ * Each note gets a few ms of attack/release so note edges don't click.
+ *
+ * Plain C++ on purpose: no Arduino headers, so tests/test_earcon.cpp can time it.
+ */
+
+#ifndef EARCON_H
+#define EARCON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define EARCON_TABLE_BITS   8
+#define EARCON_TABLE_SIZE   (1 << EARCON_TABLE_BITS)
+#define EARCON_RAMP_MS      3
+
+// sin(2*pi*i/256) in Q15, generated offline; last entry repeats the first for interpolation
+static const int16_t EARCON_SINE[EARCON_TABLE_SIZE + 1] = {
+         0,    804,   1608,   2410,   3212,   4011,   4808,   5602,   6393,   7179,   7962,   8739,
+      9512,  10278,  11039,  11793,  12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+     18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,  23170,  23731,  24279,  24811,
+     25329,  25832,  26319,  26790,  27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+     30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,  32137,  32285,  32412,  32521,
+     32609,  32678,  32728,  32757,  32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+     32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,  30273,  29956,  29621,  29268,
+     28898,  28510,  28105,  27683,  27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+     23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,  18204,  17530,  16846,  16151,
+     15446,  14732,  14010,  13279,  12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+      6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,      0,   -804,  -1608,  -2410,
+     -3212,  -4011,  -4808,  -5602,  -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159,
+    -20787, -21403, -22005, -22594, -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+    -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956, -30273, -30571, -30852, -31113,
+    -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580,
+    -31356, -31113, -30852, -30571, -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+    -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731, -23170, -22594, -22005, -21403,
+    -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,  -6393,  -5602,  -4808,  -4011,
+     -3212,  -2410,  -1608,   -804,      0
+};
+
+struct EarconNote {
+    uint16_t frequency;     // Hz, 0 = rest
+    uint16_t durationMs;
+};
+
+class EarconPlayer {
+public:
+    /**
+     * @brief Start a note list. notes must outlive playback (use static const tables)
+     * @param volume 0.0-1.0, same scale as the old playTone()
+     */
+    void start(const EarconNote* notes, uint8_t count, float volume, uint32_t sampleRate) {
+        _notes = notes;
+        _count = count;
+        _index = 0;
+        _rate = sampleRate;
+        _gain = (int32_t)((volume < 0.0f ? 0.0f : volume > 1.0f ? 1.0f : volume) * 32767);
+        beginNote();
+    }
+
+    bool active() const {
+        return _index < _count;
+    }
+
+    /**
+     * @brief Render up to frames stereo frames (L/R interleaved)
+     * @return Frames written, 0 once the last note has finished
+     */
+    size_t render(int16_t* stereo, size_t frames) {
+        size_t written = 0;
+        while (written < frames && active()) {
+            size_t run = _noteSamples - _pos;
+            if (run > frames - written) run = frames - written;
+            int16_t* out = stereo + written * 2;
+
+            if (_phaseInc == 0) {
+                memset(out, 0, run * 4);
+                _pos += run;
+            } else {
+                for (size_t i = 0; i < run; i++, _pos++) {
+                    int32_t value = (oscillator() * _gain) >> 15;
+
+                    uint32_t edge = _pos < _noteSamples - 1 - _pos ? _pos : _noteSamples - 1 - _pos;
+                    if (edge < _ramp) {
+                        value = value * (int32_t)edge / (int32_t)_ramp;
+                    }
+                    out[i * 2] = (int16_t)value;      // Left
+                    out[i * 2 + 1] = (int16_t)value;  // Right
+                }
+            }
+            written += run;
+
+            if (_pos >= _noteSamples) {
+                _index++;
+                beginNote();
+            }
+        }
+        return written;
+    }
+
+private:
+    void beginNote() {
+        while (active()) {
+            const EarconNote& note = _notes[_index];
+            _noteSamples = (uint32_t)((uint64_t)_rate * note.durationMs / 1000);
+            if (_noteSamples > 0) break;
+            _index++;
+        }
+        if (!active()) return;
+
+        const EarconNote& note = _notes[_index];
+        _pos = 0;
+        _phase = 0;
+        // Phase is a 32-bit fraction of a cycle: top bits index the table
+        _phaseInc = (uint32_t)(((uint64_t)note.frequency << 32) / _rate);
+        _ramp = _rate * EARCON_RAMP_MS / 1000;
+        if (_ramp > _noteSamples / 2) _ramp = _noteSamples / 2;
+        if (_ramp == 0) _ramp = 1;
+    }
+
+    // Linear interpolation between adjacent table points
+    inline int32_t oscillator() {
+        uint32_t index = _phase >> (32 - EARCON_TABLE_BITS);
+        int32_t frac = (_phase >> (32 - EARCON_TABLE_BITS - 16)) & 0xFFFF;
+        int32_t a = EARCON_SINE[index];
+        int32_t b = EARCON_SINE[index + 1];
+        _phase += _phaseInc;
+        return a + (((b - a) * frac) >> 16);
+    }
+
+    const EarconNote* _notes = nullptr;
+    uint8_t _count = 0;
+    uint8_t _index = 0;
+    uint32_t _rate = 16000;
+    int32_t _gain = 0;
+    uint32_t _phase = 0;
+    uint32_t _phaseInc = 0;
+    uint32_t _noteSamples = 0;
+    uint32_t _pos = 0;
+    uint32_t _ramp = 1;
+};
+
+#endif // EARCON_H
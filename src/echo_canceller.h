@@ -0,0 +1,427 @@
+/*
+ * Acoustic Echo Canceller for NOVA
+ * Keeps the wake word usable while a reply plays (barge-in). Playback pushes
+ * what it sends to the speaker, at the mic's rate, into a reference ring; the
+ * capture side subtracts that reference as it comes back through the room.
+ *
+ *   delay  Playback writes up to 2s ahead of the speaker (DMA queue), so the
+ *          two sides are lined up by sample count instead: both counters start
+ *          at the first reference sample, which leaves the echo a fixed lag
+ *          behind as long as playback doesn't underrun. The lag is found by
+ *          correlating 4ms envelopes of mic and reference, and re-checked
+ *          every 0.5s in case it moved.
+ *   NLMS   A time-domain normalized LMS filter, starting `preDelay` taps
+ *          before that lag, models the speaker -> mic path (direct sound and
+ *          early reflections) and subtracts its echo estimate.
+ *
+ * Two paths: a background filter adapts, a foreground copy of it cancels.
+ * The background is copied over only after it beat the foreground for a few
+ * blocks, and the foreground is copied back when the background diverges, so
+ * a wake word that slips past double talk detection can't wreck the output.
+ * The background adapts only while the reference plays and there is no double
+ * talk: the mic envelope well above the loudest recent reference times the
+ * coupling the delay search measured (Geigel), or the foreground's output
+ * well above the residual it usually leaves. There is no residual echo
+ * suppression: the wake word model needs the echo down, not gone.
+ *
+ * pushReference() and process() may run on different cores (one producer,
+ * one consumer); everything else belongs to the capture side. All state is
+ * fixed size, the ring is the caller's. Shared by the firmware and
+ * tools/aec_sim.
+ */
+
+#ifndef ECHO_CANCELLER_H
+#define ECHO_CANCELLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+
+#define ECHO_MAX_TAPS           512     // 32ms at 16kHz
+#define ECHO_BLOCK              64      // Samples per envelope value, 4ms at 16kHz
+#define ECHO_HISTORY_BLOCKS     384     // Envelope history, ~1.5s
+#define ECHO_MAX_LAG_BLOCKS     64      // Longest delay searched, ~256ms
+#define ECHO_SEARCH_BLOCKS      128     // Delay re-checked this often once found, ~0.5s
+#define ECHO_LOCK_BLOCKS        32      // ...and this often until then
+#define ECHO_RING_GUARD         2048    // Reference samples the producer may write during one process()
+#define ECHO_COPY_BLOCKS        3       // Blocks the background has to win before it becomes the foreground
+
+struct EchoCancellerConfig {
+    uint32_t sampleRate;
+    uint16_t taps;              // NLMS filter length, at most ECHO_MAX_TAPS
+    uint16_t preDelay;          // Taps ahead of the estimated delay (the estimate is +-1 block)
+    uint32_t maxDelayMs;        // Delay search range, at most ECHO_MAX_LAG_BLOCKS blocks
+    float stepSize;             // NLMS step, 0..1
+    float minCorrelation;       // Envelope correlation a delay estimate needs
+    float doubleTalkRatio;      // Mic envelope over the expected echo's that means near-end speech
+    uint16_t hangoverBlocks;    // Adaptation stays off this long after double talk
+    int16_t referenceFloor;     // Mean |reference| per block below which nothing adapts
+};
+
+struct EchoCancellerStats {
+    uint32_t blocks;
+    uint32_t echoBlocks;        // Reference playing, delay known, no double talk
+    uint32_t doubleTalkBlocks;
+    uint32_t delayUpdates;
+    uint32_t copies;            // Background filter taken over by the foreground
+    uint32_t resets;            // Background filter thrown away after diverging
+    uint32_t lostReference;     // Reference samples overwritten before they were used
+    double micEnergy;           // Over echo blocks, before and after cancelling
+    double outEnergy;
+};
+
+class EchoCanceller {
+public:
+    /**
+     * @brief Check the config and take the reference ring
+     * @return false if the config is unusable or the ring too small
+     */
+    bool begin(const EchoCancellerConfig& config, int16_t* ring, size_t ringSamples) {
+        if (!ring || config.taps == 0 || config.taps > ECHO_MAX_TAPS || config.preDelay >= config.taps ||
+            ringSamples < (size_t)(2 * ECHO_RING_GUARD + config.taps)) {
+            return false;
+        }
+        _config = config;
+        _ring = ring;
+        _ringSize = (uint32_t)ringSamples;
+        uint32_t lag = (uint32_t)((uint64_t)config.maxDelayMs * config.sampleRate / 1000 / ECHO_BLOCK);
+        _maxLag = lag < ECHO_MAX_LAG_BLOCKS ? lag : ECHO_MAX_LAG_BLOCKS;
+        _regularization = config.taps * (float)config.referenceFloor * config.referenceFloor;
+        reset();
+        return true;
+    }
+
+    /**
+     * @brief Forget the reference, the delay and the filter, e.g. before a
+     * reply. Neither side may be running.
+     */
+    void reset() {
+        _written.store(0, std::memory_order_relaxed);
+        _processed = 0;
+        _blocks = 0;
+        _locked = false;
+        _lag = 0;
+        _candidate = -1;
+        _delay = 0;
+        _coupling = 0.0f;
+        _residual = 1.0f;
+        _lastMicEnergy = _lastOutEnergy = 0.0f;
+        _adapt = false;
+        _hangover = 0;
+        _wins = 0;
+        _pos = 0;
+        _power = 0;
+        memset(_foreground, 0, sizeof(_foreground));
+        memset(_background, 0, sizeof(_background));
+        memset(_history, 0, sizeof(_history));
+        memset(_micEnv, 0, sizeof(_micEnv));
+        memset(_refEnv, 0, sizeof(_refEnv));
+        clearBlock();
+        _stats = EchoCancellerStats();
+    }
+
+    /**
+     * @brief Playback side: append what the speaker will play, at the mic's
+     * rate. nullptr appends silence (a gap the speaker sat through).
+     */
+    void pushReference(const int16_t* samples, size_t count) {
+        uint32_t w = _written.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; i++) {
+            _ring[(w + i) % _ringSize] = samples ? samples[i] : 0;
+        }
+        _written.store(w + (uint32_t)count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Capture side: cancel the echo in `count` mic samples. `out` may
+     * be `mic`. Until the first reference sample there is nothing to cancel
+     * and the mic passes through.
+     */
+    void process(const int16_t* mic, int16_t* out, size_t count) {
+        _seen = _written.load(std::memory_order_acquire);
+        if (_seen == 0) {
+            if (out != mic) memmove(out, mic, count * sizeof(int16_t));
+            return;
+        }
+
+        const int taps = _config.taps;
+        for (size_t i = 0; i < count; i++) {
+            float d = mic[i];
+            float e = d, eb = d;
+            int16_t r = reference(_processed);
+
+            if (_locked) {
+                int16_t x = reference((int64_t)_processed - _delay);
+                _pos = _pos == 0 ? taps - 1 : _pos - 1;
+                int32_t old = (int32_t)_history[_pos];
+                _history[_pos] = _history[_pos + taps] = x;
+                _power += (int64_t)x * x - (int64_t)old * old;
+
+                const float* h = &_history[_pos];
+                float y = 0.0f, yb = 0.0f;
+                for (int k = 0; k < taps; k++) {
+                    y += _foreground[k] * h[k];
+                    yb += _background[k] * h[k];
+                }
+                e = d - y;
+                eb = d - yb;
+                if (_adapt) {
+                    float g = _config.stepSize * eb / ((float)_power + _regularization);
+                    for (int k = 0; k < taps; k++) _background[k] += g * h[k];
+                }
+            }
+
+            out[i] = e > 32767.0f ? 32767 : e < -32768.0f ? -32768 : (int16_t)lrintf(e);
+            _blockMic += fabsf(d);
+            _blockRef += r < 0 ? -r : r;
+            _blockMicEnergy += d * d;
+            _blockOutEnergy += e * e;
+            _blockBackgroundEnergy += eb * eb;
+            _processed++;
+            if (++_blockFill == ECHO_BLOCK) endBlock();
+        }
+    }
+
+    bool locked() const {
+        return _locked;
+    }
+
+    /**
+     * @brief Estimated echo delay in samples, -1 until found
+     */
+    int32_t delay() const {
+        return _locked ? (int32_t)(_lag * ECHO_BLOCK) : -1;
+    }
+
+    /**
+     * @brief Echo return loss enhancement over the echo-only blocks so far, dB
+     */
+    float erle() const {
+        if (_stats.outEnergy <= 0.0 || _stats.micEnergy <= 0.0) return 0.0f;
+        return (float)(10.0 * log10(_stats.micEnergy / _stats.outEnergy));
+    }
+
+    const EchoCancellerStats& stats() const {
+        return _stats;
+    }
+
+private:
+    // Reference sample `index`, 0 before playback, not written yet, or already overwritten
+    int16_t reference(int64_t index) {
+        if (index < 0 || index >= (int64_t)_seen) return 0;
+        if ((int64_t)_seen - index > (int64_t)(_ringSize - ECHO_RING_GUARD)) {
+            _stats.lostReference++;
+            return 0;
+        }
+        return _ring[(uint32_t)index % _ringSize];
+    }
+
+    void clearBlock() {
+        _blockFill = 0;
+        _blockMic = _blockRef = 0.0f;
+        _blockMicEnergy = _blockOutEnergy = _blockBackgroundEnergy = 0.0f;
+    }
+
+    void endBlock() {
+        uint32_t slot = _blocks % ECHO_HISTORY_BLOCKS;
+        float micEnv = _blockMic / ECHO_BLOCK;
+        _micEnv[slot] = micEnv;
+        _refEnv[slot] = _blockRef / ECHO_BLOCK;
+        _blocks++;
+        _stats.blocks++;
+
+        if (_locked) {
+            // Loudest reference that can still be ringing in this block
+            float recent = 0.0f;
+            int32_t newest = (int32_t)_blocks - 1 - (int32_t)_lag + _config.preDelay / ECHO_BLOCK;
+            int32_t oldest = newest - _config.taps / ECHO_BLOCK - 1;
+            for (int32_t b = newest; b >= oldest && b >= 0; b--) {
+                if (b >= (int32_t)_blocks) continue;
+                float v = _refEnv[b % ECHO_HISTORY_BLOCKS];
+                if (v > recent) recent = v;
+            }
+            bool echo = recent >= _config.referenceFloor;
+            // Near-end speech either lifts the mic over the echo the reference explains (Geigel), or lifts
+            // the foreground's output over the residual it usually leaves (the foreground doesn't chase it)
+            float ratio = _config.doubleTalkRatio;
+            float micEnergy = _blockMicEnergy + _lastMicEnergy, outEnergy = _blockOutEnergy + _lastOutEnergy;
+            _lastMicEnergy = _blockMicEnergy;
+            _lastOutEnergy = _blockOutEnergy;
+            float residual = micEnergy > 0.0f ? outEnergy / micEnergy : 1.0f;
+            bool doubleTalk = echo && (micEnv > ratio * _coupling * recent || residual > ratio * _residual);
+            if (doubleTalk) {
+                _hangover = _config.hangoverBlocks;
+                _stats.doubleTalkBlocks++;
+            } else if (_hangover > 0) {
+                _hangover--;
+            }
+
+            bool quiet = echo && !doubleTalk && _hangover == 0;
+            if (echo) {
+                // Slowly even through double talk, so a changed echo path is learned again instead of frozen out
+                _residual += (residual - _residual) * (quiet ? 1.0f / 16 : 1.0f / 1024);
+                if (_residual > 1.0f) _residual = 1.0f;
+            }
+            if (quiet) {
+                _stats.echoBlocks++;
+                _stats.micEnergy += _blockMicEnergy;
+                _stats.outEnergy += _blockOutEnergy;
+            }
+
+            // Background adding echo instead of removing it: start over rather than keep going the wrong way
+            if (_blockBackgroundEnergy > 4.0f * _blockMicEnergy && _blockBackgroundEnergy > _blockOutEnergy) {
+                memcpy(_background, _foreground, sizeof(_background));
+                _wins = 0;
+                _stats.resets++;
+            } else if (quiet && _blockBackgroundEnergy < 0.7f * _blockOutEnergy) {
+                // Clearly better on echo-only blocks: worth cancelling with
+                if (++_wins >= ECHO_COPY_BLOCKS) {
+                    memcpy(_foreground, _background, sizeof(_foreground));
+                    _wins = 0;
+                    _stats.copies++;
+                }
+            } else {
+                _wins = 0;
+            }
+            _adapt = quiet;
+        }
+        clearBlock();
+
+        uint32_t every = _locked ? ECHO_SEARCH_BLOCKS : ECHO_LOCK_BLOCKS;
+        if (_blocks % every == 0 && _blocks >= _maxLag + ECHO_SEARCH_BLOCKS) searchDelay();
+    }
+
+    // Correlate the mic envelope with the reference envelope at every lag
+    void searchDelay() {
+        uint32_t span = (_blocks < ECHO_HISTORY_BLOCKS ? _blocks : ECHO_HISTORY_BLOCKS) - _maxLag;
+        uint32_t first = _blocks - span;
+
+        float micMean = 0.0f;
+        for (uint32_t b = first; b < _blocks; b++) micMean += _micEnv[b % ECHO_HISTORY_BLOCKS];
+        micMean /= span;
+        float micVar = 0.0f;
+        for (uint32_t b = first; b < _blocks; b++) {
+            float m = _micEnv[b % ECHO_HISTORY_BLOCKS] - micMean;
+            micVar += m * m;
+        }
+        if (micVar <= 0.0f) return;
+
+        float bestCorrelation = 0.0f, bestSlope = 0.0f;
+        uint32_t bestLag = 0;
+        for (uint32_t lag = 0; lag <= _maxLag; lag++) {
+            float refMean = 0.0f;
+            for (uint32_t b = first; b < _blocks; b++) refMean += _refEnv[(b - lag) % ECHO_HISTORY_BLOCKS];
+            refMean /= span;
+            float cov = 0.0f, refVar = 0.0f;
+            for (uint32_t b = first; b < _blocks; b++) {
+                float m = _micEnv[b % ECHO_HISTORY_BLOCKS] - micMean;
+                float r = _refEnv[(b - lag) % ECHO_HISTORY_BLOCKS] - refMean;
+                cov += m * r;
+                refVar += r * r;
+            }
+            if (refVar <= 0.0f) continue;
+            float correlation = cov / sqrtf(micVar * refVar);
+            if (correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                bestSlope = cov / refVar;
+                bestLag = lag;
+            }
+        }
+        // A silent or flat reference says nothing about the delay: keep the last one
+        if (bestCorrelation < _config.minCorrelation) return;
+
+        int32_t moved = (int32_t)bestLag - (int32_t)_lag;
+        if (_locked && moved >= -1 && moved <= 1) {
+            _coupling = bestSlope;
+            _candidate = -1;
+            return;
+        }
+        // A locked delay only moves when two searches in a row agree on where to
+        int32_t fromCandidate = (int32_t)bestLag - _candidate;
+        if (_locked && (_candidate < 0 || fromCandidate < -1 || fromCandidate > 1)) {
+            _candidate = (int32_t)bestLag;
+            return;
+        }
+        _coupling = bestSlope;
+        _candidate = -1;
+        setDelay((int32_t)(bestLag * ECHO_BLOCK) - _config.preDelay);
+        _lag = bestLag;
+        _locked = true;
+        _stats.delayUpdates++;
+    }
+
+    // Move the filter to a new bulk delay, keeping the taps that still line up
+    void setDelay(int32_t delay) {
+        const int taps = _config.taps;
+        if (_locked) {
+            shiftTaps(_foreground, delay - _delay);
+            shiftTaps(_background, delay - _delay);
+        }
+        _delay = delay;
+
+        // The window as it would be had the filter always run at this delay
+        _power = 0;
+        for (int k = 0; k < taps; k++) {
+            int16_t x = reference((int64_t)_processed - 1 - delay - k);
+            _history[k] = _history[k + taps] = x;
+            _power += (int64_t)x * x;
+        }
+        _pos = 0;
+    }
+
+    // New tap k is old tap k + shift
+    void shiftTaps(float* weights, int32_t shift) {
+        const int taps = _config.taps;
+        if (shift >= taps || shift <= -taps) {
+            memset(weights, 0, taps * sizeof(float));
+        } else if (shift > 0) {
+            memmove(weights, weights + shift, (taps - shift) * sizeof(float));
+            memset(weights + taps - shift, 0, shift * sizeof(float));
+        } else if (shift < 0) {
+            memmove(weights - shift, weights, (taps + shift) * sizeof(float));
+            memset(weights, 0, -shift * sizeof(float));
+        }
+    }
+
+    EchoCancellerConfig _config = {};
+    int16_t* _ring = nullptr;
+    uint32_t _ringSize = 0;
+    std::atomic<uint32_t> _written{0};  // Reference samples pushed
+    uint32_t _seen = 0;                 // _written as of this process() call
+    uint32_t _processed = 0;            // Mic samples since the first reference sample
+    uint32_t _maxLag = 0;               // Blocks
+    float _regularization = 0.0f;
+
+    // Delay
+    uint32_t _blocks = 0;
+    float _micEnv[ECHO_HISTORY_BLOCKS];
+    float _refEnv[ECHO_HISTORY_BLOCKS]; // Reference at lag 0
+    bool _locked = false;
+    uint32_t _lag = 0;                  // Blocks
+    int32_t _candidate = -1;            // Lag one search found away from _lag, waiting for a second
+    int32_t _delay = 0;                 // Samples from mic to filter tap 0
+    float _coupling = 0.0f;             // Mic envelope per unit of reference envelope
+    float _residual = 1.0f;             // Output over mic energy on echo-only blocks, smoothed
+
+    // Filter
+    float _foreground[ECHO_MAX_TAPS];   // Cancels
+    float _background[ECHO_MAX_TAPS];   // Adapts
+    float _history[2 * ECHO_MAX_TAPS];  // Mirrored so the window is always contiguous
+    int _pos = 0;
+    int64_t _power = 0;                 // Sum of squares over the window
+    bool _adapt = false;
+    uint16_t _hangover = 0;
+    uint16_t _wins = 0;                 // Blocks in a row the background beat the foreground
+
+    // Current block
+    int _blockFill = 0;
+    float _blockMic, _blockRef;
+    float _blockMicEnergy, _blockOutEnergy, _blockBackgroundEnergy;
+    float _lastMicEnergy = 0.0f, _lastOutEnergy = 0.0f;
+
+    EchoCancellerStats _stats;
+};
+
+#endif // ECHO_CANCELLER_H
@@ -5,21 +5,87 @@
 #include "esp_wifi.h"
 
 #include <driver/i2s.h>
+#include <new>
 #include <Adafruit_NeoPixel.h>
 #include "config.h"
+#include "resampler.h"
+#include "chunked_decoder.h"
+#include "telemetry.h"
+#include "earcon.h"
+#include "wake_engine.h"
 
 // Edge Impulse Wake Word
 #include <test-new_inferencing.h>
+#include "memory_pool.h"
+#include "score_capture.h"
+#include "wake_preroll.h"
+#include "wake_slices.h"
+#include "mic_agc.h"
+#include "echo_canceller.h"
+#include "noise_suppressor.h"
+#include "mic_diagnostics.h"
 
 // ============== Wake Word Configuration ==============
 // Optimized settings for WORKING detection with poorly trained model
-#define WAKE_WORD_CONFIDENCE 0.92f  // 92% threshold (strict - prevents false triggers)
-#define CONSECUTIVE_DETECTIONS 1    // Single detection (responsive - model is flaky)
+// Threshold and suppression as tuned on the device for the old per-window check;
+// re-tune with tools/wake_eval on real recordings (see wake_engine.h)
+#define WAKE_WORD_LABEL "Nova"
+#define WAKE_WORD_CONFIDENCE 0.92f  // Averaged Nova score needed to trigger
+#define WAKE_AVERAGE_MS 750         // Scores averaged over 3 slices (a word the model is unsure of rarely holds)
+#define WAKE_SUPPRESSION_MS 3000    // Prevent rapid re-triggering
 #define NOISE_GATE_THRESHOLD 200    // Minimum audio level to process (filters background noise)
 #define WAKE_WORD_GAIN 8            // 8x gain to match Edge Impulse portal example
-#define CONFIDENCE_GAP 0.30f        // Nova score must be 30% higher than Noise/Unknown (strict)
 #define DEBUG_WAKE_WORD false       // Disable debug output for production use
 
+// ============== Mic AGC ==============
+// One envelope over the mic drives the wake word and upload gains (see mic_agc.h)
+// Evaluated with tools/agc_eval. false: fixed WAKE_WORD_GAIN (wraps when loud), raw upload
+#define MIC_AGC true
+#define AGC_WAKE_TARGET 24000       // Model input peak level; quieter input keeps WAKE_WORD_GAIN
+#define AGC_WAKE_RELEASE_MS 500
+#define AGC_UPLOAD_TARGET 16000     // Upload peaks at -6 dBFS for STT
+#define AGC_UPLOAD_MAX_GAIN 8.0f    // Quiet rooms: up to 8x, never on silence (gate)
+#define AGC_UPLOAD_RELEASE_MS 1000
+#define AGC_ENVELOPE_RELEASE_MS 300
+#define AGC_LIMIT 30000             // Limiter ceiling, about -0.8 dBFS
+
+// ============== Noise Suppression ==============
+// Spectral suppression of steady background noise on the upload, after its AGC
+// (see noise_suppressor.h). Tuned with tools/ns_eval. The wake word and pre-roll stay raw
+#define NOISE_SUPPRESSION true
+#define NS_NOISE_WINDOW_MS 1500     // Minimum statistics window, longer than a word
+#define NS_OVERESTIMATE 2.0f
+#define NS_FLOOR_DB -15.0f          // Deeper floors add musical noise STT trips over
+#define NS_SMOOTHING 0.98f
+
+// ============== Mic Test ==============
+// 'r [delay ms] [seconds]' on serial: the mic streams to the speaker through a delay
+// line, with a live meter and a report at the end (see mic_diagnostics.h).
+// Everything lives in POOL_RECORD, already reserved: no allocation
+#define MIC_TEST_DELAY_MS 500       // On top of the DMA's; 0 plays straight through
+#define MIC_TEST_SECONDS 10
+#define MIC_TEST_MAX_SECONDS 300
+#define MIC_TEST_READ_SAMPLES 512   // 32ms blocks, as the barge-in task reads
+#define MIC_TEST_CLIP_LEVEL 32000
+#define MIC_TEST_DEAD_PEAK 100      // Under this peak nothing is connected
+#define MIC_TEST_MAX_DC 1000
+
+// ============== Barge-in ==============
+// While a reply plays, a core 0 task echo-cancels the mic and fills the wake word
+// slices; playback classifies them between speaker writes (see echo_canceller.h)
+// Tuned with tools/aec_sim. ECHO_REFERENCE_MS 0 (config.h) turns it off
+#define AEC_TAPS 384                // 24ms of speaker -> mic path
+#define AEC_PRE_DELAY 128           // Taps ahead of the estimated delay
+#define AEC_MAX_DELAY_MS 250        // DMA, converter and acoustic delay searched
+#define AEC_STEP_SIZE 0.5f
+#define AEC_MIN_CORRELATION 0.5f
+#define AEC_DOUBLE_TALK_RATIO 2.0f  // 6 dB over the expected echo or residual
+#define AEC_HANGOVER_BLOCKS 16      // 64ms
+#define AEC_REFERENCE_FLOOR 64      // Quieter reference blocks don't adapt
+#define BARGE_IN_READ_SAMPLES 512   // 32ms per canceller pass
+#define BARGE_IN_TASK_STACK 4096
+#define BARGE_IN_TASK_PRIORITY 5
+
 // ============== Button Configuration ==============
 #define BUTTON_PIN 4
 #define LONG_PRESS_TIME 3000  // 3 seconds for power off
@@ -30,7 +96,6 @@ bool buttonWasPressed = false;
 // ============== Global State ==============
 bool isRecording = false;
 bool isPlaying = false;
-int consecutiveWakeDetections = 0;
 static bool micReady = false;
 
 
@@ -54,17 +119,15 @@ enum Emotion {
 Emotion currentEmotion = EMOTION_NORMAL;
 
 // Audio buffers for wake word (continuous inference with double buffering)
-typedef struct {
-    int16_t *buffers[2];
-    uint8_t buf_select;
-    uint8_t buf_ready;
-    uint32_t buf_count;
-    uint32_t n_samples;
-} inference_t;
-
-static inference_t inference;
+static int16_t* wakeSliceBuffers[2] = { NULL, NULL };
+static WakeSlices wakeSlices;       // The barge-in task fills slices from the other core
 static int16_t sampleBuffer[2048];  // Temporary buffer for I2S reads
-static int print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);  // Print after full window
+static WakeEngine wakeEngine;
+static MicAgc micAgc;
+#if NOISE_SUPPRESSION
+static NoiseSuppressor noiseSuppressor;
+static bool noiseSuppressorReady = false;   // A rejected config leaves uploads as recorded
+#endif
 
 // ============== NeoPixel Setup ==============
 Adafruit_NeoPixel pixels(NUM_LEDS, RGB_LED_PIN, NEO_GRB + NEO_KHZ800);
@@ -105,42 +168,6 @@ void setLedColor(uint8_t r, uint8_t g, uint8_t b) {
     pixels.show();
 }
 
-// ============== Audio Preprocessing Variables ==============
-static float dcOffsetFilter = 0.0f;
-static const float DC_FILTER_ALPHA = 0.95f; // High-pass filter coefficient
-
-// Simple low-pass filter for noise reduction
-static int16_t lastSample = 0;
-static const float LOWPASS_ALPHA = 0.85f; // INCREASED: Less aggressive filtering (0.0-1.0)
-
-// DC offset removal (high-pass filter)
-int16_t removeDCOffset(int16_t sample) {
-    dcOffsetFilter = DC_FILTER_ALPHA * dcOffsetFilter + (1.0f - DC_FILTER_ALPHA) * sample;
-    return sample - (int16_t)dcOffsetFilter;
-}
-
-// Low-pass filter to remove high-frequency noise (gentle)
-int16_t lowPassFilter(int16_t sample) {
-    lastSample = (int16_t)(LOWPASS_ALPHA * sample + (1.0f - LOWPASS_ALPHA) * lastSample);
-    return lastSample;
-}
-
-// Gentle noise reduction - applies minimal filtering
-int16_t reduceNoise(int16_t sample) {
-    // Step 1: Remove DC offset only
-    sample = removeDCOffset(sample);
-
-    // Step 2: Very gentle low-pass filter (optional, can be disabled)
-    // sample = lowPassFilter(sample);  // Commented out - too aggressive
-
-    // Step 3: Gentle noise gate - only suppress dead silence
-    if (abs(sample) < 10) {  // REDUCED: Lower threshold for noise floor
-        sample = 0;
-    }
-
-    return sample;
-}
-
 // Voice Activity Detection (VAD) - checks if audio has speech energy
 bool isVoiceActivity(int16_t* buffer, size_t samples) {
     int32_t energy = 0;
@@ -195,8 +222,8 @@ void setupSpeaker() {
         .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
         .communication_format = (i2s_comm_format_t)I2S_COMM_FORMAT_STAND_I2S,
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = 16,   // Increased from 8 for more buffer headroom
-        .dma_buf_len = 1024,   // Increased from 512 for smoother streaming
+        .dma_buf_count = SPK_DMA_BUF_COUNT,   // Increased from 8 for more buffer headroom
+        .dma_buf_len = SPK_DMA_BUF_LEN,       // Increased from 512 for smoother streaming
         .use_apll = false,     // Standard clock (APLL can cause speed issues)
         .tx_desc_auto_clear = true,
         .fixed_mclk = 0
@@ -214,6 +241,21 @@ void setupSpeaker() {
     Serial.println("[SPK] Speaker initialized (16kHz stereo, 16KB DMA buffer)");
 }
 
+static uint32_t speakerSampleRate = SAMPLE_RATE;
+static uint32_t earconDrainsAt = 0;     // millis() by which the queued earcons have played
+static PolyphaseResampler streamResampler;
+
+// Re-clock the speaker I2S without reinstalling the driver. Frames still in the
+// DMA would play at the new rate, so a queued earcon is let out first
+void setSpeakerSampleRate(uint32_t rate) {
+    if (rate == speakerSampleRate) return;
+    int32_t pending = (int32_t)(earconDrainsAt - millis());
+    if (pending > 0) delay(pending);
+    i2s_set_sample_rates(SPK_I2S_NUM, rate);
+    speakerSampleRate = rate;
+    Serial.printf("[SPK] Sample rate: %u Hz\n", rate);
+}
+
 // ============== Display Functions Removed ==============
 // Pure audio speaker - no screen needed
 
@@ -240,76 +282,66 @@ Emotion parseEmotionString(String emotion) {
 // ============== Sound Effects System ==============
 // Alexa-style soothing sound effects for user feedback
 
-void playTone(int frequency, int duration_ms, float volume = 0.3) {
-    const int sample_rate = 16000;
-    const int num_samples = (sample_rate * duration_ms) / 1000;
-
-    int16_t* samples = (int16_t*)malloc(num_samples * 4); // stereo
-    if (!samples) return;
+static EarconPlayer earconPlayer;
 
-    for (int i = 0; i < num_samples; i++) {
-        float t = (float)i / sample_rate;
-        int16_t value = (int16_t)(sin(2.0 * M_PI * frequency * t) * 32767 * volume);
-        samples[i * 2] = value;      // Left
-        samples[i * 2 + 1] = value;  // Right
-    }
-
-    size_t bytes_written;
-    i2s_write(SPK_I2S_NUM, samples, num_samples * 4, &bytes_written, portMAX_DELAY);
-    free(samples);
-}
-
-void playMelody(int* frequencies, int* durations, int count, float volume = 0.3) {
-    for (int i = 0; i < count; i++) {
-        if (frequencies[i] > 0) {
-            playTone(frequencies[i], durations[i], volume);
-        } else {
-            delay(durations[i]); // Rest/pause
-        }
+/**
+ * @brief Play an earcon. Rendering is a table lookup per sample, and the
+ * speaker DMA queue (~1s) absorbs the whole chime, so this returns as soon
+ * as the frames are queued rather than after they have played.
+ */
+void playEarcon(const EarconNote* notes, uint8_t count, float volume = 0.3) {
+    int16_t* stereo = (int16_t*)memoryPoolCheckout(POOL_STREAM_STEREO);
+    if (!stereo) return;
+    const size_t block = memoryPoolSize(POOL_STREAM_STEREO) / 4; // stereo frames
+
+    earconPlayer.start(notes, count, volume, speakerSampleRate);
+    // It plays after whatever earcon is still queued; one DMA buffer of slack
+    // for the one being clocked out
+    uint32_t now = millis();
+    uint32_t startsAt = (int32_t)(earconDrainsAt - now) > 0 ? earconDrainsAt : now;
+    size_t frames, total = SPK_DMA_BUF_LEN, bytes_written;
+    while ((frames = earconPlayer.render(stereo, block)) > 0) {
+        i2s_write(SPK_I2S_NUM, stereo, frames * 4, &bytes_written, portMAX_DELAY);
+        total += frames;
     }
+    earconDrainsAt = startsAt + (uint32_t)((uint64_t)total * 1000 / speakerSampleRate);
+    memoryPoolCheckin(POOL_STREAM_STEREO);
 }
 
 // Sound effect definitions
 void soundStartup() {
-    int freq[] = {523, 659, 784};  // C5, E5, G5 (C major chord ascending)
-    int dur[] = {150, 150, 300};
-    playMelody(freq, dur, 3, 0.2);
+    static const EarconNote notes[] = {{523, 150}, {659, 150}, {784, 300}};  // C5, E5, G5 (C major chord ascending)
+    playEarcon(notes, 3, 0.2);
 }
 
 void soundMute() {
-    int freq[] = {880, 440};  // A5 to A4 (descending - going quiet)
-    int dur[] = {100, 200};
-    playMelody(freq, dur, 2, 0.15);
+    static const EarconNote notes[] = {{880, 100}, {440, 200}};  // A5 to A4 (descending - going quiet)
+    playEarcon(notes, 2, 0.15);
 }
 
 void soundUnmute() {
-    int freq[] = {440, 880};  // A4 to A5 (ascending - becoming active)
-    int dur[] = {100, 200};
-    playMelody(freq, dur, 2, 0.15);
+    static const EarconNote notes[] = {{440, 100}, {880, 200}};  // A4 to A5 (ascending - becoming active)
+    playEarcon(notes, 2, 0.15);
 }
 
 void soundListening() {
-    int freq[] = {1047};  // C6 (high ping - attention)
-    int dur[] = {150};
-    playMelody(freq, dur, 1, 0.2);
+    static const EarconNote notes[] = {{1047, 150}};  // C6 (high ping - attention)
+    playEarcon(notes, 1, 0.2);
 }
 
 void soundProcessing() {
-    int freq[] = {523, 659};  // C5, E5 (gentle pulse - thinking)
-    int dur[] = {200, 200};
-    playMelody(freq, dur, 2, 0.15);
+    static const EarconNote notes[] = {{523, 200}, {659, 200}};  // C5, E5 (gentle pulse - thinking)
+    playEarcon(notes, 2, 0.15);
 }
 
 void soundSuccess() {
-    int freq[] = {659, 784, 1047};  // E5, G5, C6 (rising - positive)
-    int dur[] = {100, 100, 200};
-    playMelody(freq, dur, 3, 0.2);
+    static const EarconNote notes[] = {{659, 100}, {784, 100}, {1047, 200}};  // E5, G5, C6 (rising - positive)
+    playEarcon(notes, 3, 0.2);
 }
 
 void soundError() {
-    int freq[] = {392, 330};  // G4, E4 (descending - error)
-    int dur[] = {200, 300};
-    playMelody(freq, dur, 2, 0.15);
+    static const EarconNote notes[] = {{392, 200}, {330, 300}};  // G4, E4 (descending - error)
+    playEarcon(notes, 2, 0.15);
 }
 
 // ============== WiFi Connection ==============
@@ -402,8 +434,9 @@ void connectWiFi() {
  */
 static int microphone_audio_signal_get_data(size_t offset, size_t length, float *out_ptr) {
     // Convert int16 to float from the inactive buffer
+    const int16_t* slice = wakeSlices.slice();
     for (size_t i = 0; i < length; i++) {
-        out_ptr[i] = (float)inference.buffers[inference.buf_select ^ 1][offset + i];
+        out_ptr[i] = (float)slice[offset + i];
     }
     return 0;
 }
@@ -412,23 +445,26 @@ static int microphone_audio_signal_get_data(size_t offset, size_t length, float
  * @brief Initialize continuous inference buffers
  */
 static bool microphone_inference_start(uint32_t n_samples) {
-    inference.buffers[0] = (int16_t *)malloc(n_samples * sizeof(int16_t));
-    if (inference.buffers[0] == NULL) {
+    if (n_samples * sizeof(int16_t) > memoryPoolSize(POOL_WAKE_SLICE_0)) {
+        Serial.println("[WAKE] Slice larger than wake word pool");
+        return false;
+    }
+
+    wakeSliceBuffers[0] = (int16_t *)memoryPoolCheckout(POOL_WAKE_SLICE_0);
+    if (wakeSliceBuffers[0] == NULL) {
         Serial.println("[WAKE] Failed to allocate buffer 0");
         return false;
     }
 
-    inference.buffers[1] = (int16_t *)malloc(n_samples * sizeof(int16_t));
-    if (inference.buffers[1] == NULL) {
-        free(inference.buffers[0]);
+    wakeSliceBuffers[1] = (int16_t *)memoryPoolCheckout(POOL_WAKE_SLICE_1);
+    if (wakeSliceBuffers[1] == NULL) {
+        memoryPoolCheckin(POOL_WAKE_SLICE_0);
+        wakeSliceBuffers[0] = NULL;
         Serial.println("[WAKE] Failed to allocate buffer 1");
         return false;
     }
 
-    inference.buf_select = 0;
-    inference.buf_count = 0;
-    inference.n_samples = n_samples;
-    inference.buf_ready = 0;
+    wakeSlices.begin(wakeSliceBuffers[0], wakeSliceBuffers[1], n_samples);
 
     Serial.printf("[WAKE] Continuous inference initialized (slice size: %d samples)\n", n_samples);
     return true;
@@ -438,10 +474,47 @@ static bool microphone_inference_start(uint32_t n_samples) {
  * @brief Stop continuous inference and free buffers
  */
 static void microphone_inference_end(void) {
-    if (inference.buffers[0]) free(inference.buffers[0]);
-    if (inference.buffers[1]) free(inference.buffers[1]);
-    inference.buffers[0] = NULL;
-    inference.buffers[1] = NULL;
+    if (wakeSliceBuffers[0]) memoryPoolCheckin(POOL_WAKE_SLICE_0);
+    if (wakeSliceBuffers[1]) memoryPoolCheckin(POOL_WAKE_SLICE_1);
+    wakeSliceBuffers[0] = NULL;
+    wakeSliceBuffers[1] = NULL;
+}
+
+/**
+ * @brief Classify the ready slice and run the wake engine on it
+ * @param detectMs DSP + NN time of the slice
+ */
+static WakeVerdict classifyWakeSlice(uint16_t* detectMs) {
+    if (!wakeEngine.ready()) {
+        return WAKE_SKIPPED;  // begin() failed in setup(), no wake label to read
+    }
+
+    // Run continuous classifier (accumulates slices internally)
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = &microphone_audio_signal_get_data;
+    ei_impulse_result_t result = {0};
+
+    EI_IMPULSE_ERROR res = run_classifier_continuous(&signal, &result, DEBUG_WAKE_WORD);
+
+    if (res != EI_IMPULSE_OK) {
+        Serial.printf("[WAKE] Inference error: %d\n", res);
+        return WAKE_SKIPPED;
+    }
+    scoreCaptureAppend(&result);
+    *detectMs = telemetryClampMs(result.timing.dsp + result.timing.classification);
+
+    // Running average + threshold + suppression, see wake_engine.h
+    WakeVerdict verdict = wakeEngine.update(&result);
+    float novaScore = result.classification[wakeEngine.wakeIndex()].value;
+
+    if (verdict == WAKE_DETECTED) {
+        Serial.printf("[WAKE] ✓ Nova: %.2f (averaged %.2f)\n", novaScore, wakeEngine.averagedWake());
+        Serial.println("\n[WAKE] ========== WAKE WORD DETECTED! ==========\n");
+    } else if (verdict == WAKE_REJECTED && (DEBUG_WAKE_WORD || novaScore > 0.3)) {
+        Serial.printf("[WAKE] Nova: %.2f (averaged %.2f)\n", novaScore, wakeEngine.averagedWake());
+    }
+    return verdict;
 }
 
 // ============== Continuous Wake Word Detection Function ==============
@@ -459,110 +532,210 @@ bool detectWakeWord() {
         return false;
     }
 
-    // Apply 8x gain to match Edge Impulse portal (like the official example)
-    for (int i = 0; i < bytesRead / 2; i++) {
-        sampleBuffer[i] = (int16_t)(sampleBuffer[i] * 8);
+    // Only what fits in the current slice gets classified, the rest of the read is dropped.
+    // The pre-roll keeps those samples raw.
+    size_t count = bytesRead / 2;
+    size_t used = min(count, wakeSlices.space());
+    for (size_t i = 0; i < used; i++) {
+        wakePrerollPush(sampleBuffer[i]);
     }
 
-    // Fill the double buffer (ping-pong buffering)
-    for (int i = 0; i < bytesRead / 2; i++) {
-        inference.buffers[inference.buf_select][inference.buf_count++] = sampleBuffer[i];
-
-        if (inference.buf_count >= inference.n_samples) {
-            // Buffer full, switch buffers
-            inference.buf_select ^= 1;
-            inference.buf_count = 0;
-            inference.buf_ready = 1;
-            break;
-        }
+#if MIC_AGC
+    // Wake word gain, in place; the upload gain follows the room meanwhile
+    micAgc.process(sampleBuffer, sampleBuffer, nullptr, count);
+#else
+    // 8x gain to match Edge Impulse portal (like the official example)
+    for (size_t i = 0; i < used; i++) {
+        sampleBuffer[i] = (int16_t)(sampleBuffer[i] * WAKE_WORD_GAIN);
     }
+#endif
+
+    wakeSlices.fill(sampleBuffer, used);
 
     // Only run inference when we have a full slice ready
-    if (inference.buf_ready == 0) {
+    if (!wakeSlices.ready()) {
         return false;
     }
 
-    inference.buf_ready = 0;
-
-    // Run continuous classifier (accumulates slices internally)
-    signal_t signal;
-    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
-    signal.get_data = &microphone_audio_signal_get_data;
-    ei_impulse_result_t result = {0};
-
-    EI_IMPULSE_ERROR res = run_classifier_continuous(&signal, &result, DEBUG_WAKE_WORD);
-
-    if (res != EI_IMPULSE_OK) {
-        Serial.printf("[WAKE] Inference error: %d\n", res);
+    uint16_t detectMs;
+    WakeVerdict verdict = classifyWakeSlice(&detectMs);
+    wakeSlices.release();
+    if (verdict != WAKE_DETECTED) {
         return false;
     }
+    telemetryBeginTurn(TURN_WAKE_WORD);
+    telemetryTurn()->wakeDetectMs = detectMs;
+    return true;
+}
 
-    // Only check results after processing a full window (4 slices = 1 second)
-    if (++print_results >= EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW) {
-        // Find scores for "Nova", "noise", and "unknown"
-        float novaScore = 0.0f;
-        float noiseScore = 0.0f;
-        float unknownScore = 0.0f;
+// ============== Barge-in ==============
+#if ECHO_REFERENCE_MS > 0
+static EchoCanceller echoCanceller;
+static PolyphaseResampler referenceResampler;   // Speaker rate -> SAMPLE_RATE
+static TaskHandle_t bargeInTaskHandle = NULL;
+static volatile bool bargeInActive = false;     // Reply playing, the task is cancelling
+static volatile bool bargeInIdle = true;        // The task is waiting for the next reply
+static volatile uint32_t bargeInOverruns = 0;   // Mic reads dropped, a slice still waited for the classifier
+static int16_t bargeInBuffer[BARGE_IN_READ_SAMPLES];
+static uint16_t bargeInDetectMs = 0;
+static bool bargeInPending = false;             // Reply cut short, loop() still has to start the turn
 
-        for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
-            const char* label = result.classification[i].label;
-            float score = result.classification[i].value;
+/**
+ * @brief Core 0, away from playback and the classifier: mic -> echo canceller ->
+ * pre-roll and wake word gain -> slices
+ */
+static void bargeInTask(void* param) {
+    size_t bytesRead;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
-            if (strcmp(label, "Nova") == 0) {
-                novaScore = score;
-            } else if (strcmp(label, "noise") == 0) {
-                noiseScore = score;
-            } else if (strcmp(label, "unknown") == 0) {
-                unknownScore = score;
-            }
+        // Mic audio queued before the reply would put the echo far behind its reference
+        while (i2s_read(MIC_I2S_NUM, bargeInBuffer, sizeof(bargeInBuffer), &bytesRead, 0) == ESP_OK) {
         }
 
-        // Check if Nova score meets all criteria
-        float maxOtherScore = max(noiseScore, unknownScore);
-
-        // WORKAROUND: Add cooldown to prevent rapid re-triggering
-        // With poorly trained model (Noise always 0.00), just rely on high confidence threshold
-        static unsigned long lastTriggerTime = 0;
-        unsigned long currentTime = millis();
-        bool cooldownPassed = (currentTime - lastTriggerTime > 3000); // 3 second cooldown
-
-        bool detected = (novaScore >= WAKE_WORD_CONFIDENCE) &&
-                        (novaScore > maxOtherScore + CONFIDENCE_GAP) &&
-                        cooldownPassed;
-
-        if (detected) {
-            consecutiveWakeDetections++;
-            Serial.printf("[WAKE] ✓ Nova: %.2f | Noise: %.2f | Unknown: %.2f | Consecutive: %d/%d\n",
-                          novaScore, noiseScore, unknownScore,
-                          consecutiveWakeDetections, CONSECUTIVE_DETECTIONS);
-
-            if (consecutiveWakeDetections >= CONSECUTIVE_DETECTIONS) {
-                Serial.println("\n[WAKE] ========== WAKE WORD DETECTED! ==========\n");
-                lastTriggerTime = currentTime; // Set cooldown timer
-                consecutiveWakeDetections = 0;
-                print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);  // Reset
-                return true;
+        while (bargeInActive) {
+            // A read that times out part way still returns what it got
+            bytesRead = 0;
+            i2s_read(MIC_I2S_NUM, bargeInBuffer, sizeof(bargeInBuffer), &bytesRead, pdMS_TO_TICKS(100));
+            size_t count = bytesRead / 2;
+            if (count == 0) continue;
+            echoCanceller.process(bargeInBuffer, bargeInBuffer, count);
+            for (size_t i = 0; i < count; i++) {
+                wakePrerollPush(bargeInBuffer[i]);
             }
-        } else {
-            if (DEBUG_WAKE_WORD || novaScore > 0.3) {
-                Serial.printf("[WAKE] Nova: %.2f | Noise: %.2f | Unknown: %.2f\n",
-                              novaScore, noiseScore, unknownScore);
+#if MIC_AGC
+            micAgc.process(bargeInBuffer, bargeInBuffer, nullptr, count);
+#else
+            for (size_t i = 0; i < count; i++) {
+                bargeInBuffer[i] = (int16_t)(bargeInBuffer[i] * WAKE_WORD_GAIN);
             }
-            consecutiveWakeDetections = 0;
+#endif
+            size_t used = wakeSlices.fill(bargeInBuffer, count);
+            if (used < count) used += wakeSlices.fill(bargeInBuffer + used, count - used);
+            if (used < count) bargeInOverruns++;
         }
+        bargeInIdle = true;
+    }
+}
 
-        print_results = 0;  // Reset for next window
+/**
+ * @brief Set up the canceller and start the task on core 0. Call after
+ * setupMicrophone() and microphone_inference_start().
+ */
+static void bargeInBegin() {
+    int16_t* ring = (int16_t*)memoryPoolCheckout(POOL_ECHO_REFERENCE);
+    EchoCancellerConfig config = { SAMPLE_RATE, AEC_TAPS, AEC_PRE_DELAY, AEC_MAX_DELAY_MS, AEC_STEP_SIZE,
+                                   AEC_MIN_CORRELATION, AEC_DOUBLE_TALK_RATIO, AEC_HANGOVER_BLOCKS,
+                                   AEC_REFERENCE_FLOOR };
+    if (!ring || !wakeSliceBuffers[1] ||
+        !echoCanceller.begin(config, ring, memoryPoolSize(POOL_ECHO_REFERENCE) / sizeof(int16_t))) {
+        Serial.println("[AEC] Barge-in unavailable (reference ring, wake word slices or config)");
+        return;
+    }
+    if (xTaskCreatePinnedToCore(bargeInTask, "barge_in", BARGE_IN_TASK_STACK, NULL, BARGE_IN_TASK_PRIORITY,
+                                &bargeInTaskHandle, 0) != pdPASS) {
+        bargeInTaskHandle = NULL;
+        Serial.println("[AEC] Failed to start the barge-in task");
+        return;
     }
+    Serial.printf("[AEC] Barge-in ready (%u taps, %u ms reference)\n", AEC_TAPS, ECHO_REFERENCE_MS);
+}
 
-    return false;
+/**
+ * @brief A reply is about to play at speakerRate: listen for the wake word over it
+ */
+static void bargeInStart(uint32_t speakerRate) {
+    if (!bargeInTaskHandle || isMuted) return;
+    if (!referenceResampler.configure(speakerRate, SAMPLE_RATE)) {
+        Serial.printf("[AEC] No reference at %u Hz, barge-in off for this reply\n", speakerRate);
+        return;
+    }
+    echoCanceller.reset();
+    // Audio from before the reply must not complete a wake word
+    wakeSlices.reset();
+    wakeEngine.reset();
+    wakePrerollReset();
+    bargeInOverruns = 0;
+    bargeInIdle = false;
+    bargeInActive = true;
+    xTaskNotifyGive(bargeInTaskHandle);
+}
+
+static void bargeInStop() {
+    if (!bargeInActive) return;
+    bargeInActive = false;
+    while (!bargeInIdle) {
+        delay(1);
+    }
+    const EchoCancellerStats& stats = echoCanceller.stats();
+    Serial.printf("[AEC] ERLE %.1f dB | delay %d samples | double talk %u/%u blocks | %u overruns\n",
+                  echoCanceller.erle(), echoCanceller.delay(), stats.doubleTalkBlocks, stats.blocks,
+                  bargeInOverruns);
 }
 
+/**
+ * @brief Playback side: append what the speaker is about to play (speaker rate,
+ * after volume) to the reference, resampled to the mic's rate in `scratch`
+ */
+static void bargeInReference(const int16_t* samples, size_t count, int16_t* scratch, size_t scratchCapacity) {
+    if (!bargeInActive) return;
+    while (count > 0) {
+        size_t used = 0;
+        size_t n = referenceResampler.process(samples, count, scratch, scratchCapacity, &used);
+        echoCanceller.pushReference(scratch, n);
+        samples += used;
+        count -= used;
+    }
+}
+
+/**
+ * @brief Playback side: the speaker DMA ran dry and played silence for `ms`
+ */
+static void bargeInReferenceGap(uint32_t ms) {
+    if (bargeInActive) echoCanceller.pushReference(nullptr, (size_t)SAMPLE_RATE * ms / 1000);
+}
+
+/**
+ * @brief Loop core, between speaker writes: classify a slice the task filled
+ * @return true if it completed the wake word
+ */
+static bool bargeInPoll() {
+    if (!bargeInActive || !wakeSlices.ready()) return false;
+    WakeVerdict verdict = classifyWakeSlice(&bargeInDetectMs);
+    wakeSlices.release();  // Only now may the task switch buffers again
+    return verdict == WAKE_DETECTED;
+}
+
+/**
+ * @brief Start the wake word turn of a reply that was cut short
+ */
+static bool bargeInConsume() {
+    if (!bargeInPending) return false;
+    bargeInPending = false;
+    telemetryBeginTurn(TURN_WAKE_WORD);
+    telemetryTurn()->wakeDetectMs = bargeInDetectMs;
+    return true;
+}
+#else
+static bool bargeInPending = false;
+static void bargeInBegin() {
+    Serial.println("[AEC] Barge-in compiled out (ECHO_REFERENCE_MS 0), the esp32s3-barge-in env builds it");
+}
+static void bargeInStart(uint32_t speakerRate) {}
+static void bargeInStop() {}
+static void bargeInReference(const int16_t* samples, size_t count, int16_t* scratch, size_t scratchCapacity) {}
+static void bargeInReferenceGap(uint32_t ms) {}
+static bool bargeInPoll() { return false; }
+static bool bargeInConsume() { return false; }
+#endif
+
 // ============== Record Audio for Backend ==============
+// Returns the POOL_RECORD buffer; hand it back with releaseRecording()
 uint8_t* recordAudio(size_t* bytesRecorded) {
     Serial.println("[REC] Recording started (max 10s, auto-stop on silence)...");
     isRecording = true;
 
-    uint8_t* audioBuffer = (uint8_t*)malloc(RECORD_BUFFER_SIZE);
+    uint8_t* audioBuffer = memoryPoolCheckout(POOL_RECORD);
     if (!audioBuffer) {
         Serial.println("[REC] Failed to allocate buffer!");
         isRecording = false;
@@ -577,6 +750,12 @@ uint8_t* recordAudio(size_t* bytesRecorded) {
     unsigned long startTime = millis();
     unsigned long recordDuration = RECORD_SECONDS * 1000;
     unsigned long lastSoundTime = millis();  // Track last time sound was detected
+    long firstLoud = -1, lastLoud = -1;     // Sample indices for trimming, judged on the raw mic
+#if NOISE_SUPPRESSION
+    NoiseSuppressorStats nsBefore = noiseSuppressor.stats();
+    noiseSuppressor.restart();
+    uint32_t nsUs = 0, nsMaxUs = 0;     // process() time, in total and its slowest read
+#endif
 
     i2s_zero_dma_buffer(MIC_I2S_NUM);
     delay(100);
@@ -588,12 +767,17 @@ uint8_t* recordAudio(size_t* bytesRecorded) {
             // Calculate audio level for silence detection
             int16_t* samples = (int16_t*)tempBuffer;
             int32_t maxLevel = 0;
+            long chunkFirst = -1, chunkLast = -1;
 
             for (int i = 0; i < bytesRead / 2; i++) {
                 int32_t level = abs(samples[i]);
                 if (level > maxLevel) {
                     maxLevel = level;
                 }
+                if (level > SILENCE_THRESHOLD) {
+                    if (chunkFirst < 0) chunkFirst = i;
+                    chunkLast = i;
+                }
             }
 
             // Check if sound detected above threshold
@@ -609,41 +793,59 @@ uint8_t* recordAudio(size_t* bytesRecorded) {
                 break;
             }
 
-            // No gain applied - use natural microphone levels
+            // Silence detection stays on the raw mic levels
             // (Previously had 3x gain which was causing issues with silence detection)
 
             if ((totalBytes + bytesRead) <= RECORD_BUFFER_SIZE) {
+                long base = totalBytes / 2;
+                if (chunkFirst >= 0) {
+                    if (firstLoud < 0) firstLoud = base + chunkFirst;
+                    lastLoud = base + chunkLast;
+                }
+#if MIC_AGC
+                micAgc.process(samples, nullptr, (int16_t*)(audioBuffer + totalBytes), bytesRead / 2);
+#else
                 memcpy(audioBuffer + totalBytes, tempBuffer, bytesRead);
+#endif
+#if NOISE_SUPPRESSION
+                if (noiseSuppressorReady) {
+                    int16_t* recorded = (int16_t*)(audioBuffer + totalBytes);
+                    uint32_t nsStart = micros();
+                    noiseSuppressor.process(recorded, recorded, bytesRead / 2);
+                    uint32_t elapsedUs = micros() - nsStart;
+                    nsUs += elapsedUs;
+                    if (elapsedUs > nsMaxUs) nsMaxUs = elapsedUs;
+                }
+#endif
                 totalBytes += bytesRead;
             }
         }
     }
 
     isRecording = false;
+#if NOISE_SUPPRESSION
+    // The suppressor is a frame behind: push its last one out (if it fits), skip its leading zeros
+    const size_t lag = noiseSuppressorReady ? NS_FRAME : 0;
+    size_t tail = (RECORD_BUFFER_SIZE - totalBytes) / 2;
+    if (tail > lag) tail = lag;
+    noiseSuppressor.flush((int16_t*)(audioBuffer + totalBytes), tail);
+    totalBytes += tail * 2;
+#else
+    const size_t lag = 0;
+#endif
     float recordedSeconds = (millis() - startTime) / 1000.0;
+    TurnTelemetry* turn = telemetryTurn();
+    if (turn) turn->recordMs = telemetryClampMs(millis() - startTime);
 
     // ============== Trim Silence from Recording ==============
     if (totalBytes > 0) {
-        int16_t* samples = (int16_t*)audioBuffer;
         size_t numSamples = totalBytes / 2;
 
-        // Find first non-silent sample
-        size_t startSample = 0;
-        for (size_t i = 0; i < numSamples; i++) {
-            if (abs(samples[i]) > SILENCE_THRESHOLD) {
-                startSample = i;
-                break;
-            }
-        }
-
-        // Find last non-silent sample
-        size_t endSample = numSamples - 1;
-        for (size_t i = numSamples - 1; i > startSample; i--) {
-            if (abs(samples[i]) > SILENCE_THRESHOLD) {
-                endSample = i;
-                break;
-            }
-        }
+        // First and last non-silent sample, found while recording
+        size_t startSample = (firstLoud >= 0 ? (size_t)firstLoud : 0) + lag;
+        size_t endSample = lastLoud > firstLoud ? (size_t)lastLoud + lag : numSamples - 1;
+        if (endSample > numSamples - 1) endSample = numSamples - 1;
+        if (startSample > endSample) startSample = endSample;
 
         // Calculate trimmed size
         size_t trimmedSamples = (endSample - startSample + 1);
@@ -660,6 +862,22 @@ uint8_t* recordAudio(size_t* bytesRecorded) {
         Serial.printf("[REC] Recorded %d bytes in %.1f seconds\n", totalBytes, recordedSeconds);
         Serial.printf("[REC] Trimmed %d bytes (start: %d, end: %d) → Final: %d bytes\n",
             trimmedFromStart + trimmedFromEnd, trimmedFromStart, trimmedFromEnd, trimmedBytes);
+#if MIC_AGC
+        Serial.printf("[REC] Upload gain %.1fx\n", micAgc.gain(AGC_FEED_UPLOAD));
+#endif
+#if NOISE_SUPPRESSION
+        const NoiseSuppressorStats& ns = noiseSuppressor.stats();
+        double nsIn = ns.inEnergy - nsBefore.inEnergy, nsOut = ns.outEnergy - nsBefore.outEnergy;
+        uint32_t nsFrames = ns.frames - nsBefore.frames;
+        if (nsIn > 0.0 && nsOut > 0.0) {
+            Serial.printf("[REC] Noise suppression %.1f dB (%u frames, %u FFT errors)\n", 10.0 * log10(nsOut / nsIn),
+                nsFrames, ns.fftErrors - nsBefore.fftErrors);
+        }
+        // Against the 8 ms a frame's hop lasts; the read loop must keep up with the mic DMA
+        if (nsFrames > 0) {
+            Serial.printf("[REC] Noise suppression %u us per frame, slowest read %u us\n", nsUs / nsFrames, nsMaxUs);
+        }
+#endif
 
         *bytesRecorded = trimmedBytes;
     } else {
@@ -667,32 +885,257 @@ uint8_t* recordAudio(size_t* bytesRecorded) {
         *bytesRecorded = totalBytes;
     }
 
+    if (turn) {
+        turn->trimmedBytes = *bytesRecorded;
+        if (*bytesRecorded == 0) turn->flags |= TURN_FLAG_NO_AUDIO;
+    }
+
     return audioBuffer;
 }
 
+void releaseRecording(uint8_t* audioBuffer) {
+    if (audioBuffer) memoryPoolCheckin(POOL_RECORD);
+}
+
+// ============== Mic Test ==============
+// Lower edges of mic_diagnostics.h's octave bands
+static const char* const micTestBandNames[MIC_DIAG_BANDS] = { "0", "125", "250", "500", "1k", "2k", "4k" };
+
+static void micTestMeter(unsigned long elapsedMs, const MicLevels& levels) {
+    // 20 steps over -80..0 dBFS of RMS, the peak marked
+    char bar[21];
+    int rmsSteps = (int)((micDiagDbfs(levels.rms()) + 80.0f) / 4.0f);
+    int peakStep = (int)((micDiagDbfs((float)levels.peak) + 80.0f) / 4.0f);
+    for (int i = 0; i < 20; i++) bar[i] = i < rmsSteps ? '#' : i == peakStep ? '|' : '.';
+    bar[20] = '\0';
+    Serial.printf("[TEST] %3lus [%s] rms %6.1f dBFS | peak %6.1f dBFS | dc %6.0f | clipped %u\n",
+        elapsedMs / 1000, bar, micDiagDbfs(levels.rms()), micDiagDbfs((float)levels.peak), levels.dc(),
+        levels.clipped);
+}
+
+static void micTestReport(const MicDiagReport& r, uint32_t delayMs) {
+    float seconds = (float)r.samples / SAMPLE_RATE;
+    Serial.printf("[TEST] ===== Mic report: %.1fs, loopback delay %u ms =====\n", seconds, delayMs);
+    Serial.printf("[TEST] Level  rms %.1f dBFS | peak %.1f dBFS | dc %.1f | clipped %u (%.3f%%)\n",
+        r.rmsDbfs, r.peakDbfs, r.dcOffset, r.clipped, r.samples ? 100.0f * r.clipped / r.samples : 0.0f);
+    Serial.printf("[TEST] Floor  %.1f dBFS (rms %.0f, silence threshold %d)\n",
+        r.floorDbfs, r.floorRms, SILENCE_THRESHOLD);
+    Serial.print("[TEST] Bands from Hz");
+    for (int b = 0; b < MIC_DIAG_BANDS; b++) Serial.printf(" %s %.1f", micTestBandNames[b], r.bandDbfs[b]);
+    Serial.println(" dBFS");
+    if (r.toneHz > 0.0f) Serial.printf("[TEST] Tone   %.1f Hz, %.1f dB over the floor\n", r.toneHz, r.toneDb);
+    if (r.fftErrors) Serial.printf("[TEST] %u spectrum frames failed\n", r.fftErrors);
+
+    if (r.flags == 0) Serial.println("[TEST] Verdict: OK");
+    if (r.flags & MIC_DIAG_DEAD) {
+        Serial.println("[TEST] Verdict: NO SIGNAL - check the mic's wiring, power and L/R select");
+    }
+    if (r.flags & MIC_DIAG_CLIPPING) {
+        Serial.println("[TEST] Verdict: CLIPPING - mic too close to something loud, or the speaker feeds back");
+    }
+    if (r.flags & MIC_DIAG_DC) {
+        Serial.println("[TEST] Verdict: DC OFFSET - mic or I2S format misconfigured");
+    }
+    if (r.flags & MIC_DIAG_NOISY) {
+        Serial.printf("[TEST] Verdict: NOISY - floor over the silence threshold, recordings run the full %ds\n",
+            RECORD_SECONDS);
+    }
+    if (r.flags & MIC_DIAG_TONE) {
+        Serial.println("[TEST] Verdict: TONE - mains hum or a supply whine near the mic");
+    }
+
+    // One line for install scripts
+    Serial.printf("[TEST] JSON {\"seconds\":%.1f,\"delay_ms\":%u,\"rms_dbfs\":%.1f,\"peak_dbfs\":%.1f,"
+        "\"dc\":%.1f,\"clipped\":%u,\"floor_dbfs\":%.1f,\"floor_rms\":%.0f,\"bands_dbfs\":[",
+        seconds, delayMs, r.rmsDbfs, r.peakDbfs, r.dcOffset, r.clipped, r.floorDbfs, r.floorRms);
+    for (int b = 0; b < MIC_DIAG_BANDS; b++) Serial.printf(b ? ",%.1f" : "%.1f", r.bandDbfs[b]);
+    Serial.printf("],\"tone_hz\":%.1f,\"tone_db\":%.1f,\"fft_errors\":%u,\"flags\":%u}\n",
+        r.toneHz, r.toneDb, r.fftErrors, r.flags);
+}
+
+// Mic -> speaker through a delay line in POOL_RECORD, metered as it streams.
+// Any serial input stops it early
+void micTest(uint32_t delayMs, uint32_t seconds) {
+    Serial.println("\n========== MIC TEST MODE ==========");
+    uint8_t* pool = memoryPoolCheckout(POOL_RECORD);
+    if (!pool) {
+        Serial.println("[ERROR] Record buffer busy or missing, no mic test");
+        return;
+    }
+
+    // The analyser, read and stereo blocks, then the delay ring in the rest
+    static_assert(alignof(MicDiagnostics) <= POOL_ALIGN, "MicDiagnostics needs a more aligned pool");
+    size_t diagBytes = (sizeof(MicDiagnostics) + 7) & ~(size_t)7;
+    MicDiagnostics* diag = new (pool) MicDiagnostics();
+    int16_t* mono = (int16_t*)(pool + diagBytes);
+    int16_t* stereo = mono + MIC_TEST_READ_SAMPLES;
+    int16_t* ring = stereo + MIC_TEST_READ_SAMPLES * 2;
+    size_t ringCapacity = (memoryPoolSize(POOL_RECORD) - diagBytes) / sizeof(int16_t) - MIC_TEST_READ_SAMPLES * 3;
+    uint64_t wanted = (uint64_t)delayMs * SAMPLE_RATE / 1000;
+    size_t ringSamples = wanted < ringCapacity ? (size_t)wanted : ringCapacity;
+    if (wanted > ringCapacity) {
+        delayMs = (uint32_t)(ringSamples * 1000 / SAMPLE_RATE);
+        Serial.printf("[TEST] Delay limited to %u ms by the record buffer\n", delayMs);
+    }
+    memset(ring, 0, ringSamples * sizeof(int16_t));
+
+    MicDiagConfig diagConfig = { SAMPLE_RATE, MIC_TEST_CLIP_LEVEL, MIC_TEST_DEAD_PEAK, MIC_TEST_MAX_DC,
+                                 SILENCE_THRESHOLD };
+    diag->begin(diagConfig);
+
+    Serial.printf("[TEST] Streaming mic to speaker for %us, %u ms delay (any key stops)\n", seconds, delayMs);
+    setLedColor(255, 0, 0); // Red - mic live
+    setSpeakerSampleRate(SAMPLE_RATE);
+    i2s_zero_dma_buffer(MIC_I2S_NUM);
+    i2s_zero_dma_buffer(SPK_I2S_NUM);
+    while (Serial.available()) Serial.read();
+
+    size_t ringPos = 0;
+    bool stopped = false;
+    unsigned long startTime = millis();
+    unsigned long nextMeter = 1000;
+    while (millis() - startTime < seconds * 1000UL && !(stopped = Serial.available() > 0)) {
+        size_t bytesRead = 0;
+        i2s_read(MIC_I2S_NUM, mono, MIC_TEST_READ_SAMPLES * sizeof(int16_t), &bytesRead, portMAX_DELAY);
+        size_t count = bytesRead / sizeof(int16_t);
+        if (count == 0) continue;
+        diag->process(mono, count);
+
+        for (size_t i = 0; i < count; i++) {
+            int16_t out = mono[i];
+            if (ringSamples > 0) {
+                out = ring[ringPos];
+                ring[ringPos] = mono[i];
+                if (++ringPos == ringSamples) ringPos = 0;
+            }
+            stereo[i*2] = stereo[i*2+1] = out;
+        }
+        size_t bytesWritten;
+        i2s_write(SPK_I2S_NUM, stereo, count * 4, &bytesWritten, portMAX_DELAY);
+
+        unsigned long elapsed = millis() - startTime;
+        if (elapsed >= nextMeter) {
+            micTestMeter(elapsed, diag->takeInterval());
+            nextMeter += 1000;
+        }
+    }
+    while (Serial.available()) Serial.read();
+
+    // Play out what is still in the line: a delay as long as the test records, then plays back
+    size_t heard = diag->total().count;
+    if (!stopped && ringSamples > 0 && heard > 0) {
+        size_t drain = heard < ringSamples ? heard : ringSamples;
+        size_t pos = heard < ringSamples ? 0 : ringPos;     // Else the ring's unplayed start is silence
+        Serial.printf("[TEST] Playing out the last %u ms\n", (unsigned)(drain * 1000 / SAMPLE_RATE));
+        setLedColor(0, 255, 0); // Green - playing
+        while (drain > 0) {
+            size_t count = drain < MIC_TEST_READ_SAMPLES ? drain : MIC_TEST_READ_SAMPLES;
+            for (size_t i = 0; i < count; i++) {
+                stereo[i*2] = stereo[i*2+1] = ring[pos];
+                if (++pos == ringSamples) pos = 0;
+            }
+            size_t bytesWritten;
+            i2s_write(SPK_I2S_NUM, stereo, count * 4, &bytesWritten, portMAX_DELAY);
+            drain -= count;
+        }
+    }
+
+    if (stopped) i2s_zero_dma_buffer(SPK_I2S_NUM);  // Else the DMA plays out, then auto-clears
+    setLedColor(0, 0, 0); // Off
+    micTestReport(diag->report(), delayMs);
+    diag->~MicDiagnostics();
+    memoryPoolCheckin(POOL_RECORD);
+    Serial.println("===================================\n");
+}
+
 
 
 
 // ============== Shared Audio Playback Function ==============
-// Handles buffering, stereo conversion, volume, and silence flush
-void playStream(WiFiClient& client) {
-    soundSuccess(); 
-    Serial.println("[STREAM] Starting playback...");
+// Describes a response body about to be handed to playStream()
+struct StreamInfo {
+    uint32_t sampleRate = SAMPLE_RATE;
+    bool chunked = false;             // Transfer-Encoding: chunked (streaming backend)
+    unsigned long requestSentAt = 0;  // millis() when the request was sent, 0 if unknown
+    unsigned long firstByteAt = 0;    // millis() when the first response byte arrived
+};
+
+// Resample (or copy) as much as fits, then Mono to Stereo with volume, then I2S
+// Returns false if barge-in heard the wake word, the rest of the block is dropped
+static bool writeSpeakerMono(const int16_t* mono, size_t remaining,
+                             int16_t* resampled, size_t resampledCapacity, int16_t* stereo) {
+    size_t bytesWritten;
+    while (remaining > 0) {
+        size_t used = 0;
+        size_t samples = streamResampler.process(mono, remaining, resampled, resampledCapacity, &used);
+        mono += used;
+        remaining -= used;
+
+        for (size_t i = 0; i < samples; i++) {
+            resampled[i] = (int16_t)((resampled[i] * 50) / 100); // 50% volume
+        }
+        // Echo reference before the write: the canceller must never see the echo first.
+        // Stereo holds 2x resampledCapacity, enough for any rate down to 8kHz
+        bargeInReference(resampled, samples, stereo, resampledCapacity * 2);
+
+        for (size_t i = 0; i < samples; i++) {
+            stereo[i*2] = stereo[i*2+1] = resampled[i];
+        }
+
+        if (samples > 0) {
+            i2s_write(SPK_I2S_NUM, stereo, samples * 4, &bytesWritten, portMAX_DELAY);
+        }
+        if (bargeInPoll()) return false;
+    }
+    return true;
+}
+
+// Handles chunked decoding, jitter prefill, rate conversion, stereo conversion, volume, and silence flush
+void playStream(WiFiClient& client, const StreamInfo& info = StreamInfo()) {
+    Serial.printf("[STREAM] Starting playback (%u Hz%s)...\n", info.sampleRate, info.chunked ? ", chunked" : "");
     isPlaying = true;
     setLedColor(50, 0, 200); // Purple
 
+    // Either play the stream at its own rate, or resample it to SAMPLE_RATE
+    uint32_t streamRate = info.sampleRate;
+    bool nativeRate = SPK_NATIVE_RATE_PLAYBACK &&
+                      streamRate >= SPK_MIN_SAMPLE_RATE && streamRate <= SPK_MAX_SAMPLE_RATE;
+    if (nativeRate) {
+        setSpeakerSampleRate(streamRate);
+        streamResampler.configure(streamRate, streamRate);
+    } else if (!streamResampler.configure(streamRate, SAMPLE_RATE)) {
+        Serial.printf("[STREAM] Unsupported rate %u Hz, playing unconverted\n", streamRate);
+        streamResampler.configure(SAMPLE_RATE, SAMPLE_RATE);
+    }
+    // After the re-clock: the chime is rendered at the stream's rate rather than
+    // queued at SAMPLE_RATE and played at the stream's
+    soundSuccess();
+
     // Larger chunks for smoother streaming
-    const size_t chunkSize = 2048;
-    uint8_t* audioChunk = (uint8_t*)malloc(chunkSize);
-    uint8_t* stereoChunk = (uint8_t*)malloc(chunkSize * 2);
-
-    if (!audioChunk || !stereoChunk) {
-        Serial.println("[ERR] Chunk malloc failed!");
-        if(audioChunk) free(audioChunk);
-        if(stereoChunk) free(stereoChunk);
+    const size_t chunkSize = STREAM_CHUNK_BYTES;
+    const size_t resampledCapacity = chunkSize / 2;  // Samples; matches stereoChunk frames
+    // Jitter prefill: hold this much audio before the first I2S write
+    size_t prefillTarget = ((size_t)streamRate * 2 * STREAM_PREFILL_MS / 1000) & ~(size_t)1;
+    uint8_t* audioChunk = memoryPoolCheckout(POOL_STREAM_CHUNK);
+    uint8_t* stereoChunk = memoryPoolCheckout(POOL_STREAM_STEREO);
+    int16_t* resampled = (int16_t*)memoryPoolCheckout(POOL_STREAM_RESAMPLED);
+    uint8_t* prefill = memoryPoolCheckout(POOL_STREAM_PREFILL);
+
+    if (!audioChunk || !stereoChunk || !resampled) {
+        Serial.println("[ERR] Stream buffers unavailable!");
+        if(audioChunk) memoryPoolCheckin(POOL_STREAM_CHUNK);
+        if(stereoChunk) memoryPoolCheckin(POOL_STREAM_STEREO);
+        if(resampled) memoryPoolCheckin(POOL_STREAM_RESAMPLED);
+        if(prefill) memoryPoolCheckin(POOL_STREAM_PREFILL);
         isPlaying = false;
+        setSpeakerSampleRate(SAMPLE_RATE);
         return;
     }
+    if (!prefill || prefillTarget > memoryPoolSize(POOL_STREAM_PREFILL)) {
+        prefillTarget = 0; // Degrade to play-as-received
+    }
+    bargeInStart(speakerSampleRate);
+    bool bargedIn = false;
 
     size_t totalBytes = 0;
     size_t bytesWritten;
@@ -702,6 +1145,47 @@ void playStream(WiFiClient& client) {
     uint8_t leftoverByte = 0;
     bool hasLeftover = false;
 
+    ChunkedDecoder decoder;
+    size_t prefillBytes = 0;
+    bool started = false;
+    TurnTelemetry* turn = telemetryTurn();
+
+    // Underrun tracking: audio queued to I2S vs wall time since playback start
+    unsigned long playStartedAt = 0;
+    uint32_t samplesQueued = 0;
+    uint16_t underruns = 0;
+
+    auto queueAudio = [&](const uint8_t* data, size_t bytes) {
+        unsigned long now = millis();
+        uint32_t queuedMs = (uint32_t)((uint64_t)samplesQueued * 1000 / streamRate);
+        if (now - playStartedAt > queuedMs + 20) {  // DMA ran dry before this data arrived
+            underruns++;
+            bargeInReferenceGap(now - playStartedAt - queuedMs);
+            playStartedAt = now;
+            samplesQueued = 0;
+        }
+        samplesQueued += bytes / 2;
+        if (!writeSpeakerMono((const int16_t*)data, bytes / 2,
+                              resampled, resampledCapacity, (int16_t*)stereoChunk)) {
+            bargedIn = true;
+        }
+    };
+
+    // Flush the prefill buffer to I2S and report turn latency
+    auto startPlayback = [&]() {
+        started = true;
+        unsigned long now = millis();
+        playStartedAt = now;
+        if (info.requestSentAt) {
+            Serial.printf("[LATENCY] First byte: %lu ms | First sound: %lu ms (prefill %u bytes)\n",
+                          info.firstByteAt - info.requestSentAt, now - info.requestSentAt, prefillBytes);
+            if (turn) turn->firstAudioMs = telemetryClampMs(now - info.requestSentAt);
+        }
+        if (prefillBytes > 0) {
+            queueAudio(prefill, prefillBytes);
+        }
+    };
+
     while (client.connected() || client.available()) {
         int avail = client.available();
         if (avail > 0) {
@@ -709,6 +1193,10 @@ void playStream(WiFiClient& client) {
             int bytesToRead = min((int)chunkSize - readOffset, avail);
             
             int bytesRead = client.read(audioChunk + readOffset, bytesToRead);
+
+            if (bytesRead > 0 && info.chunked) {
+                bytesRead = decoder.decode(audioChunk + readOffset, bytesRead);
+            }
             
             if (bytesRead > 0) {
                 if (hasLeftover) {
@@ -725,78 +1213,165 @@ void playStream(WiFiClient& client) {
                 }
                 
                 if (bytesRead > 0) {
-                    // Convert Mono to Stereo with volume
-                    int16_t* mono = (int16_t*)audioChunk;
-                    int16_t* stereo = (int16_t*)stereoChunk;
-                    int samples = bytesRead / 2;
-
-                    for (int i = 0; i < samples; i++) {
-                        int32_t val = (mono[i] * 50) / 100; // 50% volume
-                        stereo[i*2] = stereo[i*2+1] = (int16_t)val;
+                    size_t offset = 0;
+                    if (!started) {
+                        size_t n = min((size_t)bytesRead, prefillTarget - prefillBytes);
+                        memcpy(prefill + prefillBytes, audioChunk, n);
+                        prefillBytes += n;
+                        offset = n;
+                        if (prefillBytes >= prefillTarget) {
+                            startPlayback();
+                        }
+                    }
+                    if (started && offset < (size_t)bytesRead) {
+                        queueAudio(audioChunk + offset, bytesRead - offset);
                     }
-                    
-                    i2s_write(SPK_I2S_NUM, stereoChunk, bytesRead * 2, &bytesWritten, portMAX_DELAY);
                     totalBytes += bytesRead;
-                    lastActivity = millis();
                 }
             }
+            lastActivity = millis();
+
+            if (bargedIn) break;
+            if (info.chunked && (decoder.done() || decoder.failed())) {
+                if (decoder.failed()) Serial.println("[STREAM] Bad chunk framing, stopping.");
+                break;
+            }
         } else {
             if (millis() - lastActivity > 8000) {
                 Serial.println("[STREAM] Timeout.");
                 break;
             }
+            if (bargeInPoll()) {
+                bargedIn = true;
+                break;
+            }
             yield();
         }
     }
-    
-    free(audioChunk);
-    free(stereoChunk);
 
-    // FLUSH BUFFER WITH SILENCE (Standard I2S fix for cut-off audio)
-    const size_t silenceSize = 1024; 
-    uint8_t* silenceChunk = (uint8_t*)calloc(silenceSize, 1);
-    
-    if (silenceChunk) {
+    // Reply shorter than the prefill
+    if (!started && prefillBytes > 0 && !bargedIn) {
+        startPlayback();
+    }
+
+    if (turn) {
+        turn->underruns = underruns;
+        turn->playbackMs = started ? telemetryClampMs(millis() - playStartedAt) : 0;
+        if (info.chunked) turn->flags |= TURN_FLAG_STREAMED;
+    }
+    if (underruns > 0) {
+        Serial.printf("[STREAM] %u underruns\n", underruns);
+    }
+
+    if (bargedIn) {
+        // Cut the reply now: drop what the DMA still holds instead of playing it out
+        Serial.println("[AEC] Barge-in, stopping the reply");
+        i2s_zero_dma_buffer(SPK_I2S_NUM);
+        if (turn) turn->flags |= TURN_FLAG_BARGED_IN;
+        bargeInPending = true;
+    } else {
+        // FLUSH BUFFER WITH SILENCE (Standard I2S fix for cut-off audio)
+        const size_t silenceSize = 1024; 
+        uint8_t* silenceChunk = stereoChunk;
+        memset(silenceChunk, 0, silenceSize);
         for (int i = 0; i < 20; i++) { 
              i2s_write(SPK_I2S_NUM, silenceChunk, silenceSize, &bytesWritten, portMAX_DELAY);
         }
-        free(silenceChunk);
     }
+    bargeInStop();
+
+    memoryPoolCheckin(POOL_STREAM_CHUNK);
+    memoryPoolCheckin(POOL_STREAM_STEREO);
+    memoryPoolCheckin(POOL_STREAM_RESAMPLED);
+    if (prefill) memoryPoolCheckin(POOL_STREAM_PREFILL);
     
     i2s_zero_dma_buffer(SPK_I2S_NUM); // Reset for next time
+    setSpeakerSampleRate(SAMPLE_RATE); // Back to the rate the rest of the firmware plays at
     isPlaying = false;
     setLedColor(0, 0, 0);
     Serial.printf("[SPK] Playback complete. %d bytes\n", totalBytes);
 }
 
+// ============== Helper: HTTP Header Parsing ==============
+// Header names are case-insensitive (uvicorn sends them lowercase)
+bool parseHeader(const String& line, const char* name, String& value) {
+    size_t nameLen = strlen(name);
+    if (line.length() <= nameLen || line.charAt(nameLen) != ':') return false;
+    if (strncasecmp(line.c_str(), name, nameLen) != 0) return false;
+    value = line.substring(nameLen + 1);
+    value.trim();
+    return true;
+}
+
+// WiFiClient writes can come up short under memory pressure; keeps writing
+// until everything is out or the connection stops taking data
+size_t clientWriteAll(WiFiClient& client, const uint8_t* data, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        size_t n = client.write(data + written, size - written);
+        if (n == 0) break;
+        written += n;
+    }
+    return written;
+}
+
 // ============== Helper: Manual HTTP Request for Audio ==============
-void sendAudioRequest(String endpoint, String jsonBody = "", uint8_t* audioBody = nullptr, size_t audioSize = 0) {
+// withPreroll sends the wake pre-roll ahead of audioBody (wake word turns only)
+void sendAudioRequest(String endpoint, String jsonBody = "", uint8_t* audioBody = nullptr, size_t audioSize = 0,
+                      bool withPreroll = false) {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("[HTTP] WiFi not connected!");
         return;
     }
 
+    TurnTelemetry* turn = telemetryTurn();
+    if (turn) turn->rssi = (int8_t)WiFi.RSSI();
+
     WiFiClient client;
+    unsigned long connectStart = millis();
     if (!client.connect(BACKEND_HOST, BACKEND_PORT)) {
         Serial.println("[HTTP] Connection failed!");
+        if (turn) turn->flags |= TURN_FLAG_CONNECT_FAILED;
         soundError();
         return;
     }
+    if (turn) turn->connectMs = telemetryClampMs(millis() - connectStart);
 
     Serial.printf("[HTTP] Connected to %s:%d\n", BACKEND_HOST, BACKEND_PORT);
     
-    // Construct Manual HTTP/1.0 Request (No Chunking support expected)
+    // Construct Manual HTTP Request
+    // HTTP/1.1 lets the backend stream the reply with chunked encoding as TTS
+    // segments complete; HTTP/1.0 gets one body after the whole reply is synthesized
     String method = "POST";
     String url = endpoint; // already starts with / 
     
-    client.println(method + " " + url + " HTTP/1.0");
+    client.println(method + " " + url + (STREAM_RESPONSES ? " HTTP/1.1" : " HTTP/1.0"));
     client.println("Host: " + String(BACKEND_HOST));
     client.println("User-Agent: ESP32/NOVA");
-    client.println("Connection: close"); // Vital for HTTP/1.0
+    client.println("Connection: close"); // One request per connection
+    client.println("X-Audio-Native-Rate: 1"); // We resample or re-clock I2S ourselves
+    if (DEVICE_TOKEN[0]) {
+        client.println("X-Device-Token: " DEVICE_TOKEN);
+    }
+    if (STREAM_RESPONSES) {
+        client.println("X-Audio-Stream: 1");
+    }
+
+    // Piggyback telemetry from earlier turns
+    uint32_t telemetryCount = 0;
+    String telemetryHex = telemetryPendingHex(&telemetryCount);
+    if (telemetryCount > 0) {
+        client.println("X-Device-Id: " + WiFi.macAddress());
+        client.println("X-Telemetry: " + telemetryHex);
+    }
     
+    size_t prerollSamples = (audioBody && withPreroll) ? wakePrerollSamples() : 0;
     if (audioBody) {
+        if (prerollSamples > 0) {
+            client.println("X-Wake-Preroll: " + String(prerollSamples));
+        }
         client.println("Content-Type: application/octet-stream");
-        client.println("Content-Length: " + String(audioSize));
+        client.println("Content-Length: " + String(audioSize + prerollSamples * sizeof(int16_t)));
     } else {
         client.println("Content-Type: application/json");
         client.println("Content-Length: " + String(jsonBody.length()));
@@ -804,13 +1379,32 @@ void sendAudioRequest(String endpoint, String jsonBody = "", uint8_t* audioBody
     
     client.println(); // End of headers
     
-    // Send Body
+    // Send Body. Content-Length promised all of it: with less the backend
+    // would wait out its timeout on a body that never completes
+    unsigned long uploadStart = millis();
+    size_t bodySize, sent;
     if (audioBody) {
-        client.write(audioBody, audioSize);
+        bodySize = prerollSamples * sizeof(int16_t) + audioSize;
+        sent = prerollSamples > 0 ? wakePrerollWrite(client) : 0;
+        if (sent == prerollSamples * sizeof(int16_t)) {
+            sent += clientWriteAll(client, audioBody, audioSize);
+        }
     } else {
-        client.print(jsonBody);
+        bodySize = jsonBody.length();
+        sent = clientWriteAll(client, (const uint8_t*)jsonBody.c_str(), bodySize);
+    }
+    if (sent != bodySize) {
+        Serial.printf("[HTTP] Upload cut short: %u of %u bytes sent\n", (unsigned)sent, (unsigned)bodySize);
+        if (turn) turn->flags |= TURN_FLAG_UPLOAD_FAILED;
+        client.stop();
+        soundError();
+        return;
     }
     
+    StreamInfo info;
+    info.requestSentAt = millis();
+    if (turn) turn->uploadMs = telemetryClampMs(info.requestSentAt - uploadStart);
+
     Serial.println("[HTTP] Request sent. Waiting for response...");
     setLedColor(0, 0, 255); // Blue (Processing)
     soundProcessing();
@@ -820,22 +1414,33 @@ void sendAudioRequest(String endpoint, String jsonBody = "", uint8_t* audioBody
     while (client.available() == 0) {
         if (millis() - timeout > 45000) {
             Serial.println("[HTTP] Timeout (45s) waiting for headers!");
+            if (turn) turn->flags |= TURN_FLAG_TIMEOUT;
             client.stop();
             soundError();
             return;
         }
         delay(1);
     }
+    info.firstByteAt = millis();
+    if (turn) turn->firstByteMs = telemetryClampMs(info.firstByteAt - info.requestSentAt);
 
     bool headerEnded = false;
+    bool wakeRejected = false;
     int contentLength = -1;
     String line;
+    String value;
     
     while(client.connected() || client.available()) {
         line = client.readStringUntil('\n');
         
-        if (line.startsWith("Content-Length: ")) {
-            contentLength = line.substring(16).toInt();
+        if (parseHeader(line, "Content-Length", value)) {
+            contentLength = value.toInt();
+        } else if (parseHeader(line, "X-Audio-Sample-Rate", value)) {
+            info.sampleRate = value.toInt();
+        } else if (parseHeader(line, "Transfer-Encoding", value)) {
+            info.chunked = value.equalsIgnoreCase("chunked");
+        } else if (parseHeader(line, "X-Wake-Rejected", value)) {
+            wakeRejected = value == "1";
         }
         
         if (line == "\r" || line == "") {
@@ -846,14 +1451,27 @@ void sendAudioRequest(String endpoint, String jsonBody = "", uint8_t* audioBody
 
     if (!headerEnded) {
         Serial.println("[HTTP] Invalid response structure!");
+        if (turn) turn->flags |= TURN_FLAG_BAD_RESPONSE;
         client.stop();
         return;
     }
 
-    Serial.printf("[HTTP] Body start. Content-Length: %d\n", contentLength);
+    // Backend has the piggybacked records now
+    telemetryMarkSent(telemetryCount);
+
+    // The backend's wake word check overruled us: nothing to play
+    if (wakeRejected) {
+        Serial.println("[HTTP] Backend rejected the wake word, back to listening");
+        if (turn) turn->flags |= TURN_FLAG_WAKE_REJECTED;
+        client.stop();
+        return;
+    }
+
+    Serial.printf("[HTTP] Body start. Content-Length: %d, Rate: %u Hz, Chunked: %s\n",
+                  contentLength, info.sampleRate, info.chunked ? "yes" : "no");
     
     // Play Audio Stream using Shared Function
-    playStream(client);
+    playStream(client, info);
     client.stop();
 }
 
@@ -890,35 +1508,41 @@ void checkRemoteCommands() {
     
     // Skip headers and find Content-Length
     int len = 0;
+    StreamInfo info;
+    String value;
     while(client.available()) {
         String h = client.readStringUntil('\n');
-        if (h.startsWith("Content-Length: ")) len = h.substring(16).toInt();
+        if (parseHeader(h, "Content-Length", value)) len = value.toInt();
+        if (parseHeader(h, "X-Audio-Sample-Rate", value)) info.sampleRate = value.toInt();
         if (h == "\r") break;
     }
     
     if (len > 0) {
         Serial.println("[REMOTE] Playing queued audio...");
-        playStream(client);
+        playStream(client, info);
     }
     client.stop();
 }
 
 // ============== Send Text Command ==============
 void sendTextCommand(String text) {
+    telemetryBeginTurn(TURN_TEXT);
     String jsonBody = "{\"text\":\"" + text + "\"}";
     sendAudioRequest("/text", jsonBody);
+    telemetryCommitTurn();
 }
 
 
 // ============== Send Audio & Play Response ==============
-void sendAndPlay(uint8_t* audioData, size_t audioSize) {
-    sendAudioRequest(VOICE_ENDPOINT, "", audioData, audioSize);
+void sendAndPlay(uint8_t* audioData, size_t audioSize, bool withPreroll = false) {
+    sendAudioRequest(VOICE_ENDPOINT, "", audioData, audioSize, withPreroll);
 }
 
 // ============== Main Listen Flow ==============
 void startListening() {
     Serial.println("\n========== LISTENING ==========");
     setLedColor(0, 255, 255); // Cyan (Alexa Listening)
+    telemetryBeginTurn(TURN_BUTTON);
     soundListening();  // High ping - attention sound
 
     size_t bytesRecorded = 0;
@@ -926,11 +1550,13 @@ void startListening() {
 
     if (audioData && bytesRecorded > 0) {
         sendAndPlay(audioData, bytesRecorded);
-        free(audioData);
     }
+    releaseRecording(audioData);
+    telemetryCommitTurn();
 
     Serial.println("================================\n");
-    consecutiveWakeDetections = 0;  // Reset wake word counter
+    wakeEngine.reset();  // Scores from before the turn are stale
+    if (!bargeInPending) wakePrerollReset();  // Else it holds the wake word that cut the reply short
 }
 
 // ============== Setup ==============
@@ -950,7 +1576,29 @@ void setup() {
         Serial.println("[POWER] Power-on reset or first boot");
     }
 
+    telemetryInit();
+
+    // Reserve all audio buffers before anything else fragments the heap
+    if (!memoryPoolsBegin()) {
+        Serial.println("[MEM] WARNING: some buffer pools missing, features will degrade");
+    }
+    scoreCaptureBegin();
+    wakePrerollBegin();
+
     setupMicrophone();
+#if MIC_AGC
+    MicAgcConfig agcConfig = { SAMPLE_RATE, AGC_ENVELOPE_RELEASE_MS, SILENCE_THRESHOLD, AGC_LIMIT, {
+        { AGC_WAKE_TARGET, 1.0f, WAKE_WORD_GAIN, AGC_WAKE_RELEASE_MS },
+        { AGC_UPLOAD_TARGET, 1.0f, AGC_UPLOAD_MAX_GAIN, AGC_UPLOAD_RELEASE_MS } } };
+    micAgc.begin(agcConfig);
+#endif
+#if NOISE_SUPPRESSION
+    NoiseSuppressorConfig nsConfig = { SAMPLE_RATE, NS_NOISE_WINDOW_MS, NS_OVERESTIMATE, NS_FLOOR_DB, NS_SMOOTHING };
+    noiseSuppressorReady = noiseSuppressor.begin(nsConfig);
+    if (!noiseSuppressorReady) {
+        Serial.println("[NS] WARNING: bad noise suppressor config or no FFT, uploads stay as recorded");
+    }
+#endif
 
     // Setup Button (GPIO 4)
     pinMode(BUTTON_PIN, INPUT_PULLUP);
@@ -983,15 +1631,27 @@ void setup() {
         Serial.println("[WAKE] ERROR: Failed to start continuous inference!");
     } else {
         run_classifier_init();  // Initialize Edge Impulse classifier
-        Serial.println("[WAKE] Continuous inference ready!");
+        WakeEngineConfig wakeConfig = { WAKE_WORD_LABEL, WAKE_WORD_CONFIDENCE, WAKE_AVERAGE_MS,
+                                        WAKE_SUPPRESSION_MS, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW };
+        if (!wakeEngine.begin(ei_default_impulse.impulse, wakeConfig)) {
+            Serial.println("[WAKE] ERROR: Wake word engine config rejected (label or threshold), wake word off");
+        } else {
+            Serial.printf("[WAKE] Continuous inference ready! (averaging %u slices)\n", wakeEngine.averageSlices());
+            bargeInBegin();
+        }
     }
 
+    memoryReport();
+
     Serial.println("\n[READY] NOVA AI Speaker Ready!");
     Serial.println("Controls:");
     Serial.println("  - Wake word: Say 'Nova' to activate");
     Serial.println("  - Press BUTTON (GPIO 4) to start listening");
     Serial.println("  - Type 'l' to start listening");
-    Serial.println("  - Type 'r' for mic test (record 10s & playback)");
+    Serial.println("  - Type 'r [delay ms] [seconds]' for mic test (live loopback & report)");
+    Serial.println("  - Type 't' to print turn latency telemetry");
+    Serial.println("  - Type 'm' to print memory pools and heap fragmentation");
+    Serial.println("  - Type 's' to upload captured wake word scores");
     Serial.println("  - Long press BUTTON (3s) to sleep\n");
 }
 
@@ -1079,98 +1739,30 @@ void loop() {
         if (cmd == 'l' || cmd == 'L') {
             startListening();
         }
+        else if (cmd == 't' || cmd == 'T') {
+            telemetryPrint();
+        }
+        else if (cmd == 'm' || cmd == 'M') {
+            memoryReport();
+        }
+        else if (cmd == 's' || cmd == 'S') {
+            scoreCaptureUpload();
+        }
         else if (cmd == 'r' || cmd == 'R') {
-            // Microphone test - record and playback
-            Serial.println("\n========== MIC TEST MODE ==========");
-            Serial.println("[TEST] Recording 10 seconds...");
-            setLedColor(255, 0, 0); // Red - recording
-
-            const size_t recordDuration = 10; // 10 seconds
-            const size_t bufferSize = 16000 * 2 * recordDuration; // 16kHz, 16-bit, 10s
-            uint8_t* testBuffer = (uint8_t*)malloc(bufferSize);
-
-            if (!testBuffer) {
-                Serial.println("[ERROR] Failed to allocate test buffer!");
-                setLedColor(0, 0, 0);
-            } else {
-                size_t totalBytes = 0;
-                size_t bytesRead = 0;
-
-                i2s_zero_dma_buffer(MIC_I2S_NUM);
-                delay(100);
-
-                unsigned long startTime = millis();
-                while ((millis() - startTime) < (recordDuration * 1000) && totalBytes < bufferSize) {
-                    i2s_read(MIC_I2S_NUM, testBuffer + totalBytes, 1024, &bytesRead, portMAX_DELAY);
-                    totalBytes += bytesRead;
-
-                    // Print progress every second
-                    if ((millis() - startTime) % 1000 < 50) {
-                        int16_t* samples = (int16_t*)(testBuffer + totalBytes - bytesRead);
-                        int32_t maxLevel = 0;
-                        for (size_t i = 0; i < bytesRead / 2; i++) {
-                            if (abs(samples[i]) > maxLevel) maxLevel = abs(samples[i]);
-                        }
-                        Serial.printf("[TEST] %ds | Max Level: %d | Bytes: %d\n",
-                            (millis() - startTime) / 1000, maxLevel, totalBytes);
-                    }
-                }
-
-                Serial.printf("[TEST] Recorded %d bytes in %d seconds\n",
-                    totalBytes, (millis() - startTime) / 1000);
-
-                // Calculate and show audio statistics
-                int16_t* samples = (int16_t*)testBuffer;
-                size_t numSamples = totalBytes / 2;
-                int32_t maxLevel = 0;
-                int64_t totalEnergy = 0;
-
-                for (size_t i = 0; i < numSamples; i++) {
-                    int32_t level = abs(samples[i]);
-                    totalEnergy += level;
-                    if (level > maxLevel) maxLevel = level;
-                }
-
-                int32_t avgLevel = totalEnergy / numSamples;
-                Serial.printf("[TEST] Audio Stats: Max=%d, Avg=%d\n", maxLevel, avgLevel);
-
-                if (maxLevel < 100) {
-                    Serial.println("[WARNING] Very low audio levels - mic might not be working!");
-                } else if (maxLevel > 30000) {
-                    Serial.println("[WARNING] Very high audio levels - might be clipping!");
-                } else {
-                    Serial.println("[TEST] Audio levels look good!");
-                }
-
-                // Playback
-                Serial.println("[TEST] Playing back recording...");
-                setLedColor(0, 255, 0); // Green - playing
-                delay(500);
-
-                // Convert mono to stereo for playback
-                int16_t stereoSample[2];
-                size_t bytesWritten;
-
-                for (size_t i = 0; i < numSamples; i++) {
-                    stereoSample[0] = samples[i]; // Left
-                    stereoSample[1] = samples[i]; // Right
-                    i2s_write(SPK_I2S_NUM, stereoSample, 4, &bytesWritten, portMAX_DELAY);
-                }
-
-                i2s_zero_dma_buffer(SPK_I2S_NUM);
-                free(testBuffer);
-
-                Serial.println("[TEST] Playback complete!");
-                setLedColor(0, 0, 0); // Off
-                Serial.println("===================================\n");
-            }
+            // Microphone test: 'r', 'r <delay ms>' or 'r <delay ms> <seconds>'
+            String args = Serial.readStringUntil('\n');
+            unsigned delayMs = MIC_TEST_DELAY_MS, seconds = MIC_TEST_SECONDS;
+            sscanf(args.c_str(), "%u %u", &delayMs, &seconds);
+            if (seconds == 0 || seconds > MIC_TEST_MAX_SECONDS) seconds = MIC_TEST_SECONDS;
+            micTest(delayMs, seconds);
         }
     }
 
     // ============== Continuous Wake Word Detection ==============
     // Continuous inference runs on every loop (no timing delay needed)
     // The double buffering and slice-based approach handles timing automatically
-    if (detectWakeWord()) {
+    // A wake word heard over the last reply (barge-in) starts its turn first
+    if (bargeInConsume() || detectWakeWord()) {
         // Wake word detected! Start recording and conversation
         setLedColor(0, 255, 255); // Cyan (listening)
         soundListening();  // High ping - attention sound
@@ -1181,14 +1773,15 @@ void loop() {
         uint8_t* audioData = recordAudio(&bytesRecorded);
 
         if (audioData && bytesRecorded > 0) {
-            // Send to backend and play response
-            sendAndPlay(audioData, bytesRecorded);
-            free(audioData);
+            // Send to backend (after the audio that woke us) and play response
+            sendAndPlay(audioData, bytesRecorded, true);
         }
+        releaseRecording(audioData);
+        telemetryCommitTurn();
 
         // Reset for next wake word detection
-        consecutiveWakeDetections = 0;
-        print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
+        wakeEngine.reset();
+        if (!bargeInPending) wakePrerollReset();
         setLedColor(0, 0, 0); // Off
     }
 }
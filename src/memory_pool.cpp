@@ -0,0 +1,100 @@
+/*
+ * Memory Placement Pools for NOVA
+ * See memory_pool.h
+ */
+
+#include <Arduino.h>
+#include "memory_pool.h"
+
+#define POOL_SLOT(name, size, caps)  { name, size, caps, nullptr, false, false, 0, 0 }
+
+PoolSlot memoryPools[POOL_COUNT] = {
+    POOL_SLOT("record",      RECORD_BUFFER_SIZE,                         POOL_CAPS_PSRAM),
+    POOL_SLOT("wake_slice0", EI_CLASSIFIER_SLICE_SIZE * sizeof(int16_t), POOL_CAPS_INTERNAL),
+    POOL_SLOT("wake_slice1", EI_CLASSIFIER_SLICE_SIZE * sizeof(int16_t), POOL_CAPS_INTERNAL),
+    POOL_SLOT("stream_in",   STREAM_CHUNK_BYTES,                         POOL_CAPS_INTERNAL),
+    POOL_SLOT("resampled",   STREAM_CHUNK_BYTES,                         POOL_CAPS_INTERNAL),
+    POOL_SLOT("stereo",      STREAM_CHUNK_BYTES * 2,                     POOL_CAPS_INTERNAL),
+    POOL_SLOT("prefill",     STREAM_PREFILL_BYTES,                       POOL_CAPS_PSRAM),
+#if SCORE_CAPTURE_SLICES > 0
+    POOL_SLOT("score_ring",  SCORE_RING_BYTES,                           POOL_CAPS_PSRAM),
+#endif
+#if WAKE_PREROLL_MS > 0
+    POOL_SLOT("preroll",     WAKE_PREROLL_BYTES,                         POOL_CAPS_PSRAM),
+#endif
+#if ECHO_REFERENCE_MS > 0
+    POOL_SLOT("echo_ref",    ECHO_REFERENCE_BYTES,                       POOL_CAPS_PSRAM),
+#endif
+};
+
+bool memoryPoolsBegin() {
+    bool ok = true;
+    for (int i = 0; i < POOL_COUNT; i++) {
+        PoolSlot& slot = memoryPools[i];
+        if (slot.base) continue;
+
+        slot.base = (uint8_t*)heap_caps_aligned_alloc(POOL_ALIGN, slot.size, slot.caps);
+        if (!slot.base) {
+            // No PSRAM (or internal exhausted): take whatever the default heap has
+            slot.base = (uint8_t*)heap_caps_aligned_alloc(POOL_ALIGN, slot.size, MALLOC_CAP_8BIT);
+            slot.fallback = (slot.base != nullptr);
+        }
+        if (!slot.base) {
+            Serial.printf("[MEM] Failed to reserve pool '%s' (%u bytes)\n", slot.name, slot.size);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+uint8_t* memoryPoolCheckout(PoolId id) {
+    PoolSlot& slot = memoryPools[id];
+    if (!slot.base || slot.inUse) {
+        slot.failures++;
+        Serial.printf("[MEM] Pool '%s' unavailable (%s)\n", slot.name, slot.base ? "in use" : "not reserved");
+        return nullptr;
+    }
+    slot.inUse = true;
+    slot.checkouts++;
+    return slot.base;
+}
+
+void memoryPoolCheckin(PoolId id) {
+    memoryPools[id].inUse = false;
+}
+
+size_t memoryPoolSize(PoolId id) {
+    return memoryPools[id].size;
+}
+
+static void memoryReportRegion(const char* name, uint32_t caps) {
+    size_t total = heap_caps_get_total_size(caps);
+    if (total == 0) {
+        Serial.printf("[MEM] %-8s not present\n", name);
+        return;
+    }
+    size_t freeBytes = heap_caps_get_free_size(caps);
+    size_t largest = heap_caps_get_largest_free_block(caps);
+    size_t lowWater = heap_caps_get_minimum_free_size(caps);
+    // Fragmentation: share of free memory not usable as one block
+    unsigned fragPct = freeBytes ? (unsigned)(100 - (uint64_t)largest * 100 / freeBytes) : 0;
+    Serial.printf("[MEM] %-8s free %7u / %7u | high-water used %7u | largest block %7u | frag %u%%\n",
+                  name, freeBytes, total, total - lowWater, largest, fragPct);
+}
+
+void memoryReport() {
+    memoryReportRegion("INTERNAL", POOL_CAPS_INTERNAL);
+    memoryReportRegion("PSRAM", POOL_CAPS_PSRAM);
+
+    size_t reserved = 0;
+    for (int i = 0; i < POOL_COUNT; i++) {
+        const PoolSlot& slot = memoryPools[i];
+        reserved += slot.base ? slot.size : 0;
+        Serial.printf("[MEM]   %-12s %7u bytes %-8s%s | checkouts %u | failures %u%s\n",
+                      slot.name, slot.size,
+                      slot.caps == POOL_CAPS_PSRAM ? "PSRAM" : "INTERNAL",
+                      slot.fallback ? " (fallback)" : "",
+                      slot.checkouts, slot.failures, slot.inUse ? " | IN USE" : "");
+    }
+    Serial.printf("[MEM] Pools reserved: %u bytes\n", reserved);
+}
@@ -0,0 +1,94 @@
+/*
+ * Memory Placement Pools for NOVA
+ * Every audio buffer the firmware needs is reserved once at boot from the
+ * heap region it belongs in, then checked out / checked in per use
+ *
+ *   PSRAM    - large, long-lived, bandwidth-tolerant (recording, prefill)
+ *   INTERNAL - small and touched every sample (wake word slices, I2S staging)
+ *
+ * No malloc/free in the turn loop means no fragmentation over days of uptime,
+ * and a failed reservation shows up at boot instead of mid-conversation.
+ * The table and the functions are in memory_pool.cpp.
+ */
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_heap_caps.h"
+#include "config.h"
+#include "edge-impulse-sdk/classifier/ei_score_cache.h"
+
+#define POOL_CAPS_PSRAM     (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#define POOL_CAPS_INTERNAL  (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define POOL_ALIGN          16
+
+// What the pools may take of each region. Internal SRAM is shared with WiFi,
+// the I2S DMA and the SDK's small allocations; PSRAM (8MB) with the SDK's
+// large ones. tests/test_memory_pool.cpp reserves the pools within these.
+#define POOL_INTERNAL_BUDGET    (32 * 1024)
+#define POOL_PSRAM_BUDGET       (4 * 1024 * 1024)
+
+enum PoolId {
+    POOL_RECORD,            // recordAudio() utterance + mic test
+    POOL_WAKE_SLICE_0,      // Continuous inference double buffer
+    POOL_WAKE_SLICE_1,
+    POOL_STREAM_CHUNK,      // playStream() network read buffer
+    POOL_STREAM_RESAMPLED,  // playStream() resampler output
+    POOL_STREAM_STEREO,     // playStream() / sound effects I2S staging
+    POOL_STREAM_PREFILL,    // playStream() jitter prefill
+#if SCORE_CAPTURE_SLICES > 0
+    POOL_SCORE_RING,        // score_capture.h ring of per-slice results
+#endif
+#if WAKE_PREROLL_MS > 0
+    POOL_WAKE_PREROLL,      // wake_preroll.h ring of raw mic samples
+#endif
+#if ECHO_REFERENCE_MS > 0
+    POOL_ECHO_REFERENCE,    // echo_canceller.h ring of speaker samples
+#endif
+    POOL_COUNT
+};
+
+struct PoolSlot {
+    const char* name;
+    size_t size;
+    uint32_t caps;          // Preferred region
+    uint8_t* base;
+    bool inUse;
+    bool fallback;          // Ended up outside the preferred region
+    uint32_t checkouts;
+    uint32_t failures;      // Checkout while in use, or never reserved
+};
+
+// Sizes are the worst case for each user (see playStream() and recordAudio())
+#define STREAM_CHUNK_BYTES      2048
+#define STREAM_PREFILL_BYTES    ((SPK_MAX_SAMPLE_RATE * 2 * STREAM_PREFILL_MS / 1000) & ~1)
+#define SCORE_RING_BYTES        (SCORE_CAPTURE_SLICES * \
+                                 ei_score_cache_record_size(EI_CLASSIFIER_LABEL_COUNT, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE))
+#define WAKE_PREROLL_BYTES      (SAMPLE_RATE * WAKE_PREROLL_MS / 1000 * sizeof(int16_t))
+#define ECHO_REFERENCE_BYTES    (SAMPLE_RATE * ECHO_REFERENCE_MS / 1000 * sizeof(int16_t))
+
+extern PoolSlot memoryPools[POOL_COUNT];
+
+/**
+ * @brief Reserve every pool. Call once in setup(), before anything else allocates.
+ * @return false if any pool could not be reserved in any region
+ */
+bool memoryPoolsBegin();
+
+/**
+ * @brief Borrow a pool buffer. Returns nullptr if it is already checked out.
+ */
+uint8_t* memoryPoolCheckout(PoolId id);
+
+void memoryPoolCheckin(PoolId id);
+
+size_t memoryPoolSize(PoolId id);
+
+/**
+ * @brief Print per-region free/high-water/largest block/fragmentation and pool usage
+ */
+void memoryReport();
+
+#endif // MEMORY_POOL_H
@@ -0,0 +1,192 @@
+/*
+ * Microphone AGC for NOVA
+ * One pass over each capture buffer feeds both consumers of the mic: the wake
+ * word model and the utterance uploaded to the backend. A shared peak envelope
+ * (instant attack, exponential release) drives one gain per feed, each with
+ * its own target level, gain range and release:
+ *
+ *   gain = clamp(target / envelope, minGain, maxGain)
+ *
+ * Gains drop at once and rise at their release rate, never while the envelope
+ * is below the gate (pauses don't pump up the noise floor). A limiter caps
+ * each 1ms block's gain at limit / block peak, so the output stays below the
+ * limit without clipping; the final saturation only guards rounding.
+ *
+ * Fixed point throughout process(): samples int16, gains Q16 with a Q10
+ * per-sample multiply, block math in int64. Floats only in begin().
+ * Shared by the firmware and tools/agc_eval.
+ */
+
+#ifndef MIC_AGC_H
+#define MIC_AGC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#define MIC_AGC_BLOCK       16      // Samples per envelope/gain update, 1ms at 16kHz
+#define MIC_AGC_FEEDS       2
+
+enum MicAgcFeed {
+    AGC_FEED_WAKE = 0,      // Wake word model input
+    AGC_FEED_UPLOAD = 1     // Utterance sent to STT
+};
+
+struct MicAgcFeedConfig {
+    int16_t target;         // Envelope peak level the gain aims for
+    float minGain;
+    float maxGain;          // At most 32
+    uint32_t releaseMs;     // Time constant of a rising gain
+};
+
+struct MicAgcConfig {
+    uint32_t sampleRate;
+    uint32_t envelopeReleaseMs; // Time constant of a falling envelope
+    int16_t gate;               // Below this envelope gains hold
+    int16_t limit;              // No output sample goes past this
+    MicAgcFeedConfig feeds[MIC_AGC_FEEDS];
+};
+
+struct MicAgcStats {
+    uint32_t samples;
+    uint32_t clipped;       // Saturated samples, 0 unless rounding beat the limiter
+    uint32_t limitedBlocks; // Blocks where the limiter cut the gain
+};
+
+class MicAgc {
+public:
+    /**
+     * @brief Convert the config to fixed point and start each feed at its
+     * maximum gain (the limiter takes care of a loud first block)
+     */
+    void begin(const MicAgcConfig& config) {
+        float blockMs = MIC_AGC_BLOCK * 1000.0f / config.sampleRate;
+        _envelopeRelease = coefficient(blockMs, config.envelopeReleaseMs);
+        _gate = config.gate;
+        _limit = config.limit;
+        for (int f = 0; f < MIC_AGC_FEEDS; f++) {
+            const MicAgcFeedConfig& feed = config.feeds[f];
+            float maxGain = feed.maxGain < 32.0f ? feed.maxGain : 32.0f;
+            _feeds[f].target = feed.target;
+            _feeds[f].minGain = (int32_t)(feed.minGain * 65536.0f);
+            _feeds[f].maxGain = (int32_t)(maxGain * 65536.0f);
+            _feeds[f].release = coefficient(blockMs, feed.releaseMs);
+        }
+        reset();
+    }
+
+    void reset() {
+        _envelope = 0;
+        for (int f = 0; f < MIC_AGC_FEEDS; f++) {
+            _feeds[f].gain = _feeds[f].maxGain;
+            _feeds[f].stats = MicAgcStats();
+        }
+    }
+
+    /**
+     * @brief Track the envelope over `count` samples and write each feed that
+     * has an output (nullptr skips the multiply but still moves its gain).
+     * With a single output, it may be the input.
+     */
+    void process(const int16_t* in, int16_t* wakeOut, int16_t* uploadOut, size_t count) {
+        int16_t* outs[MIC_AGC_FEEDS] = { wakeOut, uploadOut };
+
+        for (size_t start = 0; start < count; start += MIC_AGC_BLOCK) {
+            size_t n = count - start < MIC_AGC_BLOCK ? count - start : MIC_AGC_BLOCK;
+            const int16_t* x = in + start;
+
+            int32_t peak = 0;
+            for (size_t i = 0; i < n; i++) {
+                int32_t a = x[i] < 0 ? -(int32_t)x[i] : x[i];
+                if (a > peak) peak = a;
+            }
+            if (peak > _envelope) {
+                _envelope = peak;
+            } else {
+                _envelope -= (int32_t)(((int64_t)(_envelope - peak) * _envelopeRelease + 32767) >> 15);
+            }
+
+            for (int f = 0; f < MIC_AGC_FEEDS; f++) {
+                Feed& feed = _feeds[f];
+                int32_t gain = nextGain(feed, peak);
+                if (outs[f]) apply(x, outs[f] + start, n, feed.gain, gain, feed.stats);
+                feed.gain = gain;
+                feed.stats.samples += n;
+            }
+        }
+    }
+
+    /**
+     * @brief Gain a feed is at, as a factor
+     */
+    float gain(MicAgcFeed feed) const {
+        return _feeds[feed].gain / 65536.0f;
+    }
+
+    int32_t envelope() const {
+        return _envelope;
+    }
+
+    const MicAgcStats& stats(MicAgcFeed feed) const {
+        return _feeds[feed].stats;
+    }
+
+private:
+    struct Feed {
+        int32_t target;
+        int32_t minGain, maxGain;   // Q16
+        int32_t release;            // Q15 per block
+        int32_t gain;               // Q16
+        MicAgcStats stats;
+    };
+
+    // Per-block step of a one-pole filter with time constant `ms`, Q15
+    static int32_t coefficient(float blockMs, uint32_t ms) {
+        if (ms == 0) return 32768;
+        return (int32_t)((1.0f - expf(-blockMs / ms)) * 32768.0f + 0.5f);
+    }
+
+    int32_t nextGain(Feed& feed, int32_t peak) {
+        int32_t desired = _envelope > 0 ? (int32_t)(((int64_t)feed.target << 16) / _envelope) : feed.maxGain;
+        if (desired > feed.maxGain) desired = feed.maxGain;
+        if (desired < feed.minGain) desired = feed.minGain;
+
+        int32_t gain = feed.gain;
+        if (desired < gain) {
+            gain = desired;
+        } else if (_envelope >= _gate) {
+            gain += (int32_t)(((int64_t)(desired - gain) * feed.release) >> 15);
+        }
+
+        // Look-ahead limiter: this block's peak is known before it is scaled
+        if (peak > 0) {
+            int32_t ceiling = (int32_t)(((int64_t)_limit << 16) / peak);
+            if (gain > ceiling) {
+                gain = ceiling;
+                feed.stats.limitedBlocks++;
+            }
+        }
+        return gain;
+    }
+
+    // Rising gains ramp across the block, falling ones apply at once (both stay under the limiter)
+    static void apply(const int16_t* x, int16_t* out, size_t n, int32_t from, int32_t to, MicAgcStats& stats) {
+        int32_t g = to < from ? to : from;
+        int32_t step = to > from ? (to - from) / (int32_t)n : 0;
+        for (size_t i = 0; i < n; i++) {
+            g += step;
+            int32_t y = (x[i] * (g >> 6)) >> 10;
+            if (y > 32767) { y = 32767; stats.clipped++; }
+            else if (y < -32768) { y = -32768; stats.clipped++; }
+            out[i] = (int16_t)y;
+        }
+    }
+
+    int32_t _envelope = 0;
+    int32_t _envelopeRelease = 0;
+    int32_t _gate = 0;
+    int32_t _limit = 32767;
+    Feed _feeds[MIC_AGC_FEEDS];
+};
+
+#endif // MIC_AGC_H
@@ -0,0 +1,265 @@
+/*
+ * Mic Diagnostics for NOVA
+ * Statistics for the mic test ('r' on serial), fed block by block while the
+ * mic streams back out of the speaker:
+ *
+ *   levels    RMS (DC removed), peak, DC offset and clipped samples, for the
+ *             whole test and per interval (the live meter)
+ *   floor     Hann-windowed MIC_DIAG_FFT-point power spectra through RealFft
+ *             (real_fft.h); per bin the minimum of their running average,
+ *             so speech and the loopback don't count. In octave bands, plus the
+ *             strongest narrow tone standing out of it (mains hum, coil whine)
+ *
+ * report() turns them into a MicDiagReport with problem flags an installer
+ * can act on. Levels are dBFS, 0 being an RMS of 32768. No allocation: the
+ * FFT's memory is part of the object, and the caller owns the I2S and the
+ * loopback buffers.
+ */
+
+#ifndef MIC_DIAGNOSTICS_H
+#define MIC_DIAGNOSTICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "real_fft.h"
+
+#define MIC_DIAG_FFT            512     // 32ms, 31.25 Hz bins at 16kHz
+#define MIC_DIAG_BINS           (MIC_DIAG_FFT / 2 + 1)
+#define MIC_DIAG_BANDS          7       // Octaves from 125 Hz, everything under it in the first
+#define MIC_DIAG_SMOOTHING      0.875f  // Running average over about 8 frames
+#define MIC_DIAG_SETTLE_FRAMES  8       // Frames before the minimum is tracked
+#define MIC_DIAG_TONE_DB        15.0f   // A floor bin this far over its neighbours is a tone
+
+enum MicDiagFlag : uint32_t {
+    MIC_DIAG_DEAD       = 0x01,     // Peak under deadPeak: no mic, or a wiring/clock fault
+    MIC_DIAG_CLIPPING   = 0x02,     // Over 0.1% of samples at the clip level
+    MIC_DIAG_DC         = 0x04,     // DC offset over maxDc
+    MIC_DIAG_NOISY      = 0x08,     // Floor over maxFloorRms: recordings won't stop on silence
+    MIC_DIAG_TONE       = 0x10      // A steady tone in the floor
+};
+
+struct MicDiagConfig {
+    uint32_t sampleRate;
+    int16_t clipLevel;          // |sample| at or over this counts as clipped
+    int16_t deadPeak;
+    int16_t maxDc;
+    int16_t maxFloorRms;        // recordAudio()'s silence threshold
+};
+
+struct MicLevels {
+    uint32_t count;
+    int64_t sum;
+    uint64_t sumSquares;
+    int32_t peak;
+    uint32_t clipped;
+
+    float dc() const {
+        return count ? (float)sum / count : 0.0f;
+    }
+
+    float rms() const {
+        if (count == 0) return 0.0f;
+        float dcLevel = dc();
+        float meanSquare = (float)((double)sumSquares / count) - dcLevel * dcLevel;
+        return meanSquare > 0.0f ? sqrtf(meanSquare) : 0.0f;
+    }
+};
+
+struct MicDiagReport {
+    uint32_t samples;
+    float rmsDbfs;
+    float peakDbfs;
+    float dcOffset;
+    uint32_t clipped;
+    float floorRms;                     // Whole floor, in sample units
+    float floorDbfs;
+    float bandDbfs[MIC_DIAG_BANDS];     // Floor per octave
+    float toneHz;                       // Strongest tone in the floor, 0 if none stands out
+    float toneDb;                       // Over its neighbours
+    uint32_t fftErrors;
+    uint32_t flags;                     // MicDiagFlag
+};
+
+// Upper edges of the octave bands, Hz
+static const uint16_t micDiagBandEdges[MIC_DIAG_BANDS] = { 125, 250, 500, 1000, 2000, 4000, 8000 };
+
+static inline float micDiagDbfs(float rms) {
+    return 20.0f * log10f((rms > 1.0f ? rms : 1.0f) / 32768.0f);
+}
+
+class MicDiagnostics {
+public:
+    /**
+     * @brief Check the config, build the window and set up the FFT
+     * @return false if a setting is unusable or there is no FFT
+     */
+    bool begin(const MicDiagConfig& config) {
+        if (config.sampleRate == 0 || config.clipLevel <= 0 || config.maxFloorRms <= 0) return false;
+        if (!_fft.begin()) return false;
+        _config = config;
+        float windowPower = 0.0f;
+        for (int n = 0; n < MIC_DIAG_FFT; n++) {
+            _window[n] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * n / MIC_DIAG_FFT);
+            windowPower += _window[n] * _window[n];
+        }
+        // One-sided power to mean square per bin (Parseval), DC and Nyquist counted once
+        _binScale = 2.0f / (MIC_DIAG_FFT * windowPower);
+        reset();
+        return true;
+    }
+
+    void reset() {
+        memset(&_total, 0, sizeof(_total));
+        memset(&_interval, 0, sizeof(_interval));
+        _fill = 0;
+        _frames = 0;
+        _fftErrors = 0;
+        for (int k = 0; k < MIC_DIAG_BINS; k++) {
+            _average[k] = 0.0f;
+            _floor[k] = INFINITY;
+        }
+    }
+
+    void process(const int16_t* samples, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            int16_t x = samples[i];
+            addLevel(_total, x);
+            addLevel(_interval, x);
+            _frame[_fill++] = x;
+            if (_fill == MIC_DIAG_FFT) {
+                processFrame();
+                _fill = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Levels since the last call, for the live meter
+     */
+    MicLevels takeInterval() {
+        MicLevels levels = _interval;
+        memset(&_interval, 0, sizeof(_interval));
+        return levels;
+    }
+
+    const MicLevels& total() const {
+        return _total;
+    }
+
+    MicDiagReport report() const {
+        MicDiagReport r;
+        memset(&r, 0, sizeof(r));
+        r.samples = _total.count;
+        r.rmsDbfs = micDiagDbfs(_total.rms());
+        r.peakDbfs = micDiagDbfs((float)_total.peak);
+        r.dcOffset = _total.dc();
+        r.clipped = _total.clipped;
+        r.fftErrors = _fftErrors;
+
+        if (_total.peak < _config.deadPeak) r.flags |= MIC_DIAG_DEAD;
+        if ((uint64_t)_total.clipped * 1000 > _total.count) r.flags |= MIC_DIAG_CLIPPING;
+        if (fabsf(r.dcOffset) > _config.maxDc) r.flags |= MIC_DIAG_DC;
+
+        if (_frames <= MIC_DIAG_SETTLE_FRAMES) {
+            r.floorDbfs = micDiagDbfs(0.0f);
+            for (int b = 0; b < MIC_DIAG_BANDS; b++) r.bandDbfs[b] = r.floorDbfs;
+            return r;   // Too short for a floor
+        }
+
+        float total = 0.0f, band[MIC_DIAG_BANDS] = {};
+        for (int k = 1; k < MIC_DIAG_BINS; k++) {
+            float power = floorPower(k);
+            float hz = (float)k * _config.sampleRate / MIC_DIAG_FFT;
+            int b = 0;
+            while (b < MIC_DIAG_BANDS - 1 && hz >= micDiagBandEdges[b]) b++;
+            band[b] += power;
+            total += power;
+        }
+        r.floorRms = sqrtf(total);
+        r.floorDbfs = micDiagDbfs(r.floorRms);
+        for (int b = 0; b < MIC_DIAG_BANDS; b++) r.bandDbfs[b] = micDiagDbfs(sqrtf(band[b]));
+        if (r.floorRms > _config.maxFloorRms) r.flags |= MIC_DIAG_NOISY;
+
+        // Hann leaks a tone over +-2 bins: compare with the bins 3 away. Not in digital silence
+        float bestRatio = 1.0f;
+        int best = 0;
+        for (int k = 1; k < MIC_DIAG_BINS - 1; k++) {
+            float power = floorPower(k);
+            if (power < 1.0f) continue;
+            float below = k > 3 ? floorPower(k - 3) : floorPower(k + 3);
+            float above = k + 3 < MIC_DIAG_BINS ? floorPower(k + 3) : below;
+            float ratio = power / (0.5f * (below + above) + 1e-6f);
+            if (ratio > bestRatio) {
+                bestRatio = ratio;
+                best = k;
+            }
+        }
+        r.toneDb = 10.0f * log10f(bestRatio);
+        if (r.toneDb >= MIC_DIAG_TONE_DB) {
+            // Mains hum falls between bins: Hann's two-bin estimate from the larger neighbour's
+            // magnitude ratio. Bin 0 lost its share with the DC, so not that one
+            float b = sqrtf(floorPower(best));
+            float a = best > 1 ? sqrtf(floorPower(best - 1)) : 0.0f, c = sqrtf(floorPower(best + 1));
+            float ratio = (c >= a ? c : a) / b;
+            float offset = (2.0f * ratio - 1.0f) / (ratio + 1.0f);
+            if (c < a) offset = -offset;
+            r.toneHz = (best + offset) * _config.sampleRate / MIC_DIAG_FFT;
+            r.flags |= MIC_DIAG_TONE;
+        }
+        return r;
+    }
+
+private:
+    void addLevel(MicLevels& levels, int16_t x) {
+        int32_t magnitude = x < 0 ? -(int32_t)x : x;
+        levels.count++;
+        levels.sum += x;
+        levels.sumSquares += (uint64_t)((int32_t)x * x);
+        if (magnitude > levels.peak) levels.peak = magnitude;
+        if (magnitude >= _config.clipLevel) levels.clipped++;
+    }
+
+    // Mean square the floor puts in bin k
+    float floorPower(int k) const {
+        float scale = (k == 0 || k == MIC_DIAG_BINS - 1) ? 0.5f * _binScale : _binScale;
+        return _floor[k] * scale;
+    }
+
+    void processFrame() {
+        // DC is reported on its own; left in, the window would leak it into the low bins.
+        // The running offset, not the frame's mean: 32ms of hum doesn't average out
+        float dc = _total.dc();
+        for (int n = 0; n < MIC_DIAG_FFT; n++) _work[n] = (_frame[n] - dc) * _window[n];
+        if (!_fft.forward(_work, _spectrum)) {
+            _fftErrors++;
+            return;
+        }
+        for (int k = 0; k < MIC_DIAG_BINS; k++) {
+            float power = _spectrum[k].r * _spectrum[k].r + _spectrum[k].i * _spectrum[k].i;
+            _average[k] = _frames == 0 ? power : MIC_DIAG_SMOOTHING * _average[k] + (1.0f - MIC_DIAG_SMOOTHING) * power;
+            if (_frames >= MIC_DIAG_SETTLE_FRAMES && _average[k] < _floor[k]) _floor[k] = _average[k];
+        }
+        _frames++;
+    }
+
+    MicDiagConfig _config = {};
+    float _window[MIC_DIAG_FFT];
+    float _binScale = 0.0f;
+    RealFft<MIC_DIAG_FFT> _fft;
+
+    MicLevels _total;
+    MicLevels _interval;
+
+    int16_t _frame[MIC_DIAG_FFT];
+    int _fill = 0;
+    float _work[MIC_DIAG_FFT];
+    ei::fft_complex_t _spectrum[MIC_DIAG_BINS];
+    uint32_t _frames = 0;
+    uint32_t _fftErrors = 0;
+    float _average[MIC_DIAG_BINS];      // Running average power
+    float _floor[MIC_DIAG_BINS];        // Its minimum
+};
+
+#endif // MIC_DIAGNOSTICS_H
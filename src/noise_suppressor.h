@@ -0,0 +1,267 @@
+/*
+ * Noise Suppressor for NOVA
+ * Single-channel suppression of steady background noise (fans, hum, HVAC, a
+ * TV in the next room) on the utterance uploaded to STT. 16ms frames with 50%
+ * overlap, sqrt-Hann analysis and synthesis windows, one gain per FFT bin:
+ *
+ *   noise  Minimum statistics: per bin, the smoothed power's minimum over
+ *          the last `noiseWindowMs` (tracked in sub-windows), times an
+ *          overestimate that makes up for the minimum sitting below the mean.
+ *          Speech never holds a bin for the whole window, so it doesn't leak in.
+ *   gain   Wiener, G = snr / (1 + snr), with the a priori SNR decision
+ *          directed (mostly the last frame's cleaned power, so gains don't
+ *          flicker into musical noise), floored at `floorDb`.
+ *
+ * Both transforms go through RealFft (real_fft.h), whichever FFT engine the
+ * build selected with its memory held here, so process() never allocates.
+ * The engines have no inverse real FFT in common: a Hermitian spectrum is
+ * inverted with a second forward one through the Hartley transform, which is
+ * its own inverse.
+ *
+ * Output lags input by NS_FRAME samples. restart() between utterances keeps
+ * the noise estimate, so the next one doesn't start from scratch. Shared by
+ * the firmware and tools/ns_eval.
+ */
+
+#ifndef NOISE_SUPPRESSOR_H
+#define NOISE_SUPPRESSOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "real_fft.h"
+
+#define NS_FRAME            256     // Samples per frame and FFT size, 16ms at 16kHz
+#define NS_HOP              (NS_FRAME / 2)
+#define NS_BINS             (NS_FRAME / 2 + 1)
+#define NS_SUBWINDOWS       8       // Minimum statistics window split into this many
+#define NS_POWER_SMOOTHING  0.85f   // Per-frame smoothing of the power the minimum is taken of
+
+struct NoiseSuppressorConfig {
+    uint32_t sampleRate;
+    uint32_t noiseWindowMs;     // Minimum tracked over this long: longer than a word, shorter than a change of noise
+    float overestimate;         // Noise = minimum times this (the bias of a minimum of smoothed power)
+    float floorDb;              // Most a bin is attenuated, negative
+    float smoothing;            // A priori SNR weight of the last frame, 0..1
+};
+
+struct NoiseSuppressorStats {
+    uint32_t frames;
+    uint32_t fftErrors;         // Frames passed through unchanged
+    double inEnergy;            // Over processed frames, before and after
+    double outEnergy;
+};
+
+class NoiseSuppressor {
+public:
+    /**
+     * @brief Check the config, build the windows and set up the FFT
+     * @return false if a setting is unusable or there is no FFT
+     */
+    bool begin(const NoiseSuppressorConfig& config) {
+        if (config.sampleRate == 0 || config.overestimate < 1.0f || config.floorDb > 0.0f ||
+            config.smoothing < 0.0f || config.smoothing >= 1.0f) {
+            return false;
+        }
+        uint32_t frames = (uint32_t)((uint64_t)config.noiseWindowMs * config.sampleRate / 1000 / NS_HOP);
+        if (frames < NS_SUBWINDOWS || !_fft.begin()) return false;
+        _config = config;
+        _subwindowFrames = frames / NS_SUBWINDOWS;
+        _floor = powf(10.0f, config.floorDb / 20.0f);
+        // sqrt-Hann (periodic) on both sides: the squares overlap-add to 1 at 50%
+        for (int n = 0; n < NS_FRAME; n++) {
+            _window[n] = sinf((float)M_PI * n / NS_FRAME);
+        }
+        reset();
+        return true;
+    }
+
+    /**
+     * @brief Forget the noise estimate as well as the signal
+     */
+    void reset() {
+        _frames = 0;
+        _subwindowFill = 0;
+        _subwindow = 0;
+        for (int k = 0; k < NS_BINS; k++) {
+            _power[k] = 0.0f;
+            _minimum[k] = INFINITY;
+            _windowMinimum[k] = INFINITY;
+            _cleanPower[k] = 0.0f;
+            for (int s = 0; s < NS_SUBWINDOWS; s++) _subMinimum[s][k] = INFINITY;
+        }
+        _stats = NoiseSuppressorStats();
+        restart();
+    }
+
+    /**
+     * @brief Start a new utterance: clear the signal, keep the noise estimate
+     */
+    void restart() {
+        memset(_input, 0, sizeof(_input));
+        memset(_overlap, 0, sizeof(_overlap));
+        memset(_ready, 0, sizeof(_ready));
+        memset(_cleanPower, 0, sizeof(_cleanPower));
+        _fill = NS_HOP;
+        _readPos = 0;
+    }
+
+    /**
+     * @brief Suppress `count` samples. Output is NS_FRAME samples behind the
+     * input (zeros first); `out` may be `in`.
+     */
+    void process(const int16_t* in, int16_t* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            int16_t x = in ? in[i] : 0;
+            out[i] = _ready[_readPos++];
+            _input[_fill++] = x;
+            if (_fill == NS_FRAME) {
+                processFrame();
+                memmove(_input, _input + NS_HOP, NS_HOP * sizeof(int16_t));
+                _fill = NS_HOP;
+                _readPos = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Push zeros to get out the last NS_FRAME samples of the utterance
+     */
+    void flush(int16_t* out, size_t count) {
+        process(nullptr, out, count);
+    }
+
+    /**
+     * @brief Estimated noise power in bin k, 0 until the first frame
+     */
+    float noise(int k) const {
+        return _frames > 0 ? noiseAt(k) : 0.0f;
+    }
+
+    const NoiseSuppressorStats& stats() const {
+        return _stats;
+    }
+
+private:
+    float noiseAt(int k) const {
+        float m = _minimum[k] < _windowMinimum[k] ? _minimum[k] : _windowMinimum[k];
+        return _config.overestimate * m;
+    }
+
+    void processFrame() {
+        float inEnergy = 0.0f;
+        for (int n = 0; n < NS_FRAME; n++) {
+            _work[n] = _input[n] * _window[n];
+            if (n >= NS_HOP) inEnergy += (float)_input[n] * _input[n];
+        }
+        _stats.frames++;
+        _stats.inEnergy += inEnergy;
+
+        if (!_fft.forward(_work, _spectrum)) {
+            _stats.fftErrors++;
+            for (int n = 0; n < NS_FRAME; n++) _work[n] *= _window[n];
+            overlapAdd();
+            return;
+        }
+
+        trackNoise();
+        for (int k = 0; k < NS_BINS; k++) {
+            float re = _spectrum[k].r, im = _spectrum[k].i;
+            float power = re * re + im * im;
+            float noise = noiseAt(k);
+            float gain = 1.0f;
+            if (noise > 0.0f) {
+                float post = power / noise;
+                float prio = _config.smoothing * _cleanPower[k] / noise +
+                             (1.0f - _config.smoothing) * (post > 1.0f ? post - 1.0f : 0.0f);
+                gain = prio / (1.0f + prio);
+            }
+            if (gain < _floor) gain = _floor;
+            _cleanPower[k] = gain * gain * power;
+            _spectrum[k].r = re * gain;
+            _spectrum[k].i = im * gain;
+        }
+
+        // Inverse through Hartley: the DHT of a real signal is Re(X) - Im(X) of its DFT
+        for (int k = 0; k < NS_FRAME; k++) {
+            const ei::fft_complex_t& c = k < NS_BINS ? _spectrum[k] : _spectrum[NS_FRAME - k];
+            _work[k] = k < NS_BINS ? c.r - c.i : c.r + c.i;
+        }
+        if (!_fft.forward(_work, _spectrum)) {
+            // Too late to pass the frame through, this hop goes out silent
+            _stats.fftErrors++;
+            memset(_work, 0, sizeof(_work));
+        } else {
+            for (int n = 0; n < NS_FRAME; n++) {
+                const ei::fft_complex_t& c = n < NS_BINS ? _spectrum[n] : _spectrum[NS_FRAME - n];
+                _work[n] = (n < NS_BINS ? c.r - c.i : c.r + c.i) * _window[n] / NS_FRAME;
+            }
+        }
+        overlapAdd();
+    }
+
+    // Minimum of the smoothed power over the current sub-window and the last NS_SUBWINDOWS - 1
+    void trackNoise() {
+        for (int k = 0; k < NS_BINS; k++) {
+            float power = _spectrum[k].r * _spectrum[k].r + _spectrum[k].i * _spectrum[k].i;
+            _power[k] = _frames == 0 ? power : NS_POWER_SMOOTHING * _power[k] + (1.0f - NS_POWER_SMOOTHING) * power;
+            if (_power[k] < _minimum[k]) _minimum[k] = _power[k];
+        }
+        _frames++;
+        if (++_subwindowFill < _subwindowFrames) return;
+
+        _subwindowFill = 0;
+        memcpy(_subMinimum[_subwindow], _minimum, sizeof(_minimum));
+        _subwindow = (_subwindow + 1) % NS_SUBWINDOWS;
+        for (int k = 0; k < NS_BINS; k++) {
+            float m = INFINITY;
+            for (int s = 0; s < NS_SUBWINDOWS; s++) {
+                if (s != _subwindow && _subMinimum[s][k] < m) m = _subMinimum[s][k];
+            }
+            _windowMinimum[k] = m;
+            _minimum[k] = _power[k];
+        }
+    }
+
+    // The first half of this frame completes the last one's second half
+    void overlapAdd() {
+        float outEnergy = 0.0f;
+        for (int n = 0; n < NS_HOP; n++) {
+            float y = _overlap[n] + _work[n];
+            _ready[n] = y > 32767.0f ? 32767 : y < -32768.0f ? -32768 : (int16_t)lrintf(y);
+            outEnergy += y * y;
+            _overlap[n] = _work[n + NS_HOP];
+        }
+        _stats.outEnergy += outEnergy;
+    }
+
+    NoiseSuppressorConfig _config = {};
+    float _floor = 0.0f;
+    float _window[NS_FRAME];
+    RealFft<NS_FRAME> _fft;
+
+    // Signal
+    int16_t _input[NS_FRAME];           // Last frame of input, the newest hop filling
+    int _fill = NS_HOP;
+    float _work[NS_FRAME];
+    ei::fft_complex_t _spectrum[NS_BINS];
+    float _overlap[NS_HOP];             // Second half of the last frame's output
+    int16_t _ready[NS_HOP];             // Finished output, handed out while the next hop fills
+    int _readPos = 0;
+    float _cleanPower[NS_BINS];         // Last frame's power after the gain
+
+    // Noise
+    uint32_t _frames = 0;
+    uint32_t _subwindowFrames = 1;
+    uint32_t _subwindowFill = 0;
+    int _subwindow = 0;                 // Sub-window being tracked, its slot is overwritten next
+    float _power[NS_BINS];              // Smoothed
+    float _minimum[NS_BINS];            // Over the current sub-window
+    float _subMinimum[NS_SUBWINDOWS][NS_BINS];
+    float _windowMinimum[NS_BINS];      // Over the finished sub-windows
+
+    NoiseSuppressorStats _stats;
+};
+
+#endif // NOISE_SUPPRESSOR_H
@@ -0,0 +1,75 @@
+/*
+ * Real FFT for NOVA
+ * Forward FFT of N real samples through the engine the SDK build selected
+ * (ESP-DSP on the device, KissFFT elsewhere), with the engine's working memory
+ * inside the object. ei::numpy::rfft() goes through the same engines but
+ * allocates on every call: a copy of the input, then ESP-DSP's complex buffer
+ * or KissFFT's whole state. Shared by the noise suppressor and mic diagnostics.
+ *
+ * The KissFFT state points into the object, so it can't be copied.
+ */
+
+#ifndef REAL_FFT_H
+#define REAL_FFT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+
+template <size_t N>
+class RealFft {
+public:
+    static constexpr size_t BINS = N / 2 + 1;
+
+    RealFft() = default;
+    RealFft(const RealFft&) = delete;
+    RealFft& operator=(const RealFft&) = delete;
+
+    /**
+     * @brief Set up the engine: ESP-DSP's shared tables, or KissFFT's state
+     * @return false if it can't do N points
+     */
+    bool begin() {
+#if EIDSP_USE_ESP_DSP
+        // Does nothing if the SDK's own FFTs got there first
+        _ready = ei::fft::can_do_fft(N) && dsps_fft2r_init_fc32(NULL, CONFIG_DSP_MAX_FFT_SIZE) == ESP_OK;
+#else
+        size_t length = sizeof(_kissMemory);
+        _kiss = kiss_fftr_alloc(N, 0, _kissMemory, &length);
+        _ready = _kiss != nullptr;
+#endif
+        return _ready;
+    }
+
+    /**
+     * @brief The BINS complex bins of `in`, which is left as it was
+     */
+    bool forward(const float* in, ei::fft_complex_t* out) {
+        if (!_ready) return false;
+#if EIDSP_USE_ESP_DSP
+        for (size_t n = 0; n < N; n++) {
+            _complex[2 * n] = in[n];
+            _complex[2 * n + 1] = 0.0f;
+        }
+        if (dsps_fft2r_fc32(_complex, N) != ESP_OK) return false;
+        dsps_bit_rev_fc32(_complex, N);
+        memcpy(out, _complex, BINS * sizeof(ei::fft_complex_t));
+#else
+        kiss_fftr(_kiss, in, reinterpret_cast<kiss_fft_cpx*>(out));
+#endif
+        return true;
+    }
+
+private:
+    bool _ready = false;
+#if EIDSP_USE_ESP_DSP
+    alignas(16) float _complex[2 * N];
+#else
+    kiss_fftr_cfg _kiss = nullptr;
+    // N/2-point complex plan, its twiddles and the real FFT's: about 10N + 300 bytes
+    alignas(16) uint8_t _kissMemory[sizeof(kiss_fft_cpx) * N * 2 + 512];
+#endif
+};
+
+#endif // REAL_FFT_H
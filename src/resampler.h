@@ -0,0 +1,175 @@
+/*
+ * Streaming Polyphase Resampler for ESP32
+ * Converts int16 PCM between rates (e.g. 24kHz / 22.05kHz TTS -> 16kHz I2S)
+ *
+ * Same filter design as spectral::signal::resample_poly() in the Edge Impulse
+ * SDK (Kaiser windowed sinc, beta 5.0), but:
+ *   - the FIR is split into `up` polyphase branches once, so the zeros that
+ *     upfirdn() inserts are never multiplied
+ *   - coefficients are Q15 and the MAC loop is pure int32
+ *   - input history is carried between calls, so network chunks of any size
+ *     can be fed in as they arrive
+ *   - all state is fixed size, nothing is allocated after configure()
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+// Taps per polyphase branch (prototype filter length = up * TAPS)
+#define RESAMPLER_TAPS          16
+// 22050 -> 16000 reduces to 320/441, the largest ratio we need to support
+#define RESAMPLER_MAX_PHASES    320
+#define RESAMPLER_KAISER_BETA   5.0f
+
+class PolyphaseResampler {
+private:
+    int16_t coeffs[RESAMPLER_MAX_PHASES][RESAMPLER_TAPS];  // [phase][tap], Q15
+    int16_t history[RESAMPLER_TAPS * 2];  // Mirrored so a window is always contiguous
+    uint32_t historyPos = 0;
+    uint32_t up = 1;
+    uint32_t down = 1;
+    uint32_t phase = 0;
+    bool passthrough = true;
+
+    static uint32_t gcd(uint32_t a, uint32_t b) {
+        while (b) {
+            uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    // Zeroth order modified Bessel function (power series), for the Kaiser window
+    static float besselI0(float x) {
+        float sum = 1.0f;
+        float term = 1.0f;
+        float halfX = x * 0.5f;
+        for (int k = 1; k < 32; k++) {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+            if (term < sum * 1e-9f) break;
+        }
+        return sum;
+    }
+
+    void push(int16_t sample) {
+        historyPos = (historyPos == 0) ? RESAMPLER_TAPS - 1 : historyPos - 1;
+        history[historyPos] = sample;
+        history[historyPos + RESAMPLER_TAPS] = sample;
+    }
+
+    // history[historyPos + k] is x[n - k]
+    int16_t filter(uint32_t p) const {
+        const int16_t* h = coeffs[p];
+        const int16_t* x = &history[historyPos];
+        int32_t acc = 1 << 14;  // Rounding
+        for (int k = 0; k < RESAMPLER_TAPS; k++) {
+            acc += (int32_t)h[k] * x[k];
+        }
+        acc >>= 15;
+        if (acc > 32767) acc = 32767;
+        if (acc < -32768) acc = -32768;
+        return (int16_t)acc;
+    }
+
+public:
+    /**
+     * @brief Design the polyphase filter for inRate -> outRate
+     * @return false if the reduced ratio needs more than RESAMPLER_MAX_PHASES branches
+     */
+    bool configure(uint32_t inRate, uint32_t outRate) {
+        if (inRate == 0 || outRate == 0) return false;
+
+        uint32_t g = gcd(inRate, outRate);
+        uint32_t newUp = outRate / g;
+        uint32_t newDown = inRate / g;
+
+        if (newUp > RESAMPLER_MAX_PHASES) return false;
+
+        up = newUp;
+        down = newDown;
+        passthrough = (up == 1 && down == 1);
+        reset();
+
+        if (passthrough) return true;
+
+        // Prototype low-pass at the upsampled rate, cutoff at the lower Nyquist
+        const int len = up * RESAMPLER_TAPS;
+        const float cutoff = 1.0f / (float)(up > down ? up : down);  // Relative to Nyquist
+        const float center = (len - 1) * 0.5f;
+        const float i0Beta = besselI0(RESAMPLER_KAISER_BETA);
+
+        for (int n = 0; n < len; n++) {
+            float t = n - center;
+            float sinc = (t == 0.0f) ? cutoff : sinf((float)M_PI * cutoff * t) / ((float)M_PI * t);
+            float r = 2.0f * n / (len - 1) - 1.0f;
+            float window = besselI0(RESAMPLER_KAISER_BETA * sqrtf(1.0f - r * r)) / i0Beta;
+            float h = sinc * window * up;  // Gain of `up` restores the zero-stuffed energy
+
+            int32_t q = (int32_t)lrintf(h * 32768.0f);
+            if (q > 32767) q = 32767;
+            if (q < -32768) q = -32768;
+            coeffs[n % up][n / up] = (int16_t)q;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Clear filter history, e.g. between two unrelated streams
+     */
+    void reset() {
+        memset(history, 0, sizeof(history));
+        historyPos = 0;
+        phase = up;  // First output needs one input sample
+    }
+
+    bool isPassthrough() const { return passthrough; }
+
+    /**
+     * @brief Worst case output count for an input block, for sizing buffers
+     */
+    size_t maxOutput(size_t inCount) const {
+        return (inCount * up) / down + 1;
+    }
+
+    /**
+     * @brief Resample one block of mono int16 samples
+     * @param consumed Set to the number of input samples used. Always inCount
+     *                 when outCapacity >= maxOutput(inCount).
+     * @return Number of output samples written
+     */
+    size_t process(const int16_t* in, size_t inCount, int16_t* out, size_t outCapacity, size_t* consumed = nullptr) {
+        if (passthrough) {
+            size_t n = inCount < outCapacity ? inCount : outCapacity;
+            if (out != in) memmove(out, in, n * sizeof(int16_t));
+            if (consumed) *consumed = n;
+            return n;
+        }
+
+        size_t produced = 0;
+        size_t used = 0;
+
+        while (true) {
+            while (phase >= up) {
+                if (used >= inCount) goto done;
+                push(in[used++]);
+                phase -= up;
+            }
+            if (produced >= outCapacity) break;
+            out[produced++] = filter(phase);
+            phase += down;
+        }
+
+    done:
+        if (consumed) *consumed = used;
+        return produced;
+    }
+};
+
+#endif // RESAMPLER_H
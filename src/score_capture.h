@@ -0,0 +1,126 @@
+/*
+ * Wake Word Score Capture for NOVA
+ * Every classified slice (scores, DSP/NN timing and the int8 model input) is
+ * appended to a PSRAM ring in the SDK's score cache format
+ * (edge-impulse-sdk/classifier/ei_score_cache.h). The 's' serial command
+ * uploads the ring to the backend, which stores it as a .eisc file that
+ * tools/wake_eval and friends can replay without the device.
+ *
+ * Appending is a memcpy into a pool reserved at boot, no allocation per slice.
+ */
+
+#ifndef SCORE_CAPTURE_H
+#define SCORE_CAPTURE_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "config.h"
+#include "memory_pool.h"
+
+#define SCORE_UPLOAD_ENDPOINT   "/scores"
+
+#if SCORE_CAPTURE_SLICES > 0
+
+static ei_score_cache_ring_t scoreRing;
+static int8_t scoreFeatures[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE];
+static uint32_t scoreSliceIndex = 0;
+static bool scoreCaptureActive = false;
+
+/**
+ * @brief Claim the ring pool and start capturing model input. Call after memoryPoolsBegin().
+ */
+void scoreCaptureBegin() {
+    uint8_t* buffer = memoryPoolCheckout(POOL_SCORE_RING);
+    if (!buffer) return;
+
+    ei_score_cache_header_t header;
+    ei_score_cache_header_init(&header);
+    if (ei_score_cache_capture_input(&ei_default_impulse, scoreFeatures, &header) != EI_IMPULSE_OK) {
+        Serial.println("[SCORES] Model input not capturable, keeping scores only");
+    }
+    scoreCaptureActive = scoreRing.begin(buffer, memoryPoolSize(POOL_SCORE_RING), &header);
+    Serial.printf("[SCORES] Capturing last %u slices (%u bytes per slice)\n",
+                  scoreRing.capacity(), header.record_size);
+}
+
+/**
+ * @brief Record one result of run_classifier_continuous()
+ */
+void scoreCaptureAppend(const ei_impulse_result_t* result) {
+    if (!scoreCaptureActive) return;
+    scoreRing.append(result, scoreSliceIndex++, EI_SCORE_CACHE_NO_AUDIO,
+                     ei_score_cache_captured_input(&ei_default_impulse));
+}
+
+static size_t scoreCaptureWrite(const uint8_t* data, size_t size, void* ctx) {
+    WiFiClient* client = (WiFiClient*)ctx;
+    size_t written = 0;
+    // WiFiClient accepts partial writes under memory pressure
+    while (written < size) {
+        size_t n = client->write(data + written, size - written);
+        if (n == 0) break;
+        written += n;
+    }
+    return written;
+}
+
+/**
+ * @brief POST the ring to the backend and start over
+ */
+bool scoreCaptureUpload() {
+    if (!scoreCaptureActive || scoreRing.count() == 0) {
+        Serial.println("[SCORES] Nothing captured");
+        return false;
+    }
+    if (WiFi.status() != WL_CONNECTED) {
+        Serial.println("[SCORES] WiFi not connected");
+        return false;
+    }
+
+    WiFiClient client;
+    if (!client.connect(BACKEND_HOST, BACKEND_PORT)) {
+        Serial.println("[SCORES] Connection failed");
+        return false;
+    }
+
+    size_t size = scoreRing.dump_size();
+    client.println("POST " SCORE_UPLOAD_ENDPOINT " HTTP/1.0");
+    client.println("Host: " + String(BACKEND_HOST));
+    client.println("X-Device-Id: " + WiFi.macAddress());
+    if (DEVICE_TOKEN[0]) {
+        client.println("X-Device-Token: " DEVICE_TOKEN);
+    }
+    client.println("Content-Type: application/octet-stream");
+    client.println("Content-Length: " + String(size));
+    client.println("Connection: close");
+    client.println();
+
+    unsigned long start = millis();
+    size_t sent = scoreRing.dump(scoreCaptureWrite, &client);
+
+    unsigned long waitStart = millis();
+    while (client.connected() && !client.available() && millis() - waitStart < 5000) {
+        delay(10);
+    }
+    String status = client.readStringUntil('\n');
+    client.stop();
+
+    bool ok = (sent == size) && status.indexOf("200") >= 0;
+    Serial.printf("[SCORES] Uploaded %u slices, %u/%u bytes in %lu ms: %s\n",
+                  scoreRing.count(), sent, size, millis() - start, ok ? "OK" : status.c_str());
+    if (ok) scoreRing.clear();
+    return ok;
+}
+
+#else
+
+void scoreCaptureBegin() {}
+void scoreCaptureAppend(const ei_impulse_result_t*) {}
+bool scoreCaptureUpload() {
+    Serial.println("[SCORES] Disabled (SCORE_CAPTURE_SLICES is 0)");
+    return false;
+}
+
+#endif // SCORE_CAPTURE_SLICES > 0
+
+#endif // SCORE_CAPTURE_H
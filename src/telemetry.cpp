@@ -0,0 +1,80 @@
+/*
+ * Per-Turn Latency Telemetry for NOVA
+ * See telemetry.h
+ */
+
+#include "telemetry.h"
+
+TELEMETRY_ATTR static TelemetryRing telemetryRing;
+static TurnTelemetry currentTurn;
+static bool turnActive = false;
+
+void telemetryInit() {
+    if (telemetryRing.magic != TELEMETRY_MAGIC) {
+        memset(&telemetryRing, 0, sizeof(telemetryRing));
+        telemetryRing.magic = TELEMETRY_MAGIC;
+    }
+}
+
+void telemetryBeginTurn(TurnTrigger trigger) {
+    if (turnActive) return;
+    memset(&currentTurn, 0, sizeof(currentTurn));
+    currentTurn.version = TELEMETRY_VERSION;
+    currentTurn.trigger = trigger;
+    currentTurn.turnId = telemetryRing.nextTurnId++;
+    currentTurn.startedAt = millis();
+    turnActive = true;
+}
+
+TurnTelemetry* telemetryTurn() {
+    return turnActive ? &currentTurn : nullptr;
+}
+
+void telemetryCommitTurn() {
+    if (!turnActive) return;
+    telemetryRing.records[telemetryRing.head % TELEMETRY_RING_SIZE] = currentTurn;
+    telemetryRing.head++;
+    // Oldest unsent records are overwritten once the ring wraps
+    if (telemetryRing.head - telemetryRing.sent > TELEMETRY_RING_SIZE) {
+        telemetryRing.sent = telemetryRing.head - TELEMETRY_RING_SIZE;
+    }
+    turnActive = false;
+}
+
+String telemetryPendingHex(uint32_t* count) {
+    static const char hex[] = "0123456789abcdef";
+    uint32_t pending = telemetryRing.head - telemetryRing.sent;
+    if (pending > TELEMETRY_MAX_PIGGYBACK) pending = TELEMETRY_MAX_PIGGYBACK;
+    *count = pending;
+
+    String out;
+    out.reserve(pending * sizeof(TurnTelemetry) * 2);
+    for (uint32_t r = 0; r < pending; r++) {
+        const uint8_t* bytes = (const uint8_t*)&telemetryRing.records[(telemetryRing.sent + r) % TELEMETRY_RING_SIZE];
+        for (size_t i = 0; i < sizeof(TurnTelemetry); i++) {
+            out += hex[bytes[i] >> 4];
+            out += hex[bytes[i] & 0x0F];
+        }
+    }
+    return out;
+}
+
+void telemetryMarkSent(uint32_t count) {
+    telemetryRing.sent += count;
+    if (telemetryRing.sent > telemetryRing.head) telemetryRing.sent = telemetryRing.head;
+}
+
+void telemetryPrint() {
+    uint32_t stored = telemetryRing.head < TELEMETRY_RING_SIZE ? telemetryRing.head : TELEMETRY_RING_SIZE;
+    Serial.printf("[TELEMETRY] %u turns recorded, %u stored, %u unsent\n",
+                  telemetryRing.head, stored, telemetryRing.head - telemetryRing.sent);
+    Serial.println("  turn trig flags rssi | wake  rec  bytes   conn  upld  ttfb  ttfa  play  undr");
+    for (uint32_t r = telemetryRing.head - stored; r < telemetryRing.head; r++) {
+        const TurnTelemetry& t = telemetryRing.records[r % TELEMETRY_RING_SIZE];
+        Serial.printf("  %4u %4u  0x%02x %4d | %4u %5u %6u %6u %5u %5u %5u %5u %5u\n",
+                      t.turnId, t.trigger, t.flags, t.rssi,
+                      t.wakeDetectMs, t.recordMs, t.trimmedBytes,
+                      t.connectMs, t.uploadMs, t.firstByteMs, t.firstAudioMs,
+                      t.playbackMs, t.underruns);
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Per-Turn Latency Telemetry for NOVA
+ * One fixed 32-byte record per voice turn, kept in a RAM ring (optionally RTC
+ * memory so it survives deep sleep) and piggybacked on the next backend request
+ *
+ * Wire format (little-endian, must match backend TELEMETRY_FORMAT):
+ *   version, trigger, flags, rssi, turnId, startedAt,
+ *   wakeDetectMs, recordMs, trimmedBytes, connectMs, uploadMs,
+ *   firstByteMs, firstAudioMs, playbackMs, underruns
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_MAGIC         0x4E4F5641  // "NOVA"
+#define TELEMETRY_MAX_PIGGYBACK 8           // Records per request header
+
+// Keep the ring in RTC slow memory so deep sleep doesn't lose it
+#ifndef TELEMETRY_USE_RTC
+#define TELEMETRY_USE_RTC       true
+#endif
+
+#if TELEMETRY_USE_RTC
+#define TELEMETRY_RING_SIZE     32          // 1KB of the 8KB RTC slow memory
+#define TELEMETRY_ATTR          RTC_DATA_ATTR
+#else
+#define TELEMETRY_RING_SIZE     64
+#define TELEMETRY_ATTR
+#endif
+
+// What started the turn
+enum TurnTrigger : uint8_t {
+    TURN_WAKE_WORD = 1,
+    TURN_BUTTON    = 2,
+    TURN_TEXT      = 3
+};
+
+// Turn outcome bits
+#define TURN_FLAG_CONNECT_FAILED  0x01
+#define TURN_FLAG_TIMEOUT         0x02
+#define TURN_FLAG_BAD_RESPONSE    0x04
+#define TURN_FLAG_STREAMED        0x08
+#define TURN_FLAG_NO_AUDIO        0x10
+#define TURN_FLAG_WAKE_REJECTED   0x20  // Backend's wake word check said no
+#define TURN_FLAG_BARGED_IN       0x40  // Reply cut short by a wake word
+#define TURN_FLAG_UPLOAD_FAILED   0x80  // Request body not fully sent
+
+struct __attribute__((packed)) TurnTelemetry {
+    uint8_t  version;
+    uint8_t  trigger;
+    uint8_t  flags;
+    int8_t   rssi;          // dBm at request time
+    uint32_t turnId;
+    uint32_t startedAt;     // millis() when the turn began
+    uint16_t wakeDetectMs;  // DSP + NN time of the triggering slice
+    uint16_t recordMs;
+    uint32_t trimmedBytes;  // Bytes uploaded after silence trimming
+    uint16_t connectMs;
+    uint16_t uploadMs;
+    uint16_t firstByteMs;   // Request sent -> first response byte
+    uint16_t firstAudioMs;  // Request sent -> first I2S write
+    uint16_t playbackMs;
+    uint16_t underruns;     // Times the speaker DMA ran dry mid-reply
+};
+
+static_assert(sizeof(TurnTelemetry) == 32, "TurnTelemetry wire format is 32 bytes");
+
+struct TelemetryRing {
+    uint32_t magic;
+    uint32_t nextTurnId;
+    uint32_t head;          // Total records ever written
+    uint32_t sent;          // Records acknowledged by the backend
+    TurnTelemetry records[TELEMETRY_RING_SIZE];
+};
+
+static inline uint16_t telemetryClampMs(unsigned long ms) {
+    return ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+}
+
+void telemetryInit();
+
+/**
+ * @brief Start a new turn record. A turn already in progress is kept (e.g. a
+ * wake word turn that falls through to recordAudio() and sendAudioRequest()).
+ */
+void telemetryBeginTurn(TurnTrigger trigger);
+
+/**
+ * @brief The turn being recorded, nullptr between turns
+ */
+TurnTelemetry* telemetryTurn();
+
+void telemetryCommitTurn();
+
+/**
+ * @brief Hex-encode up to TELEMETRY_MAX_PIGGYBACK unsent records for a header
+ * @param count Set to the number of records encoded, pass to telemetryMarkSent()
+ */
+String telemetryPendingHex(uint32_t* count);
+
+void telemetryMarkSent(uint32_t count);
+
+void telemetryPrint();
+
+#endif // TELEMETRY_H
@@ -0,0 +1,96 @@
+/*
+ * Wake Word Decision Logic for NOVA (per-window baseline)
+ * Turns per-slice classifier scores into wake events: one check per model
+ * window against a fixed threshold and gap. The firmware now uses WakeEngine
+ * (wake_engine.h); this is kept as the baseline tools/wake_eval compares to.
+ * Also home of WakeVerdict, shared by both.
+ *
+ * Plain C++ on purpose: no Arduino headers, time is passed in by the caller.
+ */
+
+#ifndef WAKE_DECISION_H
+#define WAKE_DECISION_H
+
+#include <stdint.h>
+
+struct WakeDecisionConfig {
+    float confidence;       // Minimum wake word score
+    float gap;              // Wake score must beat max(noise, unknown) by this much
+    uint32_t cooldownMs;    // No new trigger this soon after the last one
+    int consecutive;        // Passing windows needed in a row
+    int slicesPerWindow;    // Scores are only checked once per full model window
+};
+
+enum WakeVerdict {
+    WAKE_SKIPPED,           // Not a checking slice
+    WAKE_REJECTED,          // Checked, criteria not met
+    WAKE_CANDIDATE,         // Criteria met, waiting for more consecutive windows
+    WAKE_DETECTED
+};
+
+class WakeDecision {
+public:
+    explicit WakeDecision(const WakeDecisionConfig& config) : _config(config) {
+        reset();
+    }
+
+    /**
+     * @brief Start over after a turn: wait for one full window of fresh audio
+     */
+    void reset() {
+        _sliceCounter = -_config.slicesPerWindow;
+        _consecutive = 0;
+    }
+
+    void clearStreak() {
+        _consecutive = 0;
+    }
+
+    /**
+     * @brief Feed the scores of one classified slice
+     * @param nowMs Monotonic milliseconds (millis() on the device)
+     */
+    WakeVerdict update(float wakeScore, float noiseScore, float unknownScore, uint32_t nowMs) {
+        if (++_sliceCounter < _config.slicesPerWindow) {
+            return WAKE_SKIPPED;
+        }
+        _sliceCounter = 0;
+
+        float maxOtherScore = noiseScore > unknownScore ? noiseScore : unknownScore;
+        bool cooldownPassed = (nowMs - _lastTriggerMs > _config.cooldownMs);
+
+        bool passed = (wakeScore >= _config.confidence) &&
+                      (wakeScore > maxOtherScore + _config.gap) &&
+                      cooldownPassed;
+
+        if (!passed) {
+            _consecutive = 0;
+            return WAKE_REJECTED;
+        }
+
+        if (++_consecutive < _config.consecutive) {
+            return WAKE_CANDIDATE;
+        }
+
+        _lastTriggerMs = nowMs;
+        _consecutive = 0;
+        _sliceCounter = -_config.slicesPerWindow;
+        return WAKE_DETECTED;
+    }
+
+    int consecutive() const {
+        return _consecutive;
+    }
+
+    const WakeDecisionConfig& config() const {
+        return _config;
+    }
+
+private:
+    WakeDecisionConfig _config;
+    int _sliceCounter;
+    int _consecutive;
+    uint32_t _lastTriggerMs = 0;
+};
+
+#endif // WAKE_DECISION_H
@@ -0,0 +1,160 @@
+/*
+ * Streaming Wake Word Engine for NOVA
+ * Per-slice scores go through the SDK's PerfCal (running average over a
+ * configurable window, threshold on the averaged wake score, suppression
+ * after a trigger). Shared by the firmware and tools/wake_eval.
+ *
+ * Everything is resolved and allocated in begin(); update() only touches
+ * preallocated arrays, once per 250ms slice.
+ *
+ * Compared to WakeDecision (wake_decision.h) there is no separate gap: the
+ * classifier's scores sum to 1, so an averaged wake score of t already beats
+ * every other label by at least 2t - 1.
+ */
+
+#ifndef WAKE_ENGINE_H
+#define WAKE_ENGINE_H
+
+#include <stdint.h>
+#include <string.h>
+#include "edge-impulse-sdk/classifier/postprocessing/ei_performance_calibration.h"
+#include "wake_decision.h"
+
+struct WakeEngineConfig {
+    const char* wakeLabel;
+    float threshold;            // Averaged wake score needed to trigger
+    uint32_t averageWindowMs;   // Scores are averaged over this long
+    uint32_t suppressionMs;     // No new trigger this soon after the last one
+    int warmupSlices;           // Slices ignored after reset(): the feature window still holds old audio
+};
+
+class WakeEngine {
+public:
+    WakeEngine() = default;
+    ~WakeEngine() {
+        delete _perfCal;
+    }
+
+    // Owns its PerfCal: a copy would delete it twice
+    WakeEngine(const WakeEngine&) = delete;
+    WakeEngine& operator=(const WakeEngine&) = delete;
+
+    /**
+     * @brief Resolve labels and allocate the averaging window
+     * @return false if the model has no such label or the threshold is unusable;
+     * the engine then stays unusable (ready() is false) until a begin() succeeds
+     */
+    bool begin(const ei_impulse_t* impulse, const WakeEngineConfig& config) {
+        delete _perfCal;
+        _perfCal = nullptr;
+        _config = config;
+        _labelCount = impulse->label_count < EI_CLASSIFIER_LABEL_COUNT ? impulse->label_count : EI_CLASSIFIER_LABEL_COUNT;
+        _wakeIx = -1;
+        for (uint16_t i = 0; i < _labelCount; i++) {
+            _scores[i].label = impulse->categories[i];
+            _scores[i].value = 0.0f;
+            if (strcmp(impulse->categories[i], config.wakeLabel) == 0) _wakeIx = i;
+        }
+        if (_wakeIx < 0) return false;
+
+        // Only the wake label may trigger (and start suppression)
+        ei_performance_calibration_config_t perfCalConfig = {
+            1,                          // implementation_version
+            true,                       // is_configured
+            config.averageWindowMs,
+            config.threshold,
+            config.suppressionMs,
+            1u << _wakeIx
+        };
+        _perfCal = new PerfCal(&perfCalConfig, _labelCount, impulse->slice_size, impulse->interval_ms);
+
+        // PerfCal only reports a rejected threshold (one several labels could
+        // reach at once) or a failed allocation through trigger()
+        ei_impulse_result_classification_t probe[EI_CLASSIFIER_LABEL_COUNT] = {};
+        if (_perfCal->trigger(probe) == EI_PC_RET_MEMORY_ERROR) {
+            delete _perfCal;
+            _perfCal = nullptr;
+            return false;
+        }
+        reset();
+        return true;
+    }
+
+    /**
+     * @brief Start over after a turn. The averaging window starts out as all
+     * zeros, so one loud slice right after the warm-up can't trigger alone.
+     */
+    void reset() {
+        if (_perfCal) _perfCal->reset(true);
+        _warmup = _config.warmupSlices;
+        _averagedWake = 0.0f;
+    }
+
+    /**
+     * @brief Feed one slice's scores, in model label order
+     */
+    WakeVerdict update(const float* scores) {
+        if (!_perfCal) return WAKE_SKIPPED;
+        if (_warmup > 0) {
+            _warmup--;
+            return WAKE_SKIPPED;
+        }
+
+        // PerfCal replaces the values with their running averages
+        for (uint16_t i = 0; i < _labelCount; i++) {
+            _scores[i].value = scores[i];
+        }
+        int32_t event = _perfCal->trigger(_scores);
+        _averagedWake = _scores[_wakeIx].value;
+        return event == _wakeIx ? WAKE_DETECTED : WAKE_REJECTED;
+    }
+
+    WakeVerdict update(const ei_impulse_result_t* result) {
+        float scores[EI_CLASSIFIER_LABEL_COUNT];
+        for (uint16_t i = 0; i < _labelCount; i++) {
+            scores[i] = result->classification[i].value;
+        }
+        return update(scores);
+    }
+
+    /**
+     * @brief Averaged score of label `ix` after the last update()
+     */
+    float averaged(int ix) const {
+        return _scores[ix].value;
+    }
+
+    float averagedWake() const {
+        return _averagedWake;
+    }
+
+    /**
+     * @brief begin() succeeded: update() decides and wakeIndex() is a valid label
+     */
+    bool ready() const {
+        return _perfCal != nullptr;
+    }
+
+    int wakeIndex() const {
+        return _wakeIx;
+    }
+
+    uint32_t averageSlices() const {
+        return _perfCal ? _perfCal->average_window_samples() : 0;
+    }
+
+    const WakeEngineConfig& config() const {
+        return _config;
+    }
+
+private:
+    WakeEngineConfig _config = {};
+    PerfCal* _perfCal = nullptr;
+    ei_impulse_result_classification_t _scores[EI_CLASSIFIER_LABEL_COUNT];
+    uint16_t _labelCount = 0;
+    int _wakeIx = -1;
+    int _warmup = 0;
+    float _averagedWake = 0.0f;
+};
+
+#endif // WAKE_ENGINE_H
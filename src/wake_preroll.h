@@ -0,0 +1,98 @@
+/*
+ * Wake Word Pre-roll for NOVA
+ * The last WAKE_PREROLL_MS of mic samples the wake word engine classified,
+ * before the 8x gain, kept in a PSRAM ring. A wake word turn uploads them
+ * ahead of the recording (X-Wake-Preroll header) so the backend can run its
+ * own check of the wake word (tools/wake_verify) before paying for STT.
+ *
+ * The ring stops moving while a turn records, since detectWakeWord() is
+ * skipped then, so after a trigger it holds exactly the audio that fired.
+ * While a reply plays, barge-in fills it with the echo-cancelled mic instead.
+ */
+
+#ifndef WAKE_PREROLL_H
+#define WAKE_PREROLL_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "config.h"
+#include "memory_pool.h"
+
+#if WAKE_PREROLL_MS > 0
+
+static int16_t* prerollRing = nullptr;
+static size_t prerollCapacity = 0;
+static size_t prerollHead = 0;      // Next write position
+static size_t prerollCount = 0;
+
+/**
+ * @brief Claim the ring pool. Call after memoryPoolsBegin().
+ */
+void wakePrerollBegin() {
+    prerollRing = (int16_t*)memoryPoolCheckout(POOL_WAKE_PREROLL);
+    if (!prerollRing) return;
+    prerollCapacity = memoryPoolSize(POOL_WAKE_PREROLL) / sizeof(int16_t);
+    Serial.printf("[WAKE] Keeping %u ms of pre-roll\n", (unsigned)(prerollCapacity * 1000 / SAMPLE_RATE));
+}
+
+/**
+ * @brief Record one raw mic sample, as handed to the classifier
+ */
+inline void wakePrerollPush(int16_t sample) {
+    if (!prerollRing) return;
+    prerollRing[prerollHead] = sample;
+    if (++prerollHead == prerollCapacity) prerollHead = 0;
+    if (prerollCount < prerollCapacity) prerollCount++;
+}
+
+/**
+ * @brief Forget everything, e.g. after a turn: older audio didn't fire the wake word
+ */
+void wakePrerollReset() {
+    prerollHead = 0;
+    prerollCount = 0;
+}
+
+size_t wakePrerollSamples() {
+    return prerollCount;
+}
+
+static size_t wakePrerollWriteAll(WiFiClient& client, const int16_t* samples, size_t count) {
+    const uint8_t* data = (const uint8_t*)samples;
+    size_t size = count * sizeof(int16_t);
+    size_t written = 0;
+    // WiFiClient accepts partial writes under memory pressure
+    while (written < size) {
+        size_t n = client.write(data + written, size - written);
+        if (n == 0) break;
+        written += n;
+    }
+    return written;
+}
+
+/**
+ * @brief Send the ring oldest sample first, wakePrerollSamples() * 2 bytes
+ * @return Bytes written
+ */
+size_t wakePrerollWrite(WiFiClient& client) {
+    if (prerollCount == 0) return 0;
+    size_t start = (prerollHead + prerollCapacity - prerollCount) % prerollCapacity;
+    size_t first = min(prerollCount, prerollCapacity - start);
+    size_t written = wakePrerollWriteAll(client, prerollRing + start, first);
+    if (first < prerollCount && written == first * sizeof(int16_t)) {
+        written += wakePrerollWriteAll(client, prerollRing, prerollCount - first);
+    }
+    return written;
+}
+
+#else
+
+void wakePrerollBegin() {}
+inline void wakePrerollPush(int16_t) {}
+void wakePrerollReset() {}
+size_t wakePrerollSamples() { return 0; }
+size_t wakePrerollWrite(WiFiClient&) { return 0; }
+
+#endif // WAKE_PREROLL_MS > 0
+
+#endif // WAKE_PREROLL_H
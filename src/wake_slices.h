@@ -0,0 +1,108 @@
+/*
+ * Wake Word Slices for NOVA
+ * Double buffer between the mic and run_classifier_continuous(): the mic side
+ * fills one slice while the other, once full, waits to be classified.
+ *
+ * Normally both sides run on the loop core in turn. During barge-in the mic
+ * side is a task on core 0 and the classifier stays on the loop core, and the
+ * ready flag is all they share: the filler switches buffers only while it is
+ * clear, the classifier reads the ready slice only while it is set.
+ *
+ * A slice that fills while the last one is still unclassified waits, full,
+ * and goes out as soon as the classifier releases the other. Until then
+ * fill() takes nothing, and the caller counts what it had to drop.
+ *
+ * Plain C++ on purpose: no Arduino headers, the buffers come from the caller.
+ */
+
+#ifndef WAKE_SLICES_H
+#define WAKE_SLICES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class WakeSlices {
+public:
+    /**
+     * @brief Use two caller-owned buffers of sliceSamples each
+     */
+    void begin(int16_t* first, int16_t* second, uint32_t sliceSamples) {
+        _buffers[0] = first;
+        _buffers[1] = second;
+        _sliceSamples = sliceSamples;
+        reset();
+    }
+
+    /**
+     * @brief Drop the partial slice and any unclassified one. Not while the
+     * other side is running.
+     */
+    void reset() {
+        _select = 0;
+        _count = 0;
+        _ready = 0;
+    }
+
+    /**
+     * @brief Samples the current slice still takes, 0 while a full one waits
+     */
+    size_t space() const {
+        return _count < _sliceSamples ? _sliceSamples - _count : 0;
+    }
+
+    /**
+     * @brief Mic side: append samples to the current slice
+     * @return Samples taken, less than count when the slice filled up
+     */
+    size_t fill(const int16_t* samples, size_t count) {
+        if (_count >= _sliceSamples) {
+            if (_ready) return 0;
+            publish();  // The last slice was classified, the one waiting is next
+        }
+        size_t used = count < space() ? count : space();
+        memcpy(&_buffers[_select][_count], samples, used * sizeof(int16_t));
+        _count += used;
+        if (_count >= _sliceSamples && !_ready) {
+            publish();
+        }
+        return used;
+    }
+
+    /**
+     * @brief Classifier side: a full slice is waiting
+     */
+    bool ready() const {
+        return _ready != 0;
+    }
+
+    /**
+     * @brief Classifier side: the waiting slice, valid until release()
+     */
+    const int16_t* slice() const {
+        return _buffers[_select ^ 1];
+    }
+
+    /**
+     * @brief Classifier side: done with the slice, the filler may switch again
+     */
+    void release() {
+        _ready = 0;
+    }
+
+private:
+    // The buffer switch is visible before the flag that hands it over
+    void publish() {
+        _select ^= 1;
+        _count = 0;
+        _ready = 1;
+    }
+
+    int16_t* _buffers[2] = { nullptr, nullptr };
+    volatile uint8_t _select = 0;   // Buffer being filled
+    volatile uint8_t _ready = 0;    // The other buffer holds a full slice
+    uint32_t _count = 0;            // Mic side only
+    uint32_t _sliceSamples = 0;
+};
+
+#endif // WAKE_SLICES_H
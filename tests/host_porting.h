@@ -0,0 +1,58 @@
+/*
+ * Edge Impulse porting functions for the host tests, as in the tools' Host
+ * Porting blocks. Include it from the test's one translation unit.
+ * hostAllocations counts ei_malloc() and ei_calloc() calls, for tests of code
+ * that shouldn't allocate. hostMallocFill >= 0 fills every ei_malloc() block
+ * with that byte, for tests of code that mustn't read memory it didn't set.
+ */
+
+#ifndef NOVA_HOST_PORTING_H
+#define NOVA_HOST_PORTING_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+static std::atomic<size_t> hostAllocations(0);
+static std::atomic<int> hostMallocFill(-1);
+static const auto hostStartTime = std::chrono::steady_clock::now();
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - hostStartTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStartTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) {
+    hostAllocations++;
+    void *ptr = malloc(size);
+    if (ptr && hostMallocFill >= 0) memset(ptr, hostMallocFill, size);
+    return ptr;
+}
+void *ei_calloc(size_t nitems, size_t size) {
+    hostAllocations++;
+    return calloc(nitems, size);
+}
+void ei_free(void *ptr) { free(ptr); }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+#endif // NOVA_HOST_PORTING_H
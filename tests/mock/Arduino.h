@@ -0,0 +1,26 @@
+/*
+ * Host mock of the Arduino core, as much of it as the firmware sources the
+ * tests build use: Serial.printf() goes to stdout.
+ */
+
+#ifndef MOCK_ARDUINO_H
+#define MOCK_ARDUINO_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+struct MockSerial {
+    int printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        int n = vprintf(format, args);
+        va_end(args);
+        return n;
+    }
+};
+
+inline MockSerial Serial;
+
+#endif // MOCK_ARDUINO_H
@@ -0,0 +1,65 @@
+/*
+ * Host mock of ESP-IDF's esp_heap_caps.h: an internal and a PSRAM region with
+ * a byte budget each. mockHeap counts what was asked of which region, for
+ * tests of placement policies. The heap_caps_get_* queries report the budgets.
+ */
+
+#ifndef MOCK_ESP_HEAP_CAPS_H
+#define MOCK_ESP_HEAP_CAPS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+
+struct MockHeapRegion {
+    size_t total;
+    size_t available;       // Bytes left; an allocation over it fails
+    size_t minimum;         // Lowest available has been
+    uint32_t requests;
+    uint32_t failures;
+};
+
+struct MockHeap {
+    MockHeapRegion internal;
+    MockHeapRegion spiram;
+    uint32_t misaligned;    // Requests for an alignment that isn't a power of two
+
+    void reset(size_t internalBytes, size_t spiramBytes) {
+        *this = MockHeap();
+        internal.total = internal.available = internal.minimum = internalBytes;
+        spiram.total = spiram.available = spiram.minimum = spiramBytes;
+    }
+};
+
+inline MockHeap mockHeap;
+
+inline MockHeapRegion& mockHeapRegion(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? mockHeap.spiram : mockHeap.internal;
+}
+
+inline void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        mockHeap.misaligned++;
+        return nullptr;
+    }
+    MockHeapRegion& region = mockHeapRegion(caps);
+    region.requests++;
+    if (size > region.available) {
+        region.failures++;
+        return nullptr;
+    }
+    region.available -= size;
+    if (region.available < region.minimum) region.minimum = region.available;
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+inline size_t heap_caps_get_total_size(uint32_t caps) { return mockHeapRegion(caps).total; }
+inline size_t heap_caps_get_free_size(uint32_t caps) { return mockHeapRegion(caps).available; }
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) { return mockHeapRegion(caps).available; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) { return mockHeapRegion(caps).minimum; }
+
+#endif // MOCK_ESP_HEAP_CAPS_H
@@ -0,0 +1,17 @@
+/*
+ * Host mock of ESP-IDF's esp_idf_version.h: IDF 4.4, as Arduino-ESP32 2.x
+ * builds. Define MOCK_IDF_VERSION_MAJOR/MINOR to pretend otherwise.
+ */
+
+#ifndef MOCK_ESP_IDF_VERSION_H
+#define MOCK_ESP_IDF_VERSION_H
+
+#ifndef MOCK_IDF_VERSION_MAJOR
+#define MOCK_IDF_VERSION_MAJOR  4
+#define MOCK_IDF_VERSION_MINOR  4
+#endif
+
+#define ESP_IDF_VERSION_VAL(major, minor, patch) (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_IDF_VERSION ESP_IDF_VERSION_VAL(MOCK_IDF_VERSION_MAJOR, MOCK_IDF_VERSION_MINOR, 0)
+
+#endif // MOCK_ESP_IDF_VERSION_H
@@ -0,0 +1,14 @@
+/*
+ * Host mock of FreeRTOS.h: what the Edge Impulse Espressif port uses
+ */
+
+#ifndef MOCK_FREERTOS_H
+#define MOCK_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+#define portTICK_PERIOD_MS  1
+#define portTICK_RATE_MS    portTICK_PERIOD_MS
+
+#endif // MOCK_FREERTOS_H
@@ -0,0 +1,16 @@
+/*
+ * Host mock of FreeRTOS task.h
+ */
+
+#ifndef MOCK_FREERTOS_TASK_H
+#define MOCK_FREERTOS_TASK_H
+
+#include <chrono>
+#include <thread>
+#include "FreeRTOS.h"
+
+inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+#endif // MOCK_FREERTOS_TASK_H
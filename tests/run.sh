@@ -0,0 +1,97 @@
+#!/bin/sh
+# Build and run the host tests, then check that the host tools still build.
+# Everything of ours builds with -Wall -Wextra -Werror (tools/host_build.sh);
+# the Edge Impulse files we added to the vendored library are held to the same
+# warnings, though the rest of it is not.
+#
+# Usage:  tests/run.sh [test_name ...]      (all of tests/test_*.cpp by default)
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+. "$ROOT/tools/host_build.sh"
+OUT="$ROOT/tests/build"
+
+# Our additions to lib/test-new_inferencing/src
+SDK_OWN="edge-impulse-sdk/classifier/ei_arena_report.h
+edge-impulse-sdk/classifier/ei_run_classifier_batch.h
+edge-impulse-sdk/classifier/ei_score_cache.h
+edge-impulse-sdk/dsp/dsp_engines/ei_fixed_point_fft.h
+edge-impulse-sdk/dsp/ei_fast_math.h
+edge-impulse-sdk/dsp/scratch.hpp
+edge-impulse-sdk/dsp/speechpy/mfcc_fixed.hpp
+edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h
+edge-impulse-sdk/tensorflow/lite/micro/kernels/conv_max_pool.cpp
+tflite-model/tflite_learn_855743_3_fused.h
+tflite-model/tflite_learn_855743_3_prepacked.h"
+
+if [ $# -gt 0 ]; then
+    TESTS="$*"
+else
+    TESTS=$(cd "$ROOT/tests" && ls test_*.cpp 2>/dev/null | sed 's/\.cpp$//')
+fi
+
+sdk_objects
+mkdir -p "$OUT"
+failed=0
+for t in $TESTS; do
+    $CXX -std=gnu++17 $HOST_FLAGS -I"$ROOT/tests" -I"$ROOT/tests/mock" "$ROOT/tests/$t.cpp" "$SDK_OBJ/libsdk.a" -lpthread -o "$OUT/$t"
+    "$OUT/$t" || failed=$((failed + 1))
+done
+
+# The pools also fit the budget as the esp32s3-barge-in env (platformio.ini)
+# builds the firmware, barge-in being compiled out of the default one
+if echo " $TESTS " | grep -q " test_memory_pool "; then
+    BARGE_IN=$(grep -o -- '-DECHO_REFERENCE_MS=[0-9]*' "$ROOT/platformio.ini")
+    $CXX -std=gnu++17 $HOST_FLAGS $BARGE_IN -I"$ROOT/tests" -I"$ROOT/tests/mock" "$ROOT/tests/test_memory_pool.cpp" \
+        "$SDK_OBJ/libsdk.a" -lpthread -o "$OUT/test_memory_pool_barge_in"
+    echo "($BARGE_IN)"
+    "$OUT/test_memory_pool_barge_in" || failed=$((failed + 1))
+fi
+
+# Our SDK files, through the sources that include them, as non-system headers
+LINT_FLAGS=$(echo "$HOST_FLAGS" | sed 's/-isystem /-I/g; s/-Werror//')
+printf '%s\n' "$SDK_OWN" | sed 's|^.*/|/|; s|$|:|' > "$OUT/sdk_own.txt"
+for src in $(cd "$ROOT" && ls tests/test_*.cpp 2>/dev/null) \
+           "$LIB/edge-impulse-sdk/tensorflow/lite/micro/kernels/conv.cpp" \
+           "$LIB/edge-impulse-sdk/tensorflow/lite/micro/kernels/conv_max_pool.cpp" \
+           "$LIB/edge-impulse-sdk/tensorflow/lite/micro/kernels/fully_connected.cpp" \
+           $(ls "$LIB"/tflite-model/*_compiled.cpp); do
+    case "$src" in /*) ;; *) src="$ROOT/$src" ;; esac
+    $CXX -std=gnu++17 $LINT_FLAGS -I"$ROOT/tests" -I"$ROOT/tests/mock" -fsyntax-only "$src" 2>&1 |
+        grep -F -f "$OUT/sdk_own.txt" | grep 'warning:' || true
+done | sort -u > "$OUT/lint.txt"
+if [ -s "$OUT/lint.txt" ]; then
+    cat "$OUT/lint.txt"
+    echo "Warnings in our SDK files"
+    failed=$((failed + 1))
+fi
+
+# The compiled model's hooks are what tools/eon_hooks inserts, not hand edits,
+# and a fused graph or prepacked filters made from another export of the model
+# don't build
+for model in "$LIB"/tflite-model/*_compiled.cpp; do
+    python3 "$ROOT/tools/eon_hooks/eon_hooks.py" --check "$model" || failed=$((failed + 1))
+    for kind in fused:Fused prepacked:Prepacked; do
+        header="${model%_compiled.cpp}_${kind%%:*}.h"
+        [ -f "$header" ] || continue
+        rm -rf "$OUT/stale"
+        mkdir -p "$OUT/stale/tflite-model"
+        sed "s/k${kind#*:}ModelChecksum = .*;/k${kind#*:}ModelChecksum = kEonModelChecksum + 1;/" "$header" \
+            > "$OUT/stale/tflite-model/$(basename "$header")"
+        if $CXX -std=gnu++17 -I"$OUT/stale" $SDK_FLAGS -fsyntax-only "$model" 2>&1 |
+               grep -q "$(basename "$header") was made from another export"; then :; else
+            echo "$(basename "$model") builds with a ${kind%%:*} header from another export"
+            failed=$((failed + 1))
+        fi
+    done
+done
+
+for tool in wake_eval wake_verify ns_eval aec_sim agc_eval batch_bench arena_report; do
+    sh "$ROOT/tools/$tool/build.sh" > /dev/null
+done
+
+if [ $failed -gt 0 ]; then
+    echo "$failed failed"
+    exit 1
+fi
+echo "All passed"
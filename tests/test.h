@@ -0,0 +1,67 @@
+/*
+ * Host test helpers for NOVA
+ * Each tests/test_<module>.cpp is a program of its own: CHECK() what must hold,
+ * BENCH() what is worth tracking, and return testResult() from main(). Built
+ * and run by tests/run.sh.
+ */
+
+#ifndef NOVA_TEST_H
+#define NOVA_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+
+static int testFailures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        testFailures++; \
+        fprintf(stderr, "%s:%d: FAIL %s: ", __FILE__, __LINE__, #cond); \
+        fprintf(stderr, __VA_ARGS__); \
+        fputc('\n', stderr); \
+    } \
+} while (0)
+
+static inline double testSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs body for at least minSeconds; the mean time of one run, in microseconds
+template <typename Body>
+static double benchUs(Body body, double minSeconds = 0.2) {
+    body();     // Warm up
+    uint32_t runs = 0;
+    double start = testSeconds(), elapsed;
+    do {
+        body();
+        runs++;
+        elapsed = testSeconds() - start;
+    } while (elapsed < minSeconds);
+    return elapsed * 1e6 / runs;
+}
+
+// The fastest of runs benchUs() measurements. Steadier than one long mean on a
+// shared host, for comparisons a test CHECKs
+template <typename Body>
+static double benchBestUs(Body body, int runs = 15, double minSeconds = 0.02) {
+    double best = benchUs(body, minSeconds);
+    for (int r = 1; r < runs; r++) {
+        double us = benchUs(body, minSeconds);
+        if (us < best) best = us;
+    }
+    return best;
+}
+
+#define BENCH(name, ...) printf("  bench %-40s %10.2f us\n", name, benchUs(__VA_ARGS__))
+
+static inline int testResult(const char* name) {
+    if (testFailures) {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, testFailures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+#endif // NOVA_TEST_H
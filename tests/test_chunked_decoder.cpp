@@ -0,0 +1,192 @@
+/*
+ * ChunkedDecoder (src/chunked_decoder.h) fed as playStream() feeds it: whatever
+ * each client.read() returned, decoded in place
+ *
+ *   splits      every way to cut a body in two, and byte by byte: size lines,
+ *               extensions and CRLFs split across reads decode the same
+ *   hex         upper, lower and mixed case sizes, leading zeros
+ *   extensions  ";name=value" and whitespace after the size are skipped
+ *   trailers    a 0-size chunk, then trailer fields up to the empty line;
+ *               nothing after it is payload
+ *   malformed   bad digits, empty size lines, a missing CRLF after the data
+ *               and sizes over 32 bits fail, and stay failed
+ *   random      random payloads in random chunks, read in random sizes
+ */
+
+#include "chunked_decoder.h"
+#include "test.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+struct Decoded {
+    std::string payload;
+    bool done = false;
+    bool failed = false;
+};
+
+// Feeds body in reads of the given sizes (the rest in one read), each in its own buffer
+static Decoded decode(const std::string& body, const std::vector<size_t>& reads) {
+    ChunkedDecoder decoder;
+    Decoded d;
+    size_t pos = 0;
+    for (size_t r = 0; pos < body.size(); r++) {
+        size_t len = r < reads.size() ? reads[r] : body.size() - pos;
+        if (len > body.size() - pos) len = body.size() - pos;
+        std::vector<uint8_t> buf(body.begin() + pos, body.begin() + pos + len);
+        size_t out = decoder.decode(buf.data(), buf.size());
+        CHECK(out <= len, "%zu payload bytes out of a %zu byte read", out, len);
+        d.payload.append((const char*)buf.data(), out);
+        pos += len;
+    }
+    d.done = decoder.done();
+    d.failed = decoder.failed();
+    return d;
+}
+
+static Decoded decodeWhole(const std::string& body) {
+    return decode(body, {});
+}
+
+static Decoded decodeBytewise(const std::string& body) {
+    return decode(body, std::vector<size_t>(body.size(), 1));
+}
+
+static void expectPayload(const char* name, const std::string& body, const std::string& payload) {
+    Decoded d = decodeWhole(body);
+    CHECK(d.done && !d.failed, "%s: done %d failed %d", name, d.done, d.failed);
+    CHECK(d.payload == payload, "%s: \"%s\"", name, d.payload.c_str());
+    d = decodeBytewise(body);
+    CHECK(d.done && d.payload == payload, "%s, byte by byte: done %d, \"%s\"", name, d.done, d.payload.c_str());
+}
+
+static void expectFailure(const char* name, const std::string& body) {
+    Decoded d = decodeWhole(body);
+    CHECK(d.failed && !d.done, "%s: not rejected", name);
+    d = decodeBytewise(body);
+    CHECK(d.failed && !d.done, "%s, byte by byte: not rejected", name);
+}
+
+static void checkSplits() {
+    const std::string body = "5;ext=1\r\nhello\r\n1A\r\nabcdefghijklmnopqrstuvwxyz\r\n0\r\nX-Tail: 1\r\n\r\n";
+    const std::string payload = "helloabcdefghijklmnopqrstuvwxyz";
+    size_t bad = 0;
+    for (size_t cut = 1; cut < body.size(); cut++) {
+        Decoded d = decode(body, { cut });
+        if (!d.done || d.payload != payload) {
+            if (bad++ == 0) fprintf(stderr, "cut at %zu: done %d, \"%s\"\n", cut, d.done, d.payload.c_str());
+        }
+    }
+    CHECK(bad == 0, "%zu of %zu cuts decoded wrong", bad, body.size() - 1);
+
+    // Every pair of cuts, so a CRLF can start one read and end the next
+    bad = 0;
+    for (size_t a = 1; a < body.size(); a++) {
+        for (size_t b = 1; a + b < body.size(); b++) {
+            Decoded d = decode(body, { a, b });
+            bad += !d.done || d.payload != payload;
+        }
+    }
+    CHECK(bad == 0, "%zu cut pairs decoded wrong", bad);
+    expectPayload("splits", body, payload);
+}
+
+static void checkHex() {
+    expectPayload("lower", "a\r\n0123456789\r\n0\r\n\r\n", "0123456789");
+    expectPayload("upper", "A\r\n0123456789\r\n0\r\n\r\n", "0123456789");
+    std::string big(0x1fE, 'x');
+    expectPayload("mixed", "1fE\r\n" + big + "\r\n0\r\n\r\n", big);
+    expectPayload("leading zeros", "000000000000003\r\nabc\r\n00\r\n\r\n", "abc");
+    expectPayload("bare LF", "3\nabc\n0\n\n", "abc");
+}
+
+static void checkExtensions() {
+    expectPayload("extension", "3;name=value\r\nabc\r\n0\r\n\r\n", "abc");
+    expectPayload("extensions", "3;a=1;b=\"x y\"\r\nabc\r\n2;c\r\nde\r\n0;last\r\n\r\n", "abcde");
+    expectPayload("whitespace", "3 \r\nabc\r\n0\t;x\r\n\r\n", "abc");
+}
+
+static void checkTrailers() {
+    expectPayload("no trailers", "2\r\nok\r\n0\r\n\r\n", "ok");
+    expectPayload("trailers", "2\r\nok\r\n0\r\nX-Checksum: 1234\r\nX-Other: a\r\n\r\n", "ok");
+
+    // Whatever follows the end of the body is not payload
+    const std::string body = "2\r\nok\r\n0\r\nX-Checksum: 1234\r\n\r\n";
+    Decoded d = decodeWhole(body + "5\r\nextra\r\n");
+    CHECK(d.done && d.payload == "ok", "past the end: done %d, \"%s\"", d.done, d.payload.c_str());
+
+    // Not done until the empty line
+    d = decodeWhole("2\r\nok\r\n0\r\nX-Checksum: 1234\r\n");
+    CHECK(!d.done && !d.failed && d.payload == "ok", "done before the empty line");
+    d = decodeWhole("2\r\nok\r\n0\r\n");
+    CHECK(!d.done && !d.failed, "done before the empty line after the 0-size chunk");
+}
+
+static void checkMalformed() {
+    expectFailure("not hex", "g\r\nabc\r\n0\r\n\r\n");
+    expectFailure("sign", "-3\r\nabc\r\n0\r\n\r\n");
+    expectFailure("empty size line", "\r\nabc\r\n0\r\n\r\n");
+    expectFailure("extension without size", ";x\r\nabc\r\n0\r\n\r\n");
+    expectFailure("CR without LF", "3\rabc\r\n0\r\n\r\n");
+    expectFailure("data longer than its size", "3\r\nabcd\r\n0\r\n\r\n");
+    expectFailure("data without CRLF", "3\r\nabc3\r\ndef\r\n0\r\n\r\n");
+    expectFailure("bad trailer line end", "0\r\nX: 1\rX");
+    expectFailure("33 bits", "100000000\r\n");
+    expectFailure("64 bits", "FFFFFFFFFFFFFFFF\r\n");
+
+    // The largest size that fits is data, not an error
+    Decoded d = decodeWhole("FFFFFFFF\r\nabc");
+    CHECK(!d.failed && d.payload == "abc", "32 bit size: failed %d, \"%s\"", d.failed, d.payload.c_str());
+
+    // Payload before the error is kept, nothing after it
+    d = decodeWhole("3\r\nabc\r\nzz\r\n3\r\ndef\r\n0\r\n\r\n");
+    CHECK(d.failed && d.payload == "abc", "after an error: failed %d, \"%s\"", d.failed, d.payload.c_str());
+    ChunkedDecoder decoder;
+    uint8_t bad[] = "q\r\n";
+    decoder.decode(bad, 3);
+    uint8_t good[] = "3\r\nabc\r\n0\r\n\r\n";
+    CHECK(decoder.decode(good, sizeof(good) - 1) == 0 && decoder.failed(), "recovered from an error");
+    decoder.reset();
+    CHECK(decoder.decode(good, sizeof(good) - 1) == 3 && decoder.done(), "reset() didn't clear the error");
+}
+
+static void checkRandom() {
+    size_t bad = 0;
+    for (uint32_t seed = 0; seed < 500; seed++) {
+        std::mt19937 rng(seed);
+        std::string payload, body;
+        // TTS segments are a few KB; small chunks put more framing in each read
+        size_t chunks = std::uniform_int_distribution<size_t>(1, 20)(rng);
+        for (size_t c = 0; c < chunks; c++) {
+            size_t n = std::uniform_int_distribution<size_t>(1, seed % 2 ? 40 : 9000)(rng);
+            std::string data(n, '\0');
+            for (char& ch : data) ch = (char)rng();
+            char line[32];
+            snprintf(line, sizeof(line), rng() % 2 ? "%zx" : "%zX", n);
+            body += line;
+            if (rng() % 4 == 0) body += ";seg=" + std::to_string(c);
+            body += "\r\n" + data + "\r\n";
+            payload += data;
+        }
+        body += "0\r\n\r\n";
+
+        std::vector<size_t> reads;
+        std::uniform_int_distribution<size_t> readSize(1, seed % 3 ? 4096 : 7);
+        for (size_t pos = 0; pos < body.size(); pos += reads.back()) reads.push_back(readSize(rng));
+        Decoded d = decode(body, reads);
+        bad += !d.done || d.payload != payload;
+    }
+    CHECK(bad == 0, "%zu of 500 random bodies decoded wrong", bad);
+}
+
+int main() {
+    printf("test_chunked_decoder\n");
+    checkSplits();
+    checkHex();
+    checkExtensions();
+    checkTrailers();
+    checkMalformed();
+    checkRandom();
+    return testResult("test_chunked_decoder");
+}
@@ -0,0 +1,112 @@
+/*
+ * Continuous classification state per impulse handle (ei_continuous_state_t)
+ *
+ *   threads     N streams on N threads, each with its own handle, score bit for
+ *               bit what the same streams score one after the other
+ *   ownership   handles and their state can't be copied (a copy would free the
+ *               DSP frame and feature window twice), only moved; a stream
+ *               moved mid-way scores as if it hadn't been
+ *   shim        the old no-argument ei_dsp_clear_continuous_audio_state()
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "host_porting.h"
+#include "test.h"
+
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define STREAMS     6
+#define SLICES      40
+
+static_assert(!std::is_copy_constructible<ei_continuous_state_t>::value, "continuous state copies");
+static_assert(!std::is_copy_assignable<ei_continuous_state_t>::value, "continuous state copies");
+static_assert(std::is_move_constructible<ei_continuous_state_t>::value, "continuous state doesn't move");
+static_assert(!std::is_copy_constructible<ei_impulse_handle_t>::value, "impulse handle copies");
+static_assert(std::is_move_constructible<ei_impulse_handle_t>::value, "impulse handle doesn't move");
+
+// Noise with a tone burst now and then, different per stream
+static std::vector<int16_t> streamAudio(int stream) {
+    std::mt19937 rng(1000 + stream);
+    std::normal_distribution<float> noise(0.0f, 300.0f);
+    std::vector<int16_t> audio(SLICES * EI_CLASSIFIER_SLICE_SIZE);
+    for (size_t i = 0; i < audio.size(); i++) {
+        float v = noise(rng);
+        if ((i / 8000 + stream) % 3 == 0) v += 6000.0f * sinf(2.0f * (float)M_PI * (300.0f + 150.0f * stream) * i / 16000.0f);
+        audio[i] = (int16_t)fmaxf(-32768.0f, fminf(32767.0f, v));
+    }
+    return audio;
+}
+
+// Scores of every slice; moveAt moves the handle's continuous state out and back before that slice
+static std::vector<float> classify(const std::vector<int16_t>& audio, int moveAt = -1) {
+    ei_impulse_handle_t handle(ei_default_impulse.impulse);
+    const int16_t* slice = nullptr;
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = [&slice](size_t offset, size_t length, float* out) {
+        for (size_t i = 0; i < length; i++) out[i] = (float)slice[offset + i];
+        return 0;
+    };
+
+    std::vector<float> scores;
+    run_classifier_init(&handle);
+    for (int s = 0; s < SLICES; s++) {
+        if (s == moveAt) {
+            ei_continuous_state_t parked(std::move(handle.continuous_state));
+            handle.continuous_state = std::move(parked);
+        }
+        slice = &audio[s * EI_CLASSIFIER_SLICE_SIZE];
+        ei_impulse_result_t result = {};
+        if (run_classifier_continuous(&handle, &signal, &result, false) != EI_IMPULSE_OK) {
+            scores.clear();
+            break;
+        }
+        for (int l = 0; l < EI_CLASSIFIER_LABEL_COUNT; l++) scores.push_back(result.classification[l].value);
+    }
+    run_classifier_deinit(&handle);
+    return scores;
+}
+
+int main() {
+    printf("test_continuous_state\n");
+    std::vector<int16_t> audio[STREAMS];
+    std::vector<float> serial[STREAMS], parallel[STREAMS];
+    for (int i = 0; i < STREAMS; i++) audio[i] = streamAudio(i);
+
+    double start = testSeconds();
+    for (int i = 0; i < STREAMS; i++) {
+        serial[i] = classify(audio[i]);
+        CHECK(serial[i].size() == SLICES * EI_CLASSIFIER_LABEL_COUNT, "stream %d: classification failed", i);
+    }
+    double serialSeconds = testSeconds() - start;
+
+    start = testSeconds();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < STREAMS; i++) {
+        threads.emplace_back([i, &audio, &parallel]() { parallel[i] = classify(audio[i]); });
+    }
+    for (std::thread& t : threads) t.join();
+    double parallelSeconds = testSeconds() - start;
+
+    for (int i = 0; i < STREAMS; i++) {
+        CHECK(parallel[i] == serial[i], "stream %d scores differently on its own thread", i);
+    }
+    printf("  %d streams x %d slices: %.2f s one after the other, %.2f s on %d threads\n",
+           STREAMS, SLICES, serialSeconds, parallelSeconds, STREAMS);
+
+    // Scores vary, or the comparison above proves nothing
+    bool varies = false;
+    for (size_t k = EI_CLASSIFIER_LABEL_COUNT; k < serial[0].size(); k++) varies = varies || serial[0][k] != serial[0][0];
+    CHECK(varies, "every slice scores the same");
+
+    CHECK(classify(audio[1], SLICES / 2) == serial[1], "moving the state mid-stream changed the scores");
+
+    run_classifier_init();
+    CHECK(ei_dsp_clear_continuous_audio_state() == EIDSP_OK, "no-argument clear failed");
+    run_classifier_deinit();
+    return testResult("test_continuous_state");
+}
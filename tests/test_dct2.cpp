@@ -0,0 +1,115 @@
+/*
+ * The MFCC's DCT (numpy::dct2_truncated() with the basis of
+ * numpy::dct2_ortho_basis()), as speechpy::feature::mfcc() runs it
+ *
+ *   golden      per filterbank size, the first cepstra of log mel energy
+ *               rows within 1e-5 (relative above 1) of a double-precision
+ *               orthonormal DCT-II, and of numpy::dct2() per row
+ *   cache       the basis is built once per (num_filters, num_cepstral) and
+ *               thread: the same config again neither allocates nor rebuilds,
+ *               another config gets its own basis, another thread its own copy
+ *   bench       building the basis, against taking it from the cache
+ */
+
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "host_porting.h"
+#include "test.h"
+
+#include <math.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace ei;
+
+#define ROWS    49      // Frames in one model window
+
+// Log mel energies: a large shared offset per row, as log() of small powers gives
+static std::vector<float> logMel(size_t filters, std::mt19937& rng) {
+    std::uniform_real_distribution<float> offset(-23.0f, 8.0f);
+    std::normal_distribution<float> shape(0.0f, 2.0f);
+    std::vector<float> x(ROWS * filters);
+    for (size_t r = 0; r < ROWS; r++) {
+        float o = offset(rng);
+        for (size_t n = 0; n < filters; n++) x[r * filters + n] = o + shape(rng);
+    }
+    return x;
+}
+
+static double relativeError(double value, double ref) {
+    return fabs(value - ref) / fmax(1.0, fabs(ref));
+}
+
+static void checkGolden(size_t filters, size_t cepstral, std::mt19937& rng) {
+    std::vector<float> in = logMel(filters, rng);
+    const float* basis = numpy::dct2_ortho_basis(filters, cepstral);
+    CHECK(basis != nullptr, "%zu x %zu: no basis", filters, cepstral);
+    if (!basis) return;
+    std::vector<float> out(ROWS * cepstral);
+    numpy::dct2_truncated(in.data(), ROWS, filters, basis, cepstral, out.data());
+
+    double vsDouble = 0.0, vsDct2 = 0.0;
+    std::vector<float> row(filters);
+    for (size_t r = 0; r < ROWS; r++) {
+        const float* x = &in[r * filters];
+        memcpy(row.data(), x, filters * sizeof(float));
+        CHECK(numpy::dct2(row.data(), filters, DCT_NORMALIZATION_ORTHO) == EIDSP_OK, "dct2() failed");
+        for (size_t k = 0; k < cepstral; k++) {
+            double ref = 0.0;
+            for (size_t n = 0; n < filters; n++) ref += x[n] * cos(M_PI * k * (2 * n + 1) / (2.0 * filters));
+            ref *= sqrt((k == 0 ? 1.0 : 2.0) / filters);
+            vsDouble = fmax(vsDouble, relativeError(out[r * cepstral + k], ref));
+            vsDct2 = fmax(vsDct2, relativeError(out[r * cepstral + k], row[k]));
+        }
+    }
+    printf("  %2zu filters x %2zu cepstra  %.1e vs double  %.1e vs dct2()\n", filters, cepstral, vsDouble, vsDct2);
+    CHECK(vsDouble <= 1e-5, "%zu x %zu: %.2e off a double DCT", filters, cepstral, vsDouble);
+    CHECK(vsDct2 <= 1e-5, "%zu x %zu: %.2e off dct2()", filters, cepstral, vsDct2);
+}
+
+static void checkCache() {
+    const float* basis = numpy::dct2_ortho_basis(32, 13);
+    size_t allocations = hostAllocations;
+    for (int i = 0; i < 100; i++) {
+        CHECK(numpy::dct2_ortho_basis(32, 13) == basis, "basis rebuilt on call %d", i);
+    }
+    CHECK(hostAllocations == allocations, "%zu allocations for a cached basis", hostAllocations - allocations);
+
+    std::vector<float> expected(40 * 20);
+    numpy::dct2_ortho_matrix(expected.data(), 40, 20);
+    const float* other = numpy::dct2_ortho_basis(40, 20);
+    CHECK(other && memcmp(other, expected.data(), expected.size() * sizeof(float)) == 0, "40 x 20 basis wrong");
+
+    // Each thread keeps its own, so streams on other threads can't swap it under this one
+    numpy::dct2_ortho_matrix(expected.data(), 32, 13);
+    const float* mine = numpy::dct2_ortho_basis(32, 13);
+    std::thread([&]() {
+        const float* theirs = numpy::dct2_ortho_basis(32, 13);
+        CHECK(theirs && theirs != mine, "threads share a basis");
+        CHECK(theirs && memcmp(theirs, expected.data(), 32 * 13 * sizeof(float)) == 0, "other thread's basis wrong");
+        numpy::dct2_ortho_basis(40, 13);
+    }).join();
+    CHECK(memcmp(mine, expected.data(), 32 * 13 * sizeof(float)) == 0, "another thread changed this one's basis");
+}
+
+int main() {
+    printf("test_dct2\n");
+    std::mt19937 rng(36);
+    checkGolden(32, 13, rng);   // The model's MFCC block
+    checkGolden(40, 13, rng);
+    checkGolden(64, 20, rng);
+    checkGolden(20, 20, rng);   // Every output kept
+    checkCache();
+
+    std::vector<float> basis(32 * 13);
+    double buildUs = benchUs([&]() { numpy::dct2_ortho_matrix(basis.data(), 32, 13); });
+    double cachedUs = benchUs([&]() { numpy::dct2_ortho_basis(32, 13); });
+    printf("  bench 32 x 13 basis: built %.2f us, cached %.3f us\n", buildUs, cachedUs);
+
+    std::mt19937 benchRng(1);
+    std::vector<float> in = logMel(32, benchRng), out(ROWS * 13);
+    BENCH("dct2_truncated, 49 x 32 -> 49 x 13", [&]() {
+        numpy::dct2_truncated(in.data(), ROWS, 32, numpy::dct2_ortho_basis(32, 13), 13, out.data());
+    });
+    return testResult("test_dct2");
+}
@@ -0,0 +1,128 @@
+/*
+ * Sound effects (src/earcon.h) and the wall time they add to a turn
+ *
+ * playEarcon() renders a chime block by block into the speaker DMA and
+ * returns once the last block is queued, so what a chime costs the turn is
+ * the render time, plus waiting in i2s_write() for whatever doesn't fit in
+ * the DMA queue. Per chime and speaker rate:
+ *
+ *   length      the chime lasts as long at every rate (frames / rate)
+ *   wall time   render on this host, and time blocked on a full DMA queue
+ *   pitch       notes play at their frequency (zero crossings)
+ *   clicks      note edges ramp, no step larger than the tone's own
+ */
+
+#include "earcon.h"
+#include "test.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp, src/config.h and src/memory_pool.h
+
+#define SPK_DMA_FRAMES          (16 * 1024)     // SPK_DMA_BUF_COUNT * SPK_DMA_BUF_LEN
+#define EARCON_BLOCK_FRAMES     1024            // POOL_STREAM_STEREO bytes / 4
+
+struct Chime {
+    const char* name;
+    EarconNote notes[3];
+    uint8_t count;
+    float volume;
+};
+
+static const Chime chimes[] = {
+    { "startup",    { {523, 150}, {659, 150}, {784, 300} }, 3, 0.2f },
+    { "mute",       { {880, 100}, {440, 200} },             2, 0.15f },
+    { "unmute",     { {440, 100}, {880, 200} },             2, 0.15f },
+    { "listening",  { {1047, 150} },                        1, 0.2f },
+    { "processing", { {523, 200}, {659, 200} },             2, 0.15f },
+    { "success",    { {659, 100}, {784, 100}, {1047, 200} }, 3, 0.2f },
+    { "error",      { {392, 200}, {330, 300} },             2, 0.15f },
+};
+
+static const uint32_t rates[] = { 16000, 22050, 24000 };   // SAMPLE_RATE, and what TTS streams at
+
+// As playEarcon() does, minus the I2S: every block, mono
+static std::vector<int16_t> render(EarconPlayer& player, const Chime& chime, uint32_t rate) {
+    static int16_t stereo[EARCON_BLOCK_FRAMES * 2];
+    std::vector<int16_t> out;
+    player.start(chime.notes, chime.count, chime.volume, rate);
+    size_t frames;
+    while ((frames = player.render(stereo, EARCON_BLOCK_FRAMES)) > 0) {
+        for (size_t i = 0; i < frames; i++) {
+            if (stereo[i * 2] != stereo[i * 2 + 1]) return std::vector<int16_t>();     // Both channels, always
+            out.push_back(stereo[i * 2]);
+        }
+    }
+    return out;
+}
+
+static void checkNote(const Chime& chime, const std::vector<int16_t>& audio, uint32_t rate) {
+    size_t start = 0;
+    for (uint8_t n = 0; n < chime.count; n++) {
+        const EarconNote& note = chime.notes[n];
+        size_t length = (size_t)((uint64_t)rate * note.durationMs / 1000);
+        if (start + length > audio.size()) return;
+        const int16_t* x = &audio[start];
+
+        // Pitch from the zero crossings of the steady part
+        size_t ramp = rate * EARCON_RAMP_MS / 1000;
+        int crossings = 0;
+        size_t first = 0, last = 0;
+        for (size_t i = ramp + 1; i < length - ramp; i++) {
+            if ((x[i - 1] < 0) != (x[i] < 0)) {
+                if (crossings == 0) first = i;
+                last = i;
+                crossings++;
+            }
+        }
+        double hz = crossings > 1 ? (crossings - 1) * 0.5 * rate / (last - first) : 0.0;
+        CHECK(fabs(hz - note.frequency) < note.frequency * 0.01, "%s at %u Hz: note %u plays at %.1f Hz",
+              chime.name, rate, note.frequency, hz);
+
+        // Edges start and end at silence and don't step more than the tone does
+        int steadyStep = 0, edgeStep = abs(x[0]) > abs(x[length - 1]) ? abs(x[0]) : abs(x[length - 1]);
+        for (size_t i = 1; i < length; i++) {
+            int step = abs(x[i] - x[i - 1]);
+            if (i > ramp && i < length - ramp) steadyStep = step > steadyStep ? step : steadyStep;
+            else edgeStep = step > edgeStep ? step : edgeStep;
+        }
+        CHECK(edgeStep <= steadyStep + 1, "%s at %u Hz: note %u steps %d at its edges, %d inside",
+              chime.name, rate, note.frequency, edgeStep, steadyStep);
+        start += length;
+    }
+}
+
+int main() {
+    printf("test_earcon\n");
+    printf("  %-11s %5s  %21s  %21s\n", "", "audio", "render us @16k/22k/24k", "blocked ms @16k/22k/24k");
+    static EarconPlayer player;
+    for (const Chime& chime : chimes) {
+        uint32_t ms = 0;
+        for (uint8_t n = 0; n < chime.count; n++) ms += chime.notes[n].durationMs;
+
+        double renderUs[3], blockedMs[3];
+        for (int r = 0; r < 3; r++) {
+            uint32_t rate = rates[r];
+            std::vector<int16_t> audio = render(player, chime, rate);
+            CHECK(!audio.empty(), "%s at %u Hz: nothing rendered, or channels differ", chime.name, rate);
+            double lasts = audio.size() * 1000.0 / rate;
+            CHECK(fabs(lasts - ms) <= 1.0, "%s at %u Hz lasts %.1f ms, not %u", chime.name, rate, lasts, ms);
+            checkNote(chime, audio, rate);
+
+            renderUs[r] = benchUs([&]() { render(player, chime, rate); }, 0.05);
+            // i2s_write() only waits once the DMA queue is full (it starts empty at worst)
+            blockedMs[r] = audio.size() > SPK_DMA_FRAMES ? (audio.size() - SPK_DMA_FRAMES) * 1000.0 / rate : 0.0;
+            CHECK(blockedMs[r] == 0.0, "%s at %u Hz blocks %.1f ms on the DMA queue", chime.name, rate, blockedMs[r]);
+        }
+        printf("  %-11s %3u ms  %6.1f %6.1f %6.1f  %7.1f %6.1f %6.1f\n", chime.name, ms,
+               renderUs[0], renderUs[1], renderUs[2], blockedMs[0], blockedMs[1], blockedMs[2]);
+    }
+
+    // A chime that doesn't fit the DMA queue, to be sure the accounting above can see one
+    static const Chime longChime = { "long", { {440, 1200} }, 1, 0.2f };
+    CHECK(render(player, longChime, 16000).size() > SPK_DMA_FRAMES, "1.2 s fits the DMA queue");
+    return testResult("test_earcon");
+}
@@ -0,0 +1,93 @@
+/*
+ * Placement of the Edge Impulse SDK's allocations on the ESP32-S3
+ * (porting/espressif/ei_classifier_porting.cpp), against the mock heap of
+ * tests/mock on the IDF 4.4 that Arduino-ESP32 2.x builds:
+ *
+ *   placement   up to EI_ESPRESSIF_INTERNAL_ALLOC_MAX in internal SRAM, larger
+ *               in PSRAM, 16-byte aligned
+ *   fallback    each falls back to the other region before failing
+ *   calloc      zeroed, and nitems * size overflowing fails without asking the heap
+ */
+
+#define CONFIG_IDF_TARGET_ESP32S3   1
+#include "edge-impulse-sdk/porting/espressif/ei_classifier_porting.cpp"
+#include "test.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static bool aligned16(const void* p) {
+    return ((uintptr_t)p & 15) == 0;
+}
+
+static void checkPlacement() {
+    mockHeap.reset(1 << 20, 8 << 20);
+
+    void* small = ei_malloc(1024);
+    CHECK(small && aligned16(small), "1 KB allocation %p", small);
+    CHECK(mockHeap.internal.requests == 1 && mockHeap.spiram.requests == 0, "1 KB asked of internal %u, PSRAM %u",
+          mockHeap.internal.requests, mockHeap.spiram.requests);
+
+    void* edge = ei_malloc(EI_ESPRESSIF_INTERNAL_ALLOC_MAX);
+    CHECK(edge && mockHeap.internal.requests == 2 && mockHeap.spiram.requests == 0,
+          "%d bytes not internal", EI_ESPRESSIF_INTERNAL_ALLOC_MAX);
+
+    void* large = ei_malloc(EI_ESPRESSIF_INTERNAL_ALLOC_MAX + 1);
+    CHECK(large && aligned16(large), "large allocation %p", large);
+    CHECK(mockHeap.internal.requests == 2 && mockHeap.spiram.requests == 1, "large asked of internal %u, PSRAM %u",
+          mockHeap.internal.requests, mockHeap.spiram.requests);
+
+    ei_free(small);
+    ei_free(edge);
+    ei_free(large);
+}
+
+static void checkFallback() {
+    // Internal exhausted: small requests go to PSRAM
+    mockHeap.reset(0, 1 << 20);
+    void* p = ei_malloc(512);
+    CHECK(p && mockHeap.internal.failures == 1 && mockHeap.spiram.requests == 1, "no PSRAM fallback");
+    ei_free(p);
+
+    // No PSRAM (a board without it): large requests go internal
+    mockHeap.reset(1 << 20, 0);
+    p = ei_malloc(64 * 1024);
+    CHECK(p && mockHeap.spiram.failures == 1 && mockHeap.internal.requests == 1, "no internal fallback");
+    ei_free(p);
+
+    // Neither fits
+    mockHeap.reset(100, 100);
+    CHECK(ei_malloc(4096) == nullptr, "4 KB out of 200 bytes");
+    CHECK(mockHeap.internal.failures == 1 && mockHeap.spiram.failures == 1, "both regions not tried");
+    CHECK(mockHeap.misaligned == 0, "alignment not a power of two");
+}
+
+static void checkCalloc() {
+    mockHeap.reset(1 << 20, 8 << 20);
+    // Dirty the region first, so zeroing is the port's doing
+    uint8_t* dirty = (uint8_t*)ei_malloc(4096);
+    memset(dirty, 0xA5, 4096);
+    ei_free(dirty);
+
+    uint8_t* p = (uint8_t*)ei_calloc(1000, 4);
+    bool zero = p != nullptr;
+    for (int i = 0; p && i < 4000; i++) zero = zero && p[i] == 0;
+    CHECK(zero && aligned16(p), "calloc(1000, 4) not zeroed and aligned");
+    ei_free(p);
+
+    uint32_t asked = mockHeap.internal.requests + mockHeap.spiram.requests;
+    CHECK(ei_calloc(SIZE_MAX / 2 + 2, 2) == nullptr, "calloc overflowing size_t succeeded");
+    CHECK(ei_calloc(2, SIZE_MAX / 2 + 2) == nullptr, "calloc overflowing size_t succeeded");
+    CHECK(mockHeap.internal.requests + mockHeap.spiram.requests == asked, "overflowing calloc reached the heap");
+
+    void* empty = ei_calloc(0, 16);
+    ei_free(empty);
+}
+
+int main() {
+    printf("test_ei_porting\n");
+    checkPlacement();
+    checkFallback();
+    checkCalloc();
+    return testResult("test_ei_porting");
+}
@@ -0,0 +1,233 @@
+/*
+ * Polynomial DSP kernels (dsp/ei_fast_math.h) and the EIDSP_FAST_MATH paths
+ * the firmware builds with
+ *
+ *   bounds      log and log10 within the max errors documented in
+ *               ei_fast_math.h, exhaustively on [0.5, 2] and sampled every 61
+ *               floats elsewhere
+ *   power       numpy::power_spectrum() without the sqrt() within a few ulp of
+ *               squaring rfft()'s magnitude, bin for bin, and inside a
+ *               dsp_scratch_scope no heap allocation beyond rfft()'s own
+ *   unset       continuous classification reads no memory it didn't set: with
+ *               every ei_malloc() block filled with 0x00 or 0xA5, on the main
+ *               thread or a worker, per-slice features, captured model input
+ *               and scores are the same bit for bit, and the DSP scratch arena's
+ *               accounting stays sane
+ *   bench       the kernels against libm and numpy per value, best of 15;
+ *               log10 where it is used, in the MFE normalization loop, must
+ *               beat numpy::log10() there; power with and without the magnitude
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/classifier/ei_score_cache.h"
+#include "edge-impulse-sdk/dsp/ei_fast_math.h"
+#include "host_porting.h"
+#include "test.h"
+
+#include <float.h>
+#include <math.h>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if EIDSP_FAST_MATH != 1
+#error "Build with -DEIDSP_FAST_MATH=1, as platformio.ini does"
+#endif
+
+#define FILES       3       // run_classifier_init() per file, as tools/wake_eval does
+#define SLICES      7
+#define SAMPLE_STEP 61      // Float bit patterns between samples outside [0.5, 2]
+
+static float bitsToFloat(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+struct LogError {
+    double inside = 0.0;    // Absolute on [0.5, 2]
+    double outside = 0.0;   // Relative elsewhere
+};
+
+template <typename Fast, typename Reference>
+static LogError logError(Fast fast, Reference reference) {
+    LogError e;
+    const uint32_t half = 0x3f000000, two = 0x40000000;
+    for (uint32_t bits = half; bits <= two; bits++) {
+        float x = bitsToFloat(bits);
+        e.inside = fmax(e.inside, fabs(fast(x) - reference((double)x)));
+    }
+    for (uint32_t bits = 0x00800000; bits < 0x7f800000; bits += SAMPLE_STEP) {
+        if (bits >= half && bits <= two) continue;
+        float x = bitsToFloat(bits);
+        double ref = reference((double)x);
+        e.outside = fmax(e.outside, fabs(fast(x) - ref) / fabs(ref));
+    }
+    return e;
+}
+
+static void checkBounds() {
+    LogError ln = logError([](float x) { return fast_math::log(x); }, [](double x) { return log(x); });
+    LogError lg = logError([](float x) { return fast_math::log10(x); }, [](double x) { return log10(x); });
+    printf("  log    %.2e abs on [0.5, 2], %.2e rel elsewhere\n", ln.inside, ln.outside);
+    printf("  log10  %.2e abs on [0.5, 2], %.2e rel elsewhere\n", lg.inside, lg.outside);
+    CHECK(ln.inside <= 1.5e-5 && ln.outside <= 1.8e-5, "log outside its documented error");
+    CHECK(lg.inside <= 6.6e-6 && lg.outside <= 1.8e-5, "log10 outside its documented error");
+
+}
+
+static void checkPower() {
+    const size_t fftLength = 512, bins = fftLength / 2 + 1;
+    std::mt19937 rng(37);
+    std::normal_distribution<float> noise(0.0f, 2000.0f);
+    std::vector<float> frame(400), magnitude(bins), power(bins);
+    for (float& x : frame) x = noise(rng);
+
+    CHECK(numpy::rfft(frame.data(), frame.size(), magnitude.data(), bins, fftLength) == EIDSP_OK, "rfft() failed");
+    CHECK(numpy::power_spectrum(frame.data(), frame.size(), power.data(), bins, fftLength) == EIDSP_OK,
+          "power_spectrum() failed");
+    double worst = 0.0;
+    for (size_t k = 0; k < bins; k++) {
+        double viaMagnitude = (1.0 / fftLength) * ((double)magnitude[k] * magnitude[k]);
+        worst = fmax(worst, fabs(power[k] - viaMagnitude) / viaMagnitude);
+    }
+    printf("  power  %.1f ulp off the magnitude squared\n", worst / FLT_EPSILON);
+    CHECK(worst <= 4 * FLT_EPSILON, "power_spectrum() %.2e off the magnitude squared", worst);
+
+    // The complex spectrum is a matrix like rfft()'s input copy: from the arena in a scope
+    std::vector<fft_complex_t> spectrum(bins);
+    auto rfftInScope = [&]() { dsp_scratch_scope scope; numpy::rfft(frame.data(), frame.size(), spectrum.data(), bins, fftLength); };
+    auto powerInScope = [&]() { dsp_scratch_scope scope; numpy::power_spectrum(frame.data(), frame.size(), power.data(), bins, fftLength); };
+    powerInScope();     // Grows the block
+    size_t before = hostAllocations;
+    rfftInScope();
+    size_t rfftAllocations = hostAllocations - before;
+    before = hostAllocations;
+    powerInScope();
+    size_t powerAllocations = hostAllocations - before;
+    CHECK(powerAllocations == rfftAllocations, "power_spectrum(): %zu heap allocations, rfft() %zu", powerAllocations,
+          rfftAllocations);
+}
+
+// Everything one stream leaves behind, per slice: its features, the captured model input, its scores
+static std::string classifyFiles(int fill) {
+    hostMallocFill = fill;
+    std::mt19937 rng(370);
+    std::normal_distribution<float> noise(0.0f, 1000.0f);
+    std::vector<int16_t> slice(EI_CLASSIFIER_SLICE_SIZE);
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = [&slice](size_t offset, size_t length, float* out) {
+        for (size_t i = 0; i < length; i++) out[i] = (float)slice[offset + i];
+        return 0;
+    };
+
+    ei_impulse_handle_t handle(ei_default_impulse.impulse);
+    static thread_local int8_t features[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE];
+    ei_score_cache_header_t header;
+    ei_score_cache_header_init(&header);
+    ei_score_cache_capture_input(&handle, features, &header);
+
+    std::string out;
+    for (int file = 0; file < FILES; file++) {
+        run_classifier_init(&handle);
+        for (int s = 0; s < SLICES; s++) {
+            for (int16_t& x : slice) x = (int16_t)fmaxf(-32768.0f, fminf(32767.0f, noise(rng) * (file + 1)));
+            ei_impulse_result_t result = {};
+            if (run_classifier_continuous(&handle, &signal, &result, false) != EI_IMPULSE_OK) {
+                out += "failed";
+                break;
+            }
+            const matrix_t* window = handle.continuous_state.features;
+            out.append((const char*)window->buffer, window->rows * window->cols * sizeof(float));
+            const int8_t* input = ei_score_cache_captured_input(&handle);
+            if (input) out.append((const char*)input, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+            for (int l = 0; l < EI_CLASSIFIER_LABEL_COUNT; l++) {
+                out.append((const char*)&result.classification[l].value, sizeof(float));
+            }
+        }
+        run_classifier_deinit(&handle);
+    }
+    ei_score_cache_capture_input(&handle, nullptr, nullptr);
+    hostMallocFill = -1;
+    // A free of memory it never handed out would leave this arena's accounting off
+    size_t highWater = dsp_scratch::local().high_water();
+    out.append((const char*)&highWater, sizeof(highWater));
+    return out;
+}
+
+static std::string onWorker(int fill) {
+    std::string out;
+    std::thread([&]() { out = classifyFiles(fill); }).join();
+    return out;
+}
+
+static void checkUnset() {
+    std::string main0 = classifyFiles(0x00);
+    std::string runs[] = { classifyFiles(0xA5), onWorker(0x00), onWorker(0xA5), onWorker(0xA5) };
+    const char* names[] = { "main thread, 0xA5", "worker, 0x00", "worker, 0xA5", "second worker, 0xA5" };
+    CHECK(main0.size() > (size_t)FILES * SLICES * EI_CLASSIFIER_LABEL_COUNT * sizeof(float), "classification failed");
+    size_t highWater;
+    memcpy(&highWater, &main0[main0.size() - sizeof(highWater)], sizeof(highWater));
+    printf("  DSP scratch high water %zu bytes\n", highWater);
+    CHECK(highWater < 1024 * 1024, "DSP scratch accounting off: %zu bytes high water", highWater);
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        CHECK(runs[r] == main0, "%s differs from the main thread, 0x00", names[r]);
+    }
+}
+
+int main() {
+    printf("test_fast_math\n");
+    checkBounds();
+    checkPower();
+    checkUnset();
+
+    // Log mel energies and normalized spectrograms sit between 1e-10 and 1e6
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> exponent(-10.0f, 6.0f);
+    std::vector<float> positive(4096), buffer(4096);
+    for (float& x : positive) x = powf(10.0f, exponent(rng));
+    auto perValue = [&](void (*body)(float*, size_t)) {
+        return benchBestUs([&]() { memcpy(buffer.data(), positive.data(), positive.size() * sizeof(float)); body(buffer.data(), buffer.size()); })
+               * 1000.0 / buffer.size();
+    };
+    printf("  bench ns per value      libm  numpy  fast_math\n");
+    printf("  bench log              %5.2f  %5.2f  %5.2f\n",
+           perValue([](float* b, size_t n) { for (size_t i = 0; i < n; i++) b[i] = logf(b[i]); }),
+           perValue([](float* b, size_t n) { for (size_t i = 0; i < n; i++) b[i] = numpy::log(b[i]); }),
+           perValue([](float* b, size_t n) { fast_math::log(b, n); }));
+    printf("  bench log10            %5.2f  %5.2f  %5.2f\n",
+           perValue([](float* b, size_t n) { for (size_t i = 0; i < n; i++) b[i] = log10f(b[i]); }),
+           perValue([](float* b, size_t n) { for (size_t i = 0; i < n; i++) b[i] = numpy::log10(b[i]); }),
+           perValue([](float* b, size_t n) { for (size_t i = 0; i < n; i++) b[i] = fast_math::log10(b[i]); }));
+
+    // processing::mfe_normalization() as built, against its loop with numpy::log10()
+    double mfeNumpy = perValue([](float* b, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            float f = numpy::log10(fmaxf(b[i], 1e-30f)) * 10.0f;
+            f = roundf((f + 52.0f) * (1.0f / 64.0f) * 256) / 256;
+            b[i] = f < 0.0f ? 0.0f : f > 1.0f ? 1.0f : f;
+        }
+    });
+    double mfeFast = perValue([](float* b, size_t n) {
+        matrix_t m(1, n, b);
+        speechpy::processing::mfe_normalization(&m, -52);
+    });
+    printf("  bench MFE normalization    -  %5.2f  %5.2f\n", mfeNumpy, mfeFast);
+    CHECK(mfeFast < mfeNumpy, "fast log10 doesn't pay off in the MFE normalization");
+
+    // 257 bins, as in the model's 512-point FFT
+    std::vector<fft_complex_t> spectrum(257);
+    std::normal_distribution<float> noise(0.0f, 1000.0f);
+    for (fft_complex_t& c : spectrum) c = { noise(rng), noise(rng) };
+    std::vector<float> power(spectrum.size());
+    BENCH("power, 257 bins via the magnitude", [&]() {
+        for (size_t k = 0; k < spectrum.size(); k++) {
+            float magnitude = sqrtf(spectrum[k].r * spectrum[k].r + spectrum[k].i * spectrum[k].i);
+            power[k] = (1.0f / 512.0f) * (magnitude * magnitude);
+        }
+    });
+    BENCH("power, 257 bins direct", [&]() { fast_math::power(spectrum.data(), power.data(), power.size(), 1.0f / 512.0f); });
+    return testResult("test_fast_math");
+}
@@ -0,0 +1,203 @@
+/*
+ * Integer real FFT engine (dsp/dsp_engines/ei_fixed_point_fft.h), against
+ * KissFFT, the float FFT this build uses when no engine is selected
+ *
+ *   accuracy    fixed_point::rfft() from int16 audio, and hw_r2c_fft() from
+ *               float frames, for every size from 32 to 4096: noise, quiet
+ *               noise, a tone over DC, an impulse, full scale and silence stay
+ *               within 1e-6 of the peak bin of KissFFT's spectrum, and power
+ *               within 0.01 dB on bins within 100 dB of the peak
+ *   sizes       sizes that aren't a power of two in range are refused, so the
+ *               caller falls back to KissFFT
+ *   tables      one twiddle table serves every smaller size: once made, calls
+ *               make no heap allocations, whatever the size order
+ *   bench       cycles (x86 TSC) and time per 512-point frame, best of 15:
+ *               integer input, float input and KissFFT
+ */
+
+#define EIDSP_USE_FIXED_POINT_FFT 1
+#include "edge-impulse-sdk/dsp/dsp_engines/ei_fixed_point_fft.h"
+#include "edge-impulse-sdk/dsp/kissfft/kiss_fftr.h"
+#include "host_porting.h"
+#include "test.h"
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+using ei::fft_complex_t;
+using ei::fft::fixed_point::q31_complex_t;
+
+static std::vector<fft_complex_t> kissSpectrum(const std::vector<float>& frame) {
+    std::vector<fft_complex_t> out(frame.size() / 2 + 1);
+    kiss_fftr_cfg cfg = kiss_fftr_alloc((int)frame.size(), 0, nullptr, nullptr, nullptr);
+    kiss_fftr(cfg, frame.data(), reinterpret_cast<kiss_fft_cpx*>(out.data()));
+    free(cfg);
+    return out;
+}
+
+struct SpectrumError {
+    double peak = 0.0;      // Of the difference, relative to the largest bin
+    double powerDb = 0.0;   // On bins within 100 dB of the largest
+};
+
+static SpectrumError compare(const std::vector<fft_complex_t>& got, const std::vector<fft_complex_t>& want) {
+    SpectrumError e;
+    double peak = 0.0;
+    for (const fft_complex_t& c : want) peak = fmax(peak, hypot(c.r, c.i));
+    if (peak == 0.0) {
+        for (const fft_complex_t& c : got) e.peak = fmax(e.peak, hypot(c.r, c.i));
+        return e;
+    }
+    for (size_t k = 0; k < want.size(); k++) {
+        e.peak = fmax(e.peak, hypot(got[k].r - want[k].r, got[k].i - want[k].i) / peak);
+        double p = (double)want[k].r * want[k].r + (double)want[k].i * want[k].i;
+        if (p < peak * peak * 1e-10) continue;
+        double q = (double)got[k].r * got[k].r + (double)got[k].i * got[k].i;
+        e.powerDb = fmax(e.powerDb, fabs(10.0 * log10(q / p)));
+    }
+    return e;
+}
+
+// Whole int16 samples, as the microphone gives them; scaled by `level`
+static std::vector<float> signal(const char* name, size_t n, std::mt19937& rng) {
+    std::normal_distribution<float> noise(0.0f, 2000.0f);
+    std::vector<float> x(n, 0.0f);
+    std::string s = name;
+    for (size_t i = 0; i < n; i++) {
+        if (s == "noise") x[i] = noise(rng);
+        else if (s == "quiet") x[i] = roundf(noise(rng) / 500.0f);
+        else if (s == "tone") x[i] = roundf(300.0f + 8000.0f * sinf(0.37f * i));
+        else if (s == "full scale") x[i] = (i / 3) % 2 ? 32767.0f : -32768.0f;
+    }
+    if (s == "impulse") x[n / 3] = 1.0f;
+    for (float& v : x) v = fmaxf(-32768.0f, fminf(32767.0f, roundf(v)));
+    return x;
+}
+
+static const char* const kSignals[] = { "noise", "quiet", "tone", "impulse", "full scale", "silence" };
+
+static void checkAccuracy() {
+    std::mt19937 rng(38);
+    SpectrumError worstInt, worstFloat;
+    for (size_t n = 32; n <= 4096; n *= 2) {
+        for (const char* name : kSignals) {
+            std::vector<float> frame = signal(name, n, rng);
+            std::vector<fft_complex_t> want = kissSpectrum(frame);
+
+            // Integer input
+            std::vector<int32_t> samples(frame.begin(), frame.end());
+            std::vector<q31_complex_t> bins(n / 2 + 1);
+            int exponent = 0;
+            CHECK(ei::fft::fixed_point::rfft(samples.data(), n, bins.data(), &exponent) == ei::EIDSP_OK, "%zu: rfft failed", n);
+            std::vector<fft_complex_t> got(n / 2 + 1);
+            for (size_t k = 0; k < got.size(); k++) {
+                got[k] = { ldexpf((float)bins[k].r, exponent), ldexpf((float)bins[k].i, exponent) };
+            }
+            SpectrumError e = compare(got, want);
+            CHECK(e.peak <= 1e-6 && e.powerDb <= 0.01, "%zu, %s, integer: %.2e of the peak, %.4f dB", n, name, e.peak, e.powerDb);
+            worstInt.peak = fmax(worstInt.peak, e.peak);
+            worstInt.powerDb = fmax(worstInt.powerDb, e.powerDb);
+
+            // Float input through the engine entry point, which works in its input
+            std::vector<float> copy = frame;
+            CHECK(ei::fft::hw_r2c_fft(copy.data(), got.data(), n) == ei::EIDSP_OK, "%zu: hw_r2c_fft failed", n);
+            e = compare(got, want);
+            CHECK(e.peak <= 1e-6 && e.powerDb <= 0.01, "%zu, %s, float: %.2e of the peak, %.4f dB", n, name, e.peak, e.powerDb);
+            worstFloat.peak = fmax(worstFloat.peak, e.peak);
+            worstFloat.powerDb = fmax(worstFloat.powerDb, e.powerDb);
+        }
+    }
+    printf("  integer input  %.2e of the peak, %.4f dB power\n", worstInt.peak, worstInt.powerDb);
+    printf("  float input    %.2e of the peak, %.4f dB power\n", worstFloat.peak, worstFloat.powerDb);
+
+    // Quiet float input keeps its precision: no fixed scale to fall under
+    std::vector<float> frame = signal("noise", 512, rng);
+    for (float& v : frame) v *= 1e-6f;
+    std::vector<fft_complex_t> got(257), want = kissSpectrum(frame);
+    ei::fft::hw_r2c_fft(frame.data(), got.data(), 512);
+    SpectrumError e = compare(got, want);
+    CHECK(e.peak <= 1e-6, "noise at 1e-6: %.2e of the peak", e.peak);
+}
+
+static void checkSizes() {
+    std::vector<float> frame(8192, 1.0f);
+    std::vector<fft_complex_t> out(4097);
+    std::vector<q31_complex_t> bins(4097);
+    int32_t samples[400] = { 1 };
+    int exponent;
+    for (size_t n : { (size_t)16, (size_t)400, (size_t)8192 }) {
+        CHECK(ei::fft::hw_r2c_fft(frame.data(), out.data(), n) == ei::EIDSP_FFT_SIZE_NOT_SUPPORTED, "%zu accepted", n);
+        CHECK(!ei::fft::can_do_fft(n), "can_do_fft(%zu)", n);
+    }
+    CHECK(frame[0] == 1.0f, "refused input overwritten");
+    CHECK(ei::fft::fixed_point::rfft(samples, 400, bins.data(), &exponent) == ei::EIDSP_FFT_SIZE_NOT_SUPPORTED,
+          "rfft() took 400 points");
+}
+
+static void checkTables() {
+    std::mt19937 rng(3);
+    std::vector<float> frame;
+    std::vector<fft_complex_t> out(2049);
+    // On a thread of its own: a table made for another size doesn't get in the way
+    std::thread([&]() {
+        frame = signal("noise", 4096, rng);
+        ei::fft::hw_r2c_fft(frame.data(), out.data(), 4096);
+        size_t before = hostAllocations;
+        for (size_t n : { 512, 64, 4096, 256, 512 }) {
+            frame = signal("noise", n, rng);
+            ei::fft::hw_r2c_fft(frame.data(), out.data(), n);
+        }
+        CHECK(hostAllocations == before, "%zu heap allocations once the table was made", hostAllocations - before);
+    }).join();
+}
+
+int main() {
+    printf("test_fixed_point_fft\n");
+    checkAccuracy();
+    checkSizes();
+    checkTables();
+
+    std::mt19937 rng(512);
+    std::vector<float> audio = signal("noise", 512, rng), frame(512);
+    std::vector<int32_t> samples(512);
+    std::vector<q31_complex_t> bins(257);
+    std::vector<fft_complex_t> out(257);
+    kiss_fftr_cfg cfg = kiss_fftr_alloc(512, 0, nullptr, nullptr, nullptr);
+    int exponent;
+    auto integer = [&]() {
+        for (size_t i = 0; i < 512; i++) samples[i] = (int32_t)audio[i];
+        ei::fft::fixed_point::rfft(samples.data(), 512, bins.data(), &exponent);
+    };
+    auto fromFloat = [&]() {
+        memcpy(frame.data(), audio.data(), 512 * sizeof(float));
+        ei::fft::hw_r2c_fft(frame.data(), out.data(), 512);
+    };
+    auto kiss = [&]() {
+        memcpy(frame.data(), audio.data(), 512 * sizeof(float));
+        kiss_fftr(cfg, frame.data(), reinterpret_cast<kiss_fft_cpx*>(out.data()));
+    };
+    auto report = [](const char* name, auto body) {
+#if HAVE_TSC
+        double cycles = 1e300;
+        for (int r = 0; r < 15; r++) {
+            uint64_t start = __rdtsc();
+            for (int i = 0; i < 200; i++) body();
+            cycles = fmin(cycles, (double)(__rdtsc() - start) / 200);
+        }
+        printf("  bench %-40s %7.0f cycles %7.2f us\n", name, cycles, benchBestUs(body));
+#else
+        printf("  bench %-40s %7.2f us\n", name, benchBestUs(body));
+#endif
+    };
+    report("512 points, integer input", integer);
+    report("512 points, float input", fromFloat);
+    report("512 points, KissFFT", kiss);
+    free(cfg);
+    return testResult("test_fixed_point_fft");
+}
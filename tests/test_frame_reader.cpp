@@ -0,0 +1,201 @@
+/*
+ * Buffered framing (speechpy::processing::frame_reader) and sequential reads
+ * through pre-emphasis, as the compile-time MFCC engine frames a slice
+ *
+ *   frames      every frame bit for bit what a get_data() call for just that
+ *               frame gives, for any frames per read, with and without
+ *               overlap, with gaps between frames, with a tail the frames
+ *               don't reach
+ *   layout      stack_frames() as MFE, spectrogram and MFCC frame: as many
+ *               frames as calculate_no_of_stack_frames(), at the offsets
+ *               the frame index list had, for every version and with gaps
+ *   preemphasis the same through one preemphasis reader, against a fresh one
+ *               per frame (which fetches its history every time)
+ *   calls       one get_data() per frames_per_read frames, and no sample past
+ *               the last frame
+ *   empty       0 frames: next() fails without reading
+ *   bench       frames per second of the model's framing, one get_data() per
+ *               frame against the reader, both through pre-emphasis: best of
+ *               25 runs of 20 windows each, the reader must be faster
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "host_porting.h"
+#include "test.h"
+
+#include <random>
+#include <vector>
+
+using namespace ei;
+
+#define FRAME_LENGTH    400     // 25 ms at 16 kHz, as the model's MFCC block
+#define FRAME_STRIDE    320     // 20 ms
+#define PREEMPHASIS     0.98f
+
+// int16 audio as the firmware's get_data() converts it, counting calls and samples
+struct Source {
+    std::vector<int16_t> samples;
+    size_t calls = 0;
+    size_t read = 0;
+    size_t last = 0;    // Last sample read, + 1
+    signal_t signal;
+
+    explicit Source(size_t length, uint32_t seed) : samples(length) {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> noise(0.0f, 3000.0f);
+        for (int16_t& x : samples) x = (int16_t)fmaxf(-32768.0f, fminf(32767.0f, noise(rng)));
+        signal.total_length = length;
+        signal.get_data = [this](size_t offset, size_t count, float* out) {
+            calls++;
+            read += count;
+            if (offset + count > last) last = offset + count;
+            for (size_t i = 0; i < count; i++) out[i] = (float)samples[offset + i];
+            return 0;
+        };
+    }
+};
+
+static size_t frameCount(size_t length, size_t frameLength, size_t stride) {
+    return length < frameLength ? 0 : (length - frameLength) / stride + 1;
+}
+
+static void checkFrames(size_t length, size_t frameLength, size_t stride, size_t perRead) {
+    Source source(length, (uint32_t)(length + perRead));
+    size_t frames = frameCount(length, frameLength, stride);
+    speechpy::processing::frame_reader reader(&source.signal, frameLength, stride, frames, perRead);
+    CHECK(reader.status() == EIDSP_OK, "no buffer");
+
+    std::vector<float> expected(frameLength);
+    size_t mismatches = 0;
+    for (size_t f = 0; f < frames; f++) {
+        const float* frame = nullptr;
+        if (reader.next(&frame) != EIDSP_OK) {
+            CHECK(false, "%zu / %zu / %zu per read: frame %zu failed", frameLength, stride, perRead, f);
+            return;
+        }
+        for (size_t i = 0; i < frameLength; i++) expected[i] = (float)source.samples[f * stride + i];
+        mismatches += memcmp(frame, expected.data(), frameLength * sizeof(float)) != 0;
+    }
+    CHECK(mismatches == 0, "%zu / %zu / %zu per read: %zu frames differ", frameLength, stride, perRead, mismatches);
+    size_t reads = (frames + perRead - 1) / perRead;
+    CHECK(source.calls == reads, "%zu frames, %zu per read: %zu get_data() calls, expected %zu", frames, perRead,
+          source.calls, reads);
+    CHECK(source.last == (frames - 1) * stride + frameLength, "read up to sample %zu", source.last);
+}
+
+static void checkLayout(float frameLength, float frameStride, uint16_t version) {
+    const size_t length = 16000 + 37;
+    Source source(length, version);
+    speechpy::stack_frames_info_t info = {};
+    info.signal = &source.signal;
+    CHECK(speechpy::processing::stack_frames(&info, 16000, frameLength, frameStride, false, version) == EIDSP_OK,
+          "stack_frames failed");
+    int32_t expected = speechpy::processing::calculate_no_of_stack_frames(length, 16000, frameLength, frameStride,
+                                                                          false, version);
+    CHECK((int32_t)info.frames == expected, "v%u %.3f / %.3f: %zu frames, expected %d", version, frameLength,
+          frameStride, info.frames, expected);
+
+    speechpy::processing::frame_reader reader(&info);
+    size_t mismatches = 0;
+    for (size_t f = 0; f < info.frames; f++) {
+        const float* frame = nullptr;
+        if (reader.next(&frame) != EIDSP_OK) {
+            CHECK(false, "v%u %.3f / %.3f: frame %zu failed", version, frameLength, frameStride, f);
+            return;
+        }
+        for (int i = 0; i < info.frame_length; i++) {
+            mismatches += frame[i] != (float)source.samples[f * info.frame_stride + i];
+        }
+    }
+    CHECK(mismatches == 0, "v%u %.3f / %.3f: %zu samples differ", version, frameLength, frameStride, mismatches);
+    CHECK(source.last <= source.signal.total_length, "read past the framed signal");
+}
+
+static void checkPreemphasis(bool rescale) {
+    const size_t length = EI_CLASSIFIER_SLICE_SIZE + FRAME_LENGTH - FRAME_STRIDE;    // A slice and the overlap before it
+    const size_t frames = frameCount(length, FRAME_LENGTH, FRAME_STRIDE);
+    Source source(length, 40);
+
+    class speechpy::processing::preemphasis chained(&source.signal, 1, PREEMPHASIS, rescale);
+    signal_t preemphasized;
+    preemphasized.total_length = length;
+    preemphasized.get_data = [&chained](size_t offset, size_t count, float* out) {
+        return chained.get_data(offset, count, out);
+    };
+    speechpy::processing::frame_reader reader(&preemphasized, FRAME_LENGTH, FRAME_STRIDE, frames);
+
+    std::vector<float> expected(FRAME_LENGTH);
+    size_t mismatches = 0;
+    for (size_t f = 0; f < frames; f++) {
+        const float* frame = nullptr;
+        CHECK(reader.next(&frame) == EIDSP_OK, "frame %zu failed", f);
+        if (!frame) return;
+        class speechpy::processing::preemphasis fresh(&source.signal, 1, PREEMPHASIS, rescale);
+        fresh.get_data(f * FRAME_STRIDE, FRAME_LENGTH, expected.data());
+        mismatches += memcmp(frame, expected.data(), FRAME_LENGTH * sizeof(float)) != 0;
+    }
+    CHECK(mismatches == 0, "pre-emphasis%s: %zu of %zu frames differ", rescale ? ", rescaled" : "", mismatches, frames);
+}
+
+static void checkEmpty() {
+    Source source(FRAME_LENGTH - 1, 1);
+    speechpy::processing::frame_reader reader(&source.signal, FRAME_LENGTH, FRAME_STRIDE, 0);
+    const float* frame = nullptr;
+    CHECK(reader.next(&frame) != EIDSP_OK, "a frame out of 0");
+    CHECK(source.calls == 0, "%zu get_data() calls for 0 frames", source.calls);
+}
+
+int main() {
+    printf("test_frame_reader\n");
+    for (size_t perRead : { 1, 2, 3, 8, 100 }) {
+        checkFrames(16000, FRAME_LENGTH, FRAME_STRIDE, perRead);          // The model's window
+        checkFrames(4000 + 80, FRAME_LENGTH, FRAME_STRIDE, perRead);      // A slice and its overlap
+        checkFrames(16000 + 123, FRAME_LENGTH, FRAME_STRIDE, perRead);    // A tail no frame reaches
+        checkFrames(8000, 256, 256, perRead);                             // No overlap
+        checkFrames(8000, 256, 400, perRead);                             // Gaps
+        checkFrames(FRAME_LENGTH, FRAME_LENGTH, FRAME_STRIDE, perRead);   // One frame
+    }
+    for (uint16_t version = 1; version <= 4; version++) {
+        checkLayout(0.025f, 0.02f, version);
+        checkLayout(0.02f, 0.02f, version);
+        checkLayout(0.02f, 0.03f, version);
+        checkLayout(0.032f, 0.016f, version);
+    }
+    checkPreemphasis(false);
+    checkPreemphasis(true);
+    checkEmpty();
+
+    // The model's window, through pre-emphasis as ei_run_dsp.h chains it
+    const size_t frames = frameCount(EI_CLASSIFIER_RAW_SAMPLE_COUNT, FRAME_LENGTH, FRAME_STRIDE);
+    Source source(EI_CLASSIFIER_RAW_SAMPLE_COUNT, 2);
+    std::vector<float> frame(FRAME_LENGTH);
+    volatile float sink = 0.0f;
+    const int windows = 20;
+    double perFrameUs = benchBestUs([&]() {
+        for (int w = 0; w < windows; w++) {
+            class speechpy::processing::preemphasis p(&source.signal, 1, PREEMPHASIS, true);
+            for (size_t f = 0; f < frames; f++) {
+                p.get_data(f * FRAME_STRIDE, FRAME_LENGTH, frame.data());
+                sink = sink + frame[0];
+            }
+        }
+    }, 25);
+    double readerUs = benchBestUs([&]() {
+        for (int w = 0; w < windows; w++) {
+            class speechpy::processing::preemphasis p(&source.signal, 1, PREEMPHASIS, true);
+            signal_t chained;
+            chained.total_length = source.signal.total_length;
+            chained.get_data = [&p](size_t offset, size_t count, float* out) { return p.get_data(offset, count, out); };
+            speechpy::processing::frame_reader reader(&chained, FRAME_LENGTH, FRAME_STRIDE, frames);
+            const float* samples = nullptr;
+            for (size_t f = 0; f < frames; f++) {
+                reader.next(&samples);
+                if (samples) sink = sink + samples[0];
+            }
+        }
+    }, 25);
+    printf("  bench %zu frames: get_data() per frame %.0fk frames/s, frame_reader %.0fk frames/s\n", frames,
+           windows * frames / perFrameUs * 1e3, windows * frames / readerUs * 1e3);
+    CHECK(readerUs < perFrameUs, "frame_reader %.1f us, get_data() per frame %.1f us", readerUs, perFrameUs);
+    return testResult("test_frame_reader");
+}
@@ -0,0 +1,327 @@
+/*
+ * Packed int8 GEMM (kernels/internal/optimized/integer_ops/int8_gemm.h)
+ * against the reference kernels the reference branches of micro/kernels/conv.cpp
+ * and fully_connected.cpp call without it
+ *
+ *   conv        ConvPerChannel() bit for bit reference_integer_ops::ConvPerChannel():
+ *               the model's two layers, then random shapes with padding,
+ *               strides, dilation, depths and channel counts off the block
+ *               sizes, 1x1 convolutions read in place, several batches and
+ *               narrow activation ranges
+ *   fc          FullyConnected() bit for bit reference_integer_ops::FullyConnected(),
+ *               the model's two layers and random shapes, with and without bias
+ *   kernels     every microkernel this CPU runs (portable, SSE4.1, AVX2) gives
+ *               the portable one's accumulators, for any row count
+ *   prepacked   a table entry is only used for the tensor, shape and input
+ *               offset it was packed for, and gives what packing at run time
+ *               gives
+ *   bench       per op on the model's shapes, reference against packed
+ */
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "test.h"
+
+#include <random>
+#include <vector>
+
+using namespace tflite;
+namespace gemm = tflite::optimized_integer_ops::int8_gemm;
+
+static std::mt19937 rng(41);
+
+static int uniform(int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+static void setShape(RuntimeShape& shape, std::initializer_list<int32_t> dims) {
+    std::vector<int32_t> d(dims);
+    shape.ReplaceWith((int)d.size(), d.data());
+}
+
+static std::vector<int8_t> randomInt8(size_t n) {
+    std::vector<int8_t> v(n);
+    for (int8_t& x : v) x = (int8_t)uniform(-128, 127);
+    return v;
+}
+
+// Packed filter storage, 16 byte aligned as PackFilter() wants
+struct Packed {
+    std::vector<int32_t> storage;
+    gemm::PackedFilter filter;
+
+    Packed(const int8_t* weights, const int32_t* bias, int channels, int depth, int32_t inputOffset)
+        : storage(gemm::PackedFilterSize(channels, depth) / sizeof(int32_t) + 4) {
+        uintptr_t base = ((uintptr_t)storage.data() + 15) & ~(uintptr_t)15;
+        filter = gemm::PackFilter(weights, bias, channels, depth, inputOffset, (void*)base);
+    }
+};
+
+struct ConvCase {
+    int batches, inHeight, inWidth, inDepth, outDepth, filterHeight, filterWidth;
+    int strideH, strideW, dilationH, dilationW;
+    bool same;
+    int activationMin, activationMax;
+};
+
+static int outputSize(int in, int filter, int stride, int dilation, bool same) {
+    int effective = (filter - 1) * dilation + 1;
+    return same ? (in + stride - 1) / stride : (in - effective + stride) / stride;
+}
+
+static int padding(int in, int out, int filter, int stride, int dilation, bool same) {
+    int effective = (filter - 1) * dilation + 1;
+    return same ? std::max(0, ((out - 1) * stride + effective - in) / 2) : 0;
+}
+
+// Operands and outputs of the last check, kept for the benchmark
+struct ConvRun {
+    ConvParams params;
+    RuntimeShape input, filter, bias, output;
+    std::vector<int8_t> inputData, filterData, expected, got, im2col;
+    std::vector<int32_t> biasData, multiplier, shift;
+};
+
+// Outputs that differ from the reference; 0 for shapes with no output
+static int checkConv(const ConvCase& c, ConvRun& run) {
+    const int outH = outputSize(c.inHeight, c.filterHeight, c.strideH, c.dilationH, c.same);
+    const int outW = outputSize(c.inWidth, c.filterWidth, c.strideW, c.dilationW, c.same);
+    if (outH <= 0 || outW <= 0) return 0;
+
+    ConvParams& p = run.params;
+    p = ConvParams();
+    p.padding_type = c.same ? PaddingType::kSame : PaddingType::kValid;
+    p.padding_values.height = padding(c.inHeight, outH, c.filterHeight, c.strideH, c.dilationH, c.same);
+    p.padding_values.width = padding(c.inWidth, outW, c.filterWidth, c.strideW, c.dilationW, c.same);
+    p.stride_height = c.strideH;
+    p.stride_width = c.strideW;
+    p.dilation_height_factor = c.dilationH;
+    p.dilation_width_factor = c.dilationW;
+    p.input_offset = uniform(-127, 128);
+    p.weights_offset = 0;
+    p.output_offset = uniform(-128, 127);
+    p.quantized_activation_min = c.activationMin;
+    p.quantized_activation_max = c.activationMax;
+
+    setShape(run.input, { c.batches, c.inHeight, c.inWidth, c.inDepth });
+    setShape(run.filter, { c.outDepth, c.filterHeight, c.filterWidth, c.inDepth });
+    setShape(run.bias, { c.outDepth });
+    setShape(run.output, { c.batches, outH, outW, c.outDepth });
+    run.inputData = randomInt8(run.input.FlatSize());
+    run.filterData = randomInt8(run.filter.FlatSize());
+    run.biasData.resize(c.outDepth);
+    run.multiplier.resize(c.outDepth);
+    run.shift.resize(c.outDepth);
+    for (int oc = 0; oc < c.outDepth; oc++) {
+        run.biasData[oc] = uniform(-20000, 20000);
+        run.multiplier[oc] = uniform(1 << 30, INT32_MAX);
+        run.shift[oc] = uniform(-12, -5);
+    }
+    run.expected.assign(run.output.FlatSize(), 0);
+    run.got.assign(run.output.FlatSize(), 0);
+
+    reference_integer_ops::ConvPerChannel(p, run.multiplier.data(), run.shift.data(), run.input, run.inputData.data(),
+                                          run.filter, run.filterData.data(), run.bias, run.biasData.data(),
+                                          run.output, run.expected.data());
+
+    const int depth = c.filterHeight * c.filterWidth * c.inDepth;
+    Packed packed(run.filterData.data(), run.biasData.data(), c.outDepth, depth, p.input_offset);
+    const int pixels = c.batches * outH * outW;
+    run.im2col.assign(gemm::Im2colNeeded(c.filterHeight, c.filterWidth, c.strideH, c.strideW, c.inDepth)
+                      ? gemm::Im2colBufferSize(pixels, depth) : 0, 0);
+    gemm::ConvPerChannel(p, run.multiplier.data(), run.shift.data(), run.input, run.inputData.data(), run.filter,
+                         packed.filter, run.output, run.got.data(), run.im2col.empty() ? nullptr : run.im2col.data());
+
+    int diffs = 0;
+    for (size_t i = 0; i < run.expected.size(); i++) diffs += run.expected[i] != run.got[i];
+    return diffs;
+}
+
+struct FcRun {
+    FullyConnectedParams params;
+    RuntimeShape input, filter, bias, output;
+    std::vector<int8_t> inputData, filterData, expected, got, rows;
+    std::vector<int32_t> biasData;
+};
+
+// Outputs that differ from the reference
+static int checkFullyConnected(int batches, int depth, int channels, bool withBias, bool relu, FcRun& run) {
+    FullyConnectedParams& p = run.params;
+    p = FullyConnectedParams();
+    p.input_offset = uniform(-127, 128);
+    p.weights_offset = 0;
+    p.output_offset = uniform(-128, 127);
+    p.output_multiplier = uniform(1 << 30, INT32_MAX);
+    p.output_shift = uniform(-12, -5);
+    p.quantized_activation_min = relu ? p.output_offset : -128;
+    p.quantized_activation_max = 127;
+
+    setShape(run.input, { batches, depth });
+    setShape(run.filter, { channels, depth });
+    setShape(run.bias, { channels });
+    setShape(run.output, { batches, channels });
+    run.inputData = randomInt8(batches * depth);
+    run.filterData = randomInt8(channels * depth);
+    run.biasData.resize(channels);
+    for (int32_t& b : run.biasData) b = uniform(-20000, 20000);
+    const int32_t* bias = withBias ? run.biasData.data() : nullptr;
+    run.expected.assign(batches * channels, 0);
+    run.got.assign(batches * channels, 0);
+
+    reference_integer_ops::FullyConnected(p, run.input, run.inputData.data(), run.filter, run.filterData.data(),
+                                          run.bias, bias, run.output, run.expected.data());
+    Packed packed(run.filterData.data(), bias, channels, depth, p.input_offset);
+    run.rows.assign(gemm::FullyConnectedBufferSize(batches, depth), 0);
+    gemm::FullyConnected(p, run.inputData.data(), packed.filter, run.output, run.got.data(),
+                         run.rows.empty() ? nullptr : run.rows.data());
+
+    int diffs = 0;
+    for (size_t i = 0; i < run.expected.size(); i++) diffs += run.expected[i] != run.got[i];
+    return diffs;
+}
+
+static void checkKernels() {
+    std::vector<std::pair<const char*, gemm::KernelFn>> kernels;
+#if EI_INT8_GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) kernels.push_back({ "SSE4.1", gemm::KernelSse41 });
+    if (__builtin_cpu_supports("avx2")) kernels.push_back({ "AVX2", gemm::KernelAvx2 });
+#endif
+    printf("  microkernels checked against the portable one:");
+    for (auto& k : kernels) printf(" %s", k.first);
+    printf("%s\n", kernels.empty() ? " none on this CPU" : "");
+
+    for (int trial = 0; trial < 200; trial++) {
+        const int paddedDepth = gemm::kDepthAlign * uniform(1, 12), rows = uniform(1, gemm::kRowBlock);
+        std::vector<int8_t> data = randomInt8(rows * paddedDepth), block = randomInt8(gemm::kChannelBlock * paddedDepth);
+        // Extremes too: -128 * -128 sums are where 16 bit pair adds would overflow
+        if (trial % 4 == 0) {
+            for (int8_t& x : data) x = -128;
+            for (int8_t& x : block) x = -128;
+        }
+        std::vector<int32_t> expected(rows * gemm::kChannelBlock), got(rows * gemm::kChannelBlock);
+        gemm::KernelPortable(data.data(), rows, block.data(), paddedDepth, expected.data());
+        for (auto& k : kernels) {
+            k.second(data.data(), rows, block.data(), paddedDepth, got.data());
+            CHECK(got == expected, "%s: %d rows x %d depth differ", k.first, rows, paddedDepth);
+        }
+    }
+}
+
+static void checkPrepacked() {
+    const int channels = 8, depth = 39;
+    std::vector<int8_t> filter = randomInt8(channels * depth);
+    std::vector<int32_t> bias(channels, 1234);
+    const int32_t inputOffset = 7;
+    Packed runtime(filter.data(), bias.data(), channels, depth, inputOffset);
+
+    gemm::PrepackedFilter entry = { filter.data(), inputOffset, channels, depth,
+                                    runtime.filter.corrections, runtime.filter.weights };
+    gemm::SetPrepackedFilters(&entry, 1);
+    gemm::PackedFilter found;
+    CHECK(gemm::FindPrepackedFilter(filter.data(), channels, depth, inputOffset, &found), "entry not found");
+    CHECK(found.weights == runtime.filter.weights && found.padded_depth == runtime.filter.padded_depth, "wrong entry");
+    CHECK(!gemm::FindPrepackedFilter(filter.data(), channels, depth, inputOffset + 1, &found),
+          "entry used for another input offset");
+    CHECK(!gemm::FindPrepackedFilter(filter.data(), channels, depth - 1, inputOffset, &found),
+          "entry used for another shape");
+    std::vector<int8_t> copy = filter;
+    CHECK(!gemm::FindPrepackedFilter(copy.data(), channels, depth, inputOffset, &found),
+          "entry used for another filter");
+    gemm::SetPrepackedFilters(nullptr, 0);
+    CHECK(!gemm::FindPrepackedFilter(filter.data(), channels, depth, inputOffset, &found),
+          "entry used after the table was cleared");
+}
+
+int main() {
+    printf("test_int8_gemm\n");
+
+    // tflite_learn_855743_3: two 1x3 SAME convolutions with ReLU, then 208 -> 32 (ReLU) -> 3
+    const ConvCase conv1 = { 1, 1, 49, 13, 8, 1, 3, 1, 1, 1, 1, true, -128, 127 };
+    const ConvCase conv2 = { 1, 1, 25, 8, 16, 1, 3, 1, 1, 1, 1, true, -128, 127 };
+    ConvRun convRun;
+    FcRun fcRun;
+    CHECK(checkConv(conv1, convRun) == 0, "model conv 1 differs");
+    CHECK(checkConv(conv2, convRun) == 0, "model conv 2 differs");
+    CHECK(checkFullyConnected(1, 208, 32, true, true, fcRun) == 0, "model dense 1 differs");
+    CHECK(checkFullyConnected(1, 32, 3, true, false, fcRun) == 0, "model dense 2 differs");
+
+    int convCases = 0, convFailed = 0;
+    for (int trial = 0; trial < 400; trial++) {
+        ConvCase c;
+        c.batches = uniform(1, 3);
+        c.inHeight = uniform(1, 12);
+        c.inWidth = uniform(1, 40);
+        c.inDepth = trial % 5 == 0 ? 16 * uniform(1, 3) : uniform(1, 40);
+        c.outDepth = uniform(1, 23);
+        c.filterHeight = trial % 5 == 0 ? 1 : uniform(1, 4);
+        c.filterWidth = trial % 5 == 0 ? 1 : uniform(1, 5);
+        c.strideH = trial % 5 == 0 ? 1 : uniform(1, 3);
+        c.strideW = trial % 5 == 0 ? 1 : uniform(1, 3);
+        c.dilationH = trial % 3 == 0 ? uniform(1, 3) : 1;
+        c.dilationW = trial % 3 == 0 ? uniform(1, 3) : 1;
+        c.same = uniform(0, 1);
+        c.activationMin = trial % 4 == 0 ? uniform(-128, 0) : -128;
+        c.activationMax = trial % 4 == 0 ? uniform(1, 127) : 127;
+        int diffs = checkConv(c, convRun);
+        convCases += !convRun.expected.empty();
+        if (diffs) {
+            convFailed++;
+            CHECK(false, "%dx%dx%dx%d * %dx%dx%d, stride %dx%d, dilation %dx%d, %s: %d outputs differ", c.batches,
+                  c.inHeight, c.inWidth, c.inDepth, c.outDepth, c.filterHeight, c.filterWidth, c.strideH, c.strideW,
+                  c.dilationH, c.dilationW, c.same ? "SAME" : "VALID", diffs);
+        }
+    }
+    int fcFailed = 0;
+    for (int trial = 0; trial < 200; trial++) {
+        int batches = uniform(1, 40), depth = trial % 4 == 0 ? 16 * uniform(1, 20) : uniform(1, 300);
+        int channels = uniform(1, 70);
+        bool withBias = trial % 3 != 0, relu = trial % 2 == 0;
+        if (int diffs = checkFullyConnected(batches, depth, channels, withBias, relu, fcRun)) {
+            fcFailed++;
+            CHECK(false, "%d x %d -> %d%s: %d outputs differ", batches, depth, channels, withBias ? "" : ", no bias",
+                  diffs);
+        }
+    }
+    printf("  %d random convolutions, %d differ; 200 random dense layers, %d differ\n", convCases, convFailed, fcFailed);
+    checkKernels();
+    checkPrepacked();
+
+    // Per op on the model's shapes, packing (done once at prepare) left out
+    struct { const char* name; ConvCase c; } convs[] = { { "conv 1x3, 49x13 -> 49x8", conv1 },
+                                                          { "conv 1x3, 25x8 -> 25x16", conv2 } };
+    for (auto& op : convs) {
+        checkConv(op.c, convRun);
+        ConvRun& r = convRun;
+        const int depth = op.c.filterHeight * op.c.filterWidth * op.c.inDepth;
+        Packed packed(r.filterData.data(), r.biasData.data(), op.c.outDepth, depth, r.params.input_offset);
+        double refUs = benchUs([&]() {
+            reference_integer_ops::ConvPerChannel(r.params, r.multiplier.data(), r.shift.data(), r.input,
+                                                  r.inputData.data(), r.filter, r.filterData.data(), r.bias,
+                                                  r.biasData.data(), r.output, r.expected.data());
+        });
+        double gemmUs = benchUs([&]() {
+            gemm::ConvPerChannel(r.params, r.multiplier.data(), r.shift.data(), r.input, r.inputData.data(), r.filter,
+                                 packed.filter, r.output, r.got.data(), r.im2col.empty() ? nullptr : r.im2col.data());
+        });
+        printf("  bench %-26s reference %6.2f us, packed %6.2f us (%.1fx)\n", op.name, refUs, gemmUs, refUs / gemmUs);
+    }
+    struct { const char* name; int depth, channels; bool relu; } fcs[] = { { "dense 208 -> 32", 208, 32, true },
+                                                                          { "dense 32 -> 3", 32, 3, false } };
+    for (auto& op : fcs) {
+        checkFullyConnected(1, op.depth, op.channels, true, op.relu, fcRun);
+        FcRun& r = fcRun;
+        Packed packed(r.filterData.data(), r.biasData.data(), op.channels, op.depth, r.params.input_offset);
+        double refUs = benchUs([&]() {
+            reference_integer_ops::FullyConnected(r.params, r.input, r.inputData.data(), r.filter, r.filterData.data(),
+                                                  r.bias, r.biasData.data(), r.output, r.expected.data());
+        });
+        double gemmUs = benchUs([&]() {
+            gemm::FullyConnected(r.params, r.inputData.data(), packed.filter, r.output, r.got.data(),
+                                 r.rows.empty() ? nullptr : r.rows.data());
+        });
+        printf("  bench %-26s reference %6.2f us, packed %6.2f us (%.1fx)\n", op.name, refUs, gemmUs, refUs / gemmUs);
+    }
+    return testResult("test_int8_gemm");
+}
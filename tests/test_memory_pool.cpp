@@ -0,0 +1,112 @@
+/*
+ * The firmware's pool table (src/memory_pool.cpp) reserved from the mock heap
+ * of tests/mock, with the config.h the firmware builds with
+ *
+ *   budget      on an ESP32-S3 with PSRAM, every pool is reserved in its
+ *               preferred region, 16-byte aligned, and the totals per region
+ *               fit POOL_INTERNAL_BUDGET and POOL_PSRAM_BUDGET
+ *   no psram    a board without PSRAM takes PSRAM pools from internal memory
+ *               and marks them fallback; if they don't fit, begin fails
+ *   checkout    one user at a time, failures counted, checkin frees the slot
+ */
+
+#include "memory_pool.cpp"
+#include "test.h"
+
+#include <string.h>
+
+static void resetPools() {
+    for (int i = 0; i < POOL_COUNT; i++) {
+        free(memoryPools[i].base);
+        memoryPools[i].base = nullptr;
+        memoryPools[i].inUse = false;
+        memoryPools[i].fallback = false;
+        memoryPools[i].checkouts = 0;
+        memoryPools[i].failures = 0;
+    }
+}
+
+static void checkBudget() {
+    resetPools();
+    mockHeap.reset(POOL_INTERNAL_BUDGET, POOL_PSRAM_BUDGET);
+    CHECK(memoryPoolsBegin(), "pools don't fit the budget");
+
+    size_t internal = 0, psram = 0;
+    for (int i = 0; i < POOL_COUNT; i++) {
+        const PoolSlot& slot = memoryPools[i];
+        CHECK(slot.base && ((uintptr_t)slot.base % POOL_ALIGN) == 0, "'%s' at %p", slot.name, slot.base);
+        CHECK(!slot.fallback, "'%s' outside its region", slot.name);
+        CHECK(slot.size > 0 && slot.size % 2 == 0, "'%s' is %zu bytes, not whole samples", slot.name, slot.size);
+        (slot.caps == POOL_CAPS_PSRAM ? psram : internal) += slot.size;
+    }
+    CHECK(mockHeap.misaligned == 0, "alignment not a power of two");
+    CHECK(mockHeap.internal.failures == 0 && mockHeap.spiram.failures == 0, "reservations failed");
+    CHECK(internal == mockHeap.internal.total - mockHeap.internal.available, "internal: %zu bytes in the table, %zu taken",
+          internal, mockHeap.internal.total - mockHeap.internal.available);
+    CHECK(psram == mockHeap.spiram.total - mockHeap.spiram.available, "PSRAM: %zu bytes in the table, %zu taken", psram,
+          mockHeap.spiram.total - mockHeap.spiram.available);
+    CHECK(internal <= POOL_INTERNAL_BUDGET, "internal pools %zu > %d", internal, POOL_INTERNAL_BUDGET);
+    CHECK(psram <= POOL_PSRAM_BUDGET, "PSRAM pools %zu > %d", psram, POOL_PSRAM_BUDGET);
+
+    // The users' own limits
+    CHECK(memoryPoolSize(POOL_WAKE_SLICE_0) >= EI_CLASSIFIER_SLICE_SIZE * sizeof(int16_t), "wake slice too small");
+    CHECK(memoryPoolSize(POOL_STREAM_STEREO) == 2 * memoryPoolSize(POOL_STREAM_CHUNK), "stereo not twice the chunk");
+    printf("  internal %6zu of %6d bytes, PSRAM %7zu of %7d bytes\n", internal, POOL_INTERNAL_BUDGET, psram,
+           POOL_PSRAM_BUDGET);
+
+    // A second begin() keeps what it has
+    uint32_t requests = mockHeap.internal.requests + mockHeap.spiram.requests;
+    CHECK(memoryPoolsBegin(), "second begin failed");
+    CHECK(mockHeap.internal.requests + mockHeap.spiram.requests == requests, "second begin reserved again");
+}
+
+static void checkNoPsram() {
+    size_t total = 0;
+    for (int i = 0; i < POOL_COUNT; i++) total += memoryPools[i].size;
+
+    // Internal big enough for everything: PSRAM pools fall back
+    resetPools();
+    mockHeap.reset(total, 0);
+    CHECK(memoryPoolsBegin(), "no fallback to internal memory");
+    for (int i = 0; i < POOL_COUNT; i++) {
+        const PoolSlot& slot = memoryPools[i];
+        CHECK(slot.base && slot.fallback == (slot.caps == POOL_CAPS_PSRAM), "'%s': fallback %d", slot.name,
+              slot.fallback);
+    }
+
+    // It isn't: begin reports it, what fits is still reserved
+    resetPools();
+    mockHeap.reset(POOL_INTERNAL_BUDGET, 0);
+    printf("  without PSRAM:\n");
+    CHECK(!memoryPoolsBegin(), "begin succeeded without room for the PSRAM pools");
+    CHECK(memoryPools[POOL_WAKE_SLICE_0].base && !memoryPools[POOL_RECORD].base, "wrong pools reserved");
+}
+
+static void checkCheckout() {
+    resetPools();
+    mockHeap.reset(POOL_INTERNAL_BUDGET, POOL_PSRAM_BUDGET);
+    memoryPoolsBegin();
+
+    uint8_t* a = memoryPoolCheckout(POOL_STREAM_CHUNK);
+    CHECK(a == memoryPools[POOL_STREAM_CHUNK].base, "checkout gave %p", a);
+    CHECK(memoryPoolCheckout(POOL_STREAM_CHUNK) == nullptr, "checked out twice");
+    CHECK(memoryPools[POOL_STREAM_CHUNK].failures == 1, "failure not counted");
+    memoryPoolCheckin(POOL_STREAM_CHUNK);
+    CHECK(memoryPoolCheckout(POOL_STREAM_CHUNK) == a, "not available after checkin");
+    CHECK(memoryPools[POOL_STREAM_CHUNK].checkouts == 2, "%u checkouts", memoryPools[POOL_STREAM_CHUNK].checkouts);
+    memoryPoolCheckin(POOL_STREAM_CHUNK);
+
+    // Never reserved
+    free(memoryPools[POOL_STREAM_PREFILL].base);
+    memoryPools[POOL_STREAM_PREFILL].base = nullptr;
+    CHECK(memoryPoolCheckout(POOL_STREAM_PREFILL) == nullptr, "checked out an unreserved pool");
+}
+
+int main() {
+    printf("test_memory_pool\n");
+    checkBudget();
+    checkNoPsram();
+    checkCheckout();
+    resetPools();
+    return testResult("test_memory_pool");
+}
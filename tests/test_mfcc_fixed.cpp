@@ -0,0 +1,162 @@
+/*
+ * Compile-time MFCC engine (dsp/speechpy/mfcc_fixed.hpp) against
+ * speechpy::feature::mfcc() with DC elimination, at the model's DSP config
+ *
+ *   golden      per signal and length, every coefficient of every frame: c0
+ *               (log frame energy) bit for bit, the DCT within 1e-5 of the
+ *               reference (relative above 1)
+ *   config      matches() takes the model's runtime config and nothing else;
+ *               frame counts agree with calculate_mfcc_buffer_size()
+ *   bench       one slice and one model window, both engines
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "host_porting.h"
+#include "test.h"
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+#if !EI_CLASSIFIER_MFCC_FIXED
+#error "The model's DSP config has no compile-time MFCC engine"
+#endif
+
+static const ei_dsp_config_mfcc_t& config = ei_dsp_config_855743_2;
+
+struct Signal {
+    const char* name;
+    std::vector<float> samples;
+};
+
+static std::vector<Signal> signals() {
+    std::mt19937 rng(35);
+    std::vector<Signal> out;
+    const size_t n = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+
+    for (float level : { 30.0f, 3000.0f }) {
+        std::normal_distribution<float> noise(0.0f, level);
+        Signal s = { level < 100.0f ? "quiet noise" : "loud noise", std::vector<float>(n) };
+        for (float& x : s.samples) x = noise(rng);
+        out.push_back(s);
+    }
+    out.push_back({ "silence", std::vector<float>(n, 0.0f) });
+
+    // 8x gain on a 1 kHz tone wraps like the firmware's fixed wake word gain
+    Signal clipped = { "clipped tone", std::vector<float>(n) };
+    for (size_t i = 0; i < n; i++) clipped.samples[i] = (float)(int16_t)(int32_t)(8 * 12000.0 * sin(2 * M_PI * 1000.0 * i / 16000.0));
+    out.push_back(clipped);
+
+    // 100 Hz to 7.9 kHz, across every filter
+    Signal chirp = { "chirp", std::vector<float>(n) };
+    for (size_t i = 0; i < n; i++) {
+        double t = (double)i / 16000.0, seconds = (double)n / 16000.0;
+        chirp.samples[i] = (float)(10000.0 * sin(2 * M_PI * (100.0 * t + (7800.0 / (2 * seconds)) * t * t)));
+    }
+    out.push_back(chirp);
+    return out;
+}
+
+static signal_t signalOf(const float* samples, size_t length) {
+    signal_t signal;
+    signal.total_length = length;
+    signal.get_data = [samples](size_t offset, size_t count, float* out) {
+        memcpy(out, samples + offset, count * sizeof(float));
+        return 0;
+    };
+    return signal;
+}
+
+static int reference(matrix_t* out, const float* samples, size_t length) {
+    signal_t signal = signalOf(samples, length);
+    return speechpy::feature::mfcc(out, &signal, EI_CLASSIFIER_FREQUENCY, config.frame_length, config.frame_stride,
+                                   config.num_cepstral, config.num_filters, config.fft_length, config.low_frequency,
+                                   config.high_frequency, true, config.implementation_version);
+}
+
+static int fixed(matrix_t* out, const float* samples, size_t length) {
+    signal_t signal = signalOf(samples, length);
+    return mfcc_fixed_t::mfcc(out, &signal, config.implementation_version);
+}
+
+static void checkGolden(const Signal& s, size_t length) {
+    matrix_size_t size = speechpy::feature::calculate_mfcc_buffer_size(length, EI_CLASSIFIER_FREQUENCY,
+        config.frame_length, config.frame_stride, config.num_cepstral, config.implementation_version);
+    CHECK((int32_t)size.rows == mfcc_fixed_t::frame_count(length, config.implementation_version),
+          "%zu samples: %u frames, the engine counts %d", length, size.rows,
+          (int)mfcc_fixed_t::frame_count(length, config.implementation_version));
+
+    matrix_t expected(size.rows, size.cols), got(size.rows, size.cols);
+    CHECK(reference(&expected, s.samples.data(), length) == EIDSP_OK, "%s: reference failed", s.name);
+    CHECK(fixed(&got, s.samples.data(), length) == EIDSP_OK, "%s: engine failed", s.name);
+
+    int c0Diffs = 0;
+    double worst = 0.0;
+    for (uint32_t f = 0; f < size.rows; f++) {
+        for (uint32_t c = 0; c < size.cols; c++) {
+            float ref = expected.buffer[f * size.cols + c], value = got.buffer[f * size.cols + c];
+            if (c == 0) c0Diffs += memcmp(&ref, &value, sizeof(float)) != 0;
+            else worst = fmax(worst, fabs((double)value - ref) / fmax(1.0, fabs(ref)));
+        }
+    }
+    printf("  %-12s %5zu samples  %2u frames  c0 %s  DCT within %.1e\n", s.name, length, size.rows,
+           c0Diffs ? "differs" : "exact", worst);
+    CHECK(c0Diffs == 0, "%s, %zu samples: c0 differs in %d frames", s.name, length, c0Diffs);
+    CHECK(worst <= 1e-5, "%s, %zu samples: DCT off by %.2e", s.name, length, worst);
+}
+
+static void checkConfig() {
+    auto matches = [](uint32_t frequency, float frameLength, float frameStride, uint16_t cepstral, uint16_t filters,
+                      uint16_t fft, uint32_t low, uint32_t high, uint16_t version) {
+        return mfcc_fixed_t::matches(frequency, frameLength, frameStride, cepstral, filters, fft, low, high, version);
+    };
+    const ei_dsp_config_mfcc_t& c = config;
+    CHECK(matches(EI_CLASSIFIER_FREQUENCY, c.frame_length, c.frame_stride, c.num_cepstral, c.num_filters,
+                  c.fft_length, c.low_frequency, c.high_frequency, c.implementation_version), "model config rejected");
+    CHECK(!matches(8000, c.frame_length, c.frame_stride, c.num_cepstral, c.num_filters,
+                   c.fft_length, c.low_frequency, c.high_frequency, c.implementation_version), "8 kHz taken");
+    CHECK(!matches(EI_CLASSIFIER_FREQUENCY, 0.032f, c.frame_stride, c.num_cepstral, c.num_filters,
+                   c.fft_length, c.low_frequency, c.high_frequency, c.implementation_version), "frame length taken");
+    CHECK(!matches(EI_CLASSIFIER_FREQUENCY, c.frame_length, 0.01f, c.num_cepstral, c.num_filters,
+                   c.fft_length, c.low_frequency, c.high_frequency, c.implementation_version), "frame stride taken");
+    CHECK(!matches(EI_CLASSIFIER_FREQUENCY, c.frame_length, c.frame_stride, 12, c.num_filters,
+                   c.fft_length, c.low_frequency, c.high_frequency, c.implementation_version), "cepstra taken");
+    CHECK(!matches(EI_CLASSIFIER_FREQUENCY, c.frame_length, c.frame_stride, c.num_cepstral, 40,
+                   c.fft_length, c.low_frequency, c.high_frequency, c.implementation_version), "filters taken");
+    CHECK(!matches(EI_CLASSIFIER_FREQUENCY, c.frame_length, c.frame_stride, c.num_cepstral, c.num_filters,
+                   c.fft_length, 0, c.high_frequency, c.implementation_version), "low frequency 0 taken");
+    CHECK(!matches(EI_CLASSIFIER_FREQUENCY, c.frame_length, c.frame_stride, c.num_cepstral, c.num_filters,
+                   c.fft_length, c.low_frequency, c.high_frequency, 3), "version 3 filterbank taken");
+    // high_frequency 0 means half the sampling frequency, as in feature::mfcc()
+    CHECK(matches(EI_CLASSIFIER_FREQUENCY, c.frame_length, c.frame_stride, c.num_cepstral, c.num_filters,
+                  c.fft_length, c.low_frequency, 0, c.implementation_version) == (c.high_frequency == EI_CLASSIFIER_FREQUENCY / 2),
+          "high frequency 0 not defaulted");
+
+    // Too short for a single frame
+    std::vector<float> tooShort(EI_CLASSIFIER_MFCC_FIXED_FRAME_LENGTH - EI_CLASSIFIER_MFCC_FIXED_FRAME_STRIDE - 1);
+    matrix_t out(1, c.num_cepstral);
+    CHECK(fixed(&out, tooShort.data(), tooShort.size()) != EIDSP_OK, "%zu samples gave a frame", tooShort.size());
+}
+
+int main() {
+    printf("test_mfcc_fixed\n");
+    std::vector<Signal> all = signals();
+    for (const Signal& s : all) {
+        checkGolden(s, EI_CLASSIFIER_SLICE_SIZE);
+        checkGolden(s, EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+    }
+    checkConfig();
+
+    // Per call, as run_classifier_continuous() (one slice) and run_classifier() (one window) call it
+    const Signal& noise = all[1];
+    for (size_t length : { (size_t)EI_CLASSIFIER_SLICE_SIZE, (size_t)EI_CLASSIFIER_RAW_SAMPLE_COUNT }) {
+        matrix_size_t size = speechpy::feature::calculate_mfcc_buffer_size(length, EI_CLASSIFIER_FREQUENCY,
+            config.frame_length, config.frame_stride, config.num_cepstral, config.implementation_version);
+        matrix_t out(size.rows, size.cols);
+        double refUs = benchUs([&]() { reference(&out, noise.samples.data(), length); });
+        double fixedUs = benchUs([&]() { fixed(&out, noise.samples.data(), length); });
+        printf("  bench %5zu samples: speechpy %7.1f us, mfcc_fixed %7.1f us (%.1fx)\n", length, refUs, fixedUs,
+               refUs / fixedUs);
+    }
+    return testResult("test_mfcc_fixed");
+}
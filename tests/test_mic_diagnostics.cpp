@@ -0,0 +1,174 @@
+/*
+ * Mic diagnostics (src/mic_diagnostics.h) at the firmware's mic test settings,
+ * on synthetic mic input fed in micTest()'s 512 sample reads
+ *
+ *   floor       white noise under bursts of louder speech-like noise: the
+ *               floor reads the noise within 1 dB, the bursts don't count
+ *   tone        50, 60, 100 and 120 Hz hum under the same bursts read within
+ *               4 Hz (an eighth of a bin) and flagged, a floor without one isn't
+ *   dc          a 3000 count offset is flagged and leaves the floor where the
+ *               same noise without it puts it
+ *   flags       a clipping and a dead input raise their flags, a healthy one none
+ *   alloc       process() and report() make no heap allocations
+ *   bench       time per FFT frame on this host
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "host_porting.h"
+#include "test.h"
+#include "mic_diagnostics.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp and src/config.h
+
+#define SAMPLE_RATE             16000
+#define SILENCE_THRESHOLD       200
+#define MIC_TEST_READ_SAMPLES   512
+#define MIC_TEST_CLIP_LEVEL     32000
+#define MIC_TEST_DEAD_PEAK      100
+#define MIC_TEST_MAX_DC         1000
+
+static const MicDiagConfig diagConfig = { SAMPLE_RATE, MIC_TEST_CLIP_LEVEL, MIC_TEST_DEAD_PEAK, MIC_TEST_MAX_DC,
+                                          SILENCE_THRESHOLD };
+
+#define SECONDS                 10
+
+static int16_t saturate(double x) {
+    return x > 32767.0 ? 32767 : x < -32768.0 ? -32768 : (int16_t)lrint(x);
+}
+
+struct Input {
+    double noiseRms = 0.0;      // White
+    double humHz = 0.0;
+    double humRms = 0.0;
+    double dc = 0.0;
+    double burstRms = 0.0;      // Every other half second
+    double gain = 1.0;          // Before saturation, to clip
+};
+
+static std::vector<int16_t> synthesize(const Input& in, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::vector<int16_t> out(SECONDS * SAMPLE_RATE);
+    for (size_t i = 0; i < out.size(); i++) {
+        double t = (double)i / SAMPLE_RATE;
+        double x = in.dc + in.noiseRms * gauss(rng) + in.humRms * sqrt(2.0) * sin(2.0 * M_PI * in.humHz * t);
+        if (fmod(t, 1.0) >= 0.5) x += in.burstRms * gauss(rng);
+        out[i] = saturate(in.gain * x);
+    }
+    return out;
+}
+
+// The diagnostics are 18 KB on this host, so on the heap as micTest() puts them in a pool
+static MicDiagReport analyse(const std::vector<int16_t>& samples) {
+    std::unique_ptr<MicDiagnostics> diag(new MicDiagnostics());
+    CHECK(diag->begin(diagConfig), "config rejected");
+    for (size_t pos = 0; pos < samples.size(); pos += MIC_TEST_READ_SAMPLES) {
+        size_t count = std::min((size_t)MIC_TEST_READ_SAMPLES, samples.size() - pos);
+        diag->process(&samples[pos], count);
+    }
+    MicDiagReport r = diag->report();
+    CHECK(r.fftErrors == 0, "%u FFT errors", r.fftErrors);
+    return r;
+}
+
+static void checkFloor() {
+    for (double rms : { 30.0, 100.0, 400.0 }) {
+        Input in;
+        in.noiseRms = rms;
+        in.burstRms = 3000.0;
+        MicDiagReport r = analyse(synthesize(in, (uint32_t)rms));
+        float expected = micDiagDbfs((float)rms);
+        CHECK(fabsf(r.floorDbfs - expected) <= 1.0f, "noise at %.1f dBFS: floor %.1f dBFS", expected, r.floorDbfs);
+        CHECK(!(r.flags & MIC_DIAG_TONE), "noise at %.1f dBFS: tone at %.1f Hz", expected, r.toneHz);
+        bool noisy = rms > SILENCE_THRESHOLD;
+        CHECK(!!(r.flags & MIC_DIAG_NOISY) == noisy, "noise at %.0f RMS: noisy flag %s", rms,
+              noisy ? "missing" : "raised");
+        printf("  noise %6.1f dBFS: floor %6.1f dBFS\n", expected, r.floorDbfs);
+    }
+}
+
+static void checkTone() {
+    for (double hz : { 50.0, 60.0, 100.0, 120.0 }) {
+        Input in;
+        in.noiseRms = 30.0;
+        in.humHz = hz;
+        in.humRms = 300.0;
+        in.burstRms = 3000.0;
+        MicDiagReport r = analyse(synthesize(in, (uint32_t)hz));
+        CHECK(r.flags & MIC_DIAG_TONE, "%.0f Hz hum not flagged (%.1f dB over its neighbours)", hz, r.toneDb);
+        // Exact without the bursts; with them the per-bin minima come from different
+        // frames, which pulls the estimate by up to 3.3 Hz (120 Hz)
+        CHECK(fabs(r.toneHz - hz) <= 4.0, "%.0f Hz hum read as %.1f Hz", hz, r.toneHz);
+        printf("  hum %5.1f Hz: read %5.1f Hz, %4.1f dB over the floor\n", hz, r.toneHz, r.toneDb);
+    }
+}
+
+static void checkDc() {
+    Input in;
+    in.noiseRms = 30.0;
+    MicDiagReport clean = analyse(synthesize(in, 5));
+    in.dc = 3000.0;
+    MicDiagReport r = analyse(synthesize(in, 5));
+    CHECK(r.flags & MIC_DIAG_DC, "3000 DC offset not flagged (%.1f)", r.dcOffset);
+    CHECK(fabsf(r.dcOffset - 3000.0f) < 10.0f, "DC offset read as %.1f", r.dcOffset);
+    // Without bursts the floor is the minimum over all 10 s and reads ~3 dB under
+    // the noise, so compare with the same noise and no offset
+    CHECK(fabsf(r.floorDbfs - clean.floorDbfs) <= 0.1f, "DC leaks into the floor: %.1f dBFS, %.1f without",
+          r.floorDbfs, clean.floorDbfs);
+    CHECK(!(r.flags & (MIC_DIAG_NOISY | MIC_DIAG_TONE)), "DC offset raised flags %#x", r.flags);
+}
+
+static void checkFlags() {
+    Input healthy;
+    healthy.noiseRms = 30.0;
+    healthy.burstRms = 3000.0;
+    MicDiagReport r = analyse(synthesize(healthy, 6));
+    CHECK(r.flags == 0, "healthy mic: flags %#x", r.flags);
+
+    Input loud = healthy;
+    loud.gain = 12.0;
+    r = analyse(synthesize(loud, 7));
+    CHECK(r.flags & MIC_DIAG_CLIPPING, "clipping not flagged (%u of %u samples)", r.clipped, r.samples);
+
+    Input dead;
+    dead.noiseRms = 3.0;
+    r = analyse(synthesize(dead, 8));
+    CHECK(r.flags & MIC_DIAG_DEAD, "dead mic not flagged (peak %.1f dBFS)", r.peakDbfs);
+}
+
+static void checkAllocations() {
+    Input in;
+    in.noiseRms = 100.0;
+    std::vector<int16_t> samples = synthesize(in, 9);
+    std::unique_ptr<MicDiagnostics> diag(new MicDiagnostics());
+    diag->begin(diagConfig);
+    size_t before = hostAllocations;
+    diag->process(samples.data(), samples.size());
+    diag->report();
+    CHECK(hostAllocations == before, "%zu heap allocations over %d s", hostAllocations - before, SECONDS);
+}
+
+int main() {
+    printf("test_mic_diagnostics\n");
+    checkFloor();
+    checkTone();
+    checkDc();
+    checkFlags();
+    checkAllocations();
+
+    Input in;
+    in.noiseRms = 100.0;
+    std::vector<int16_t> samples = synthesize(in, 10);
+    std::unique_ptr<MicDiagnostics> diag(new MicDiagnostics());
+    diag->begin(diagConfig);
+    const size_t frames = samples.size() / MIC_DIAG_FFT;
+    double us = benchUs([&]() { diag->process(samples.data(), frames * MIC_DIAG_FFT); });
+    printf("  bench %-40s %10.2f us\n", "mic diagnostics, per frame", us / frames);
+    return testResult("test_mic_diagnostics");
+}
@@ -0,0 +1,271 @@
+/*
+ * Noise suppressor (src/noise_suppressor.h) and the real FFT it runs on
+ * (src/real_fft.h), at the firmware's settings
+ *
+ *   fft         RealFft gives ei::numpy::rfft()'s bins bit for bit, without
+ *               its heap allocations
+ *   alloc       process() makes no heap allocations
+ *   snr         synthetic voiced speech in fan and hum noise at 0 and 5 dB,
+ *               after a warm-up on noise alone and restart() as between turns:
+ *               SNR and segmental SNR go up, noise-only stretches go down
+ *   clean       speech without noise comes out close to as it went in
+ *   bench       time per frame on this host
+ *
+ * The speech and noise are synthetic (tools/ns_eval runs recordings), so the
+ * bounds sit a few dB under what this gives, to catch a suppressor that broke
+ * rather than to grade one.
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "host_porting.h"
+#include "test.h"
+#include "noise_suppressor.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp
+
+#define SAMPLE_RATE             16000
+#define NS_NOISE_WINDOW_MS      1500
+#define NS_OVERESTIMATE         2.0f
+#define NS_FLOOR_DB             -15.0f
+#define NS_SMOOTHING            0.98f
+#define SILENCE_THRESHOLD       200
+#define RECORD_READ_SAMPLES     512     // recordAudio()'s 1024 byte reads
+
+static const NoiseSuppressorConfig nsConfig = { SAMPLE_RATE, NS_NOISE_WINDOW_MS, NS_OVERESTIMATE, NS_FLOOR_DB,
+                                                NS_SMOOTHING };
+
+#define SEGMENT                 320     // 20ms
+#define MIN_CLEAN_SNR_DB        14.0    // Gives 16.6
+
+// Two-pole resonator, a formant
+struct Resonator {
+    float y1 = 0.0f, y2 = 0.0f;
+    float step(float x, float freq, float radius) {
+        float y = x + 2.0f * radius * cosf(2.0f * (float)M_PI * freq / SAMPLE_RATE) * y1 - radius * radius * y2;
+        y2 = y1;
+        y1 = y;
+        return y * (1.0f - radius);
+    }
+};
+
+// Voiced syllables: a wandering glottal pulse train through two formants, with pauses
+static std::vector<float> speech(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<float> out(count);
+    Resonator r1, r2;
+    float f0 = 140.0f, f1 = 600.0f, f2 = 1500.0f, level = 0.0f, target = 0.0f, phase = 0.0f;
+    size_t next = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == next) {
+            bool pause = uniform(rng) < 0.3f;
+            target = pause ? 0.0f : 0.5f + 0.5f * uniform(rng);
+            f0 = 110.0f + 80.0f * uniform(rng);
+            f1 = 300.0f + 600.0f * uniform(rng);
+            f2 = 1000.0f + 1500.0f * uniform(rng);
+            next += (size_t)(SAMPLE_RATE * (pause ? 0.15f + 0.3f * uniform(rng) : 0.15f + 0.2f * uniform(rng)));
+        }
+        level += (target - level) * 0.003f;
+        phase += f0 / SAMPLE_RATE;
+        float pulse = 0.0f;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+            pulse = 1.0f;
+        }
+        out[i] = 8000.0f * level * (r1.step(pulse, f1, 0.97f) + 0.6f * r2.step(pulse, f2, 0.95f));
+    }
+    return out;
+}
+
+static std::vector<float> noise(bool fan, size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    std::vector<float> out(count);
+    float rumble = 0.0f, phase = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        if (fan) {
+            // Rumble, broadband air and the blade pass tone
+            rumble = 0.995f * rumble + gauss(rng);
+            phase += 2.0f * (float)M_PI * 87.0f / SAMPLE_RATE;
+            out[i] = 0.1f * rumble + gauss(rng) + 0.8f * (sinf(phase) + 0.5f * sinf(2 * phase));
+        } else {
+            // Mains hum and its odd harmonics, a little hiss
+            phase += 2.0f * (float)M_PI * 50.0f / SAMPLE_RATE;
+            float hum = 0.0f;
+            for (int h = 1; h <= 7; h += 2) hum += sinf(h * phase) / h;
+            out[i] = 2.0f * hum + 0.3f * gauss(rng);
+        }
+    }
+    return out;
+}
+
+static int16_t saturate(float x) {
+    return x > 32767.0f ? 32767 : x < -32768.0f ? -32768 : (int16_t)lrintf(x);
+}
+
+static double power(const std::vector<float>& x, size_t from, size_t to) {
+    double sum = 0.0;
+    for (size_t i = from; i < to; i++) sum += (double)x[i] * x[i];
+    return sum / (to - from);
+}
+
+// recordAudio()'s reads, then the flush; returns the output lined up with the input
+static std::vector<int16_t> suppress(NoiseSuppressor& ns, const std::vector<int16_t>& in) {
+    std::vector<int16_t> out(in.size() + NS_FRAME);
+    for (size_t pos = 0; pos < in.size(); pos += RECORD_READ_SAMPLES) {
+        size_t count = std::min((size_t)RECORD_READ_SAMPLES, in.size() - pos);
+        ns.process(&in[pos], &out[pos], count);
+    }
+    ns.flush(&out[in.size()], NS_FRAME);
+    return std::vector<int16_t>(out.begin() + NS_FRAME, out.end());
+}
+
+struct Quality {
+    double snr = 0.0;           // dB, over the whole recording
+    double segSnr = 0.0;        // dB, mean over speech segments, clamped to -10..35
+    double noise = 0.0;         // Mean power over the noise-only segments
+};
+
+static Quality quality(const std::vector<int16_t>& clean, const std::vector<int16_t>& signal) {
+    Quality q;
+    double c = 0.0, e = 0.0;
+    size_t segments = 0, noiseSegments = 0;
+    for (size_t s = 0; s + SEGMENT <= clean.size(); s += SEGMENT) {
+        double sc = 0.0, se = 0.0;
+        for (size_t i = s; i < s + SEGMENT; i++) {
+            double d = (double)signal[i] - clean[i];
+            sc += (double)clean[i] * clean[i];
+            se += d * d;
+        }
+        c += sc;
+        e += se;
+        if (sc / SEGMENT > (double)SILENCE_THRESHOLD * SILENCE_THRESHOLD) {
+            double snr = 10.0 * log10((sc + 1e-9) / (se + 1e-9));
+            q.segSnr += snr < -10.0 ? -10.0 : snr > 35.0 ? 35.0 : snr;
+            segments++;
+        } else {
+            for (size_t i = s; i < s + SEGMENT; i++) q.noise += (double)signal[i] * signal[i];
+            noiseSegments++;
+        }
+    }
+    q.snr = 10.0 * log10(c / (e + 1e-9));
+    q.segSnr = segments ? q.segSnr / segments : 0.0;
+    q.noise = noiseSegments ? q.noise / (noiseSegments * SEGMENT) : 0.0;
+    return q;
+}
+
+static void checkFft() {
+    RealFft<NS_FRAME> fft;
+    CHECK(fft.begin(), "no FFT");
+    std::mt19937 rng(49);
+    std::normal_distribution<float> gauss(0.0f, 3000.0f);
+    std::vector<float> frame(NS_FRAME);
+    ei::fft_complex_t direct[NS_BINS], numpy[NS_BINS];
+    size_t mismatches = 0, directAllocations = 0, numpyAllocations = 0;
+    for (int f = 0; f < 100; f++) {
+        for (float& x : frame) x = gauss(rng);
+        size_t before = hostAllocations;
+        CHECK(fft.forward(frame.data(), direct), "forward failed");
+        directAllocations += hostAllocations - before;
+        before = hostAllocations;
+        CHECK(ei::numpy::rfft(frame.data(), NS_FRAME, numpy, NS_BINS, NS_FRAME) == ei::EIDSP_OK, "rfft failed");
+        numpyAllocations += hostAllocations - before;
+        mismatches += memcmp(direct, numpy, sizeof(direct)) != 0;
+    }
+    CHECK(mismatches == 0, "%zu of 100 frames differ from ei::numpy::rfft()", mismatches);
+    CHECK(directAllocations == 0, "RealFft: %zu heap allocations", directAllocations);
+    printf("  heap allocations per frame: ei::numpy::rfft() %zu, RealFft %zu\n", numpyAllocations / 100,
+           directAllocations / 100);
+}
+
+static void checkAllocations() {
+    NoiseSuppressor ns;
+    CHECK(ns.begin(nsConfig), "config rejected");
+    std::vector<float> x = noise(true, 2 * SAMPLE_RATE, 1);
+    std::vector<int16_t> in(x.size()), out(x.size());
+    for (size_t i = 0; i < x.size(); i++) in[i] = saturate(300.0f * x[i]);
+    size_t before = hostAllocations;
+    ns.process(in.data(), out.data(), in.size());
+    CHECK(hostAllocations == before, "process(): %zu heap allocations", hostAllocations - before);
+    CHECK(ns.stats().fftErrors == 0, "%u FFT errors", ns.stats().fftErrors);
+}
+
+// What a case must gain, in dB
+struct SnrCase {
+    bool fan;
+    double snrDb;
+    double snr;
+    double segSnr;
+    double noise;           // Down by
+};
+
+static void checkSnr(const SnrCase& c) {
+    const bool fan = c.fan;
+    const double snrDb = c.snrDb;
+    const size_t warmup = 2 * SAMPLE_RATE, length = 8 * SAMPLE_RATE;
+    std::vector<float> s = speech(length, 7), n = noise(fan, warmup + length, fan ? 2 : 3);
+    double scale = sqrt(power(s, 0, length) / power(n, 0, n.size()) / pow(10.0, snrDb / 10.0));
+
+    std::vector<int16_t> lead(warmup), clean(length), mix(length);
+    for (size_t i = 0; i < warmup; i++) lead[i] = saturate((float)(scale * n[i]));
+    for (size_t i = 0; i < length; i++) {
+        clean[i] = saturate(s[i]);
+        mix[i] = saturate((float)(s[i] + scale * n[warmup + i]));
+    }
+    NoiseSuppressor ns;
+    ns.begin(nsConfig);
+    suppress(ns, lead);
+    ns.restart();
+    std::vector<int16_t> out = suppress(ns, mix);
+
+    Quality in = quality(clean, mix), q = quality(clean, out);
+    const char* name = fan ? "fan" : "hum";
+    double noiseDown = 10.0 * log10(in.noise / (q.noise + 1e-9));
+    printf("  %s %.0f dB: SNR %5.1f -> %5.1f dB, segSNR %5.1f -> %5.1f dB, noise down %5.1f dB\n", name, snrDb, in.snr,
+           q.snr, in.segSnr, q.segSnr, noiseDown);
+    CHECK(q.snr - in.snr >= c.snr, "%s %.0f dB: SNR up %.1f dB, expected %.1f", name, snrDb, q.snr - in.snr, c.snr);
+    CHECK(q.segSnr - in.segSnr >= c.segSnr, "%s %.0f dB: segmental SNR up %.1f dB, expected %.1f", name, snrDb,
+          q.segSnr - in.segSnr, c.segSnr);
+    CHECK(noiseDown >= c.noise, "%s %.0f dB: noise down %.1f dB, expected %.1f", name, snrDb, noiseDown, c.noise);
+}
+
+static void checkClean() {
+    const size_t length = 8 * SAMPLE_RATE;
+    std::vector<float> s = speech(length, 8);
+    std::vector<int16_t> clean(length);
+    for (size_t i = 0; i < length; i++) clean[i] = saturate(s[i]);
+    NoiseSuppressor ns;
+    ns.begin(nsConfig);
+    Quality q = quality(clean, suppress(ns, clean));
+    printf("  clean: SNR %.1f dB against the input\n", q.snr);
+    CHECK(q.snr >= MIN_CLEAN_SNR_DB, "clean speech: SNR %.1f dB against the input", q.snr);
+}
+
+int main() {
+    printf("test_noise_suppressor\n");
+    checkFft();
+    checkAllocations();
+    static const SnrCase cases[] = {
+        // Gives 7.9 / 5.1 / 5.6, 5.9 / 2.8 / 2.8, 9.3 / 6.1 / 5.3, 6.6 / 3.3 / 2.6
+        { true, 0.0, 6.0, 3.0, 3.5 },
+        { true, 5.0, 4.0, 1.5, 1.5 },
+        { false, 0.0, 7.0, 4.0, 3.5 },
+        { false, 5.0, 4.5, 1.5, 1.5 },
+    };
+    for (const SnrCase& c : cases) checkSnr(c);
+    checkClean();
+
+    NoiseSuppressor ns;
+    ns.begin(nsConfig);
+    std::vector<float> x = noise(true, NS_HOP * 100, 4);
+    std::vector<int16_t> in(x.size()), out(x.size());
+    for (size_t i = 0; i < x.size(); i++) in[i] = saturate(300.0f * x[i]);
+    double us = benchUs([&]() { ns.process(in.data(), out.data(), in.size()); });
+    printf("  bench %-40s %10.2f us\n", "noise suppressor, per frame", us / 100);
+    return testResult("test_noise_suppressor");
+}
@@ -0,0 +1,180 @@
+/*
+ * Filters packed ahead of time by tools/eon_prepack
+ * (tflite-model/<model>_prepacked.h) and the hook tools/eon_hooks inserts
+ * into the compiled model, which is compiled in here as the tool compiles it
+ *
+ *   table       made from this export (kPrepackedModelChecksum), every entry is
+ *               bit for bit what PackFilter() gives at run time from the
+ *               model's filter, bias and input offset, and every int8 CONV_2D /
+ *               FULLY_CONNECTED node has one
+ *   outputs     the model gives the same output bytes with the table, packing
+ *               at run time and a stale table (entries for other tensors), over
+ *               random inputs; the table saves init's heap allocations, a stale
+ *               one saves none, and init leaves no table behind
+ *   bench       init + reset with the table against packing at run time, best
+ *               of 15: the table must be faster
+ */
+
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h"
+
+#include <random>
+#include <vector>
+
+// What the model's init hands its kernels: the table, nothing, or a copy for other tensors
+enum class Table { Prepacked, None, Stale };
+static Table table = Table::Prepacked;
+static std::vector<tflite::optimized_integer_ops::int8_gemm::PrepackedFilter> staleTable;
+
+namespace tflite {
+namespace optimized_integer_ops {
+namespace int8_gemm {
+
+static const PrepackedFilter* testTable(const PrepackedFilter* entries, size_t count) {
+    if (table == Table::None) return nullptr;
+    if (table == Table::Prepacked) return entries;
+    staleTable.assign(entries, entries + count);
+    for (PrepackedFilter& entry : staleTable) entry.filter = (const int8_t*)entry.filter + 1;
+    return staleTable.data();
+}
+
+struct TestPrepackedFiltersScope : PrepackedFiltersScope {
+    TestPrepackedFiltersScope(const PrepackedFilter* entries, size_t count)
+        : PrepackedFiltersScope(testTable(entries, count), count) {}
+};
+
+}  // namespace int8_gemm
+}  // namespace optimized_integer_ops
+}  // namespace tflite
+
+#define PrepackedFiltersScope TestPrepackedFiltersScope
+#include "tflite-model/tflite_learn_855743_3_compiled.cpp"
+#undef PrepackedFiltersScope
+
+#include "host_porting.h"
+#include "test.h"
+
+#ifndef EI_EON_PREPACKED_FILTERS
+#error "No tflite-model/tflite_learn_855743_3_prepacked.h, run tools/eon_prepack/build.sh"
+#endif
+
+#define RUNS    500
+
+namespace gemm = tflite::optimized_integer_ops::int8_gemm;
+
+static int32_t zeroPoint(const TensorInfo_t& tensor) {
+    if (tensor.quantization.type != kTfLiteAffineQuantization) return 0;
+    return ((const TfLiteAffineQuantization*)tensor.quantization.params)->zero_point->data[0];
+}
+
+static void checkTable() {
+    CHECK(kPrepackedModelChecksum == kEonModelChecksum, "table made from export %08x, the model is %08x",
+          (unsigned)kPrepackedModelChecksum, (unsigned)kEonModelChecksum);
+    const size_t entries = sizeof(prepacked_filters) / sizeof(prepacked_filters[0]);
+    size_t nodes = 0;
+    for (size_t n = 0; n < sizeof(tflNodes) / sizeof(tflNodes[0]); n++) {
+        const bool conv = used_ops[n] == OP_CONV_2D;
+        if (!conv && used_ops[n] != OP_FULLY_CONNECTED) continue;
+        nodes++;
+        const TfLiteIntArray* inputs = tflNodes[n].inputs;
+        const TensorInfo_t& filter = tensorData[inputs->data[1]];
+        const int32_t* bias = inputs->size > 2 ? (const int32_t*)tensorData[inputs->data[2]].data : nullptr;
+        const TfLiteIntArray* dims = filter.dims;
+        const int channels = conv ? dims->data[0] : dims->data[dims->size - 2];
+        const int depth = conv ? dims->data[1] * dims->data[2] * dims->data[3] : dims->data[dims->size - 1];
+
+        const gemm::PrepackedFilter* entry = nullptr;
+        for (size_t e = 0; e < entries; e++) {
+            if (prepacked_filters[e].filter == filter.data) entry = &prepacked_filters[e];
+        }
+        CHECK(entry, "node %zu: filter not in the table", n);
+        if (!entry) continue;
+        CHECK(entry->channels == channels && entry->depth == depth, "node %zu: %d x %d packed as %d x %d", n,
+              channels, depth, (int)entry->channels, (int)entry->depth);
+        CHECK(entry->input_offset == -zeroPoint(tensorData[inputs->data[0]]), "node %zu: input offset %d", n,
+              (int)entry->input_offset);
+
+        std::vector<int32_t> storage(gemm::PackedFilterSize(channels, depth) / sizeof(int32_t) + 4);
+        void* buffer = (void*)(((uintptr_t)storage.data() + 15) & ~(uintptr_t)15);
+        gemm::PackedFilter runtime = gemm::PackFilter((const int8_t*)filter.data, bias, channels, depth,
+                                                      entry->input_offset, buffer);
+        const int paddedChannels = gemm::PaddedChannels(channels);
+        CHECK(memcmp(entry->corrections, runtime.corrections, paddedChannels * sizeof(int32_t)) == 0,
+              "node %zu: corrections differ from packing at run time", n);
+        CHECK(memcmp(entry->weights, runtime.weights, (size_t)paddedChannels * runtime.padded_depth) == 0,
+              "node %zu: weights differ from packing at run time", n);
+    }
+    CHECK(nodes == entries, "%zu entries for %zu nodes", entries, nodes);
+}
+
+static void* arenaAlloc(size_t align, size_t size) {
+    return aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+struct Run {
+    TfLiteStatus status;
+    size_t allocations;     // init's heap allocations, the arena aside
+    std::vector<int8_t> outputs;
+};
+
+static Run run(Table mode, const std::vector<int8_t>& inputs, size_t inputBytes) {
+    table = mode;
+    Run r;
+    size_t before = hostAllocations;
+    r.status = tflite_learn_855743_3_init(arenaAlloc);
+    r.allocations = hostAllocations - before;
+    CHECK(gemm::CurrentPrepackedFilters().entries == nullptr, "init left its table set");
+    TfLiteTensor input, output;
+    for (int i = 0; i < RUNS && r.status == kTfLiteOk; i++) {
+        tflite_learn_855743_3_input(0, &input);
+        memcpy(input.data.data, &inputs[i * inputBytes], inputBytes);
+        r.status = tflite_learn_855743_3_invoke();
+        tflite_learn_855743_3_output(0, &output);
+        r.outputs.insert(r.outputs.end(), output.data.int8, output.data.int8 + output.bytes);
+    }
+    tflite_learn_855743_3_reset(free);
+    table = Table::Prepacked;
+    return r;
+}
+
+static void checkOutputs() {
+    TfLiteTensor input;
+    tflite_learn_855743_3_init(arenaAlloc);
+    tflite_learn_855743_3_input(0, &input);
+    const size_t inputBytes = input.bytes;
+    tflite_learn_855743_3_reset(free);
+
+    std::mt19937 rng(42);
+    std::vector<int8_t> inputs(RUNS * inputBytes);
+    for (int8_t& x : inputs) x = (int8_t)std::uniform_int_distribution<int>(-128, 127)(rng);
+
+    Run prepacked = run(Table::Prepacked, inputs, inputBytes);
+    Run runtime = run(Table::None, inputs, inputBytes);
+    Run stale = run(Table::Stale, inputs, inputBytes);
+    CHECK(prepacked.status == kTfLiteOk && runtime.status == kTfLiteOk && stale.status == kTfLiteOk, "model failed");
+    CHECK(prepacked.outputs == runtime.outputs, "outputs differ from packing at run time");
+    CHECK(stale.outputs == runtime.outputs, "stale table: outputs differ from packing at run time");
+    CHECK(prepacked.allocations < runtime.allocations, "table saves no allocations (%zu)", prepacked.allocations);
+    CHECK(stale.allocations == runtime.allocations, "stale table used: %zu allocations, %zu packing at run time",
+          stale.allocations, runtime.allocations);
+    printf("  init heap allocations: table %zu, at run time %zu\n", prepacked.allocations, runtime.allocations);
+}
+
+int main() {
+    printf("test_prepacked\n");
+    checkTable();
+    checkOutputs();
+
+    double us[2];
+    for (Table mode : { Table::Prepacked, Table::None }) {
+        table = mode;
+        double& best = us[mode == Table::Prepacked ? 0 : 1];
+        best = benchBestUs([]() {
+            tflite_learn_855743_3_init(arenaAlloc);
+            tflite_learn_855743_3_reset(free);
+        });
+        printf("  bench init + reset, %-24s %10.2f us\n", mode == Table::Prepacked ? "table" : "packing at run time", best);
+    }
+    table = Table::Prepacked;
+    CHECK(us[0] < us[1], "init with the table %.2f us, packing at run time %.2f us", us[0], us[1]);
+    return testResult("test_prepacked");
+}
@@ -0,0 +1,186 @@
+/*
+ * PolyphaseResampler (src/resampler.h) against a float reference
+ *
+ *   quality     per rate pair, SNR of the Q15 streaming output against the
+ *               same filter in double precision, and against the ideal tone
+ *   streaming   fed in network-sized chunks of any length, the output is the
+ *               same as in one block
+ *   stopband    a tone above the output's Nyquist is filtered out, not aliased
+ *   bench       seconds of audio per second of host time
+ */
+
+#include "resampler.h"
+#include "test.h"
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/config.h
+
+#define STREAM_BLOCK            2048    // STREAM_CHUNK_BYTES / 2: samples per playStream() read
+
+// The resampler's filter, in double and without rounding: same design, same phase walk
+static std::vector<double> referenceResample(const std::vector<int16_t>& in, uint32_t inRate, uint32_t outRate) {
+    uint32_t a = inRate, b = outRate;
+    while (b) { uint32_t t = a % b; a = b; b = t; }
+    const uint32_t up = outRate / a, down = inRate / a;
+    const int len = up * RESAMPLER_TAPS;
+    const double cutoff = 1.0 / (up > down ? up : down);
+    const double center = (len - 1) * 0.5;
+    std::vector<double> h(len);
+    for (int n = 0; n < len; n++) {
+        double t = n - center;
+        double sinc = t == 0.0 ? cutoff : sin(M_PI * cutoff * t) / (M_PI * t);
+        double r = 2.0 * n / (len - 1) - 1.0;
+        h[n] = sinc * std::cyl_bessel_i(0.0, RESAMPLER_KAISER_BETA * sqrt(1.0 - r * r)) /
+               std::cyl_bessel_i(0.0, (double)RESAMPLER_KAISER_BETA) * up;
+    }
+
+    std::vector<double> out;
+    uint32_t phase = up;
+    size_t n = 0;   // Input samples pushed
+    for (;;) {
+        while (phase >= up) {
+            if (n == in.size()) return out;
+            n++;
+            phase -= up;
+        }
+        double acc = 0.0;
+        for (int k = 0; k < RESAMPLER_TAPS && k < (int)n; k++) acc += h[phase + k * up] * in[n - 1 - k];
+        out.push_back(acc);
+        phase += down;
+    }
+}
+
+static std::vector<int16_t> tone(uint32_t rate, double hz, double seconds, double amplitude) {
+    std::vector<int16_t> x((size_t)(rate * seconds));
+    for (size_t i = 0; i < x.size(); i++) x[i] = (int16_t)lrint(amplitude * sin(2.0 * M_PI * hz * i / rate));
+    return x;
+}
+
+static std::vector<int16_t> resampleAll(PolyphaseResampler& r, const std::vector<int16_t>& in) {
+    std::vector<int16_t> out(r.maxOutput(in.size()));
+    out.resize(r.process(in.data(), in.size(), out.data(), out.size()));
+    return out;
+}
+
+static double snrDb(double signal, double noise) {
+    return 10.0 * log10(signal / (noise > 1e-12 ? noise : 1e-12));
+}
+
+static void checkQuality(uint32_t inRate, uint32_t outRate, double minRefSnr, double minToneSnr) {
+    static PolyphaseResampler r;
+    CHECK(r.configure(inRate, outRate), "%u -> %u", inRate, outRate);
+
+    // Speech band multitone at -6 dBFS, 1s
+    std::vector<int16_t> in((size_t)inRate);
+    const double freqs[] = { 200.0, 750.0, 1900.0, 3300.0, 5100.0 };
+    for (size_t i = 0; i < in.size(); i++) {
+        double v = 0.0;
+        for (double f : freqs) v += sin(2.0 * M_PI * f * i / inRate);
+        in[i] = (int16_t)lrint(16384.0 / 5 * v);
+    }
+    std::vector<int16_t> out = resampleAll(r, in);
+    std::vector<double> ref = referenceResample(in, inRate, outRate);
+    CHECK(out.size() == ref.size(), "%u -> %u: %zu samples, reference %zu", inRate, outRate, out.size(), ref.size());
+
+    double signal = 0.0, noise = 0.0;
+    for (size_t i = 0; i < out.size() && i < ref.size(); i++) {
+        signal += ref[i] * ref[i];
+        noise += (out[i] - ref[i]) * (out[i] - ref[i]);
+    }
+    double refSnr = snrDb(signal, noise);
+
+    // Against the ideal 1 kHz tone, past the filter's delay (half the taps at the input rate)
+    std::vector<int16_t> sine = tone(inRate, 1000.0, 1.0, 16384.0);
+    r.reset();
+    std::vector<int16_t> y = resampleAll(r, sine);
+    double bestSnr = -1e9;
+    const double delay = (RESAMPLER_TAPS - 1) * 0.5 * outRate / inRate;     // Output samples, about
+    for (double d = delay - 2.0; d <= delay + 2.0; d += 0.01) {
+        signal = noise = 0.0;
+        for (size_t i = 64; i + 64 < y.size(); i++) {
+            double ideal = 16384.0 * sin(2.0 * M_PI * 1000.0 * (i - d) / outRate);
+            signal += ideal * ideal;
+            noise += (y[i] - ideal) * (y[i] - ideal);
+        }
+        bestSnr = fmax(bestSnr, snrDb(signal, noise));
+    }
+
+    printf("  %5u -> %5u  %5.1f dB vs float  %5.1f dB vs ideal tone\n", inRate, outRate, refSnr, bestSnr);
+    CHECK(refSnr >= minRefSnr, "%u -> %u: %.1f dB against the float reference", inRate, outRate, refSnr);
+    CHECK(bestSnr >= minToneSnr, "%u -> %u: %.1f dB against the ideal tone", inRate, outRate, bestSnr);
+}
+
+static void checkStreaming(uint32_t inRate, uint32_t outRate) {
+    static PolyphaseResampler whole, chunked;
+    whole.configure(inRate, outRate);
+    chunked.configure(inRate, outRate);
+
+    std::mt19937 rng(inRate);
+    std::uniform_int_distribution<int> sample(-20000, 20000), chunk(1, 700);
+    std::vector<int16_t> in(inRate / 2);
+    for (int16_t& s : in) s = (int16_t)sample(rng);
+
+    std::vector<int16_t> expected = resampleAll(whole, in), got;
+    for (size_t pos = 0; pos < in.size();) {
+        size_t n = std::min((size_t)chunk(rng), in.size() - pos);
+        // Short output buffers too: whatever isn't consumed is fed again
+        int16_t out[256];
+        size_t consumed;
+        size_t produced = chunked.process(&in[pos], n, out, 1 + chunk(rng) % 256, &consumed);
+        got.insert(got.end(), out, out + produced);
+        pos += consumed;
+    }
+    CHECK(got == expected, "%u -> %u: chunked output differs (%zu vs %zu samples)", inRate, outRate,
+          got.size(), expected.size());
+}
+
+static void checkStopband() {
+    // 24k -> 16k: 11 kHz would alias to 5 kHz, 3 kHz into the stopband
+    static PolyphaseResampler r;
+    r.configure(24000, 16000);
+    std::vector<int16_t> y = resampleAll(r, tone(24000, 11000.0, 1.0, 16384.0));
+    double power = 0.0;
+    for (size_t i = 64; i < y.size(); i++) power += (double)y[i] * y[i];
+    double db = snrDb(16384.0 * 16384.0 / 2.0, power / (y.size() - 64));
+    printf("  24000 -> 16000  11 kHz attenuated %.1f dB\n", db);
+    CHECK(db >= 50.0, "11 kHz only %.1f dB down", db);
+}
+
+int main() {
+    printf("test_resampler\n");
+    checkQuality(24000, 16000, 75.0, 50.0);
+    checkQuality(22050, 16000, 75.0, 50.0);
+    checkQuality(44100, 16000, 75.0, 50.0);
+    checkQuality(48000, 16000, 75.0, 50.0);
+    checkQuality(16000, 24000, 75.0, 50.0);
+
+    static PolyphaseResampler passthrough;
+    passthrough.configure(16000, 16000);
+    std::vector<int16_t> x = tone(16000, 440.0, 0.1, 12000.0);
+    CHECK(resampleAll(passthrough, x) == x, "16000 -> 16000 isn't a copy");
+    CHECK(!passthrough.configure(44100, 16001), "44100/16001 fits in %d phases", RESAMPLER_MAX_PHASES);
+
+    checkStreaming(24000, 16000);
+    checkStreaming(22050, 16000);
+    checkStreaming(16000, 24000);
+    checkStopband();
+
+    // One second of TTS through the resampler, as playStream() feeds it
+    static PolyphaseResampler r;
+    for (uint32_t inRate : { 24000u, 22050u }) {
+        r.configure(inRate, 16000);
+        std::vector<int16_t> in = tone(inRate, 1000.0, 1.0, 16384.0);
+        std::vector<int16_t> out(r.maxOutput(STREAM_BLOCK));
+        double us = benchUs([&]() {
+            for (size_t pos = 0; pos < in.size(); pos += STREAM_BLOCK) {
+                r.process(&in[pos], std::min((size_t)STREAM_BLOCK, in.size() - pos), out.data(), out.size());
+            }
+        });
+        printf("  bench %5u -> 16000, 1 s of audio in %8.1f us (%.0fx real time)\n", inRate, us, 1e6 / us);
+    }
+    return testResult("test_resampler");
+}
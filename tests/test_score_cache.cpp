@@ -0,0 +1,83 @@
+/*
+ * Model input capture for the score cache (ei_score_cache.h)
+ *
+ *   warm-up     slices that didn't run the model have no captured input, and
+ *               their records store zeros rather than a stale or unset buffer
+ *   captured    slices that ran it store exactly what the model was given
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/classifier/ei_score_cache.h"
+#include "host_porting.h"
+#include "test.h"
+
+#include <random>
+#include <string.h>
+#include <vector>
+
+#define SLICES  12
+
+int main() {
+    printf("test_score_cache\n");
+    ei_impulse_handle_t handle(ei_default_impulse.impulse);
+
+    // Poisoned, so a record that copies it unasked shows
+    static int8_t features[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE];
+    memset(features, 0x5A, sizeof(features));
+    ei_score_cache_header_t header;
+    ei_score_cache_header_init(&header);
+    CHECK(ei_score_cache_capture_input(&handle, features, &header) == EI_IMPULSE_OK, "capture not supported");
+    CHECK(header.feature_count == EI_CLASSIFIER_NN_INPUT_FRAME_SIZE, "feature_count %u", header.feature_count);
+
+    static uint8_t ringBuffer[64 * 1024];
+    ei_score_cache_ring_t ring;
+    CHECK(ring.begin(ringBuffer, sizeof(ringBuffer), &header), "ring too small");
+
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 2000.0f);
+    std::vector<int16_t> slice(EI_CLASSIFIER_SLICE_SIZE);
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = [&slice](size_t offset, size_t length, float* out) {
+        for (size_t i = 0; i < length; i++) out[i] = (float)slice[offset + i];
+        return 0;
+    };
+
+    run_classifier_init(&handle);
+    std::vector<bool> ran;
+    for (int s = 0; s < SLICES; s++) {
+        for (int16_t& x : slice) x = (int16_t)noise(rng);
+        ei_impulse_result_t result = {};
+        CHECK(run_classifier_continuous(&handle, &signal, &result, false) == EI_IMPULSE_OK, "slice %d failed", s);
+        const int8_t* captured = ei_score_cache_captured_input(&handle);
+        CHECK(captured == nullptr || captured == features, "slice %d: captured input isn't the buffer", s);
+        ran.push_back(captured != nullptr);
+        ring.append(&result, s, EI_SCORE_CACHE_NO_AUDIO, captured);
+    }
+    run_classifier_deinit(&handle);
+
+    // The window fills after slices_per_model_window slices, then every slice runs the model
+    for (int s = 0; s < SLICES; s++) {
+        CHECK(ran[s] == (s >= EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW - 1), "slice %d %s the model", s,
+              ran[s] ? "ran" : "didn't run");
+    }
+
+    std::vector<uint8_t> dump;
+    ring.dump([](const uint8_t* data, size_t size, void* ctx) {
+        ((std::vector<uint8_t>*)ctx)->insert(((std::vector<uint8_t>*)ctx)->end(), data, data + size);
+        return size;
+    }, &dump);
+
+    ei_score_cache_reader_t reader;
+    CHECK(reader.open(dump.data(), dump.size()) && reader.count() == SLICES, "dump doesn't read back");
+    for (uint32_t r = 0; r < reader.count() && r < SLICES; r++) {
+        const int8_t* stored = reader.features(r);
+        bool zero = true;
+        for (int k = 0; k < EI_CLASSIFIER_NN_INPUT_FRAME_SIZE; k++) zero = zero && stored[k] == 0;
+        if (!ran[r]) CHECK(zero, "warm-up slice %u stored features", r);
+        else CHECK(!zero, "slice %u stored no features", r);
+    }
+    // The last record holds what the buffer holds now: the model's last input
+    CHECK(memcmp(reader.features(SLICES - 1), features, sizeof(features)) == 0, "last record isn't the model input");
+    return testResult("test_score_cache");
+}
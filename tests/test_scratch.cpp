@@ -0,0 +1,263 @@
+/*
+ * DSP scratch arena (dsp/scratch.hpp) and the matrix_t temporaries it serves
+ *
+ *   zero        size 0 gives nullptr, as heap_caps_calloc() does on the device,
+ *               so a 0 x n matrix in a scope holds no buffer and frees nothing
+ *   bump        allocations are aligned, zeroed and back to back; freeing the
+ *               newest gives its space back, freeing everything empties the block
+ *   overflow    what doesn't fit comes from the heap and goes back there
+ *   growth      the outermost scope grows the block to the high water mark; a
+ *               matrix that outlives its scope frees cleanly and holds growth
+ *               off until it goes
+ *   threads     each thread has its own arena
+ *   owner       a matrix remembers the arena it came from (none outside a
+ *               scope) and gives its buffer back there; freeing it on
+ *               another thread asserts
+ *   no heap     once warmed up, a whole MFCC call in a scope makes no heap
+ *               allocations: the generic speechpy MFCC, and
+ *               extract_mfcc_features() as run_classifier() calls it
+ *   bench       one model window of MFCC from the heap against from the
+ *               arena, and extract_mfcc_features(): time (best of 15) and
+ *               heap allocations per call
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "host_porting.h"
+#include "test.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if !EIDSP_USE_DSP_SCRATCH
+#error "Build with the DSP scratch arena, as the firmware does"
+#endif
+
+static bool aligned(const void* ptr) {
+    return ((uintptr_t)ptr & (EIDSP_SCRATCH_ALIGNMENT - 1)) == 0;
+}
+
+static bool inBlock(const void* ptr, const void* first) {
+    dsp_scratch& scratch = dsp_scratch::local();
+    return (const uint8_t*)ptr >= (const uint8_t*)first && (const uint8_t*)ptr < (const uint8_t*)first + scratch.capacity();
+}
+
+static void checkZero() {
+    dsp_scratch& scratch = dsp_scratch::local();
+    scratch.reserve(4096);
+    dsp_scratch_scope scope;
+    size_t highWater = scratch.high_water();
+    CHECK(scratch.calloc(0) == nullptr, "calloc(0) in a scope gave a pointer");
+    {
+        matrix_t empty(0, 13);
+        CHECK(empty.buffer == nullptr, "0 x 13 matrix holds a buffer");
+        matrix_t none(13, 0);
+        CHECK(none.buffer == nullptr, "13 x 0 matrix holds a buffer");
+    }   // Would ei_free() a pointer into the block
+    CHECK(scratch.high_water() == highWater, "size 0 counted towards the high water mark");
+
+    // The block is still empty: the next allocation starts it
+    float* first = (float*)scratch.calloc(64);
+    CHECK(first && aligned(first), "no aligned allocation after size 0");
+    scratch.free(first, 64);
+}
+
+static void checkBump() {
+    dsp_scratch& scratch = dsp_scratch::local();
+    scratch.reserve(4096);
+    dsp_scratch_scope scope;
+    uint8_t* a = (uint8_t*)scratch.calloc(100);
+    uint8_t* b = (uint8_t*)scratch.calloc(10);
+    CHECK(a && b && aligned(a) && aligned(b), "unaligned allocation");
+    const size_t stride = (100 + EIDSP_SCRATCH_ALIGNMENT - 1) & ~(size_t)(EIDSP_SCRATCH_ALIGNMENT - 1);
+    CHECK(b == a + stride, "allocations not back to back");
+
+    memset(b, 0x5A, 10);
+    scratch.free(b, 10);
+    uint8_t* again = (uint8_t*)scratch.calloc(10);
+    CHECK(again == b, "freeing the newest didn't give its space back");
+    bool zero = true;
+    for (int i = 0; i < 10; i++) zero = zero && again[i] == 0;
+    CHECK(zero, "reused space not zeroed");
+
+    // Out of order: the space comes back once everything is freed
+    scratch.free(a, 100);
+    scratch.free(again, 10);
+    CHECK(scratch.calloc(100) == a, "freeing everything didn't empty the block");
+    scratch.free(a, 100);
+}
+
+static void checkOverflow() {
+    dsp_scratch& scratch = dsp_scratch::local();
+    scratch.reserve(4096);
+    dsp_scratch_scope scope;
+    void* first = scratch.calloc(32);
+    size_t before = hostAllocations;
+    void* big = scratch.calloc(scratch.capacity() * 2);
+    CHECK(big && !inBlock(big, first), "oversize allocation not from the heap");
+    CHECK(hostAllocations == before + 1, "oversize allocation: %zu heap allocations", hostAllocations - before);
+    scratch.free(big, scratch.capacity() * 2);
+    scratch.free(first, 32);
+}
+
+static void checkGrowth() {
+    dsp_scratch& scratch = dsp_scratch::local();
+    size_t size = scratch.capacity() + 8192;
+    {
+        dsp_scratch_scope scope;
+        matrix_t big(1, size / sizeof(float));
+        CHECK(big.buffer != nullptr, "no buffer");
+    }
+    CHECK(scratch.capacity() >= size, "block not grown to %zu bytes (%zu)", size, scratch.capacity());
+
+    size_t before = hostAllocations;
+    {
+        dsp_scratch_scope scope;
+        matrix_t big(1, size / sizeof(float));
+    }
+    CHECK(hostAllocations == before, "%zu heap allocations after growing", hostAllocations - before);
+
+    // Out of the block, freed after the scope closed: the block can't grow
+    // under it, and empties when it goes
+    matrix_t* outlives;
+    void* first;
+    {
+        dsp_scratch_scope scope;
+        first = scratch.calloc(32);
+        scratch.free(first, 32);
+        outlives = new matrix_t(1, 16);
+        CHECK(outlives->buffer == first, "matrix not from the block");
+        matrix_t tooBig(1, (scratch.capacity() + 4096) / sizeof(float));
+    }
+    size_t capacity = scratch.capacity();
+    delete outlives;
+    {
+        dsp_scratch_scope scope;
+        CHECK(scratch.calloc(32) == first, "block not empty after the matrix went");
+        scratch.free(first, 32);
+    }
+    CHECK(scratch.capacity() > capacity, "block didn't grow once empty");
+}
+
+static void checkThreads() {
+    dsp_scratch* mine = &dsp_scratch::local();
+    dsp_scratch* theirs = nullptr;
+    std::thread([&]() {
+        theirs = &dsp_scratch::local();
+        CHECK(theirs->capacity() == 0, "new thread's arena isn't empty");
+    }).join();
+    CHECK(theirs != mine, "threads share an arena");
+}
+
+static void checkOwner() {
+    dsp_scratch& mine = dsp_scratch::local();
+    matrix_t outside(1, 16);
+    CHECK(outside._scratch == nullptr && outside._scratch_size == 0, "matrix outside a scope has an arena");
+    {
+        dsp_scratch_scope scope;
+        matrix_t inside(1, 16);
+        CHECK(inside._scratch == &mine, "matrix doesn't know its arena");
+    }
+
+    // Made on a worker, freed there after its scope closed
+    std::thread([]() {
+        dsp_scratch::local().reserve(4096);
+        matrix_t* outlives;
+        {
+            dsp_scratch_scope scope;
+            outlives = new matrix_t(1, 16);
+        }
+        CHECK(outlives->_scratch == &dsp_scratch::local(), "worker's matrix not from the worker's arena");
+        float* buffer = outlives->buffer;
+        delete outlives;
+        dsp_scratch_scope scope;
+        matrix_t again(1, 16);
+        CHECK(again.buffer == buffer, "worker's arena not empty after the matrix went");
+    }).join();
+
+#ifndef NDEBUG
+    // Made in a scope on one thread, freed on another: into the wrong arena,
+    // unlocked. A debug build stops it (in a child process, so it can abort)
+    fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        freopen("/dev/null", "w", stderr);
+        matrix_t* crossing;
+        {
+            dsp_scratch_scope scope;
+            crossing = new matrix_t(1, 16);
+        }
+        std::thread([crossing]() { delete crossing; }).join();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT, "freeing on another thread didn't assert (status %d)",
+          status);
+#endif
+}
+
+// One model window of MFCC, as run_classifier() does
+static int mfcc(matrix_t* out, signal_t* signal) {
+    const ei_dsp_config_mfcc_t& c = ei_dsp_config_855743_2;
+    return speechpy::feature::mfcc(out, signal, EI_CLASSIFIER_FREQUENCY, c.frame_length, c.frame_stride, c.num_cepstral,
+                                   c.num_filters, c.fft_length, c.low_frequency, c.high_frequency, true,
+                                   c.implementation_version);
+}
+
+int main() {
+    printf("test_scratch\n");
+    checkZero();
+    checkBump();
+    checkOverflow();
+    checkGrowth();
+    checkThreads();
+    checkOwner();
+
+    std::mt19937 rng(39);
+    std::normal_distribution<float> noise(0.0f, 2000.0f);
+    std::vector<float> audio(EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+    for (float& x : audio) x = noise(rng);
+    signal_t signal;
+    signal.total_length = audio.size();
+    signal.get_data = [&audio](size_t offset, size_t length, float* out) {
+        memcpy(out, &audio[offset], length * sizeof(float));
+        return 0;
+    };
+    const ei_dsp_config_mfcc_t& c = ei_dsp_config_855743_2;
+    matrix_size_t size = speechpy::feature::calculate_mfcc_buffer_size(audio.size(), EI_CLASSIFIER_FREQUENCY,
+        c.frame_length, c.frame_stride, c.num_cepstral, c.implementation_version);
+    matrix_t heapOut(size.rows, size.cols), arenaOut(size.rows, size.cols);
+
+    size_t before = hostAllocations;
+    CHECK(mfcc(&heapOut, &signal) == EIDSP_OK, "MFCC failed");
+    size_t heapAllocations = hostAllocations - before;
+    double heapUs = benchBestUs([&]() { mfcc(&heapOut, &signal); });
+
+    auto inScope = [&]() { dsp_scratch_scope scope; return mfcc(&arenaOut, &signal); };
+    inScope();  // Grows the block
+    before = hostAllocations;
+    CHECK(inScope() == EIDSP_OK, "MFCC in a scope failed");
+    size_t arenaAllocations = hostAllocations - before;
+    double arenaUs = benchBestUs(inScope);
+
+    CHECK(memcmp(heapOut.buffer, arenaOut.buffer, size.rows * size.cols * sizeof(float)) == 0, "arena changes the features");
+    CHECK(arenaAllocations == 0, "MFCC in a scope: %zu heap allocations", arenaAllocations);
+    printf("  bench MFCC window, heap:  %7.1f us  %3zu allocations\n", heapUs, heapAllocations);
+    printf("  bench MFCC window, arena: %7.1f us  %3zu allocations\n", arenaUs, arenaAllocations);
+
+    // The block run_classifier() uses, pre-emphasis and all
+    matrix_t features(1, size.rows * size.cols);
+    auto extract = [&]() { return extract_mfcc_features(&signal, &features, (void*)&c, EI_CLASSIFIER_FREQUENCY); };
+    extract();
+    before = hostAllocations;
+    CHECK(extract() == EIDSP_OK, "extract_mfcc_features failed");
+    size_t extractAllocations = hostAllocations - before;
+    CHECK(extractAllocations == 0, "extract_mfcc_features: %zu heap allocations", extractAllocations);
+    printf("  bench extract_mfcc_features:  %7.1f us  %3zu allocations\n", benchBestUs(extract), extractAllocations);
+    return testResult("test_scratch");
+}
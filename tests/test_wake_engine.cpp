@@ -0,0 +1,200 @@
+/*
+ * WakeEngine (src/wake_engine.h) against the WakeDecision baseline it replaced
+ * (src/wake_decision.h), both at the firmware's settings, on score traces
+ *
+ *   corpus      hours of background with confusable words, and wake words;
+ *               the engine has no more false accepts per hour than the
+ *               baseline and misses no more wake words
+ *   rules       what holds for any scores: a single slice never triggers the
+ *               engine, a wake word above the threshold for the averaging
+ *               window always does
+ *   begin       an engine whose begin() failed never decides or indexes scores
+ *   ownership   an engine can't be copied (it owns its PerfCal)
+ *
+ * The traces are synthetic. A word shorter than the model's 1 s window is all
+ * in a few windows in a row and partly in one on each side. The wake word
+ * scores near 1 in the windows that hold it, as a model deployed at 0.92 must
+ * for most utterances; a confusable word scores anywhere from 0.4 to 0.9 and
+ * varies a lot from window to window. How often the real model does either
+ * only recordings can tell (tools/wake_eval).
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "host_porting.h"
+#include "test.h"
+#include "wake_engine.h"
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+static_assert(!std::is_copy_constructible<WakeEngine>::value, "WakeEngine copies");
+static_assert(!std::is_copy_assignable<WakeEngine>::value, "WakeEngine copies");
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp
+
+#define WAKE_WORD_LABEL         "Nova"
+#define WAKE_WORD_CONFIDENCE    0.92f
+#define WAKE_AVERAGE_MS         750
+#define WAKE_SUPPRESSION_MS     3000
+// What the firmware used before WakeEngine
+#define LEGACY_CONFIDENCE_GAP   0.30f
+#define LEGACY_CONSECUTIVE      1
+#define SLICE_MS                (EI_CLASSIFIER_SLICE_SIZE * 1000 / EI_CLASSIFIER_FREQUENCY)
+
+#define NEGATIVE_HOURS          24
+#define POSITIVES               2000
+#define CONFUSABLES_PER_HOUR    60      // Words that now and then look like the wake word
+
+static const WakeEngineConfig engineConfig = { WAKE_WORD_LABEL, WAKE_WORD_CONFIDENCE, WAKE_AVERAGE_MS,
+                                               WAKE_SUPPRESSION_MS, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW };
+static const WakeDecisionConfig legacyConfig = { WAKE_WORD_CONFIDENCE, LEGACY_CONFIDENCE_GAP, WAKE_SUPPRESSION_MS,
+                                                 LEGACY_CONSECUTIVE, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW };
+
+struct Slice {
+    float scores[EI_CLASSIFIER_LABEL_COUNT];    // Model label order: Nova, noise, unknown
+};
+
+static Slice slice(float wake, std::mt19937& rng) {
+    std::uniform_real_distribution<float> split(0.0f, 1.0f);
+    float s = split(rng);
+    return { { wake, (1.0f - wake) * s, (1.0f - wake) * (1.0f - s) } };
+}
+
+static void background(std::vector<Slice>& trace, size_t count, std::mt19937& rng) {
+    std::exponential_distribution<float> low(30.0f);
+    for (size_t i = 0; i < count; i++) trace.push_back(slice(fminf(low(rng), 0.3f), rng));
+}
+
+// A word shorter than the window: `full` slices whose windows hold all of it,
+// scoring around `peak`, and one on each side with part of it
+static void word(std::vector<Slice>& trace, int full, float peak, float spread, std::mt19937& rng) {
+    std::normal_distribution<float> jitter(0.0f, spread);
+    std::uniform_real_distribution<float> part(0.3f, 0.9f);
+    trace.push_back(slice(peak * part(rng), rng));
+    for (int i = 0; i < full; i++) trace.push_back(slice(fmaxf(0.0f, fminf(1.0f, peak + jitter(rng))), rng));
+    trace.push_back(slice(peak * part(rng), rng));
+}
+
+// Most wake words score near 1, a few lower
+static float wakePeak(std::mt19937& rng) {
+    std::normal_distribution<float> below(0.0f, 0.04f);
+    return 1.0f - fabsf(below(rng));
+}
+
+struct Count {
+    int engine = 0;
+    int legacy = 0;
+};
+
+// Detections of both rules over a trace, from a fresh start (reset) at nowMs
+static Count run(WakeEngine& engine, WakeDecision& legacy, const std::vector<Slice>& trace, uint32_t& nowMs) {
+    Count detected;
+    engine.reset();
+    legacy.reset();
+    for (const Slice& s : trace) {
+        nowMs += SLICE_MS;
+        detected.engine += engine.update(s.scores) == WAKE_DETECTED;
+        detected.legacy += legacy.update(s.scores[0], s.scores[1], s.scores[2], nowMs) == WAKE_DETECTED;
+    }
+    return detected;
+}
+
+// Wake words of `full` slices, starting at any slice of the baseline's window
+template <typename Peak>
+static Count positives(WakeEngine& engine, WakeDecision& legacy, int count, std::uniform_int_distribution<int> full,
+                       Peak peak, float spread, std::mt19937& rng, uint32_t& nowMs) {
+    Count hits;
+    std::uniform_int_distribution<int> offset(0, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW - 1);
+    for (int p = 0; p < count; p++) {
+        std::vector<Slice> trace;
+        background(trace, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW + offset(rng), rng);  // Warm-up, then the offset
+        word(trace, full(rng), peak(rng), spread, rng);
+        background(trace, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW, rng);
+        nowMs += WAKE_SUPPRESSION_MS;
+        Count c = run(engine, legacy, trace, nowMs);
+        hits.engine += c.engine > 0;
+        hits.legacy += c.legacy > 0;
+    }
+    return hits;
+}
+
+int main() {
+    printf("test_wake_engine\n");
+    WakeEngine engine;
+    CHECK(engine.begin(ei_default_impulse.impulse, engineConfig), "begin() failed");
+    CHECK(engine.ready() && engine.wakeIndex() == 0, "wake label at %d", engine.wakeIndex());
+    WakeDecision legacy(legacyConfig);
+    std::mt19937 rng(34);
+    uint32_t nowMs = 60000;     // The device has been up a while
+    const size_t slicesPerHour = 3600 * 1000 / SLICE_MS;
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    // Hours of background, confusable words at random
+    std::vector<Slice> negative;
+    std::uniform_real_distribution<float> confusablePeak(0.4f, 0.9f);
+    std::uniform_int_distribution<int> confusableSlices(1, 4);
+    background(negative, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW, rng);
+    while (negative.size() < NEGATIVE_HOURS * slicesPerHour) {
+        if (chance(rng) < (float)CONFUSABLES_PER_HOUR / slicesPerHour) {
+            word(negative, confusableSlices(rng), confusablePeak(rng), 0.2f, rng);
+        } else {
+            background(negative, 1, rng);
+        }
+    }
+    Count falseAccepts = run(engine, legacy, negative, nowMs);
+    double hours = (double)negative.size() / slicesPerHour;
+    Count hits = positives(engine, legacy, POSITIVES, std::uniform_int_distribution<int>(3, 5), wakePeak, 0.03f, rng,
+                           nowMs);
+
+    double engineRate = falseAccepts.engine / hours, legacyRate = falseAccepts.legacy / hours;
+    double engineMiss = 100.0 * (POSITIVES - hits.engine) / POSITIVES;
+    double legacyMiss = 100.0 * (POSITIVES - hits.legacy) / POSITIVES;
+    printf("  %.0f h of background with %d confusable words/h, %d wake words, threshold %.2f\n",
+           hours, CONFUSABLES_PER_HOUR, POSITIVES, WAKE_WORD_CONFIDENCE);
+    printf("  %-30s %6.2f false accepts/h  %5.1f%% miss\n", "WakeDecision (gap, 1 s checks)", legacyRate, legacyMiss);
+    char engineName[32];
+    snprintf(engineName, sizeof(engineName), "WakeEngine (averaged %d ms)", WAKE_AVERAGE_MS);
+    printf("  %-30s %6.2f false accepts/h  %5.1f%% miss\n", engineName, engineRate, engineMiss);
+    CHECK(engineRate <= legacyRate, "WakeEngine %.2f false accepts/h, the baseline %.2f", engineRate, legacyRate);
+    CHECK(engineMiss <= legacyMiss, "WakeEngine misses %.1f%%, the baseline %.1f%%", engineMiss, legacyMiss);
+    // The baseline only misses the wake words its once a second check falls beside
+    CHECK(legacyMiss < 25.0, "the baseline misses %.1f%% of the wake words, the corpus isn't one the model was "
+          "deployed on", legacyMiss);
+
+    // What holds whatever the model's scores look like: one slice alone never
+    // triggers the engine, however high...
+    std::vector<Slice> spikes;
+    background(spikes, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW, rng);
+    for (int i = 0; i < 1000; i++) {
+        spikes.push_back({ { 1.0f, 0.0f, 0.0f } });
+        background(spikes, WAKE_SUPPRESSION_MS / SLICE_MS + 1 + i % EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW, rng);
+    }
+    Count spikeAccepts = run(engine, legacy, spikes, nowMs);
+    printf("  1000 single-slice spikes: WakeDecision accepts %d, WakeEngine %d\n", spikeAccepts.legacy, spikeAccepts.engine);
+    CHECK(spikeAccepts.engine == 0, "WakeEngine accepted %d single-slice spikes", spikeAccepts.engine);
+    CHECK(spikeAccepts.legacy > 0, "the baseline accepts no spike either, the spikes prove nothing");
+
+    // ...and a wake word above the threshold for the whole averaging window is
+    // never missed, wherever it falls relative to the baseline's check slice
+    const int windowSlices = (int)engine.averageSlices();
+    std::uniform_real_distribution<float> clearPeak(0.99f, 1.0f);
+    Count clear = positives(engine, legacy, 1000, std::uniform_int_distribution<int>(windowSlices, windowSlices),
+                            clearPeak, 0.0f, rng, nowMs);
+    printf("  1000 clear %d-slice wake words: WakeDecision finds %d, WakeEngine %d\n", windowSlices, clear.legacy,
+           clear.engine);
+    CHECK(clear.engine == 1000, "WakeEngine missed %d clear wake words", 1000 - clear.engine);
+    CHECK(clear.legacy < 1000, "the baseline found them all, the offsets prove nothing");
+
+    // A failed begin() leaves nothing usable behind, not even the last good one
+    WakeEngineConfig missing = engineConfig;
+    missing.wakeLabel = "Alexa";
+    CHECK(!engine.begin(ei_default_impulse.impulse, missing), "begin() took a label the model doesn't have");
+    CHECK(!engine.ready() && engine.wakeIndex() < 0, "engine still usable after a failed begin()");
+    const float loud[EI_CLASSIFIER_LABEL_COUNT] = { 1.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 2 * EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW; i++) {
+        CHECK(engine.update(loud) == WAKE_SKIPPED, "slice %d decided without an engine", i);
+    }
+    return testResult("test_wake_engine");
+}
@@ -0,0 +1,142 @@
+/*
+ * Wake word slices (src/wake_slices.h) between the mic and the classifier,
+ * interleaved as detectWakeWord() and barge-in run them
+ *
+ *   loop        the loop core: fill, classify at once; every sample in order,
+ *               in whole slices, nothing dropped
+ *   deferred    a slice that fills while the last is unclassified waits and
+ *               goes out once the classifier releases the other, as it was
+ *   interleave  barge-in: reads of any size, the classifier at random times;
+ *               every sample fill() took reaches the classifier in order, and
+ *               whatever it didn't take the caller counts as dropped
+ *   reset       drops the partial and the waiting slice
+ *
+ * Samples carry their position in the stream, so a slice shows where it came from.
+ */
+
+#include "test.h"
+#include "wake_slices.h"
+
+#include <random>
+#include <vector>
+
+#define SLICE_SAMPLES   4000    // EI_CLASSIFIER_SLICE_SIZE, 250ms at 16kHz
+#define READ_SAMPLES    512     // BARGE_IN_READ_SAMPLES
+
+struct Harness {
+    int16_t buffers[2][SLICE_SAMPLES];
+    WakeSlices slices;
+    uint32_t next = 0;              // Position of the next mic sample
+    std::vector<uint32_t> taken;    // Positions fill() took, in order
+    std::vector<uint16_t> seen;     // What the classifier read, in order
+    size_t dropped = 0;
+    size_t classified = 0;
+
+    Harness() {
+        slices.begin(buffers[0], buffers[1], SLICE_SAMPLES);
+    }
+
+    // One mic read, as bargeInTask() hands it over
+    void read(size_t count) {
+        std::vector<int16_t> samples(count);
+        for (size_t i = 0; i < count; i++) samples[i] = (int16_t)((next + i) & 0x7FFF);
+        size_t used = slices.fill(samples.data(), count);
+        if (used < count) used += slices.fill(samples.data() + used, count - used);
+        for (size_t i = 0; i < used; i++) taken.push_back(next + (uint32_t)i);
+        dropped += count - used;
+        next += (uint32_t)count;
+    }
+
+    bool classify() {
+        if (!slices.ready()) return false;
+        const int16_t* slice = slices.slice();
+        for (size_t i = 0; i < SLICE_SAMPLES; i++) seen.push_back((uint16_t)slice[i]);
+        slices.release();
+        classified++;
+        return true;
+    }
+
+    // Samples taken and classified in order, the rest still in the slices
+    void checkStream(const char* name) {
+        CHECK(seen.size() <= taken.size(), "%s: classified more than was taken", name);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < seen.size() && i < taken.size(); i++) mismatches += seen[i] != (taken[i] & 0x7FFF);
+        CHECK(mismatches == 0, "%s: %zu samples classified out of stream order", name, mismatches);
+        size_t held = taken.size() - seen.size();
+        CHECK(held < 2 * SLICE_SAMPLES, "%s: %zu samples taken and still held", name, held);
+        CHECK(taken.size() + dropped == next, "%s: %zu taken + %zu dropped of %u", name, taken.size(), dropped, next);
+    }
+};
+
+static void checkLoop() {
+    Harness h;
+    std::mt19937 rng(48);
+    for (int r = 0; r < 2000; r++) {
+        // detectWakeWord(): up to 2048 samples, only what fits in the slice
+        size_t count = std::uniform_int_distribution<size_t>(1, 2048)(rng);
+        size_t fits = h.slices.space();
+        h.read(count < fits ? count : fits);
+        h.classify();
+    }
+    h.checkStream("loop");
+    CHECK(h.dropped == 0, "loop: %zu samples dropped", h.dropped);
+    CHECK(h.classified == h.next / SLICE_SAMPLES, "loop: %zu slices of %u samples", h.classified, h.next);
+}
+
+static void checkDeferred() {
+    Harness h;
+    while (!h.slices.ready()) h.read(READ_SAMPLES);
+    // The classifier is busy: the next slice fills up and waits
+    while (h.slices.space() > 0) h.read(READ_SAMPLES);
+    CHECK(h.slices.space() == 0, "no slice waiting");
+    size_t dropped = h.dropped;
+    h.read(READ_SAMPLES);
+    CHECK(h.dropped == dropped + READ_SAMPLES, "took samples while a full slice waited");
+
+    CHECK(h.classify(), "first slice not ready");
+    CHECK(!h.slices.ready(), "waiting slice out before the next fill");
+    h.read(READ_SAMPLES);
+    CHECK(h.slices.ready(), "waiting slice dropped once the classifier released");
+    CHECK(h.classify(), "waiting slice not classified");
+    h.checkStream("deferred");
+    CHECK(h.seen.size() == 2 * SLICE_SAMPLES, "%zu samples classified", h.seen.size());
+}
+
+static void checkInterleave() {
+    for (uint32_t seed = 0; seed < 50; seed++) {
+        Harness h;
+        std::mt19937 rng(seed);
+        // Anything from a classifier that keeps up to one that falls far behind
+        std::uniform_int_distribution<int> classifyEvery(1, 1 + seed % 20);
+        std::uniform_int_distribution<size_t> readSize(1, READ_SAMPLES * 4);
+        for (int r = 0; r < 3000; r++) {
+            h.read(readSize(rng));
+            if (classifyEvery(rng) == 1) h.classify();
+        }
+        while (h.classify()) {
+        }
+        h.checkStream("interleave");
+        // All that's left is the slice being filled, or a full one waiting for the next read
+        size_t held = h.taken.size() - h.seen.size();
+        CHECK(held < SLICE_SAMPLES || (held == SLICE_SAMPLES && h.slices.space() == 0),
+              "seed %u: %zu samples taken and never classified", seed, held);
+    }
+}
+
+static void checkReset() {
+    Harness h;
+    while (!h.slices.ready()) h.read(READ_SAMPLES);
+    h.read(READ_SAMPLES);
+    h.slices.reset();
+    CHECK(!h.slices.ready(), "slice still ready after reset");
+    CHECK(h.slices.space() == SLICE_SAMPLES, "partial slice kept after reset");
+}
+
+int main() {
+    printf("test_wake_slices\n");
+    checkLoop();
+    checkDeferred();
+    checkInterleave();
+    checkReset();
+    return testResult("test_wake_slices");
+}
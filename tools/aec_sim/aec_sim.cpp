@@ -0,0 +1,511 @@
+/*
+ * Echo Canceller Simulation for NOVA
+ * Plays a reply through synthetic speaker -> mic echo paths and runs the
+ * mic through the firmware's barge-in chain: EchoCanceller
+ * (src/echo_canceller.h), the mic AGC's wake feed, run_classifier_continuous()
+ * per 250ms slice and the WakeEngine. Per echo path it reports:
+ *
+ *   delay      true echo delay vs the canceller's estimate
+ *   ERLE       echo return loss enhancement over echo-only audio after the
+ *              first 2s, from the known echo; and the canceller's own figure
+ *   SER        wake word to residual (echo + distortion) ratio over the wake
+ *              word, mic in -> canceller out
+ *   detected   wake words found on the raw mic, after the canceller, and on
+ *              the wake word alone (no reply playing) as the ceiling
+ *   false      detections over echo-only runs (the reply by itself)
+ *   cost       canceller time per second of audio on this host
+ *
+ * The reply is speech-shaped noise (coloured, syllable-rate envelope, pauses)
+ * unless --reference gives a recording. Echo paths: a bulk delay (DMA and
+ * converter latency), a direct path, a few early reflections and an
+ * exponentially decaying tail. Reference and mic are fed as on the device:
+ * the reference in playback-sized bursts up to a DMA queue ahead, the mic
+ * in barge-in reads. Each wake word recording is spoken over the reply at
+ * --echo-db of echo relative to it. Recordings: 16kHz 16-bit mono WAV, or
+ * directories of them; files under a directory named like the wake label
+ * contain one wake word each, the rest are skipped.
+ *
+ * Build:  tools/aec_sim/build.sh
+ * Usage:  aec_sim <recordings ...> [--reference reply.wav] [--echo-db 6] [--seconds 8]
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "wake_engine.h"
+#include "mic_agc.h"
+#include "echo_canceller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+// ============== Host Porting ==============
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp and src/config.h
+
+#define WAKE_LABEL              "Nova"
+#define WAKE_WORD_GAIN          8
+#define SILENCE_THRESHOLD       200
+#define BARGE_IN_READ_SAMPLES   512     // bargeInTask()'s reads
+#define PLAYBACK_CHUNK_SAMPLES  1024    // writeSpeakerMono()'s resampler output
+#define SPEAKER_QUEUE_SAMPLES   16384   // 16 x 1024 frame speaker DMA queue
+#define ECHO_REFERENCE_MS       2500    // config.h ships 0 (off), as the esp32s3-barge-in env builds it
+
+static const WakeEngineConfig wakeConfig = { WAKE_LABEL, 0.92f, 750, 3000, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW };
+static const MicAgcConfig agcConfig = { EI_CLASSIFIER_FREQUENCY, 300, SILENCE_THRESHOLD, 30000, {
+    { 24000, 1.0f, WAKE_WORD_GAIN, 500 },
+    { 16000, 1.0f, 8.0f, 1000 } } };
+static const EchoCancellerConfig echoConfig = { EI_CLASSIFIER_FREQUENCY, 384, 128, 250, 0.5f, 0.5f, 2.0f, 16, 64 };
+
+// ============== Recordings ==============
+
+struct Recording {
+    std::string name;
+    bool positive = false;
+    std::vector<int16_t> samples;
+};
+
+static bool loadWav(const std::string& path, Recording& r) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool formatOk = false;
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, &data[pos + 4], 4);
+        const uint8_t* body = &data[pos + 8];
+
+        if (memcmp(&data[pos], "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint16_t format, channels, bits;
+            uint32_t rate;
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&rate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+            formatOk = (format == 1 && channels == 1 && bits == 16 && rate == EI_CLASSIFIER_FREQUENCY);
+        } else if (memcmp(&data[pos], "data", 4) == 0) {
+            if (!formatOk) return false;
+            size_t available = data.size() - (pos + 8);
+            size_t count = (chunkSize < available ? chunkSize : available) / 2;
+            r.name = path;
+            r.samples.resize(count);
+            memcpy(r.samples.data(), body, count * 2);
+            return true;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+static void findRecordings(const std::string& path, bool positive, std::vector<Recording>& out) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        Recording r;
+        r.positive = positive;
+        if (loadWav(path, r)) out.push_back(r);
+        else fprintf(stderr, "Skipping %s (need %d Hz 16-bit mono PCM)\n", path.c_str(), EI_CLASSIFIER_FREQUENCY);
+        return;
+    }
+
+    size_t slash = path.find_last_of('/', path.size() - 2);
+    std::string base = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    if (!base.empty() && base.back() == '/') base.pop_back();
+    positive = positive || strcasecmp(base.c_str(), WAKE_LABEL) == 0;
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) {
+        std::string full = path + "/" + name;
+        if (stat(full.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            findRecordings(full, positive, out);
+        } else if (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0) {
+            findRecordings(full, positive, out);
+        }
+    }
+}
+
+// ============== Reply and Echo Paths ==============
+
+// Speech-shaped stand-in for a TTS reply, after the firmware's 50% volume
+static std::vector<int16_t> syntheticReply(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<int16_t> out(count);
+
+    // Two resonators, roughly a first and second formant that wander per syllable
+    float y1[2] = { 0, 0 }, y2[2] = { 0, 0 };
+    float f1 = 600, f2 = 1800, level = 0.0f, target = 0.0f;
+    size_t nextSyllable = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == nextSyllable) {
+            bool pause = uniform(rng) < 0.15f;
+            target = pause ? 0.0f : 0.3f + 0.7f * uniform(rng);
+            f1 = 300 + 600 * uniform(rng);
+            f2 = 1000 + 1500 * uniform(rng);
+            nextSyllable += (size_t)(EI_CLASSIFIER_FREQUENCY * (pause ? 0.25f + 0.3f * uniform(rng) : 0.12f + 0.15f * uniform(rng)));
+        }
+        level += (target - level) * 0.002f;
+
+        float x = noise(rng);
+        float out1, out2;
+        {
+            float w = 2.0f * (float)M_PI * f1 / EI_CLASSIFIER_FREQUENCY, r = 0.97f;
+            out1 = x + 2 * r * cosf(w) * y1[0] - r * r * y1[1];
+            y1[1] = y1[0];
+            y1[0] = out1;
+        }
+        {
+            float w = 2.0f * (float)M_PI * f2 / EI_CLASSIFIER_FREQUENCY, r = 0.95f;
+            out2 = x + 2 * r * cosf(w) * y2[0] - r * r * y2[1];
+            y2[1] = y2[0];
+            y2[0] = out2;
+        }
+        float s = level * (out1 * 0.06f + out2 * 0.08f) * 3000.0f;
+        out[i] = (int16_t)std::max(-32768.0f, std::min(32767.0f, s));
+    }
+    return out;
+}
+
+struct EchoPath {
+    const char* name;
+    float delayMs;          // Bulk: reference counter to mic counter
+    float rt60Ms;           // Tail decay
+    float tailDb;           // Tail level relative to the direct path
+    float moveMs;           // Delay change halfway through (an underrun the firmware misjudged), 0 for none
+};
+
+static const EchoPath echoPaths[] = {
+    { "enclosure",  40.0f,  80.0f, -12.0f, 0.0f },
+    { "desk",       90.0f, 250.0f,  -6.0f, 0.0f },
+    { "room",       60.0f, 450.0f,  -3.0f, 0.0f },
+    { "moved",      50.0f, 150.0f,  -9.0f, 24.0f },
+};
+
+static std::vector<float> impulseResponse(const EchoPath& path, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    size_t length = (size_t)(path.rt60Ms * EI_CLASSIFIER_FREQUENCY / 1000);
+    std::vector<float> h(length + 1, 0.0f);
+    h[0] = 1.0f;
+    // Early reflections off the desk and walls
+    const float early[][2] = { { 1.5f, -0.5f }, { 4.0f, 0.35f }, { 7.5f, -0.25f } };
+    for (const auto& e : early) {
+        size_t at = (size_t)(e[0] * EI_CLASSIFIER_FREQUENCY / 1000);
+        if (at < h.size()) h[at] += e[1];
+    }
+    float tail = powf(10.0f, path.tailDb / 20.0f) / sqrtf(length * 0.15f);
+    float decay = -6.9078f / length;    // -60dB over rt60
+    for (size_t n = 1; n < h.size(); n++) h[n] += tail * noise(rng) * expf(decay * n);
+    return h;
+}
+
+// Echo of `reply` at the mic, mic counter i hearing reference i - delay(i)
+static std::vector<float> echoOf(const std::vector<int16_t>& reply, const EchoPath& path, uint32_t seed) {
+    std::vector<float> h = impulseResponse(path, seed);
+    size_t delay = (size_t)(path.delayMs * EI_CLASSIFIER_FREQUENCY / 1000);
+    size_t moved = (size_t)((path.delayMs + path.moveMs) * EI_CLASSIFIER_FREQUENCY / 1000);
+    std::vector<float> echo(reply.size(), 0.0f);
+    for (size_t i = 0; i < echo.size(); i++) {
+        size_t d = (path.moveMs != 0.0f && i >= echo.size() / 2) ? moved : delay;
+        float sum = 0.0f;
+        for (size_t k = 0; k < h.size() && i >= d + k; k++) sum += h[k] * reply[i - d - k];
+        echo[i] = sum;
+    }
+    return echo;
+}
+
+// ============== Evaluation ==============
+
+struct Tally {
+    int runs = 0;
+    double delayError = 0.0;        // ms, over runs that locked
+    int locked = 0;
+    double echoEnergy = 0.0, residualEnergy = 0.0;
+    double erleSelf = 0.0;
+    double nearEnergy = 0.0, micResidual = 0.0, outResidual = 0.0;
+    int positives = 0;
+    int detectedRaw = 0, detectedAec = 0, detectedClean = 0;
+    int falseRaw = 0, falseAec = 0;
+    double echoSeconds = 0.0;
+    double aecSeconds = 0.0, aecTime = 0.0;
+};
+
+// Detections of the firmware's wake word chain over `mic` (AGC wake feed, slices, engine)
+static int detect(ei_impulse_handle_t* handle, const std::vector<int16_t>& mic) {
+    MicAgc agc;
+    agc.begin(agcConfig);
+    std::vector<int16_t> wake(mic.size());
+    for (size_t start = 0; start < mic.size(); start += BARGE_IN_READ_SAMPLES) {
+        size_t n = std::min((size_t)BARGE_IN_READ_SAMPLES, mic.size() - start);
+        agc.process(&mic[start], &wake[start], nullptr, n);
+    }
+
+    WakeEngine engine;
+    if (!engine.begin(handle->impulse, wakeConfig)) return -1;
+    std::vector<int16_t> slice(EI_CLASSIFIER_SLICE_SIZE);
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = [&slice](size_t offset, size_t length, float* out) {
+        return numpy::int16_to_float(&slice[offset], out, length);
+    };
+
+    run_classifier_init(handle);
+    int detections = 0;
+    for (size_t start = 0; start + EI_CLASSIFIER_SLICE_SIZE <= wake.size(); start += EI_CLASSIFIER_SLICE_SIZE) {
+        memcpy(slice.data(), &wake[start], EI_CLASSIFIER_SLICE_SIZE * sizeof(int16_t));
+        ei_impulse_result_t result = {};
+        if (run_classifier_continuous(handle, &signal, &result, false) != EI_IMPULSE_OK) {
+            detections = -1;
+            break;
+        }
+        if (engine.update(&result) == WAKE_DETECTED) {
+            detections++;
+            engine.reset();
+        }
+    }
+    run_classifier_deinit(handle);
+    return detections;
+}
+
+// The device's interleaving: playback keeps up to a DMA queue of reference ahead of the mic
+static std::vector<int16_t> cancel(EchoCanceller& aec, const std::vector<int16_t>& reply,
+                                   const std::vector<int16_t>& mic, double* seconds) {
+    std::vector<int16_t> out(mic.size());
+    aec.reset();
+    size_t pushed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t read = 0; read < mic.size(); read += BARGE_IN_READ_SAMPLES) {
+        while (pushed < reply.size() && pushed < read + SPEAKER_QUEUE_SAMPLES) {
+            size_t n = std::min((size_t)PLAYBACK_CHUNK_SAMPLES, reply.size() - pushed);
+            aec.pushReference(&reply[pushed], n);
+            pushed += n;
+        }
+        size_t n = std::min((size_t)BARGE_IN_READ_SAMPLES, mic.size() - read);
+        aec.process(&mic[read], &out[read], n);
+    }
+    *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return out;
+}
+
+static int16_t clip(float v) {
+    return (int16_t)std::max(-32768.0f, std::min(32767.0f, v));
+}
+
+static double db(double ratio) {
+    return ratio > 0.0 ? 10.0 * log10(ratio) : -INFINITY;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    std::string referencePath;
+    float echoDb = 6.0f;
+    float seconds = 8.0f;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--reference") && i + 1 < argc) {
+            referencePath = argv[++i];
+        } else if (!strcmp(argv[i], "--echo-db") && i + 1 < argc) {
+            echoDb = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.empty() || seconds < 4.0f) {
+        fprintf(stderr, "Usage: %s <recordings ...> [--reference reply.wav] [--echo-db 6] [--seconds 8]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Recording> recordings, positives;
+    for (const std::string& path : paths) findRecordings(path, false, recordings);
+    for (const Recording& r : recordings) {
+        if (r.positive) positives.push_back(r);
+    }
+    if (positives.empty()) {
+        fprintf(stderr, "No wake word recordings found\n");
+        return 1;
+    }
+
+    size_t length = (size_t)(seconds * EI_CLASSIFIER_FREQUENCY);
+    std::vector<int16_t> reply;
+    if (!referencePath.empty()) {
+        Recording r;
+        if (!loadWav(referencePath, r) || r.samples.empty()) {
+            fprintf(stderr, "Can't read %s (need %d Hz 16-bit mono PCM)\n", referencePath.c_str(), EI_CLASSIFIER_FREQUENCY);
+            return 1;
+        }
+        reply.resize(length);
+        for (size_t i = 0; i < length; i++) reply[i] = r.samples[i % r.samples.size()];
+    } else {
+        reply = syntheticReply(length, 1);
+    }
+
+    std::vector<int16_t> ring(EI_CLASSIFIER_FREQUENCY * ECHO_REFERENCE_MS / 1000);
+    EchoCanceller aec;
+    if (!aec.begin(echoConfig, ring.data(), ring.size())) {
+        fprintf(stderr, "Echo canceller config rejected\n");
+        return 1;
+    }
+
+    ei_impulse_handle_t handle(ei_default_impulse.impulse);
+    const size_t settle = 2 * EI_CLASSIFIER_FREQUENCY;      // ERLE ignores the canceller's start
+    const size_t wakeAt = length / 2 - EI_CLASSIFIER_FREQUENCY;
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 30.0f);   // Mic self noise
+
+    printf("Reply: %s, %.0fs | echo %+.0f dB over each wake word | %zu wake word recordings\n",
+        referencePath.empty() ? "speech-shaped noise" : referencePath.c_str(), seconds, echoDb, positives.size());
+    printf("%-10s %9s %9s  %7s %7s  %15s  %18s  %11s  %8s  %s\n", "path", "delay", "estimate", "ERLE", "(self)",
+        "SER in->out", "detected raw/aec", "(no reply)", "false", "cost");
+
+    for (size_t p = 0; p < sizeof(echoPaths) / sizeof(echoPaths[0]); p++) {
+        const EchoPath& path = echoPaths[p];
+        std::vector<float> echo = echoOf(reply, path, 100 + (uint32_t)p);
+        double echoRms = 0.0;
+        for (size_t i = settle; i < length; i++) echoRms += (double)echo[i] * echo[i];
+        echoRms = sqrt(echoRms / (length - settle));
+
+        Tally t;
+        for (int run = 0; run <= (int)positives.size(); run++) {
+            // The last run is the reply alone
+            const Recording* r = run < (int)positives.size() ? &positives[run] : nullptr;
+            std::vector<float> near(length, 0.0f);
+            float scale = 1.0f;
+            if (r) {
+                double nearRms = 0.0;
+                size_t n = std::min(r->samples.size(), length - wakeAt);
+                for (size_t i = 0; i < n; i++) nearRms += (double)r->samples[i] * r->samples[i];
+                nearRms = sqrt(nearRms / std::max<size_t>(n, 1));
+                for (size_t i = 0; i < n; i++) near[wakeAt + i] = r->samples[i];
+                // Echo at echoDb over the wake word's level
+                scale = nearRms > 0.0 ? (float)(nearRms * pow(10.0, echoDb / 20.0) / echoRms) : 1.0f;
+            } else {
+                scale = (float)(1000.0 / echoRms);
+            }
+
+            std::vector<int16_t> mic(length), clean(length);
+            for (size_t i = 0; i < length; i++) {
+                float n = noise(rng);
+                mic[i] = clip(echo[i] * scale + near[i] + n);
+                clean[i] = clip(near[i] + n);
+            }
+
+            double took = 0.0;
+            std::vector<int16_t> out = cancel(aec, reply, mic, &took);
+            t.aecTime += took;
+            t.aecSeconds += seconds;
+            t.runs++;
+            if (aec.locked()) {
+                t.locked++;
+                float truth = path.delayMs + path.moveMs;
+                t.delayError += fabsf(aec.delay() * 1000.0f / EI_CLASSIFIER_FREQUENCY - truth);
+            }
+            t.erleSelf += aec.erle();
+
+            // Residual = what the canceller left of the echo, plus anything it did to the wake word
+            size_t wakeEnd = r ? std::min(length, wakeAt + r->samples.size()) : wakeAt;
+            for (size_t i = settle; i < length; i++) {
+                float e = echo[i] * scale;
+                float residual = out[i] - near[i] - (mic[i] - e - near[i]);
+                if (i >= wakeAt && i < wakeEnd) {
+                    t.nearEnergy += (double)near[i] * near[i];
+                    t.micResidual += (double)e * e;
+                    t.outResidual += (double)residual * residual;
+                } else {
+                    t.echoEnergy += (double)e * e;
+                    t.residualEnergy += (double)residual * residual;
+                }
+            }
+
+            int raw = detect(&handle, mic);
+            int aecDetections = detect(&handle, out);
+            if (raw < 0 || aecDetections < 0) {
+                fprintf(stderr, "Classification failed\n");
+                return 1;
+            }
+            if (r) {
+                int cleanDetections = detect(&handle, clean);
+                t.positives++;
+                t.detectedRaw += raw > 0;
+                t.detectedAec += aecDetections > 0;
+                t.detectedClean += cleanDetections > 0;
+            } else {
+                t.falseRaw += raw;
+                t.falseAec += aecDetections;
+                t.echoSeconds += seconds;
+            }
+        }
+
+        char delay[48], estimate[48], ser[48], detected[48], ceiling[48], falses[48];
+        snprintf(delay, sizeof(delay), path.moveMs != 0.0f ? "%.0f>%.0fms" : "%.0fms", path.delayMs, path.delayMs + path.moveMs);
+        if (t.locked) snprintf(estimate, sizeof(estimate), "+-%.1fms", t.delayError / t.locked);
+        else snprintf(estimate, sizeof(estimate), "none");
+        snprintf(ser, sizeof(ser), "%+.1f->%+.1fdB", db(t.nearEnergy / t.micResidual), db(t.nearEnergy / t.outResidual));
+        snprintf(detected, sizeof(detected), "%d/%d -> %d/%d", t.detectedRaw, t.positives, t.detectedAec, t.positives);
+        snprintf(ceiling, sizeof(ceiling), "%d/%d", t.detectedClean, t.positives);
+        snprintf(falses, sizeof(falses), "%d -> %d", t.falseRaw, t.falseAec);
+        printf("%-10s %9s %9s  %5.1fdB %5.1fdB  %15s  %18s  %11s  %8s  %.1fms/s\n", path.name, delay, estimate,
+            db(t.echoEnergy / t.residualEnergy), t.erleSelf / t.runs, ser, detected, ceiling, falses,
+            1000.0 * t.aecTime / t.aecSeconds);
+        fflush(stdout);
+    }
+    return 0;
+}
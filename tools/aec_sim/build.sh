@@ -0,0 +1,8 @@
+#!/bin/sh
+# Build the echo canceller simulation against the firmware's Edge Impulse library.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+
+host_program tools/aec_sim/build aec_sim tools/aec_sim/aec_sim.cpp
@@ -0,0 +1,316 @@
+/*
+ * Mic AGC Evaluator for NOVA
+ * Replays recordings at a range of input levels through both mic paths of
+ * the firmware and reports, per level:
+ *
+ *   fixed  the wake word feed at a fixed 8x gain with int16 wrap-around,
+ *          the upload raw
+ *   agc    both feeds from MicAgc (src/mic_agc.h) with the firmware's settings
+ *
+ * Wake feed: wrapped or saturated samples (%), limiter activity, then
+ * run_classifier_continuous() per 250ms slice and the firmware's WakeEngine,
+ * counting detections on wake word recordings and false accepts elsewhere.
+ * Upload feed: samples the path itself clipped (%) and RMS level over the
+ * samples above the silence threshold, i.e. what STT hears of the speech.
+ *
+ * Level changes are applied to the raw recordings with saturation, as a mic
+ * clipping at its own full scale would. Recordings: 16kHz 16-bit mono WAV,
+ * or directories of them; files under a directory named like the wake label
+ * contain one wake word each.
+ *
+ * Build:  tools/agc_eval/build.sh
+ * Usage:  agc_eval <recordings ...> [--levels -24,-12,-6,0,6,12]
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "wake_engine.h"
+#include "mic_agc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+// ============== Host Porting ==============
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp and src/config.h
+
+#define WAKE_LABEL              "Nova"
+#define WAKE_WORD_GAIN          8
+#define SILENCE_THRESHOLD       200
+#define I2S_READ_SAMPLES        2048    // detectWakeWord()'s reads
+
+static const WakeEngineConfig wakeConfig = { WAKE_LABEL, 0.92f, 500, 3000, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW };
+static const MicAgcConfig agcConfig = { EI_CLASSIFIER_FREQUENCY, 300, SILENCE_THRESHOLD, 30000, {
+    { 24000, 1.0f, WAKE_WORD_GAIN, 500 },
+    { 16000, 1.0f, 8.0f, 1000 } } };
+
+// ============== Recordings ==============
+
+struct Recording {
+    std::string name;
+    bool positive = false;
+    std::vector<int16_t> samples;
+};
+
+static bool loadWav(const std::string& path, Recording& r) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool formatOk = false;
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, &data[pos + 4], 4);
+        const uint8_t* body = &data[pos + 8];
+
+        if (memcmp(&data[pos], "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint16_t format, channels, bits;
+            uint32_t rate;
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&rate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+            formatOk = (format == 1 && channels == 1 && bits == 16 && rate == EI_CLASSIFIER_FREQUENCY);
+        } else if (memcmp(&data[pos], "data", 4) == 0) {
+            if (!formatOk) return false;
+            size_t available = data.size() - (pos + 8);
+            size_t count = (chunkSize < available ? chunkSize : available) / 2;
+            r.name = path;
+            r.samples.resize(count);
+            memcpy(r.samples.data(), body, count * 2);
+            return true;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+static void findRecordings(const std::string& path, bool positive, std::vector<Recording>& out) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        Recording r;
+        r.positive = positive;
+        if (loadWav(path, r)) out.push_back(r);
+        else fprintf(stderr, "Skipping %s (need %d Hz 16-bit mono PCM)\n", path.c_str(), EI_CLASSIFIER_FREQUENCY);
+        return;
+    }
+
+    size_t slash = path.find_last_of('/', path.size() - 2);
+    std::string base = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    if (!base.empty() && base.back() == '/') base.pop_back();
+    positive = positive || strcasecmp(base.c_str(), WAKE_LABEL) == 0;
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) {
+        std::string full = path + "/" + name;
+        if (stat(full.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            findRecordings(full, positive, out);
+        } else if (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0) {
+            findRecordings(full, positive, out);
+        }
+    }
+}
+
+// ============== Evaluation ==============
+
+struct Tally {
+    uint64_t samples = 0;
+    uint64_t inputClipped = 0;      // By the level change itself, the same for both paths
+    uint64_t wakeClipped = 0;       // Wrapped (fixed) or saturated (agc)
+    uint64_t limitedBlocks = 0;
+    uint64_t blocks = 0;
+    uint64_t uploadClipped = 0;
+    double uploadEnergy = 0.0;      // Over samples above the silence threshold
+    uint64_t uploadLoud = 0;
+    int positives = 0;
+    int detected = 0;
+    int falseAccepts = 0;
+    double negativeHours = 0.0;
+};
+
+static int16_t scaled(int16_t s, int32_t levelQ12) {
+    int32_t y = (s * levelQ12) >> 12;
+    return (int16_t)std::max(-32768, std::min(32767, y));
+}
+
+static bool evaluate(ei_impulse_handle_t* handle, const Recording& r, int32_t levelQ12, bool agc, Tally& t) {
+    std::vector<int16_t> raw(r.samples.size()), wake(r.samples.size()), upload(r.samples.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        raw[i] = scaled(r.samples[i], levelQ12);
+        t.inputClipped += (raw[i] == 32767 || raw[i] == -32768);
+    }
+
+    // Both feeds from one pass, in the firmware's read size
+    MicAgc micAgc;
+    if (agc) {
+        micAgc.begin(agcConfig);
+        for (size_t start = 0; start < raw.size(); start += I2S_READ_SAMPLES) {
+            size_t n = std::min((size_t)I2S_READ_SAMPLES, raw.size() - start);
+            micAgc.process(&raw[start], &wake[start], &upload[start], n);
+        }
+        t.wakeClipped += micAgc.stats(AGC_FEED_WAKE).clipped;
+        t.uploadClipped += micAgc.stats(AGC_FEED_UPLOAD).clipped;
+        t.limitedBlocks += micAgc.stats(AGC_FEED_WAKE).limitedBlocks;
+    } else {
+        for (size_t i = 0; i < raw.size(); i++) {
+            int32_t y = raw[i] * WAKE_WORD_GAIN;
+            t.wakeClipped += (y > 32767 || y < -32768);
+            wake[i] = (int16_t)y;
+            upload[i] = raw[i];
+        }
+    }
+    t.samples += raw.size();
+    t.blocks += (raw.size() + MIC_AGC_BLOCK - 1) / MIC_AGC_BLOCK;
+    for (size_t i = 0; i < raw.size(); i++) {
+        if (std::abs((int)raw[i]) > SILENCE_THRESHOLD) {
+            t.uploadEnergy += (double)upload[i] * upload[i];
+            t.uploadLoud++;
+        }
+    }
+
+    // The firmware's wake word decision over the wake feed
+    WakeEngine engine;
+    if (!engine.begin(handle->impulse, wakeConfig)) return false;
+    std::vector<int16_t> slice(EI_CLASSIFIER_SLICE_SIZE);
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = [&slice](size_t offset, size_t length, float* out) {
+        return numpy::int16_to_float(&slice[offset], out, length);
+    };
+
+    run_classifier_init(handle);
+    int detections = 0;
+    for (size_t start = 0; start + EI_CLASSIFIER_SLICE_SIZE <= wake.size(); start += EI_CLASSIFIER_SLICE_SIZE) {
+        memcpy(slice.data(), &wake[start], EI_CLASSIFIER_SLICE_SIZE * sizeof(int16_t));
+        ei_impulse_result_t result = {};
+        if (run_classifier_continuous(handle, &signal, &result, false) != EI_IMPULSE_OK) {
+            run_classifier_deinit(handle);
+            return false;
+        }
+        if (engine.update(&result) == WAKE_DETECTED) {
+            detections++;
+            engine.reset();     // The device records and replies before listening again
+        }
+    }
+    run_classifier_deinit(handle);
+
+    if (r.positive) {
+        t.positives++;
+        t.detected += detections > 0;
+    } else {
+        t.falseAccepts += detections;
+        t.negativeHours += r.samples.size() / (3600.0 * EI_CLASSIFIER_FREQUENCY);
+    }
+    return true;
+}
+
+static double dbfs(double rms) {
+    return rms > 0.0 ? 20.0 * log10(rms / 32768.0) : -INFINITY;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    std::vector<double> levels = { -24, -12, -6, 0, 6, 12 };
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--levels") && i + 1 < argc) {
+            levels.clear();
+            for (char* p = strtok(argv[++i], ","); p; p = strtok(nullptr, ",")) levels.push_back(atof(p));
+        } else if (argv[i][0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.empty() || levels.empty()) {
+        fprintf(stderr, "Usage: %s <recordings ...> [--levels -24,-12,-6,0,6,12]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Recording> recordings;
+    for (const std::string& path : paths) findRecordings(path, false, recordings);
+    if (recordings.empty()) {
+        fprintf(stderr, "No recordings found\n");
+        return 1;
+    }
+
+    ei_impulse_handle_t handle(ei_default_impulse.impulse);
+    printf("%-7s %-5s  %10s  %10s %9s  %11s %10s  %9s %14s\n", "level", "path", "input clip", "wake clip",
+        "limited", "upload clip", "speech", "detected", "false accepts");
+    for (double level : levels) {
+        int32_t levelQ12 = (int32_t)lround(pow(10.0, level / 20.0) * 4096.0);
+        for (int agc = 0; agc < 2; agc++) {
+            Tally t;
+            for (const Recording& r : recordings) {
+                if (!evaluate(&handle, r, levelQ12, agc, t)) {
+                    fprintf(stderr, "%s: classification failed\n", r.name.c_str());
+                    return 1;
+                }
+            }
+            char detected[32], falseAccepts[32];
+            snprintf(detected, sizeof(detected), "%d/%d", t.detected, t.positives);
+            snprintf(falseAccepts, sizeof(falseAccepts), "%d (%.1f/h)", t.falseAccepts,
+                t.negativeHours > 0 ? t.falseAccepts / t.negativeHours : 0.0);
+            printf("%+5.0fdB %-5s  %9.3f%%  %9.3f%% %8.2f%%  %10.3f%% %6.1fdBFS  %9s %14s\n", level,
+                agc ? "agc" : "fixed", 100.0 * t.inputClipped / t.samples, 100.0 * t.wakeClipped / t.samples, agc ? 100.0 * t.limitedBlocks / t.blocks : 0.0,
+                100.0 * t.uploadClipped / t.samples,
+                dbfs(t.uploadLoud ? sqrt(t.uploadEnergy / t.uploadLoud) : 0.0), detected, falseAccepts);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,8 @@
+#!/bin/sh
+# Build the mic AGC evaluator against the firmware's Edge Impulse library.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+
+host_program tools/agc_eval/build agc_eval tools/agc_eval/agc_eval.cpp
@@ -0,0 +1,201 @@
+/*
+ * Tensor Arena Report for NOVA
+ * Sizes the TFLite Micro tensor arena of an interpreter (non-EON) build from
+ * the model file, before a firmware build: runs the .tflite once through the
+ * SDK's arena report (edge-impulse-sdk/classifier/ei_arena_report.h) and
+ * prints the persistent / non-persistent / scratch breakdown, each planned
+ * buffer's lifetime, and the minimal arena for the greedy and/or linear
+ * memory planner.
+ *
+ * The kernels are the host build of the firmware's (same flags as
+ * tools/wake_eval), so scratch requests match a device without vendor
+ * kernels. EON builds don't use an arena of this kind, the compiled
+ * model carries its own kTensorArenaSize.
+ *
+ * Build:  tools/arena_report/build.sh
+ * Usage:  arena_report <model.tflite> [--planner greedy|linear|both]
+ *                      [--work-arena 4194304] [--buffers] [--verbose]
+ */
+
+#include "edge-impulse-sdk/classifier/ei_arena_report.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/all_ops_resolver.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_utils.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// ============== Host Porting ==============
+
+static const auto startTime = std::chrono::steady_clock::now();
+static bool verbose = false;
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+// The minimal arena search fails AllocateTensors() on purpose, keep that quiet
+void DebugLog(const char* s) { if (verbose) fputs(s, stderr); }
+
+// ============== Report ==============
+
+static const size_t MAX_BUFFERS = 4096;
+
+static const char* plannerName(ei_arena_planner_t planner) {
+    return planner == EI_ARENA_PLANNER_LINEAR ? "linear" : "greedy";
+}
+
+static const char* operatorName(const tflite::Model* model, int subgraph, int op) {
+    const tflite::SubGraph* sg = model->subgraphs()->Get(subgraph);
+    if (op < 0 || op >= (int)sg->operators()->size()) return "-";
+    const tflite::OperatorCode* code = model->operator_codes()->Get(sg->operators()->Get(op)->opcode_index());
+    return tflite::EnumNameBuiltinOperator(tflite::GetBuiltinCode(code));
+}
+
+static const char* tensorName(const tflite::Model* model, const ei_arena_buffer_t& buffer) {
+    if (buffer.tensor < 0) return "(scratch)";
+    const tflite::Tensor* tensor = model->subgraphs()->Get(buffer.subgraph)->tensors()->Get(buffer.tensor);
+    return tensor->name() ? tensor->name()->c_str() : "";
+}
+
+static void printRecorded(const char* name, const tflite::RecordedAllocation& a) {
+    printf("    %-22s %8zu bytes  (%zu allocations)\n", name, a.used_bytes, a.count);
+}
+
+static void printReport(const tflite::Model* model, const ei_arena_report_t& r,
+                        const std::vector<ei_arena_buffer_t>& buffers, bool listBuffers) {
+    printf("\n%s planner\n", plannerName(r.planner));
+    printf("  minimal arena            %8zu bytes\n", r.minimal_arena_size);
+    printf("  used                     %8zu bytes\n", r.used_bytes);
+    printf("  persistent (tail)        %8zu bytes\n", r.persistent_bytes);
+    printRecorded("eval tensors", r.eval_tensors);
+    printRecorded("tflite tensors", r.tflite_tensors);
+    printRecorded("quantization", r.quantization);
+    printRecorded("op data", r.op_data);
+    printRecorded("variable tensors", r.variables);
+    printRecorded("nodes + registrations", r.node_registrations);
+    printf("  non-persistent (head)    %8zu bytes\n", r.non_persistent_bytes);
+    printf("    activations, no reuse  %8zu bytes\n", r.activation_bytes);
+    printf("    kernel scratch         %8zu bytes\n", r.scratch_bytes);
+    printf("    live peak              %8zu bytes  (operator %d, %s)\n", r.live_peak_bytes,
+        r.live_peak_operator, operatorName(model, 0, r.live_peak_operator));
+    if (r.buffer_count > buffers.size()) {
+        printf("  only the first %zu of %zu buffers recorded\n", buffers.size(), r.buffer_count);
+    }
+
+    if (!listBuffers) return;
+    printf("\n  %4s %7s %8s %8s  %-15s %-15s %s\n", "#", "tensor", "bytes", "offset", "first op", "last op", "name");
+    const size_t count = r.buffer_count < buffers.size() ? r.buffer_count : buffers.size();
+    for (size_t ix = 0; ix < count; ix++) {
+        const ei_arena_buffer_t& b = buffers[ix];
+        char first[32], last[32];
+        snprintf(first, sizeof(first), "%d %s", b.first_used, operatorName(model, b.subgraph, b.first_used));
+        snprintf(last, sizeof(last), "%d %s", b.last_used, operatorName(model, b.subgraph, b.last_used));
+        printf("  %4zu %7d %8u %8u  %-15s %-15s %s\n", ix, b.tensor, b.bytes, b.offset, first, last,
+            tensorName(model, b));
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    const char* planner = "both";
+    size_t workArena = 4 * 1024 * 1024;
+    bool listBuffers = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--planner") && i + 1 < argc) planner = argv[++i];
+        else if (!strcmp(argv[i], "--work-arena") && i + 1 < argc) workArena = strtoul(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--buffers")) listBuffers = true;
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (!path || (strcmp(planner, "greedy") && strcmp(planner, "linear") && strcmp(planner, "both"))) {
+        fprintf(stderr, "Usage: %s <model.tflite> [--planner greedy|linear|both] [--work-arena bytes] [--buffers] [--verbose]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    const long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    // The flatbuffer is read in place, keep it aligned as a model array would be
+    uint8_t* data = (uint8_t*)aligned_alloc(16, (size + 15) / 16 * 16);
+    if (!data || fread(data, 1, size, f) != (size_t)size) {
+        fprintf(stderr, "Can't read %s\n", path);
+        return 1;
+    }
+    fclose(f);
+
+    flatbuffers::Verifier verifier(data, size);
+    if (!tflite::VerifyModelBuffer(verifier)) {
+        fprintf(stderr, "%s is not a TFLite flatbuffer\n", path);
+        return 1;
+    }
+    const tflite::Model* model = tflite::GetModel(data);
+    const tflite::SubGraph* main = model->subgraphs()->Get(0);
+    printf("%s: %ld bytes, %u subgraph(s), %u tensors, %u operators\n", path, size,
+        model->subgraphs()->size(), main->tensors()->size(), main->operators()->size());
+
+    static tflite::AllOpsResolver resolver;
+    std::vector<ei_arena_planner_t> planners;
+    if (strcmp(planner, "linear")) planners.push_back(EI_ARENA_PLANNER_GREEDY);
+    if (strcmp(planner, "greedy")) planners.push_back(EI_ARENA_PLANNER_LINEAR);
+
+    std::vector<ei_arena_report_t> reports;
+    for (ei_arena_planner_t p : planners) {
+        std::vector<ei_arena_buffer_t> buffers(MAX_BUFFERS);
+        ei_arena_report_t report;
+        EI_IMPULSE_ERROR res = ei_arena_report(data, resolver, p, workArena, &report, buffers.data(), buffers.size());
+        if (res != EI_IMPULSE_OK) {
+            fprintf(stderr, "%s planner: arena report failed (%d)\n", plannerName(p), res);
+            return 1;
+        }
+        printReport(model, report, buffers, listBuffers);
+        reports.push_back(report);
+    }
+
+    if (reports.size() == 2) {
+        const ei_arena_report_t& g = reports[0];
+        const ei_arena_report_t& l = reports[1];
+        printf("\ngreedy vs linear: head %zu vs %zu bytes, minimal arena %zu vs %zu bytes (%.1fx)\n",
+            g.non_persistent_bytes, l.non_persistent_bytes, g.minimal_arena_size, l.minimal_arena_size,
+            g.minimal_arena_size ? (double)l.minimal_arena_size / g.minimal_arena_size : 0.0);
+    }
+
+    // inference_tflite_setup() allocates this from ei_aligned_calloc(16, ...)
+    printf("\nSuggested: #define EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE %zu  (arena_size in model_variables.h, %s planner)\n",
+        reports[0].minimal_arena_size, plannerName(reports[0].planner));
+    free(data);
+    return 0;
+}
@@ -0,0 +1,15 @@
+#!/bin/sh
+# Build the tensor arena report CLI against the firmware's Edge Impulse library.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+OUT="$ROOT/tools/arena_report/build"
+
+# Only the TFLite Micro runtime is needed (kissfft for its RFFT2D kernel)
+sdk_objects
+mkdir -p "$OUT"
+$CXX -std=gnu++17 $HOST_FLAGS "$ROOT/tools/arena_report/arena_report.cpp" \
+    $(sdk_object_list -e '^edge-impulse-sdk/tensorflow/' -e '^edge-impulse-sdk/third_party/' -e '^edge-impulse-sdk/dsp/kissfft/') \
+    -lpthread -o "$OUT/arena_report"
+echo "Built $OUT/arena_report"
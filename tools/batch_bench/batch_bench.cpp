@@ -0,0 +1,286 @@
+/*
+ * Batch Classification Benchmark for NOVA
+ * Classifies every window of a set of recordings three ways and compares:
+ *
+ *   loop     run_classifier() per window, the single-call baseline
+ *   windows  run_classifier_batch(), one signal per window
+ *   signal   run_classifier_batch_signal(), the recording plus a hop size
+ *
+ * (edge-impulse-sdk/classifier/ei_run_classifier_batch.h). Reports windows per
+ * second for each and checks that both batch APIs give the loop's scores bit
+ * for bit. Samples get the firmware's 8x mic gain, as in tools/wake_eval.
+ *
+ * Recordings: 16kHz 16-bit mono WAV files, or directories of them. Without
+ * any, a minute of seeded noise is used.
+ *
+ * Build:  tools/batch_bench/build.sh
+ * Usage:  batch_bench [recordings ...] [--hop 320] [--repeat 3]
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier_batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+// ============== Host Porting ==============
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+// Keep in sync with src/main.cpp
+#define WAKE_WORD_GAIN          8
+
+// ============== Recordings ==============
+
+struct Recording {
+    std::string name;
+    std::vector<float> samples;     // after the mic gain
+};
+
+static bool loadWav(const std::string& path, Recording& r) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool formatOk = false;
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, &data[pos + 4], 4);
+        const uint8_t* body = &data[pos + 8];
+
+        if (memcmp(&data[pos], "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint16_t format, channels, bits;
+            uint32_t rate;
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&rate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+            formatOk = (format == 1 && channels == 1 && bits == 16 && rate == EI_CLASSIFIER_FREQUENCY);
+        } else if (memcmp(&data[pos], "data", 4) == 0) {
+            if (!formatOk) return false;
+            size_t available = data.size() - (pos + 8);
+            size_t count = (chunkSize < available ? chunkSize : available) / 2;
+            r.name = path;
+            r.samples.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                int16_t s;
+                memcpy(&s, body + i * 2, 2);
+                r.samples[i] = (float)(int16_t)(s * WAKE_WORD_GAIN);
+            }
+            return true;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+static void findRecordings(const std::string& path, std::vector<Recording>& out) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        Recording r;
+        if (loadWav(path, r)) out.push_back(r);
+        else fprintf(stderr, "Skipping %s (need %d Hz 16-bit mono PCM)\n", path.c_str(), EI_CLASSIFIER_FREQUENCY);
+        return;
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) {
+        std::string full = path + "/" + name;
+        if (stat(full.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode) || (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0)) {
+            findRecordings(full, out);
+        }
+    }
+}
+
+// ============== Benchmark ==============
+
+static signal_t bufferSignal(const float* data, size_t length) {
+    signal_t signal;
+    signal.total_length = length;
+    signal.get_data = [data](size_t offset, size_t length, float* out) {
+        memcpy(out, data + offset, length * sizeof(float));
+        return 0;
+    };
+    return signal;
+}
+
+// Scores of a result, compared bit for bit
+static bool sameScores(const ei_impulse_result_t& a, const ei_impulse_result_t& b) {
+    for (int l = 0; l < EI_CLASSIFIER_LABEL_COUNT; l++) {
+        if (memcmp(&a.classification[l].value, &b.classification[l].value, sizeof(float)) != 0 ||
+            strcmp(a.classification[l].label, b.classification[l].label) != 0) {
+            return false;
+        }
+    }
+    return memcmp(&a.anomaly, &b.anomaly, sizeof(float)) == 0;
+}
+
+struct Totals {
+    size_t windows = 0;
+    uint64_t us[3] = { 0, 0, 0 };   // loop, windows, signal
+    size_t mismatches[2] = { 0, 0 };
+};
+
+static bool benchRecording(const Recording& r, size_t hop, int repeat, Totals& t) {
+    const size_t windowLength = EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE;
+    const size_t count = run_classifier_batch_window_count(&ei_default_impulse, r.samples.size(), hop);
+    if (count == 0) return true;
+
+    std::vector<ei_impulse_result_t> loop(count), windows(count), batch(count);
+    std::vector<signal_t> signals(count);
+    for (size_t w = 0; w < count; w++) {
+        signals[w] = bufferSignal(r.samples.data() + w * hop, windowLength);
+    }
+    signal_t longSignal = bufferSignal(r.samples.data(), r.samples.size());
+
+    uint64_t best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+    for (int i = 0; i < repeat; i++) {
+        uint64_t start = ei_read_timer_us();
+        for (size_t w = 0; w < count; w++) {
+            if (run_classifier(&signals[w], &loop[w], false) != EI_IMPULSE_OK) {
+                fprintf(stderr, "%s: run_classifier failed on window %zu\n", r.name.c_str(), w);
+                return false;
+            }
+        }
+        best[0] = std::min(best[0], ei_read_timer_us() - start);
+
+        start = ei_read_timer_us();
+        EI_IMPULSE_ERROR res = run_classifier_batch(signals.data(), count, windows.data(), false);
+        best[1] = std::min(best[1], ei_read_timer_us() - start);
+        if (res != EI_IMPULSE_OK) {
+            fprintf(stderr, "%s: run_classifier_batch failed (%d)\n", r.name.c_str(), res);
+            return false;
+        }
+
+        size_t classified = 0;
+        start = ei_read_timer_us();
+        res = run_classifier_batch_signal(&longSignal, hop, batch.data(), count, &classified, false);
+        best[2] = std::min(best[2], ei_read_timer_us() - start);
+        if (res != EI_IMPULSE_OK || classified != count) {
+            fprintf(stderr, "%s: run_classifier_batch_signal failed (%d, %zu of %zu windows)\n",
+                r.name.c_str(), res, classified, count);
+            return false;
+        }
+    }
+
+    size_t mismatches[2] = { 0, 0 };
+    for (size_t w = 0; w < count; w++) {
+        if (!sameScores(loop[w], windows[w])) mismatches[0]++;
+        if (!sameScores(loop[w], batch[w])) mismatches[1]++;
+    }
+    printf("  %-40s %6zu windows  loop %8.1f  windows %8.1f  signal %8.1f win/s  mismatches %zu/%zu\n",
+        r.name.c_str(), count, count * 1e6 / best[0], count * 1e6 / best[1], count * 1e6 / best[2],
+        mismatches[0], mismatches[1]);
+
+    t.windows += count;
+    for (int i = 0; i < 3; i++) t.us[i] += best[i];
+    t.mismatches[0] += mismatches[0];
+    t.mismatches[1] += mismatches[1];
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    size_t hop = 320;
+    int repeat = 3;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--hop") && i + 1 < argc) hop = strtoul(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = atoi(argv[++i]);
+        else if (argv[i][0] != '-') paths.push_back(argv[i]);
+        else {
+            hop = 0;
+            break;
+        }
+    }
+    if (hop == 0 || repeat < 1) {
+        fprintf(stderr, "Usage: %s [recordings ...] [--hop 320] [--repeat 3]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Recording> recordings;
+    for (const std::string& path : paths) {
+        findRecordings(path, recordings);
+    }
+    if (recordings.empty()) {
+        if (!paths.empty()) {
+            fprintf(stderr, "No recordings found\n");
+            return 1;
+        }
+        Recording r;
+        r.name = "(60 s of noise)";
+        std::mt19937 rng(7);
+        std::normal_distribution<float> noise(0.0f, 2000.0f);
+        r.samples.resize(60 * EI_CLASSIFIER_FREQUENCY);
+        for (float& s : r.samples) s = (float)(int16_t)std::max(-32768.0f, std::min(32767.0f, noise(rng)));
+        recordings.push_back(r);
+    }
+
+    printf("hop %zu samples (%.1f ms), best of %d\n", hop, hop * 1000.0 / EI_CLASSIFIER_FREQUENCY, repeat);
+    Totals t;
+    for (const Recording& r : recordings) {
+        if (!benchRecording(r, hop, repeat, t)) return 1;
+    }
+    if (t.windows == 0) {
+        fprintf(stderr, "No recording is a window long\n");
+        return 1;
+    }
+
+    printf("\n%zu windows: loop %.1f, windows %.1f (%.2fx), signal %.1f (%.2fx) windows/s\n", t.windows,
+        t.windows * 1e6 / t.us[0],
+        t.windows * 1e6 / t.us[1], (double)t.us[0] / t.us[1],
+        t.windows * 1e6 / t.us[2], (double)t.us[0] / t.us[2]);
+    printf("mismatching windows: %zu (windows), %zu (signal)\n", t.mismatches[0], t.mismatches[1]);
+    return (t.mismatches[0] || t.mismatches[1]) ? 1 : 0;
+}
@@ -0,0 +1,8 @@
+#!/bin/sh
+# Build the batch classification benchmark against the firmware's Edge Impulse library.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+
+host_program tools/batch_bench/build batch_bench tools/batch_bench/batch_bench.cpp
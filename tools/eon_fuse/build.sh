@@ -0,0 +1,21 @@
+#!/bin/sh
+# Fold the RESHAPEs and fuse CONV_2D + MAX_POOL_2D of the EON compiled model,
+# into tflite-model/<model>_fused.h next to the model, and hook the model up to
+# it (tools/eon_hooks). Run again whenever the model is re-exported, after
+# tools/eon_prepack/build.sh.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+OUT="$ROOT/tools/eon_fuse/build"
+
+MODEL=$(cd "$LIB" && ls tflite-model/*_compiled.cpp)
+HEADER="$LIB/${MODEL%_compiled.cpp}_fused.h"
+python3 "$ROOT/tools/eon_hooks/eon_hooks.py" "$LIB/$MODEL"
+
+# The model is compiled into the fuser, so leave its own object out
+sdk_objects -v '^tflite-model/'
+mkdir -p "$OUT"
+$CXX -std=gnu++17 $HOST_FLAGS -DEI_EON_FUSE -DEI_EON_MODEL_SOURCE="\"$MODEL\"" \
+    "$ROOT/tools/eon_fuse/eon_fuse.cpp" $(sdk_object_list -v '^tflite-model/') -lpthread -o "$OUT/eon_fuse"
+"$OUT/eon_fuse" "$HEADER" "$@"
@@ -0,0 +1,445 @@
+/*
+ * EON Graph Fuser for NOVA
+ * Rewrites the node list of an EON compiled model ahead of time and writes
+ * the result next to the model, which runs it in place of its own:
+ *
+ *  - RESHAPEs between arena tensors of the same size are folded away, the
+ *    output simply aliases the input's buffer.
+ *  - CONV_2D followed by MAX_POOL_2D (RESHAPEs in between folded) becomes one
+ *    CONV_2D_MAX_POOL_2D node (micro/kernels/conv_max_pool.cpp), so the
+ *    convolution output is never stored.
+ *
+ * The arena tensors of the new graph are planned again with the SDK's
+ * greedy planner, and the arena shrinks by what the fused tensors and the
+ * RESHAPE copies took. The persistent tail (op data, packed filters, kernel
+ * scratch) is measured by running init, and what used to overflow to the heap
+ * is given room in the arena. Measured on the host, 64-bit pointers make the
+ * op data a little larger than on the device, so the tail is an overestimate.
+ *
+ * The model source is compiled into this tool (EI_EON_MODEL_SOURCE). Before
+ * writing anything the tool runs both graphs on the same random inputs and
+ * refuses to emit the rewrite unless every output is byte-identical. The
+ * header records the export's kEonModelChecksum (tools/eon_hooks), and the
+ * model doesn't build against one made from another export.
+ *
+ * Build + run:  tools/eon_fuse/build.sh  (after tools/eon_prepack/build.sh,
+ *               the prepacked filters change the tail)
+ * Usage:        eon_fuse <output header> [--runs 2000]
+ */
+
+#include EI_EON_MODEL_SOURCE
+
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============== Host Porting ==============
+// Overflow buffers of the persistent tail are counted, they belong in the arena
+
+static size_t overflowBytes = 0;
+
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) {
+    overflowBytes += (nitems * size + 15) / 16 * 16;
+    return calloc(nitems, size);
+}
+void ei_free(void *ptr) { free(ptr); }
+uint64_t ei_read_timer_us() { return 0; }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+// ============== Graph ==============
+
+static const char* paddingName(TfLitePadding padding) {
+    switch (padding) {
+        case kTfLitePaddingSame: return "kTfLitePaddingSame";
+        case kTfLitePaddingValid: return "kTfLitePaddingValid";
+        default: return "kTfLitePaddingUnknown";
+    }
+}
+
+static const char* activationName(TfLiteFusedActivation activation) {
+    static const char* names[] = { "kTfLiteActNone", "kTfLiteActRelu", "kTfLiteActReluN1To1",
+        "kTfLiteActRelu6", "kTfLiteActTanh", "kTfLiteActSignBit", "kTfLiteActSigmoid" };
+    return names[activation];
+}
+
+static bool isArena(int tensor) {
+    return tensorData[tensor].allocation_type == kTfLiteArenaRw;
+}
+
+static bool sameQuantization(const TensorInfo_t& a, const TensorInfo_t& b) {
+    if (a.quantization.type != kTfLiteAffineQuantization || b.quantization.type != kTfLiteAffineQuantization) {
+        return false;
+    }
+    const TfLiteAffineQuantization* qa = (const TfLiteAffineQuantization*)a.quantization.params;
+    const TfLiteAffineQuantization* qb = (const TfLiteAffineQuantization*)b.quantization.params;
+    if (qa->scale->size != 1 || qb->scale->size != 1) return false;
+    return qa->scale->data[0] == qb->scale->data[0] && qa->zero_point->data[0] == qb->zero_point->data[0];
+}
+
+// Buffer classes: tensors sharing one buffer after RESHAPE folding
+struct Classes {
+    std::vector<int> parent;
+    explicit Classes(int count) : parent(count) {
+        for (int i = 0; i < count; i++) parent[i] = i;
+    }
+    int find(int t) { return parent[t] == t ? t : parent[t] = find(parent[t]); }
+    void merge(int a, int b) { parent[find(b)] = find(a); }
+};
+
+struct FusedNode {
+    int node;              // node of tflNodes it replaces
+    int pool;              // fused MAX_POOL_2D node, -1 for none
+    ConvMaxPoolParams params;
+};
+
+// Pooling window of `pool` in the coordinates of the convolution output, or
+// false when the RESHAPEs in between reorder the pixels
+static bool mapPool(const TfLiteIntArray* convDims, const TfLiteIntArray* poolDims,
+                    const TfLitePoolParams& pool, TfLitePoolParams* mapped) {
+    if (convDims->size != 4 || poolDims->size != 4 ||
+        convDims->data[0] != poolDims->data[0] || convDims->data[3] != poolDims->data[3]) {
+        return false;
+    }
+    *mapped = pool;
+    const int h = convDims->data[1], w = convDims->data[2];
+    if (h == poolDims->data[1] && w == poolDims->data[2]) return true;
+    // [1, n] <-> [n, 1] keeps the pixel order, only the axes swap
+    if (h == poolDims->data[2] && w == poolDims->data[1] && (h == 1 || w == 1)) {
+        mapped->stride_width = pool.stride_height;
+        mapped->stride_height = pool.stride_width;
+        mapped->filter_width = pool.filter_height;
+        mapped->filter_height = pool.filter_width;
+        return true;
+    }
+    return false;
+}
+
+// ============== Running ==============
+
+struct RunResult {
+    TfLiteStatus status;
+    size_t tail;       // persistent tail after init, overflow included
+    double invokeUs;   // mean per invoke
+    std::vector<int8_t> outputs;
+};
+
+static void* arenaAlloc(size_t align, size_t size) {
+    return aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+static RunResult run(const std::vector<int8_t>& inputs, size_t inputBytes, int runs) {
+    RunResult r;
+    overflowBytes = 0;
+    r.status = tflite_learn_855743_3_init(arenaAlloc);
+    r.tail = (size_t)(tensor_arena + kTensorArenaSize - current_location) + overflowBytes;
+    r.invokeUs = 0;
+    if (r.status != kTfLiteOk) {
+        tflite_learn_855743_3_reset(free);
+        return r;
+    }
+
+    TfLiteTensor input, output;
+    double total = 0;
+    for (int i = 0; i < runs && r.status == kTfLiteOk; i++) {
+        tflite_learn_855743_3_input(0, &input);
+        memcpy(input.data.data, &inputs[i * inputBytes], inputBytes);
+        const auto start = std::chrono::steady_clock::now();
+        r.status = tflite_learn_855743_3_invoke();
+        total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        tflite_learn_855743_3_output(0, &output);
+        const int8_t* data = (const int8_t*)output.data.data;
+        r.outputs.insert(r.outputs.end(), data, data + output.bytes);
+    }
+    r.invokeUs = total / runs;
+    tflite_learn_855743_3_reset(free);
+    return r;
+}
+
+static size_t align16(size_t bytes) {
+    return (bytes + 15) / 16 * 16;
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    int runs = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--runs") && i + 1 < argc) runs = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (!path || runs <= 0) {
+        fprintf(stderr, "Usage: %s <output header> [--runs 2000]\n", argv[0]);
+        return 2;
+    }
+
+    const int nodeCount = (int)(sizeof(tflNodes) / sizeof(tflNodes[0]));
+    const int tensorCount = (int)(sizeof(tensorData) / sizeof(tensorData[0]));
+    const size_t subgraphs = sizeof(tflNodes_subgraph_index) / sizeof(tflNodes_subgraph_index[0]) - 1;
+    const int inputTensor = in_tensor_indices[0];
+    const int outputTensor = out_tensor_indices[0];
+    // Only single subgraph, single input / output models are rewritten
+    const bool supported = subgraphs == 1 &&
+        sizeof(in_tensor_indices) == sizeof(int) && sizeof(out_tensor_indices) == sizeof(int) &&
+        tensorData[inputTensor].type == kTfLiteInt8 && tensorData[outputTensor].type == kTfLiteInt8;
+
+    // Fold RESHAPEs
+    Classes classes(tensorCount);
+    std::vector<bool> dropped(nodeCount, false);
+    for (int n = 0; supported && n < nodeCount; n++) {
+        if (used_ops[n] != OP_RESHAPE) continue;
+        const int in = tflNodes[n].inputs->data[0];
+        const int out = tflNodes[n].outputs->data[0];
+        if (!isArena(in) || !isArena(out) || tensorData[in].bytes != tensorData[out].bytes || out == inputTensor) {
+            continue;
+        }
+        classes.merge(in, out);
+        dropped[n] = true;
+    }
+
+    // Fuse CONV_2D + MAX_POOL_2D whose convolution output nothing else reads
+    std::vector<FusedNode> fused;
+    std::vector<bool> stored(tensorCount, true);
+    for (int n = 0; supported && n < nodeCount; n++) {
+        if (dropped[n]) continue;
+        FusedNode f;
+        f.node = n;
+        f.pool = -1;
+        if (used_ops[n] == OP_CONV_2D) {
+            const TfLiteIntArray* inputs = tflNodes[n].inputs;
+            const int convOut = tflNodes[n].outputs->data[0];
+            const int cls = classes.find(convOut);
+            int consumers = 0, pool = -1;
+            for (int m = 0; m < nodeCount; m++) {
+                if (dropped[m]) continue;
+                for (int ix = 0; ix < tflNodes[m].inputs->size; ix++) {
+                    const int t = tflNodes[m].inputs->data[ix];
+                    if (t >= 0 && classes.find(t) == cls) {
+                        consumers++;
+                        pool = m;
+                    }
+                }
+            }
+            const bool exposed = classes.find(inputTensor) == cls || classes.find(outputTensor) == cls;
+            if (consumers == 1 && !exposed && used_ops[pool] == OP_MAX_POOL_2D) {
+                const int poolIn = tflNodes[pool].inputs->data[0];
+                const int poolOut = tflNodes[pool].outputs->data[0];
+                const TfLitePoolParams& poolParams = *(const TfLitePoolParams*)tflNodes[pool].builtin_data;
+                TfLitePoolParams mapped;
+                if (tensorData[inputs->data[0]].type == kTfLiteInt8 &&
+                    tensorData[inputs->data[1]].allocation_type == kTfLiteMmapRo &&
+                    tensorData[inputs->data[1]].type == kTfLiteInt8 &&
+                    tensorData[poolOut].type == kTfLiteInt8 &&
+                    tensorData[inputs->data[1]].dims->data[3] == tensorData[inputs->data[0]].dims->data[3] &&
+                    sameQuantization(tensorData[convOut], tensorData[poolOut]) &&
+                    mapPool(tensorData[convOut].dims, tensorData[poolIn].dims, poolParams, &mapped) &&
+                    // Windows don't overlap, and one fits a GEMM block
+                    mapped.stride_width >= mapped.filter_width && mapped.stride_height >= mapped.filter_height &&
+                    mapped.filter_width * mapped.filter_height <= tflite::optimized_integer_ops::int8_gemm::kRowBlock) {
+                    f.pool = pool;
+                    f.params.conv = *(const TfLiteConvParams*)tflNodes[n].builtin_data;
+                    f.params.pool = mapped;
+                    f.params.pool.computed.padding = TfLitePaddingValues();
+                    dropped[pool] = true;
+                    for (int t = 0; t < tensorCount; t++) {
+                        if (isArena(t) && classes.find(t) == cls) stored[t] = false;
+                    }
+                }
+            }
+        }
+        fused.push_back(f);
+    }
+
+    int fusedCount = 0;
+    for (const FusedNode& f : fused) fusedCount += f.pool >= 0;
+    if (fusedCount == 0) {
+        remove(path);
+        fprintf(stderr, "No CONV_2D + MAX_POOL_2D to fuse, removed %s\n", path);
+        return 0;
+    }
+
+    // Plan the arena tensors of the new graph, one buffer per class
+    const int count = (int)fused.size();
+    std::vector<int> first(tensorCount, -1), last(tensorCount, -1);
+    std::vector<size_t> bytes(tensorCount, 0);
+    auto use = [&](int t, int time) {
+        if (t < 0 || !isArena(t)) return;
+        const int c = classes.find(t);
+        if (first[c] < 0 || time < first[c]) first[c] = time;
+        if (time > last[c]) last[c] = time;
+        if (tensorData[t].bytes > bytes[c]) bytes[c] = tensorData[t].bytes;
+    };
+    use(inputTensor, 0);
+    use(outputTensor, count - 1);
+    for (int i = 0; i < count; i++) {
+        const TfLiteNode& node = tflNodes[fused[i].node];
+        const TfLiteIntArray* outputs = fused[i].pool >= 0 ? tflNodes[fused[i].pool].outputs : node.outputs;
+        for (int ix = 0; ix < node.inputs->size; ix++) use(node.inputs->data[ix], i);
+        for (int ix = 0; ix < outputs->size; ix++) use(outputs->data[ix], i);
+    }
+
+    std::vector<unsigned char> plannerScratch(tensorCount * tflite::GreedyMemoryPlanner::per_buffer_size());
+    tflite::GreedyMemoryPlanner planner;
+    planner.Init(plannerScratch.data(), (int)plannerScratch.size());
+    std::vector<int> bufferOf(tensorCount, -1);
+    int buffers = 0;
+    for (int c = 0; c < tensorCount; c++) {
+        if (first[c] < 0) continue;
+        planner.AddBuffer((int)align16(bytes[c]), first[c], last[c]);
+        bufferOf[c] = buffers++;
+    }
+    const size_t head = planner.GetMaximumMemorySize();
+    std::vector<int32_t> offsets(tensorCount, -1);
+    for (int t = 0; t < tensorCount; t++) {
+        if (!isArena(t) || !stored[t] || bufferOf[classes.find(t)] < 0) continue;
+        int offset;
+        planner.GetOffsetForBuffer(bufferOf[classes.find(t)], &offset);
+        offsets[t] = offset;
+    }
+
+    // Same random inputs through both graphs
+    const size_t inputBytes = tensorData[inputTensor].bytes;
+    std::vector<int8_t> inputs(runs * inputBytes);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-128, 127);
+    for (int8_t& v : inputs) v = (int8_t)dist(rng);
+
+    size_t originalHead = 0;
+    for (int t = 0; t < tensorCount; t++) {
+        if (isArena(t)) originalHead = std::max(originalHead, (size_t)(uintptr_t)tensorData[t].data + tensorData[t].bytes);
+    }
+    const RunResult original = run(inputs, inputBytes, runs);
+
+    std::vector<TfLiteNode> nodes(count);
+    std::vector<used_operators_e> ops(count);
+    std::vector<TfLiteIntArray*> poolOutputs(count, nullptr);
+    for (int i = 0; i < count; i++) {
+        nodes[i] = tflNodes[fused[i].node];
+        ops[i] = used_ops[fused[i].node];
+        if (fused[i].pool >= 0) {
+            nodes[i].outputs = tflNodes[fused[i].pool].outputs;
+            nodes[i].builtin_data = &fused[i].params;
+            ops[i] = OP_CONV_2D_MAX_POOL_2D;
+        }
+    }
+    const size_t subgraphIndex[] = { 0, (size_t)count };
+    std::vector<TensorInfo_t> saved(tensorData, tensorData + tensorCount);
+    for (int t = 0; t < tensorCount; t++) {
+        if (!isArena(t)) continue;
+        if (offsets[t] < 0) {
+            tensorData[t].allocation_type = kTfLiteMmapRo;
+            tensorData[t].data = nullptr;
+        } else {
+            tensorData[t].data = (void*)(uintptr_t)offsets[t];
+        }
+    }
+    const Graph_t originalGraph = graph;
+    graph.nodes = nodes.data();
+    graph.ops = ops.data();
+    graph.subgraph_index = subgraphIndex;
+    graph.node_count = count;
+    const RunResult rewritten = run(inputs, inputBytes, runs);
+    graph = originalGraph;
+    std::copy(saved.begin(), saved.end(), tensorData);
+
+    if (original.status != kTfLiteOk || rewritten.status != kTfLiteOk) {
+        fprintf(stderr, "Run failed (original %d, fused %d)\n", original.status, rewritten.status);
+        return 1;
+    }
+    if (original.outputs != rewritten.outputs) {
+        size_t diff = 0;
+        for (size_t i = 0; i < original.outputs.size(); i++) diff += original.outputs[i] != rewritten.outputs[i];
+        fprintf(stderr, "Fused graph differs in %zu of %zu output bytes, not written\n", diff, original.outputs.size());
+        return 1;
+    }
+
+    const size_t originalArena = align16(originalHead) + original.tail;
+    const size_t fusedArena = align16(head) + rewritten.tail;
+
+    std::string body, entries, offsetLines;
+    char line[512];
+    for (const FusedNode& f : fused) {
+        if (f.pool >= 0) {
+            const TfLiteConvParams& c = f.params.conv;
+            const TfLitePoolParams& p = f.params.pool;
+            snprintf(line, sizeof(line),
+                "\n// node %d CONV_2D + node %d MAX_POOL_2D, pooling window in the convolution's axes\n"
+                "const ConvMaxPoolParams fused_opdata%d = {\n"
+                "  { %s, %d,%d, %s, %d,%d },\n"
+                "  { %s, %d,%d, %d,%d, %s, { { 0,0, 0, 0 } } },\n"
+                "};\n",
+                f.node, f.pool, f.node,
+                paddingName(c.padding), c.stride_width, c.stride_height, activationName(c.activation),
+                c.dilation_width_factor, c.dilation_height_factor,
+                paddingName(p.padding), p.stride_width, p.stride_height, p.filter_width, p.filter_height,
+                activationName(p.activation));
+            body += line;
+            const TfLiteIntArray* outputs = tflNodes[f.pool].outputs;
+            snprintf(line, sizeof(line), "const FusedIntArray<%d> fused_outputs%d = { %d, { ", outputs->size, f.node, outputs->size);
+            body += line;
+            for (int ix = 0; ix < outputs->size; ix++) {
+                snprintf(line, sizeof(line), "%s%d", ix ? "," : "", outputs->data[ix]);
+                body += line;
+            }
+            body += " } };\n";
+            snprintf(line, sizeof(line), "  { %d, (const TfLiteIntArray*)&fused_outputs%d, &fused_opdata%d },\n",
+                f.node, f.node, f.node);
+        } else {
+            snprintf(line, sizeof(line), "  { %d, nullptr, nullptr },\n", f.node);
+        }
+        entries += line;
+    }
+    for (int t = 0; t < tensorCount; t++) {
+        if (!isArena(t)) continue;
+        snprintf(line, sizeof(line), "  { %d, %d },\n", t, (int)offsets[t]);
+        offsetLines += line;
+    }
+
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Can't write %s\n", path);
+        return 1;
+    }
+    fprintf(f,
+        "// Generated by tools/eon_fuse, do not edit. Run it again after re-exporting the model\n"
+        "// (and after tools/eon_prepack). The model's graph with RESHAPEs folded and\n"
+        "// CONV_2D + MAX_POOL_2D fused, included by the compiled model.\n"
+        "// %d -> %d nodes, arena %zu -> %zu bytes (tensors %zu -> %zu, persistent %zu -> %zu)\n"
+        "\n// kEonModelChecksum of the export it was made from, the model doesn't build with another\n"
+        "constexpr uint32_t kFusedModelChecksum = 0x%08xu;\n"
+        "\nconst int kFusedTensorArenaSize = %zu;\n",
+        nodeCount, count, originalArena, fusedArena, align16(originalHead), align16(head),
+        original.tail, rewritten.tail, (unsigned)kEonModelChecksum, fusedArena);
+    fputs(body.c_str(), f);
+    fprintf(f, "\nconst FusedNodeInfo_t fused_nodes[] = {\n%s};\n", entries.c_str());
+    fprintf(f, "const size_t fused_nodes_subgraph_index[] = {0, %d, };\n", count);
+    fprintf(f, "\n// { tensor, arena offset }, -1: not stored any more\nconst int32_t fused_tensor_offsets[][2] = {\n%s};\n",
+        offsetLines.c_str());
+    fclose(f);
+
+    for (const FusedNode& fn : fused) {
+        if (fn.pool >= 0) fprintf(stderr, "Fused node %d CONV_2D + node %d MAX_POOL_2D\n", fn.node, fn.pool);
+    }
+    fprintf(stderr, "%d -> %d nodes, arena %zu -> %zu bytes (tensors %zu -> %zu, persistent %zu -> %zu)\n",
+        nodeCount, count, originalArena, fusedArena, align16(originalHead), align16(head),
+        original.tail, rewritten.tail);
+    fprintf(stderr, "%d runs bit-exact, invoke %.2f -> %.2f us\n", runs, original.invokeUs, rewritten.invokeUs);
+    fprintf(stderr, "Wrote %s\n", path);
+    return 0;
+}
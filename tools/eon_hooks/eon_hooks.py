@@ -0,0 +1,317 @@
+#!/usr/bin/env python3
+"""
+Hooks for the build-time EON tools, inserted into the EON compiled model.
+
+The compiled model (tflite-model/<model>_compiled.cpp) is generated by Edge
+Impulse and replaced on every re-export. The hooks that make it pick up what
+tools/eon_prepack and tools/eon_fuse write are not edited into it by hand:
+this script inserts them, each between "eon_hooks begin" / "eon_hooks end"
+lines, at anchors found in the exported code. An exported line a hook
+rewrites is kept in it as an "eon_hooks was" comment. Running the script
+again first restores the export, so it can be run on a fresh export or on an
+already hooked model alike.
+
+  prepacked   includes <model>_prepacked.h when present, and hands its table
+              to the kernels for their prepare in init; like the fused
+              header, it must have been made from this export
+  fused       includes <model>_fused.h when present, and runs its graph in
+              place of the exported one; the header must have been made from
+              this export (kEonModelChecksum), or the model doesn't build
+
+Usage:  eon_hooks.py [--check] <model>_compiled.cpp
+        --check  change nothing, fail if the hooks are missing or were edited
+"""
+
+import os
+import re
+import sys
+
+BEGIN = "// eon_hooks begin: "
+END = "// eon_hooks end: "
+WAS = "// eon_hooks was: "
+
+
+class HookError(Exception):
+    pass
+
+
+def strip(lines):
+    """The model as exported, without what an earlier run inserted."""
+    out = []
+    hook = None
+    for line in lines:
+        if hook is None and line.startswith(BEGIN):
+            hook = line[len(BEGIN):].strip()
+        elif hook is not None:
+            if line.startswith(WAS):
+                out.append(line[len(WAS):])
+            elif line.strip() == END + hook:
+                hook = None
+        else:
+            out.append(line)
+    if hook is not None:
+        raise HookError("hook '%s' has no end line" % hook)
+    return out
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def matches(regex, line):
+    return not line.startswith("// eon_hooks") and regex.search(line)
+
+
+def find(lines, pattern, start=0, stop=None, step=1):
+    """Index of the only line matching pattern (the first, walking by step)."""
+    regex = re.compile(pattern)
+    if step > 0:
+        indices = range(start, len(lines) if stop is None else stop)
+        found = [i for i in indices if matches(regex, lines[i])]
+        if len(found) != 1:
+            raise HookError("%d lines match /%s/, expected 1" % (len(found), pattern))
+        return found[0]
+    for i in range(start, -1, -1):
+        if matches(regex, lines[i]):
+            return i
+    raise HookError("no line matches /%s/" % pattern)
+
+
+def block(name, text, was=()):
+    return ([BEGIN + name + "\n"] + [WAS + l for l in was] +
+            [l + "\n" for l in text.strip("\n").split("\n")] + [END + name + "\n"])
+
+
+def rewrite(lines, name, start, stop, rewrite_line):
+    """Passes lines [start, stop) through rewrite_line, a block per run of lines it changes."""
+    changed = lambda line: not line.startswith("// eon_hooks") and rewrite_line(line) != line
+    i = start
+    while i < stop:
+        if not changed(lines[i]):
+            i += 1
+            continue
+        end = i
+        while end < stop and changed(lines[end]):
+            end += 1
+        old = lines[i:end]
+        new = block(name, "".join(rewrite_line(l) for l in old), was=old)
+        lines[i:end] = new
+        stop += len(new) - len(old)
+        i += len(new)
+    return lines
+
+
+def prepacked(lines, model, checksum):
+    # After the exported includes: EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM and the table's type
+    first_if = next(i for i, l in enumerate(lines) if l.startswith("#if"))
+    includes = find(lines, r"^#include ", start=first_if, step=-1)
+    lines[includes + 1:includes + 1] = block("prepacked", """
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h"
+""")
+
+    # Where the constant tensor data it points into has been defined
+    tensors = find(lines, r"^TensorInfo_t tensorData\[\] = \{")
+    lines[tensors:tensors] = block("prepacked", """
+// Filters packed for the int8 GEMM kernels ahead of time, by tools/eon_prepack
+// (which compiles this file itself without them)
+#if EI_CLASSIFIER_TFLITE_ENABLE_INT8_GEMM && !defined(EI_EON_PREPACK)
+#ifdef __has_include
+#if __has_include("tflite-model/%(model)s_prepacked.h")
+#include "tflite-model/%(model)s_prepacked.h"
+#define EI_EON_PREPACKED_FILTERS 1
+static_assert(kPrepackedModelChecksum == kEonModelChecksum,
+  "tflite-model/%(model)s_prepacked.h was made from another export of the model, run tools/eon_prepack/build.sh");
+#endif
+#endif // __has_include
+#endif
+""" % {"model": model})
+
+    # Before the loop over the nodes' prepare in init
+    init = find(lines, r"^TfLiteStatus %s_init\(" % re.escape(model))
+    prepare = find(lines, r"\]\.prepare\(&ctx", start=init)
+    loop = find(lines, r"^\s*for\s*\(size_t g = 0;", start=prepare, step=-1)
+    lines[loop:loop] = block("prepacked", """
+#ifdef EI_EON_PREPACKED_FILTERS
+  tflite::optimized_integer_ops::int8_gemm::PrepackedFiltersScope prepacked(prepacked_filters,
+    sizeof(prepacked_filters) / sizeof(prepacked_filters[0]));
+#endif
+""")
+    return lines
+
+
+def fused(lines, model, checksum):
+    # Ahead of the arena size, which the rewritten graph changes
+    sizes = [i for i, l in enumerate(lines) if l.startswith("constexpr int kTensorArenaSize = ")]
+    if not sizes:
+        raise HookError("no kTensorArenaSize")
+    opening = find(lines, r"^#if ", start=sizes[0], step=-1)
+    lines[opening:opening] = block("fused", """
+// The graph rewritten by tools/eon_fuse, with its own arena size and tensor
+// offsets (the EON tools compile this file themselves without it). The header
+// is only taken for the export it was made from: kEonModelChecksum is FNV-1a of
+// this file as exported.
+constexpr uint32_t kEonModelChecksum = 0x%(checksum)08xu;
+
+template <int SZ> struct FusedIntArray {
+  int sz; int elem[SZ];
+};
+
+struct FusedNodeInfo_t { // node of the graph rewritten by tools/eon_fuse, runs in place of tflNodes[node]
+  int node;
+  const TfLiteIntArray* outputs; // nullptr: those of tflNodes[node]
+  const ConvMaxPoolParams* conv_max_pool; // set: a CONV_2D_MAX_POOL_2D node
+};
+
+#if !defined(EI_EON_FUSE) && !defined(EI_EON_PREPACK)
+#ifdef __has_include
+#if __has_include("tflite-model/%(model)s_fused.h")
+#include "tflite-model/%(model)s_fused.h"
+#define EI_EON_FUSED_GRAPH 1
+static_assert(kFusedModelChecksum == kEonModelChecksum,
+  "tflite-model/%(model)s_fused.h was made from another export of the model, run tools/eon_fuse/build.sh");
+#endif
+#endif // __has_include
+#endif
+""" % {"model": model, "checksum": checksum})
+
+    default = max(i for i, l in enumerate(lines) if l.startswith("constexpr int kTensorArenaSize = "))
+    if not lines[default - 1].startswith("#else"):
+        raise HookError("no #else before the default kTensorArenaSize")
+    lines[default - 1:default - 1] = block("fused", """
+#elif defined(EI_EON_FUSED_GRAPH)
+constexpr int kTensorArenaSize = kFusedTensorArenaSize;
+""")
+
+    ops = find(lines, r"^\s*OP_\w+,.*\bOP_LAST$")
+    rewrite(lines, "fused", ops, ops + 1,
+            lambda l: re.sub(r"(\s*)\bOP_LAST$", r" OP_CONV_2D_MAX_POOL_2D,\1OP_LAST", l))
+
+    # After the exported graph's tables
+    subgraphs = find(lines, r"^const size_t tflNodes_subgraph_index\[\] = ")
+    lines[subgraphs + 2:subgraphs + 2] = block("fused", """
+// The nodes init and invoke run: tflNodes, or the fused graph
+struct Graph_t {
+  TfLiteNode* nodes;
+  used_operators_e* ops;
+  const size_t* subgraph_index;
+  size_t node_count;
+};
+
+static Graph_t graph = { tflNodes, used_ops, tflNodes_subgraph_index, sizeof(tflNodes) / sizeof(tflNodes[0]) };
+
+#ifdef EI_EON_FUSED_GRAPH
+const size_t kFusedNodeCount = sizeof(fused_nodes) / sizeof(fused_nodes[0]);
+static TfLiteNode fusedNodes[kFusedNodeCount];
+static used_operators_e fused_used_ops[kFusedNodeCount];
+
+// Builds the fused graph's nodes and moves the tensors to its memory plan.
+// Tensors it no longer stores (folded into a fused node) are left without data.
+static void init_fused_graph() {
+  for (size_t i = 0; i < kFusedNodeCount; ++i) {
+    const FusedNodeInfo_t& info = fused_nodes[i];
+    fusedNodes[i] = tflNodes[info.node];
+    fused_used_ops[i] = used_ops[info.node];
+    if (info.outputs) {
+      fusedNodes[i].outputs = const_cast<TfLiteIntArray*>(info.outputs);
+    }
+    if (info.conv_max_pool) {
+      fusedNodes[i].builtin_data = const_cast<ConvMaxPoolParams*>(info.conv_max_pool);
+      fused_used_ops[i] = OP_CONV_2D_MAX_POOL_2D;
+    }
+  }
+
+  for (size_t i = 0; i < sizeof(fused_tensor_offsets) / sizeof(fused_tensor_offsets[0]); ++i) {
+    TensorInfo_t& tensor = tensorData[fused_tensor_offsets[i][0]];
+    const int32_t offset = fused_tensor_offsets[i][1];
+    if (offset < 0) {
+      tensor.allocation_type = kTfLiteMmapRo;
+      tensor.data = nullptr;
+      continue;
+    }
+#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
+    tensor.data = (void*)(uintptr_t)offset;
+#else
+    tensor.data = tensor_arena + offset;
+#endif
+  }
+
+  graph.nodes = fusedNodes;
+  graph.ops = fused_used_ops;
+  graph.subgraph_index = fused_nodes_subgraph_index;
+  graph.node_count = kFusedNodeCount;
+}
+#endif // EI_EON_FUSED_GRAPH
+""")
+
+    init = find(lines, r"^TfLiteStatus %s_init\(" % re.escape(model))
+    tensors = find(lines, r"^\s*ctx\.tensors_size = ", start=init)
+    lines[tensors:tensors] = block("fused", """
+#ifdef EI_EON_FUSED_GRAPH
+  init_fused_graph();
+#endif
+""")
+
+    registered = [i for i in range(init, len(lines)) if re.match(r"^\s*registrations\[OP_\w+\] = Register_\w+\(\);", lines[i])]
+    if not registered:
+        raise HookError("no registrations in init")
+    lines[registered[-1] + 1:registered[-1] + 1] = block("fused", """
+#if defined(EI_EON_FUSED_GRAPH) || defined(EI_EON_FUSE)
+  registrations[OP_CONV_2D_MAX_POOL_2D] = Register_CONV_2D_MAX_POOL_2D();
+#endif
+""")
+
+    # init and invoke walk the graph instead of the exported tables
+    def to_graph(line):
+        line = re.sub(r"\btflNodes_subgraph_index\[", "graph.subgraph_index[", line)
+        line = re.sub(r"\btflNodes\[i\]", "graph.nodes[i]", line)
+        return re.sub(r"\bused_ops\[i\]", "graph.ops[i]", line)
+    invoke = find(lines, r"^TfLiteStatus %s_invoke\(" % re.escape(model))
+    loop = find(lines, r"^\s*for \(size_t i = 0; i < \d+; \+\+i\) \{$", start=invoke, stop=invoke + 2)
+    rewrite(lines, "fused", loop, loop + 1,
+            lambda l: re.sub(r"i < \d+;", "i < graph.node_count;", l))
+    reset = find(lines, r"^TfLiteStatus %s_reset\(" % re.escape(model))
+    rewrite(lines, "fused", init, reset, to_graph)
+    return lines
+
+
+HOOKS = [prepacked, fused]
+
+
+def main(argv):
+    check = "--check" in argv[1:]
+    paths = [a for a in argv[1:] if a != "--check"]
+    if len(paths) != 1 or not paths[0].endswith("_compiled.cpp"):
+        sys.stderr.write(__doc__.split("\n\n")[-1].lstrip() + "\n")
+        return 2
+    path = paths[0]
+    model = os.path.basename(path)[:-len("_compiled.cpp")]
+
+    with open(path) as f:
+        current = f.readlines()
+    try:
+        lines = strip(current)
+        checksum = fnv1a("".join(lines).encode())
+        for hook in HOOKS:
+            lines = hook(lines, model, checksum)
+    except HookError as e:
+        sys.stderr.write("%s: %s\n" % (path, e))
+        return 1
+
+    if check:
+        if lines != current:
+            sys.stderr.write("%s: hooks missing or edited, run tools/eon_hooks/eon_hooks.py on it\n" % path)
+            return 1
+        return 0
+    if lines != current:
+        with open(path, "w") as f:
+            f.writelines(lines)
+        sys.stderr.write("Hooked %s\n" % path)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
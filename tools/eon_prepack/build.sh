@@ -0,0 +1,20 @@
+#!/bin/sh
+# Pack the EON compiled model's int8 filters for the SDK's int8 GEMM kernels,
+# into tflite-model/<model>_prepacked.h next to the model, and hook the model
+# up to it (tools/eon_hooks). Run again whenever the model is re-exported.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+OUT="$ROOT/tools/eon_prepack/build"
+
+MODEL=$(cd "$LIB" && ls tflite-model/*_compiled.cpp)
+HEADER="$LIB/${MODEL%_compiled.cpp}_prepacked.h"
+python3 "$ROOT/tools/eon_hooks/eon_hooks.py" "$LIB/$MODEL"
+
+# The model is compiled into the packer, so leave its own object out
+sdk_objects -v '^tflite-model/'
+mkdir -p "$OUT"
+$CXX -std=gnu++17 $HOST_FLAGS -DEI_EON_PREPACK -DEI_EON_MODEL_SOURCE="\"$MODEL\"" \
+    "$ROOT/tools/eon_prepack/eon_prepack.cpp" $(sdk_object_list -v '^tflite-model/') -lpthread -o "$OUT/eon_prepack"
+"$OUT/eon_prepack" "$HEADER"
@@ -0,0 +1,166 @@
+/*
+ * EON Weight Pre-packer for NOVA
+ * Packs the int8 CONV_2D / FULLY_CONNECTED filters of an EON compiled model
+ * into the layout of the SDK's int8 GEMM kernels
+ * (kernels/internal/optimized/integer_ops/int8_gemm.h), bias and input zero
+ * point already folded, and writes them as const arrays next to the model.
+ * The model hands the table to its kernels during prepare, which then use the
+ * weights in place from flash instead of packing a RAM copy at init.
+ *
+ * The model source is compiled into this tool (EI_EON_MODEL_SOURCE), so the
+ * packer walks the exact node and tensor tables the device runs. Only filters
+ * the kernels would pack themselves are emitted, with the same eligibility
+ * rules. The header records the export's kEonModelChecksum (tools/eon_hooks):
+ * a table left over from an older model fails the build, so init takes the
+ * entries as they are.
+ *
+ * Build + run:  tools/eon_prepack/build.sh
+ * Usage:        eon_prepack <output header>
+ */
+
+#include EI_EON_MODEL_SOURCE
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// ============== Host Porting ==============
+// The model references these, nothing here calls into them
+
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+uint64_t ei_read_timer_us() { return 0; }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+namespace gemm = tflite::optimized_integer_ops::int8_gemm;
+
+static int32_t zeroPoint(const TensorInfo_t& tensor) {
+    if (tensor.quantization.type != kTfLiteAffineQuantization) return 0;
+    const TfLiteAffineQuantization* q = (const TfLiteAffineQuantization*)tensor.quantization.params;
+    return q->zero_point->data[0];
+}
+
+static bool isConstant(const TensorInfo_t& tensor, TfLiteType type) {
+    return tensor.allocation_type == kTfLiteMmapRo && tensor.type == type;
+}
+
+template <typename T>
+static void writeArray(FILE* f, const char* type, const char* name, const T* values, size_t count) {
+    fprintf(f, "const MODEL_SECTION(EI_MODEL_SECTION) ALIGN(16) %s %s[%zu] = {", type, name, count);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(f, "%s%d,", i % 32 == 0 ? "\n  " : " ", (int)values[i]);
+    }
+    fprintf(f, "\n};\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <output header>\n", argv[0]);
+        return 2;
+    }
+
+    std::string body, entries;
+    int packedCount = 0;
+    size_t packedBytes = 0;
+    const size_t subgraphs = sizeof(tflNodes_subgraph_index) / sizeof(tflNodes_subgraph_index[0]) - 1;
+
+    for (size_t g = 0; g < subgraphs; g++) {
+        const int base = (int)tflTensors_subgraph_index[g];
+        for (size_t n = tflNodes_subgraph_index[g]; n < tflNodes_subgraph_index[g + 1]; n++) {
+            const bool conv = used_ops[n] == OP_CONV_2D;
+            if (!conv && used_ops[n] != OP_FULLY_CONNECTED) continue;
+
+            const TfLiteIntArray* inputs = tflNodes[n].inputs;
+            const int filterIx = inputs->data[1];
+            const int biasIx = inputs->size > 2 ? inputs->data[2] : -1;
+            const TensorInfo_t& input = tensorData[base + inputs->data[0]];
+            const TensorInfo_t& filter = tensorData[base + filterIx];
+            const TensorInfo_t* bias = biasIx >= 0 ? &tensorData[base + biasIx] : nullptr;
+            const TfLiteIntArray* dims = filter.dims;
+
+            // Same checks as the kernels' prepare, anything else stays on the reference kernels
+            if (input.type != kTfLiteInt8 || !isConstant(filter, kTfLiteInt8) ||
+                (bias && !isConstant(*bias, kTfLiteInt32))) {
+                continue;
+            }
+            int channels, depth;
+            if (conv) {
+                if (dims->data[3] != input.dims->data[3]) continue;
+                channels = dims->data[0];
+                depth = dims->data[1] * dims->data[2] * dims->data[3];
+            } else {
+                if (zeroPoint(filter) != 0) continue;
+                channels = dims->data[dims->size - 2];
+                depth = dims->data[dims->size - 1];
+            }
+
+            const int8_t* filterData = (const int8_t*)filter.data;
+            const int32_t* biasData = bias ? (const int32_t*)bias->data : nullptr;
+            const int32_t inputOffset = -zeroPoint(input);
+            const size_t size = gemm::PackedFilterSize(channels, depth);
+            void* buffer = aligned_alloc(16, (size + 15) / 16 * 16);
+            gemm::PackedFilter packed = gemm::PackFilter(filterData, biasData, channels, depth, inputOffset, buffer);
+
+            char name[64];
+            char line[512];
+            snprintf(line, sizeof(line), "\n// node %zu, %s, %d x %d from tensor %d\n",
+                n, conv ? "CONV_2D" : "FULLY_CONNECTED", channels, depth, filterIx);
+            body += line;
+
+            char* text = nullptr;
+            size_t textSize = 0;
+            FILE* mem = open_memstream(&text, &textSize);
+            snprintf(name, sizeof(name), "prepacked_corrections%zu", n);
+            writeArray(mem, "int32_t", name, packed.corrections, gemm::PaddedChannels(channels));
+            snprintf(name, sizeof(name), "prepacked_weights%zu", n);
+            writeArray(mem, "int8_t", name, packed.weights, (size_t)gemm::PaddedChannels(channels) * packed.padded_depth);
+            fclose(mem);
+            body += text;
+            free(text);
+
+            // EON names constant tensor data g<subgraph>::tensor_data<index>
+            snprintf(line, sizeof(line), "  { g%zu::tensor_data%d, %d, %d, %d, prepacked_corrections%zu, prepacked_weights%zu },\n",
+                g, filterIx, (int)inputOffset, channels, depth, n, n);
+            entries += line;
+
+            free(buffer);
+            packedCount++;
+            packedBytes += size;
+        }
+    }
+
+    if (packedCount == 0) {
+        remove(argv[1]);
+        fprintf(stderr, "No filters to pack, removed %s\n", argv[1]);
+        return 0;
+    }
+
+    FILE* f = fopen(argv[1], "w");
+    if (!f) {
+        fprintf(stderr, "Can't write %s\n", argv[1]);
+        return 1;
+    }
+    fprintf(f,
+        "// Generated by tools/eon_prepack, do not edit. Run it again after re-exporting the model.\n"
+        "// int8 CONV_2D / FULLY_CONNECTED filters in the int8 GEMM layout\n"
+        "// (edge-impulse-sdk/tensorflow/lite/kernels/internal/optimized/integer_ops/int8_gemm.h),\n"
+        "// included by the compiled model.\n"
+        "\n// kEonModelChecksum of the export it was made from, the model doesn't build with another\n"
+        "constexpr uint32_t kPrepackedModelChecksum = 0x%08xu;\n",
+        (unsigned)kEonModelChecksum);
+    fputs(body.c_str(), f);
+    fprintf(f, "\nconst tflite::optimized_integer_ops::int8_gemm::PrepackedFilter prepacked_filters[] = {\n%s};\n",
+        entries.c_str());
+    fclose(f);
+
+    fprintf(stderr, "Packed %d filters (%zu bytes) into %s\n", packedCount, packedBytes, argv[1]);
+    return 0;
+}
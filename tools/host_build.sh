@@ -0,0 +1,88 @@
+# Shared host build for the programs under tools/ and tests/, sourced by their
+# build scripts after setting ROOT to the repository root:
+#
+#   ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+#   . "$ROOT/tools/host_build.sh"
+#   host_program tools/ns_eval/build ns_eval tools/ns_eval/ns_eval.cpp
+#
+# The Edge Impulse library is vendor code: it is built quietly, once, into
+# tools/build/sdk (rebuilt per object when its source or any header it includes
+# changes, and from scratch when the flags do, also as libsdk.a) and its headers
+# are included as system headers. Our own sources build with -Wall -Wextra -Werror.
+#
+# LIB=<exported library>/src builds against another library than the
+# firmware's; its objects are cached in tools/build/sdk-<hash of LIB>.
+
+LIB=${LIB:-"$ROOT/lib/test-new_inferencing/src"}
+JOBS=${JOBS:-$(nproc)}
+CXX=${CXX:-g++}
+CC=${CC:-gcc}
+
+# DSP flags as in platformio.ini, so the features match the device
+HOST_DEFINES="-DEI_CLASSIFIER_TFLITE_ENABLE_ESP_NN=0 -DEI_CLASSIFIER_CONTINUOUS_THREAD_SAFE=1 -DEIDSP_FAST_MATH=1"
+SDK_DIRS="$LIB $LIB/edge-impulse-sdk $LIB/edge-impulse-sdk/third_party/flatbuffers/include \
+ $LIB/edge-impulse-sdk/third_party/gemmlowp $LIB/edge-impulse-sdk/third_party/ruy"
+
+SDK_FLAGS="-O2 -w $HOST_DEFINES $(for d in $SDK_DIRS; do printf -- '-I%s ' "$d"; done)"
+HOST_FLAGS="-O2 -Wall -Wextra -Werror $HOST_DEFINES $(for d in $SDK_DIRS; do printf -- '-isystem %s ' "$d"; done)-I$ROOT/src"
+
+if [ "$LIB" = "$ROOT/lib/test-new_inferencing/src" ]; then
+    SDK_OBJ="$ROOT/tools/build/sdk"
+else
+    SDK_OBJ="$ROOT/tools/build/sdk-$(printf '%s' "$LIB" | cksum | cut -d' ' -f1)"
+fi
+
+# sdk_objects [-v pattern]: build the SDK objects that are missing or stale, and
+# libsdk.a. With -v, only those of the sources not matching pattern, and no
+# libsdk.a (the EON tools build the model themselves, whatever its generated
+# headers are). CMSIS and the MCU ports aren't used on the host
+sdk_objects() {
+    skip='^$'
+    if [ "$1" = "-v" ]; then skip=$2; fi
+    mkdir -p "$SDK_OBJ"
+    if [ "$(cat "$SDK_OBJ/flags" 2>/dev/null)" != "$SDK_FLAGS" ]; then
+        rm -rf "$SDK_OBJ/obj"
+        printf '%s' "$SDK_FLAGS" > "$SDK_OBJ/flags"
+    fi
+    (cd "$LIB" && find edge-impulse-sdk/dsp edge-impulse-sdk/tensorflow edge-impulse-sdk/third_party \
+         edge-impulse-sdk/classifier tflite-model \
+         \( -name '*.c' -o -name '*.cc' -o -name '*.cpp' \) | sort > "$SDK_OBJ/sources.txt")
+
+    grep -v -e "$skip" "$SDK_OBJ/sources.txt" |
+    LIB="$LIB" SDK_OBJ="$SDK_OBJ" SDK_FLAGS="$SDK_FLAGS" CXX="$CXX" CC="$CC" \
+    xargs -P "$JOBS" -I{} sh -c '
+        src="$LIB/{}" obj="$SDK_OBJ/obj/{}.o"
+        if [ -f "$obj" ] && [ -f "$obj.d" ] &&
+           [ -z "$(find "$src" $(sed "s/^[^:]*://; s/\\\\$//" "$obj.d") -newer "$obj" 2>/dev/null | head -n 1)" ]; then
+            exit 0
+        fi
+        mkdir -p "$(dirname "$obj")"
+        case "{}" in
+            *.c) $CC -std=gnu11 $SDK_FLAGS -MMD -MF "$obj.d" -c "$src" -o "$obj" ;;
+            *)   $CXX -std=gnu++17 $SDK_FLAGS -MMD -MF "$obj.d" -c "$src" -o "$obj" ;;
+        esac'
+    if [ "$skip" != '^$' ]; then return; fi
+
+    # The same objects as an archive, for programs that only pull what they use
+    if [ ! -f "$SDK_OBJ/libsdk.a" ] || [ -n "$(find "$SDK_OBJ/obj" -name '*.o' -newer "$SDK_OBJ/libsdk.a" | head -n 1)" ]; then
+        rm -f "$SDK_OBJ/libsdk.a"
+        sdk_object_list | xargs ar rcs "$SDK_OBJ/libsdk.a"
+    fi
+}
+
+# sdk_object_list [grep -e pattern]: objects to link, all of them by default
+sdk_object_list() {
+    if [ $# -gt 0 ]; then grep "$@" "$SDK_OBJ/sources.txt"; else cat "$SDK_OBJ/sources.txt"; fi |
+        sed "s|^|$SDK_OBJ/obj/|; s|$|.o|"
+}
+
+# host_program <out dir> <name> <source> [flags...]: build <source> against all
+# the SDK objects into <out dir>/<name>; paths relative to ROOT
+host_program() {
+    out="$ROOT/$1" name=$2 source="$ROOT/$3"
+    shift 3
+    sdk_objects
+    mkdir -p "$out"
+    $CXX -std=gnu++17 $HOST_FLAGS "$@" "$source" $(sdk_object_list) -lpthread -o "$out/$name"
+    echo "Built $out/$name"
+}
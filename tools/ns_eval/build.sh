@@ -0,0 +1,8 @@
+#!/bin/sh
+# Build the noise suppressor evaluator against the firmware's Edge Impulse library.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+
+host_program tools/ns_eval/build ns_eval tools/ns_eval/ns_eval.cpp
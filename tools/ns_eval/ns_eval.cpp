@@ -0,0 +1,406 @@
+/*
+ * Noise Suppressor Evaluator for NOVA
+ * Mixes recordings with background noise at a range of SNRs, runs the mix
+ * through the firmware's NoiseSuppressor (src/noise_suppressor.h) as
+ * recordAudio() does, and reports per noise and SNR:
+ *
+ *   SNR       recording to everything else (noise, and what the suppressor
+ *             did to the recording), mix in -> suppressor out
+ *   segSNR    the same per 20ms over speech segments, clamped to -10..35 dB
+ *   noise     attenuation of the noise-only segments
+ *   cost      suppressor time per second of audio and per frame on this host
+ *
+ * Speech segments are those where the recording's own RMS is above the
+ * silence threshold, the rest count as noise-only. Each recording starts with --warmup of noise alone, then
+ * restart(), like a turn after the last one: the firmware keeps its noise
+ * estimate between turns. The upload AGC is left out, so the recording
+ * stays a sample-exact reference (the suppressor doesn't care about scale).
+ *
+ * Noise: synthetic fan (pink rumble, blade tone), hum (mains harmonics and
+ * hiss) and tv (speech-shaped babble, the hard case: it moves like speech),
+ * or --noise recordings, looped. Recordings: 16kHz 16-bit mono WAV, or
+ * directories of them.
+ *
+ * Build:  tools/ns_eval/build.sh
+ * Usage:  ns_eval <recordings ...> [--noise noise.wav ...] [--snr 0,5,10,20] [--warmup 2000]
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "noise_suppressor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+// ============== Host Porting ==============
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp and src/config.h
+
+#define SILENCE_THRESHOLD       200
+#define RECORD_READ_SAMPLES     512     // recordAudio()'s reads
+
+static const NoiseSuppressorConfig nsConfig = { EI_CLASSIFIER_FREQUENCY, 1500, 2.0f, -15.0f, 0.98f };
+
+// ============== Recordings ==============
+
+struct Recording {
+    std::string name;
+    std::vector<int16_t> samples;
+};
+
+static bool loadWav(const std::string& path, Recording& r) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool formatOk = false;
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, &data[pos + 4], 4);
+        const uint8_t* body = &data[pos + 8];
+
+        if (memcmp(&data[pos], "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint16_t format, channels, bits;
+            uint32_t rate;
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&rate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+            formatOk = (format == 1 && channels == 1 && bits == 16 && rate == EI_CLASSIFIER_FREQUENCY);
+        } else if (memcmp(&data[pos], "data", 4) == 0) {
+            if (!formatOk) return false;
+            size_t available = data.size() - (pos + 8);
+            size_t count = (chunkSize < available ? chunkSize : available) / 2;
+            r.name = path;
+            r.samples.resize(count);
+            memcpy(r.samples.data(), body, count * 2);
+            return true;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+static void findRecordings(const std::string& path, std::vector<Recording>& out) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        Recording r;
+        if (loadWav(path, r)) out.push_back(r);
+        else fprintf(stderr, "Skipping %s (need %d Hz 16-bit mono PCM)\n", path.c_str(), EI_CLASSIFIER_FREQUENCY);
+        return;
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) {
+        std::string full = path + "/" + name;
+        if (stat(full.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            findRecordings(full, out);
+        } else if (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0) {
+            findRecordings(full, out);
+        }
+    }
+}
+
+// ============== Noise ==============
+
+// Two-pole resonator, y[n] = x + 2r cos(w) y[n-1] - r^2 y[n-2]
+struct Resonator {
+    float y1 = 0.0f, y2 = 0.0f;
+    float step(float x, float hz, float r) {
+        float w = 2.0f * (float)M_PI * hz / EI_CLASSIFIER_FREQUENCY;
+        float y = x + 2.0f * r * cosf(w) * y1 - r * r * y2;
+        y2 = y1;
+        y1 = y;
+        return y;
+    }
+};
+
+static std::vector<float> syntheticNoise(const std::string& type, size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<float> out(count);
+    const float fs = EI_CLASSIFIER_FREQUENCY;
+
+    if (type == "fan") {
+        // Rumble (integrated white noise, leaky) plus broadband air, and the blade pass tone with harmonics
+        float rumble = 0.0f, phase = 0.0f;
+        for (size_t i = 0; i < count; i++) {
+            rumble = 0.995f * rumble + gauss(rng);
+            phase += 2.0f * (float)M_PI * 87.0f / fs;
+            float blade = sinf(phase) + 0.5f * sinf(2 * phase) + 0.25f * sinf(3 * phase);
+            out[i] = 0.1f * rumble + gauss(rng) + 0.8f * blade;
+        }
+    } else if (type == "hum") {
+        float phase = 0.0f;
+        for (size_t i = 0; i < count; i++) {
+            phase += 2.0f * (float)M_PI * 50.0f / fs;
+            float hum = 0.0f;
+            for (int h = 1; h <= 7; h += 2) hum += sinf(h * phase) / h;
+            out[i] = 2.0f * hum + 0.3f * gauss(rng);
+        }
+    } else {
+        // Babble: three talkers, each a pair of wandering formants with a syllable envelope
+        for (int talker = 0; talker < 3; talker++) {
+            Resonator r1, r2;
+            float f1 = 500, f2 = 1500, level = 0.0f, target = 0.0f;
+            size_t next = 0;
+            for (size_t i = 0; i < count; i++) {
+                if (i == next) {
+                    bool pause = uniform(rng) < 0.2f;
+                    target = pause ? 0.0f : 0.3f + 0.7f * uniform(rng);
+                    f1 = 300 + 600 * uniform(rng);
+                    f2 = 1000 + 1500 * uniform(rng);
+                    next += (size_t)(fs * (pause ? 0.2f + 0.3f * uniform(rng) : 0.12f + 0.15f * uniform(rng)));
+                }
+                level += (target - level) * 0.002f;
+                float x = gauss(rng);
+                out[i] += level * (0.06f * r1.step(x, f1, 0.97f) + 0.08f * r2.step(x, f2, 0.95f));
+            }
+        }
+    }
+    return out;
+}
+
+// ============== Evaluation ==============
+
+struct Tally {
+    double clean = 0.0, errorIn = 0.0, errorOut = 0.0;     // Whole recordings
+    double segIn = 0.0, segOut = 0.0;                       // Sums of clamped segment SNRs
+    size_t speechSegments = 0;
+    double noiseIn = 0.0, noiseOut = 0.0;                   // Noise-only segments
+    double seconds = 0.0, microseconds = 0.0;
+    uint32_t frames = 0;
+};
+
+static double db(double ratio) {
+    return ratio > 0.0 ? 10.0 * log10(ratio) : -INFINITY;
+}
+
+static double segmentSnr(double signal, double error) {
+    double snr = error > 0.0 ? db(signal / error) : 35.0;
+    return std::max(-10.0, std::min(35.0, snr));
+}
+
+static bool isSpeech(double energy, size_t count) {
+    return energy > (double)SILENCE_THRESHOLD * SILENCE_THRESHOLD * count;
+}
+
+static int16_t saturate(float x) {
+    return (int16_t)std::max(-32768.0f, std::min(32767.0f, roundf(x)));
+}
+
+static void evaluate(const Recording& r, const std::vector<float>& noise, size_t noiseOffset, double snrDb,
+                     size_t warmup, Tally& t) {
+    const std::vector<int16_t>& clean = r.samples;
+    const size_t n = clean.size();
+    const size_t segment = EI_CLASSIFIER_FREQUENCY / 50;
+
+    // Noise level from the speech segments' power, the way SNR is usually quoted
+    double speechPower = 0.0, noisePower = 0.0;
+    size_t speechSamples = 0;
+    for (size_t s = 0; s + segment <= n; s += segment) {
+        double e = 0.0;
+        for (size_t i = s; i < s + segment; i++) e += (double)clean[i] * clean[i];
+        if (isSpeech(e, segment)) {
+            speechPower += e;
+            speechSamples += segment;
+        }
+    }
+    for (size_t i = 0; i < n + warmup; i++) {
+        float v = noise[(noiseOffset + i) % noise.size()];
+        noisePower += (double)v * v;
+    }
+    if (speechSamples == 0 || noisePower <= 0.0) return;
+    speechPower /= speechSamples;
+    noisePower /= n + warmup;
+    float scale = (float)sqrt(speechPower / noisePower / pow(10.0, snrDb / 10.0));
+
+    std::vector<int16_t> lead(warmup), mix(n), out(n + NS_FRAME);
+    for (size_t i = 0; i < warmup; i++) lead[i] = saturate(scale * noise[(noiseOffset + i) % noise.size()]);
+    for (size_t i = 0; i < n; i++) mix[i] = saturate(clean[i] + scale * noise[(noiseOffset + warmup + i) % noise.size()]);
+
+    NoiseSuppressor ns;
+    ns.begin(nsConfig);
+    std::vector<int16_t> scratch(RECORD_READ_SAMPLES);
+    for (size_t pos = 0; pos < warmup; pos += RECORD_READ_SAMPLES) {
+        size_t count = std::min((size_t)RECORD_READ_SAMPLES, warmup - pos);
+        ns.process(&lead[pos], scratch.data(), count);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    ns.restart();
+    uint32_t framesBefore = ns.stats().frames;
+    for (size_t pos = 0; pos < n; pos += RECORD_READ_SAMPLES) {
+        size_t count = std::min((size_t)RECORD_READ_SAMPLES, n - pos);
+        ns.process(&mix[pos], &out[pos], count);
+    }
+    ns.flush(&out[n], NS_FRAME);
+    t.microseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    t.frames += ns.stats().frames - framesBefore;
+    t.seconds += (double)n / EI_CLASSIFIER_FREQUENCY;
+
+    for (size_t s = 0; s + segment <= n; s += segment) {
+        double c = 0.0, ein = 0.0, eout = 0.0, min = 0.0, mout = 0.0;
+        for (size_t i = s; i < s + segment; i++) {
+            double y = out[i + NS_FRAME];
+            c += (double)clean[i] * clean[i];
+            ein += ((double)mix[i] - clean[i]) * ((double)mix[i] - clean[i]);
+            eout += (y - clean[i]) * (y - clean[i]);
+            min += (double)mix[i] * mix[i];
+            mout += y * y;
+        }
+        t.clean += c;
+        t.errorIn += ein;
+        t.errorOut += eout;
+        if (isSpeech(c, segment)) {
+            t.segIn += segmentSnr(c, ein);
+            t.segOut += segmentSnr(c, eout);
+            t.speechSegments++;
+        } else {
+            t.noiseIn += min;
+            t.noiseOut += mout;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths, noisePaths;
+    std::vector<double> snrs = { 0, 5, 10, 20 };
+    size_t warmupMs = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--snr") && i + 1 < argc) {
+            snrs.clear();
+            for (char* p = strtok(argv[++i], ","); p; p = strtok(nullptr, ",")) snrs.push_back(atof(p));
+        } else if (!strcmp(argv[i], "--noise") && i + 1 < argc) {
+            noisePaths.push_back(argv[++i]);
+        } else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) {
+            warmupMs = (size_t)atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.empty() || snrs.empty()) {
+        fprintf(stderr, "Usage: %s <recordings ...> [--noise noise.wav ...] [--snr 0,5,10,20] [--warmup 2000]\n", argv[0]);
+        return 2;
+    }
+    NoiseSuppressor probe;
+    if (!probe.begin(nsConfig)) {
+        fprintf(stderr, "Noise suppressor config rejected\n");
+        return 1;
+    }
+
+    std::vector<Recording> recordings;
+    for (const std::string& path : paths) findRecordings(path, recordings);
+    if (recordings.empty()) {
+        fprintf(stderr, "No recordings found\n");
+        return 1;
+    }
+
+    struct Noise {
+        std::string name;
+        std::vector<float> samples;
+    };
+    std::vector<Noise> noises;
+    if (noisePaths.empty()) {
+        for (const char* type : { "fan", "hum", "tv" }) {
+            noises.push_back({ type, syntheticNoise(type, 60 * EI_CLASSIFIER_FREQUENCY, 1) });
+        }
+    } else {
+        std::vector<Recording> loaded;
+        for (const std::string& path : noisePaths) findRecordings(path, loaded);
+        for (const Recording& r : loaded) {
+            if (r.samples.empty()) continue;
+            size_t slash = r.name.find_last_of('/');
+            noises.push_back({ r.name.substr(slash == std::string::npos ? 0 : slash + 1),
+                               std::vector<float>(r.samples.begin(), r.samples.end()) });
+        }
+        if (noises.empty()) {
+            fprintf(stderr, "No noise recordings found\n");
+            return 1;
+        }
+    }
+
+    const size_t warmup = warmupMs * EI_CLASSIFIER_FREQUENCY / 1000;
+    printf("%zu recordings, %.0fs | warm-up %zums\n", recordings.size(),
+        [&] { double s = 0; for (const Recording& r : recordings) s += r.samples.size(); return s / EI_CLASSIFIER_FREQUENCY; }(),
+        warmupMs);
+    printf("%-12s %5s  %16s  %16s  %8s  %16s\n", "noise", "snr", "SNR in->out", "segSNR in->out", "noise", "cost");
+    for (const Noise& noise : noises) {
+        for (double snr : snrs) {
+            Tally t;
+            size_t offset = 0;
+            for (const Recording& r : recordings) {
+                evaluate(r, noise.samples, offset, snr, warmup, t);
+                offset += r.samples.size() + warmup;
+            }
+            double segIn = t.speechSegments ? t.segIn / t.speechSegments : 0.0;
+            double segOut = t.speechSegments ? t.segOut / t.speechSegments : 0.0;
+            char attenuation[16] = "-";
+            if (t.noiseIn > 0.0) snprintf(attenuation, sizeof(attenuation), "%+6.1fdB", -db(t.noiseIn / t.noiseOut));
+            printf("%-12s %+4.0fdB  %+6.1f->%+6.1fdB  %+6.1f->%+6.1fdB  %8s  %4.1fms/s %4.1fus/fr\n",
+                noise.name.c_str(), snr, db(t.clean / t.errorIn), db(t.clean / t.errorOut), segIn, segOut,
+                attenuation, t.microseconds / 1000.0 / t.seconds, t.frames ? t.microseconds / t.frames : 0.0);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,8 @@
+#!/bin/sh
+# Build the offline wake word evaluator against the firmware's Edge Impulse library.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+. "$ROOT/tools/host_build.sh"
+
+host_program tools/wake_eval/build wake_eval tools/wake_eval/wake_eval.cpp
@@ -0,0 +1,603 @@
+/*
+ * Offline Wake Word Evaluator for NOVA
+ * Runs the firmware's exact pipeline over a directory of labelled recordings:
+ * the mic AGC's wake feed (src/mic_agc.h), run_classifier_continuous() per
+ * 250ms slice, then the shared
+ * decision logic: the PerfCal-based WakeEngine (src/wake_engine.h) the
+ * firmware uses, or the older per-window WakeDecision (src/wake_decision.h)
+ * as a baseline. Reports per-file detections, both engines side by side, and
+ * a DET sweep (miss rate vs false accepts per hour) across thresholds.
+ *
+ * Recordings: 16kHz 16-bit mono WAV, or score traces (.eisc, e.g. dumps
+ * uploaded by the device) which skip classification. Files anywhere under a
+ * directory named like the wake label (e.g. recordings/nova/...) contain one
+ * wake word each, everything else is negative audio (speech, TV, silence, ...).
+ *
+ * Per-slice scores and model inputs are cached next to the run (--cache) as
+ * score cache files (edge-impulse-sdk/classifier/ei_score_cache.h), so
+ * re-sweeping thresholds skips DSP/NN entirely. --gain fixed swaps the AGC for
+ * the firmware's fixed 8x gain (MIC_AGC false), saturating, cached apart. Files are spread over all cores with a
+ * work-stealing pool, one impulse handle per worker.
+ *
+ * Build:  tools/wake_eval/build.sh
+ * Usage:  wake_eval <recordings_dir> [-j threads] [--cache dir] [--out prefix]
+ *                   [--gain agc|fixed] [--engine perfcal|legacy] [--confidence 0.92]
+ *                   [--average 750] [--suppression 3000]               (perfcal)
+ *                   [--gap 0.30] [--cooldown 3000] [--consecutive 1]   (legacy)
+ */
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/classifier/ei_score_cache.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/debug_log.h"
+#include "mic_agc.h"
+#include "wake_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// ============== Host Porting ==============
+// The Arduino export of the SDK ships no POSIX port, so provide it here
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+// ============== Firmware Parameters ==============
+// Keep in sync with src/main.cpp
+
+#define WAKE_LABEL              "Nova"
+#define NOISE_LABEL             "noise"
+#define UNKNOWN_LABEL           "unknown"
+#define WAKE_WORD_GAIN          8
+#define SILENCE_THRESHOLD       200
+#define SLICE_MS                (EI_CLASSIFIER_SLICE_SIZE * 1000 / EI_CLASSIFIER_FREQUENCY)
+// The device has been up a while when the first wake word arrives
+#define CLOCK_START_MS          60000
+
+// MIC_AGC: only the wake feed reaches the model
+static const MicAgcConfig agcConfig = { EI_CLASSIFIER_FREQUENCY, 300, SILENCE_THRESHOLD, 30000, {
+    { 24000, 1.0f, WAKE_WORD_GAIN, 500 },
+    { 16000, 1.0f, 8.0f, 1000 } } };
+static bool fixedGain = false;  // --gain fixed
+
+struct Recording {
+    std::string path;
+    std::string name;           // Relative to the recordings directory
+    bool positive;
+    off_t size;
+    time_t mtime;
+    std::vector<float> scores;  // [slice][label]
+    bool trace = false;         // .eisc score trace, nothing to classify
+    bool ok = false;
+};
+
+static int wakeIx = -1, noiseIx = -1, unknownIx = -1;
+
+// ============== Recordings ==============
+
+static bool iequals(const std::string& a, const char* b) {
+    return strcasecmp(a.c_str(), b) == 0;
+}
+
+static void findRecordings(const std::string& root, const std::string& rel, bool positive, std::vector<Recording>& out) {
+    std::string dirPath = rel.empty() ? root : root + "/" + rel;
+    DIR* dir = opendir(dirPath.c_str());
+    if (!dir) return;
+
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name[0] == '.') continue;
+
+        std::string relPath = rel.empty() ? name : rel + "/" + name;
+        std::string fullPath = root + "/" + relPath;
+        struct stat st;
+        if (stat(fullPath.c_str(), &st) != 0) continue;
+
+        if (S_ISDIR(st.st_mode)) {
+            findRecordings(root, relPath, positive || iequals(name, WAKE_LABEL), out);
+        } else if ((name.size() > 4 && iequals(name.substr(name.size() - 4), ".wav")) ||
+                   (name.size() > 5 && iequals(name.substr(name.size() - 5), ".eisc"))) {
+            Recording r;
+            r.trace = iequals(name.substr(name.size() - 5), ".eisc");
+            r.path = fullPath;
+            r.name = relPath;
+            r.positive = positive;
+            r.size = st.st_size;
+            r.mtime = st.st_mtime;
+            out.push_back(r);
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * @brief Locate the PCM samples in a memory-mapped WAV
+ * @return nullptr if the file is not 16kHz 16-bit mono PCM
+ */
+static const int16_t* wavSamples(const uint8_t* data, size_t size, size_t* count) {
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return nullptr;
+    }
+
+    bool formatOk = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, data + pos + 4, 4);
+        const uint8_t* body = data + pos + 8;
+
+        if (memcmp(data + pos, "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint16_t format, channels, bits;
+            uint32_t rate;
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&rate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+            formatOk = (format == 1 && channels == 1 && bits == 16 && rate == EI_CLASSIFIER_FREQUENCY);
+        } else if (memcmp(data + pos, "data", 4) == 0) {
+            if (!formatOk) return nullptr;
+            size_t available = size - (pos + 8);
+            *count = (chunkSize < available ? chunkSize : available) / 2;
+            return (const int16_t*)body;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return nullptr;
+}
+
+// ============== Score Cache ==============
+
+static std::string cachePath(const std::string& cacheDir, const Recording& r) {
+    std::string flat = r.name;
+    for (char& c : flat) {
+        if (c == '/') c = '_';
+    }
+    return cacheDir + "/" + flat + (fixedGain ? ".fixed.eisc" : ".eisc");
+}
+
+/**
+ * @brief Read the scores of a score cache file
+ * @param source Recording the cache must have been made from, nullptr to accept any
+ */
+static bool loadScores(const std::string& path, Recording& r, const Recording* source) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    void* map = (fstat(fd, &st) == 0 && st.st_size > 0)
+        ? mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    ei_score_cache_reader_t cache;
+    bool ok = cache.open(map, st.st_size) &&
+              cache.header()->label_count == EI_CLASSIFIER_LABEL_COUNT &&
+              cache.header()->slice_size == EI_CLASSIFIER_SLICE_SIZE;
+    if (ok && source) {
+        ok = cache.header()->record_count != EI_SCORE_CACHE_STREAMING &&  // Interrupted run
+             cache.header()->source_size == (uint64_t)source->size && cache.header()->source_mtime == source->mtime;
+    }
+    if (ok) {
+        r.scores.resize((size_t)cache.count() * EI_CLASSIFIER_LABEL_COUNT);
+        for (uint32_t s = 0; s < cache.count(); s++) {
+            memcpy(&r.scores[s * EI_CLASSIFIER_LABEL_COUNT], cache.scores(s), EI_CLASSIFIER_LABEL_COUNT * sizeof(float));
+        }
+    }
+    munmap(map, st.st_size);
+    return ok;
+}
+
+static bool loadCache(const std::string& cacheDir, Recording& r) {
+    return loadScores(cachePath(cacheDir, r), r, &r);
+}
+
+// ============== Classification ==============
+
+/**
+ * @brief Classify one recording slice by slice, exactly as detectWakeWord() feeds the model
+ */
+static bool classifyRecording(ei_impulse_handle_t* handle, Recording& r, const std::string& cacheDir) {
+    int fd = open(r.path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    void* map = mmap(nullptr, r.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    size_t count = 0;
+    const int16_t* samples = wavSamples((const uint8_t*)map, r.size, &count);
+    if (!samples) {
+        fprintf(stderr, "[EVAL] Skipping %s (need %d Hz 16-bit mono PCM)\n", r.name.c_str(), EI_CLASSIFIER_FREQUENCY);
+        munmap(map, r.size);
+        return false;
+    }
+
+    int16_t slice[EI_CLASSIFIER_SLICE_SIZE];
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = [&slice](size_t offset, size_t length, float* out) {
+        for (size_t i = 0; i < length; i++) {
+            out[i] = (float)slice[offset + i];
+        }
+        return 0;
+    };
+
+    // Write to a temporary name so a killed run never leaves a valid-looking cache
+    FILE* cacheFile = nullptr;
+    std::string cacheName, tmpName;
+    ei_score_cache_writer_t writer;
+    int8_t features[EI_CLASSIFIER_NN_INPUT_FRAME_SIZE] = {};
+    if (!cacheDir.empty()) {
+        cacheName = cachePath(cacheDir, r);
+        tmpName = cacheName + ".tmp";
+        cacheFile = fopen(tmpName.c_str(), "wb");
+    }
+    if (cacheFile) {
+        ei_score_cache_header_t header;
+        ei_score_cache_header_init(&header);
+        header.source_size = r.size;
+        header.source_mtime = r.mtime;
+        ei_score_cache_capture_input(handle, features, &header);
+        writer.begin(cacheFile, &header);
+    }
+
+    // The device's AGC has been running since boot; a recording starts it afresh
+    MicAgc agc;
+    agc.begin(agcConfig);
+    run_classifier_init(handle);
+    r.scores.clear();
+    bool ok = true;
+    for (size_t start = 0; start + EI_CLASSIFIER_SLICE_SIZE <= count; start += EI_CLASSIFIER_SLICE_SIZE) {
+        if (fixedGain) {
+            for (int i = 0; i < EI_CLASSIFIER_SLICE_SIZE; i++) {
+                int32_t x = samples[start + i] * WAKE_WORD_GAIN;
+                slice[i] = (int16_t)(x > 32767 ? 32767 : x < -32768 ? -32768 : x);
+            }
+        } else {
+            agc.process(samples + start, slice, nullptr, EI_CLASSIFIER_SLICE_SIZE);
+        }
+
+        ei_impulse_result_t result = {};
+        if (run_classifier_continuous(handle, &signal, &result, false) != EI_IMPULSE_OK) {
+            ok = false;
+            break;
+        }
+        for (int l = 0; l < EI_CLASSIFIER_LABEL_COUNT; l++) {
+            r.scores.push_back(result.classification[l].value);
+        }
+        if (cacheFile) {
+            writer.append(&result, (uint32_t)(start / EI_CLASSIFIER_SLICE_SIZE), (uint32_t)start,
+                          ei_score_cache_captured_input(handle));
+        }
+    }
+    run_classifier_deinit(handle);
+    munmap(map, r.size);
+
+    if (cacheFile) {
+        ei_score_cache_capture_input(handle, nullptr, nullptr);
+        bool cacheOk = writer.end();
+        cacheOk = (fclose(cacheFile) == 0) && cacheOk && ok;
+        if (!cacheOk || rename(tmpName.c_str(), cacheName.c_str()) != 0) {
+            unlink(tmpName.c_str());
+        }
+    }
+    return ok;
+}
+
+/**
+ * Each worker owns a deque of recording indices and steals from the back of
+ * the others once its own runs dry, so one long file can't stall the tail.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int workers) : _queues(workers), _locks(workers) {}
+
+    void push(int worker, size_t task) {
+        _queues[worker].push_back(task);
+    }
+
+    bool next(int worker, size_t* task) {
+        {
+            std::lock_guard<std::mutex> lock(_locks[worker]);
+            if (!_queues[worker].empty()) {
+                *task = _queues[worker].front();
+                _queues[worker].pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < _queues.size(); i++) {
+            int victim = (worker + i) % _queues.size();
+            std::lock_guard<std::mutex> lock(_locks[victim]);
+            if (!_queues[victim].empty()) {
+                *task = _queues[victim].back();
+                _queues[victim].pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::vector<std::deque<size_t>> _queues;
+    std::vector<std::mutex> _locks;
+};
+
+// ============== Decisions ==============
+
+struct EvalConfig {
+    bool perfCal;
+    WakeEngineConfig engine;
+    WakeDecisionConfig legacy;
+};
+
+static std::vector<uint32_t> detect(const Recording& r, const EvalConfig& config) {
+    std::vector<uint32_t> detections;
+    WakeEngine engine;
+    WakeDecision decision(config.legacy);
+    if (config.perfCal && !engine.begin(ei_default_impulse.impulse, config.engine)) {
+        return detections;
+    }
+    size_t slices = r.scores.size() / EI_CLASSIFIER_LABEL_COUNT;
+
+    for (size_t s = 0; s < slices; s++) {
+        const float* scores = &r.scores[s * EI_CLASSIFIER_LABEL_COUNT];
+        uint32_t nowMs = CLOCK_START_MS + (uint32_t)((s + 1) * SLICE_MS);
+        WakeVerdict verdict = config.perfCal
+            ? engine.update(scores)
+            : decision.update(scores[wakeIx], scores[noiseIx], scores[unknownIx], nowMs);
+        if (verdict == WAKE_DETECTED) {
+            detections.push_back((uint32_t)((s + 1) * SLICE_MS));
+            // The device records and replies before listening again
+            engine.reset();
+            decision.reset();
+        }
+    }
+    return detections;
+}
+
+struct SweepPoint {
+    int misses = 0;
+    int falseAccepts = 0;
+};
+
+static SweepPoint evaluate(const std::vector<Recording>& recs, const EvalConfig& config) {
+    SweepPoint p;
+    for (const Recording& r : recs) {
+        if (!r.ok) continue;
+        size_t n = detect(r, config).size();
+        if (r.positive) {
+            p.misses += (n == 0);
+        } else {
+            p.falseAccepts += (int)n;
+        }
+    }
+    return p;
+}
+
+static int labelIndex(const char* label) {
+    for (int i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+        if (strcmp(ei_default_impulse.impulse->categories[i], label) == 0) return i;
+    }
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    std::string root, cacheDir, outPrefix = "wake_eval";
+    int threads = (int)std::thread::hardware_concurrency();
+    // Firmware defaults (src/main.cpp)
+    EvalConfig config = {
+        true,
+        { WAKE_LABEL, 0.92f, 750, 3000, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW },
+        // Before WakeEngine
+        { 0.92f, 0.30f, 3000, 1, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW },
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-j" && hasValue) threads = atoi(argv[++i]);
+        else if (arg == "--cache" && hasValue) cacheDir = argv[++i];
+        else if (arg == "--out" && hasValue) outPrefix = argv[++i];
+        else if (arg == "--gain" && hasValue) fixedGain = strcmp(argv[++i], "fixed") == 0;
+        else if (arg == "--engine" && hasValue) config.perfCal = strcmp(argv[++i], "legacy") != 0;
+        else if (arg == "--confidence" && hasValue) config.engine.threshold = config.legacy.confidence = atof(argv[++i]);
+        else if (arg == "--average" && hasValue) config.engine.averageWindowMs = atoi(argv[++i]);
+        else if (arg == "--suppression" && hasValue) config.engine.suppressionMs = atoi(argv[++i]);
+        else if (arg == "--gap" && hasValue) config.legacy.gap = atof(argv[++i]);
+        else if (arg == "--cooldown" && hasValue) config.legacy.cooldownMs = atoi(argv[++i]);
+        else if (arg == "--consecutive" && hasValue) config.legacy.consecutive = atoi(argv[++i]);
+        else if (arg[0] != '-' && root.empty()) root = arg;
+        else {
+            fprintf(stderr, "Usage: %s <recordings_dir> [-j threads] [--cache dir] [--out prefix]\n"
+                            "          [--gain agc|fixed] [--engine perfcal|legacy] [--confidence f]\n"
+                            "          [--average ms] [--suppression ms]\n"
+                            "          [--gap f] [--cooldown ms] [--consecutive n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (root.empty()) {
+        fprintf(stderr, "Usage: %s <recordings_dir> [options]\n", argv[0]);
+        return 1;
+    }
+    if (threads < 1) threads = 1;
+
+    wakeIx = labelIndex(WAKE_LABEL);
+    noiseIx = labelIndex(NOISE_LABEL);
+    unknownIx = labelIndex(UNKNOWN_LABEL);
+    if (wakeIx < 0 || noiseIx < 0 || unknownIx < 0) {
+        fprintf(stderr, "[EVAL] Model labels don't match the firmware (%s/%s/%s)\n", WAKE_LABEL, NOISE_LABEL, UNKNOWN_LABEL);
+        return 1;
+    }
+    if (!cacheDir.empty()) {
+        mkdir(cacheDir.c_str(), 0755);
+    }
+
+    std::vector<Recording> recs;
+    findRecordings(root, "", false, recs);
+    if (recs.empty()) {
+        fprintf(stderr, "[EVAL] No WAV files or score traces under %s\n", root.c_str());
+        return 1;
+    }
+
+    // Largest first, dealt round-robin, so stealing only has to balance the tail
+    std::vector<size_t> order(recs.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return recs[a].size > recs[b].size; });
+
+    WorkStealingPool pool(threads);
+    for (size_t i = 0; i < order.size(); i++) {
+        pool.push(i % threads, order[i]);
+    }
+
+    std::atomic<int> classified(0), cached(0);
+    uint64_t started = ei_read_timer_ms();
+    std::vector<std::thread> workers;
+    for (int w = 0; w < threads; w++) {
+        workers.emplace_back([&, w] {
+            ei_impulse_handle_t handle(ei_default_impulse.impulse);
+            size_t task;
+            while (pool.next(w, &task)) {
+                Recording& r = recs[task];
+                if (r.trace) {
+                    r.ok = loadScores(r.path, r, nullptr);
+                    if (r.ok) cached++;
+                    else fprintf(stderr, "[EVAL] Skipping %s (not a score trace for this model)\n", r.name.c_str());
+                    continue;
+                }
+                if (!cacheDir.empty() && loadCache(cacheDir, r)) {
+                    r.ok = true;
+                    cached++;
+                    continue;
+                }
+                r.ok = classifyRecording(&handle, r, cacheDir);
+                if (r.ok) classified++;
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    uint64_t elapsedMs = ei_read_timer_ms() - started;
+
+    // Per-file detections at the configured thresholds
+    double positiveCount = 0, negativeHours = 0, audioSeconds = 0;
+    std::string detectionsPath = outPrefix + "_detections.csv";
+    FILE* out = fopen(detectionsPath.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "[EVAL] Can't write %s\n", detectionsPath.c_str());
+        return 1;
+    }
+    fprintf(out, "file,positive,seconds,detections,times_s\n");
+    for (const Recording& r : recs) {
+        if (!r.ok) continue;
+        double seconds = (r.scores.size() / EI_CLASSIFIER_LABEL_COUNT) * SLICE_MS / 1000.0;
+        audioSeconds += seconds;
+        if (r.positive) positiveCount++;
+        else negativeHours += seconds / 3600.0;
+
+        std::vector<uint32_t> det = detect(r, config);
+        fprintf(out, "\"%s\",%d,%.2f,%zu,", r.name.c_str(), r.positive ? 1 : 0, seconds, det.size());
+        for (size_t i = 0; i < det.size(); i++) {
+            fprintf(out, "%s%.2f", i ? ";" : "", det[i] / 1000.0);
+        }
+        fprintf(out, "\n");
+    }
+    fclose(out);
+
+    // DET sweep, both engines: confidence x gap (legacy) and confidence x
+    // averaging window (perfcal), everything else as configured
+    std::string sweepPath = outPrefix + "_sweep.csv";
+    out = fopen(sweepPath.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "[EVAL] Can't write %s\n", sweepPath.c_str());
+        return 1;
+    }
+    auto sweepRow = [&](const EvalConfig& point) {
+        SweepPoint p = evaluate(recs, point);
+        fprintf(out, "%s,%.2f,", point.perfCal ? "perfcal" : "legacy",
+                point.perfCal ? point.engine.threshold : point.legacy.confidence);
+        if (point.perfCal) fprintf(out, ",%u,", point.engine.averageWindowMs);
+        else fprintf(out, "%.2f,,", point.legacy.gap);
+        fprintf(out, "%.4f,%d,%.3f\n", positiveCount ? p.misses / positiveCount : 0.0, p.falseAccepts,
+                negativeHours ? p.falseAccepts / negativeHours : 0.0);
+    };
+    fprintf(out, "engine,confidence,gap,average_ms,miss_rate,false_accepts,fa_per_hour\n");
+    static const float gaps[] = { 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f };
+    static const uint32_t averages[] = { 250, 500, 750, 1000 };
+    for (float gap : gaps) {
+        for (int c = 50; c <= 99; c++) {
+            EvalConfig point = config;
+            point.perfCal = false;
+            point.legacy.confidence = c / 100.0f;
+            point.legacy.gap = gap;
+            sweepRow(point);
+        }
+    }
+    for (uint32_t average : averages) {
+        for (int c = 51; c <= 99; c++) {
+            EvalConfig point = config;
+            point.perfCal = true;
+            point.engine.threshold = c / 100.0f;
+            point.engine.averageWindowMs = average;
+            sweepRow(point);
+        }
+    }
+    fclose(out);
+
+    printf("[EVAL] %zu recordings, %.1f min of audio, %s: %d classified, %d from cache, %d threads, %.1f s\n",
+           recs.size(), audioSeconds / 60.0, fixedGain ? "fixed 8x gain" : "mic AGC", classified.load(), cached.load(),
+           threads, elapsedMs / 1000.0);
+
+    // Both engines at the configured thresholds, the selected one first
+    for (int pass = 0; pass < 2; pass++) {
+        EvalConfig point = config;
+        point.perfCal = (pass == 0) == config.perfCal;
+        SweepPoint current = evaluate(recs, point);
+        if (point.perfCal) {
+            printf("[EVAL] perfcal: confidence %.2f average %u ms suppression %u ms\n",
+                   point.engine.threshold, point.engine.averageWindowMs, point.engine.suppressionMs);
+        } else {
+            printf("[EVAL] legacy:  confidence %.2f gap %.2f cooldown %u ms consecutive %d\n",
+                   point.legacy.confidence, point.legacy.gap, point.legacy.cooldownMs, point.legacy.consecutive);
+        }
+        printf("[EVAL]   Miss rate %.1f%% (%d/%d) | False accepts %d (%.2f per hour)\n",
+               positiveCount ? 100.0 * current.misses / positiveCount : 0.0, current.misses, (int)positiveCount,
+               current.falseAccepts, negativeHours ? current.falseAccepts / negativeHours : 0.0);
+    }
+    printf("[EVAL] Wrote %s and %s\n", detectionsPath.c_str(), sweepPath.c_str());
+    return 0;
+}
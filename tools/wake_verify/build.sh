@@ -0,0 +1,12 @@
+#!/bin/sh
+# Build the server-side wake word verifier against the firmware's Edge Impulse library.
+#
+# VERIFY_LIB=<exported library>/src builds against another (e.g. larger) model
+# instead; its objects are cached apart from the firmware library's.
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+LIB=$VERIFY_LIB
+. "$ROOT/tools/host_build.sh"
+
+host_program tools/wake_verify/build wake_verify tools/wake_verify/wake_verify.cpp
@@ -0,0 +1,332 @@
+/*
+ * Server-Side Wake Word Verifier for NOVA
+ * A second opinion on a wake word turn before the backend pays for STT, LLM
+ * and TTS. The start of the upload (the device's pre-roll, src/wake_preroll.h,
+ * then the first of the recording) is classified every 20ms with
+ * run_classifier_batch_signal(), and the wake score's running average has to
+ * reach a threshold stricter than the device's. The samples get the device's
+ * wake word gain first: its mic AGC (src/mic_agc.h), or a fixed gain.
+ *
+ * WakeVerifier is the check itself, one per thread. WakeVerifyServer answers
+ * requests on a Unix socket from a pool of them, one impulse handle each.
+ * Protocol, little endian, any number of requests per connection:
+ *
+ *   request   WakeVerifyRequest, then sample_count int16 samples (raw mic, before gain)
+ *   response  WakeVerifyResponse
+ *
+ * backend/wake_verify.py is the client.
+ */
+
+#ifndef WAKE_VERIFIER_H
+#define WAKE_VERIFIER_H
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier_batch.h"
+#include "mic_agc.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <errno.h>
+#include <mutex>
+#include <string>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define WAKE_VERIFY_MAGIC           0x5657564E  // "NVWV"
+#define WAKE_VERIFY_MAX_SAMPLES     (10 * EI_CLASSIFIER_FREQUENCY)
+#define WAKE_VERIFY_IDLE_TIMEOUT_S  5           // Drop connections that stall mid-request
+
+// Must match backend/wake_verify.py
+struct WakeVerifyRequest {
+    uint32_t magic;
+    uint32_t sample_count;
+    uint32_t preroll_samples;   // How many of the samples are pre-roll, 0 if unknown
+    uint32_t flags;             // Reserved, 0
+};
+
+enum WakeVerifyStatus : int32_t {
+    WAKE_VERIFY_OK = 0,
+    WAKE_VERIFY_TOO_SHORT = 1,      // Less than one model window
+    WAKE_VERIFY_BAD_REQUEST = 2,
+    WAKE_VERIFY_CLASSIFIER_ERROR = 3
+};
+
+struct WakeVerifyResponse {
+    uint32_t magic;
+    int32_t status;             // WakeVerifyStatus. Not OK always comes with accepted = 1
+    uint32_t accepted;
+    float score;                // Best averaged wake score
+    float threshold;
+    uint32_t windows;           // Windows classified
+    uint32_t latency_us;        // Time spent classifying
+    uint32_t reserved;
+};
+
+struct WakeVerifierConfig {
+    const char* wakeLabel;
+    float threshold;            // Averaged wake score needed to accept
+    uint32_t averageMs;         // Scores are averaged over this long
+    uint32_t analyzeMs;         // Only the start of the upload is classified
+    uint32_t hopSamples;        // Window step, a multiple of the MFCC stride so windows share frames
+    int gain;                   // The firmware's fixed mic gain, without agc
+    const MicAgcConfig* agc;    // The firmware's mic AGC, nullptr for the fixed gain
+};
+
+class WakeVerifier {
+public:
+    WakeVerifier() : _handle(ei_default_impulse.impulse) {
+        run_classifier_init(&_handle);
+    }
+
+    ~WakeVerifier() {
+        run_classifier_deinit(&_handle);
+    }
+
+    /**
+     * @brief Resolve the wake label and size the buffers
+     * @return false if the model has no such label or a setting is unusable
+     */
+    bool begin(const WakeVerifierConfig& config) {
+        _config = config;
+        const ei_impulse_t* impulse = _handle.impulse;
+        _wakeIx = -1;
+        for (uint16_t i = 0; i < impulse->label_count; i++) {
+            if (strcmp(impulse->categories[i], config.wakeLabel) == 0) _wakeIx = i;
+        }
+        if (_wakeIx < 0 || config.hopSamples == 0 || config.hopSamples % impulse->raw_samples_per_frame != 0) {
+            return false;
+        }
+
+        _maxSamples = (size_t)config.analyzeMs * impulse->frequency / 1000;
+        if (_maxSamples < impulse->dsp_input_frame_size) _maxSamples = impulse->dsp_input_frame_size;
+        _averageWindows = (size_t)config.averageMs * impulse->frequency / 1000 / config.hopSamples;
+        if (_averageWindows == 0) _averageWindows = 1;
+
+        _samples.resize(_maxSamples);
+        _gained.resize(_maxSamples);
+        _results.resize(run_classifier_batch_window_count(&_handle, _maxSamples, config.hopSamples));
+        return true;
+    }
+
+    /**
+     * @brief Check one upload. Errors fail open (accepted), the device already said yes.
+     */
+    WakeVerifyResponse verify(const int16_t* samples, size_t count) {
+        WakeVerifyResponse response = { WAKE_VERIFY_MAGIC, WAKE_VERIFY_OK, 1, 0.0f, _config.threshold, 0, 0, 0 };
+        uint64_t start = ei_read_timer_us();
+
+        size_t n = count < _maxSamples ? count : _maxSamples;
+        if (n < _handle.impulse->dsp_input_frame_size) {
+            response.status = WAKE_VERIFY_TOO_SHORT;
+            return response;
+        }
+        if (_config.agc) {
+            // A fresh AGC: the envelope attacks at once, gains start at their maximum
+            MicAgc agc;
+            agc.begin(*_config.agc);
+            agc.process(samples, _gained.data(), nullptr, n);
+            for (size_t i = 0; i < n; i++) _samples[i] = _gained[i];
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                _samples[i] = (float)(int16_t)(samples[i] * _config.gain);
+            }
+        }
+
+        signal_t signal;
+        signal.total_length = n;
+        signal.get_data = [this](size_t offset, size_t length, float* out) {
+            memcpy(out, _samples.data() + offset, length * sizeof(float));
+            return 0;
+        };
+        size_t windows = 0;
+        if (run_classifier_batch_signal(&_handle, &signal, _config.hopSamples, _results.data(), _results.size(),
+                                        &windows, false) != EI_IMPULSE_OK || windows == 0) {
+            response.status = WAKE_VERIFY_CLASSIFIER_ERROR;
+            return response;
+        }
+
+        // Best trailing average, over fewer windows while the first ones fill
+        float sum = 0.0f, best = 0.0f;
+        for (size_t w = 0; w < windows; w++) {
+            sum += _results[w].classification[_wakeIx].value;
+            if (w >= _averageWindows) sum -= _results[w - _averageWindows].classification[_wakeIx].value;
+            size_t span = w + 1 < _averageWindows ? w + 1 : _averageWindows;
+            if (w + 1 >= _averageWindows || w + 1 == windows) {
+                best = std::max(best, sum / span);
+            }
+        }
+
+        response.accepted = best >= _config.threshold;
+        response.score = best;
+        response.windows = (uint32_t)windows;
+        response.latency_us = (uint32_t)(ei_read_timer_us() - start);
+        return response;
+    }
+
+private:
+    ei_impulse_handle_t _handle;
+    WakeVerifierConfig _config = {};
+    int _wakeIx = -1;
+    size_t _maxSamples = 0;
+    size_t _averageWindows = 1;
+    std::vector<float> _samples;            // After the mic gain
+    std::vector<int16_t> _gained;
+    std::vector<ei_impulse_result_t> _results;
+};
+
+class WakeVerifyServer {
+public:
+    ~WakeVerifyServer() {
+        stop();
+    }
+
+    /**
+     * @brief Listen on a Unix socket and verify with `threads` workers
+     * @return false if the socket can't be bound or a worker's config is rejected
+     */
+    bool start(const std::string& path, const WakeVerifierConfig& config, int threads) {
+        // Every worker needs its own verifier; check the config once up front
+        WakeVerifier probe;
+        if (!probe.begin(config)) return false;
+
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        strcpy(addr.sun_path, path.c_str());
+
+        _listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (_listenFd < 0) return false;
+        unlink(path.c_str());
+        if (bind(_listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(_listenFd, 128) != 0) {
+            close(_listenFd);
+            _listenFd = -1;
+            return false;
+        }
+
+        _path = path;
+        _config = config;
+        _stopping = false;
+        for (int i = 0; i < threads; i++) {
+            _threads.emplace_back([this] { workerLoop(); });
+        }
+        _threads.emplace_back([this] { acceptLoop(); });
+        return true;
+    }
+
+    void stop() {
+        if (_listenFd < 0) return;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        shutdown(_listenFd, SHUT_RDWR);     // Wakes the acceptor
+        _ready.notify_all();
+        for (std::thread& t : _threads) t.join();
+        _threads.clear();
+        for (int fd : _pending) close(fd);
+        _pending.clear();
+        close(_listenFd);
+        _listenFd = -1;
+        unlink(_path.c_str());
+    }
+
+    uint64_t served() const {
+        return _served.load();
+    }
+
+private:
+    void acceptLoop() {
+        while (true) {
+            int fd = accept(_listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return;
+            }
+            timeval timeout = { WAKE_VERIFY_IDLE_TIMEOUT_S, 0 };
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_stopping) {
+                close(fd);
+                return;
+            }
+            _pending.push_back(fd);
+            _ready.notify_one();
+        }
+    }
+
+    void workerLoop() {
+        WakeVerifier verifier;
+        verifier.begin(_config);
+        std::vector<int16_t> samples;
+        while (true) {
+            int fd;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _ready.wait(lock, [this] { return _stopping || !_pending.empty(); });
+                if (_stopping) return;
+                fd = _pending.front();
+                _pending.pop_front();
+            }
+            serveConnection(verifier, fd, samples);
+            close(fd);
+        }
+    }
+
+    void serveConnection(WakeVerifier& verifier, int fd, std::vector<int16_t>& samples) {
+        WakeVerifyRequest request;
+        while (readAll(fd, &request, sizeof(request))) {
+            WakeVerifyResponse response = { WAKE_VERIFY_MAGIC, WAKE_VERIFY_BAD_REQUEST, 1, 0.0f, 0.0f, 0, 0, 0 };
+            if (request.magic != WAKE_VERIFY_MAGIC || request.sample_count > WAKE_VERIFY_MAX_SAMPLES) {
+                writeAll(fd, &response, sizeof(response));
+                return;     // Out of sync, the rest of the stream means nothing
+            }
+            samples.resize(request.sample_count);
+            if (!readAll(fd, samples.data(), samples.size() * sizeof(int16_t))) return;
+
+            response = verifier.verify(samples.data(), samples.size());
+            _served++;
+            if (!writeAll(fd, &response, sizeof(response))) return;
+        }
+    }
+
+    static bool readAll(int fd, void* data, size_t size) {
+        uint8_t* p = (uint8_t*)data;
+        while (size > 0) {
+            ssize_t n = recv(fd, p, size, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= (size_t)n;
+        }
+        return true;
+    }
+
+    static bool writeAll(int fd, const void* data, size_t size) {
+        const uint8_t* p = (const uint8_t*)data;
+        while (size > 0) {
+            ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= (size_t)n;
+        }
+        return true;
+    }
+
+    WakeVerifierConfig _config = {};
+    std::string _path;
+    int _listenFd = -1;
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _ready;
+    std::deque<int> _pending;               // Accepted, waiting for a worker
+    bool _stopping = false;
+    std::atomic<uint64_t> _served{0};
+};
+
+#endif // WAKE_VERIFIER_H
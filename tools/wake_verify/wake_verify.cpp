@@ -0,0 +1,420 @@
+/*
+ * Server-Side Wake Word Verifier for NOVA
+ * Runs the checks of wake_verifier.h for the backend (backend/wake_verify.py):
+ *
+ *   serve   answer requests on a Unix socket with a pool of workers
+ *   check   verify WAV files, as if each was an upload
+ *   bench   start a server and hammer it from concurrent clients, reporting
+ *           latency percentiles and requests per second
+ *
+ * bench sends 1.5s excerpts of the given recordings (16kHz 16-bit mono WAV,
+ * or directories of them; under a directory named like the wake label they
+ * count as wake words), or seeded noise without any, and also reports how
+ * many excerpts of each kind were accepted.
+ *
+ * Build:  tools/wake_verify/build.sh
+ * Usage:  wake_verify serve [--socket /tmp/nova_wake_verify.sock] [-j threads]
+ *         wake_verify check <file.wav ...>
+ *         wake_verify bench [recordings ...] [-j threads] [--clients n] [--requests n]
+ *         common: [--threshold 0.90] [--average 250] [--analyze 1500] [--hop 320] [--label Nova]
+ */
+
+#include "wake_verifier.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+// ============== Host Porting ==============
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t time_ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(time_ms));
+    return EI_IMPULSE_OK;
+}
+uint64_t ei_read_timer_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+uint64_t ei_read_timer_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+void ei_printf_float(float f) { fprintf(stderr, "%f", f); }
+void ei_putchar(char c) { fputc(c, stderr); }
+char ei_getchar() { return 0; }
+void *ei_malloc(size_t size) { return malloc(size); }
+void *ei_calloc(size_t nitems, size_t size) { return calloc(nitems, size); }
+void ei_free(void *ptr) { free(ptr); }
+void DebugLog(const char* s) { fputs(s, stderr); }
+
+// ============== Parameters ==============
+// Keep in sync with src/main.cpp and src/config.h
+
+#define WAKE_LABEL              "Nova"
+#define WAKE_WORD_GAIN          8
+#define WAKE_PREROLL_MS         1500
+#define SILENCE_THRESHOLD       200
+#define DEFAULT_SOCKET          "/tmp/nova_wake_verify.sock"
+
+// Against the device's 0.92 over 750ms: the verifier sees every 20ms step
+// instead of every 250ms slice, so a real wake word holds up for longer
+static const MicAgcConfig agcConfig = { EI_CLASSIFIER_FREQUENCY, 300, SILENCE_THRESHOLD, 30000, {
+    { 24000, 1.0f, WAKE_WORD_GAIN, 500 },
+    { 16000, 1.0f, 8.0f, 1000 } } };
+static const WakeVerifierConfig defaultConfig = { WAKE_LABEL, 0.90f, 250, 1500, 320, WAKE_WORD_GAIN, &agcConfig };
+
+// ============== Recordings ==============
+
+struct Recording {
+    std::string name;
+    bool positive = false;
+    std::vector<int16_t> samples;   // Raw, before the mic gain
+};
+
+static bool loadWav(const std::string& path, Recording& r) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool formatOk = false;
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, &data[pos + 4], 4);
+        const uint8_t* body = &data[pos + 8];
+
+        if (memcmp(&data[pos], "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint16_t format, channels, bits;
+            uint32_t rate;
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&rate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+            formatOk = (format == 1 && channels == 1 && bits == 16 && rate == EI_CLASSIFIER_FREQUENCY);
+        } else if (memcmp(&data[pos], "data", 4) == 0) {
+            if (!formatOk) return false;
+            size_t available = data.size() - (pos + 8);
+            size_t count = (chunkSize < available ? chunkSize : available) / 2;
+            r.name = path;
+            r.samples.resize(count);
+            memcpy(r.samples.data(), body, count * 2);
+            return true;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+static void findRecordings(const std::string& path, bool positive, const char* label, std::vector<Recording>& out) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        Recording r;
+        r.positive = positive;
+        if (loadWav(path, r)) out.push_back(r);
+        else fprintf(stderr, "Skipping %s (need %d Hz 16-bit mono PCM)\n", path.c_str(), EI_CLASSIFIER_FREQUENCY);
+        return;
+    }
+
+    size_t slash = path.find_last_of('/', path.size() - 2);
+    std::string base = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    if (!base.empty() && base.back() == '/') base.pop_back();
+    positive = positive || strcasecmp(base.c_str(), label) == 0;
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    for (const std::string& name : names) {
+        std::string full = path + "/" + name;
+        if (stat(full.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            findRecordings(full, positive, label, out);
+        } else if (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".wav") == 0) {
+            findRecordings(full, positive, label, out);
+        }
+    }
+}
+
+// ============== Client ==============
+
+static int connectTo(const std::string& path) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// One connection per request, like backend/wake_verify.py
+static bool request(const std::string& path, const std::vector<int16_t>& samples, uint32_t preroll,
+                    WakeVerifyResponse& response) {
+    int fd = connectTo(path);
+    if (fd < 0) return false;
+    WakeVerifyRequest header = { WAKE_VERIFY_MAGIC, (uint32_t)samples.size(), preroll, 0 };
+    std::vector<uint8_t> message(sizeof(header) + samples.size() * sizeof(int16_t));
+    memcpy(message.data(), &header, sizeof(header));
+    memcpy(message.data() + sizeof(header), samples.data(), samples.size() * sizeof(int16_t));
+
+    bool ok = send(fd, message.data(), message.size(), MSG_NOSIGNAL) == (ssize_t)message.size();
+    size_t got = 0;
+    while (ok && got < sizeof(response)) {
+        ssize_t n = recv(fd, (uint8_t*)&response + got, sizeof(response) - got, 0);
+        if (n <= 0) ok = false;
+        else got += (size_t)n;
+    }
+    close(fd);
+    return ok && response.magic == WAKE_VERIFY_MAGIC;
+}
+
+// ============== Modes ==============
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static int serve(const std::string& path, const WakeVerifierConfig& config, int threads) {
+    WakeVerifyServer server;
+    if (!server.start(path, config, threads)) {
+        fprintf(stderr, "Can't serve on %s (socket, or label/hop rejected by the model)\n", path.c_str());
+        return 1;
+    }
+    ::signal(SIGINT, onSignal);
+    ::signal(SIGTERM, onSignal);
+    printf("Verifying '%s' on %s with %d workers (threshold %.2f over %u ms, first %u ms)\n",
+        config.wakeLabel, path.c_str(), threads, config.threshold, config.averageMs, config.analyzeMs);
+    fflush(stdout);
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    server.stop();
+    printf("Served %llu requests\n", (unsigned long long)server.served());
+    return 0;
+}
+
+static int check(const std::vector<std::string>& paths, const WakeVerifierConfig& config) {
+    WakeVerifier verifier;
+    if (!verifier.begin(config)) {
+        fprintf(stderr, "Config rejected (no label '%s' or hop not a multiple of the frame stride)\n", config.wakeLabel);
+        return 1;
+    }
+    int rejected = 0;
+    for (const std::string& path : paths) {
+        Recording r;
+        if (!loadWav(path, r)) {
+            fprintf(stderr, "Skipping %s (need %d Hz 16-bit mono PCM)\n", path.c_str(), EI_CLASSIFIER_FREQUENCY);
+            continue;
+        }
+        WakeVerifyResponse v = verifier.verify(r.samples.data(), r.samples.size());
+        printf("%-40s %s  score %.3f  %u windows  %.2f ms%s\n", path.c_str(), v.accepted ? "accept" : "REJECT",
+            v.score, v.windows, v.latency_us / 1000.0, v.status == WAKE_VERIFY_OK ? "" : "  (too short or error)");
+        rejected += !v.accepted;
+    }
+    return rejected ? 3 : 0;
+}
+
+struct Excerpt {
+    std::vector<int16_t> samples;
+    bool positive = false;
+    bool accepted = false;  // Direct verdict, the server must agree
+};
+
+static double percentile(std::vector<double> sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t ix = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(ix, sorted.size() - 1)];
+}
+
+static int bench(const std::vector<std::string>& paths, const WakeVerifierConfig& config,
+                 int threads, int clients, int requests) {
+    std::vector<Recording> recordings;
+    for (const std::string& path : paths) {
+        findRecordings(path, false, config.wakeLabel, recordings);
+    }
+    if (recordings.empty() && !paths.empty()) {
+        fprintf(stderr, "No recordings found\n");
+        return 1;
+    }
+
+    // Requests: back to back excerpts as long as the verifier looks at
+    const size_t length = (size_t)config.analyzeMs * EI_CLASSIFIER_FREQUENCY / 1000;
+    const uint32_t preroll = WAKE_PREROLL_MS * EI_CLASSIFIER_FREQUENCY / 1000;
+    std::vector<Excerpt> excerpts;
+    for (const Recording& r : recordings) {
+        for (size_t start = 0; start + length <= r.samples.size(); start += length) {
+            Excerpt e;
+            e.samples.assign(r.samples.begin() + start, r.samples.begin() + start + length);
+            e.positive = r.positive;
+            excerpts.push_back(e);
+        }
+    }
+    if (recordings.empty()) {
+        std::mt19937 rng(7);
+        std::normal_distribution<float> noise(0.0f, 250.0f);
+        for (int i = 0; i < 64; i++) {
+            Excerpt e;
+            e.positive = false;
+            for (size_t s = 0; s < length; s++) {
+                e.samples.push_back((int16_t)std::max(-32768.0f, std::min(32767.0f, noise(rng))));
+            }
+            excerpts.push_back(e);
+        }
+    }
+    if (excerpts.empty()) {
+        fprintf(stderr, "No recording is %u ms long\n", config.analyzeMs);
+        return 1;
+    }
+
+    // Verdicts and single-thread latency, straight through the library
+    WakeVerifier verifier;
+    if (!verifier.begin(config)) {
+        fprintf(stderr, "Config rejected (no label '%s' or hop not a multiple of the frame stride)\n", config.wakeLabel);
+        return 1;
+    }
+    std::vector<double> direct;
+    int counts[2] = { 0, 0 }, accepted[2] = { 0, 0 };
+    for (Excerpt& e : excerpts) {
+        WakeVerifyResponse v = verifier.verify(e.samples.data(), e.samples.size());
+        e.accepted = v.accepted;
+        direct.push_back(v.latency_us / 1000.0);
+        counts[e.positive]++;
+        accepted[e.positive] += v.accepted;
+    }
+    std::sort(direct.begin(), direct.end());
+    printf("%zu excerpts of %u ms, threshold %.2f over %u ms, hop %u\n",
+        excerpts.size(), config.analyzeMs, config.threshold, config.averageMs, config.hopSamples);
+    printf("  accepted: %d/%d wake word excerpts, %d/%d other excerpts\n",
+        accepted[1], counts[1], accepted[0], counts[0]);
+    printf("  library, 1 thread: p50 %.2f ms  p99 %.2f ms\n", percentile(direct, 50), percentile(direct, 99));
+
+    // Concurrent clients against a real server
+    char socketPath[64];
+    snprintf(socketPath, sizeof(socketPath), "/tmp/wake_verify_bench_%d.sock", (int)getpid());
+    WakeVerifyServer server;
+    if (!server.start(socketPath, config, threads)) {
+        fprintf(stderr, "Can't serve on %s\n", socketPath);
+        return 1;
+    }
+
+    std::atomic<int> next{0};
+    std::atomic<int> failures{0}, disagreements{0};
+    std::vector<std::vector<double>> latencies(clients);
+    uint64_t start = ei_read_timer_us();
+    std::vector<std::thread> pool;
+    for (int c = 0; c < clients; c++) {
+        pool.emplace_back([&, c] {
+            int i;
+            while ((i = next++) < requests) {
+                const Excerpt& e = excerpts[i % excerpts.size()];
+                WakeVerifyResponse v;
+                uint64_t t0 = ei_read_timer_us();
+                if (!request(socketPath, e.samples, preroll, v) || v.status != WAKE_VERIFY_OK) {
+                    failures++;
+                    continue;
+                }
+                latencies[c].push_back((ei_read_timer_us() - t0) / 1000.0);
+                disagreements += ((bool)v.accepted != e.accepted);
+            }
+        });
+    }
+    for (std::thread& t : pool) t.join();
+    double seconds = (ei_read_timer_us() - start) / 1e6;
+    server.stop();
+
+    std::vector<double> all;
+    for (const std::vector<double>& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    printf("  server, %d workers, %d clients, %d requests: p50 %.2f ms  p95 %.2f ms  p99 %.2f ms  max %.2f ms\n",
+        threads, clients, requests, percentile(all, 50), percentile(all, 95), percentile(all, 99),
+        all.empty() ? 0.0 : all.back());
+    printf("  %.1f requests/s on %u hardware threads, %d failed, %d disagreed with the library\n",
+        all.size() / seconds, std::thread::hardware_concurrency(), failures.load(), disagreements.load());
+    return (failures || disagreements) ? 1 : 0;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "Usage: %s serve [--socket %s] [-j threads]\n"
+        "       %s check <file.wav ...>\n"
+        "       %s bench [recordings ...] [-j threads] [--clients n] [--requests n]\n"
+        "       common: [--threshold %.2f] [--average %u] [--analyze %u] [--hop %u] [--label %s]\n",
+        argv0, DEFAULT_SOCKET, argv0, argv0, defaultConfig.threshold, defaultConfig.averageMs,
+        defaultConfig.analyzeMs, defaultConfig.hopSamples, defaultConfig.wakeLabel);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    std::string mode = argv[1];
+    WakeVerifierConfig config = defaultConfig;
+    std::string socketPath = DEFAULT_SOCKET;
+    std::vector<std::string> paths;
+    int threads = std::max(1, (int)std::thread::hardware_concurrency());
+    int clients = 0;
+    int requests = 2000;
+
+    for (int i = 2; i < argc; i++) {
+        bool more = i + 1 < argc;
+        if (!strcmp(argv[i], "--socket") && more) socketPath = argv[++i];
+        else if (!strcmp(argv[i], "-j") && more) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--clients") && more) clients = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--requests") && more) requests = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threshold") && more) config.threshold = strtof(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "--average") && more) config.averageMs = strtoul(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--analyze") && more) config.analyzeMs = strtoul(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--hop") && more) config.hopSamples = strtoul(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--label") && more) config.wakeLabel = argv[++i];
+        else if (argv[i][0] != '-') paths.push_back(argv[i]);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (threads < 1 || requests < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (clients < 1) clients = threads * 2;
+
+    if (mode == "serve") return serve(socketPath, config, threads);
+    if (mode == "check" && !paths.empty()) return check(paths, config);
+    if (mode == "bench") return bench(paths, config, threads, clients, requests);
+    usage(argv[0]);
+    return 2;
+}